@@ -0,0 +1,237 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/log.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/ssid.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/seq-ts-size-header.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/multi-link-scheduler.h"
+
+// This example shows how to configure multi-link devices (MLDs): an AP MLD
+// and a number of non-AP STA MLDs, each with a link in the 5 GHz band
+// (channel 36), a link in the 6 GHz band and a link in the 2.4 GHz band,
+// of which the first nLinks are used. Each link operates on its own channel
+// and uses IEEE 802.11ax with the given HE MCS.
+//
+// Every station sends a UDP flow to the AP at the given rate. The example
+// outputs the aggregated throughput, the mean latency of the packets and the
+// number of packets that the multi-link scheduler of each station handed to
+// every link, so that the gains of the links can be compared by running it
+// with increasing values of nLinks, e.g.:
+//
+// ./waf --run "wifi-multi-link --nLinks=1"
+// ./waf --run "wifi-multi-link --nLinks=2"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("WifiMultiLink");
+
+Time g_delaySum;           ///< sum of the latencies of the received packets
+uint64_t g_nDelays = 0;    ///< number of received packets
+
+/**
+ * Record the latency of a packet received by a sink.
+ *
+ * \param packet the packet
+ * \param from the address of the sender
+ * \param to the address of the receiver
+ * \param header the header carrying the time the packet was sent
+ */
+void
+RxWithSeqTsSize (Ptr<const Packet> packet, const Address &from, const Address &to,
+                 const SeqTsSizeHeader &header)
+{
+  g_delaySum += Simulator::Now () - header.GetTs ();
+  g_nDelays++;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nStations = 1;
+  uint16_t nLinks = 2;
+  double simulationTime = 1; //seconds
+  double distance = 1.0; //meters
+  uint16_t mcs = 7;
+  double dataRate = 1000; //Mbit/s per station
+  uint32_t payloadSize = 1472; //bytes
+  double minExpectedThroughput = 0;
+
+  CommandLine cmd (__FILE__);
+  cmd.AddValue ("nStations", "Number of non-AP stations", nStations);
+  cmd.AddValue ("nLinks", "Number of links of each device (1 - 3)", nLinks);
+  cmd.AddValue ("distance", "Distance in meters between the stations and the access point", distance);
+  cmd.AddValue ("simulationTime", "Simulation time in seconds", simulationTime);
+  cmd.AddValue ("mcs", "HE MCS value (0 - 11)", mcs);
+  cmd.AddValue ("dataRate", "Offered load of each station in Mbit/s", dataRate);
+  cmd.AddValue ("payloadSize", "Payload size in bytes", payloadSize);
+  cmd.AddValue ("minExpectedThroughput", "if set, simulation fails if the throughput is below this value", minExpectedThroughput);
+  cmd.Parse (argc,argv);
+
+  if (nLinks < 1 || nLinks > 3)
+    {
+      NS_FATAL_ERROR ("The number of links must be between 1 and 3");
+    }
+
+  NodeContainer wifiStaNodes;
+  wifiStaNodes.Create (nStations);
+  NodeContainer wifiApNode;
+  wifiApNode.Create (1);
+
+  // a PHY helper per link, each with its own channel
+  std::vector<WifiStandard> standards {WIFI_STANDARD_80211ax_5GHZ,
+                                       WIFI_STANDARD_80211ax_6GHZ,
+                                       WIFI_STANDARD_80211ax_2_4GHZ};
+  std::vector<YansWifiPhyHelper> phyHelpers (3);
+  std::vector<const WifiPhyHelper*> phys;
+  for (uint16_t i = 0; i < nLinks; i++)
+    {
+      YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+      phyHelpers[i].SetChannel (channel.Create ());
+      phys.push_back (&phyHelpers[i]);
+    }
+  standards.resize (nLinks);
+
+  WifiMacHelper mac;
+  WifiHelper wifi;
+
+  std::ostringstream oss;
+  oss << "HeMcs" << mcs;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue (oss.str ()),
+                                "ControlMode", StringValue (oss.str ()));
+
+  Ssid ssid = Ssid ("ns3-80211ax-mld");
+
+  mac.SetType ("ns3::StaWifiMac",
+               "Ssid", SsidValue (ssid));
+
+  NetDeviceContainer staDevices;
+  staDevices = wifi.Install (phys, standards, mac, wifiStaNodes);
+
+  mac.SetType ("ns3::ApWifiMac",
+               "Ssid", SsidValue (ssid));
+
+  NetDeviceContainer apDevice;
+  apDevice = wifi.Install (phys, standards, mac, wifiApNode);
+
+  int64_t streamNumber = 150;
+  streamNumber += wifi.AssignStreams (apDevice, streamNumber);
+  streamNumber += wifi.AssignStreams (staDevices, streamNumber);
+
+  // mobility
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      positionAlloc->Add (Vector (distance, 0.0, 0.0));
+    }
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiApNode);
+  mobility.Install (wifiStaNodes);
+
+  // Internet stack
+  InternetStackHelper stack;
+  stack.Install (wifiApNode);
+  stack.Install (wifiStaNodes);
+  Ipv4AddressHelper address;
+
+  address.SetBase ("192.168.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer apNodeInterface = address.Assign (apDevice);
+  address.Assign (staDevices);
+
+  // Setting applications
+  ApplicationContainer sourceApplications, sinkApplications;
+  uint32_t portNumber = 9;
+  for (uint32_t index = 0; index < nStations; ++index)
+    {
+      InetSocketAddress sinkSocket (apNodeInterface.GetAddress (0), portNumber++);
+      OnOffHelper onOffHelper ("ns3::UdpSocketFactory", sinkSocket);
+      onOffHelper.SetAttribute ("OnTime", StringValue ("ns3::ConstantRandomVariable[Constant=1]"));
+      onOffHelper.SetAttribute ("OffTime", StringValue ("ns3::ConstantRandomVariable[Constant=0]"));
+      onOffHelper.SetAttribute ("DataRate", DataRateValue (DataRate (dataRate * 1e6)));
+      onOffHelper.SetAttribute ("PacketSize", UintegerValue (payloadSize)); //bytes
+      onOffHelper.SetAttribute ("EnableSeqTsSizeHeader", BooleanValue (true));
+      sourceApplications.Add (onOffHelper.Install (wifiStaNodes.Get (index)));
+      PacketSinkHelper packetSinkHelper ("ns3::UdpSocketFactory", sinkSocket);
+      packetSinkHelper.SetAttribute ("EnableSeqTsSizeHeader", BooleanValue (true));
+      sinkApplications.Add (packetSinkHelper.Install (wifiApNode.Get (0)));
+    }
+
+  for (uint32_t index = 0; index < sinkApplications.GetN (); ++index)
+    {
+      sinkApplications.Get (index)->TraceConnectWithoutContext ("RxWithSeqTsSize",
+                                                                MakeCallback (&RxWithSeqTsSize));
+    }
+
+  sinkApplications.Start (Seconds (0.0));
+  sinkApplications.Stop (Seconds (simulationTime + 1));
+  sourceApplications.Start (Seconds (1.0));
+  sourceApplications.Stop (Seconds (simulationTime + 1));
+
+  Simulator::Stop (Seconds (simulationTime + 1));
+  Simulator::Run ();
+
+  double throughput = 0;
+  for (uint32_t index = 0; index < sinkApplications.GetN (); ++index)
+    {
+      uint64_t totalPacketsThrough = DynamicCast<PacketSink> (sinkApplications.Get (index))->GetTotalRx ();
+      throughput += ((totalPacketsThrough * 8) / (simulationTime * 1000000.0)); //Mbit/s
+    }
+
+  std::cout << "Links: " << nLinks << std::endl
+            << "Aggregated throughput: " << throughput << " Mbit/s" << std::endl;
+  if (g_nDelays > 0)
+    {
+      std::cout << "Mean latency: " << (g_delaySum / g_nDelays).As (Time::MS) << std::endl;
+    }
+  for (uint32_t index = 0; index < nStations; ++index)
+    {
+      Ptr<MultiLinkScheduler> scheduler = DynamicCast<WifiNetDevice> (staDevices.Get (index))->GetMultiLinkScheduler ();
+      if (scheduler != 0)
+        {
+          std::cout << "Station " << index << " packets per link:";
+          for (uint8_t linkId = 0; linkId < scheduler->GetNLinks (); linkId++)
+            {
+              std::cout << " " << scheduler->GetNPacketsToLink (AC_BE, linkId);
+            }
+          std::cout << std::endl;
+        }
+    }
+
+  Simulator::Destroy ();
+
+  if (throughput < minExpectedThroughput || throughput == 0)
+    {
+      NS_LOG_ERROR ("Obtained throughput " << throughput << " is not expected!");
+      exit (1);
+    }
+
+  return 0;
+}
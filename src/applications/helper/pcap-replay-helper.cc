@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "pcap-replay-helper.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+
+namespace ns3 {
+
+PcapReplayHelper::PcapReplayHelper (std::string filename)
+{
+  m_factory.SetTypeId ("ns3::PcapReplayApplication");
+  m_factory.Set ("File", StringValue (filename));
+}
+
+void
+PcapReplayHelper::SetAttribute (std::string name, const AttributeValue &value)
+{
+  m_factory.Set (name, value);
+}
+
+ApplicationContainer
+PcapReplayHelper::Install (Ptr<Node> node) const
+{
+  return ApplicationContainer (InstallPriv (node, 0));
+}
+
+ApplicationContainer
+PcapReplayHelper::Install (NetDeviceContainer c) const
+{
+  ApplicationContainer apps;
+  for (NetDeviceContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      apps.Add (InstallPriv ((*i)->GetNode (), *i));
+    }
+
+  return apps;
+}
+
+ApplicationContainer
+PcapReplayHelper::Install (NodeContainer c) const
+{
+  ApplicationContainer apps;
+  for (NodeContainer::Iterator i = c.Begin (); i != c.End (); ++i)
+    {
+      apps.Add (InstallPriv (*i, 0));
+    }
+
+  return apps;
+}
+
+Ptr<Application>
+PcapReplayHelper::InstallPriv (Ptr<Node> node, Ptr<NetDevice> device) const
+{
+  Ptr<Application> app = m_factory.Create<Application> ();
+  if (device != 0)
+    {
+      app->SetAttribute ("Device", PointerValue (device));
+    }
+  node->AddApplication (app);
+
+  return app;
+}
+
+} // namespace ns3
@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_REPLAY_HELPER_H
+#define PCAP_REPLAY_HELPER_H
+
+#include <stdint.h>
+#include <string>
+#include "ns3/object-factory.h"
+#include "ns3/address.h"
+#include "ns3/attribute.h"
+#include "ns3/net-device.h"
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/application-container.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup pcapreplay
+ * \brief A helper to make it easier to instantiate an
+ * ns3::PcapReplayApplication on a set of nodes or devices.
+ */
+class PcapReplayHelper
+{
+public:
+  /**
+   * Create a PcapReplayHelper to make it easier to work with
+   * PcapReplayApplications
+   *
+   * \param filename the pcap or pcapng file to replay
+   */
+  PcapReplayHelper (std::string filename);
+
+  /**
+   * Helper function used to set the underlying application attributes,
+   * _not_ the socket attributes.
+   *
+   * \param name the name of the application attribute to set
+   * \param value the value of the application attribute to set
+   */
+  void SetAttribute (std::string name, const AttributeValue &value);
+
+  /**
+   * Install an ns3::PcapReplayApplication sending on a socket connected to
+   * the "Remote" address on each node of the input container.
+   *
+   * \param c NodeContainer of the set of nodes on which a
+   * PcapReplayApplication will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (NodeContainer c) const;
+
+  /**
+   * Install an ns3::PcapReplayApplication sending on a socket connected to
+   * the "Remote" address on the node.
+   *
+   * \param node The node on which a PcapReplayApplication will be installed.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (Ptr<Node> node) const;
+
+  /**
+   * Install an ns3::PcapReplayApplication sending frames directly on each
+   * device of the input container, on the node of the device.
+   *
+   * \param c NetDeviceContainer of the devices to send frames on.
+   * \returns Container of Ptr to the applications installed.
+   */
+  ApplicationContainer Install (NetDeviceContainer c) const;
+
+private:
+  /**
+   * Install an ns3::PcapReplayApplication on the node configured with all
+   * the attributes set with SetAttribute.
+   *
+   * \param node The node on which a PcapReplayApplication will be installed.
+   * \param device The device to send frames on, if any
+   * \returns Ptr to the application installed.
+   */
+  Ptr<Application> InstallPriv (Ptr<Node> node, Ptr<NetDevice> device) const;
+
+  ObjectFactory m_factory; //!< Object factory.
+};
+
+} // namespace ns3
+
+#endif /* PCAP_REPLAY_HELPER_H */
@@ -0,0 +1,438 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mapped-pcap-file.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MappedPcapFile");
+
+/// libpcap magic number, microsecond resolution
+static const uint32_t PCAP_MAGIC = 0xa1b2c3d4;
+/// libpcap magic number, nanosecond resolution
+static const uint32_t PCAP_NSEC_MAGIC = 0xa1b23c4d;
+/// Size of the libpcap file header
+static const uint32_t PCAP_FILE_HEADER_SIZE = 24;
+/// Size of the libpcap record header
+static const uint32_t PCAP_RECORD_HEADER_SIZE = 16;
+
+/// pcapng Section Header Block type (the same in both byte orders)
+static const uint32_t PCAPNG_SHB = 0x0a0d0d0a;
+/// pcapng Interface Description Block type
+static const uint32_t PCAPNG_IDB = 1;
+/// pcapng (obsolete) Packet Block type
+static const uint32_t PCAPNG_PB = 2;
+/// pcapng Simple Packet Block type
+static const uint32_t PCAPNG_SPB = 3;
+/// pcapng Enhanced Packet Block type
+static const uint32_t PCAPNG_EPB = 6;
+/// pcapng byte-order magic number
+static const uint32_t PCAPNG_BYTE_ORDER_MAGIC = 0x1a2b3c4d;
+/// pcapng if_tsresol option code
+static const uint16_t PCAPNG_IF_TSRESOL = 9;
+
+/**
+ * \param x a 32-bit value
+ * \return x with its bytes in the reverse order
+ */
+static uint32_t
+Swap32 (uint32_t x)
+{
+  return ((x & 0xff) << 24) | ((x & 0xff00) << 8) | ((x >> 8) & 0xff00) | (x >> 24);
+}
+
+MappedPcapFile::MappedPcapFile ()
+  : m_data (0),
+    m_size (0),
+    m_offset (0),
+    m_first (0),
+    m_pcapNg (false),
+    m_swapped (false),
+    m_lastTimeNs (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MappedPcapFile::~MappedPcapFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+MappedPcapFile::Open (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  Close ();
+
+  int fd = open (filename.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Cannot open " << filename << ": " << std::strerror (errno));
+      return false;
+    }
+  struct stat st;
+  if (fstat (fd, &st) < 0 || st.st_size < 12)
+    {
+      NS_LOG_WARN ("Cannot use " << filename << " as a pcap file");
+      close (fd);
+      return false;
+    }
+  void *data = mmap (0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // the mapping stays valid after the descriptor is closed
+  close (fd);
+  if (data == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Cannot map " << filename << ": " << std::strerror (errno));
+      return false;
+    }
+  // records are visited once, in order
+  madvise (data, st.st_size, MADV_SEQUENTIAL);
+  m_data = static_cast<const uint8_t *> (data);
+  m_size = st.st_size;
+
+  uint32_t magic;
+  std::memcpy (&magic, m_data, 4);
+  if (magic == PCAPNG_SHB)
+    {
+      m_pcapNg = true;
+      m_first = 0;
+      m_offset = 0;
+      if (!ReadSectionHeader ())
+        {
+          NS_LOG_WARN (filename << " is not a valid pcapng file");
+          Close ();
+          return false;
+        }
+    }
+  else
+    {
+      m_pcapNg = false;
+      if (magic == PCAP_MAGIC || magic == PCAP_NSEC_MAGIC)
+        {
+          m_swapped = false;
+        }
+      else if (Swap32 (magic) == PCAP_MAGIC || Swap32 (magic) == PCAP_NSEC_MAGIC)
+        {
+          m_swapped = true;
+        }
+      else
+        {
+          NS_LOG_WARN (filename << " is neither a pcap nor a pcapng file");
+          Close ();
+          return false;
+        }
+      if (m_size < PCAP_FILE_HEADER_SIZE)
+        {
+          NS_LOG_WARN (filename << " is truncated");
+          Close ();
+          return false;
+        }
+      m_pcapInterface.snapLength = ReadU32 (m_data + 16);
+      m_pcapInterface.dataLinkType = ReadU32 (m_data + 20);
+      m_pcapInterface.binary = false;
+      m_pcapInterface.exponent = (ReadU32 (m_data) == PCAP_NSEC_MAGIC) ? 9 : 6;
+      m_first = PCAP_FILE_HEADER_SIZE;
+    }
+  Rewind ();
+  return true;
+}
+
+void
+MappedPcapFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0)
+    {
+      munmap (const_cast<uint8_t *> (m_data), m_size);
+    }
+  m_data = 0;
+  m_size = 0;
+  m_offset = 0;
+  m_first = 0;
+  m_interfaces.clear ();
+}
+
+bool
+MappedPcapFile::IsOpen (void) const
+{
+  return m_data != 0;
+}
+
+bool
+MappedPcapFile::IsPcapNg (void) const
+{
+  return m_pcapNg;
+}
+
+void
+MappedPcapFile::Rewind (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_offset = m_first;
+  m_interfaces.clear ();
+  m_lastTimeNs = 0;
+}
+
+bool
+MappedPcapFile::Next (Record &record)
+{
+  if (m_data == 0)
+    {
+      return false;
+    }
+  bool found = m_pcapNg ? NextPcapNg (record) : NextPcap (record);
+  if (found)
+    {
+      m_lastTimeNs = record.timeNs;
+    }
+  return found;
+}
+
+uint16_t
+MappedPcapFile::ReadU16 (const uint8_t *p) const
+{
+  uint16_t v;
+  std::memcpy (&v, p, 2);
+  return m_swapped ? static_cast<uint16_t> ((v >> 8) | (v << 8)) : v;
+}
+
+uint32_t
+MappedPcapFile::ReadU32 (const uint8_t *p) const
+{
+  uint32_t v;
+  std::memcpy (&v, p, 4);
+  return m_swapped ? Swap32 (v) : v;
+}
+
+uint64_t
+MappedPcapFile::ToNanoSeconds (uint64_t units, const Interface &itf)
+{
+  if (!itf.binary)
+    {
+      uint64_t scale = 1;
+      if (itf.exponent <= 9)
+        {
+          for (uint8_t i = itf.exponent; i < 9; i++)
+            {
+              scale *= 10;
+            }
+          return units * scale;
+        }
+      for (uint8_t i = 9; i < itf.exponent && i < 28; i++)
+        {
+          scale *= 10;
+        }
+      return units / scale;
+    }
+  uint8_t exponent = std::min<uint8_t> (itf.exponent, 63);
+  uint64_t seconds = units >> exponent;
+  uint64_t fraction = units & ((uint64_t (1) << exponent) - 1);
+  // keep fraction * 10^9 within 64 bits
+  if (exponent > 32)
+    {
+      fraction >>= exponent - 32;
+      exponent = 32;
+    }
+  return seconds * 1000000000 + ((fraction * 1000000000) >> exponent);
+}
+
+bool
+MappedPcapFile::NextPcap (Record &record)
+{
+  if (m_size - m_offset < PCAP_RECORD_HEADER_SIZE)
+    {
+      return false;
+    }
+  const uint8_t *header = m_data + m_offset;
+  uint64_t seconds = ReadU32 (header);
+  uint64_t fraction = ReadU32 (header + 4);
+  uint32_t capturedLength = ReadU32 (header + 8);
+  uint32_t originalLength = ReadU32 (header + 12);
+  if (capturedLength > m_size - m_offset - PCAP_RECORD_HEADER_SIZE)
+    {
+      NS_LOG_WARN ("Truncated record at offset " << m_offset);
+      m_offset = m_size;
+      return false;
+    }
+  record.timeNs = seconds * 1000000000
+    + ((m_pcapInterface.exponent == 9) ? fraction : fraction * 1000);
+  record.data = header + PCAP_RECORD_HEADER_SIZE;
+  record.capturedLength = capturedLength;
+  record.originalLength = originalLength;
+  record.dataLinkType = m_pcapInterface.dataLinkType;
+  m_offset += PCAP_RECORD_HEADER_SIZE + capturedLength;
+  return true;
+}
+
+bool
+MappedPcapFile::ReadSectionHeader (void)
+{
+  NS_LOG_FUNCTION (this << m_offset);
+  if (m_size - m_offset < 28)
+    {
+      return false;
+    }
+  const uint8_t *block = m_data + m_offset;
+  uint32_t magic;
+  std::memcpy (&magic, block + 8, 4);
+  if (magic == PCAPNG_BYTE_ORDER_MAGIC)
+    {
+      m_swapped = false;
+    }
+  else if (Swap32 (magic) == PCAPNG_BYTE_ORDER_MAGIC)
+    {
+      m_swapped = true;
+    }
+  else
+    {
+      return false;
+    }
+  uint32_t length = ReadU32 (block + 4);
+  if (length < 28 || length % 4 != 0 || length > m_size - m_offset)
+    {
+      return false;
+    }
+  // interface identifiers are local to a section
+  m_interfaces.clear ();
+  m_offset += length;
+  return true;
+}
+
+void
+MappedPcapFile::ReadInterface (const uint8_t *body, uint32_t length)
+{
+  Interface itf;
+  itf.dataLinkType = 0;
+  itf.snapLength = 0;
+  itf.binary = false;
+  itf.exponent = 6;
+  if (length >= 8)
+    {
+      itf.dataLinkType = ReadU16 (body);
+      itf.snapLength = ReadU32 (body + 4);
+      const uint8_t *option = body + 8;
+      const uint8_t *end = body + length;
+      while (end - option >= 4)
+        {
+          uint16_t code = ReadU16 (option);
+          uint16_t optionLength = ReadU16 (option + 2);
+          if (code == 0 || end - option - 4 < optionLength)
+            {
+              break;
+            }
+          if (code == PCAPNG_IF_TSRESOL && optionLength >= 1)
+            {
+              itf.binary = (option[4] & 0x80) != 0;
+              itf.exponent = option[4] & 0x7f;
+            }
+          option += 4 + ((optionLength + 3) & ~3);
+        }
+    }
+  m_interfaces.push_back (itf);
+}
+
+bool
+MappedPcapFile::NextPcapNg (Record &record)
+{
+  while (m_size - m_offset >= 12)
+    {
+      const uint8_t *block = m_data + m_offset;
+      uint32_t type;
+      std::memcpy (&type, block, 4);
+      if (type == PCAPNG_SHB)
+        {
+          if (!ReadSectionHeader ())
+            {
+              NS_LOG_WARN ("Invalid section header at offset " << m_offset);
+              m_offset = m_size;
+              return false;
+            }
+          continue;
+        }
+      type = ReadU32 (block);
+      uint32_t length = ReadU32 (block + 4);
+      if (length < 12 || length % 4 != 0 || length > m_size - m_offset)
+        {
+          NS_LOG_WARN ("Invalid block at offset " << m_offset);
+          m_offset = m_size;
+          return false;
+        }
+      m_offset += length;
+
+      const uint8_t *body = block + 8;
+      uint32_t bodyLength = length - 12;
+      if (type == PCAPNG_IDB)
+        {
+          ReadInterface (body, bodyLength);
+        }
+      else if (type == PCAPNG_EPB || type == PCAPNG_PB)
+        {
+          if (bodyLength < 20)
+            {
+              continue;
+            }
+          uint32_t id = (type == PCAPNG_EPB) ? ReadU32 (body) : ReadU16 (body);
+          uint64_t units = (uint64_t (ReadU32 (body + 4)) << 32) | ReadU32 (body + 8);
+          uint32_t capturedLength = ReadU32 (body + 12);
+          if (id >= m_interfaces.size () || capturedLength > bodyLength - 20)
+            {
+              NS_LOG_WARN ("Skipping invalid packet block");
+              continue;
+            }
+          record.timeNs = ToNanoSeconds (units, m_interfaces[id]);
+          record.data = body + 20;
+          record.capturedLength = capturedLength;
+          record.originalLength = ReadU32 (body + 16);
+          record.dataLinkType = m_interfaces[id].dataLinkType;
+          return true;
+        }
+      else if (type == PCAPNG_SPB)
+        {
+          if (bodyLength < 4 || m_interfaces.empty ())
+            {
+              continue;
+            }
+          // Simple Packet Blocks carry no timestamp and belong to the
+          // first interface
+          uint32_t originalLength = ReadU32 (body);
+          uint32_t capturedLength = std::min (originalLength, bodyLength - 4);
+          if (m_interfaces[0].snapLength != 0)
+            {
+              capturedLength = std::min (capturedLength, m_interfaces[0].snapLength);
+            }
+          record.timeNs = m_lastTimeNs;
+          record.data = body + 4;
+          record.capturedLength = capturedLength;
+          record.originalLength = originalLength;
+          record.dataLinkType = m_interfaces[0].dataLinkType;
+          return true;
+        }
+      // other blocks (statistics, name resolution, ...) are ignored
+    }
+  return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,150 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MAPPED_PCAP_FILE_H
+#define MAPPED_PCAP_FILE_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup applications
+ *
+ * \brief Sequential, read-only access to a memory-mapped pcap or pcapng file
+ *
+ * Unlike PcapFile, which reads each record into a caller-provided buffer,
+ * this class maps the whole file in memory and hands out pointers to the
+ * records in place, so that traces much larger than the available memory
+ * can be walked through with the operating system paging the file in and
+ * out as needed.  The pointers are only valid until the file is closed:
+ * the bytes to keep (e.g., in a Packet) must be copied.  Both the classic libpcap format (micro or nanosecond
+ * resolution, either byte order) and the pcapng format (Enhanced, Simple
+ * and obsolete Packet Blocks, several sections and interfaces) are
+ * understood.  Malformed or truncated content ends the walk.
+ */
+class MappedPcapFile
+{
+public:
+  /**
+   * A record of the file, pointing into the mapped memory
+   */
+  struct Record
+  {
+    uint64_t timeNs;          //!< timestamp, in nanoseconds since the epoch
+    const uint8_t *data;      //!< captured bytes
+    uint32_t capturedLength;  //!< number of bytes at data
+    uint32_t originalLength;  //!< length of the packet on the wire
+    uint32_t dataLinkType;    //!< link-layer header type of the record
+  };
+
+  MappedPcapFile ();
+  ~MappedPcapFile ();
+
+  /**
+   * \brief Map a file and position the walk on its first record
+   * \param filename the file name
+   * \return false if the file cannot be mapped or is not a pcap or pcapng file
+   */
+  bool Open (std::string filename);
+  /**
+   * \brief Unmap the file, if any
+   */
+  void Close (void);
+  /**
+   * \return true if a file is mapped
+   */
+  bool IsOpen (void) const;
+  /**
+   * \return true if the mapped file is in the pcapng format
+   */
+  bool IsPcapNg (void) const;
+  /**
+   * \brief Position the walk on the first record again
+   */
+  void Rewind (void);
+  /**
+   * \brief Get the next record
+   * \param [out] record the record
+   * \return false at the end of the file (or of its valid content)
+   */
+  bool Next (Record &record);
+
+private:
+  /// A pcapng interface, as described by an Interface Description Block
+  struct Interface
+  {
+    uint32_t dataLinkType; //!< link-layer header type
+    uint32_t snapLength;   //!< capture length limit (0 if none)
+    bool binary;           //!< true if the resolution is 2^-exponent s
+    uint8_t exponent;      //!< timestamp resolution exponent
+  };
+
+  /**
+   * \param p where to read
+   * \return the 16-bit value at p, in the byte order of the file
+   */
+  uint16_t ReadU16 (const uint8_t *p) const;
+  /**
+   * \param p where to read
+   * \return the 32-bit value at p, in the byte order of the file
+   */
+  uint32_t ReadU32 (const uint8_t *p) const;
+  /**
+   * \param units a timestamp in units of the interface resolution
+   * \param itf the interface
+   * \return the timestamp in nanoseconds
+   */
+  static uint64_t ToNanoSeconds (uint64_t units, const Interface &itf);
+  /**
+   * \param [out] record the next record of a libpcap file
+   * \return false at the end of the file
+   */
+  bool NextPcap (Record &record);
+  /**
+   * \param [out] record the next packet record of a pcapng file
+   * \return false at the end of the file
+   */
+  bool NextPcapNg (Record &record);
+  /**
+   * \brief Parse a Section Header Block at m_offset
+   * \return false if it is not valid
+   */
+  bool ReadSectionHeader (void);
+  /**
+   * \brief Parse an Interface Description Block
+   * \param body the block body
+   * \param length the body length
+   */
+  void ReadInterface (const uint8_t *body, uint32_t length);
+
+  const uint8_t *m_data;  //!< the mapped file
+  size_t m_size;          //!< size of the mapped file
+  size_t m_offset;        //!< offset of the next block or record
+  size_t m_first;         //!< offset of the first record
+  bool m_pcapNg;          //!< whether the file is in the pcapng format
+  bool m_swapped;         //!< whether the file byte order is not the host one
+  Interface m_pcapInterface;          //!< the single interface of a libpcap file
+  std::vector<Interface> m_interfaces; //!< interfaces of the current pcapng section
+  uint64_t m_lastTimeNs;  //!< timestamp of the last record returned
+};
+
+} // namespace ns3
+
+#endif /* MAPPED_PCAP_FILE_H */
@@ -0,0 +1,369 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/address.h"
+#include "ns3/node.h"
+#include "ns3/net-device.h"
+#include "ns3/socket.h"
+#include "ns3/simulator.h"
+#include "ns3/socket-factory.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/packet-socket-address.h"
+#include "ns3/trace-helper.h"
+#include "pcap-replay-application.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapReplayApplication");
+
+NS_OBJECT_ENSURE_REGISTERED (PcapReplayApplication);
+
+/// EtherType of IPv4
+static const uint16_t ETHERTYPE_IPV4 = 0x0800;
+/// EtherType of IPv6
+static const uint16_t ETHERTYPE_IPV6 = 0x86dd;
+/// Link-layer type of raw IPv4 captures
+static const uint32_t DLT_IPV4 = 228;
+/// Link-layer type of raw IPv6 captures
+static const uint32_t DLT_IPV6 = 229;
+
+TypeId
+PcapReplayApplication::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::PcapReplayApplication")
+    .SetParent<Application> ()
+    .SetGroupName ("Applications")
+    .AddConstructor<PcapReplayApplication> ()
+    .AddAttribute ("File", "The pcap or pcapng file to replay.",
+                   StringValue (""),
+                   MakeStringAccessor (&PcapReplayApplication::m_filename),
+                   MakeStringChecker ())
+    .AddAttribute ("Speed",
+                   "The replay speed factor: the recorded delays between "
+                   "packets are divided by this value.",
+                   DoubleValue (1.0),
+                   MakeDoubleAccessor (&PcapReplayApplication::m_speed),
+                   MakeDoubleChecker<double> (1e-9))
+    .AddAttribute ("MaxPackets",
+                   "The maximum number of packets to send each time the "
+                   "application is started. The value zero means that "
+                   "there is no limit.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PcapReplayApplication::m_maxPackets),
+                   MakeUintegerChecker<uint64_t> ())
+    .AddAttribute ("UseOriginalLength",
+                   "Pad the records whose capture was truncated with zeros, "
+                   "up to their original length.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&PcapReplayApplication::m_useOriginalLength),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Protocol", "The type of protocol to use (socket mode).",
+                   TypeIdValue (UdpSocketFactory::GetTypeId ()),
+                   MakeTypeIdAccessor (&PcapReplayApplication::m_tid),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("Remote", "The address of the destination (socket mode).",
+                   AddressValue (),
+                   MakeAddressAccessor (&PcapReplayApplication::m_peer),
+                   MakeAddressChecker ())
+    .AddAttribute ("Device",
+                   "If set, frames are sent directly on this device "
+                   "instead of on a socket.",
+                   PointerValue (),
+                   MakePointerAccessor (&PcapReplayApplication::m_device),
+                   MakePointerChecker<NetDevice> ())
+    .AddTraceSource ("Tx", "A new packet is sent",
+                     MakeTraceSourceAccessor (&PcapReplayApplication::m_txTrace),
+                     "ns3::Packet::TracedCallback")
+  ;
+  return tid;
+}
+
+PcapReplayApplication::PcapReplayApplication ()
+  : m_socket (0),
+    m_firstTimeNs (0),
+    m_sentThisRun (0),
+    m_sent (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapReplayApplication::~PcapReplayApplication ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+PcapReplayApplication::GetSent (void) const
+{
+  return m_sent;
+}
+
+Ptr<Socket>
+PcapReplayApplication::GetSocket (void) const
+{
+  return m_socket;
+}
+
+void
+PcapReplayApplication::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_socket = 0;
+  m_device = 0;
+  m_file.Close ();
+  // chain up
+  Application::DoDispose ();
+}
+
+void
+PcapReplayApplication::StartApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if (!m_file.Open (m_filename))
+    {
+      NS_FATAL_ERROR ("Cannot replay " << m_filename);
+    }
+
+  if (m_device == 0 && !m_socket)
+    {
+      m_socket = Socket::CreateSocket (GetNode (), m_tid);
+      int ret = -1;
+      if (Inet6SocketAddress::IsMatchingType (m_peer))
+        {
+          ret = m_socket->Bind6 ();
+        }
+      else if (InetSocketAddress::IsMatchingType (m_peer)
+               || PacketSocketAddress::IsMatchingType (m_peer))
+        {
+          ret = m_socket->Bind ();
+        }
+      if (ret == -1)
+        {
+          NS_FATAL_ERROR ("Failed to bind socket");
+        }
+      m_socket->Connect (m_peer);
+      m_socket->SetAllowBroadcast (true);
+      m_socket->ShutdownRecv ();
+    }
+
+  m_sentThisRun = 0;
+  if (!m_file.Next (m_record))
+    {
+      NS_LOG_WARN ("No packet to replay in " << m_filename);
+      return;
+    }
+  m_firstTimeNs = m_record.timeNs;
+  m_startTime = Simulator::Now ();
+  m_sendEvent = Simulator::ScheduleNow (&PcapReplayApplication::SendRecord, this);
+}
+
+void
+PcapReplayApplication::StopApplication (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  Simulator::Cancel (m_sendEvent);
+  if (m_socket != 0)
+    {
+      m_socket->Close ();
+      m_socket = 0;
+    }
+  m_file.Close ();
+}
+
+void
+PcapReplayApplication::ParseFrame (const MappedPcapFile::Record &record, FrameInfo &info)
+{
+  const uint8_t *d = record.data;
+  uint32_t length = record.capturedLength;
+  uint32_t offset = 0;
+  uint16_t protocol = 0;
+
+  info.linkHeaderSize = 0;
+  info.protocol = 0;
+  info.hasDestination = false;
+  info.payloadOffset = 0;
+
+  switch (record.dataLinkType)
+    {
+    case PcapHelper::DLT_EN10MB:
+      if (length < 14)
+        {
+          return;
+        }
+      info.destination.CopyFrom (d);
+      info.hasDestination = true;
+      protocol = (d[12] << 8) | d[13];
+      offset = 14;
+      // skip 802.1Q and 802.1ad tags
+      while ((protocol == 0x8100 || protocol == 0x88a8) && length >= offset + 4)
+        {
+          protocol = (d[offset + 2] << 8) | d[offset + 3];
+          offset += 4;
+        }
+      break;
+    case PcapHelper::DLT_PPP:
+      {
+        if (length >= 2 && d[0] == 0xff && d[1] == 0x03)
+          {
+            // HDLC-like framing, address and control fields
+            offset = 2;
+          }
+        if (length < offset + 2)
+          {
+            return;
+          }
+        uint16_t pppProtocol = (d[offset] << 8) | d[offset + 1];
+        offset += 2;
+        protocol = (pppProtocol == 0x0021) ? ETHERTYPE_IPV4 : (pppProtocol == 0x0057) ? ETHERTYPE_IPV6 : 0;
+        break;
+      }
+    case PcapHelper::DLT_LINUX_SLL:
+      if (length < 16)
+        {
+          return;
+        }
+      protocol = (d[14] << 8) | d[15];
+      offset = 16;
+      break;
+    case PcapHelper::DLT_NULL:
+      // the address family is in the byte order of the capturing host, so
+      // rely on the IP version instead
+      offset = 4;
+      break;
+    case PcapHelper::DLT_RAW:
+    case DLT_IPV4:
+    case DLT_IPV6:
+      break;
+    default:
+      return;
+    }
+  if (length < offset)
+    {
+      return;
+    }
+  if (protocol == 0 && length > offset)
+    {
+      uint8_t version = d[offset] >> 4;
+      protocol = (version == 4) ? ETHERTYPE_IPV4 : (version == 6) ? ETHERTYPE_IPV6 : 0;
+    }
+  info.linkHeaderSize = offset;
+  info.protocol = protocol;
+
+  uint8_t transport;
+  if (protocol == ETHERTYPE_IPV4 && length >= offset + 20)
+    {
+      uint32_t ihl = (d[offset] & 0x0f) * 4;
+      bool firstFragment = (((d[offset + 6] & 0x1f) << 8) | d[offset + 7]) == 0;
+      transport = firstFragment ? d[offset + 9] : 0;
+      offset += std::max<uint32_t> (ihl, 20);
+    }
+  else if (protocol == ETHERTYPE_IPV6 && length >= offset + 40)
+    {
+      // extension headers are not walked through
+      transport = d[offset + 6];
+      offset += 40;
+    }
+  else
+    {
+      return;
+    }
+
+  if (transport == 17 && length >= offset + 8)
+    {
+      offset += 8;
+    }
+  else if (transport == 6 && length >= offset + 20)
+    {
+      offset += std::max<uint32_t> ((d[offset + 12] >> 4) * 4, 20);
+    }
+  if (offset <= length)
+    {
+      info.payloadOffset = offset;
+    }
+}
+
+void
+PcapReplayApplication::SendRecord (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  FrameInfo info;
+  ParseFrame (m_record, info);
+
+  uint32_t offset = (m_device != 0) ? info.linkHeaderSize : info.payloadOffset;
+  // packets own their bytes, hence the copy from the mapped file
+  Ptr<Packet> packet = Create<Packet> (m_record.data + offset, m_record.capturedLength - offset);
+  if (m_useOriginalLength && m_record.originalLength > m_record.capturedLength)
+    {
+      packet->AddPaddingAtEnd (m_record.originalLength - m_record.capturedLength);
+    }
+
+  NS_LOG_LOGIC ("Replaying record of " << m_record.capturedLength << " bytes as "
+                << packet->GetSize () << " bytes");
+  m_txTrace (packet);
+  if (m_device != 0)
+    {
+      Address destination = info.hasDestination ? Address (info.destination) : m_device->GetBroadcast ();
+      m_device->Send (packet, destination, info.protocol);
+    }
+  else
+    {
+      m_socket->Send (packet);
+    }
+  m_sentThisRun++;
+  m_sent++;
+
+  ScheduleNext ();
+}
+
+void
+PcapReplayApplication::ScheduleNext (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  if ((m_maxPackets != 0 && m_sentThisRun >= m_maxPackets) || !m_file.Next (m_record))
+    {
+      NS_LOG_LOGIC ("Replay complete, " << m_sentThisRun << " packets sent");
+      return;
+    }
+
+  Time offset = Seconds (0);
+  if (m_record.timeNs > m_firstTimeNs)
+    {
+      offset = NanoSeconds (static_cast<int64_t> ((m_record.timeNs - m_firstTimeNs) / m_speed));
+    }
+  Time delay = m_startTime + offset - Simulator::Now ();
+  if (delay.IsStrictlyNegative ())
+    {
+      // out-of-order timestamps (e.g., several pcapng interfaces)
+      delay = Seconds (0);
+    }
+  m_sendEvent = Simulator::Schedule (delay, &PcapReplayApplication::SendRecord, this);
+}
+
+} // namespace ns3
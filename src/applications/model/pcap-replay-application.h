@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAP_REPLAY_APPLICATION_H
+#define PCAP_REPLAY_APPLICATION_H
+
+#include "ns3/address.h"
+#include "ns3/application.h"
+#include "ns3/event-id.h"
+#include "ns3/mac48-address.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/traced-callback.h"
+#include "mapped-pcap-file.h"
+
+namespace ns3 {
+
+class Socket;
+class NetDevice;
+class Packet;
+
+/**
+ * \ingroup applications
+ * \defgroup pcapreplay PcapReplayApplication
+ *
+ * This traffic generator replays the packets of a recorded pcap or pcapng
+ * file with their original timing.
+ */
+
+/**
+ * \ingroup pcapreplay
+ *
+ * \brief Replay the packets of a pcap or pcapng file at their recorded times
+ *
+ * The file is memory-mapped (see MappedPcapFile) and walked one record at
+ * a time: only the next packet to send is ever scheduled, and each Packet
+ * is built from the mapped bytes just before it is sent, so that traces of
+ * any size can be replayed without loading them in memory.  A Packet owns
+ * its bytes, so the bytes of each record are still copied once, from the
+ * mapping into the buffer of its Packet.
+ *
+ * The first record is sent when the application starts, and each following
+ * record after the same delay, divided by the "Speed" attribute, as in the
+ * recording.  Records whose capture was truncated (snap length) are padded
+ * with zeros up to their original length, unless "UseOriginalLength" is
+ * false.
+ *
+ * Packets are either:
+ * - sent on a socket of type "Protocol" connected to "Remote" (the default
+ *   mode), in which case only the transport payload of the records is sent,
+ *   when the link, IPv4 or IPv6 and UDP or TCP headers can be recognized,
+ *   or the whole record otherwise; or
+ * - handed to the NetDevice given by the "Device" attribute, in which case
+ *   the link-layer header of the records is removed and its destination
+ *   address (Ethernet) and protocol number are used for NetDevice::Send;
+ *   records without a destination are sent to the broadcast address.
+ *
+ * Recognized link-layer types are Ethernet (with VLAN tags), PPP, Linux
+ * cooked capture, BSD loopback and raw IPv4/IPv6.
+ */
+class PcapReplayApplication : public Application
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PcapReplayApplication ();
+
+  virtual ~PcapReplayApplication ();
+
+  /**
+   * \return the number of packets sent since the application was created
+   */
+  uint64_t GetSent (void) const;
+
+  /**
+   * \brief Get the socket this application is attached to.
+   * \return pointer to associated socket (null in device mode)
+   */
+  Ptr<Socket> GetSocket (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  // inherited from Application base class.
+  virtual void StartApplication (void);
+  virtual void StopApplication (void);
+
+  /// What is known of a recorded frame
+  struct FrameInfo
+  {
+    uint32_t linkHeaderSize;  //!< size of the link-layer header
+    uint16_t protocol;        //!< EtherType of the link-layer payload (0 if unknown)
+    bool hasDestination;      //!< whether destination is known
+    Mac48Address destination; //!< link-layer destination
+    uint32_t payloadOffset;   //!< offset of the transport payload (0 if unknown)
+  };
+
+  /**
+   * \brief Parse the headers of a record
+   * \param record the record
+   * \param [out] info what could be parsed
+   */
+  static void ParseFrame (const MappedPcapFile::Record &record, FrameInfo &info);
+
+  /**
+   * \brief Schedule the transmission of the next record, if any
+   */
+  void ScheduleNext (void);
+  /**
+   * \brief Send the current record
+   */
+  void SendRecord (void);
+
+  std::string m_filename;         //!< pcap or pcapng file to replay
+  double m_speed;                 //!< replay speed factor
+  uint64_t m_maxPackets;          //!< maximum number of packets to send (0 means no limit)
+  bool m_useOriginalLength;       //!< pad truncated records to their original length
+  TypeId m_tid;                   //!< socket factory type
+  Address m_peer;                 //!< remote address
+  Ptr<NetDevice> m_device;        //!< device to send frames to (device mode)
+  Ptr<Socket> m_socket;           //!< socket (socket mode)
+
+  MappedPcapFile m_file;          //!< the mapped file
+  MappedPcapFile::Record m_record; //!< next record to send
+  uint64_t m_firstTimeNs;         //!< timestamp of the first record
+  Time m_startTime;               //!< time the first record was sent
+  uint64_t m_sentThisRun;         //!< packets sent since the last start
+  uint64_t m_sent;                //!< packets sent since the creation
+  EventId m_sendEvent;            //!< next transmission
+
+  /// Traced Callback: sent packets
+  TracedCallback<Ptr<const Packet> > m_txTrace;
+};
+
+} // namespace ns3
+
+#endif /* PCAP_REPLAY_APPLICATION_H */
@@ -0,0 +1,293 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "ns3/test.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/net-device-container.h"
+#include "ns3/pcap-file.h"
+#include "ns3/trace-helper.h"
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/pcap-replay-application.h"
+#include "ns3/pcap-replay-helper.h"
+#include "ns3/mapped-pcap-file.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * Replay a pcap and a pcapng file on a SimpleNetDevice and check the
+ * timing, sizes and protocols of the frames received by the peer.
+ */
+class PcapReplayApplicationTestCase : public TestCase
+{
+public:
+  PcapReplayApplicationTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Receive callback of the peer device
+   * \param device the device
+   * \param packet the packet
+   * \param protocol the protocol
+   * \param from the sender address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  /**
+   * Write a libpcap file of Ethernet frames, truncated to 40 bytes
+   * \param filename the file name
+   */
+  void WritePcap (std::string filename);
+  /**
+   * Write a pcapng file with a nanosecond-resolution interface
+   * \param filename the file name
+   */
+  void WritePcapNg (std::string filename);
+  /**
+   * Replay a file and collect what is received
+   * \param filename the file name
+   * \param speed the replay speed
+   * \param useOriginalLength value of the UseOriginalLength attribute
+   */
+  void Replay (std::string filename, double speed, bool useOriginalLength);
+
+  std::vector<Time> m_times;       //!< reception times
+  std::vector<uint32_t> m_sizes;   //!< received sizes
+  std::vector<uint16_t> m_protocols; //!< received protocols
+};
+
+PcapReplayApplicationTestCase::PcapReplayApplicationTestCase ()
+  : TestCase ("Replay pcap and pcapng files on a device")
+{
+}
+
+bool
+PcapReplayApplicationTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from)
+{
+  m_times.push_back (Simulator::Now ());
+  m_sizes.push_back (packet->GetSize ());
+  m_protocols.push_back (protocol);
+  return true;
+}
+
+/**
+ * Build a broadcast Ethernet frame carrying an IPv4/UDP packet
+ * \param payload the UDP payload size
+ * \return the frame
+ */
+static std::vector<uint8_t>
+MakeFrame (uint32_t payload)
+{
+  std::vector<uint8_t> frame (14 + 20 + 8 + payload, 0);
+  std::memset (&frame[0], 0xff, 6);
+  frame[12] = 0x08;
+  frame[13] = 0x00;
+  frame[14] = 0x45;
+  frame[14 + 9] = 17;
+  return frame;
+}
+
+void
+PcapReplayApplicationTestCase::WritePcap (std::string filename)
+{
+  PcapFile file;
+  file.Open (filename, std::ios::out);
+  file.Init (PcapHelper::DLT_EN10MB, 40);
+  std::vector<uint8_t> frame = MakeFrame (100);
+  file.Write (100, 0, &frame[0], frame.size ());
+  file.Write (100, 500000, &frame[0], frame.size ());
+  file.Write (101, 0, &frame[0], frame.size ());
+  file.Close ();
+}
+
+/**
+ * Append a 32-bit value in host byte order
+ * \param v the vector to append to
+ * \param x the value
+ */
+static void
+Append32 (std::vector<uint8_t> &v, uint32_t x)
+{
+  uint8_t b[4];
+  std::memcpy (b, &x, 4);
+  v.insert (v.end (), b, b + 4);
+}
+
+/**
+ * Append a 16-bit value in host byte order
+ * \param v the vector to append to
+ * \param x the value
+ */
+static void
+Append16 (std::vector<uint8_t> &v, uint16_t x)
+{
+  uint8_t b[2];
+  std::memcpy (b, &x, 2);
+  v.insert (v.end (), b, b + 2);
+}
+
+void
+PcapReplayApplicationTestCase::WritePcapNg (std::string filename)
+{
+  std::vector<uint8_t> data;
+  // Section Header Block
+  Append32 (data, 0x0a0d0d0a);
+  Append32 (data, 28);
+  Append32 (data, 0x1a2b3c4d);
+  Append16 (data, 1);
+  Append16 (data, 0);
+  Append32 (data, 0xffffffff);
+  Append32 (data, 0xffffffff);
+  Append32 (data, 28);
+  // Interface Description Block, raw IP, nanosecond resolution
+  Append32 (data, 1);
+  Append32 (data, 32);
+  Append16 (data, PcapHelper::DLT_RAW);
+  Append16 (data, 0);
+  Append32 (data, 0);
+  Append16 (data, 9);
+  Append16 (data, 1);
+  data.push_back (9);
+  data.push_back (0);
+  data.push_back (0);
+  data.push_back (0);
+  Append32 (data, 0);
+  Append32 (data, 32);
+  // Two Enhanced Packet Blocks, 1 ms apart
+  std::vector<uint8_t> frame = MakeFrame (12);
+  frame.erase (frame.begin (), frame.begin () + 14);
+  uint64_t times[2] = {5000000000ULL, 5001000000ULL};
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      Append32 (data, 6);
+      Append32 (data, 32 + frame.size ());
+      Append32 (data, 0);
+      Append32 (data, times[i] >> 32);
+      Append32 (data, times[i] & 0xffffffff);
+      Append32 (data, frame.size ());
+      Append32 (data, frame.size ());
+      data.insert (data.end (), frame.begin (), frame.end ());
+      Append32 (data, 32 + frame.size ());
+    }
+  // A statistics block, to be skipped
+  Append32 (data, 5);
+  Append32 (data, 12);
+  Append32 (data, 12);
+
+  std::ofstream file (filename.c_str (), std::ios::binary);
+  file.write (reinterpret_cast<const char *> (&data[0]), data.size ());
+}
+
+void
+PcapReplayApplicationTestCase::Replay (std::string filename, double speed, bool useOriginalLength)
+{
+  m_times.clear ();
+  m_sizes.clear ();
+  m_protocols.clear ();
+
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> rxDev = CreateObject<SimpleNetDevice> ();
+  a->AddDevice (txDev);
+  b->AddDevice (rxDev);
+  txDev->SetAddress (Mac48Address::Allocate ());
+  rxDev->SetAddress (Mac48Address::Allocate ());
+  txDev->SetChannel (channel);
+  rxDev->SetChannel (channel);
+  rxDev->SetReceiveCallback (MakeCallback (&PcapReplayApplicationTestCase::Receive, this));
+
+  PcapReplayHelper helper (filename);
+  helper.SetAttribute ("Speed", DoubleValue (speed));
+  helper.SetAttribute ("UseOriginalLength", BooleanValue (useOriginalLength));
+  ApplicationContainer apps = helper.Install (NetDeviceContainer (txDev));
+  apps.Start (Seconds (1));
+  apps.Stop (Seconds (10));
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+void
+PcapReplayApplicationTestCase::DoRun (void)
+{
+  std::string pcap = CreateTempDirFilename ("pcap-replay-test.pcap");
+  WritePcap (pcap);
+
+  MappedPcapFile mapped;
+  NS_TEST_ASSERT_MSG_EQ (mapped.Open (pcap), true, "The pcap file can be mapped");
+  MappedPcapFile::Record record;
+  uint32_t n = 0;
+  while (mapped.Next (record))
+    {
+      NS_TEST_EXPECT_MSG_EQ (record.capturedLength, 40, "Records are truncated to the snap length");
+      NS_TEST_EXPECT_MSG_EQ (record.originalLength, 142, "Original length of the records");
+      n++;
+    }
+  NS_TEST_EXPECT_MSG_EQ (n, 3, "Three records in the pcap file");
+  mapped.Close ();
+
+  Replay (pcap, 2, true);
+  NS_TEST_ASSERT_MSG_EQ (m_times.size (), 3, "All the records should be replayed");
+  NS_TEST_EXPECT_MSG_EQ (m_times[0], Seconds (1), "The first record is sent at start");
+  NS_TEST_EXPECT_MSG_EQ (m_times[1], Seconds (1.25), "Delays are divided by the speed");
+  NS_TEST_EXPECT_MSG_EQ (m_times[2], Seconds (1.5), "Delays are divided by the speed");
+  NS_TEST_EXPECT_MSG_EQ (m_sizes[0], 142 - 14, "Truncated records are padded, without Ethernet header");
+  NS_TEST_EXPECT_MSG_EQ (m_protocols[0], 0x0800, "Protocol taken from the EtherType");
+
+  Replay (pcap, 1, false);
+  NS_TEST_ASSERT_MSG_EQ (m_times.size (), 3, "All the records should be replayed");
+  NS_TEST_EXPECT_MSG_EQ (m_times[2], Seconds (2), "Recorded delays are kept");
+  NS_TEST_EXPECT_MSG_EQ (m_sizes[0], 40 - 14, "Truncated records are not padded");
+
+  std::string pcapng = CreateTempDirFilename ("pcap-replay-test.pcapng");
+  WritePcapNg (pcapng);
+  Replay (pcapng, 1, true);
+  NS_TEST_ASSERT_MSG_EQ (m_times.size (), 2, "Both packet blocks should be replayed");
+  NS_TEST_EXPECT_MSG_EQ (m_times[1] - m_times[0], MilliSeconds (1), "Nanosecond timestamps");
+  NS_TEST_EXPECT_MSG_EQ (m_sizes[0], 40, "Raw IP records are sent whole");
+  NS_TEST_EXPECT_MSG_EQ (m_protocols[0], 0x0800, "Protocol taken from the IP version");
+}
+
+/**
+ * \ingroup applications-test
+ * \ingroup tests
+ *
+ * \brief PcapReplayApplication TestSuite
+ */
+class PcapReplayApplicationTestSuite : public TestSuite
+{
+public:
+  PcapReplayApplicationTestSuite ()
+    : TestSuite ("applications-pcap-replay", UNIT)
+  {
+    AddTestCase (new PcapReplayApplicationTestCase (), TestCase::QUICK);
+  }
+};
+
+static PcapReplayApplicationTestSuite g_pcapReplayApplicationTestSuite; //!< Static variable for test initialization
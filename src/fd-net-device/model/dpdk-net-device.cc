@@ -476,13 +476,9 @@ DpdkNetDevice::Write (uint8_t *buffer, size_t length)
 void
 DpdkNetDevice::DoFinishStoppingDevice (void)
 {
-  CriticalSection cs (m_pendingReadMutex);
-
-  while (!m_pendingQueue.empty ())
+  std::pair<uint8_t *, ssize_t> next;
+  while (m_pendingQueue.Pop (next))
     {
-      std::pair<uint8_t *, ssize_t> next = m_pendingQueue.front ();
-      m_pendingQueue.pop ();
-
       FreeBuffer (next.first);
     }
 }
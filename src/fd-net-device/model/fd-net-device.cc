@@ -147,6 +147,11 @@ FdNetDevice::GetTypeId (void)
                      "This is a non-promiscuous trace,",
                      MakeTraceSourceAccessor (&FdNetDevice::m_macRxTrace),
                      "ns3::Packet::TracedCallback")
+    .AddTraceSource ("RxQueueDrop",
+                     "A packet read from the network has been dropped "
+                     "because the read queue is full (see RxQueueSize).",
+                     MakeTraceSourceAccessor (&FdNetDevice::m_rxQueueDropTrace),
+                     "ns3::Packet::TracedCallback")
 
     //
     // Trace sources designed to simulate a packet sniffer facility (tcpdump).
@@ -178,6 +183,7 @@ FdNetDevice::FdNetDevice ()
     m_stopEvent ()
 {
   NS_LOG_FUNCTION (this);
+  m_forwardUpPending = false;
 }
 
 FdNetDevice::~FdNetDevice ()
@@ -248,6 +254,10 @@ FdNetDevice::StartDevice (void)
       return;
     }
 
+  // The reader thread is not running yet, so the ring can be resized
+  m_pendingQueue.SetCapacity (m_maxPendingReads);
+  m_forwardUpPending = false;
+
   m_fdReader = DoCreateFdReader ();
   m_fdReader->Start (m_fd, MakeCallback (&FdNetDevice::ReceiveCallback, this));
 
@@ -296,10 +306,9 @@ FdNetDevice::StopDevice (void)
       m_fd = -1;
     }
 
-  while (!m_pendingQueue.empty ())
+  std::pair<uint8_t *, ssize_t> next;
+  while (m_pendingQueue.Pop (next))
     {
-      std::pair<uint8_t *, ssize_t> next = m_pendingQueue.front ();
-      m_pendingQueue.pop ();
       FreeBuffer (next.first);
     }
 
@@ -310,29 +319,24 @@ void
 FdNetDevice::ReceiveCallback (uint8_t *buf, ssize_t len)
 {
   NS_LOG_FUNCTION (this << static_cast<void *> (buf) << len);
-  bool skip = false;
-
-  {
-    CriticalSection cs (m_pendingReadMutex);
-    if (m_pendingQueue.size () >= m_maxPendingReads)
-      {
-        NS_LOG_WARN ("Packet dropped");
-        skip = true;
-      }
-    else
-      {
-        m_pendingQueue.push (std::make_pair (buf, len));
-      }
-  }
 
-  if (skip)
+  // The size seen by the producer can only overestimate the ring occupancy
+  if (m_pendingQueue.GetSize () >= m_maxPendingReads
+      || !m_pendingQueue.Push (std::make_pair (buf, len)))
     {
+      NS_LOG_WARN ("Packet dropped");
+      // the packet is built and traced in the simulator thread
+      Simulator::ScheduleWithContext (m_nodeId, Time (0), MakeEvent (&FdNetDevice::DropFrame, this, buf, len));
       struct timespec time = {
         0, 100000000L
       };                                        // 100 ms
       nanosleep (&time, NULL);
+      return;
     }
-  else
+
+  // Only wake up the simulator thread if no drain is pending already: a
+  // single event then forwards all the frames read in the meantime.
+  if (!m_forwardUpPending.exchange (true))
     {
       Simulator::ScheduleWithContext (m_nodeId, Time (0), MakeEvent (&FdNetDevice::ForwardUp, this));
     }
@@ -419,23 +423,35 @@ FdNetDevice::ForwardUp (void)
 {
   NS_LOG_FUNCTION (this);
 
-  uint8_t *buf = 0;
-  ssize_t len = 0;
+  // Clear the flag before draining, so that a frame pushed after the last
+  // Pop below schedules a new event
+  m_forwardUpPending = false;
 
-  if (m_pendingQueue.empty())
-  {
-    NS_LOG_LOGIC ("buffer is empty, probably the device is stopped.");
-    return;
-  }
+  std::pair<uint8_t *, ssize_t> next;
+  while (m_pendingQueue.Pop (next))
+    {
+      ForwardFrameUp (next.first, next.second);
+    }
+}
 
-  {
-    CriticalSection cs (m_pendingReadMutex);
-    std::pair<uint8_t *, ssize_t> next = m_pendingQueue.front ();
-    m_pendingQueue.pop ();
+void
+FdNetDevice::DropFrame (uint8_t *buf, ssize_t len)
+{
+  NS_LOG_FUNCTION (this << static_cast<void *> (buf) << len);
 
-    buf = next.first;
-    len = next.second;
-  }
+  if (m_encapMode == DIXPI)
+    {
+      RemovePIHeader (buf, len);
+    }
+  Ptr<Packet> packet = Create<Packet> (reinterpret_cast<const uint8_t *> (buf), len);
+  FreeBuffer (buf);
+  m_rxQueueDropTrace (packet);
+}
+
+void
+FdNetDevice::ForwardFrameUp (uint8_t *buf, ssize_t len)
+{
+  NS_LOG_FUNCTION (this << static_cast<void *> (buf) << len);
 
   NS_LOG_LOGIC ("buffer: " << static_cast<void *> (buf) << " length: " << len);
 
@@ -34,10 +34,10 @@
 #include "ns3/system-condition.h"
 #include "ns3/traced-callback.h"
 #include "ns3/unix-fd-reader.h"
-#include "ns3/system-mutex.h"
+#include "ns3/spsc-ring.h"
 
+#include <atomic>
 #include <utility>
-#include <queue>
 
 namespace ns3 {
 
@@ -225,14 +225,16 @@ protected:
   void ReceiveCallback (uint8_t *buf, ssize_t len);
 
   /**
-   * Mutex to increase pending read counter.
+   * Buffers received by the reader thread and not yet processed by the
+   * simulator thread.  The reader thread is the only producer and the
+   * simulator thread the only consumer, so no lock is needed.
    */
-  SystemMutex m_pendingReadMutex;
+  SpscRing< std::pair<uint8_t *, ssize_t> > m_pendingQueue;
 
   /**
-   * Number of packets that were received and scheduled for read but not yet read.
+   * Whether a ForwardUp event is already scheduled to drain m_pendingQueue.
    */
-  std::queue< std::pair<uint8_t *, ssize_t> > m_pendingQueue;
+  std::atomic<bool> m_forwardUpPending;
 
 private:
   /**
@@ -270,10 +272,25 @@ private:
   virtual void DoFinishStoppingDevice (void);
 
   /**
-   * Forward the frame to the appropriate callback for processing
+   * Forward all the pending frames to the appropriate callback for processing
    */
   void ForwardUp (void);
 
+  /**
+   * Forward a frame to the appropriate callback for processing
+   * \param buf the frame buffer, freed by this method
+   * \param len the frame length
+   */
+  void ForwardFrameUp (uint8_t *buf, ssize_t len);
+
+  /**
+   * Fire the RxQueueDrop trace for a frame which did not fit in the read
+   * queue
+   * \param buf the frame buffer, freed by this method
+   * \param len the frame length
+   */
+  void DropFrame (uint8_t *buf, ssize_t len);
+
   /**
    * Start Sending a Packet Down the Wire.
    * @param p packet to send
@@ -445,6 +462,15 @@ private:
    */
   TracedCallback<Ptr<const Packet> > m_phyRxDropTrace;
 
+  /**
+   * The trace source fired for the frames read from the file descriptor
+   * which are dropped because the read queue is full (see the RxQueueSize
+   * attribute).  It is fired in the simulator thread.
+   *
+   * \see class CallBackTraceSource
+   */
+  TracedCallback<Ptr<const Packet> > m_rxQueueDropTrace;
+
   /**
    * A trace source that emulates a non-promiscuous protocol sniffer connected
    * to the device.  Unlike your average everyday sniffer, this trace source
@@ -0,0 +1,182 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/fd-net-device.h"
+
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup fd-net-device
+ * \defgroup fd-net-device-test FdNetDevice module tests
+ */
+
+/**
+ * \ingroup fd-net-device-test
+ * \ingroup tests
+ *
+ * \brief Check the frames dropped when the read queue of a FdNetDevice is full
+ *
+ * Frames are written to a socket pair while the simulator thread is busy,
+ * so that the reader thread fills the read queue: the frames that do not
+ * fit must be reported by the RxQueueDrop trace, and the queued ones must
+ * still be received.
+ */
+class FdNetDeviceRxQueueDropTestCase : public TestCase
+{
+public:
+  FdNetDeviceRxQueueDropTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Write the frames and block the simulator thread until they are read
+   * \param fd the file descriptor to write the frames to
+   * \param readFd the file descriptor of the device
+   */
+  void WriteFrames (int fd, int readFd);
+  /**
+   * \brief Receive a frame from the device
+   * \param device the receiving device
+   * \param packet the received packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \return true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet, uint16_t protocol, const Address &from);
+  /**
+   * \brief Count a frame dropped by the device
+   * \param packet the dropped frame
+   */
+  void Drop (Ptr<const Packet> packet);
+
+  uint32_t m_nFrames;    //!< Number of frames written
+  uint32_t m_frameSize;  //!< Size of the frames written
+  uint32_t m_nReceived;  //!< Number of frames received
+  uint32_t m_nDropped;   //!< Number of frames dropped
+  uint32_t m_droppedBytes; //!< Size of the frames dropped
+};
+
+FdNetDeviceRxQueueDropTestCase::FdNetDeviceRxQueueDropTestCase ()
+  : TestCase ("FdNetDevice read queue overflow"),
+    m_nFrames (6),
+    m_frameSize (64),
+    m_nReceived (0),
+    m_nDropped (0),
+    m_droppedBytes (0)
+{
+}
+
+void
+FdNetDeviceRxQueueDropTestCase::WriteFrames (int fd, int readFd)
+{
+  // broadcast Ethernet frames carrying IPv4
+  uint8_t frame[64];
+  std::memset (frame, 0, sizeof (frame));
+  std::memset (frame, 0xff, 6);
+  frame[6] = 0x02;
+  frame[11] = 0x01;
+  frame[12] = 0x08;
+  frame[13] = 0x00;
+  for (uint32_t i = 0; i < m_nFrames; i++)
+    {
+      ssize_t written = write (fd, frame, m_frameSize);
+      NS_TEST_ASSERT_MSG_EQ (written, static_cast<ssize_t> (m_frameSize), "Frame written");
+    }
+
+  // wait for the reader thread to read all the frames
+  int pending = 1;
+  for (uint32_t i = 0; i < 500 && pending > 0; i++)
+    {
+      usleep (10000);
+      NS_TEST_ASSERT_MSG_EQ (ioctl (readFd, FIONREAD, &pending), 0, "Pending bytes");
+    }
+  NS_TEST_ASSERT_MSG_EQ (pending, 0, "All the frames are read");
+  // and for the last frame to be queued or dropped
+  usleep (200000);
+}
+
+bool
+FdNetDeviceRxQueueDropTestCase::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                         uint16_t protocol, const Address &from)
+{
+  m_nReceived++;
+  return true;
+}
+
+void
+FdNetDeviceRxQueueDropTestCase::Drop (Ptr<const Packet> packet)
+{
+  m_nDropped++;
+  m_droppedBytes += packet->GetSize ();
+}
+
+void
+FdNetDeviceRxQueueDropTestCase::DoRun (void)
+{
+  int fds[2];
+  NS_TEST_ASSERT_MSG_EQ (socketpair (AF_UNIX, SOCK_DGRAM, 0, fds), 0, "Socket pair created");
+
+  uint32_t queueSize = 2;
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<FdNetDevice> device = CreateObject<FdNetDevice> ();
+  device->SetAttribute ("RxQueueSize", UintegerValue (queueSize));
+  device->SetAddress (Mac48Address::Allocate ());
+  device->SetFileDescriptor (fds[0]);
+  node->AddDevice (device);
+  device->SetReceiveCallback (MakeCallback (&FdNetDeviceRxQueueDropTestCase::Receive, this));
+  device->TraceConnectWithoutContext ("RxQueueDrop", MakeCallback (&FdNetDeviceRxQueueDropTestCase::Drop, this));
+  device->Start (Seconds (0));
+  device->Stop (Seconds (1));
+
+  Simulator::Schedule (Seconds (0.1), &FdNetDeviceRxQueueDropTestCase::WriteFrames, this, fds[1], fds[0]);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  close (fds[1]);
+
+  NS_TEST_EXPECT_MSG_EQ (m_nReceived, queueSize, "The queued frames are received");
+  NS_TEST_EXPECT_MSG_EQ (m_nDropped, m_nFrames - queueSize, "The other frames are dropped");
+  NS_TEST_EXPECT_MSG_EQ (m_droppedBytes, (m_nFrames - queueSize) * m_frameSize, "The dropped frames are traced whole");
+}
+
+/**
+ * \ingroup fd-net-device-test
+ * \ingroup tests
+ *
+ * \brief FdNetDevice TestSuite
+ */
+class FdNetDeviceTestSuite : public TestSuite
+{
+public:
+  FdNetDeviceTestSuite ()
+    : TestSuite ("fd-net-device", UNIT)
+  {
+    AddTestCase (new FdNetDeviceRxQueueDropTestCase (), TestCase::QUICK);
+  }
+};
+
+static FdNetDeviceTestSuite g_fdNetDeviceTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/string.h"
+
+#include <algorithm>
+
+using namespace ns3;
+
+/**
+ * \ingroup flow-monitor
+ * \defgroup flow-monitor-test FlowMonitor module tests
+ */
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief Check the flow statistics of a TCP sender using segmentation offload
+ *
+ * A bulk transfer is monitored with and without TSO (see the TcpSocketBase
+ * "Tso" attribute) on a link with a 1500 bytes MTU: the probe of the sender
+ * must see each segment, so the statistics of the data flow are the same,
+ * and no packet is reported lost.
+ */
+class FlowMonitorTsoTestCase : public TestCase
+{
+public:
+  FlowMonitorTsoTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Run a monitored bulk transfer
+   * \param tso whether the sender uses TSO
+   * \return the statistics of the data flow
+   */
+  FlowMonitor::FlowStats RunTransfer (bool tso);
+
+  /**
+   * \brief Fill the sender buffer
+   * \param socket the sender socket
+   * \param available the available space in the buffer
+   */
+  void Send (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Accept a connection
+   * \param socket the accepted socket
+   * \param from the address of the peer
+   */
+  void Accept (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Read the received data
+   * \param socket the receiver socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  uint32_t m_totalBytes;    //!< Bytes to transfer
+  uint32_t m_sentBytes;     //!< Bytes given to the sender socket
+  uint32_t m_receivedBytes; //!< Bytes read from the receiver socket
+};
+
+FlowMonitorTsoTestCase::FlowMonitorTsoTestCase ()
+  : TestCase ("FlowMonitor statistics with TCP segmentation offload"),
+    m_totalBytes (1000000),
+    m_sentBytes (0),
+    m_receivedBytes (0)
+{
+}
+
+void
+FlowMonitorTsoTestCase::Send (Ptr<Socket> socket, uint32_t available)
+{
+  while (m_sentBytes < m_totalBytes && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (socket->GetTxAvailable (), m_totalBytes - m_sentBytes);
+      int sent = socket->Send (Create<Packet> (size));
+      if (sent <= 0)
+        {
+          break;
+        }
+      m_sentBytes += sent;
+    }
+}
+
+void
+FlowMonitorTsoTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&FlowMonitorTsoTestCase::Receive, this));
+}
+
+void
+FlowMonitorTsoTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      m_receivedBytes += p->GetSize ();
+    }
+}
+
+FlowMonitor::FlowStats
+FlowMonitorTsoTestCase::RunTransfer (bool tso)
+{
+  m_sentBytes = 0;
+  m_receivedBytes = 0;
+
+  NodeContainer nodes;
+  nodes.Create (2);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("100Mbps"));
+  simple.SetChannelAttribute ("Delay", StringValue ("5ms"));
+  simple.SetQueue ("ns3::DropTailQueue", "MaxSize", StringValue ("10000p"));
+  NetDeviceContainer devices = simple.Install (nodes);
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      devices.Get (i)->SetMtu (1500);
+    }
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer interfaces = ipv4.Assign (devices);
+
+  FlowMonitorHelper flowmon;
+  Ptr<FlowMonitor> monitor = flowmon.Install (nodes);
+
+  Ptr<Socket> receiver = nodes.Get (1)->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  receiver->Bind (InetSocketAddress (Ipv4Address::GetAny (), 5000));
+  receiver->Listen ();
+  receiver->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                               MakeCallback (&FlowMonitorTsoTestCase::Accept, this));
+
+  Ptr<Socket> sender = nodes.Get (0)->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  sender->SetAttribute ("SegmentSize", UintegerValue (1448));
+  sender->SetAttribute ("SndBufSize", UintegerValue (1 << 20));
+  sender->SetAttribute ("Tso", BooleanValue (tso));
+  sender->SetSendCallback (MakeCallback (&FlowMonitorTsoTestCase::Send, this));
+  sender->Connect (InetSocketAddress (interfaces.GetAddress (1), 5000));
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_receivedBytes, m_totalBytes, "All the data is received");
+  monitor->CheckForLostPackets ();
+  Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier> (flowmon.GetClassifier ());
+  FlowMonitor::FlowStats stats;
+  uint32_t nFlows = 0;
+  FlowMonitor::FlowStatsContainer flows = monitor->GetFlowStats ();
+  for (FlowMonitor::FlowStatsContainerCI i = flows.begin (); i != flows.end (); i++)
+    {
+      if (classifier->FindFlow (i->first).sourceAddress == interfaces.GetAddress (0))
+        {
+          stats = i->second;
+          nFlows++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (nFlows, 1, "One data flow");
+  Simulator::Destroy ();
+  return stats;
+}
+
+void
+FlowMonitorTsoTestCase::DoRun (void)
+{
+  FlowMonitor::FlowStats reference = RunTransfer (false);
+  FlowMonitor::FlowStats tso = RunTransfer (true);
+
+  NS_TEST_EXPECT_MSG_EQ (reference.txPackets, reference.rxPackets, "No loss without TSO");
+  NS_TEST_EXPECT_MSG_GT (reference.txPackets, m_totalBytes / 1448, "One packet per segment without TSO");
+  NS_TEST_EXPECT_MSG_EQ (tso.txPackets, reference.txPackets, "One packet per segment with TSO");
+  NS_TEST_EXPECT_MSG_EQ (tso.rxPackets, reference.rxPackets, "Received packets with TSO");
+  NS_TEST_EXPECT_MSG_EQ (tso.txBytes, reference.txBytes, "Sent bytes with TSO");
+  NS_TEST_EXPECT_MSG_EQ (tso.rxBytes, reference.rxBytes, "Received bytes with TSO");
+  NS_TEST_EXPECT_MSG_EQ (tso.lostPackets, 0, "No packet lost with TSO");
+  NS_TEST_EXPECT_MSG_EQ (tso.delaySum, reference.delaySum, "Same delays with TSO");
+}
+
+/**
+ * \ingroup flow-monitor-test
+ * \ingroup tests
+ *
+ * \brief FlowMonitor TSO TestSuite
+ */
+class FlowMonitorTsoTestSuite : public TestSuite
+{
+public:
+  FlowMonitorTsoTestSuite ()
+    : TestSuite ("flow-monitor-tso", UNIT)
+  {
+    AddTestCase (new FlowMonitorTsoTestCase (), TestCase::QUICK);
+  }
+};
+
+static FlowMonitorTsoTestSuite g_flowMonitorTsoTestSuite; //!< Static variable for test initialization
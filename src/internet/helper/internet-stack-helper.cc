@@ -45,6 +45,7 @@
 #include "ns3/ipv6-extension-demux.h"
 #include "ns3/ipv6-extension-header.h"
 #include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/mptcp-socket-factory.h"
 #include "ns3/global-router-interface.h"
 #include "ns3/traffic-control-layer.h"
 #include <limits>
@@ -247,6 +248,11 @@ InternetStackHelper::AssignStreams (NodeContainer c, int64_t stream)
               currentStream += icmpv6L4Protocol->AssignStreams (currentStream);
             }
         }
+      Ptr<MpTcpSocketFactory> mptcpFactory = node->GetObject<MpTcpSocketFactory> ();
+      if (mptcpFactory != 0)
+        {
+          currentStream += mptcpFactory->AssignStreams (currentStream);
+        }
     }
   return (currentStream - stream);
 }
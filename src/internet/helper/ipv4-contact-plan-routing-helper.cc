@@ -0,0 +1,71 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-contact-plan-routing-helper.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-contact-plan-routing.h"
+#include "ns3/node.h"
+#include "ns3/log.h"
+#include "ns3/abort.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4ContactPlanRoutingHelper");
+
+Ipv4ContactPlanRoutingHelper::Ipv4ContactPlanRoutingHelper ()
+  : m_plan (CreateObject<ContactPlan> ())
+{
+}
+
+Ipv4ContactPlanRoutingHelper::Ipv4ContactPlanRoutingHelper (Ptr<ContactPlan> plan)
+  : m_plan (plan)
+{
+}
+
+Ipv4ContactPlanRoutingHelper*
+Ipv4ContactPlanRoutingHelper::Copy (void) const
+{
+  return new Ipv4ContactPlanRoutingHelper (*this);
+}
+
+Ptr<Ipv4RoutingProtocol>
+Ipv4ContactPlanRoutingHelper::Create (Ptr<Node> node) const
+{
+  NS_LOG_LOGIC ("Adding contact plan routing protocol to node " << node->GetId ());
+  Ptr<Ipv4ContactPlanRouting> routing = CreateObject<Ipv4ContactPlanRouting> ();
+  routing->SetContactPlan (m_plan);
+  return routing;
+}
+
+Ptr<ContactPlan>
+Ipv4ContactPlanRoutingHelper::GetContactPlan (void) const
+{
+  return m_plan;
+}
+
+void
+Ipv4ContactPlanRoutingHelper::AddLink (Ptr<NetDevice> a, Ptr<NetDevice> b, Time start, Time stop, Time delay)
+{
+  Ptr<Node> nodeA = a->GetNode ();
+  Ptr<Node> nodeB = b->GetNode ();
+  int32_t ifA = nodeA->GetObject<Ipv4> ()->GetInterfaceForDevice (a);
+  int32_t ifB = nodeB->GetObject<Ipv4> ()->GetInterfaceForDevice (b);
+  NS_ABORT_MSG_IF (ifA < 0 || ifB < 0, "The devices of a contact need an IPv4 interface");
+  m_plan->AddContact (nodeA, ifA, nodeB, ifB, start, stop, delay);
+  m_plan->AddContact (nodeB, ifB, nodeA, ifA, start, stop, delay);
+}
+
+} // namespace ns3
@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_CONTACT_PLAN_ROUTING_HELPER_H
+#define IPV4_CONTACT_PLAN_ROUTING_HELPER_H
+
+#include "ns3/nstime.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4-routing-helper.h"
+#include "ns3/contact-plan.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4Helpers
+ *
+ * \brief Helper class that adds ns3::Ipv4ContactPlanRouting objects
+ *
+ * All the routing protocols created by a helper share its ContactPlan.
+ */
+class Ipv4ContactPlanRoutingHelper : public Ipv4RoutingHelper
+{
+public:
+  /**
+   * \brief Construct a helper with an empty contact plan
+   */
+  Ipv4ContactPlanRoutingHelper ();
+
+  /**
+   * \brief Construct a helper following an existing contact plan
+   * \param plan the contact plan
+   */
+  Ipv4ContactPlanRoutingHelper (Ptr<ContactPlan> plan);
+
+  /**
+   * \returns pointer to clone of this Ipv4ContactPlanRoutingHelper
+   *
+   * This method is mainly for internal use by the other helpers;
+   * clients are expected to free the dynamic memory allocated by this method
+   */
+  Ipv4ContactPlanRoutingHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   *
+   * This method will be called by ns3::InternetStackHelper::Install
+   */
+  virtual Ptr<Ipv4RoutingProtocol> Create (Ptr<Node> node) const;
+
+  /**
+   * \return the contact plan of the routing protocols
+   */
+  Ptr<ContactPlan> GetContactPlan (void) const;
+
+  /**
+   * \brief Add the contacts of a bidirectional link between two devices
+   *
+   * The devices must already have an IPv4 interface.
+   *
+   * \param a a device
+   * \param b the device at the other end of the link
+   * \param start the time the link becomes available
+   * \param stop the time the link becomes unavailable
+   * \param delay the delay of the link
+   */
+  void AddLink (Ptr<NetDevice> a, Ptr<NetDevice> b, Time start, Time stop, Time delay);
+
+private:
+  Ptr<ContactPlan> m_plan; //!< the contact plan
+};
+
+} // namespace ns3
+
+#endif /* IPV4_CONTACT_PLAN_ROUTING_HELPER_H */
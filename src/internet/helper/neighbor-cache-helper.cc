@@ -0,0 +1,215 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <map>
+#include "neighbor-cache-helper.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/channel-list.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ndisc-cache.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NeighborCacheHelper");
+
+NeighborCacheHelper::NeighborCacheHelper ()
+  : m_permanent (false)
+{
+}
+
+void
+NeighborCacheHelper::SetPermanent (bool permanent)
+{
+  m_permanent = permanent;
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCache (void) const
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < ChannelList::GetNChannels (); i++)
+    {
+      PopulateNeighborCache (ChannelList::GetChannel (i));
+    }
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCache (Ptr<Channel> channel) const
+{
+  NS_LOG_FUNCTION (this << channel);
+  std::vector<Ptr<NetDevice> > devices;
+  for (std::size_t i = 0; i < channel->GetNDevices (); i++)
+    {
+      devices.push_back (channel->GetDevice (i));
+    }
+  PopulateDevices (devices);
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCache (const NetDeviceContainer &devices) const
+{
+  NS_LOG_FUNCTION (this);
+  std::map<Ptr<Channel>, std::vector<Ptr<NetDevice> > > channels;
+  for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); i++)
+    {
+      Ptr<Channel> channel = (*i)->GetChannel ();
+      if (channel)
+        {
+          channels[channel].push_back (*i);
+        }
+    }
+  for (auto i = channels.begin (); i != channels.end (); i++)
+    {
+      PopulateDevices (i->second);
+    }
+}
+
+void
+NeighborCacheHelper::PopulateDevices (const std::vector<Ptr<NetDevice> > &devices) const
+{
+  std::vector<Ptr<Ipv4Interface> > ipv4Interfaces;
+  std::vector<Ptr<Ipv6Interface> > ipv6Interfaces;
+  for (std::vector<Ptr<NetDevice> >::const_iterator i = devices.begin (); i != devices.end (); i++)
+    {
+      Ptr<Node> node = (*i)->GetNode ();
+      Ptr<Ipv4L3Protocol> ipv4 = node->GetObject<Ipv4L3Protocol> ();
+      if (ipv4)
+        {
+          int32_t index = ipv4->GetInterfaceForDevice (*i);
+          if (index >= 0)
+            {
+              ipv4Interfaces.push_back (ipv4->GetInterface (index));
+            }
+        }
+      Ptr<Ipv6L3Protocol> ipv6 = node->GetObject<Ipv6L3Protocol> ();
+      if (ipv6)
+        {
+          int32_t index = ipv6->GetInterfaceForDevice (*i);
+          if (index >= 0)
+            {
+              ipv6Interfaces.push_back (ipv6->GetInterface (index));
+            }
+        }
+    }
+
+  for (uint32_t i = 0; i < ipv4Interfaces.size (); i++)
+    {
+      for (uint32_t j = 0; j < ipv4Interfaces.size (); j++)
+        {
+          if (i != j)
+            {
+              AddArpEntries (ipv4Interfaces[i], ipv4Interfaces[j]);
+            }
+        }
+    }
+  for (uint32_t i = 0; i < ipv6Interfaces.size (); i++)
+    {
+      for (uint32_t j = 0; j < ipv6Interfaces.size (); j++)
+        {
+          if (i != j)
+            {
+              AddNdiscEntries (ipv6Interfaces[i], ipv6Interfaces[j]);
+            }
+        }
+    }
+}
+
+void
+NeighborCacheHelper::AddArpEntries (Ptr<Ipv4Interface> interface, Ptr<Ipv4Interface> neighbor) const
+{
+  Ptr<ArpCache> cache = interface->GetArpCache ();
+  if (!cache)
+    {
+      return;
+    }
+  Address mac = neighbor->GetDevice ()->GetAddress ();
+  for (uint32_t j = 0; j < neighbor->GetNAddresses (); j++)
+    {
+      Ipv4Address address = neighbor->GetAddress (j).GetLocal ();
+      for (uint32_t i = 0; i < interface->GetNAddresses (); i++)
+        {
+          Ipv4InterfaceAddress local = interface->GetAddress (i);
+          if (!local.GetMask ().IsMatch (local.GetLocal (), address))
+            {
+              continue;
+            }
+          NS_LOG_LOGIC ("ARP entry " << address << " -> " << mac << " on " << local.GetLocal ());
+          ArpCache::Entry *entry = cache->Lookup (address);
+          if (entry != 0)
+            {
+              cache->Remove (entry);
+            }
+          // a new entry is alive from now on
+          entry = cache->Add (address);
+          entry->SetMacAddress (mac);
+          if (m_permanent)
+            {
+              entry->MarkPermanent ();
+            }
+          else
+            {
+              entry->UpdateSeen ();
+            }
+          break;
+        }
+    }
+}
+
+void
+NeighborCacheHelper::AddNdiscEntries (Ptr<Ipv6Interface> interface, Ptr<Ipv6Interface> neighbor) const
+{
+  Ptr<NdiscCache> cache = interface->GetNdiscCache ();
+  if (!cache)
+    {
+      return;
+    }
+  Address mac = neighbor->GetDevice ()->GetAddress ();
+  for (uint32_t j = 0; j < neighbor->GetNAddresses (); j++)
+    {
+      Ipv6Address address = neighbor->GetAddress (j).GetAddress ();
+      for (uint32_t i = 0; i < interface->GetNAddresses (); i++)
+        {
+          if (!interface->GetAddress (i).IsInSameSubnet (address))
+            {
+              continue;
+            }
+          NS_LOG_LOGIC ("NDISC entry " << address << " -> " << mac);
+          NdiscCache::Entry *entry = cache->Lookup (address);
+          if (entry != 0)
+            {
+              cache->Remove (entry);
+            }
+          entry = cache->Add (address);
+          if (m_permanent)
+            {
+              entry->SetMacAddress (mac);
+              entry->MarkPermanent ();
+            }
+          else
+            {
+              entry->MarkStale (mac);
+            }
+          break;
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef NEIGHBOR_CACHE_HELPER_H
+#define NEIGHBOR_CACHE_HELPER_H
+
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/channel.h"
+#include "ns3/net-device-container.h"
+
+namespace ns3 {
+
+class Ipv4Interface;
+class Ipv6Interface;
+
+/**
+ * \ingroup internet
+ *
+ * \brief Fill the ARP and NDISC caches from the topology
+ *
+ * On large LANs, the first packets of each pair of hosts wait for an
+ * ARP or NDISC resolution, and the requests are broadcast to all the
+ * hosts.  This helper fills, before the simulation starts, the caches of
+ * the interfaces with the addresses of the other interfaces on the same
+ * channel and subnet (and of all of them for IPv6 link-local addresses),
+ * so that no resolution is needed.
+ *
+ * By default, the ARP entries are alive, and expire after the cache
+ * AliveTimeout as if they were just resolved, and the NDISC entries are
+ * stale, which triggers a unicast probe when they are first used, as
+ * for an unsolicited advertisement.  In the permanent mode, the entries
+ * never expire: there is then no ARP or NDISC traffic at all, but the
+ * entries are not updated if an address is changed or moved later on.
+ *
+ * The caches must be filled after the addresses are assigned.
+ */
+class NeighborCacheHelper
+{
+public:
+  NeighborCacheHelper ();
+
+  /**
+   * \brief Set whether the entries are permanent
+   * \param permanent true if the entries never expire
+   */
+  void SetPermanent (bool permanent);
+
+  /**
+   * \brief Fill the caches of all the interfaces of the simulation
+   */
+  void PopulateNeighborCache (void) const;
+
+  /**
+   * \brief Fill the caches of the interfaces on a channel
+   * \param channel the channel
+   */
+  void PopulateNeighborCache (Ptr<Channel> channel) const;
+
+  /**
+   * \brief Fill the caches of some interfaces with the addresses of each other
+   *
+   * The devices need not be on the same channel: each one only learns the
+   * addresses of the devices of the container on its channel.
+   *
+   * \param devices the devices of the interfaces
+   */
+  void PopulateNeighborCache (const NetDeviceContainer &devices) const;
+
+private:
+  /**
+   * \brief Fill the caches of the interfaces of a set of devices on the same channel
+   * \param devices the devices
+   */
+  void PopulateDevices (const std::vector<Ptr<NetDevice> > &devices) const;
+
+  /**
+   * \brief Add the addresses of an interface to the ARP cache of another one
+   * \param interface the interface whose cache is filled
+   * \param neighbor the neighbor interface
+   */
+  void AddArpEntries (Ptr<Ipv4Interface> interface, Ptr<Ipv4Interface> neighbor) const;
+
+  /**
+   * \brief Add the addresses of an interface to the NDISC cache of another one
+   * \param interface the interface whose cache is filled
+   * \param neighbor the neighbor interface
+   */
+  void AddNdiscEntries (Ptr<Ipv6Interface> interface, Ptr<Ipv6Interface> neighbor) const;
+
+  bool m_permanent; //!< Whether the entries are permanent
+};
+
+} // namespace ns3
+
+#endif /* NEIGHBOR_CACHE_HELPER_H */
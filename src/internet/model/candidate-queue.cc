@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <vector>
 #include "ns3/log.h"
 #include "ns3/assert.h"
 #include "candidate-queue.h"
@@ -57,16 +58,17 @@ operator<< (std::ostream& os, const CandidateQueue& q)
   for (CIter_t iter = list.begin (); iter != list.end (); iter++)
     {
       os << "<" 
-      << (*iter)->GetVertexId () << ", "
-      << (*iter)->GetDistanceFromRoot () << ", "
-      << (*iter)->GetVertexType () << ">" << std::endl;
+      << iter->second->GetVertexId () << ", "
+      << iter->second->GetDistanceFromRoot () << ", "
+      << iter->second->GetVertexType () << ">" << std::endl;
     }
   os << "*** CandidateQueue End ***";
   return os;
 }
 
 CandidateQueue::CandidateQueue()
-  : m_candidates ()
+  : m_candidates (),
+    m_index ()
 {
   NS_LOG_FUNCTION (this);
 }
@@ -94,11 +96,9 @@ CandidateQueue::Push (SPFVertex *vNew)
 {
   NS_LOG_FUNCTION (this << vNew);
 
-  CandidateList_t::iterator i = std::upper_bound (
-      m_candidates.begin (), m_candidates.end (), vNew,
-      &CandidateQueue::CompareSPFVertex
-      );
-  m_candidates.insert (i, vNew);
+  // equal keys are inserted at the upper bound of their range
+  CandidateList_t::iterator i = m_candidates.insert (std::make_pair (GetKey (vNew), vNew));
+  m_index[vNew->GetVertexId ()] = i;
 }
 
 SPFVertex *
@@ -110,8 +110,14 @@ CandidateQueue::Pop (void)
       return 0;
     }
 
-  SPFVertex *v = m_candidates.front ();
-  m_candidates.pop_front ();
+  CandidateList_t::iterator i = m_candidates.begin ();
+  SPFVertex *v = i->second;
+  CandidateIndex_t::iterator j = m_index.find (v->GetVertexId ());
+  if (j != m_index.end () && j->second == i)
+    {
+      m_index.erase (j);
+    }
+  m_candidates.erase (i);
   return v;
 }
 
@@ -124,7 +130,7 @@ CandidateQueue::Top (void) const
       return 0;
     }
 
-  return m_candidates.front ();
+  return m_candidates.begin ()->second;
 }
 
 bool
@@ -145,18 +151,12 @@ SPFVertex *
 CandidateQueue::Find (const Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this);
-  CandidateList_t::const_iterator i = m_candidates.begin ();
-
-  for (; i != m_candidates.end (); i++)
+  CandidateIndex_t::const_iterator i = m_index.find (addr);
+  if (i == m_index.end ())
     {
-      SPFVertex *v = *i;
-      if (v->GetVertexId () == addr)
-        {
-          return v;
-        }
+      return 0;
     }
-
-  return 0;
+  return i->second->second;
 }
 
 void
@@ -164,11 +164,46 @@ CandidateQueue::Reorder (void)
 {
   NS_LOG_FUNCTION (this);
 
-  m_candidates.sort (&CandidateQueue::CompareSPFVertex);
+  // move the vertices whose key changed, in queue order
+  std::vector<SPFVertex *> moved;
+  for (CandidateList_t::iterator i = m_candidates.begin (); i != m_candidates.end (); )
+    {
+      if (i->first != GetKey (i->second))
+        {
+          moved.push_back (i->second);
+          m_candidates.erase (i++);
+        }
+      else
+        {
+          i++;
+        }
+    }
+  for (std::vector<SPFVertex *>::const_iterator i = moved.begin (); i != moved.end (); i++)
+    {
+      Push (*i);
+    }
   NS_LOG_LOGIC ("After reordering the CandidateQueue");
   NS_LOG_LOGIC (*this);
 }
 
+void
+CandidateQueue::Reorder (SPFVertex *v)
+{
+  NS_LOG_FUNCTION (this << v);
+
+  CandidateIndex_t::iterator j = m_index.find (v->GetVertexId ());
+  NS_ASSERT_MSG (j != m_index.end () && j->second->second == v, "Vertex not in the CandidateQueue");
+  m_candidates.erase (j->second);
+  j->second = m_candidates.insert (std::make_pair (GetKey (v), v));
+}
+
+CandidateQueue::Key_t
+CandidateQueue::GetKey (const SPFVertex* v)
+{
+  return Key_t (v->GetDistanceFromRoot (),
+                v->GetVertexType () == SPFVertex::VertexNetwork ? 0 : 1);
+}
+
 /*
  * In this implementation, SPFVertex follows the ordering where
  * a vertex is ranked first if its GetDistanceFromRoot () is smaller;
@@ -22,7 +22,9 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <map>
+#include <unordered_map>
+#include <utility>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -47,6 +49,12 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
  * enhanced priority queue.
+ *
+ * The vertices are kept in a multimap ordered by (distance, type), where
+ * vertices with equal keys are kept in insertion order, along with a hash
+ * table indexed by vertex ID; Push, Pop, Find and Reorder (SPFVertex*) thus
+ * cost O(log n) at most.  The vertex IDs in the queue are expected to be
+ * unique, as they are in the SPF calculation.
  */
 class CandidateQueue
 {
@@ -154,6 +162,18 @@ public:
  */
   void Reorder (void);
 
+/**
+ * @brief Moves a vertex whose distance from the root decreased to its new
+ * place in the queue.
+ *
+ * This is equivalent to, and much faster than, Reorder () when the distance
+ * of a single vertex changed.
+ *
+ * @see SPFVertex
+ * @param v The Shortest Path First Vertex, which must be in the queue.
+ */
+  void Reorder (SPFVertex *v);
+
 private:
 /**
  * Candidate Queue copy construction is disallowed (not implemented) to 
@@ -184,8 +204,19 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
+  /// Ordering key of a vertex: distance from the root, then type rank
+  typedef std::pair<uint32_t, uint32_t> Key_t;
+  /**
+   * \param v a vertex
+   * \return the ordering key of the vertex, consistent with CompareSPFVertex
+   */
+  static Key_t GetKey (const SPFVertex* v);
+
+  typedef std::multimap<Key_t, SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
+  /// Index of the candidates by vertex ID
+  typedef std::unordered_map<Ipv4Address, CandidateList_t::iterator, Ipv4AddressHash> CandidateIndex_t;
   CandidateList_t m_candidates;  //!< SPFVertex candidates
+  CandidateIndex_t m_index;      //!< SPFVertex candidates, by vertex ID
 
   /**
    * \brief Stream insertion operator.
@@ -0,0 +1,544 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <set>
+
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/ipv4.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
+#include "contact-plan.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ContactPlan");
+
+NS_OBJECT_ENSURE_REGISTERED (ContactPlan);
+
+TypeId
+ContactPlan::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ContactPlan")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<ContactPlan> ()
+    .AddAttribute ("Threads",
+                   "The number of threads computing the routes.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&ContactPlan::m_threads),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+ContactPlan::ContactPlan ()
+  : m_workers (1),
+    m_nNodes (0),
+    m_computed (false),
+    m_started (false),
+    m_current (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ContactPlan::~ContactPlan ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ContactPlan::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_contacts.clear ();
+  m_epochs.clear ();
+  m_tables.clear ();
+  m_epochTables.clear ();
+  m_hosts.clear ();
+  m_shared.clear ();
+  m_sharedIndex.clear ();
+  m_networks.Clear ();
+  Object::DoDispose ();
+}
+
+void
+ContactPlan::AddContact (Ptr<Node> from, uint32_t fromInterface,
+                         Ptr<Node> to, uint32_t toInterface,
+                         Time start, Time stop, Time delay)
+{
+  NS_LOG_FUNCTION (this << from << fromInterface << to << toInterface << start << stop << delay);
+  NS_ASSERT_MSG (!m_computed, "Contacts must be added before the routes are computed");
+  NS_ASSERT_MSG (from->GetId () != to->GetId (), "A contact links two different nodes");
+  NS_ASSERT_MSG (!delay.IsStrictlyNegative (), "The delay of a contact cannot be negative");
+  Contact contact;
+  contact.from = from->GetId ();
+  contact.fromIf = fromInterface;
+  contact.to = to->GetId ();
+  contact.toIf = toInterface;
+  contact.start = std::max<int64_t> (start.GetTimeStep (), 0);
+  contact.stop = stop.GetTimeStep ();
+  contact.delay = delay.GetTimeStep ();
+  m_contacts.push_back (contact);
+}
+
+uint32_t
+ContactPlan::GetNContacts (void) const
+{
+  return m_contacts.size ();
+}
+
+uint32_t
+ContactPlan::GetNEpochs (void) const
+{
+  return m_epochs.size ();
+}
+
+Time
+ContactPlan::GetEpochStart (uint32_t epoch) const
+{
+  NS_ASSERT (epoch < m_epochs.size ());
+  return TimeStep (m_epochs[epoch].start);
+}
+
+uint32_t
+ContactPlan::GetCurrentEpoch (void) const
+{
+  return m_current;
+}
+
+uint32_t
+ContactPlan::GetNTables (void) const
+{
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < m_tables.size (); i++)
+    {
+      n += m_tables[i].size ();
+    }
+  return n;
+}
+
+void
+ContactPlan::Compute (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_computed)
+    {
+      return;
+    }
+  m_computed = true;
+  m_nNodes = NodeList::GetNNodes ();
+
+//
+// Resolve the addresses: the receiving interface of each contact is the
+// next hop, and each address of a node leads to that node.  The networks
+// shared by several nodes get an entry in the tables, for the node to go
+// to.
+//
+  std::vector<std::pair<RoutingPrefixIndex<uint32_t>::Key, uint8_t> > prefixes;
+  for (uint32_t n = 0; n < m_nNodes; n++)
+    {
+      Ptr<Ipv4> ipv4 = NodeList::GetNode (n)->GetObject<Ipv4> ();
+      if (ipv4 == 0)
+        {
+          continue;
+        }
+      for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+        {
+          for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+            {
+              Ipv4InterfaceAddress address = ipv4->GetAddress (i, j);
+              if (address.GetLocal ().IsLocalhost ())
+                {
+                  continue;
+                }
+              m_hosts.insert (std::make_pair (address.GetLocal ().Get (), n));
+              uint8_t length = address.GetMask ().GetPrefixLength ();
+              RoutingPrefixIndex<uint32_t>::Key key = RoutingPrefixIndex<uint32_t>::MakeKey (address.GetLocal ());
+              if (length < 32 && !IsOnNetwork (m_networks.Find (key, length), n))
+                {
+                  m_networks.Insert (key, length, n);
+                  prefixes.push_back (std::make_pair (key, length));
+                }
+            }
+        }
+    }
+  for (uint32_t i = 0; i < prefixes.size (); i++)
+    {
+      const RoutingPrefixIndex<uint32_t>::Bucket *network = m_networks.Find (prefixes[i].first, prefixes[i].second);
+      if (network->size () > 1 && m_sharedIndex.find (network) == m_sharedIndex.end ())
+        {
+          m_sharedIndex.insert (std::make_pair (network, m_shared.size ()));
+          m_shared.push_back (network);
+        }
+    }
+  for (std::vector<Contact>::iterator c = m_contacts.begin (); c != m_contacts.end (); c++)
+    {
+      NS_ABORT_MSG_UNLESS (c->from < m_nNodes && c->to < m_nNodes, "Contact with an unknown node");
+      Ptr<Ipv4> ipv4 = NodeList::GetNode (c->to)->GetObject<Ipv4> ();
+      if (ipv4 == 0 || c->toIf >= ipv4->GetNInterfaces () || ipv4->GetNAddresses (c->toIf) == 0)
+        {
+          NS_FATAL_ERROR ("Interface " << c->toIf << " of node " << c->to << " has no IPv4 address");
+        }
+      c->gateway = ipv4->GetAddress (c->toIf, 0).GetLocal ();
+    }
+
+//
+// Cut the time into epochs at the start and stop times of the contacts,
+// and sweep them to build the adjacency list of each epoch along with the
+// contacts added and removed at its start.
+//
+  std::vector<std::pair<int64_t, uint32_t> > starts;
+  std::vector<std::pair<int64_t, uint32_t> > stops;
+  std::vector<int64_t> boundaries (1, 0);
+  for (uint32_t i = 0; i < m_contacts.size (); i++)
+    {
+      if (m_contacts[i].stop <= m_contacts[i].start)
+        {
+          continue;
+        }
+      starts.push_back (std::make_pair (m_contacts[i].start, i));
+      stops.push_back (std::make_pair (m_contacts[i].stop, i));
+      boundaries.push_back (m_contacts[i].start);
+      boundaries.push_back (m_contacts[i].stop);
+    }
+  std::sort (starts.begin (), starts.end ());
+  std::sort (stops.begin (), stops.end ());
+  std::sort (boundaries.begin (), boundaries.end ());
+  boundaries.erase (std::unique (boundaries.begin (), boundaries.end ()), boundaries.end ());
+
+  m_epochs.resize (boundaries.size ());
+  std::set<std::pair<uint32_t, uint32_t> > active;
+  uint32_t nextStart = 0;
+  uint32_t nextStop = 0;
+  for (uint32_t k = 0; k < boundaries.size (); k++)
+    {
+      Epoch &epoch = m_epochs[k];
+      epoch.start = boundaries[k];
+      for (; nextStop < stops.size () && stops[nextStop].first <= epoch.start; nextStop++)
+        {
+          uint32_t c = stops[nextStop].second;
+          active.erase (std::make_pair (m_contacts[c].from, c));
+          epoch.removed.push_back (c);
+        }
+      for (; nextStart < starts.size () && starts[nextStart].first <= epoch.start; nextStart++)
+        {
+          uint32_t c = starts[nextStart].second;
+          active.insert (std::make_pair (m_contacts[c].from, c));
+          epoch.added.push_back (c);
+        }
+      epoch.offsets.assign (m_nNodes + 1, 0);
+      epoch.edges.reserve (active.size ());
+      for (std::set<std::pair<uint32_t, uint32_t> >::const_iterator i = active.begin (); i != active.end (); i++)
+        {
+          epoch.offsets[i->first + 1]++;
+          epoch.edges.push_back (i->second);
+        }
+      for (uint32_t n = 0; n < m_nNodes; n++)
+        {
+          epoch.offsets[n + 1] += epoch.offsets[n];
+        }
+    }
+  NS_LOG_LOGIC (m_contacts.size () << " contacts, " << m_epochs.size () << " epochs, "
+                << m_shared.size () << " shared networks");
+
+//
+// Compute the tables, the sources being dealt in turn to the threads.  The
+// threads only read the contacts and epochs, and write to the entries of
+// their own sources.
+//
+  m_tables.assign (m_nNodes, std::vector<Table> ());
+  m_epochTables.assign (m_epochs.size () * m_nNodes, 0);
+  uint32_t nThreads = std::max<uint32_t> (std::min<uint32_t> (m_threads, m_nNodes), 1);
+#ifndef HAVE_PTHREAD_H
+  nThreads = 1;
+#endif
+  m_workers = nThreads;
+#ifdef HAVE_PTHREAD_H
+  std::vector<Worker> workers (nThreads);
+  std::vector<Ptr<SystemThread> > systemThreads;
+  for (uint32_t t = 1; t < nThreads; t++)
+    {
+      workers[t].plan = this;
+      workers[t].index = t;
+      systemThreads.push_back (Create<SystemThread> (MakeCallback (&Worker::Run, &workers[t])));
+      systemThreads.back ()->Start ();
+    }
+#endif
+  ComputeSources (0);
+#ifdef HAVE_PTHREAD_H
+  for (uint32_t t = 0; t < systemThreads.size (); t++)
+    {
+      systemThreads[t]->Join ();
+    }
+#endif
+  NS_LOG_LOGIC (GetNTables () << " distinct tables for " << m_epochTables.size () << " (epoch, node) pairs");
+}
+
+void
+ContactPlan::Worker::Run (void)
+{
+  plan->ComputeSources (index);
+}
+
+/**
+ * \param table a route table
+ * \return a hash of the table
+ */
+static std::size_t
+HashTable (const std::vector<int32_t> &table)
+{
+  std::size_t h = 14695981039346656037ULL;
+  for (std::vector<int32_t>::const_iterator i = table.begin (); i != table.end (); i++)
+    {
+      h = (h ^ static_cast<uint32_t> (*i)) * 1099511628211ULL;
+    }
+  return h;
+}
+
+void
+ContactPlan::ComputeSources (uint32_t worker)
+{
+  NS_LOG_FUNCTION (this << worker);
+  Table table;
+  std::vector<int32_t> parent;
+  for (uint32_t source = worker; source < m_nNodes; source += m_workers)
+    {
+      std::vector<Table> &tables = m_tables[source];
+      std::unordered_map<std::size_t, std::vector<uint32_t> > distinct;
+      uint32_t current = 0;
+      for (uint32_t k = 0; k < m_epochs.size (); k++)
+        {
+          const Epoch &epoch = m_epochs[k];
+          bool unchanged = (k > 0 && epoch.added.empty ());
+          for (uint32_t i = 0; unchanged && i < epoch.removed.size (); i++)
+            {
+              uint32_t c = epoch.removed[i];
+              unchanged = (parent[m_contacts[c].to] != static_cast<int32_t> (c));
+            }
+          if (!unchanged)
+            {
+              ComputeTable (epoch, source, table, parent);
+              std::vector<uint32_t> &candidates = distinct[HashTable (table)];
+              current = tables.size ();
+              for (uint32_t i = 0; i < candidates.size (); i++)
+                {
+                  if (tables[candidates[i]] == table)
+                    {
+                      current = candidates[i];
+                      break;
+                    }
+                }
+              if (current == tables.size ())
+                {
+                  candidates.push_back (current);
+                  tables.push_back (table);
+                }
+            }
+          m_epochTables[k * m_nNodes + source] = current;
+        }
+    }
+}
+
+void
+ContactPlan::ComputeTable (const Epoch &epoch, uint32_t source,
+                           Table &table, std::vector<int32_t> &parent) const
+{
+  typedef std::pair<int64_t, uint32_t> Candidate;
+  std::vector<int64_t> distance (m_nNodes, std::numeric_limits<int64_t>::max ());
+  table.assign (m_nNodes + m_shared.size (), -1);
+  parent.assign (m_nNodes, -1);
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > candidates;
+  distance[source] = 0;
+  candidates.push (Candidate (0, source));
+  while (!candidates.empty ())
+    {
+      Candidate top = candidates.top ();
+      candidates.pop ();
+      uint32_t u = top.second;
+      if (top.first > distance[u])
+        {
+          continue;
+        }
+      for (uint32_t e = epoch.offsets[u]; e < epoch.offsets[u + 1]; e++)
+        {
+          uint32_t c = epoch.edges[e];
+          uint32_t v = m_contacts[c].to;
+          int64_t d = top.first + m_contacts[c].delay;
+          if (d < distance[v])
+            {
+              distance[v] = d;
+              parent[v] = c;
+              table[v] = (u == source) ? static_cast<int32_t> (c) : table[u];
+              candidates.push (Candidate (d, v));
+            }
+        }
+    }
+  // the packets to a shared network go to its node reached first, or stay
+  // on the source if it is attached to the network
+  for (uint32_t j = 0; j < m_shared.size (); j++)
+    {
+      int32_t &nearest = table[m_nNodes + j];
+      for (RoutingPrefixIndex<uint32_t>::Bucket::const_iterator n = m_shared[j]->begin (); n != m_shared[j]->end (); n++)
+        {
+          if (n->value == source)
+            {
+              nearest = source;
+              break;
+            }
+          if (distance[n->value] != std::numeric_limits<int64_t>::max ()
+              && (nearest < 0 || distance[n->value] < distance[nearest]))
+            {
+              nearest = n->value;
+            }
+        }
+    }
+}
+
+bool
+ContactPlan::IsOnNetwork (const RoutingPrefixIndex<uint32_t>::Bucket *network, uint32_t nodeId)
+{
+  if (network == 0)
+    {
+      return false;
+    }
+  for (RoutingPrefixIndex<uint32_t>::Bucket::const_iterator i = network->begin (); i != network->end (); i++)
+    {
+      if (i->value == nodeId)
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+int32_t
+ContactPlan::FindNode (uint32_t epoch, uint32_t nodeId, Ipv4Address address) const
+{
+  std::unordered_map<uint32_t, uint32_t>::const_iterator i = m_hosts.find (address.Get ());
+  if (i != m_hosts.end ())
+    {
+      return i->second;
+    }
+  int length = 33;
+  const RoutingPrefixIndex<uint32_t>::Bucket *network =
+    m_networks.FindLongestMatch (RoutingPrefixIndex<uint32_t>::MakeKey (address), length);
+  if (network == 0)
+    {
+      return -1;
+    }
+  if (network->size () == 1)
+    {
+      return network->front ().value;
+    }
+  std::unordered_map<const RoutingPrefixIndex<uint32_t>::Bucket *, uint32_t>::const_iterator j = m_sharedIndex.find (network);
+  NS_ASSERT (j != m_sharedIndex.end ());
+  return m_tables[nodeId][m_epochTables[epoch * m_nNodes + nodeId]][m_nNodes + j->second];
+}
+
+bool
+ContactPlan::LookupNode (uint32_t epoch, uint32_t nodeId, uint32_t destinationId,
+                         uint32_t &interface, Ipv4Address &gateway) const
+{
+  NS_ASSERT (epoch < m_epochs.size ());
+  if (nodeId >= m_nNodes || destinationId >= m_nNodes)
+    {
+      return false;
+    }
+  int32_t c = m_tables[nodeId][m_epochTables[epoch * m_nNodes + nodeId]][destinationId];
+  if (c < 0)
+    {
+      return false;
+    }
+  interface = m_contacts[c].fromIf;
+  gateway = m_contacts[c].gateway;
+  return true;
+}
+
+bool
+ContactPlan::Lookup (uint32_t epoch, uint32_t nodeId, Ipv4Address destination,
+                     uint32_t &interface, Ipv4Address &gateway) const
+{
+  if (nodeId >= m_nNodes)
+    {
+      return false;
+    }
+  int32_t destinationId = FindNode (epoch, nodeId, destination);
+  if (destinationId < 0 || static_cast<uint32_t> (destinationId) == nodeId)
+    {
+      return false;
+    }
+  return LookupNode (epoch, nodeId, destinationId, interface, gateway);
+}
+
+bool
+ContactPlan::Lookup (uint32_t nodeId, Ipv4Address destination,
+                     uint32_t &interface, Ipv4Address &gateway)
+{
+  if (!m_started)
+    {
+      Start ();
+    }
+  return Lookup (m_current, nodeId, destination, interface, gateway);
+}
+
+void
+ContactPlan::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_started)
+    {
+      return;
+    }
+  Compute ();
+  m_started = true;
+  int64_t now = Simulator::Now ().GetTimeStep ();
+  m_current = 0;
+  while (m_current + 1 < m_epochs.size () && m_epochs[m_current + 1].start <= now)
+    {
+      m_current++;
+    }
+  if (m_current + 1 < m_epochs.size ())
+    {
+      Simulator::Schedule (TimeStep (m_epochs[m_current + 1].start - now), &ContactPlan::NextEpoch, this);
+    }
+}
+
+void
+ContactPlan::NextEpoch (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_current++;
+  NS_LOG_LOGIC ("Epoch " << m_current << " starts");
+  if (m_current + 1 < m_epochs.size ())
+    {
+      Simulator::Schedule (TimeStep (m_epochs[m_current + 1].start - m_epochs[m_current].start),
+                           &ContactPlan::NextEpoch, this);
+    }
+}
+
+} // namespace ns3
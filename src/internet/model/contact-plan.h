@@ -0,0 +1,265 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CONTACT_PLAN_H
+#define CONTACT_PLAN_H
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/routing-prefix-index.h"
+
+namespace ns3 {
+
+class Node;
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief A schedule of link availability, and the routes derived from it
+ *
+ * A contact is a directional link, from an interface of a node to an
+ * interface of another node, which is available during a time interval
+ * and has a given delay.  The start and stop times of the contacts cut
+ * the simulation time into topology epochs, during each of which the set
+ * of available links is constant.
+ *
+ * Compute () builds, once and before the simulation runs, the routes of
+ * every node for every epoch: for each source node, a table giving the
+ * first-hop contact towards each destination node along the path of
+ * smallest total delay.  The sources are shared among the number of
+ * threads given by the "Threads" attribute.  The tables are built epoch
+ * after epoch, and the table of the previous epoch is kept as is when the
+ * epoch only removes contacts which are not on the shortest-path tree of
+ * the source.  Identical tables of a source are stored once, so periodic
+ * plans (e.g., satellite passes) cost memory for their distinct
+ * topologies only.
+ *
+ * Start () schedules the switch of the current epoch at each epoch
+ * boundary, so that Lookup () is a few array accesses and a hash lookup,
+ * independent of the size of the plan.
+ *
+ * The addresses of the destinations are resolved when Compute () is
+ * called, so the plan must be computed after the addresses are assigned.
+ * An address which is not one of a node goes to the node attached to its
+ * network which the packet reaches first in the current epoch; that node
+ * is found along with the routes, for each source and epoch, so that it
+ * costs a table access too.
+ */
+class ContactPlan : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  ContactPlan ();
+  virtual ~ContactPlan ();
+
+  /**
+   * \brief Add a contact
+   * \param from the transmitting node
+   * \param fromInterface the IPv4 interface index of the transmitter
+   * \param to the receiving node
+   * \param toInterface the IPv4 interface index of the receiver
+   * \param start the time the link becomes available
+   * \param stop the time the link becomes unavailable
+   * \param delay the delay of the link, used as its routing cost
+   */
+  void AddContact (Ptr<Node> from, uint32_t fromInterface,
+                   Ptr<Node> to, uint32_t toInterface,
+                   Time start, Time stop, Time delay);
+  /**
+   * \return the number of contacts
+   */
+  uint32_t GetNContacts (void) const;
+
+  /**
+   * \brief Compute the routes of all the epochs
+   *
+   * Called by Start () if needed; it can be called explicitly to control
+   * when the computation takes place.
+   */
+  void Compute (void);
+  /**
+   * \brief Compute the routes if needed, and follow the epochs from now on
+   *
+   * Calling this method more than once has no effect.
+   */
+  void Start (void);
+
+  /**
+   * \return the number of epochs (valid after Compute ())
+   */
+  uint32_t GetNEpochs (void) const;
+  /**
+   * \param epoch an epoch index
+   * \return the start time of the epoch
+   */
+  Time GetEpochStart (uint32_t epoch) const;
+  /**
+   * \return the index of the current epoch
+   */
+  uint32_t GetCurrentEpoch (void) const;
+  /**
+   * \return the number of distinct route tables stored, for all the nodes
+   */
+  uint32_t GetNTables (void) const;
+
+  /**
+   * \brief Find the next hop towards an address in the current epoch
+   * \param nodeId the node forwarding the packet
+   * \param destination the destination address
+   * \param [out] interface the output interface
+   * \param [out] gateway the next hop
+   * \return false if there is no route
+   */
+  bool Lookup (uint32_t nodeId, Ipv4Address destination,
+               uint32_t &interface, Ipv4Address &gateway);
+  /**
+   * \brief Find the next hop towards an address in a given epoch
+   * \param epoch the epoch
+   * \param nodeId the node forwarding the packet
+   * \param destination the destination address
+   * \param [out] interface the output interface
+   * \param [out] gateway the next hop
+   * \return false if there is no route
+   */
+  bool Lookup (uint32_t epoch, uint32_t nodeId, Ipv4Address destination,
+               uint32_t &interface, Ipv4Address &gateway) const;
+  /**
+   * \brief Find the next hop towards a node in a given epoch
+   * \param epoch the epoch
+   * \param nodeId the node forwarding the packet
+   * \param destinationId the destination node
+   * \param [out] interface the output interface
+   * \param [out] gateway the next hop
+   * \return false if there is no route
+   */
+  bool LookupNode (uint32_t epoch, uint32_t nodeId, uint32_t destinationId,
+                   uint32_t &interface, Ipv4Address &gateway) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /// A directional link availability
+  struct Contact
+  {
+    uint32_t from;        //!< transmitting node id
+    uint32_t fromIf;      //!< interface of the transmitter
+    uint32_t to;          //!< receiving node id
+    uint32_t toIf;        //!< interface of the receiver
+    int64_t start;        //!< start time, in time steps
+    int64_t stop;         //!< stop time, in time steps
+    int64_t delay;        //!< delay, in time steps
+    Ipv4Address gateway;  //!< address of the receiving interface
+  };
+
+  /// The contacts usable in an epoch, as an adjacency list
+  struct Epoch
+  {
+    int64_t start;                 //!< start time, in time steps
+    std::vector<uint32_t> offsets; //!< first contact of each node (one per node, plus one)
+    std::vector<uint32_t> edges;   //!< contacts, grouped by transmitter
+    std::vector<uint32_t> added;   //!< contacts not usable in the previous epoch
+    std::vector<uint32_t> removed; //!< contacts usable in the previous epoch only
+  };
+
+  /**
+   * First-hop contact towards each node, followed by the nearest node
+   * attached to each shared network (-1 if unreachable)
+   */
+  typedef std::vector<int32_t> Table;
+
+  /// A thread computing the tables of some sources
+  struct Worker
+  {
+    ContactPlan *plan; //!< the plan
+    uint32_t index;    //!< index of the thread
+    /// Compute the tables of the sources of this thread
+    void Run (void);
+  };
+
+  /**
+   * \brief Build the tables of a range of sources, for all the epochs
+   * \param worker the index of the calling thread
+   */
+  void ComputeSources (uint32_t worker);
+  /**
+   * \brief Run Dijkstra's algorithm in an epoch
+   * \param epoch the epoch
+   * \param source the source node
+   * \param [out] table the first-hop contact towards each node, and the
+   *        nearest node attached to each shared network
+   * \param [out] parent the last contact of the path to each node
+   */
+  void ComputeTable (const Epoch &epoch, uint32_t source,
+                     Table &table, std::vector<int32_t> &parent) const;
+  /**
+   * \param network the nodes attached to a network prefix, or 0
+   * \param nodeId a node
+   * \return true if the node is attached to the network
+   */
+  static bool IsOnNetwork (const RoutingPrefixIndex<uint32_t>::Bucket *network, uint32_t nodeId);
+  /**
+   * \brief Find the node to route a packet to, in a given epoch
+   *
+   * An address of a node leads to that node.  Otherwise, among the nodes
+   * attached to the longest prefix matching the address, the packet goes
+   * to the one it reaches first; the forwarding node itself is returned if
+   * it is attached to that prefix.
+   *
+   * \param epoch the epoch
+   * \param nodeId the node forwarding the packet
+   * \param address the destination address
+   * \return the id of the destination node, or -1 if none is reachable
+   */
+  int32_t FindNode (uint32_t epoch, uint32_t nodeId, Ipv4Address address) const;
+  /**
+   * \brief Make the next epoch current, and schedule the following switch
+   */
+  void NextEpoch (void);
+
+  uint32_t m_threads;                   //!< number of threads computing the routes
+  uint32_t m_workers;                   //!< number of threads of the current computation
+  std::vector<Contact> m_contacts;      //!< all the contacts
+  std::vector<Epoch> m_epochs;          //!< the epochs, in time order
+  uint32_t m_nNodes;                    //!< number of nodes when computed
+  std::vector<std::vector<Table> > m_tables; //!< distinct tables of each source
+  std::vector<uint32_t> m_epochTables;  //!< index in m_tables[node] of each (epoch, node)
+  /// Owner of each host address
+  std::unordered_map<uint32_t, uint32_t> m_hosts;
+  /// Nodes attached to each network prefix
+  RoutingPrefixIndex<uint32_t> m_networks;
+  /// Networks with several attached nodes, in the order of their table entries
+  std::vector<const RoutingPrefixIndex<uint32_t>::Bucket *> m_shared;
+  /// Index of each network of m_shared
+  std::unordered_map<const RoutingPrefixIndex<uint32_t>::Bucket *, uint32_t> m_sharedIndex;
+  bool m_computed;                      //!< whether the routes are computed
+  bool m_started;                       //!< whether the epoch switches are scheduled
+  uint32_t m_current;                   //!< the current epoch
+};
+
+} // namespace ns3
+
+#endif /* CONTACT_PLAN_H */
@@ -0,0 +1,327 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef END_POINT_INDEX_H
+#define END_POINT_INDEX_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief Hash index of the endpoints of an Ipv4EndPointDemux or
+ * Ipv6EndPointDemux
+ *
+ * The endpoints whose peer address and port are both set (the connected
+ * ones, e.g., the accepted TCP connections) are hashed on their 4-tuple,
+ * so that a connected endpoint is found with one hash lookup whatever the
+ * number of connections.  The other endpoints (listening, bound-only or
+ * partially connected) are grouped by local port: there are few of them
+ * per port, and the demultiplexers still apply their own matching rules
+ * to them.
+ *
+ * The index also keeps the position of each endpoint in the list of the
+ * demultiplexer, and the number of endpoints using each local port.  The
+ * demultiplexer must call Update () when the addresses or ports of an
+ * endpoint change.
+ *
+ * \tparam EndPoint the endpoint type (Ipv4EndPoint or Ipv6EndPoint)
+ * \tparam Address the address type (Ipv4Address or Ipv6Address)
+ * \tparam AddressHash a hash function of the addresses
+ */
+template <typename EndPoint, typename Address, typename AddressHash>
+class EndPointIndex
+{
+public:
+  /// The list of endpoints of the demultiplexer
+  typedef std::list<EndPoint *> EndPoints;
+  /// Endpoints with the same key
+  typedef std::vector<EndPoint *> Bucket;
+
+  /**
+   * \brief Add an endpoint
+   * \param endPoint the endpoint
+   * \param position the position of the endpoint in the demultiplexer list
+   */
+  void Add (EndPoint *endPoint, typename EndPoints::iterator position);
+  /**
+   * \brief Move an endpoint after a change of its addresses or ports
+   * \param endPoint the endpoint
+   */
+  void Update (EndPoint *endPoint);
+  /**
+   * \brief Remove an endpoint
+   * \param endPoint the endpoint
+   * \param [out] position the position of the endpoint in the demultiplexer list
+   * \return false if the endpoint is not indexed
+   */
+  bool Remove (EndPoint *endPoint, typename EndPoints::iterator &position);
+  /**
+   * \brief Remove all the endpoints
+   */
+  void Clear (void);
+
+  /**
+   * \param localAddress the local address
+   * \param localPort the local port
+   * \param peerAddress the peer address
+   * \param peerPort the peer port
+   * \return the connected endpoints with this 4-tuple, or 0 if none
+   */
+  const Bucket *FindConnected (Address localAddress, uint16_t localPort,
+                               Address peerAddress, uint16_t peerPort) const;
+  /**
+   * \param localPort the local port
+   * \return the endpoints of the port which are not connected, or 0 if none
+   */
+  const Bucket *FindUnconnected (uint16_t localPort) const;
+  /**
+   * \param localPort the local port
+   * \return true if an endpoint uses this local port
+   */
+  bool HasPort (uint16_t localPort) const;
+
+  /**
+   * \param peerAddress the peer address
+   * \param peerPort the peer port
+   * \return true if an endpoint with this peer is hashed on its 4-tuple
+   */
+  static bool IsConnected (Address peerAddress, uint16_t peerPort)
+  {
+    return peerPort != 0 && peerAddress != Address::GetAny ();
+  }
+
+private:
+  /// 4-tuple of a connected endpoint
+  struct Key
+  {
+    Address localAddress; //!< the local address
+    Address peerAddress;  //!< the peer address
+    uint16_t localPort;   //!< the local port
+    uint16_t peerPort;    //!< the peer port
+
+    /**
+     * \param o the other key
+     * \return true if both keys are equal
+     */
+    bool operator == (const Key &o) const
+    {
+      return localPort == o.localPort && peerPort == o.peerPort
+             && localAddress == o.localAddress && peerAddress == o.peerAddress;
+    }
+  };
+
+  /// Hash function of the keys
+  struct KeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    std::size_t operator () (const Key &key) const
+    {
+      AddressHash hash;
+      std::size_t h = hash (key.localAddress) * 31 + hash (key.peerAddress);
+      return (h * 0x9e3779b97f4a7c15ULL) ^ (key.localPort << 16 | key.peerPort);
+    }
+  };
+
+  /// Where an endpoint is
+  struct Entry
+  {
+    typename EndPoints::iterator position; //!< position in the demultiplexer list
+    bool connected;                        //!< whether the endpoint is hashed on its 4-tuple
+    Key key;                               //!< the key used when the endpoint was indexed
+  };
+
+  /**
+   * \param endPoint an endpoint
+   * \param [out] entry where to index it
+   */
+  static void MakeEntry (EndPoint *endPoint, Entry &entry);
+  /**
+   * \param entry where an endpoint is indexed
+   * \param endPoint the endpoint
+   */
+  void Insert (const Entry &entry, EndPoint *endPoint);
+  /**
+   * \param entry where an endpoint is indexed
+   * \param endPoint the endpoint
+   */
+  void Erase (const Entry &entry, EndPoint *endPoint);
+
+  std::unordered_map<EndPoint *, Entry> m_entries;          //!< all the endpoints
+  std::unordered_map<Key, Bucket, KeyHash> m_connected;     //!< connected endpoints, by 4-tuple
+  std::unordered_map<uint16_t, Bucket> m_unconnected;       //!< other endpoints, by local port
+  std::unordered_map<uint16_t, uint32_t> m_ports;           //!< number of endpoints of each local port
+};
+
+template <typename EndPoint, typename Address, typename AddressHash>
+void
+EndPointIndex<EndPoint, Address, AddressHash>::MakeEntry (EndPoint *endPoint, Entry &entry)
+{
+  entry.key.localAddress = endPoint->GetLocalAddress ();
+  entry.key.localPort = endPoint->GetLocalPort ();
+  entry.key.peerAddress = endPoint->GetPeerAddress ();
+  entry.key.peerPort = endPoint->GetPeerPort ();
+  entry.connected = IsConnected (entry.key.peerAddress, entry.key.peerPort);
+}
+
+template <typename EndPoint, typename Address, typename AddressHash>
+void
+EndPointIndex<EndPoint, Address, AddressHash>::Insert (const Entry &entry, EndPoint *endPoint)
+{
+  if (entry.connected)
+    {
+      m_connected[entry.key].push_back (endPoint);
+    }
+  else
+    {
+      m_unconnected[entry.key.localPort].push_back (endPoint);
+    }
+}
+
+template <typename EndPoint, typename Address, typename AddressHash>
+void
+EndPointIndex<EndPoint, Address, AddressHash>::Erase (const Entry &entry, EndPoint *endPoint)
+{
+  if (entry.connected)
+    {
+      typename std::unordered_map<Key, Bucket, KeyHash>::iterator b = m_connected.find (entry.key);
+      NS_ASSERT (b != m_connected.end ());
+      b->second.erase (std::find (b->second.begin (), b->second.end (), endPoint));
+      if (b->second.empty ())
+        {
+          m_connected.erase (b);
+        }
+    }
+  else
+    {
+      typename std::unordered_map<uint16_t, Bucket>::iterator b = m_unconnected.find (entry.key.localPort);
+      NS_ASSERT (b != m_unconnected.end ());
+      b->second.erase (std::find (b->second.begin (), b->second.end (), endPoint));
+      if (b->second.empty ())
+        {
+          m_unconnected.erase (b);
+        }
+    }
+}
+
+template <typename EndPoint, typename Address, typename AddressHash>
+void
+EndPointIndex<EndPoint, Address, AddressHash>::Add (EndPoint *endPoint, typename EndPoints::iterator position)
+{
+  Entry entry;
+  MakeEntry (endPoint, entry);
+  entry.position = position;
+  Insert (entry, endPoint);
+  m_ports[entry.key.localPort]++;
+  m_entries[endPoint] = entry;
+}
+
+template <typename EndPoint, typename Address, typename AddressHash>
+void
+EndPointIndex<EndPoint, Address, AddressHash>::Update (EndPoint *endPoint)
+{
+  typename std::unordered_map<EndPoint *, Entry>::iterator i = m_entries.find (endPoint);
+  if (i == m_entries.end ())
+    {
+      return;
+    }
+  Entry entry;
+  MakeEntry (endPoint, entry);
+  if (entry.connected == i->second.connected && entry.key == i->second.key)
+    {
+      return;
+    }
+  // the local port of an endpoint never changes
+  NS_ASSERT (entry.key.localPort == i->second.key.localPort);
+  Erase (i->second, endPoint);
+  entry.position = i->second.position;
+  Insert (entry, endPoint);
+  i->second = entry;
+}
+
+template <typename EndPoint, typename Address, typename AddressHash>
+bool
+EndPointIndex<EndPoint, Address, AddressHash>::Remove (EndPoint *endPoint, typename EndPoints::iterator &position)
+{
+  typename std::unordered_map<EndPoint *, Entry>::iterator i = m_entries.find (endPoint);
+  if (i == m_entries.end ())
+    {
+      return false;
+    }
+  Erase (i->second, endPoint);
+  std::unordered_map<uint16_t, uint32_t>::iterator p = m_ports.find (i->second.key.localPort);
+  if (--p->second == 0)
+    {
+      m_ports.erase (p);
+    }
+  position = i->second.position;
+  m_entries.erase (i);
+  return true;
+}
+
+template <typename EndPoint, typename Address, typename AddressHash>
+void
+EndPointIndex<EndPoint, Address, AddressHash>::Clear (void)
+{
+  m_entries.clear ();
+  m_connected.clear ();
+  m_unconnected.clear ();
+  m_ports.clear ();
+}
+
+template <typename EndPoint, typename Address, typename AddressHash>
+const typename EndPointIndex<EndPoint, Address, AddressHash>::Bucket *
+EndPointIndex<EndPoint, Address, AddressHash>::FindConnected (Address localAddress, uint16_t localPort,
+                                                              Address peerAddress, uint16_t peerPort) const
+{
+  Key key;
+  key.localAddress = localAddress;
+  key.localPort = localPort;
+  key.peerAddress = peerAddress;
+  key.peerPort = peerPort;
+  typename std::unordered_map<Key, Bucket, KeyHash>::const_iterator b = m_connected.find (key);
+  return (b == m_connected.end ()) ? 0 : &b->second;
+}
+
+template <typename EndPoint, typename Address, typename AddressHash>
+const typename EndPointIndex<EndPoint, Address, AddressHash>::Bucket *
+EndPointIndex<EndPoint, Address, AddressHash>::FindUnconnected (uint16_t localPort) const
+{
+  typename std::unordered_map<uint16_t, Bucket>::const_iterator b = m_unconnected.find (localPort);
+  return (b == m_unconnected.end ()) ? 0 : &b->second;
+}
+
+template <typename EndPoint, typename Address, typename AddressHash>
+bool
+EndPointIndex<EndPoint, Address, AddressHash>::HasPort (uint16_t localPort) const
+{
+  return m_ports.find (localPort) != m_ports.end ();
+}
+
+} // namespace ns3
+
+#endif /* END_POINT_INDEX_H */
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/log.h"
+#include "fragment-buffer.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("FragmentBuffer");
+
+FragmentBuffer::FragmentBuffer ()
+  : m_received (0),
+    m_end (0),
+    m_moreFragments (false),
+    m_overlaps (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+FragmentBuffer::AddFragment (Ptr<Packet> fragment, uint32_t offset, bool moreFragments)
+{
+  NS_LOG_FUNCTION (this << fragment << offset << moreFragments);
+
+  uint32_t end = offset + fragment->GetSize ();
+  Fragments_t::iterator it = m_fragments.insert (std::make_pair (offset, fragment));
+  Fragments_t::iterator next = std::next (it);
+
+  if (next == m_fragments.end ())
+    {
+      m_moreFragments = moreFragments;
+    }
+
+  // without previous overlaps, only the neighbours can overlap the new fragment
+  if (it != m_fragments.begin ())
+    {
+      Fragments_t::iterator prev = std::prev (it);
+      if (prev->first == offset || prev->first + prev->second->GetSize () > offset)
+        {
+          m_overlaps = true;
+        }
+    }
+  if (next != m_fragments.end () && next->first < end)
+    {
+      m_overlaps = true;
+    }
+
+  m_end = std::max (m_end, end);
+
+  if (offset <= m_received && end > m_received)
+    {
+      // the fragments up to m_received are already accounted for
+      Fragments_t::iterator i = m_fragments.upper_bound (m_received);
+      m_received = end;
+      for ( ; i != m_fragments.end () && i->first <= m_received; i++)
+        {
+          m_received = std::max (m_received, i->first + i->second->GetSize ());
+        }
+      NS_LOG_LOGIC ("Received without hole up to " << m_received);
+    }
+}
+
+bool
+FragmentBuffer::IsEntire (void) const
+{
+  return !m_moreFragments && !m_fragments.empty () && m_received == m_end;
+}
+
+bool
+FragmentBuffer::HasOverlaps (void) const
+{
+  return m_overlaps;
+}
+
+Ptr<Packet>
+FragmentBuffer::GetPacket (void) const
+{
+  NS_LOG_FUNCTION (this);
+
+  Fragments_t::const_iterator it = m_fragments.begin ();
+  if (it == m_fragments.end () || it->first > 0)
+    {
+      return Create<Packet> ();
+    }
+
+  Ptr<Packet> p = it->second->Copy ();
+  for (it++; it != m_fragments.end () && it->first <= p->GetSize (); it++)
+    {
+      uint32_t lastEnd = p->GetSize ();
+      if (lastEnd > it->first)
+        {
+          // The fragments are overlapping.
+          // We do not overwrite the "old" with the "new" because we do not know when each arrived.
+          uint32_t newStart = lastEnd - it->first;
+          if (it->second->GetSize () > newStart)
+            {
+              p->AddAtEnd (it->second->CreateFragment (newStart, it->second->GetSize () - newStart));
+            }
+        }
+      else
+        {
+          p->AddAtEnd (it->second);
+        }
+    }
+
+  return p;
+}
+
+} // namespace ns3
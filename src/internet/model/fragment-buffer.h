@@ -0,0 +1,194 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FRAGMENT_BUFFER_H
+#define FRAGMENT_BUFFER_H
+
+#include <list>
+#include <map>
+#include <iterator>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/nstime.h"
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup internet
+ *
+ * \brief The fragments of a packet waiting to be reassembled
+ *
+ * The fragments are indexed by offset, and the end of the data received
+ * without hole from offset 0 is advanced as they arrive: adding a fragment
+ * takes a logarithmic time, and knowing whether the packet is entire a
+ * constant time, whatever the order of arrival.
+ *
+ * Overlapping fragments are kept, and the overlapping bytes are taken from
+ * the fragment with the lowest offset.  Since each protocol has its own
+ * rules about them, the buffer only records that some fragments overlap.
+ */
+class FragmentBuffer
+{
+public:
+  FragmentBuffer ();
+
+  /**
+   * \brief Add a fragment.
+   * \param fragment the fragment
+   * \param offset the offset of the fragment, in bytes
+   * \param moreFragments the bit "More Fragments"
+   */
+  void AddFragment (Ptr<Packet> fragment, uint32_t offset, bool moreFragments);
+
+  /**
+   * \brief If all the fragments have been added.
+   * \returns true if the last fragment has been received, and there is no hole
+   */
+  bool IsEntire (void) const;
+
+  /**
+   * \brief If some fragments overlap, or have been received twice.
+   * \returns true if some fragments overlap
+   */
+  bool HasOverlaps (void) const;
+
+  /**
+   * \brief Get the data received without hole from offset 0.
+   *
+   * This is the entire packet when IsEntire returns true.
+   *
+   * \return the data, or an empty packet if the first fragment is missing
+   */
+  Ptr<Packet> GetPacket (void) const;
+
+private:
+  /// Fragments, by offset (the later ones after the earlier ones at the same offset)
+  typedef std::multimap<uint32_t, Ptr<Packet> > Fragments_t;
+
+  Fragments_t m_fragments; //!< The fragments
+  uint32_t m_received;     //!< End of the data received without hole from offset 0
+  uint32_t m_end;          //!< End of the data received
+  bool m_moreFragments;    //!< The bit "More Fragments" of the fragment with the highest offset
+  bool m_overlaps;         //!< If some fragments overlap
+};
+
+/**
+ * \ingroup internet
+ *
+ * \brief The reassembly timeouts of a protocol
+ *
+ * All the reassemblies of a protocol expire after the same time, hence in
+ * the order they started: the timeouts are queued in this order, and a
+ * single event is scheduled at a time, for the earliest one.  This is a
+ * timer wheel with a slot for each expiration time: starting, completing
+ * or expiring a reassembly never schedules nor cancels a per-packet event.
+ *
+ * \tparam Key the type identifying a reassembly
+ */
+template <typename Key>
+class FragmentTimeouts
+{
+public:
+  /// Container of the timeouts
+  typedef std::list<std::pair<Time, Key> > Timeouts_t;
+  /// Iterator to a timeout
+  typedef typename Timeouts_t::iterator Iterator;
+
+  /**
+   * \brief Set the function called when a reassembly expires.
+   * \param expire the callback, called with the key of the reassembly
+   */
+  void SetExpireCallback (Callback<void, Key> expire)
+  {
+    m_expire = expire;
+  }
+
+  /**
+   * \brief Start the timeout of a reassembly.
+   * \param delay the time before the reassembly expires
+   * \param key the reassembly
+   * \return an iterator to the timeout, to remove it
+   */
+  Iterator Add (Time delay, const Key &key)
+  {
+    Time expiration = Simulator::Now () + delay;
+    // the delay is usually the same, so that the place is at the end
+    Iterator it = m_timeouts.end ();
+    while (it != m_timeouts.begin () && std::prev (it)->first > expiration)
+      {
+        --it;
+      }
+    it = m_timeouts.emplace (it, expiration, key);
+    if (it == m_timeouts.begin ())
+      {
+        m_event.Cancel ();
+        m_event = Simulator::Schedule (delay, &FragmentTimeouts<Key>::Expire, this);
+      }
+    return it;
+  }
+
+  /**
+   * \brief Remove the timeout of a completed reassembly.
+   * \param it the timeout
+   */
+  void Remove (Iterator it)
+  {
+    m_timeouts.erase (it);
+    if (m_timeouts.empty ())
+      {
+        m_event.Cancel ();
+      }
+  }
+
+  /**
+   * \brief Remove all the timeouts.
+   */
+  void Clear (void)
+  {
+    m_timeouts.clear ();
+    m_event.Cancel ();
+  }
+
+private:
+  /**
+   * \brief Expire the reassemblies whose time has come, and schedule the next one.
+   */
+  void Expire (void)
+  {
+    Time now = Simulator::Now ();
+    while (!m_timeouts.empty () && m_timeouts.front ().first <= now)
+      {
+        Key key = m_timeouts.front ().second;
+        m_timeouts.pop_front ();
+        m_expire (key);
+      }
+    if (!m_timeouts.empty ())
+      {
+        m_event = Simulator::Schedule (m_timeouts.front ().first - now, &FragmentTimeouts<Key>::Expire, this);
+      }
+  }
+
+  Timeouts_t m_timeouts;        //!< The timeouts, in order of expiration
+  EventId m_event;              //!< Event for the earliest timeout
+  Callback<void, Key> m_expire; //!< Called when a reassembly expires
+};
+
+} // namespace ns3
+
+#endif /* FRAGMENT_BUFFER_H */
@@ -25,6 +25,7 @@
 #include <utility>
 #include <vector>
 #include <queue>
+#include <set>
 #include <algorithm>
 #include <iostream>
 #include "ns3/assert.h"
@@ -34,6 +35,13 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-list-routing.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#endif
 #include "global-router-interface.h"
 #include "global-route-manager-impl.h"
 #include "candidate-queue.h"
@@ -43,6 +51,25 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * \brief Number of threads running the SPF calculations.
+ */
+static GlobalValue g_spfThreads = GlobalValue ("GlobalRoutingSpfThreads",
+                                               "The number of threads running the SPF calculations of the global routing",
+                                               UintegerValue (1),
+                                               MakeUintegerChecker<uint32_t> (1));
+
+/**
+ * \ingroup globalrouting
+ * \brief Whether to keep the SPF trees, to update them incrementally.
+ */
+static GlobalValue g_incrementalSpf = GlobalValue ("GlobalRoutingIncrementalSpf",
+                                                   "Keep the shortest-path trees of the global routing, to update "
+                                                   "them incrementally when the routes are recomputed",
+                                                   BooleanValue (false),
+                                                   MakeBooleanChecker ());
+
 /**
  * \brief Stream insertion operator.
  *
@@ -138,8 +165,9 @@ SPFVertex::~SPFVertex ()
       // remove the current vertex from its parent's children list. Check
       // if the size of the list is reduced, or the child<->parent relation
       // is not bidirectional
-      uint32_t orgCount = (*piter)->m_children.size ();
-      (*piter)->m_children.remove (this);
+      ListOfSPFVertex_t &siblings = (*piter)->m_children;
+      uint32_t orgCount = siblings.size ();
+      siblings.erase (std::remove (siblings.begin (), siblings.end (), this), siblings.end ());
       uint32_t newCount = (*piter)->m_children.size ();
       if (orgCount > newCount)
         {
@@ -155,9 +183,9 @@ SPFVertex::~SPFVertex ()
       // it is necessary to use pop to walk through all children, instead
       // of using iterator.
       //
-      // Note that m_children.pop_front () is not necessary as this
+      // Note that m_children.pop_back () is not necessary as this
       // p is removed from the children list when p is deleted
-      SPFVertex* p = m_children.front ();
+      SPFVertex* p = m_children.back ();
       // 'p' == 0, this child is already deleted by its other parent
       if (p == 0) continue;
       NS_LOG_LOGIC ("Parent vertex-" << m_vertexId << " deleting its child vertex-" << p->GetVertexId ());
@@ -268,8 +296,8 @@ SPFVertex::MergeParent (const SPFVertex* v)
   m_parents.insert (m_parents.end (), 
                     v->m_parents.begin (), v->m_parents.end ());
   // remove duplication
-  m_parents.sort ();
-  m_parents.unique ();
+  std::sort (m_parents.begin (), m_parents.end ());
+  m_parents.erase (std::unique (m_parents.begin (), m_parents.end ()), m_parents.end ());
   NS_LOG_LOGIC ("After merge, list of parents = " << m_parents);
 }
 
@@ -365,19 +393,8 @@ SPFVertex*
 SPFVertex::GetChild (uint32_t n) const
 {
   NS_LOG_FUNCTION (this << n);
-  uint32_t j = 0;
-
-  for ( ListOfSPFVertex_t::const_iterator i = m_children.begin ();
-        i != m_children.end ();
-        i++, j++)
-    {
-      if (j == n)
-        {
-          return *i;
-        }
-    }
-  NS_ASSERT_MSG (false, "Index <n> out of range.");
-  return 0;
+  NS_ASSERT_MSG (n < m_children.size (), "Index <n> out of range.");
+  return m_children[n];
 }
 
 uint32_t
@@ -422,7 +439,9 @@ SPFVertex::ClearVertexProcessed (void)
 GlobalRouteManagerLSDB::GlobalRouteManagerLSDB ()
   :
     m_database (),
-    m_extdatabase ()
+    m_extdatabase (),
+    m_linkDataIndex (),
+    m_linkDataIndexValid (false)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -470,6 +489,7 @@ GlobalRouteManagerLSDB::Insert (Ipv4Address addr, GlobalRoutingLSA* lsa)
   else
     {
       m_database.insert (LSDBPair_t (addr, lsa));
+      m_linkDataIndexValid = false;
     }
 }
 
@@ -494,13 +514,10 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i != m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return i->second;
     }
   return 0;
 }
@@ -510,26 +527,218 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this << addr);
 //
-// Look up an LSA by its address.
+// Look up an LSA by the link data of its transit network link records.  The
+// index keeps, for each link data, the first LSA of the database (and its
+// first link record) having it.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  if (!m_linkDataIndexValid)
     {
-      GlobalRoutingLSA* temp = i->second;
-// Iterate among temp's Link Records
-      for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
+      m_linkDataIndex.clear ();
+      LSDBMap_t::const_iterator i;
+      for (i= m_database.begin (); i!= m_database.end (); i++)
         {
-          GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
-          if ( lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork &&
-               lr->GetLinkData () == addr)
+          GlobalRoutingLSA* temp = i->second;
+// Iterate among temp's Link Records
+          for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
             {
-              return temp;
+              GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
+              if (lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork)
+                {
+                  m_linkDataIndex.insert (std::make_pair (lr->GetLinkData (), temp));
+                }
             }
         }
+      m_linkDataIndexValid = true;
+    }
+  LinkDataIndex_t::const_iterator i = m_linkDataIndex.find (addr);
+  if (i != m_linkDataIndex.end ())
+    {
+      return i->second;
     }
   return 0;
 }
 
+GlobalRouteManagerLSDB*
+GlobalRouteManagerLSDB::Copy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  GlobalRouteManagerLSDB* lsdb = new GlobalRouteManagerLSDB ();
+  for (LSDBMap_t::const_iterator i = m_database.begin (); i != m_database.end (); i++)
+    {
+      GlobalRoutingLSA* lsa = new GlobalRoutingLSA ();
+      *lsa = *i->second;
+      lsdb->m_database.insert (LSDBPair_t (i->first, lsa));
+    }
+  for (uint32_t j = 0; j < m_extdatabase.size (); j++)
+    {
+      GlobalRoutingLSA* lsa = new GlobalRoutingLSA ();
+      *lsa = *m_extdatabase[j];
+      lsdb->m_extdatabase.push_back (lsa);
+    }
+  return lsdb;
+}
+
+/**
+ * \brief Compare two link records
+ * \param a a link record
+ * \param b another link record
+ * \returns true if both records are the same
+ */
+static bool
+SameLinkRecord (const GlobalRoutingLinkRecord* a, const GlobalRoutingLinkRecord* b)
+{
+  return a->GetLinkType () == b->GetLinkType ()
+         && a->GetLinkId () == b->GetLinkId ()
+         && a->GetLinkData () == b->GetLinkData ()
+         && a->GetMetric () == b->GetMetric ();
+}
+
+/**
+ * \brief Get the link records of a router LSA used in the first stage of
+ * the SPF calculation, i.e., all but the stub network records
+ * \param lsa the LSA
+ * \param [out] records the records, in order
+ */
+static void
+GetTransitRecords (const GlobalRoutingLSA* lsa, std::vector<GlobalRoutingLinkRecord*> &records)
+{
+  records.clear ();
+  for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+    {
+      GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+      if (lr->GetLinkType () != GlobalRoutingLinkRecord::StubNetwork)
+        {
+          records.push_back (lr);
+        }
+    }
+}
+
+bool
+GlobalRouteManagerLSDB::GetChangedLinks (const GlobalRouteManagerLSDB* other,
+                                         std::vector<std::pair<Ipv4Address, Ipv4Address> > &changes) const
+{
+  NS_LOG_FUNCTION (this << other);
+  changes.clear ();
+  if (m_database.size () != other->m_database.size ())
+    {
+      return false;
+    }
+  std::vector<GlobalRoutingLinkRecord*> mine;
+  std::vector<GlobalRoutingLinkRecord*> theirs;
+  LSDBMap_t::const_iterator i = m_database.begin ();
+  LSDBMap_t::const_iterator k = other->m_database.begin ();
+  for (; i != m_database.end (); i++, k++)
+    {
+      const GlobalRoutingLSA* a = i->second;
+      const GlobalRoutingLSA* b = k->second;
+      if (i->first != k->first || a->GetLSType () != b->GetLSType ()
+          || a->GetLinkStateId () != b->GetLinkStateId ())
+        {
+          return false;
+        }
+      if (a->GetLSType () != GlobalRoutingLSA::RouterLSA)
+        {
+          if (a->GetNetworkLSANetworkMask () != b->GetNetworkLSANetworkMask ()
+              || a->GetNAttachedRouters () != b->GetNAttachedRouters ())
+            {
+              return false;
+            }
+          for (uint32_t j = 0; j < a->GetNAttachedRouters (); j++)
+            {
+              if (a->GetAttachedRouter (j) != b->GetAttachedRouter (j))
+                {
+                  return false;
+                }
+            }
+          continue;
+        }
+      GetTransitRecords (a, mine);
+      GetTransitRecords (b, theirs);
+      bool same = (mine.size () == theirs.size ());
+      for (uint32_t j = 0; same && j < mine.size (); j++)
+        {
+          same = SameLinkRecord (mine[j], theirs[j]);
+        }
+      if (same)
+        {
+          continue;
+        }
+//
+// Find the neighbors toward which the records changed, and check that the
+// other records are in the same order (the SPF calculation examines them
+// in order).
+//
+      typedef std::map<Ipv4Address, std::vector<GlobalRoutingLinkRecord*> > ByNeighbor_t;
+      ByNeighbor_t before;
+      ByNeighbor_t after;
+      for (uint32_t j = 0; j < mine.size (); j++)
+        {
+          before[mine[j]->GetLinkId ()].push_back (mine[j]);
+        }
+      for (uint32_t j = 0; j < theirs.size (); j++)
+        {
+          after[theirs[j]->GetLinkId ()].push_back (theirs[j]);
+        }
+      std::set<Ipv4Address> changed;
+      for (uint32_t side = 0; side < 2; side++)
+        {
+          const ByNeighbor_t &x = side ? after : before;
+          const ByNeighbor_t &y = side ? before : after;
+          for (ByNeighbor_t::const_iterator n = x.begin (); n != x.end (); n++)
+            {
+              ByNeighbor_t::const_iterator m = y.find (n->first);
+              bool equal = (m != y.end () && m->second.size () == n->second.size ());
+              for (uint32_t j = 0; equal && j < n->second.size (); j++)
+                {
+                  equal = SameLinkRecord (n->second[j], m->second[j]);
+                }
+              if (equal)
+                {
+                  continue;
+                }
+              for (uint32_t j = 0; j < n->second.size (); j++)
+                {
+                  if (n->second[j]->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+                    {
+                      return false;
+                    }
+                }
+              changed.insert (n->first);
+            }
+        }
+      uint32_t jm = 0;
+      uint32_t jt = 0;
+      for (;;)
+        {
+          while (jm < mine.size () && changed.count (mine[jm]->GetLinkId ()))
+            {
+              jm++;
+            }
+          while (jt < theirs.size () && changed.count (theirs[jt]->GetLinkId ()))
+            {
+              jt++;
+            }
+          if (jm == mine.size () || jt == theirs.size ())
+            {
+              break;
+            }
+          if (!SameLinkRecord (mine[jm++], theirs[jt++]))
+            {
+              return false;
+            }
+        }
+      if (jm != mine.size () || jt != theirs.size ())
+        {
+          return false;
+        }
+      for (std::set<Ipv4Address>::const_iterator n = changed.begin (); n != changed.end (); n++)
+        {
+          changes.push_back (std::make_pair (a->GetLinkStateId (), *n));
+        }
+    }
+  return true;
+}
+
 // ---------------------------------------------------------------------------
 //
 // GlobalRouteManagerImpl Implementation
@@ -538,7 +747,9 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl () 
   :
-    m_spfroot (0)
+    m_spfroot (0),
+    m_previousLsdb (0),
+    m_root (0)
 {
   NS_LOG_FUNCTION (this);
   m_lsdb = new GlobalRouteManagerLSDB ();
@@ -551,6 +762,10 @@ GlobalRouteManagerImpl::~GlobalRouteManagerImpl ()
     {
       delete m_lsdb;
     }
+  if (m_previousLsdb)
+    {
+      delete m_previousLsdb;
+    }
 }
 
 void
@@ -591,10 +806,29 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes ()
         }
       NS_LOG_LOGIC ("Deleted " << j << " global routes from node "<< node->GetId ());
     }
+  BooleanValue incremental;
+  g_incrementalSpf.GetValue (incremental);
+  if (m_previousLsdb)
+    {
+      delete m_previousLsdb;
+      m_previousLsdb = 0;
+    }
+  if (!incremental.Get ())
+    {
+      m_roots.clear ();
+    }
   if (m_lsdb)
     {
-      NS_LOG_LOGIC ("Deleting LSDB, creating new one");
-      delete m_lsdb;
+      if (incremental.Get ())
+        {
+          NS_LOG_LOGIC ("Keeping LSDB for the incremental SPF, creating new one");
+          m_previousLsdb = m_lsdb;
+        }
+      else
+        {
+          NS_LOG_LOGIC ("Deleting LSDB, creating new one");
+          delete m_lsdb;
+        }
       m_lsdb = new GlobalRouteManagerLSDB ();
     }
 }
@@ -699,6 +933,7 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 // Walk the list of nodes in the system.
 //
   NS_LOG_INFO ("About to start SPF calculation");
+  std::vector<SPFRoot> roots;
   NodeList::Iterator listEnd = NodeList::End ();
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
@@ -723,12 +958,246 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 //
       if (rtr && rtr->GetNumLSAs () )
         {
-          SPFCalculate (rtr->GetRouterId ());
+          roots.push_back (SPFRoot ());
+          PrepareRoot (node, rtr, roots.back ());
         }
     }
+
+  BooleanValue incremental;
+  g_incrementalSpf.GetValue (incremental);
+  if (incremental.Get () && m_previousLsdb)
+    {
+      PlanIncrementalSPF (roots);
+    }
+  RunSPF (roots);
+//
+// Install the routes, in node order.
+//
+  for (std::vector<SPFRoot>::iterator i = roots.begin (); i != roots.end (); i++)
+    {
+      InstallRoutes (*i);
+      std::vector<SPFRoute> ().swap (i->routes);
+      i->routing = 0;
+      if (!incremental.Get ())
+        {
+          std::vector<SPFTreeVertex> ().swap (i->tree);
+          std::vector<uint32_t> ().swap (i->order);
+        }
+    }
+  if (incremental.Get ())
+    {
+      m_roots.swap (roots);
+    }
+  else
+    {
+      m_roots.clear ();
+    }
+  if (m_previousLsdb)
+    {
+      delete m_previousLsdb;
+      m_previousLsdb = 0;
+    }
   NS_LOG_INFO ("Finished SPF calculation");
 }
 
+void
+GlobalRouteManagerImpl::PrepareRoot (Ptr<Node> node, Ptr<GlobalRouter> rtr, SPFRoot &root)
+{
+  NS_LOG_FUNCTION (node << rtr);
+  root.routerId = rtr->GetRouterId ();
+  root.routing = rtr->GetRoutingProtocol ();
+  root.checkStub = NodeList::GetNNodes () > 0;
+  root.replay = false;
+  root.stub = false;
+  root.addresses.clear ();
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  NS_ASSERT_MSG (ipv4, 
+                 "GlobalRouteManagerImpl::PrepareRoot (): "
+                 "GetObject for <Ipv4> interface failed");
+  for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+    {
+      for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+        {
+          root.addresses.push_back (std::make_pair (ipv4->GetAddress (i, j).GetLocal (), i));
+        }
+    }
+}
+
+//
+// A router u examines its link records when it is added to the SPF tree;
+// the records toward a router w that was added to the tree before are
+// ignored.  So, if the point-to-point link records from u to w changed, and
+// either u was not reached or w was added to the tree before u, the
+// calculation examines the same records, in the same order, with the same
+// results: the tree is unchanged, and the routes can be found again from it
+// and from the new database (whose stub records and external LSAs may have
+// changed).
+//
+// The records toward the root, and those of the root, also determine the
+// next hops of the root: their changes, and those of the addresses of the
+// root, lead to a full calculation, as do the other changes to the database
+// (see GlobalRouteManagerLSDB::GetChangedLinks).
+//
+void
+GlobalRouteManagerImpl::PlanIncrementalSPF (std::vector<SPFRoot> &roots)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<std::pair<Ipv4Address, Ipv4Address> > changes;
+  if (!m_previousLsdb->GetChangedLinks (m_lsdb, changes))
+    {
+      NS_LOG_LOGIC ("Full SPF calculation");
+      return;
+    }
+  std::unordered_map<Ipv4Address, SPFRoot*, Ipv4AddressHash> previous;
+  for (std::vector<SPFRoot>::iterator i = m_roots.begin (); i != m_roots.end (); i++)
+    {
+      previous[i->routerId] = &*i;
+    }
+  std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> rank;
+  for (std::vector<SPFRoot>::iterator r = roots.begin (); r != roots.end (); r++)
+    {
+      std::unordered_map<Ipv4Address, SPFRoot*, Ipv4AddressHash>::iterator p = previous.find (r->routerId);
+      if (p == previous.end () || p->second->stub || p->second->tree.empty ()
+          || p->second->addresses != r->addresses)
+        {
+          continue;
+        }
+      SPFRoot *old = p->second;
+      rank.clear ();
+      for (uint32_t j = 0; j < old->tree.size (); j++)
+        {
+          if (old->tree[j].type == SPFVertex::VertexRouter)
+            {
+              rank.insert (std::make_pair (old->tree[j].id, j));
+            }
+        }
+      bool unchanged = true;
+      for (uint32_t j = 0; unchanged && j < changes.size (); j++)
+        {
+          Ipv4Address u = changes[j].first;
+          Ipv4Address w = changes[j].second;
+          if (u == r->routerId || w == r->routerId)
+            {
+              unchanged = false;
+              break;
+            }
+          std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash>::const_iterator ru = rank.find (u);
+          if (ru == rank.end ())
+            {
+              continue;
+            }
+          std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash>::const_iterator rw = rank.find (w);
+          unchanged = (rw != rank.end () && rw->second < ru->second);
+        }
+      if (unchanged)
+        {
+          NS_LOG_LOGIC ("Reusing the SPF tree of " << r->routerId);
+          r->replay = true;
+          r->tree.swap (old->tree);
+          r->order.swap (old->order);
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::RunSPF (std::vector<SPFRoot> &roots)
+{
+  NS_LOG_FUNCTION (this);
+  UintegerValue threads;
+  g_spfThreads.GetValue (threads);
+  uint32_t nThreads = std::min<uint32_t> (threads.Get (), roots.size ());
+#ifndef HAVE_PTHREAD_H
+  nThreads = std::min<uint32_t> (nThreads, 1);
+#endif
+  if (nThreads <= 1)
+    {
+      m_jobs.clear ();
+      for (uint32_t i = 0; i < roots.size (); i++)
+        {
+          m_jobs.push_back (&roots[i]);
+        }
+      RunSPFJobs ();
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+//
+// Each worker has its own copy of the LSDB, since the SPF calculation keeps
+// its state in the LSAs; this object is the first worker.  The roots are
+// dealt in turn to the workers.
+//
+  NS_LOG_LOGIC ("SPF calculations in " << nThreads << " threads");
+  std::vector<GlobalRouteManagerImpl*> workers;
+  workers.push_back (this);
+  m_jobs.clear ();
+  for (uint32_t t = 1; t < nThreads; t++)
+    {
+      GlobalRouteManagerImpl* worker = new GlobalRouteManagerImpl ();
+      delete worker->m_lsdb;
+      worker->m_lsdb = m_lsdb->Copy ();
+      workers.push_back (worker);
+    }
+  for (uint32_t i = 0; i < roots.size (); i++)
+    {
+      workers[i % nThreads]->m_jobs.push_back (&roots[i]);
+    }
+  std::vector<Ptr<SystemThread> > systemThreads;
+  for (uint32_t t = 1; t < nThreads; t++)
+    {
+      systemThreads.push_back (Create<SystemThread> (MakeCallback (&GlobalRouteManagerImpl::RunSPFJobs, workers[t])));
+      systemThreads.back ()->Start ();
+    }
+  RunSPFJobs ();
+  for (uint32_t t = 1; t < nThreads; t++)
+    {
+      systemThreads[t - 1]->Join ();
+      delete workers[t];
+    }
+#endif
+}
+
+void
+GlobalRouteManagerImpl::RunSPFJobs (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<SPFRoot*>::iterator i = m_jobs.begin (); i != m_jobs.end (); i++)
+    {
+      if ((*i)->replay)
+        {
+          SPFAddRoutes (**i);
+        }
+      else
+        {
+          SPFCalculate (**i);
+        }
+    }
+  m_jobs.clear ();
+}
+
+void
+GlobalRouteManagerImpl::InstallRoutes (SPFRoot &root)
+{
+  NS_LOG_FUNCTION (root.routerId);
+  if (root.routing == 0)
+    {
+      return;
+    }
+  for (std::vector<SPFRoute>::const_iterator i = root.routes.begin (); i != root.routes.end (); i++)
+    {
+      switch (i->type)
+        {
+        case SPFRoute::HOST:
+          root.routing->AddHostRouteTo (i->dest, i->nextHop, i->outIf);
+          break;
+        case SPFRoute::NETWORK:
+          root.routing->AddNetworkRouteTo (i->dest, i->mask, i->nextHop, i->outIf);
+          break;
+        case SPFRoute::EXTERNAL:
+          root.routing->AddASExternalRouteTo (i->dest, i->mask, i->nextHop, i->outIf);
+          break;
+        }
+    }
+}
+
 //
 // This method is derived from quagga ospf_spf_next ().  See RFC2328 Section 
 // 16.1 (2) for further details.
@@ -1123,7 +1592,13 @@ GlobalRouteManagerImpl::SPFNexthopCalculation (
         }
       else 
         {
-          w->SetRootExitDirection (v->GetRootExitDirection ());
+//
+// The network may have been reached through equal-cost paths, in which case
+// it has several root exits.  The router behind it inherits all of them,
+// rather than only the first one: the network would otherwise forward all
+// the traffic to the routers behind it through a single exit.
+//
+          w->InheritAllRootExitDirections (v);
         }
     }
   else 
@@ -1246,7 +1721,23 @@ void
 GlobalRouteManagerImpl::DebugSPFCalculate (Ipv4Address root)
 {
   NS_LOG_FUNCTION (this << root);
-  SPFCalculate (root);
+  SPFRoot spfRoot;
+  spfRoot.routerId = root;
+  spfRoot.checkStub = NodeList::GetNNodes () > 0;
+  spfRoot.replay = false;
+  spfRoot.stub = false;
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      if (rtr && rtr->GetRouterId () == root)
+        {
+          PrepareRoot (*i, rtr, spfRoot);
+          break;
+        }
+    }
+  SPFCalculate (spfRoot);
+  InstallRoutes (spfRoot);
 }
 
 //
@@ -1319,12 +1810,13 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
               if (lr->GetLinkId () == myRouterId)
                 {
                   // Next hop is stored in the LinkID field of lr
-                  Ptr<GlobalRouter> router = rlsa->GetNode ()->GetObject<GlobalRouter> ();
-                  NS_ASSERT (router);
-                  Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-                  NS_ASSERT (gr);
-                  gr->AddNetworkRouteTo (Ipv4Address ("0.0.0.0"), Ipv4Mask ("0.0.0.0"), lr->GetLinkData (), 
-                                         FindOutgoingInterfaceId (transitLink->GetLinkData ()));
+                  SPFRoute route;
+                  route.type = SPFRoute::NETWORK;
+                  route.dest = Ipv4Address ("0.0.0.0");
+                  route.mask = Ipv4Mask ("0.0.0.0");
+                  route.nextHop = lr->GetLinkData ();
+                  route.outIf = FindOutgoingInterfaceId (transitLink->GetLinkData ());
+                  m_root->routes.push_back (route);
                   NS_LOG_LOGIC ("Inserting default route for node " << myRouterId << " to next hop " << 
                                 lr->GetLinkData () << " via interface " << 
                                 FindOutgoingInterfaceId (transitLink->GetLinkData ()));
@@ -1338,11 +1830,17 @@ GlobalRouteManagerImpl::CheckForStubNode (Ipv4Address root)
 
 // quagga ospf_spf_calculate
 void
-GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
+GlobalRouteManagerImpl::SPFCalculate (SPFRoot &spfRoot)
 {
+  Ipv4Address root = spfRoot.routerId;
   NS_LOG_FUNCTION (this << root);
 
   SPFVertex *v;
+  m_root = &spfRoot;
+  spfRoot.routes.clear ();
+  spfRoot.tree.clear ();
+  spfRoot.order.clear ();
+  spfRoot.stub = false;
 //
 // Initialize the Link State Database.
 //
@@ -1368,6 +1866,16 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
   v->SetDistanceFromRoot (0);
   v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
   NS_LOG_LOGIC ("Starting SPFCalculate for node " << root);
+//
+// The vertices are remembered in the order they are added to the tree: the
+// routes are found from this tree, once it is complete.
+//
+  std::unordered_map<const SPFVertex*, uint32_t> index;
+  SPFTreeVertex treeVertex;
+  treeVertex.id = v->GetVertexId ();
+  treeVertex.type = v->GetVertexType ();
+  index[v] = spfRoot.tree.size ();
+  spfRoot.tree.push_back (treeVertex);
 
 //
 // Optimize SPF calculation, for ns-3.
@@ -1376,10 +1884,13 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // reached.  Instead, short-circuit this computation and just install
 // a default route in the CheckForStubNode() method.
 //
-  if (NodeList::GetNNodes () > 0 && CheckForStubNode (root))
+  if (spfRoot.checkStub && CheckForStubNode (root))
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
+      spfRoot.stub = true;
       delete m_spfroot;
+      m_spfroot = 0;
+      m_root = 0;
       return;
     }
 
@@ -1443,93 +1954,130 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
 // RFC2328 16.1. (4). 
 //
-// This is the method that actually adds the routes.  It'll walk the list
-// of nodes in the system, looking for the node corresponding to the router
-// ID of the root of the tree -- that is the router we're building the routes
-// for.  It looks for the Ipv4 interface of that node and remembers it.  So
-// we are only actually adding routes to that one node at the root of the SPF 
-// tree.
+// Remember the vertex, its type and the outbound interfaces and next hops
+// to reach it from the root, which have possibly been inherited from the
+// root.  The routes toward the vertex are added once the tree is complete
+// (see SPFAddRoutes).
+//
+      NS_ASSERT_MSG (v->GetVertexType () == SPFVertex::VertexRouter
+                     || v->GetVertexType () == SPFVertex::VertexNetwork,
+                     "illegal SPFVertex type");
+      treeVertex.id = v->GetVertexId ();
+      treeVertex.type = v->GetVertexType ();
+      treeVertex.exits.clear ();
+      for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
+        {
+          treeVertex.exits.push_back (v->GetRootExitDirection (i));
+        }
+      index[v] = spfRoot.tree.size ();
+      spfRoot.tree.push_back (treeVertex);
 //
-// We're going to pop of a pointer to every vertex in the tree except the 
-// root in order of distance from the root.  For each of the vertices, we call
-// SPFIntraAddRouter ().  Down in SPFIntraAddRouter, we look at all of the 
-// point-to-point Global Router Link Records (the links to nodes adjacent to
-// the node represented by the vertex).  We add a route to the IP address 
-// specified by the m_linkData field of each of those link records.  This will
-// be the *local* IP address associated with the interface attached to the 
-// link.  We use the outbound interface and next hop information present in 
-// the vertex <v> which have possibly been inherited from the root.
+// RFC2328 16.1. (5). 
+//
+// Iterate the algorithm by returning to Step 2 until there are no more
+// candidate vertices.
+
+    }  // end for loop
+
+// The second stage of the calculation visits the tree depth-first
+  spfRoot.order.push_back (0);
+  SPFDepthFirstOrder (m_spfroot, index);
+
+//
+// We're all done with the tree of the node at the root.  Delete all of the
+// vertices and corresponding resources, and find the routes.  Go possibly do
+// it again for the next router.
+//
+  delete m_spfroot;
+  m_spfroot = 0;
+  SPFAddRoutes (spfRoot);
+}
+
+void
+GlobalRouteManagerImpl::SPFDepthFirstOrder (SPFVertex* v, const std::unordered_map<const SPFVertex*, uint32_t> &index)
+{
+  NS_LOG_FUNCTION (this << v);
+  for (uint32_t i = 0; i < v->GetNChildren (); i++)
+    {
+      SPFVertex* child = v->GetChild (i);
+      if (!child->IsVertexProcessed ())
+        {
+          m_root->order.push_back (index.at (child));
+          SPFDepthFirstOrder (child, index);
+          child->SetVertexProcessed (true);
+        }
+    }
+}
+
+void
+GlobalRouteManagerImpl::SPFAddRoutes (SPFRoot &spfRoot)
+{
+  NS_LOG_FUNCTION (this << spfRoot.routerId);
+  m_root = &spfRoot;
+  spfRoot.routes.clear ();
+//
+// This is where the routes are actually added.  We go through every vertex
+// in the tree except the root, in the order they were added to the tree,
+// i.e., in order of distance from the root.  For each of the router
+// vertices, we call SPFIntraAddRouter ().  Down in SPFIntraAddRouter, we look
+// at all of the point-to-point Global Router Link Records (the links to nodes
+// adjacent to the node represented by the vertex).  We add a route to the IP
+// address specified by the m_linkData field of each of those link records.
+// This will be the *local* IP address associated with the interface attached
+// to the link.  We use the outbound interface and next hop information
+// remembered in the vertex.
 //
 // To summarize, we're going to look at the node represented by <v> and loop
 // through its point-to-point links, adding a *host* route to the local IP
 // address (at the <v> side) for each of those links.
 //
-      if (v->GetVertexType () == SPFVertex::VertexRouter)
+  for (uint32_t i = 1; i < spfRoot.tree.size (); i++)
+    {
+      const SPFTreeVertex &v = spfRoot.tree[i];
+      if (v.type == SPFVertex::VertexRouter)
         {
           SPFIntraAddRouter (v);
         }
-      else if (v->GetVertexType () == SPFVertex::VertexNetwork)
-        {
-          SPFIntraAddTransit (v);
-        }
       else
         {
-          NS_ASSERT_MSG (0, "illegal SPFVertex type");
+          SPFIntraAddTransit (v);
         }
-//
-// RFC2328 16.1. (5). 
-//
-// Iterate the algorithm by returning to Step 2 until there are no more
-// candidate vertices.
-
-    }  // end for loop
+    }
 
 // Second stage of SPF calculation procedure
-  SPFProcessStubs (m_spfroot);
-  for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs (); i++)
+  for (uint32_t i = 0; i < spfRoot.order.size (); i++)
+    {
+      SPFProcessStubs (spfRoot.tree[spfRoot.order[i]]);
+    }
+  for (uint32_t j = 0; j < m_lsdb->GetNumExtLSAs (); j++)
     {
-      m_spfroot->ClearVertexProcessed ();
-      GlobalRoutingLSA *extlsa = m_lsdb->GetExtLSA (i);
+      GlobalRoutingLSA *extlsa = m_lsdb->GetExtLSA (j);
       NS_LOG_LOGIC ("Processing External LSA with id " << extlsa->GetLinkStateId ());
-      ProcessASExternals (m_spfroot, extlsa);
+      for (uint32_t i = 0; i < spfRoot.order.size (); i++)
+        {
+          ProcessASExternals (spfRoot.tree[spfRoot.order[i]], extlsa);
+        }
     }
-
-//
-// We're all done setting the routing information for the node at the root of
-// the SPF tree.  Delete all of the vertices and corresponding resources.  Go
-// possibly do it again for the next router.
-//
-  delete m_spfroot;
-  m_spfroot = 0;
+  m_root = 0;
 }
 
 void
-GlobalRouteManagerImpl::ProcessASExternals (SPFVertex* v, GlobalRoutingLSA* extlsa)
+GlobalRouteManagerImpl::ProcessASExternals (const SPFTreeVertex &v, GlobalRoutingLSA* extlsa)
 {
-  NS_LOG_FUNCTION (this << v << extlsa);
+  NS_LOG_FUNCTION (this << v.id << extlsa);
   NS_LOG_LOGIC ("Processing external for destination " << 
                 extlsa->GetLinkStateId () <<
-                ", for router "  << v->GetVertexId () <<
+                ", for router "  << v.id <<
                 ", advertised by " << extlsa->GetAdvertisingRouter ());
-  if (v->GetVertexType () == SPFVertex::VertexRouter)
+  if (v.type == SPFVertex::VertexRouter)
     {
-      GlobalRoutingLSA *rlsa = v->GetLSA ();
-      NS_LOG_LOGIC ("Processing router LSA with id " << rlsa->GetLinkStateId ());
-      if ((rlsa->GetLinkStateId ()) == (extlsa->GetAdvertisingRouter ()))
+      NS_LOG_LOGIC ("Processing router LSA with id " << v.id);
+      if (v.id == extlsa->GetAdvertisingRouter ())
         {
           NS_LOG_LOGIC ("Found advertising router to destination");
           SPFAddASExternal (extlsa,v);
         }
     }
-  for (uint32_t i = 0; i < v->GetNChildren (); i++)
-    {
-      if (!v->GetChild (i)->IsVertexProcessed ())
-        {
-          NS_LOG_LOGIC ("Vertex's child " << i << " not yet processed, processing...");
-          ProcessASExternals (v->GetChild (i), extlsa);
-          v->GetChild (i)->SetVertexProcessed (true);
-        }
-    }
 }
 
 //
@@ -1538,126 +2086,61 @@ GlobalRouteManagerImpl::ProcessASExternals (SPFVertex* v, GlobalRoutingLSA* extl
 //
 
 void
-GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v)
+GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, const SPFTreeVertex &v)
 {
-  NS_LOG_FUNCTION (this << extlsa << v);
+  NS_LOG_FUNCTION (this << extlsa << v.id);
 
-  NS_ASSERT_MSG (m_spfroot, "GlobalRouteManagerImpl::SPFAddASExternal (): Root pointer not set");
+  NS_ASSERT_MSG (m_root, "GlobalRouteManagerImpl::SPFAddASExternal (): Root pointer not set");
 // Two cases to consider: We are advertising the external ourselves
 // => No need to add anything
 // OR find best path to the advertising router
-  if (v->GetVertexId () == m_spfroot->GetVertexId ())
+  if (v.id == m_root->routerId)
     {
       NS_LOG_LOGIC ("External is on local host: " 
-                    << v->GetVertexId () << "; returning");
+                    << v.id << "; returning");
       return;
     }
   NS_LOG_LOGIC ("External is on remote host: " 
                 << extlsa->GetAdvertisingRouter () << "; installing");
 
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
+  Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = extlsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
 
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The vertex <v> (corresponding to the advertising router) has the next hops
+// and outbound interfaces precalculated for us, to which the root node
+// should send packets to be forwarded to the external network.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v.exits.size (); i++)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
+      SPFVertex::NodeExit_t exit = v.exits[i];
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
         {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << node->GetId ());
-          continue;
+          SPFRoute route;
+          route.type = SPFRoute::EXTERNAL;
+          route.dest = tempip;
+          route.mask = tempmask;
+          route.nextHop = nextHop;
+          route.outIf = outIf;
+          m_root->routes.push_back (route);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_root->routerId <<
+                        " add external network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
+      else
         {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = extlsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddASExternalRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add external network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_root->routerId <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 
@@ -1665,20 +2148,21 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
 // stub link records will exist for point-to-point interfaces and for
 // broadcast interfaces for which no neighboring router can be found
 void
-GlobalRouteManagerImpl::SPFProcessStubs (SPFVertex* v)
+GlobalRouteManagerImpl::SPFProcessStubs (const SPFTreeVertex &v)
 {
-  NS_LOG_FUNCTION (this << v);
-  NS_LOG_LOGIC ("Processing stubs for " << v->GetVertexId ());
-  if (v->GetVertexType () == SPFVertex::VertexRouter)
+  NS_LOG_FUNCTION (this << v.id);
+  NS_LOG_LOGIC ("Processing stubs for " << v.id);
+  if (v.type == SPFVertex::VertexRouter)
     {
-      GlobalRoutingLSA *rlsa = v->GetLSA ();
+      GlobalRoutingLSA *rlsa = m_lsdb->GetLSA (v.id);
+      NS_ASSERT (rlsa);
       NS_LOG_LOGIC ("Processing router LSA with id " << rlsa->GetLinkStateId ());
       for (uint32_t i = 0; i < rlsa->GetNLinkRecords (); i++)
         {
           NS_LOG_LOGIC ("Examining link " << i << " of " << 
-                        v->GetVertexId () << "'s " <<
-                        v->GetLSA ()->GetNLinkRecords () << " link records");
-          GlobalRoutingLinkRecord *l = v->GetLSA ()->GetLinkRecord (i);
+                        v.id << "'s " <<
+                        rlsa->GetNLinkRecords () << " link records");
+          GlobalRoutingLinkRecord *l = rlsa->GetLinkRecord (i);
           if (l->GetLinkType () == GlobalRoutingLinkRecord::StubNetwork)
             {
               NS_LOG_LOGIC ("Found a Stub record to " << l->GetLinkId ());
@@ -1687,23 +2171,15 @@ GlobalRouteManagerImpl::SPFProcessStubs (SPFVertex* v)
             }
         }
     }
-  for (uint32_t i = 0; i < v->GetNChildren (); i++)
-    {
-      if (!v->GetChild (i)->IsVertexProcessed ())
-        {
-          SPFProcessStubs (v->GetChild (i));
-          v->GetChild (i)->SetVertexProcessed (true);
-        }
-    }
 }
 
 // RFC2328 16.1. second stage. 
 void
-GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, const SPFTreeVertex &v)
 {
-  NS_LOG_FUNCTION (this << l << v);
+  NS_LOG_FUNCTION (this << l << v.id);
 
-  NS_ASSERT_MSG (m_spfroot, 
+  NS_ASSERT_MSG (m_root, 
                  "GlobalRouteManagerImpl::SPFIntraAddStub (): Root pointer not set");
 
   // XXX simplifed logic for the moment.  There are two cases to consider:
@@ -1711,130 +2187,57 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
   //    (already handled above)
   // 2) the stub network is on a remote router, so I should use the
   // same next hop that I use to get to vertex v
-  if (v->GetVertexId () == m_spfroot->GetVertexId ())
+  if (v.id == m_root->routerId)
     {
-      NS_LOG_LOGIC ("Stub is on local host: " << v->GetVertexId () << "; returning");
+      NS_LOG_LOGIC ("Stub is on local host: " << v.id << "; returning");
       return;
     }
-  NS_LOG_LOGIC ("Stub is on remote host: " << v->GetVertexId () << "; installing");
-//
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
+  NS_LOG_LOGIC ("Stub is on remote host: " << v.id << "; installing");
 
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
+  Ipv4Mask tempmask (l->GetLinkData ().Get ());
+  Ipv4Address tempip = l->GetLinkId ();
+  tempip = tempip.CombineMask (tempmask);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// The vertex <v> (corresponding to the node that has the stub network) has
+// the next hops precalculated for us, to which the root node should send
+// packets to be forwarded to the stub network, along with the outbound
+// interfaces to which the packets should be sent.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+  // walk through all next-hop-IPs and out-going-interfaces for reaching
+  // the stub network gateway 'v' from the root node
+  for (uint32_t i = 0; i < v.exits.size (); i++)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to QI for that interface.  If there's no GlobalRouter interface, the node
-// in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
+      SPFVertex::NodeExit_t exit = v.exits[i];
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
+      if (outIf >= 0)
         {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
+          SPFRoute route;
+          route.type = SPFRoute::NETWORK;
+          route.dest = tempip;
+          route.mask = tempmask;
+          route.nextHop = nextHop;
+          route.outIf = outIf;
+          m_root->routes.push_back (route);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_root->routerId <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
+      else
         {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to QI
-// for that interface.  If the node is acting as an IP version 4 router, it
-// should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "QI for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          NS_ASSERT_MSG (v->GetLSA (), 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask (l->GetLinkData ().Get ());
-          Ipv4Address tempip = l->GetLinkId ();
-          tempip = tempip.CombineMask (tempmask);
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all next-hop-IPs and out-going-interfaces for reaching
-          // the stub network gateway 'v' from the root node
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative");
-                }
-            }
-          return;
-        } // if
-    } // for
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_root->routerId <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
 // Return the interface number corresponding to a given IP address and mask
-// This is a wrapper around GetInterfaceForPrefix(), but we first
-// have to find the right node pointer to pass to that function.
+// This is equivalent to GetInterfaceForPrefix() on the node of the root of
+// the SPF tree, whose addresses were gathered before the calculation.
 // If no such interface is found, return -1 (note:  unit test framework
 // for routing assumes -1 to be a legal return value)
 //
@@ -1842,70 +2245,22 @@ int32_t
 GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 {
   NS_LOG_FUNCTION (this << a << amask);
+  NS_ASSERT_MSG (m_root, 
+                 "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): Root pointer not set");
 //
-// We have an IP address <a> and a vertex ID of the root of the SPF tree.
-// The question is what interface index does this address correspond to.
-// The answer is a little complicated since we have to find a pointer to
-// the node corresponding to the vertex ID, find the Ipv4 interface on that
-// node in order to iterate the interfaces and find the one corresponding to
-// the address in question.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-//
-// Walk the list of nodes in the system looking for the one corresponding to
-// the node at the root of the SPF tree.  This is the node for which we are
-// building the routing table.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-//
-// If the node doesn't have a GlobalRouter interface it can't be the one
-// we're interested in.
-//
-      if (rtr == 0)
-        {
-          continue;
-        }
-
-      if (rtr->GetRouterId () == routerId)
-        {
-//
-// This is the node we're building the routing table for.  We're going to need
-// the Ipv4 interface to look for the ipv4 interface index.  Since this node
-// is participating in routing IP version 4 packets, it certainly must have 
-// an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                         "GetObject for <Ipv4> interface failed");
-//
-// Look through the interfaces on this node for one that has the IP address
+// Look through the interfaces of the root for one that has the IP address
 // we're looking for.  If we find one, return the corresponding interface
 // index, or -1 if not found.
 //
-          int32_t interface = ipv4->GetInterfaceForPrefix (a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif 
-          return interface;
+  Ipv4Address prefix = a.CombineMask (amask);
+  for (uint32_t i = 0; i < m_root->addresses.size (); i++)
+    {
+      if (m_root->addresses[i].first.CombineMask (amask) == prefix)
+        {
+          return m_root->addresses[i].second;
         }
     }
-//
-// Couldn't find it.
-//
-  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find root node " << routerId);
+  NS_LOG_LOGIC ("FindOutgoingInterfaceId():Can't find interface of root node " << m_root->routerId);
   return -1;
 }
 
@@ -1915,88 +2270,33 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 // This is where we are actually going to add the host routes to the routing
 // tables of the individual nodes.
 //
-// The vertex passed as a parameter has just been added to the SPF tree.
-// This vertex must have a valid m_root_oid, corresponding to the outgoing
-// interface on the root router of the tree that is the first hop on the path
-// to the vertex.  The vertex must also have a next hop address, corresponding
-// to the next hop on the path to the vertex.  The vertex has an m_lsa field
-// that has some number of link records.  For each point to point link record,
-// the m_linkData is the local IP address of the link.  This corresponds to
-// a destination IP address, reachable from the root, to which we add a host
-// route.
+// The vertex passed as a parameter has been added to the SPF tree.  It has
+// valid root exits, corresponding to the outgoing interfaces on the root
+// router of the tree that are the first hop on the paths to the vertex, and
+// to the next hops on these paths.  The LSA of the vertex has some number of
+// link records.  For each point to point link record, the m_linkData is the
+// local IP address of the link.  This corresponds to a destination IP
+// address, reachable from the root, to which we add a host route.
 //
 void
-GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddRouter (const SPFTreeVertex &v)
 {
-  NS_LOG_FUNCTION (this << v);
+  NS_LOG_FUNCTION (this << v.id);
 
-  NS_ASSERT_MSG (m_spfroot, 
+  NS_ASSERT_MSG (m_root, 
                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
 //
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
-
-      if (rtr == 0)
-        {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
-        }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
-        {
-          NS_LOG_LOGIC ("Setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "GetObject for <Ipv4> interface failed");
-//
 // Get the Global Router Link State Advertisement from the vertex we're
 // adding the routes to.  The LSA will have a number of attached Global Router
 // Link Records corresponding to links off of that vertex / node.  We're going
 // to be interested in the records corresponding to point-to-point links.
 //
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                         "Expected valid LSA in SPFVertex* v");
+  GlobalRoutingLSA *lsa = m_lsdb->GetLSA (v.id);
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                 "Expected valid LSA in SPFVertex* v");
 
-          uint32_t nLinkRecords = lsa->GetNLinkRecords ();
+  uint32_t nLinkRecords = lsa->GetNLinkRecords ();
 //
 // Iterate through the link records on the vertex to which we're going to add
 // routes.  To make sure we're being clear, we're going to add routing table
@@ -2005,178 +2305,99 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 // the local side of the point-to-point links found on the node described by
 // the vertex <v>.
 //
-          NS_LOG_LOGIC (" Node " << node->GetId () <<
-                        " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
-          for (uint32_t j = 0; j < nLinkRecords; ++j)
-            {
+  NS_LOG_LOGIC (" Node " << m_root->routerId <<
+                " found " << nLinkRecords << " link records in LSA " << lsa << "with LinkStateId "<< lsa->GetLinkStateId ());
+  for (uint32_t j = 0; j < nLinkRecords; ++j)
+    {
 //
 // We are only concerned about point-to-point links
 //
-              GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
-              if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                  continue;
-                }
-//
-// Here's why we did all of that work.  We're going to add a host route to the
-// host address found in the m_linkData field of the point-to-point link
-// record.  In the case of a point-to-point link, this is the local IP address
-// of the node connected to the link.  Each of these point-to-point links
-// will correspond to a local interface that has an IP address to which
-// the node at the root of the SPF tree can send packets.  The vertex <v> 
-// (corresponding to the node that has these links and interfaces) has 
-// an m_nextHop address precalculated for us that is the address to which the
-// root node should send packets to be forwarded to these IP addresses.
-// Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-// which the packets should be send for forwarding.
-//
-              Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-              if (router == 0)
-                {
-                  continue;
-                }
-              Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-              NS_ASSERT (gr);
-              // walk through all available exit directions due to ECMP,
-              // and add host route for each of the exit direction toward
-              // the vertex 'v'
-              for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-                {
-                  SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-                  Ipv4Address nextHop = exit.first;
-                  int32_t outIf = exit.second;
-                  if (outIf >= 0)
-                    {
-                      gr->AddHostRouteTo (lr->GetLinkData (), nextHop,
-                                          outIf);
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " adding host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " and outgoing interface " << outIf);
-                    }
-                  else
-                    {
-                      NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                    " NOT able to add host route to " << lr->GetLinkData () <<
-                                    " using next hop " << nextHop <<
-                                    " since outgoing interface id is negative " << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
-            }
-//
-// Done adding the routes for the selected node.
-//
-          return;
+      GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+      if (lr->GetLinkType () != GlobalRoutingLinkRecord::PointToPoint)
+        {
+          continue;
         }
+      // walk through all available exit directions due to ECMP,
+      // and add host route for each of the exit direction toward
+      // the vertex 'v'
+      for (uint32_t i = 0; i < v.exits.size (); i++)
+        {
+          SPFVertex::NodeExit_t exit = v.exits[i];
+          Ipv4Address nextHop = exit.first;
+          int32_t outIf = exit.second;
+          if (outIf >= 0)
+            {
+              SPFRoute route;
+              route.type = SPFRoute::HOST;
+              route.dest = lr->GetLinkData ();
+              route.nextHop = nextHop;
+              route.outIf = outIf;
+              m_root->routes.push_back (route);
+              NS_LOG_LOGIC ("(Route " << i << ") Node " << m_root->routerId <<
+                            " adding host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " and outgoing interface " << outIf);
+            }
+          else
+            {
+              NS_LOG_LOGIC ("(Route " << i << ") Node " << m_root->routerId <<
+                            " NOT able to add host route to " << lr->GetLinkData () <<
+                            " using next hop " << nextHop <<
+                            " since outgoing interface id is negative " << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
+
 void
-GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
+GlobalRouteManagerImpl::SPFIntraAddTransit (const SPFTreeVertex &v)
 {
-  NS_LOG_FUNCTION (this << v);
+  NS_LOG_FUNCTION (this << v.id);
 
-  NS_ASSERT_MSG (m_spfroot, 
+  NS_ASSERT_MSG (m_root, 
                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
 //
-// The root of the Shortest Path First tree is the router to which we are 
-// going to write the actual routing table entries.  The vertex corresponding
-// to this router has a vertex ID which is the router ID of that node.  We're
-// going to use this ID to discover which node it is that we're actually going
-// to update.
-//
-  Ipv4Address routerId = m_spfroot->GetVertexId ();
-
-  NS_LOG_LOGIC ("Vertex ID = " << routerId);
-//
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
-//
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (; i != listEnd; i++)
+// Get the Network Link State Advertisement from the vertex we're adding the
+// routes to; the route is to the network it describes.
+//
+  GlobalRoutingLSA *lsa = m_lsdb->GetLSA (v.id);
+  NS_ASSERT_MSG (lsa, 
+                 "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                 "Expected valid LSA in SPFVertex* v");
+  Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
+  Ipv4Address tempip = lsa->GetLinkStateId ();
+  tempip = tempip.CombineMask (tempmask);
+  // walk through all available exit directions due to ECMP,
+  // and add host route for each of the exit direction toward
+  // the vertex 'v'
+  for (uint32_t i = 0; i < v.exits.size (); i++)
     {
-      Ptr<Node> node = *i;
-//
-// The router ID is accessible through the GlobalRouter interface, so we need
-// to GetObject for that interface.  If there's no GlobalRouter interface, 
-// the node in question cannot be the router we want, so we continue.
-// 
-      Ptr<GlobalRouter> rtr = 
-        node->GetObject<GlobalRouter> ();
+      SPFVertex::NodeExit_t exit = v.exits[i];
+      Ipv4Address nextHop = exit.first;
+      int32_t outIf = exit.second;
 
-      if (rtr == 0)
+      if (outIf >= 0)
         {
-          NS_LOG_LOGIC ("No GlobalRouter interface on node " << 
-                        node->GetId ());
-          continue;
+          SPFRoute route;
+          route.type = SPFRoute::NETWORK;
+          route.dest = tempip;
+          route.mask = tempmask;
+          route.nextHop = nextHop;
+          route.outIf = outIf;
+          m_root->routes.push_back (route);
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_root->routerId <<
+                        " add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " via interface " << outIf);
         }
-//
-// If the router ID of the current node is equal to the router ID of the 
-// root of the SPF tree, then this node is the one for which we need to 
-// write the routing tables.
-//
-      NS_LOG_LOGIC ("Considering router " << rtr->GetRouterId ());
-
-      if (rtr->GetRouterId () == routerId)
+      else
         {
-          NS_LOG_LOGIC ("setting routes for node " << node->GetId ());
-//
-// Routing information is updated using the Ipv4 interface.  We need to 
-// GetObject for that interface.  If the node is acting as an IP version 4 
-// router, it should absolutely have an Ipv4 interface.
-//
-          Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-          NS_ASSERT_MSG (ipv4, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "GetObject for <Ipv4> interface failed");
-//
-// Get the Global Router Link State Advertisement from the vertex we're
-// adding the routes to.  The LSA will have a number of attached Global Router
-// Link Records corresponding to links off of that vertex / node.  We're going
-// to be interested in the records corresponding to point-to-point links.
-//
-          GlobalRoutingLSA *lsa = v->GetLSA ();
-          NS_ASSERT_MSG (lsa, 
-                         "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                         "Expected valid LSA in SPFVertex* v");
-          Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask ();
-          Ipv4Address tempip = lsa->GetLinkStateId ();
-          tempip = tempip.CombineMask (tempmask);
-          Ptr<GlobalRouter> router = node->GetObject<GlobalRouter> ();
-          if (router == 0)
-            {
-              continue;
-            }
-          Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol ();
-          NS_ASSERT (gr);
-          // walk through all available exit directions due to ECMP,
-          // and add host route for each of the exit direction toward
-          // the vertex 'v'
-          for (uint32_t i = 0; i < v->GetNRootExitDirections (); i++)
-            {
-              SPFVertex::NodeExit_t exit = v->GetRootExitDirection (i);
-              Ipv4Address nextHop = exit.first;
-              int32_t outIf = exit.second;
-
-              if (outIf >= 0)
-                {
-                  gr->AddNetworkRouteTo (tempip, tempmask, nextHop, outIf);
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " via interface " << outIf);
-                }
-              else
-                {
-                  NS_LOG_LOGIC ("(Route " << i << ") Node " << node->GetId () <<
-                                " NOT able to add network route to " << tempip <<
-                                " using next hop " << nextHop <<
-                                " since outgoing interface id is negative " << outIf);
-                }
-            }
+          NS_LOG_LOGIC ("(Route " << i << ") Node " << m_root->routerId <<
+                        " NOT able to add network route to " << tempip <<
+                        " using next hop " << nextHop <<
+                        " since outgoing interface id is negative " << outIf);
         }
-    } 
+    }
 }
 
 // Derived from quagga ospf_vertex_add_parents ()
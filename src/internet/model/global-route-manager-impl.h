@@ -26,6 +26,8 @@
 #include <list>
 #include <queue>
 #include <map>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 #include "ns3/object.h"
 #include "ns3/ptr.h"
@@ -534,7 +536,7 @@ private:
   Ipv4Address m_nextHop; //!< next hop
   typedef std::list< NodeExit_t > ListOfNodeExit_t; //!< container of Exit nodes
   ListOfNodeExit_t m_ecmpRootExits; //!< store the multiple root's exits for supporting ECMP
-  typedef std::list<SPFVertex*> ListOfSPFVertex_t; //!< container of SPFVertexes
+  typedef std::vector<SPFVertex*> ListOfSPFVertex_t; //!< container of SPFVertexes
   ListOfSPFVertex_t m_parents; //!< parent list
   ListOfSPFVertex_t m_children; //!< Children list
   bool m_vertexProcessed; //!< Flag to note whether vertex has been processed in stage two of SPF computation
@@ -674,13 +676,48 @@ public:
    */
   uint32_t GetNumExtLSAs () const;
 
+  /**
+   * @brief Make a deep copy of the database.
+   *
+   * The SPF calculation keeps its state in the Link State Advertisements,
+   * so each thread running SPF calculations works on its own copy.
+   *
+   * @returns a new database, with copies of all the Link State
+   * Advertisements, to be deleted by the caller.
+   */
+  GlobalRouteManagerLSDB* Copy (void) const;
+
+  /**
+   * @brief Compare the router and network Link State Advertisements of two
+   * databases, for the incremental SPF calculation.
+   *
+   * The link records toward stub networks and the External Link State
+   * Advertisements are not compared.  A point-to-point link record from a
+   * router u to a router w is considered changed if the list of the
+   * records of u toward w changed (link added, removed, or with a different
+   * metric or address).
+   *
+   * @param other the database to compare to
+   * @param [out] changes the (u, w) pairs of router IDs whose point-to-point
+   * link records changed
+   * @returns false if other changes were found (set of LSAs, network LSAs,
+   * transit link records, or the relative order of the unchanged records),
+   * in which case the changes are not all reported.
+   */
+  bool GetChangedLinks (const GlobalRouteManagerLSDB* other,
+                        std::vector<std::pair<Ipv4Address, Ipv4Address> > &changes) const;
+
 
 private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
   typedef std::pair<Ipv4Address, GlobalRoutingLSA*> LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
+  /// Router LSAs by link data of their transit network link records
+  typedef std::unordered_map<Ipv4Address, GlobalRoutingLSA*, Ipv4AddressHash> LinkDataIndex_t;
 
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
+  mutable LinkDataIndex_t m_linkDataIndex; //!< index used by GetLSAByLinkData, built on demand
+  mutable bool m_linkDataIndexValid; //!< whether m_linkDataIndex is up to date
 
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
@@ -732,6 +769,23 @@ public:
 /**
  * @brief Compute routes using a Dijkstra SPF computation and populate
  * per-node forwarding tables
+ *
+ * The SPF calculations of the different roots are independent; if the
+ * "GlobalRoutingSpfThreads" global value is greater than one, they are
+ * shared between that many threads, each working on its own copy of the
+ * Link State DataBase.  The routes are installed by the calling thread,
+ * in node order, once all the calculations are done.
+ *
+ * If the "GlobalRoutingIncrementalSpf" global value is true, the
+ * shortest-path tree of each root is kept, along with the previous
+ * database, when the routes are deleted (see DeleteGlobalRoutes).  When
+ * the routes are recomputed, the changes of point-to-point links (up,
+ * down, or metric) which cannot have modified the tree of a root (e.g.,
+ * the links of routers the root reaches through shorter paths) are
+ * detected, and the routes of such a root are rebuilt from its tree and
+ * the new database without running Dijkstra again.  Other changes (to
+ * transit networks, the set of routers, or close to the root) lead to a
+ * full calculation.  The routing tables are the same in all cases.
  */
   virtual void InitializeRoutes ();
 
@@ -767,8 +821,96 @@ private:
  */
   GlobalRouteManagerImpl& operator= (GlobalRouteManagerImpl& srmi);
 
+  /// A route found by the SPF calculation, to be installed on the root
+  struct SPFRoute
+  {
+    /// Route types
+    enum Type
+    {
+      HOST,     //!< host route
+      NETWORK,  //!< network route
+      EXTERNAL  //!< AS external route
+    };
+    Type type;           //!< the route type
+    Ipv4Address dest;    //!< the destination
+    Ipv4Mask mask;       //!< the destination mask (network and external routes)
+    Ipv4Address nextHop; //!< the next hop
+    uint32_t outIf;      //!< the outgoing interface
+  };
+
+  /// A vertex of a shortest-path tree, as remembered after the calculation
+  struct SPFTreeVertex
+  {
+    Ipv4Address id;                            //!< the vertex ID
+    SPFVertex::VertexType type;                //!< the vertex type
+    std::vector<SPFVertex::NodeExit_t> exits;  //!< the root exits toward the vertex
+  };
+
+  /**
+   * \brief The SPF calculation from a root router
+   *
+   * Everything the calculation needs from the node of the root is gathered
+   * beforehand, so that the calculation does not access the node (and can
+   * run in another thread).
+   */
+  struct SPFRoot
+  {
+    Ipv4Address routerId;            //!< router ID of the root
+    Ptr<Ipv4GlobalRouting> routing;  //!< where to install the routes (may be null)
+    /// local addresses of the root, with their interface index
+    std::vector<std::pair<Ipv4Address, int32_t> > addresses;
+    bool checkStub;                  //!< whether the stub node shortcut may be taken
+    bool replay;                     //!< whether the tree is to be reused, instead of calculated
+    bool stub;                       //!< whether the stub node shortcut was taken
+    std::vector<SPFTreeVertex> tree; //!< tree vertices, in the order they were added to the tree
+    std::vector<uint32_t> order;     //!< tree vertex indices, in depth-first order
+    std::vector<SPFRoute> routes;    //!< the routes found
+  };
+
   SPFVertex* m_spfroot; //!< the root node
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+  GlobalRouteManagerLSDB* m_previousLsdb; //!< the LSDB of the previous routes (incremental SPF)
+  SPFRoot* m_root; //!< the SPF calculation in progress
+  std::vector<SPFRoot> m_roots; //!< the SPF calculations of the previous routes (incremental SPF)
+  std::vector<SPFRoot*> m_jobs; //!< the SPF calculations to run (RunSPFJobs)
+
+  /**
+   * \brief Gather what the SPF calculation needs from the node of a root
+   *
+   * \param node the node
+   * \param rtr the global router of the node
+   * \param [out] root the SPF calculation
+   */
+  static void PrepareRoot (Ptr<Node> node, Ptr<GlobalRouter> rtr, SPFRoot &root);
+
+  /**
+   * \brief Reuse the shortest-path trees of the previous calculation
+   *
+   * Set the replay flag, and the tree, of the roots whose tree cannot have
+   * changed since the previous calculation.
+   *
+   * \param roots the SPF calculations to run
+   */
+  void PlanIncrementalSPF (std::vector<SPFRoot> &roots);
+
+  /**
+   * \brief Run SPF calculations, possibly in several threads
+   *
+   * \param roots the SPF calculations to run
+   */
+  void RunSPF (std::vector<SPFRoot> &roots);
+
+  /**
+   * \brief Run the SPF calculations of m_jobs, in this object
+   */
+  void RunSPFJobs (void);
+
+  /**
+   * \brief Install the routes found by an SPF calculation
+   *
+   * \param root the SPF calculation
+   */
+  static void InstallRoutes (SPFRoot &root);
 
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
@@ -783,12 +925,29 @@ private:
   bool CheckForStubNode (Ipv4Address root);
 
   /**
-   * \brief Calculate the shortest path first (SPF) tree
+   * \brief Calculate the shortest path first (SPF) tree, and the routes
    *
    * Equivalent to quagga ospf_spf_calculate
-   * \param root the root node
+   * \param root the SPF calculation, whose tree and routes are set
+   */
+  void SPFCalculate (SPFRoot &root);
+
+  /**
+   * \brief Set the depth-first order of the vertices of the SPF tree
+   *
+   * The second stage of the calculation visits the vertices in this order.
+   *
+   * \param v vertex to be visited
+   * \param index tree index of each vertex
+   */
+  void SPFDepthFirstOrder (SPFVertex* v, const std::unordered_map<const SPFVertex*, uint32_t> &index);
+
+  /**
+   * \brief Find the routes of the root, given its SPF tree
+   *
+   * \param root the SPF calculation
    */
-  void SPFCalculate (Ipv4Address root);
+  void SPFAddRoutes (SPFRoot &root);
 
   /**
    * \brief Process Stub nodes
@@ -799,7 +958,7 @@ private:
    *
    * \param v vertex to be processed
    */
-  void SPFProcessStubs (SPFVertex* v);
+  void SPFProcessStubs (const SPFTreeVertex &v);
 
   /**
    * \brief Process Autonomous Systems (AS) External LSA
@@ -807,7 +966,7 @@ private:
    * \param v vertex to be processed
    * \param extlsa external LSA
    */
-  void ProcessASExternals (SPFVertex* v, GlobalRoutingLSA* extlsa);
+  void ProcessASExternals (const SPFTreeVertex &v, GlobalRoutingLSA* extlsa);
 
   /**
    * \brief Examine the links in v's LSA and update the list of candidates with any
@@ -908,14 +1067,14 @@ private:
    * \param v the vertex
    *
    */
-  void SPFIntraAddRouter (SPFVertex* v);
+  void SPFIntraAddRouter (const SPFTreeVertex &v);
 
   /**
    * \brief Add a transit to the routing tables
    *
    * \param v the vertex
    */
-  void SPFIntraAddTransit (SPFVertex* v);
+  void SPFIntraAddTransit (const SPFTreeVertex &v);
 
   /**
    * \brief Add a stub to the routing tables
@@ -923,7 +1082,7 @@ private:
    * \param l the global routing link record
    * \param v the vertex
    */
-  void SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex* v);
+  void SPFIntraAddStub (GlobalRoutingLinkRecord *l, const SPFTreeVertex &v);
 
   /**
    * \brief Add an external route to the routing tables
@@ -931,13 +1090,13 @@ private:
    * \param extlsa the external LSA
    * \param v the vertex
    */
-  void SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v);
+  void SPFAddASExternal (GlobalRoutingLSA *extlsa, const SPFTreeVertex &v);
 
   /**
    * \brief Return the interface number corresponding to a given IP address and mask
    *
-   * This is a wrapper around GetInterfaceForPrefix(), but we first
-   * have to find the right node pointer to pass to that function.
+   * This is equivalent to GetInterfaceForPrefix() on the node of the root,
+   * using the addresses gathered before the calculation.
    * If no such interface is found, return -1 (note:  unit test framework
    * for routing assumes -1 to be a legal return value)
    *
@@ -0,0 +1,269 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <sstream>
+#include "ns3/log.h"
+#include "ns3/names.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4-route.h"
+#include "ipv4-contact-plan-routing.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv4ContactPlanRouting");
+
+NS_OBJECT_ENSURE_REGISTERED (Ipv4ContactPlanRouting);
+
+TypeId
+Ipv4ContactPlanRouting::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Ipv4ContactPlanRouting")
+    .SetParent<Ipv4RoutingProtocol> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<Ipv4ContactPlanRouting> ()
+    .AddAttribute ("ContactPlan", "The contact plan to follow.",
+                   PointerValue (),
+                   MakePointerAccessor (&Ipv4ContactPlanRouting::m_plan),
+                   MakePointerChecker<ContactPlan> ())
+  ;
+  return tid;
+}
+
+Ipv4ContactPlanRouting::Ipv4ContactPlanRouting ()
+  : m_nodeId (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv4ContactPlanRouting::~Ipv4ContactPlanRouting ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+Ipv4ContactPlanRouting::SetContactPlan (Ptr<ContactPlan> plan)
+{
+  NS_LOG_FUNCTION (this << plan);
+  m_plan = plan;
+}
+
+Ptr<ContactPlan>
+Ipv4ContactPlanRouting::GetContactPlan (void) const
+{
+  return m_plan;
+}
+
+void
+Ipv4ContactPlanRouting::DoInitialize (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the first node to start computes the routes of all the nodes
+  if (m_plan != 0)
+    {
+      m_plan->Start ();
+    }
+  Ipv4RoutingProtocol::DoInitialize ();
+}
+
+void
+Ipv4ContactPlanRouting::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ipv4 = 0;
+  m_plan = 0;
+  Ipv4RoutingProtocol::DoDispose ();
+}
+
+Ptr<Ipv4Route>
+Ipv4ContactPlanRouting::Lookup (Ipv4Address dest, Ptr<NetDevice> oif)
+{
+  NS_LOG_FUNCTION (this << dest << oif);
+  uint32_t interface;
+  Ipv4Address gateway;
+  if (m_plan == 0
+      || !m_plan->Lookup (m_nodeId, dest, interface, gateway))
+    {
+      return 0;
+    }
+  if (oif != 0 && oif != m_ipv4->GetNetDevice (interface))
+    {
+      NS_LOG_LOGIC ("Not on requested interface");
+      return 0;
+    }
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (dest);
+  rtentry->SetSource (m_ipv4->GetAddress (interface, 0).GetLocal ());
+  rtentry->SetGateway (gateway);
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interface));
+  return rtentry;
+}
+
+Ptr<Ipv4Route>
+Ipv4ContactPlanRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << p << &header << oif << &sockerr);
+  if (header.GetDestination ().IsMulticast ())
+    {
+      NS_LOG_LOGIC ("Multicast destination-- returning false");
+      return 0; // Let other routing protocols try to handle this
+    }
+  Ptr<Ipv4Route> rtentry = Lookup (header.GetDestination (), oif);
+  if (rtentry)
+    {
+      sockerr = Socket::ERROR_NOTERROR;
+    }
+  else
+    {
+      sockerr = Socket::ERROR_NOROUTETOHOST;
+    }
+  return rtentry;
+}
+
+bool
+Ipv4ContactPlanRouting::RouteInput (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                                    UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                                    LocalDeliverCallback lcb, ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header << idev << &lcb << &ecb);
+  NS_ASSERT (m_ipv4->GetInterfaceForDevice (idev) >= 0);
+  uint32_t iif = m_ipv4->GetInterfaceForDevice (idev);
+
+  if (m_ipv4->IsDestinationAddress (header.GetDestination (), iif))
+    {
+      if (!lcb.IsNull ())
+        {
+          NS_LOG_LOGIC ("Local delivery to " << header.GetDestination ());
+          lcb (p, header, iif);
+          return true;
+        }
+      // possibly a multicast or broadcast packet, for another protocol
+      return false;
+    }
+
+  if (m_ipv4->IsForwarding (iif) == false)
+    {
+      NS_LOG_LOGIC ("Forwarding disabled for this interface");
+      ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+      return true;
+    }
+  Ptr<Ipv4Route> rtentry = Lookup (header.GetDestination ());
+  if (rtentry != 0)
+    {
+      NS_LOG_LOGIC ("Found unicast destination- calling unicast callback");
+      ucb (rtentry, p, header);
+      return true;
+    }
+  NS_LOG_LOGIC ("Did not find unicast destination- returning false");
+  return false; // Let other routing protocols try to handle this
+}
+
+void
+Ipv4ContactPlanRouting::NotifyInterfaceUp (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  // the node is known by now, even if the protocol was set before the
+  // IPv4 stack was aggregated to it
+  m_nodeId = m_ipv4->GetObject<Node> ()->GetId ();
+}
+
+void
+Ipv4ContactPlanRouting::NotifyInterfaceDown (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+}
+
+void
+Ipv4ContactPlanRouting::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  NS_LOG_FUNCTION (this << interface << address);
+}
+
+void
+Ipv4ContactPlanRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
+{
+  NS_LOG_FUNCTION (this << interface << address);
+}
+
+void
+Ipv4ContactPlanRouting::SetIpv4 (Ptr<Ipv4> ipv4)
+{
+  NS_LOG_FUNCTION (this << ipv4);
+  NS_ASSERT (m_ipv4 == 0 && ipv4 != 0);
+  m_ipv4 = ipv4;
+  Ptr<Node> node = m_ipv4->GetObject<Node> ();
+  if (node != 0)
+    {
+      m_nodeId = node->GetId ();
+    }
+}
+
+void
+Ipv4ContactPlanRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
+{
+  NS_LOG_FUNCTION (this << stream);
+  std::ostream* os = stream->GetStream ();
+  // Copy the current ostream state
+  std::ios oldState (nullptr);
+  oldState.copyfmt (*os);
+
+  *os << std::resetiosflags (std::ios::adjustfield) << std::setiosflags (std::ios::left);
+
+  uint32_t nodeId = m_nodeId;
+  *os << "Node: " << nodeId
+      << ", Time: " << Now ().As (unit)
+      << ", Local time: " << m_ipv4->GetObject<Node> ()->GetLocalTime ().As (unit)
+      << ", Ipv4ContactPlanRouting table";
+  if (m_plan == 0 || m_plan->GetNEpochs () == 0)
+    {
+      *os << " (not computed)" << std::endl << std::endl;
+      (*os).copyfmt (oldState);
+      return;
+    }
+  uint32_t epoch = m_plan->GetCurrentEpoch ();
+  *os << ", epoch " << epoch << " since " << m_plan->GetEpochStart (epoch).As (unit) << std::endl;
+  *os << "Node    Gateway         Iface" << std::endl;
+  for (uint32_t d = 0; d < NodeList::GetNNodes (); d++)
+    {
+      uint32_t interface;
+      Ipv4Address gateway;
+      if (d == nodeId || !m_plan->LookupNode (epoch, nodeId, d, interface, gateway))
+        {
+          continue;
+        }
+      std::ostringstream gw;
+      gw << gateway;
+      *os << std::setw (8) << d << std::setw (16) << gw.str ();
+      if (Names::FindName (m_ipv4->GetNetDevice (interface)) != "")
+        {
+          *os << Names::FindName (m_ipv4->GetNetDevice (interface));
+        }
+      else
+        {
+          *os << interface;
+        }
+      *os << std::endl;
+    }
+  *os << std::endl;
+  // Restore the previous ostream state
+  (*os).copyfmt (oldState);
+}
+
+} // namespace ns3
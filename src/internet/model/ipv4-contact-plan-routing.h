@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_CONTACT_PLAN_ROUTING_H
+#define IPV4_CONTACT_PLAN_ROUTING_H
+
+#include "ns3/ptr.h"
+#include "ns3/ipv4.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "contact-plan.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Routing along a contact plan, for time-varying topologies
+ *
+ * This protocol forwards the unicast packets along the routes that a
+ * ContactPlan computed beforehand for each topology epoch: the routes
+ * follow the epochs without any control traffic nor computation during
+ * the simulation, and a lookup costs the same whatever the size of the
+ * plan.  All the nodes of a plan share the same ContactPlan object.
+ *
+ * Packets for the node itself, and for addresses which do not belong to
+ * a node of the plan, are left to the other routing protocols, so this
+ * protocol is meant to be used in an Ipv4ListRouting along with an
+ * Ipv4StaticRouting for the directly connected networks.
+ *
+ * \see ContactPlan
+ */
+class Ipv4ContactPlanRouting : public Ipv4RoutingProtocol
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  Ipv4ContactPlanRouting ();
+  virtual ~Ipv4ContactPlanRouting ();
+
+  /**
+   * \param plan the contact plan to follow
+   */
+  void SetContactPlan (Ptr<ContactPlan> plan);
+  /**
+   * \return the contact plan followed
+   */
+  Ptr<ContactPlan> GetContactPlan (void) const;
+
+  // These methods inherited from base class
+  virtual Ptr<Ipv4Route> RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput  (Ptr<const Packet> p, const Ipv4Header &header, Ptr<const NetDevice> idev,
+                            UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                            LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address);
+  virtual void SetIpv4 (Ptr<Ipv4> ipv4);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream, Time::Unit unit = Time::S) const;
+
+protected:
+  virtual void DoInitialize (void);
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Find the route to a destination in the current epoch
+   * \param dest the destination
+   * \param oif the output device, if constrained
+   * \return the route, or 0 if none
+   */
+  Ptr<Ipv4Route> Lookup (Ipv4Address dest, Ptr<NetDevice> oif = 0);
+
+  Ptr<Ipv4> m_ipv4;         //!< the IPv4 stack
+  Ptr<ContactPlan> m_plan;  //!< the contact plan
+  uint32_t m_nodeId;        //!< the id of the node, cached for the lookups
+};
+
+} // namespace ns3
+
+#endif /* IPV4_CONTACT_PLAN_ROUTING_H */
@@ -22,6 +22,7 @@
 #include "ipv4-end-point.h"
 #include "ipv4-interface-address.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 
 namespace ns3 {
@@ -37,6 +38,7 @@ Ipv4EndPointDemux::Ipv4EndPointDemux ()
 Ipv4EndPointDemux::~Ipv4EndPointDemux ()
 {
   NS_LOG_FUNCTION (this);
+  m_index.Clear ();
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       Ipv4EndPoint *endPoint = *i;
@@ -45,24 +47,35 @@ Ipv4EndPointDemux::~Ipv4EndPointDemux ()
   m_endPoints.clear ();
 }
 
+void
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_endPoints.push_back (endPoint);
+  m_index.Add (endPoint, --m_endPoints.end ());
+  endPoint->m_demux = this;
+  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+}
+
+void
+Ipv4EndPointDemux::Update (Ipv4EndPoint *endPoint)
+{
+  NS_LOG_FUNCTION (this << endPoint);
+  m_index.Update (endPoint);
+}
+
 bool
 Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
 {
   NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
-    {
-      if ((*i)->GetLocalPort  () == port) 
-        {
-          return true;
-        }
-    }
-  return false;
+  return m_index.HasPort (port);
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ptr<NetDevice> boundNetDevice, Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
+  // only called when binding: the endpoints are not indexed by local address
   for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
       if ((*i)->GetLocalPort () == port &&
@@ -86,8 +99,7 @@ Ipv4EndPointDemux::Allocate (void)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -102,8 +114,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -125,8 +136,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice, Ipv4Address address,
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
   return endPoint;
 }
 
@@ -136,13 +146,17 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort << boundNetDevice);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  const Index::Bucket *bucket = Index::IsConnected (peerAddress, peerPort)
+    ? m_index.FindConnected (localAddress, localPort, peerAddress, peerPort)
+    : m_index.FindUnconnected (localPort);
+  for (uint32_t i = 0; bucket != 0 && i < bucket->size (); i++)
     {
-      if ((*i)->GetLocalPort () == localPort &&
-          (*i)->GetLocalAddress () == localAddress &&
-          (*i)->GetPeerPort () == peerPort &&
-          (*i)->GetPeerAddress () == peerAddress &&
-          ((*i)->GetBoundNetDevice () == boundNetDevice || (*i)->GetBoundNetDevice () == 0))
+      Ipv4EndPoint *endP = (*bucket)[i];
+      if (endP->GetLocalPort () == localPort &&
+          endP->GetLocalAddress () == localAddress &&
+          endP->GetPeerPort () == peerPort &&
+          endP->GetPeerAddress () == peerAddress &&
+          (endP->GetBoundNetDevice () == boundNetDevice || endP->GetBoundNetDevice () == 0))
         {
           NS_LOG_WARN ("Duplicated endpoint.");
           return 0;
@@ -150,9 +164,7 @@ Ipv4EndPointDemux::Allocate (Ptr<NetDevice> boundNetDevice,
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
-
-  NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
+  Insert (endPoint);
 
   return endPoint;
 }
@@ -161,14 +173,11 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  EndPointsI i;
+  if (m_index.Remove (endPoint, i))
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      delete endPoint;
+      m_endPoints.erase (i);
     }
 }
 
@@ -208,7 +217,47 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval4; // Exact match on all 4
 
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr << ":" << dport);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+
+  // The candidates are the endpoints of the port which are not connected,
+  // and the connected endpoints whose peer is the source and whose local
+  // address can match the destination: the destination itself, Any, or the
+  // network of an address of the incoming interface.  The order of the
+  // candidates does not matter, since at most one endpoint may match.
+  std::vector<Ipv4EndPoint *> candidates;
+  const Index::Bucket *bucket = m_index.FindUnconnected (dport);
+  if (bucket != 0)
+    {
+      candidates.insert (candidates.end (), bucket->begin (), bucket->end ());
+    }
+  if (Index::IsConnected (saddr, sport))
+    {
+      std::vector<Ipv4Address> locals;
+      locals.push_back (daddr);
+      locals.push_back (Ipv4Address::GetAny ());
+      for (uint32_t i = 0; incomingInterface != 0 && i < incomingInterface->GetNAddresses (); i++)
+        {
+          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+          Ipv4Address addrNetpart = addr.GetLocal ().CombineMask (addr.GetMask ());
+          if (addrNetpart == daddr.CombineMask (addr.GetMask ()))
+            {
+              locals.push_back (addrNetpart);
+            }
+        }
+      for (uint32_t i = 0; i < locals.size (); i++)
+        {
+          if (std::find (locals.begin (), locals.begin () + i, locals[i]) != locals.begin () + i)
+            {
+              continue;
+            }
+          bucket = m_index.FindConnected (locals[i], dport, saddr, sport);
+          if (bucket != 0)
+            {
+              candidates.insert (candidates.end (), bucket->begin (), bucket->end ());
+            }
+        }
+    }
+
+  for (std::vector<Ipv4EndPoint *>::iterator i = candidates.begin (); i != candidates.end (); i++)
     {
       Ipv4EndPoint* endP = *i;
 
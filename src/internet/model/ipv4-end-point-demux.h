@@ -25,6 +25,7 @@
 #include <list>
 #include "ns3/ipv4-address.h"
 #include "ipv4-interface.h"
+#include "end-point-index.h"
 
 namespace ns3 {
 
@@ -40,6 +41,9 @@ class Ipv4EndPoint;
  * of endpoints, and has APIs to add and find endpoints in this demux.  This
  * code is shared in common to TCP and UDP protocols in ns3.  This demux
  * sits between ns3's layer four and the socket layer
+ *
+ * The endpoints are also hashed (see EndPointIndex), so that finding the
+ * endpoint of a connection does not depend on the number of endpoints.
  */
 
 class Ipv4EndPointDemux {
@@ -166,6 +170,24 @@ public:
   void DeAllocate (Ipv4EndPoint *endPoint);
 
 private:
+  friend class Ipv4EndPoint;
+
+  /**
+   * \brief The type of the hash index of the end points.
+   */
+  typedef EndPointIndex<Ipv4EndPoint, Ipv4Address, Ipv4AddressHash> Index;
+
+  /**
+   * \brief Add a new end point to the list and to the index.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv4EndPoint *endPoint);
+
+  /**
+   * \brief Re-index an end point whose addresses or ports changed.
+   * \param endPoint the end point
+   */
+  void Update (Ipv4EndPoint *endPoint);
 
   /**
    * \brief Allocate an ephemeral port.
@@ -192,6 +214,11 @@ private:
    * \brief A list of IPv4 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The hash index of the end points.
+   */
+  Index m_index;
 };
 
 } // namespace ns3
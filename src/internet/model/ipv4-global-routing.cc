@@ -16,6 +16,7 @@
 // Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
 //
 
+#include <algorithm>
 #include <vector>
 #include <iomanip>
 #include "ns3/names.h"
@@ -80,6 +81,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  IndexRoute (m_hostRoutesIndex, route);
 }
 
 void 
@@ -90,6 +92,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  IndexRoute (m_hostRoutesIndex, route);
 }
 
 void 
@@ -105,6 +108,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  IndexRoute (m_networkRoutesIndex, route);
 }
 
 void 
@@ -118,6 +122,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  IndexRoute (m_networkRoutesIndex, route);
 }
 
 void 
@@ -133,8 +138,22 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  IndexRoute (m_ASexternalRoutesIndex, route);
 }
 
+void
+Ipv4GlobalRouting::IndexRoute (RoutesIndex &index, Ipv4RoutingTableEntry *route)
+{
+  index.Insert (RoutesIndex::MakeKey (route->GetDestNetwork ()),
+                route->GetDestNetworkMask ().GetPrefixLength (), route);
+}
+
+void
+Ipv4GlobalRouting::UnindexRoute (RoutesIndex &index, Ipv4RoutingTableEntry *route)
+{
+  index.Remove (RoutesIndex::MakeKey (route->GetDestNetwork ()),
+                route->GetDestNetworkMask ().GetPrefixLength (), route);
+}
 
 Ptr<Ipv4Route>
 Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
@@ -146,73 +165,84 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
+  RoutesIndex::Key key = RoutesIndex::MakeKey (dest);
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
-       i++) 
+  const RoutesIndex::Bucket *bucket = m_hostRoutesIndex.Find (key, 32);
+  if (bucket != 0)
     {
-      NS_ASSERT ((*i)->IsHost ());
-      if ((*i)->GetDest () == dest)
+      for (RoutesIndex::Bucket::const_iterator i = bucket->begin (); i != bucket->end (); i++)
         {
+          NS_ASSERT (i->value->IsHost ());
           if (oif != 0)
             {
-              if (oif != m_ipv4->GetNetDevice ((*i)->GetInterface ()))
+              if (oif != m_ipv4->GetNetDevice (i->value->GetInterface ()))
                 {
                   NS_LOG_LOGIC ("Not on requested interface, skipping");
                   continue;
                 }
             }
-          allRoutes.push_back (*i);
-          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << *i); 
+          allRoutes.push_back (i->value);
+          NS_LOG_LOGIC (allRoutes.size () << "Found global host route" << i->value);
         }
     }
   if (allRoutes.size () == 0) // if no host route is found
     {
+      // all the matching network routes, whatever their prefix length,
+      // are equal-cost candidates; keep them in the order they were added
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
-           j++) 
+      std::vector<std::pair<uint64_t, Ipv4RoutingTableEntry*> > matches;
+      int length = 33;
+      while ((bucket = m_networkRoutesIndex.FindLongestMatch (key, length)) != 0)
         {
-          Ipv4Mask mask = (*j)->GetDestNetworkMask ();
-          Ipv4Address entry = (*j)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry)) 
+          for (RoutesIndex::Bucket::const_iterator j = bucket->begin (); j != bucket->end (); j++)
             {
               if (oif != 0)
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*j)->GetInterface ()))
+                  if (oif != m_ipv4->GetNetDevice (j->value->GetInterface ()))
                     {
                       NS_LOG_LOGIC ("Not on requested interface, skipping");
                       continue;
                     }
                 }
-              allRoutes.push_back (*j);
-              NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << *j);
+              matches.push_back (std::make_pair (j->sequence, j->value));
             }
         }
+      std::sort (matches.begin (), matches.end ());
+      for (uint32_t j = 0; j < matches.size (); j++)
+        {
+          allRoutes.push_back (matches[j].second);
+          NS_LOG_LOGIC (allRoutes.size () << "Found global network route" << matches[j].second);
+        }
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
-           k++)
+      // the first matching external route added wins
+      const RoutesIndex::Item *first = 0;
+      int length = 33;
+      while ((bucket = m_ASexternalRoutesIndex.FindLongestMatch (key, length)) != 0)
         {
-          Ipv4Mask mask = (*k)->GetDestNetworkMask ();
-          Ipv4Address entry = (*k)->GetDestNetwork ();
-          if (mask.IsMatch (dest, entry))
+          for (RoutesIndex::Bucket::const_iterator k = bucket->begin (); k != bucket->end (); k++)
             {
-              NS_LOG_LOGIC ("Found external route" << *k);
+              NS_LOG_LOGIC ("Found external route" << k->value);
               if (oif != 0)
                 {
-                  if (oif != m_ipv4->GetNetDevice ((*k)->GetInterface ()))
+                  if (oif != m_ipv4->GetNetDevice (k->value->GetInterface ()))
                     {
                       NS_LOG_LOGIC ("Not on requested interface, skipping");
                       continue;
                     }
                 }
-              allRoutes.push_back (*k);
+              if (first == 0 || k->sequence < first->sequence)
+                {
+                  first = &(*k);
+                }
               break;
             }
         }
+      if (first != 0)
+        {
+          allRoutes.push_back (first->value);
+        }
     }
   if (allRoutes.size () > 0 ) // if route(s) is found
     {
@@ -319,6 +349,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           if (tmp  == index)
             {
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
+              UnindexRoute (m_hostRoutesIndex, *i);
               delete *i;
               m_hostRoutes.erase (i);
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
@@ -336,6 +367,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
+          UnindexRoute (m_networkRoutesIndex, *j);
           delete *j;
           m_networkRoutes.erase (j);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -352,6 +384,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
       if (tmp == index)
         {
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
+          UnindexRoute (m_ASexternalRoutesIndex, *k);
           delete *k;
           m_ASexternalRoutes.erase (k);
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
@@ -392,6 +425,9 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostRoutesIndex.Clear ();
+  m_networkRoutesIndex.Clear ();
+  m_ASexternalRoutesIndex.Clear ();
 
   Ipv4RoutingProtocol::DoDispose ();
 }
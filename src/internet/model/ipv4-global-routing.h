@@ -28,6 +28,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/routing-prefix-index.h"
 
 namespace ns3 {
 
@@ -260,6 +261,22 @@ private:
   /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
   typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
 
+  /// longest-prefix-match index of Ipv4RoutingTableEntry
+  typedef RoutingPrefixIndex<Ipv4RoutingTableEntry *> RoutesIndex;
+
+  /**
+   * \brief Add a route to an index, by destination prefix.
+   * \param index the index
+   * \param route the route
+   */
+  static void IndexRoute (RoutesIndex &index, Ipv4RoutingTableEntry *route);
+  /**
+   * \brief Remove a route from an index.
+   * \param index the index
+   * \param route the route
+   */
+  static void UnindexRoute (RoutesIndex &index, Ipv4RoutingTableEntry *route);
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -272,6 +289,10 @@ private:
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  RoutesIndex m_hostRoutesIndex;       //!< Routes to hosts, by destination
+  RoutesIndex m_networkRoutesIndex;    //!< Routes to networks, by prefix
+  RoutesIndex m_ASexternalRoutesIndex; //!< External routes imported, by prefix
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -380,16 +380,9 @@ Ipv4Header::GetSerializedSize (void) const
 }
 
 void
-Ipv4Header::Serialize (Buffer::Iterator start) const
+Ipv4Header::WriteFixedPart (uint8_t *buffer) const
 {
-  NS_LOG_FUNCTION (this << &start);
-  Buffer::Iterator i = start;
-
-  uint8_t verIhl = (4 << 4) | (5);
-  i.WriteU8 (verIhl);
-  i.WriteU8 (m_tos);
-  i.WriteHtonU16 (m_payloadSize + 5*4);
-  i.WriteHtonU16 (m_identification);
+  uint16_t totalLength = m_payloadSize + 5*4;
   uint32_t fragmentOffset = m_fragmentOffset / 8;
   uint8_t flagsFrag = (fragmentOffset >> 8) & 0x1f;
   if (m_flags & DONT_FRAGMENT) 
@@ -400,14 +393,40 @@ Ipv4Header::Serialize (Buffer::Iterator start) const
     {
       flagsFrag |= (1<<5);
     }
-  i.WriteU8 (flagsFrag);
-  uint8_t frag = fragmentOffset & 0xff;
-  i.WriteU8 (frag);
-  i.WriteU8 (m_ttl);
-  i.WriteU8 (m_protocol);
-  i.WriteHtonU16 (0);
-  i.WriteHtonU32 (m_source.Get ());
-  i.WriteHtonU32 (m_destination.Get ());
+  uint32_t source = m_source.Get ();
+  uint32_t destination = m_destination.Get ();
+
+  buffer[0] = (4 << 4) | (5);
+  buffer[1] = m_tos;
+  buffer[2] = (totalLength >> 8) & 0xff;
+  buffer[3] = totalLength & 0xff;
+  buffer[4] = (m_identification >> 8) & 0xff;
+  buffer[5] = m_identification & 0xff;
+  buffer[6] = flagsFrag;
+  buffer[7] = fragmentOffset & 0xff;
+  buffer[8] = m_ttl;
+  buffer[9] = m_protocol;
+  buffer[10] = 0;
+  buffer[11] = 0;
+  buffer[12] = (source >> 24) & 0xff;
+  buffer[13] = (source >> 16) & 0xff;
+  buffer[14] = (source >> 8) & 0xff;
+  buffer[15] = source & 0xff;
+  buffer[16] = (destination >> 24) & 0xff;
+  buffer[17] = (destination >> 16) & 0xff;
+  buffer[18] = (destination >> 8) & 0xff;
+  buffer[19] = destination & 0xff;
+}
+
+void
+Ipv4Header::Serialize (Buffer::Iterator start) const
+{
+  NS_LOG_FUNCTION (this << &start);
+  Buffer::Iterator i = start;
+
+  uint8_t buffer[20];
+  WriteFixedPart (buffer);
+  i.Write (buffer, 20);
 
   if (m_calcChecksum) 
     {
@@ -419,6 +438,32 @@ Ipv4Header::Serialize (Buffer::Iterator start) const
       i.WriteU16 (checksum);
     }
 }
+
+bool
+Ipv4Header::SerializeTo (uint8_t *start, uint32_t packetSize) const
+{
+  NS_LOG_FUNCTION (this);
+  WriteFixedPart (start);
+
+  if (m_calcChecksum) 
+    {
+      // Same as Buffer::Iterator::CalculateIpChecksum, see RFC 1071
+      uint32_t sum = 0;
+      for (uint32_t j = 0; j < 20; j += 2)
+        {
+          sum += start[j] | (start[j + 1] << 8);
+        }
+      while (sum >> 16)
+        {
+          sum = (sum & 0xffff) + (sum >> 16);
+        }
+      uint16_t checksum = ~sum;
+      NS_LOG_LOGIC ("checksum=" <<checksum);
+      start[10] = checksum & 0xff;
+      start[11] = (checksum >> 8) & 0xff;
+    }
+  return true;
+}
 uint32_t
 Ipv4Header::Deserialize (Buffer::Iterator start)
 {
@@ -237,8 +237,14 @@ public:
   virtual void Print (std::ostream &os) const;
   virtual uint32_t GetSerializedSize (void) const;
   virtual void Serialize (Buffer::Iterator start) const;
+  virtual bool SerializeTo (uint8_t *start, uint32_t packetSize) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
 private:
+  /**
+   * \brief Write the 20 bytes of the header, with a null checksum
+   * \param buffer the destination
+   */
+  void WriteFixedPart (uint8_t *buffer) const;
 
   /// flags related to IP fragmentation
   enum FlagsE {
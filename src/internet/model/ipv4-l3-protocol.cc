@@ -43,6 +43,8 @@
 #include "icmpv4-l4-protocol.h"
 #include "ipv4-interface.h"
 #include "ipv4-raw-socket-impl.h"
+#include "tcp-header.h"
+#include "tcp-tso-tag.h"
 
 namespace ns3 {
 
@@ -86,6 +88,13 @@ Ipv4L3Protocol::GetTypeId (void)
                    TimeValue (Seconds (1)),
                    MakeTimeAccessor (&Ipv4L3Protocol::m_purge),
                    MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("TsoCarryWhole",
+                   "Carry the TCP super-segments (see TcpTsoTag) whole on the "
+                   "output devices whose MTU is large enough, instead of cutting "
+                   "them into their segments.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4L3Protocol::m_tsoCarryWhole),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Tx",
                      "Send ipv4 packet to outgoing interface.",
                      MakeTraceSourceAccessor (&Ipv4L3Protocol::m_txTrace),
@@ -132,6 +141,7 @@ Ipv4L3Protocol::GetTypeId (void)
 Ipv4L3Protocol::Ipv4L3Protocol()
 {
   NS_LOG_FUNCTION (this);
+  m_fragmentsTimeouts.SetExpireCallback (MakeCallback (&Ipv4L3Protocol::HandleFragmentsTimeout, this));
 }
 
 Ipv4L3Protocol::~Ipv4L3Protocol ()
@@ -330,11 +340,7 @@ Ipv4L3Protocol::DoDispose (void)
     }
 
   m_fragments.clear ();
-  m_timeoutEventList.clear ();
-  if (m_timeoutEvent.IsRunning ())
-    {
-      m_timeoutEvent.Cancel ();
-    }
+  m_fragmentsTimeouts.Clear ();
 
   if (m_cleanDpd.IsRunning ())
     {
@@ -803,6 +809,27 @@ Ipv4L3Protocol::Send (Ptr<Packet> packet,
       // 1b) with a valid gateway
       NS_LOG_LOGIC ("Ipv4L3Protocol::Send case 1b:  passed in with route and valid gateway");
       int32_t interface = GetInterfaceForDevice (route->GetOutputDevice ());
+      TcpTsoTag tsoTag;
+      if (packet->PeekPacketTag (tsoTag) && tsoTag.GetSegmentCount () > 1)
+        {
+          // reserve the identifications of the other segments of a super-segment
+          uint64_t srcDst = destination.Get () | (static_cast<uint64_t> (source.Get ()) << 32);
+          m_identification[std::make_pair (srcDst, protocol)] += tsoTag.GetSegmentCount () - 1;
+          if (!m_tsoCarryWhole
+              || packet->GetSize () + ipHeader.GetSerializedSize () > route->GetOutputDevice ()->GetMtu ())
+            {
+              // cut the super-segment first, so that the segments are
+              // traced as they are sent
+              std::list<Ipv4PayloadHeaderPair> listSegments;
+              DoSegmentation (packet, ipHeader, tsoTag.GetSegmentSize (), listSegments);
+              for (std::list<Ipv4PayloadHeaderPair>::iterator it = listSegments.begin (); it != listSegments.end (); it++)
+                {
+                  m_sendOutgoingTrace (it->second, it->first, interface);
+                  SendRealOut (route, it->first, it->second);
+                }
+              return;
+            }
+        }
       m_sendOutgoingTrace (ipHeader, packet, interface);
       if (m_enableDpd && ipHeader.GetDestination ().IsMulticast ())
         {
@@ -993,7 +1020,20 @@ Ipv4L3Protocol::SendRealOut (Ptr<Ipv4Route> route,
   if (outInterface->IsUp ())
     {
       NS_LOG_LOGIC ("Send to " << targetLabel << " " << target);
-      if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
+      TcpTsoTag tsoTag;
+      if (packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu ()
+          && packet->PeekPacketTag (tsoTag))
+        {
+          // TCP super-segment carried whole up to here: send the segments
+          // it stands for
+          std::list<Ipv4PayloadHeaderPair> listSegments;
+          DoSegmentation (packet, ipHeader, tsoTag.GetSegmentSize (), listSegments);
+          for (std::list<Ipv4PayloadHeaderPair>::iterator it = listSegments.begin (); it != listSegments.end (); it++)
+            {
+              SendRealOut (route, it->first, it->second);
+            }
+        }
+      else if ( packet->GetSize () + ipHeader.GetSerializedSize () > outInterface->GetDevice ()->GetMtu () )
         {
           std::list<Ipv4PayloadHeaderPair> listFragments;
           DoFragmentation (packet, ipHeader, outInterface->GetDevice ()->GetMtu (), listFragments);
@@ -1436,6 +1476,40 @@ Ipv4L3Protocol::RouteInputError (Ptr<const Packet> p, const Ipv4Header & ipHeade
   // \todo Send an ICMP no route.
 }
 
+void
+Ipv4L3Protocol::DoSegmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Header, uint32_t segmentSize, std::list<Ipv4PayloadHeaderPair>& listSegments)
+{
+  NS_LOG_FUNCTION (this << *packet << ipv4Header << segmentSize << &listSegments);
+  NS_ASSERT (segmentSize > 0);
+
+  Ptr<Packet> p = packet->Copy ();
+  TcpTsoTag tsoTag;
+  p->RemovePacketTag (tsoTag);
+  TcpHeader tcpHeader;
+  p->RemoveHeader (tcpHeader);
+  if (Node::ChecksumEnabled ())
+    {
+      tcpHeader.EnableChecksums ();
+      tcpHeader.InitializeChecksum (ipv4Header.GetSource (), ipv4Header.GetDestination (), ipv4Header.GetProtocol ());
+    }
+
+  uint16_t identification = ipv4Header.GetIdentification ();
+  uint32_t size = p->GetSize ();
+  for (uint32_t offset = 0; offset < size; offset += segmentSize)
+    {
+      Ptr<Packet> segment = p->CreateFragment (offset, std::min (segmentSize, size - offset));
+      TcpHeader segmentTcpHeader = tcpHeader;
+      segmentTcpHeader.SetSequenceNumber (tcpHeader.GetSequenceNumber () + offset);
+      segment->AddHeader (segmentTcpHeader);
+
+      Ipv4Header segmentHeader = ipv4Header;
+      segmentHeader.SetPayloadSize (segment->GetSize ());
+      segmentHeader.SetIdentification (identification++);
+      NS_LOG_LOGIC ("Segment " << *segment);
+      listSegments.push_back (Ipv4PayloadHeaderPair (segment, segmentHeader));
+    }
+}
+
 void
 Ipv4L3Protocol::DoFragmentation (Ptr<Packet> packet, const Ipv4Header & ipv4Header, uint32_t outIfaceMtu, std::list<Ipv4PayloadHeaderPair>& listFragments)
 {
@@ -1539,10 +1613,10 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
   MapFragments_t::iterator it = m_fragments.find (key);
   if (it == m_fragments.end ())
     {
-      fragments = Create<Fragments> ();
+      fragments = Create<Fragments> (ipHeader, iif);
       m_fragments.insert (std::make_pair (key, fragments));
 
-      FragmentsTimeoutsListI_t iter = SetTimeout (key, ipHeader, iif);
+      FragmentsTimeoutsListI_t iter = m_fragmentsTimeouts.Add (m_fragmentExpirationTimeout, key);
       fragments->SetTimeoutIter (iter);
     }
   else
@@ -1557,7 +1631,7 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
   if ( fragments->IsEntire () )
     {
       packet = fragments->GetPacket ();
-      m_timeoutEventList.erase (fragments->GetTimeoutIter ());
+      m_fragmentsTimeouts.Remove (fragments->GetTimeoutIter ());
       fragments = 0;
       m_fragments.erase (key);
       ret = true;
@@ -1566,8 +1640,9 @@ Ipv4L3Protocol::ProcessFragment (Ptr<Packet>& packet, Ipv4Header& ipHeader, uint
   return ret;
 }
 
-Ipv4L3Protocol::Fragments::Fragments ()
-  : m_moreFragment (0)
+Ipv4L3Protocol::Fragments::Fragments (const Ipv4Header &ipHeader, uint32_t iif)
+  : m_ipHeader (ipHeader),
+    m_iif (iif)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -1581,126 +1656,41 @@ void
 Ipv4L3Protocol::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
 {
   NS_LOG_FUNCTION (this << fragment << fragmentOffset << moreFragment);
-
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
-
-  for (it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
-    }
-
-  if (it == m_fragments.end ())
-    {
-      m_moreFragment = moreFragment;
-    }
-
-  m_fragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+  m_fragments.AddFragment (fragment, fragmentOffset, moreFragment);
 }
 
 bool
 Ipv4L3Protocol::Fragments::IsEntire () const
 {
   NS_LOG_FUNCTION (this);
-
-  bool ret = !m_moreFragment && m_fragments.size () > 0;
-
-  if (ret)
-    {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin (); it != m_fragments.end (); it++)
-        {
-          // overlapping fragments do exist
-          NS_LOG_LOGIC ("Checking overlaps " << lastEndOffset << " - " << it->second );
-
-          if (lastEndOffset < it->second)
-            {
-              ret = false;
-              break;
-            }
-          // fragments might overlap in strange ways
-          uint16_t fragmentEnd = it->first->GetSize () + it->second;
-          lastEndOffset = std::max ( lastEndOffset, fragmentEnd );
-        }
-    }
-
-  return ret;
+  // overlapping fragments do exist, and are accepted
+  return m_fragments.IsEntire ();
 }
 
 Ptr<Packet>
 Ipv4L3Protocol::Fragments::GetPacket () const
 {
   NS_LOG_FUNCTION (this);
-
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
-
-  Ptr<Packet> p = it->first->Copy ();
-  uint16_t lastEndOffset = p->GetSize ();
-  it++;
-
-  for ( ; it != m_fragments.end (); it++)
-    {
-      if ( lastEndOffset > it->second )
-        {
-          // The fragments are overlapping.
-          // We do not overwrite the "old" with the "new" because we do not know when each arrived.
-          // This is different from what Linux does.
-          // It is not possible to emulate a fragmentation attack.
-          uint32_t newStart = lastEndOffset - it->second;
-          if ( it->first->GetSize () > newStart )
-            {
-              uint32_t newSize = it->first->GetSize () - newStart;
-              Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
-              p->AddAtEnd (tempFragment);
-            }
-        }
-      else
-        {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
-        }
-      lastEndOffset = p->GetSize ();
-    }
-
-  return p;
+  return m_fragments.GetPacket ();
 }
 
 Ptr<Packet>
 Ipv4L3Protocol::Fragments::GetPartialPacket () const
 {
   NS_LOG_FUNCTION (this);
-  
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_fragments.begin ();
-
-  Ptr<Packet> p = Create<Packet> ();
-  uint16_t lastEndOffset = 0;
-
-  if ( m_fragments.begin ()->second > 0 )
-    {
-      return p;
-    }
+  return m_fragments.GetPacket ();
+}
 
-  for ( it = m_fragments.begin (); it != m_fragments.end (); it++)
-    {
-      if ( lastEndOffset > it->second )
-        {
-          uint32_t newStart = lastEndOffset - it->second;
-          uint32_t newSize = it->first->GetSize () - newStart;
-          Ptr<Packet> tempFragment = it->first->CreateFragment (newStart, newSize);
-          p->AddAtEnd (tempFragment);
-        }
-      else if ( lastEndOffset == it->second )
-        {
-          NS_LOG_LOGIC ("Adding: " << *(it->first) );
-          p->AddAtEnd (it->first);
-        }
-      lastEndOffset = p->GetSize ();
-    }
+const Ipv4Header &
+Ipv4L3Protocol::Fragments::GetIpHeader () const
+{
+  return m_ipHeader;
+}
 
-  return p;
+uint32_t
+Ipv4L3Protocol::Fragments::GetIif () const
+{
+  return m_iif;
 }
 
 void
@@ -1718,12 +1708,14 @@ Ipv4L3Protocol::Fragments::GetTimeoutIter ()
 
 
 void
-Ipv4L3Protocol::HandleFragmentsTimeout (FragmentKey_t key, Ipv4Header & ipHeader, uint32_t iif)
+Ipv4L3Protocol::HandleFragmentsTimeout (FragmentKey_t key)
 {
-  NS_LOG_FUNCTION (this << &key << &ipHeader << iif);
+  NS_LOG_FUNCTION (this << &key);
 
   MapFragments_t::iterator it = m_fragments.find (key);
   Ptr<Packet> packet = it->second->GetPartialPacket ();
+  const Ipv4Header &ipHeader = it->second->GetIpHeader ();
+  uint32_t iif = it->second->GetIif ();
 
   // if we have at least 8 bytes, we can send an ICMP.
   if ( packet->GetSize () > 8 )
@@ -1845,44 +1837,4 @@ Ipv4L3Protocol::RemoveDuplicates (void)
     }
 }
 
-Ipv4L3Protocol::FragmentsTimeoutsListI_t
-Ipv4L3Protocol::SetTimeout (FragmentKey_t key, Ipv4Header ipHeader, uint32_t iif)
-{
-  Time now = Simulator::Now () + m_fragmentExpirationTimeout;
-
-  if (m_timeoutEventList.empty ())
-    {
-      m_timeoutEvent = Simulator::Schedule (m_fragmentExpirationTimeout, &Ipv4L3Protocol::HandleTimeout, this);
-    }
-  m_timeoutEventList.emplace_back (now, key, ipHeader, iif);
-
-  Ipv4L3Protocol::FragmentsTimeoutsListI_t iter = --m_timeoutEventList.end();
-
-  return (iter);
-}
-
-void
-Ipv4L3Protocol::HandleTimeout (void)
-{
-  Time now = Simulator::Now ();
-
-  while (!m_timeoutEventList.empty () && std::get<0> (*m_timeoutEventList.begin ()) == now)
-    {
-      HandleFragmentsTimeout (std::get<1> (*m_timeoutEventList.begin ()),
-                              std::get<2> (*m_timeoutEventList.begin ()),
-                              std::get<3> (*m_timeoutEventList.begin ()));
-      m_timeoutEventList.pop_front ();
-    }
-
-  if (m_timeoutEventList.empty ())
-    {
-      return;
-    }
-
-  Time difference = std::get<0> (*m_timeoutEventList.begin ()) - now;
-  m_timeoutEvent = Simulator::Schedule (difference, &Ipv4L3Protocol::HandleTimeout, this);
-
-  return;
-}
-
 } // namespace ns3
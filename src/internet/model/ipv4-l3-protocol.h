@@ -34,6 +34,7 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/nstime.h"
 #include "ns3/simulator.h"
+#include "fragment-buffer.h"
 
 class Ipv4L3ProtocolTestCase;
 
@@ -416,6 +417,20 @@ private:
    */
   void DoFragmentation (Ptr<Packet> packet, const Ipv4Header& ipv4Header, uint32_t outIfaceMtu, std::list<Ipv4PayloadHeaderPair>& listFragments);
 
+  /**
+   * \brief Cut a TCP super-segment (see TcpTsoTag) into its segments
+   *
+   * The segments get a copy of the TCP header with their own sequence
+   * number, and consecutive IP identifications starting from the one of
+   * the super-segment.
+   *
+   * \param packet the super-segment, with its TCP header
+   * \param ipv4Header the IPv4 header
+   * \param segmentSize the size of the payload of the segments
+   * \param listSegments the list of segments
+   */
+  void DoSegmentation (Ptr<Packet> packet, const Ipv4Header& ipv4Header, uint32_t segmentSize, std::list<Ipv4PayloadHeaderPair>& listSegments);
+
   /**
    * \brief Process a packet fragment
    * \param packet the packet
@@ -500,36 +515,18 @@ private:
   /// Key identifying a fragmented packet
   typedef std::pair<uint64_t, uint32_t> FragmentKey_t;
 
-  /// Container for fragment timeouts.
-  typedef std::list< std::tuple <Time, FragmentKey_t, Ipv4Header, uint32_t > > FragmentsTimeoutsList_t;
-  /// Container Iterator for fragment timeouts..
-  typedef std::list< std::tuple <Time, FragmentKey_t, Ipv4Header, uint32_t > >::iterator FragmentsTimeoutsListI_t;
+  /// Timeouts of the fragmented packets
+  typedef FragmentTimeouts<FragmentKey_t> FragmentsTimeouts_t;
+  /// Iterator to the timeout of a fragmented packet
+  typedef FragmentsTimeouts_t::Iterator FragmentsTimeoutsListI_t;
 
   /**
    * \brief Process the timeout for packet fragments
    * \param key representing the packet fragments
-   * \param ipHeader the IP header of the original packet
-   * \param iif Input Interface
-   */
-  void HandleFragmentsTimeout (FragmentKey_t key, Ipv4Header & ipHeader, uint32_t iif);
-
-  /**
-   * \brief Set a new timeout "event" for a fragmented packet
-   * \param key the fragment identification
-   * \param ipHeader the IPv4 header of the fragmented packet
-   * \param iif input interface of the packet
-   * \return an iterator to the inserted "event"
-   */
-  FragmentsTimeoutsListI_t SetTimeout (FragmentKey_t key, Ipv4Header ipHeader, uint32_t iif);
-
-  /**
-   * \brief Handles a fragmented packet timeout
    */
-  void HandleTimeout (void);
+  void HandleFragmentsTimeout (FragmentKey_t key);
 
-  FragmentsTimeoutsList_t m_timeoutEventList;  //!< Timeout "events" container
-
-  EventId m_timeoutEvent;  //!< Event for the next scheduled timeout
+  FragmentsTimeouts_t m_fragmentsTimeouts;  //!< Timeouts of the fragmented packets
 
   /**
    * \brief A Set of Fragment belonging to the same packet (src, dst, identification and proto)
@@ -539,8 +536,10 @@ private:
   public:
     /**
      * \brief Constructor.
+     * \param ipHeader the IPv4 header of the first fragment received
+     * \param iif input interface of the first fragment received
      */
-    Fragments ();
+    Fragments (const Ipv4Header &ipHeader, uint32_t iif);
 
     /**
      * \brief Destructor.
@@ -573,6 +572,18 @@ private:
      */
     Ptr<Packet> GetPartialPacket () const;
 
+    /**
+     * \brief Get the IPv4 header of the first fragment received.
+     * \returns the IPv4 header
+     */
+    const Ipv4Header & GetIpHeader () const;
+
+    /**
+     * \brief Get the input interface of the first fragment received.
+     * \returns the interface index
+     */
+    uint32_t GetIif () const;
+
     /**
      * \brief Set the Timeout iterator.
      * \param iter The iterator.
@@ -587,14 +598,19 @@ private:
 
   private:
     /**
-     * \brief True if other fragments will be sent.
+     * \brief The current fragments.
      */
-    bool m_moreFragment;
+    FragmentBuffer m_fragments;
 
     /**
-     * \brief The current fragments.
+     * \brief The IPv4 header of the first fragment received.
+     */
+    Ipv4Header m_ipHeader;
+
+    /**
+     * \brief The input interface of the first fragment received.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_fragments;
+    uint32_t m_iif;
 
     /**
      * \brief Timeout iterator to "event" handler
@@ -626,6 +642,8 @@ private:
    */
   void RemoveDuplicates (void);
 
+  bool                m_tsoCarryWhole; //!< Carry the TCP super-segments whole where they fit
+
   bool                m_enableDpd;    //!< Enable multicast duplicate packet detection
   DupMap_t            m_dups;         //!< map of packet duplicate tuples to expiry event
   Time                m_expire;       //!< duplicate entry expiration delay
@@ -75,8 +75,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
 
   if (!LookupRoute (route, metric))
     {
-      Ipv4RoutingTableEntry *routePtr = new Ipv4RoutingTableEntry (route);
-      m_networkRoutes.push_back (make_pair (routePtr, metric));
+      InsertRoute (new Ipv4RoutingTableEntry (route), metric);
     }
 }
 
@@ -93,9 +92,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                                              interface);
   if (!LookupRoute (route, metric))
     {
-      Ipv4RoutingTableEntry *routePtr = new Ipv4RoutingTableEntry (route);
-
-      m_networkRoutes.push_back (make_pair (routePtr, metric));
+      InsertRoute (new Ipv4RoutingTableEntry (route), metric);
     }
 }
 
@@ -153,7 +150,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo (network,
                                                         networkMask,
                                                         outputInterface);
-  m_networkRoutes.push_back (make_pair (route,0));
+  InsertRoute (route, 0);
 }
 
 uint32_t 
@@ -229,18 +226,45 @@ Ipv4StaticRouting::RemoveMulticastRoute (uint32_t index)
     }
 }
 
+void
+Ipv4StaticRouting::InsertRoute (Ipv4RoutingTableEntry *route, uint32_t metric)
+{
+  m_networkRoutes.push_back (std::make_pair (route, metric));
+  m_networkRoutesIndex.Insert (NetworkRoutesIndex::MakeKey (route->GetDestNetwork ()),
+                               route->GetDestNetworkMask ().GetPrefixLength (),
+                               m_networkRoutes.back ());
+}
+
+Ipv4StaticRouting::NetworkRoutesI
+Ipv4StaticRouting::EraseRoute (NetworkRoutesI it)
+{
+  Ipv4RoutingTableEntry *route = it->first;
+  m_networkRoutesIndex.Remove (NetworkRoutesIndex::MakeKey (route->GetDestNetwork ()),
+                               route->GetDestNetworkMask ().GetPrefixLength (),
+                               *it);
+  delete route;
+  return m_networkRoutes.erase (it);
+}
+
 bool
 Ipv4StaticRouting::LookupRoute (const Ipv4RoutingTableEntry &route, uint32_t metric)
 {
-  for (NetworkRoutesI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+  const NetworkRoutesIndex::Bucket *bucket =
+    m_networkRoutesIndex.Find (NetworkRoutesIndex::MakeKey (route.GetDestNetwork ()),
+                               route.GetDestNetworkMask ().GetPrefixLength ());
+  if (bucket == 0)
     {
-      Ipv4RoutingTableEntry* rtentry = j->first;
+      return false;
+    }
+  for (NetworkRoutesIndex::Bucket::const_iterator j = bucket->begin (); j != bucket->end (); j++)
+    {
+      const Ipv4RoutingTableEntry* rtentry = j->value.first;
 
       if (rtentry->GetDest () == route.GetDest () &&
           rtentry->GetDestNetworkMask () == route.GetDestNetworkMask () &&
           rtentry->GetGateway () == route.GetGateway () &&
           rtentry->GetInterface () == route.GetInterface () &&
-          j->second == metric)
+          j->value.second == metric)
         {
           return true;
         }
@@ -253,8 +277,6 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION (this << dest << " " << oif);
   Ptr<Ipv4Route> rtentry = 0;
-  uint16_t longest_mask = 0;
-  uint32_t shortest_metric = 0xffffffff;
   /* when sending on local multicast, there have to be interface specified */
   if (dest.IsLocalMulticast ())
     {
@@ -269,18 +291,21 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
-       i++) 
+  // Visit the prefixes matching dest, longest first; the first length
+  // with a route on the requested interface wins.  Among routes of that
+  // length, the one with the lowest metric wins, the last one added when
+  // metrics are equal, except for host routes where the first one wins.
+  NetworkRoutesIndex::Key key = NetworkRoutesIndex::MakeKey (dest);
+  int masklen = 33;
+  const NetworkRoutesIndex::Bucket *bucket;
+  while (rtentry == 0 && (bucket = m_networkRoutesIndex.FindLongestMatch (key, masklen)) != 0)
     {
-      Ipv4RoutingTableEntry *j=i->first;
-      uint32_t metric =i->second;
-      Ipv4Mask mask = (j)->GetDestNetworkMask ();
-      uint16_t masklen = mask.GetPrefixLength ();
-      Ipv4Address entry = (j)->GetDestNetwork ();
-      NS_LOG_LOGIC ("Searching for route to " << dest << ", checking against route to " << entry << "/" << masklen);
-      if (mask.IsMatch (dest, entry)) 
+      Ipv4RoutingTableEntry *route = 0;
+      uint32_t shortest_metric = 0xffffffff;
+      for (NetworkRoutesIndex::Bucket::const_iterator i = bucket->begin (); i != bucket->end (); i++)
         {
+          Ipv4RoutingTableEntry *j = i->value.first;
+          uint32_t metric = i->value.second;
           NS_LOG_LOGIC ("Found global network route " << j << ", mask length " << masklen << ", metric " << metric);
           if (oif != 0)
             {
@@ -290,33 +315,26 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
                   continue;
                 }
             }
-          if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-              NS_LOG_LOGIC ("Previous match longer, skipping");
-              continue;
-            }
-          if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-              shortest_metric = 0xffffffff;
-            }
-          longest_mask = masklen;
           if (metric > shortest_metric)
             {
               NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
               continue;
             }
           shortest_metric = metric;
-          Ipv4RoutingTableEntry* route = (j);
+          route = j;
+          if (masklen == 32)
+            {
+              break;
+            }
+        }
+      if (route != 0)
+        {
           uint32_t interfaceIdx = route->GetInterface ();
           rtentry = Create<Ipv4Route> ();
           rtentry->SetDestination (route->GetDest ());
           rtentry->SetSource (m_ipv4->SourceAddressSelection (interfaceIdx, route->GetDest ()));
           rtentry->SetGateway (route->GetGateway ());
           rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-          if (masklen == 32)
-            {
-              break;
-            }
         }
     }
   if (rtentry != 0)
@@ -476,8 +494,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete j->first;
-          m_networkRoutes.erase (j);
+          EraseRoute (j);
           return;
         }
       tmp++;
@@ -604,6 +621,7 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_networkRoutesIndex.Clear ();
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -642,8 +660,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseRoute (it);
         }
       else
         {
@@ -689,8 +706,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkMask () == networkMask)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseRoute (it);
         }
       else
         {
@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/routing-prefix-index.h"
 
 namespace ns3 {
 
@@ -367,6 +368,9 @@ private:
   /// Iterator for container for the network routes
   typedef std::list<std::pair <Ipv4RoutingTableEntry *, uint32_t> >::iterator NetworkRoutesI;
 
+  /// Longest-prefix-match index of the network routes
+  typedef RoutingPrefixIndex<std::pair <Ipv4RoutingTableEntry *, uint32_t> > NetworkRoutesIndex;
+
   /// Container for the multicast routes
   typedef std::list<Ipv4MulticastRoutingTableEntry *> MulticastRoutes;
 
@@ -384,6 +388,23 @@ private:
    */
   bool LookupRoute (const Ipv4RoutingTableEntry &route, uint32_t metric);
 
+  /**
+   * \brief Add a network route to the forwarding table and its index.
+   * \param route route (owned by the table from now on)
+   * \param metric metric of route
+   */
+  void InsertRoute (Ipv4RoutingTableEntry *route, uint32_t metric);
+
+  /**
+   * \brief Remove a network route from the forwarding table and its index.
+   *
+   * The route entry is deleted.
+   *
+   * \param it the route
+   * \return the iterator following the removed route
+   */
+  NetworkRoutesI EraseRoute (NetworkRoutesI it);
+
   /**
    * \brief Lookup in the forwarding table for destination.
    * \param dest destination address
@@ -407,6 +428,11 @@ private:
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief the network routes, indexed by destination prefix.
+   */
+  NetworkRoutesIndex m_networkRoutesIndex;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -25,6 +25,7 @@
 #include <list>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
+#include "end-point-index.h"
 
 namespace ns3 {
 
@@ -34,6 +35,9 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * The endpoints are also hashed (see EndPointIndex), so that finding the
+ * endpoint of a connection does not depend on the number of endpoints.
  */
 class Ipv6EndPointDemux
 {
@@ -153,6 +157,25 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
+  /**
+   * \brief The type of the hash index of the end points.
+   */
+  typedef EndPointIndex<Ipv6EndPoint, Ipv6Address, Ipv6AddressHash> Index;
+
+  /**
+   * \brief Add a new end point to the list and to the index.
+   * \param endPoint the end point
+   */
+  void Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Re-index an end point whose addresses or ports changed.
+   * \param endPoint the end point
+   */
+  void Update (Ipv6EndPoint *endPoint);
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
@@ -178,6 +201,11 @@ private:
    * \brief A list of IPv6 end points.
    */
   EndPoints m_endPoints;
+
+  /**
+   * \brief The hash index of the end points.
+   */
+  Index m_index;
 };
 
 } /* namespace ns3 */
@@ -314,6 +314,7 @@ TypeId Ipv6ExtensionFragment::GetTypeId ()
 
 Ipv6ExtensionFragment::Ipv6ExtensionFragment ()
 {
+  m_fragmentsTimeouts.SetExpireCallback (MakeCallback (&Ipv6ExtensionFragment::HandleFragmentsTimeout, this));
 }
 
 Ipv6ExtensionFragment::~Ipv6ExtensionFragment ()
@@ -330,11 +331,7 @@ void Ipv6ExtensionFragment::DoDispose ()
     }
 
   m_fragments.clear ();
-  m_timeoutEventList.clear ();
-  if (m_timeoutEvent.IsRunning ())
-    {
-      m_timeoutEvent.Cancel ();
-    }
+  m_fragmentsTimeouts.Clear ();
   Ipv6Extension::DoDispose ();
 }
 
@@ -379,10 +376,10 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet,
   MapFragments_t::iterator it = m_fragments.find (fragmentKey);
   if (it == m_fragments.end ())
     {
-      fragments = Create<Fragments> ();
+      fragments = Create<Fragments> (ipHeader);
       m_fragments.insert (std::make_pair (fragmentKey, fragments));
       NS_LOG_DEBUG ("Insert new fragment key: src: " << src << " IP hdr id " << identification << " m_fragments.size() " << m_fragments.size () << " offset " << fragmentOffset);
-      FragmentsTimeoutsListI_t iter = SetTimeout (fragmentKey, ipHeader);
+      FragmentsTimeoutsListI_t iter = m_fragmentsTimeouts.Add (m_fragmentExpirationTimeout, fragmentKey);
       fragments->SetTimeoutIter (iter);
     }
   else
@@ -403,7 +400,7 @@ uint8_t Ipv6ExtensionFragment::Process (Ptr<Packet>& packet,
   if (fragments->IsEntire ())
     {
       packet = fragments->GetPacket ();
-      m_timeoutEventList.erase (fragments->GetTimeoutIter ());
+      m_fragmentsTimeouts.Remove (fragments->GetTimeoutIter ());
       m_fragments.erase (fragmentKey);
       NS_LOG_DEBUG ("Finished fragment with IP hdr id " << fragmentKey.second << " erase timeout, m_fragments.size(): " << m_fragments.size ());
       stopProcessing = false;
@@ -590,15 +587,15 @@ void Ipv6ExtensionFragment::GetFragments (Ptr<Packet> packet, Ipv6Header ipv6Hea
 }
 
 
-void Ipv6ExtensionFragment::HandleFragmentsTimeout (FragmentKey_t fragmentKey,
-                                                    Ipv6Header ipHeader)
+void Ipv6ExtensionFragment::HandleFragmentsTimeout (FragmentKey_t fragmentKey)
 {
-  NS_LOG_FUNCTION (this << fragmentKey.first << fragmentKey.second << ipHeader);
+  NS_LOG_FUNCTION (this << fragmentKey.first << fragmentKey.second);
   Ptr<Fragments> fragments;
 
   MapFragments_t::iterator it = m_fragments.find (fragmentKey);
   NS_ASSERT_MSG(it != m_fragments.end (), "IPv6 Fragment timeout reached for non-existent fragment");
   fragments = it->second;
+  Ipv6Header ipHeader = fragments->GetIpHeader ();
 
   Ptr<Packet> packet = fragments->GetPartialPacket ();
 
@@ -619,56 +616,8 @@ void Ipv6ExtensionFragment::HandleFragmentsTimeout (FragmentKey_t fragmentKey,
 }
 
 
-Ipv6ExtensionFragment::FragmentsTimeoutsListI_t Ipv6ExtensionFragment::SetTimeout (FragmentKey_t key, Ipv6Header ipHeader)
-{
-  NS_LOG_FUNCTION (this << key.first << key.second << ipHeader);
-  if (m_timeoutEventList.empty ())
-    {
-      NS_LOG_DEBUG ("Scheduling timeout for IP hdr id " << key.second << " at time " << (Simulator::Now () + m_fragmentExpirationTimeout).GetSeconds ());
-      m_timeoutEvent = Simulator::Schedule (m_fragmentExpirationTimeout, &Ipv6ExtensionFragment::HandleTimeout, this);
-    }
-  NS_LOG_DEBUG ("Adding timeout at " << (Simulator::Now () + m_fragmentExpirationTimeout).GetSeconds () << " with key " << key.second);
-  m_timeoutEventList.emplace_back (Simulator::Now () + m_fragmentExpirationTimeout, key, ipHeader);
-
-  Ipv6ExtensionFragment::FragmentsTimeoutsListI_t iter = --m_timeoutEventList.end();
-
-  return (iter);
-}
-
-void Ipv6ExtensionFragment::HandleTimeout (void)
-{
-  NS_LOG_FUNCTION (this);
-  Time now = Simulator::Now ();
-
-  // std::list Time, Fragment_key_t, Ipv6Header
-  // Fragment key is a pair: Ipv6Address, uint32_t ipHeaderId
-  for (auto & element : m_timeoutEventList)
-    {
-      NS_LOG_DEBUG ("Handle time " << std::get<0> (element).GetSeconds () << " IP hdr id " << std::get<1> (element).second);
-    }
-  while (!m_timeoutEventList.empty () && std::get<0> (*m_timeoutEventList.begin ()) == now)
-    {
-      HandleFragmentsTimeout (std::get<1> (*m_timeoutEventList.begin ()),
-                              std::get<2> (*m_timeoutEventList.begin ()));
-      m_timeoutEventList.pop_front ();
-    }
-
-  if (m_timeoutEventList.empty ())
-    {
-      return;
-    }
-
-  Time difference = std::get<0> (*m_timeoutEventList.begin ()) - now;
-  NS_LOG_DEBUG ("Scheduling later HandleTimeout at " << (now + difference).GetSeconds ());
-  m_timeoutEvent = Simulator::Schedule (difference, &Ipv6ExtensionFragment::HandleTimeout, this);
-
-  return;
-}
-
-
-
-Ipv6ExtensionFragment::Fragments::Fragments ()
-  : m_moreFragment (0)
+Ipv6ExtensionFragment::Fragments::Fragments (const Ipv6Header &ipHeader)
+  : m_ipHeader (ipHeader)
 {
 }
 
@@ -679,22 +628,7 @@ Ipv6ExtensionFragment::Fragments::~Fragments ()
 void Ipv6ExtensionFragment::Fragments::AddFragment (Ptr<Packet> fragment, uint16_t fragmentOffset, bool moreFragment)
 {
   NS_LOG_FUNCTION (this << fragment << fragmentOffset << moreFragment);
-  std::list<std::pair<Ptr<Packet>, uint16_t> >::iterator it;
-
-  for (it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
-    {
-      if (it->second > fragmentOffset)
-        {
-          break;
-        }
-    }
-
-  if (it == m_packetFragments.end ())
-    {
-      m_moreFragment = moreFragment;
-    }
-
-  m_packetFragments.insert (it, std::pair<Ptr<Packet>, uint16_t> (fragment, fragmentOffset));
+  m_packetFragments.AddFragment (fragment, fragmentOffset, moreFragment);
 }
 
 void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfragmentablePart)
@@ -705,36 +639,14 @@ void Ipv6ExtensionFragment::Fragments::SetUnfragmentablePart (Ptr<Packet> unfrag
 
 bool Ipv6ExtensionFragment::Fragments::IsEntire () const
 {
-  bool ret = !m_moreFragment && m_packetFragments.size () > 0;
-
-  if (ret)
-    {
-      uint16_t lastEndOffset = 0;
-
-      for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
-        {
-          if (lastEndOffset != it->second)
-            {
-              ret = false;
-              break;
-            }
-
-          lastEndOffset += it->first->GetSize ();
-        }
-    }
-
-  return ret;
+  // overlapping fragments are not reassembled (RFC 5722)
+  return m_packetFragments.IsEntire () && !m_packetFragments.HasOverlaps ();
 }
 
 Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPacket () const
 {
   Ptr<Packet> p =  m_unfragmentable->Copy ();
-
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
-    {
-      p->AddAtEnd (it->first);
-    }
-
+  p->AddAtEnd (m_packetFragments.GetPacket ());
   return p;
 }
 
@@ -745,27 +657,17 @@ Ptr<Packet> Ipv6ExtensionFragment::Fragments::GetPartialPacket () const
   if ( m_unfragmentable )
     {
       p = m_unfragmentable->Copy ();
-    }
-  else
-    {
-      return p;
-    }
-
-  uint16_t lastEndOffset = 0;
-
-  for (std::list<std::pair<Ptr<Packet>, uint16_t> >::const_iterator it = m_packetFragments.begin (); it != m_packetFragments.end (); it++)
-    {
-      if (lastEndOffset != it->second)
-        {
-          break;
-        }
-      p->AddAtEnd (it->first);
-      lastEndOffset += it->first->GetSize ();
+      p->AddAtEnd (m_packetFragments.GetPacket ());
     }
 
   return p;
 }
 
+const Ipv6Header & Ipv6ExtensionFragment::Fragments::GetIpHeader () const
+{
+  return m_ipHeader;
+}
+
 void Ipv6ExtensionFragment::Fragments::SetTimeoutIter (FragmentsTimeoutsListI_t iter)
 {
   NS_LOG_FUNCTION (this);
@@ -36,6 +36,7 @@
 #include "ns3/ipv6-address.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/traced-callback.h"
+#include "fragment-buffer.h"
 
 
 namespace ns3 {
@@ -324,13 +325,13 @@ private:
   typedef std::pair<Ipv6Address, uint32_t> FragmentKey_t;
 
   /**
-   * Container for fragment timeouts.
+   * Timeouts of the fragmented packets.
    */
-  typedef std::list< std::tuple <Time, FragmentKey_t, Ipv6Header > > FragmentsTimeoutsList_t;
+  typedef FragmentTimeouts<FragmentKey_t> FragmentsTimeouts_t;
   /**
-   * Container Iterator for fragment timeouts.
+   * Iterator to the timeout of a fragmented packet.
    */
-  typedef std::list< std::tuple <Time, FragmentKey_t, Ipv6Header > >::iterator FragmentsTimeoutsListI_t;
+  typedef FragmentsTimeouts_t::Iterator FragmentsTimeoutsListI_t;
 
   /**
    * \ingroup ipv6HeaderExt
@@ -342,8 +343,9 @@ private:
 public:
     /**
      * \brief Constructor.
+     * \param ipHeader the IPv6 header of the fragmented packet
      */
-    Fragments ();
+    Fragments (const Ipv6Header &ipHeader);
 
     /**
      * \brief Destructor.
@@ -382,6 +384,12 @@ public:
      */
     Ptr<Packet> GetPartialPacket () const;
 
+    /**
+     * \brief Get the IPv6 header of the fragmented packet.
+     * \returns the IPv6 header
+     */
+    const Ipv6Header & GetIpHeader () const;
+
     /**
      * \brief Set the Timeout iterator.
      * \param iter The iterator.
@@ -396,14 +404,14 @@ public:
 
 private:
     /**
-     * \brief If other fragments will be sent.
+     * \brief The current fragments.
      */
-    bool m_moreFragment;
+    FragmentBuffer m_packetFragments;
 
     /**
-     * \brief The current fragments.
+     * \brief The IPv6 header of the fragmented packet.
      */
-    std::list<std::pair<Ptr<Packet>, uint16_t> > m_packetFragments;
+    Ipv6Header m_ipHeader;
 
     /**
      * \brief The unfragmentable part.
@@ -419,9 +427,8 @@ private:
   /**
    * \brief Process the timeout for packet fragments
    * \param key representing the packet fragments
-   * \param ipHeader the IP header of the original packet
    */
-  void HandleFragmentsTimeout (FragmentKey_t key, Ipv6Header ipHeader);
+  void HandleFragmentsTimeout (FragmentKey_t key);
 
   /**
    * \brief Get the packet parts so far received.
@@ -450,21 +457,7 @@ private:
    */
   MapFragments_t m_fragments;
 
-  /**
-   * \brief Set a new timeout "event" for a fragmented packet
-   * \param key the fragment identification
-   * \param ipHeader the IPv6 header of the fragmented packet
-   * \return an iterator to the inserted "event"
-   */
-  FragmentsTimeoutsListI_t SetTimeout (FragmentKey_t key, Ipv6Header ipHeader);
-
-  /**
-   * \brief Handles a fragmented packet timeout
-   */
-  void HandleTimeout (void);
-
-  FragmentsTimeoutsList_t m_timeoutEventList;  //!< Timeout "events" container
-  EventId m_timeoutEvent;  //!< Event for the next scheduled timeout
+  FragmentsTimeouts_t m_fragmentsTimeouts;  //!< Timeouts of the fragmented packets
   Time m_fragmentExpirationTimeout; //!< Expiration timeout
 };
 
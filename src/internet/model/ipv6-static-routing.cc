@@ -161,8 +161,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
 
   if (!LookupRoute (route, metric))
     {
-      Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry (route);
-      m_networkRoutes.push_back (std::make_pair (routePtr, metric));
+      InsertRoute (new Ipv6RoutingTableEntry (route), metric);
     }
 }
 
@@ -177,8 +176,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   Ipv6RoutingTableEntry route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface, prefixToUse);
   if (!LookupRoute (route, metric))
     {
-      Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry (route);
-      m_networkRoutes.push_back (std::make_pair (routePtr, metric));
+      InsertRoute (new Ipv6RoutingTableEntry (route), metric);
     }
 }
 
@@ -189,8 +187,7 @@ void Ipv6StaticRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix netwo
   Ipv6RoutingTableEntry route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, interface);
   if (!LookupRoute (route, metric))
     {
-      Ipv6RoutingTableEntry* routePtr = new Ipv6RoutingTableEntry (route);
-      m_networkRoutes.push_back (std::make_pair (routePtr, metric));
+      InsertRoute (new Ipv6RoutingTableEntry (route), metric);
     }
 }
 
@@ -215,7 +212,7 @@ void Ipv6StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
   Ipv6Address network = Ipv6Address ("ff00::"); /* RFC 3513 */
   Ipv6Prefix networkMask = Ipv6Prefix (8);
   *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkMask, outputInterface);
-  m_networkRoutes.push_back (std::make_pair (route, 0));
+  InsertRoute (route, 0);
 }
 
 uint32_t Ipv6StaticRouting::GetNMulticastRoutes () const
@@ -300,18 +297,43 @@ bool Ipv6StaticRouting::HasNetworkDest (Ipv6Address network, uint32_t interfaceI
   return false;
 }
 
+void Ipv6StaticRouting::InsertRoute (Ipv6RoutingTableEntry *route, uint32_t metric)
+{
+  m_networkRoutes.push_back (std::make_pair (route, metric));
+  m_networkRoutesIndex.Insert (NetworkRoutesIndex::MakeKey (route->GetDestNetwork ()),
+                               route->GetDestNetworkPrefix ().GetPrefixLength (),
+                               m_networkRoutes.back ());
+}
+
+Ipv6StaticRouting::NetworkRoutesI Ipv6StaticRouting::EraseRoute (NetworkRoutesI it)
+{
+  Ipv6RoutingTableEntry *route = it->first;
+  m_networkRoutesIndex.Remove (NetworkRoutesIndex::MakeKey (route->GetDestNetwork ()),
+                               route->GetDestNetworkPrefix ().GetPrefixLength (),
+                               *it);
+  delete route;
+  return m_networkRoutes.erase (it);
+}
+
 bool Ipv6StaticRouting::LookupRoute (const Ipv6RoutingTableEntry &route, uint32_t metric)
 {
-  for (NetworkRoutesI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+  const NetworkRoutesIndex::Bucket *bucket =
+    m_networkRoutesIndex.Find (NetworkRoutesIndex::MakeKey (route.GetDestNetwork ()),
+                               route.GetDestNetworkPrefix ().GetPrefixLength ());
+  if (bucket == 0)
     {
-      Ipv6RoutingTableEntry* rtentry = j->first;
+      return false;
+    }
+  for (NetworkRoutesIndex::Bucket::const_iterator j = bucket->begin (); j != bucket->end (); j++)
+    {
+      const Ipv6RoutingTableEntry* rtentry = j->value.first;
 
       if (rtentry->GetDest () == route.GetDest () &&
           rtentry->GetDestNetworkPrefix () == route.GetDestNetworkPrefix () &&
           rtentry->GetGateway () == route.GetGateway () &&
           rtentry->GetInterface () == route.GetInterface () &&
           rtentry->GetPrefixToUse () == route.GetPrefixToUse () &&
-          j->second == metric)
+          j->value.second == metric)
         {
           return true;
         }
@@ -323,8 +345,6 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
 {
   NS_LOG_FUNCTION (this << dst << interface);
   Ptr<Ipv6Route> rtentry = 0;
-  uint16_t longestMask = 0;
-  uint32_t shortestMetric = 0xffffffff;
 
   /* when sending on link-local multicast, there have to be interface specified */
   if (dst.IsLinkLocalMulticast ())
@@ -338,67 +358,64 @@ Ptr<Ipv6Route> Ipv6StaticRouting::LookupStatic (Ipv6Address dst, Ptr<NetDevice>
       return rtentry;
     }
 
-  for (NetworkRoutesI it = m_networkRoutes.begin (); it != m_networkRoutes.end (); it++)
+  /* visit the prefixes matching dst, longest first: the first length with
+   * a route on the requested interface wins.  Among routes of that length,
+   * the one with the lowest metric wins, the last one added when metrics are
+   * equal, except for host routes where the first one wins.
+   */
+  NetworkRoutesIndex::Key key = NetworkRoutesIndex::MakeKey (dst);
+  int maskLen = 129;
+  const NetworkRoutesIndex::Bucket *bucket;
+  while (!rtentry && (bucket = m_networkRoutesIndex.FindLongestMatch (key, maskLen)) != 0)
     {
-      Ipv6RoutingTableEntry* j = it->first;
-      uint32_t metric = it->second;
-      Ipv6Prefix mask = j->GetDestNetworkPrefix ();
-      uint16_t maskLen = mask.GetPrefixLength ();
-      Ipv6Address entry = j->GetDestNetwork ();
-
-      NS_LOG_LOGIC ("Searching for route to " << dst << ", mask length " << maskLen << ", metric " << metric);
-
-      if (mask.IsMatch (dst, entry))
+      Ipv6RoutingTableEntry* route = 0;
+      uint32_t shortestMetric = 0xffffffff;
+      for (NetworkRoutesIndex::Bucket::const_iterator it = bucket->begin (); it != bucket->end (); it++)
         {
+          Ipv6RoutingTableEntry* j = it->value.first;
+          uint32_t metric = it->value.second;
+
           NS_LOG_LOGIC ("Found global network route " << *j << ", mask length " << maskLen << ", metric " << metric);
 
           /* if interface is given, check the route will output on this interface */
-          if (!interface || interface == m_ipv6->GetNetDevice (j->GetInterface ()))
+          if (interface && interface != m_ipv6->GetNetDevice (j->GetInterface ()))
             {
-              if (maskLen < longestMask)
-                {
-                  NS_LOG_LOGIC ("Previous match longer, skipping");
-                  continue;
-                }
-
-              if (maskLen > longestMask)
-                {
-                  shortestMetric = 0xffffffff;
-                }
-
-              longestMask = maskLen;
-              if (metric > shortestMetric)
-                {
-                  NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
-                  continue;
-                }
-
-              shortestMetric = metric;
-              Ipv6RoutingTableEntry* route = j;
-              uint32_t interfaceIdx = route->GetInterface ();
-              rtentry = Create<Ipv6Route> ();
+              continue;
+            }
+          if (metric > shortestMetric)
+            {
+              NS_LOG_LOGIC ("Equal mask length, but previous metric shorter, skipping");
+              continue;
+            }
 
-              if (route->GetGateway ().IsAny ())
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
-                }
-              else if (route->GetDest ().IsAny ()) /* default route */
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
-                }
-              else
-                {
-                  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
-                }
+          shortestMetric = metric;
+          route = j;
+          if (maskLen == 128)
+            {
+              break;
+            }
+        }
+      if (route)
+        {
+          uint32_t interfaceIdx = route->GetInterface ();
+          rtentry = Create<Ipv6Route> ();
 
-              rtentry->SetDestination (route->GetDest ());
-              rtentry->SetGateway (route->GetGateway ());
-              rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
-              if (maskLen == 128)
-                {
-                  break;
-                }
+          if (route->GetGateway ().IsAny ())
+            {
+              rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetDest ()));
             }
+          else if (route->GetDest ().IsAny ()) /* default route */
+            {
+              rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetPrefixToUse ().IsAny () ? dst : route->GetPrefixToUse ()));
+            }
+          else
+            {
+              rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, route->GetGateway ()));
+            }
+
+          rtentry->SetDestination (route->GetDest ());
+          rtentry->SetGateway (route->GetGateway ());
+          rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
         }
     }
 
@@ -418,6 +435,7 @@ void Ipv6StaticRouting::DoDispose ()
       delete j->first;
     }
   m_networkRoutes.clear ();
+  m_networkRoutesIndex.Clear ();
 
   for (MulticastRoutesI i = m_multicastRoutes.begin (); i != m_multicastRoutes.end (); i = m_multicastRoutes.erase (i))
     {
@@ -566,8 +584,7 @@ void Ipv6StaticRouting::RemoveRoute (uint32_t index)
     {
       if (tmp == index)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          EraseRoute (it);
           return;
         }
       tmp++;
@@ -585,8 +602,7 @@ void Ipv6StaticRouting::RemoveRoute (Ipv6Address network, Ipv6Prefix prefix, uin
       if (network == rtentry->GetDest () && rtentry->GetInterface () == ifIndex
           && rtentry->GetPrefixToUse () == prefixToUse)
         {
-          delete it->first;
-          m_networkRoutes.erase (it);
+          EraseRoute (it);
           return;
         }
     }
@@ -715,8 +731,7 @@ void Ipv6StaticRouting::NotifyInterfaceDown (uint32_t i)
     {
       if (it->first->GetInterface () == i)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseRoute (it);
         }
       else
         {
@@ -752,8 +767,7 @@ void Ipv6StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAd
           && it->first->GetDestNetwork () == networkAddress
           && it->first->GetDestNetworkPrefix () == networkMask)
         {
-          delete it->first;
-          it = m_networkRoutes.erase (it);
+          it = EraseRoute (it);
         }
       else
         {
@@ -800,8 +814,7 @@ void Ipv6StaticRouting::NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv
 
           if (dst == entry && prefix == mask && rtentry->GetInterface () == interface)
             {
-              delete j->first;
-              j = m_networkRoutes.erase (j);
+              j = EraseRoute (j);
             }
           else
             {
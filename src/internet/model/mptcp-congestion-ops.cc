@@ -0,0 +1,467 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "mptcp-congestion-ops.h"
+#include "tcp-socket-state.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpCongestionOps");
+
+void
+MpTcpCoupling::AddSubflow (Ptr<const TcpSocketState> tcb)
+{
+  if (GetSubflow (tcb) != 0)
+    {
+      return;
+    }
+  Subflow subflow;
+  subflow.tcb = tcb;
+  subflow.srtt = Time (0);
+  subflow.bytesSinceLoss = 0;
+  subflow.bytesBetweenLosses = 0;
+  m_subflows.push_back (subflow);
+}
+
+MpTcpCoupling::Subflow *
+MpTcpCoupling::GetSubflow (Ptr<const TcpSocketState> tcb)
+{
+  for (std::vector<Subflow>::iterator it = m_subflows.begin (); it != m_subflows.end (); it++)
+    {
+      if (it->tcb == tcb)
+        {
+          return &(*it);
+        }
+    }
+  return 0;
+}
+
+void
+MpTcpCoupling::RemoveSubflow (Ptr<const TcpSocketState> tcb)
+{
+  for (std::vector<Subflow>::iterator it = m_subflows.begin (); it != m_subflows.end (); it++)
+    {
+      if (it->tcb == tcb)
+        {
+          m_subflows.erase (it);
+          return;
+        }
+    }
+}
+
+std::vector<const MpTcpCoupling::Subflow *>
+MpTcpCoupling::GetActiveSubflows (void) const
+{
+  std::vector<const Subflow *> subflows;
+  for (std::vector<Subflow>::const_iterator it = m_subflows.begin (); it != m_subflows.end (); it++)
+    {
+      if (it->srtt.IsStrictlyPositive ())
+        {
+          subflows.push_back (&(*it));
+        }
+    }
+  return subflows;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpCongestionOps);
+
+TypeId
+MpTcpCongestionOps::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpCongestionOps")
+    .SetParent<TcpNewReno> ()
+    .SetGroupName ("Internet")
+  ;
+  return tid;
+}
+
+MpTcpCongestionOps::MpTcpCongestionOps (void)
+  : TcpNewReno (),
+    m_increase (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpCongestionOps::MpTcpCongestionOps (const MpTcpCongestionOps& sock)
+  : TcpNewReno (sock),
+    m_increase (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpCongestionOps::~MpTcpCongestionOps (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MpTcpCongestionOps::SetCoupling (Ptr<MpTcpCoupling> coupling)
+{
+  NS_LOG_FUNCTION (this << coupling);
+  m_coupling = coupling;
+}
+
+void
+MpTcpCongestionOps::PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                               const Time &rtt)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked << rtt);
+
+  MpTcpCoupling::Subflow *subflow = (m_coupling != 0) ? m_coupling->GetSubflow (tcb) : 0;
+  if (subflow == 0)
+    {
+      return;
+    }
+  subflow->bytesSinceLoss += static_cast<uint64_t> (segmentsAcked) * tcb->m_segmentSize;
+  if (rtt.IsStrictlyPositive ())
+    {
+      // same smoothing as the RFC 6298 estimator
+      subflow->srtt = subflow->srtt.IsZero () ? rtt : (subflow->srtt * 7 + rtt) / 8;
+    }
+}
+
+uint32_t
+MpTcpCongestionOps::GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                 uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+  RecordLoss (tcb);
+  return TcpNewReno::GetSsThresh (tcb, bytesInFlight);
+}
+
+void
+MpTcpCongestionOps::RecordLoss (Ptr<const TcpSocketState> tcb)
+{
+  MpTcpCoupling::Subflow *subflow = (m_coupling != 0) ? m_coupling->GetSubflow (tcb) : 0;
+  if (subflow == 0)
+    {
+      return;
+    }
+  subflow->bytesBetweenLosses = subflow->bytesSinceLoss;
+  subflow->bytesSinceLoss = 0;
+}
+
+void
+MpTcpCongestionOps::CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+  NS_LOG_FUNCTION (this << tcb << segmentsAcked);
+
+  if (m_coupling == 0 || segmentsAcked == 0)
+    {
+      TcpNewReno::CongestionAvoidance (tcb, segmentsAcked);
+      return;
+    }
+
+  const MpTcpCoupling::Subflow *self = m_coupling->GetSubflow (tcb);
+  if (self == 0 || !self->srtt.IsStrictlyPositive ())
+    {
+      TcpNewReno::CongestionAvoidance (tcb, segmentsAcked);
+      return;
+    }
+
+  m_increase += segmentsAcked * GetIncrease (tcb, m_coupling->GetActiveSubflows (), self);
+  int32_t bytes = static_cast<int32_t> (m_increase * tcb->m_segmentSize);
+  if (bytes == 0)
+    {
+      return;
+    }
+  m_increase -= static_cast<double> (bytes) / tcb->m_segmentSize;
+
+  int64_t cWnd = static_cast<int64_t> (tcb->m_cWnd.Get ()) + bytes;
+  tcb->m_cWnd = static_cast<uint32_t> (std::max<int64_t> (cWnd, tcb->m_segmentSize));
+  NS_LOG_INFO ("In CongAvoid, updated to cwnd " << tcb->m_cWnd <<
+               " ssthresh " << tcb->m_ssThresh);
+}
+
+/**
+ * \brief Get the window of a subflow
+ * \param subflow the subflow
+ * \return the window, in segments
+ */
+static double
+GetWindow (const MpTcpCoupling::Subflow *subflow)
+{
+  return static_cast<double> (subflow->tcb->m_cWnd.Get ()) / subflow->tcb->m_segmentSize;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpLia);
+
+TypeId
+MpTcpLia::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpLia")
+    .SetParent<MpTcpCongestionOps> ()
+    .AddConstructor<MpTcpLia> ()
+    .SetGroupName ("Internet")
+  ;
+  return tid;
+}
+
+MpTcpLia::MpTcpLia (void)
+  : MpTcpCongestionOps ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpLia::MpTcpLia (const MpTcpLia& sock)
+  : MpTcpCongestionOps (sock)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpLia::~MpTcpLia (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+MpTcpLia::GetName () const
+{
+  return "MpTcpLia";
+}
+
+Ptr<TcpCongestionOps>
+MpTcpLia::Fork ()
+{
+  return CopyObject<MpTcpLia> (this);
+}
+
+double
+MpTcpLia::GetIncrease (Ptr<const TcpSocketState> tcb,
+                       const std::vector<const MpTcpCoupling::Subflow *> &subflows,
+                       const MpTcpCoupling::Subflow *self) const
+{
+  double total = 0;
+  double best = 0;
+  double sum = 0;
+  for (std::vector<const MpTcpCoupling::Subflow *>::const_iterator it = subflows.begin ();
+       it != subflows.end (); it++)
+    {
+      double w = GetWindow (*it);
+      double rtt = (*it)->srtt.GetSeconds ();
+      total += w;
+      best = std::max (best, w / (rtt * rtt));
+      sum += w / rtt;
+    }
+  double alpha = total * best / (sum * sum);
+  double increase = std::min (alpha / total, 1 / GetWindow (self));
+  NS_LOG_DEBUG ("alpha " << alpha << " increase " << increase);
+  return increase;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpOlia);
+
+TypeId
+MpTcpOlia::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpOlia")
+    .SetParent<MpTcpCongestionOps> ()
+    .AddConstructor<MpTcpOlia> ()
+    .SetGroupName ("Internet")
+  ;
+  return tid;
+}
+
+MpTcpOlia::MpTcpOlia (void)
+  : MpTcpCongestionOps ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpOlia::MpTcpOlia (const MpTcpOlia& sock)
+  : MpTcpCongestionOps (sock)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpOlia::~MpTcpOlia (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+MpTcpOlia::GetName () const
+{
+  return "MpTcpOlia";
+}
+
+Ptr<TcpCongestionOps>
+MpTcpOlia::Fork ()
+{
+  return CopyObject<MpTcpOlia> (this);
+}
+
+double
+MpTcpOlia::GetIncrease (Ptr<const TcpSocketState> tcb,
+                        const std::vector<const MpTcpCoupling::Subflow *> &subflows,
+                        const MpTcpCoupling::Subflow *self) const
+{
+  double sum = 0;
+  uint32_t maxWindow = 0;
+  double bestQuality = 0;
+  for (std::vector<const MpTcpCoupling::Subflow *>::const_iterator it = subflows.begin ();
+       it != subflows.end (); it++)
+    {
+      double rtt = (*it)->srtt.GetSeconds ();
+      double l = static_cast<double> (std::max ((*it)->bytesSinceLoss, (*it)->bytesBetweenLosses));
+      sum += GetWindow (*it) / rtt;
+      maxWindow = std::max (maxWindow, (*it)->tcb->m_cWnd.Get ());
+      bestQuality = std::max (bestQuality, l / (rtt * rtt));
+    }
+
+  // the paths with the largest window, and the best paths which do not have it
+  uint32_t nMax = 0;
+  uint32_t nCollected = 0;
+  bool selfMax = false;
+  bool selfCollected = false;
+  for (std::vector<const MpTcpCoupling::Subflow *>::const_iterator it = subflows.begin ();
+       it != subflows.end (); it++)
+    {
+      double rtt = (*it)->srtt.GetSeconds ();
+      double l = static_cast<double> (std::max ((*it)->bytesSinceLoss, (*it)->bytesBetweenLosses));
+      if ((*it)->tcb->m_cWnd.Get () == maxWindow)
+        {
+          nMax++;
+          selfMax |= (*it == self);
+        }
+      else if (l / (rtt * rtt) >= bestQuality)
+        {
+          nCollected++;
+          selfCollected |= (*it == self);
+        }
+    }
+
+  double alpha = 0;
+  if (nCollected > 0)
+    {
+      double n = static_cast<double> (subflows.size ());
+      if (selfCollected)
+        {
+          alpha = 1 / (n * nCollected);
+        }
+      else if (selfMax)
+        {
+          alpha = -1 / (n * nMax);
+        }
+    }
+
+  double w = GetWindow (self);
+  double rtt = self->srtt.GetSeconds ();
+  double increase = (w / (rtt * rtt)) / (sum * sum) + alpha / w;
+  NS_LOG_DEBUG ("alpha " << alpha << " increase " << increase);
+  return increase;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpBalia);
+
+TypeId
+MpTcpBalia::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpBalia")
+    .SetParent<MpTcpCongestionOps> ()
+    .AddConstructor<MpTcpBalia> ()
+    .SetGroupName ("Internet")
+  ;
+  return tid;
+}
+
+MpTcpBalia::MpTcpBalia (void)
+  : MpTcpCongestionOps ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpBalia::MpTcpBalia (const MpTcpBalia& sock)
+  : MpTcpCongestionOps (sock)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpBalia::~MpTcpBalia (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+std::string
+MpTcpBalia::GetName () const
+{
+  return "MpTcpBalia";
+}
+
+Ptr<TcpCongestionOps>
+MpTcpBalia::Fork ()
+{
+  return CopyObject<MpTcpBalia> (this);
+}
+
+double
+MpTcpBalia::GetIncrease (Ptr<const TcpSocketState> tcb,
+                         const std::vector<const MpTcpCoupling::Subflow *> &subflows,
+                         const MpTcpCoupling::Subflow *self) const
+{
+  double sum = 0;
+  double maxRate = 0;
+  for (std::vector<const MpTcpCoupling::Subflow *>::const_iterator it = subflows.begin ();
+       it != subflows.end (); it++)
+    {
+      double x = GetWindow (*it) / (*it)->srtt.GetSeconds ();
+      sum += x;
+      maxRate = std::max (maxRate, x);
+    }
+
+  double rtt = self->srtt.GetSeconds ();
+  double x = GetWindow (self) / rtt;
+  double alpha = maxRate / x;
+  double increase = x / (rtt * sum * sum) * (1 + alpha) / 2 * (4 + alpha) / 5;
+  NS_LOG_DEBUG ("alpha " << alpha << " increase " << increase);
+  return increase;
+}
+
+uint32_t
+MpTcpBalia::GetSsThresh (Ptr<const TcpSocketState> tcb,
+                         uint32_t bytesInFlight)
+{
+  NS_LOG_FUNCTION (this << tcb << bytesInFlight);
+
+  RecordLoss (tcb);
+  if (m_coupling == 0)
+    {
+      return TcpNewReno::GetSsThresh (tcb, bytesInFlight);
+    }
+
+  std::vector<const MpTcpCoupling::Subflow *> subflows = m_coupling->GetActiveSubflows ();
+  const MpTcpCoupling::Subflow *self = m_coupling->GetSubflow (tcb);
+  if (self == 0 || !self->srtt.IsStrictlyPositive ())
+    {
+      return TcpNewReno::GetSsThresh (tcb, bytesInFlight);
+    }
+
+  double maxRate = 0;
+  for (std::vector<const MpTcpCoupling::Subflow *>::const_iterator it = subflows.begin ();
+       it != subflows.end (); it++)
+    {
+      maxRate = std::max (maxRate, GetWindow (*it) / (*it)->srtt.GetSeconds ());
+    }
+  double alpha = maxRate / (GetWindow (self) / self->srtt.GetSeconds ());
+  double reduction = bytesInFlight / 2.0 * std::min (alpha, 1.5);
+  uint32_t ssThresh = static_cast<uint32_t> (std::max (0.0, bytesInFlight - reduction));
+  return std::max (2 * tcb->m_segmentSize, ssThresh);
+}
+
+} // namespace ns3
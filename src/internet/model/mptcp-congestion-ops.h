@@ -0,0 +1,294 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_CONGESTION_OPS_H
+#define MPTCP_CONGESTION_OPS_H
+
+#include <vector>
+#include "ns3/simple-ref-count.h"
+#include "ns3/nstime.h"
+#include "tcp-congestion-ops.h"
+
+namespace ns3 {
+
+class TcpSocketState;
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief State shared by the coupled congestion controls of the subflows
+ * of a Multipath TCP connection
+ *
+ * Each subflow is identified by its congestion state, and is added the
+ * first time its congestion control needs it.  The smoothed RTT and the
+ * loss intervals are measured here, since the other subflows need them
+ * to compute their increase.
+ */
+class MpTcpCoupling : public SimpleRefCount<MpTcpCoupling>
+{
+public:
+  /**
+   * \brief A subflow of the connection
+   */
+  struct Subflow
+  {
+    Ptr<const TcpSocketState> tcb; //!< Congestion state of the subflow
+    Time srtt;                     //!< Smoothed RTT, zero before the first sample
+    uint64_t bytesSinceLoss;       //!< Bytes acked since the last loss
+    uint64_t bytesBetweenLosses;   //!< Bytes acked between the last two losses
+  };
+
+  /**
+   * \brief Add a subflow
+   * \param tcb the congestion state of the subflow
+   */
+  void AddSubflow (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief Get a subflow
+   *
+   * A subflow which was never added, or was removed, is not coupled: an ACK
+   * it receives once it is closed does not bring it back.
+   *
+   * \param tcb the congestion state of the subflow
+   * \return the subflow, or 0 if it is not one of the coupled subflows
+   */
+  Subflow * GetSubflow (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief Remove a subflow, when it is closed
+   * \param tcb the congestion state of the subflow
+   */
+  void RemoveSubflow (Ptr<const TcpSocketState> tcb);
+
+  /**
+   * \brief Get the subflows with an RTT estimate
+   *
+   * Only they take part in the coupling.
+   *
+   * \return the subflows
+   */
+  std::vector<const Subflow *> GetActiveSubflows (void) const;
+
+private:
+  std::vector<Subflow> m_subflows; //!< The subflows
+};
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Base class of the coupled congestion controls of Multipath TCP
+ *
+ * The subflows of a connection share an MpTcpCoupling, set by the
+ * meta-socket.  Slow start and the window reduction are the ones of
+ * NewReno, and the congestion avoidance increases the window, on each
+ * acknowledged segment, by the amount returned by GetIncrease, in segments.
+ * The fractional part of the increase is carried over between ACKs.
+ *
+ * Without a coupling, when the subflow is not one of its subflows, or as
+ * long as the RTT of the subflow is unknown, the subflow behaves as
+ * NewReno; with a single subflow, the coupled algorithms give the NewReno
+ * increase too.
+ */
+class MpTcpCongestionOps : public TcpNewReno
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpCongestionOps (void);
+
+  /**
+   * \brief Copy constructor
+   *
+   * The coupling is not copied: forked subflows are coupled by their
+   * meta-socket.
+   *
+   * \param sock the object to copy
+   */
+  MpTcpCongestionOps (const MpTcpCongestionOps& sock);
+  virtual ~MpTcpCongestionOps (void);
+
+  /**
+   * \brief Set the state shared with the other subflows
+   * \param coupling the coupling
+   */
+  void SetCoupling (Ptr<MpTcpCoupling> coupling);
+
+  virtual void PktsAcked (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked,
+                          const Time &rtt);
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                uint32_t bytesInFlight);
+
+protected:
+  virtual void CongestionAvoidance (Ptr<TcpSocketState> tcb, uint32_t segmentsAcked);
+
+  /**
+   * \brief Get the window increase for an acknowledged segment
+   *
+   * \param tcb the congestion state of the subflow
+   * \param subflows the subflows with an RTT estimate, including this one
+   * \param self the entry of this subflow
+   * \return the increase, in segments (possibly negative)
+   */
+  virtual double GetIncrease (Ptr<const TcpSocketState> tcb,
+                              const std::vector<const MpTcpCoupling::Subflow *> &subflows,
+                              const MpTcpCoupling::Subflow *self) const = 0;
+
+  /**
+   * \brief Record a loss in the coupling
+   * \param tcb the congestion state of the subflow
+   */
+  void RecordLoss (Ptr<const TcpSocketState> tcb);
+
+  Ptr<MpTcpCoupling> m_coupling; //!< State shared with the other subflows
+
+private:
+  double m_increase; //!< Fraction of segment of window increase not applied yet
+};
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Linked Increases Algorithm (RFC 6356)
+ *
+ * The increase for an acknowledged segment on the subflow i is
+ *
+ *         min (alpha / w_total, 1 / w_i)
+ *
+ * with alpha = w_total * max (w_j / rtt_j^2) / (sum (w_j / rtt_j))^2, so
+ * that the connection is not more aggressive than a single TCP flow on the
+ * best path.
+ */
+class MpTcpLia : public MpTcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpLia (void);
+
+  /**
+   * \brief Copy constructor
+   * \param sock the object to copy
+   */
+  MpTcpLia (const MpTcpLia& sock);
+  virtual ~MpTcpLia (void);
+
+  virtual std::string GetName () const;
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+protected:
+  virtual double GetIncrease (Ptr<const TcpSocketState> tcb,
+                              const std::vector<const MpTcpCoupling::Subflow *> &subflows,
+                              const MpTcpCoupling::Subflow *self) const;
+};
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Opportunistic Linked Increases Algorithm
+ *
+ * The increase for an acknowledged segment on the subflow r is
+ *
+ *         (w_r / rtt_r^2) / (sum (w_p / rtt_p))^2 + alpha_r / w_r
+ *
+ * where alpha_r moves window from the paths with the largest window to the
+ * best paths (largest l_r / rtt_r^2, l_r being the bytes acked between
+ * losses) which do not have the largest window yet.
+ *
+ * More information: R. Khalili et al., "MPTCP is not Pareto-optimal:
+ * performance issues and a possible solution", IEEE/ACM ToN, 2013.
+ */
+class MpTcpOlia : public MpTcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpOlia (void);
+
+  /**
+   * \brief Copy constructor
+   * \param sock the object to copy
+   */
+  MpTcpOlia (const MpTcpOlia& sock);
+  virtual ~MpTcpOlia (void);
+
+  virtual std::string GetName () const;
+  virtual Ptr<TcpCongestionOps> Fork ();
+
+protected:
+  virtual double GetIncrease (Ptr<const TcpSocketState> tcb,
+                              const std::vector<const MpTcpCoupling::Subflow *> &subflows,
+                              const MpTcpCoupling::Subflow *self) const;
+};
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Balanced Linked Adaptation
+ *
+ * With x_r = w_r / rtt_r and alpha_r = max (x_k) / x_r, the increase for an
+ * acknowledged segment on the subflow r is
+ *
+ *         x_r / (rtt_r * (sum (x_k))^2) * (1 + alpha_r) / 2 * (4 + alpha_r) / 5
+ *
+ * and, on a loss, the window is reduced by w_r / 2 * min (alpha_r, 1.5).
+ *
+ * More information: Q. Peng et al., "Multipath TCP: Analysis, Design, and
+ * Implementation", IEEE/ACM ToN, 2016.
+ */
+class MpTcpBalia : public MpTcpCongestionOps
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpBalia (void);
+
+  /**
+   * \brief Copy constructor
+   * \param sock the object to copy
+   */
+  MpTcpBalia (const MpTcpBalia& sock);
+  virtual ~MpTcpBalia (void);
+
+  virtual std::string GetName () const;
+  virtual Ptr<TcpCongestionOps> Fork ();
+  virtual uint32_t GetSsThresh (Ptr<const TcpSocketState> tcb,
+                                uint32_t bytesInFlight);
+
+protected:
+  virtual double GetIncrease (Ptr<const TcpSocketState> tcb,
+                              const std::vector<const MpTcpCoupling::Subflow *> &subflows,
+                              const MpTcpCoupling::Subflow *self) const;
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_CONGESTION_OPS_H */
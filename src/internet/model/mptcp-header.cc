@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-header.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpHeader");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpHeader);
+
+MpTcpHeader::MpTcpHeader ()
+  : m_kind (DSS),
+    m_token (0),
+    m_dataSequence (0),
+    m_dataLength (0)
+{
+}
+
+MpTcpHeader::~MpTcpHeader ()
+{
+}
+
+TypeId
+MpTcpHeader::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpHeader")
+    .SetParent<Header> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpHeader> ()
+  ;
+  return tid;
+}
+
+TypeId
+MpTcpHeader::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+void
+MpTcpHeader::Print (std::ostream &os) const
+{
+  switch (m_kind)
+    {
+    case MP_CAPABLE:
+      os << "MP_CAPABLE token=" << m_token;
+      break;
+    case MP_JOIN:
+      os << "MP_JOIN token=" << m_token;
+      break;
+    case DSS:
+      os << "DSS seq=" << m_dataSequence << " length=" << m_dataLength;
+      break;
+    }
+}
+
+uint32_t
+MpTcpHeader::GetSerializedSize (uint8_t kind)
+{
+  switch (kind)
+    {
+    case MP_CAPABLE:
+    case MP_JOIN:
+      return 5;
+    case DSS:
+      return 11;
+    default:
+      return 0;
+    }
+}
+
+uint32_t
+MpTcpHeader::GetSerializedSize (void) const
+{
+  return GetSerializedSize (static_cast<uint8_t> (m_kind));
+}
+
+void
+MpTcpHeader::Serialize (Buffer::Iterator start) const
+{
+  Buffer::Iterator i = start;
+  i.WriteU8 (m_kind);
+  if (m_kind == DSS)
+    {
+      i.WriteHtonU64 (m_dataSequence);
+      i.WriteHtonU16 (m_dataLength);
+    }
+  else
+    {
+      i.WriteHtonU32 (m_token);
+    }
+}
+
+uint32_t
+MpTcpHeader::Deserialize (Buffer::Iterator start)
+{
+  Buffer::Iterator i = start;
+  uint8_t kind = i.ReadU8 ();
+  if (GetSerializedSize (kind) == 0)
+    {
+      NS_LOG_WARN ("Unknown MPTCP header kind " << static_cast<uint32_t> (kind));
+      return 0;
+    }
+  m_kind = static_cast<Kind> (kind);
+  if (m_kind == DSS)
+    {
+      m_dataSequence = i.ReadNtohU64 ();
+      m_dataLength = i.ReadNtohU16 ();
+    }
+  else
+    {
+      m_token = i.ReadNtohU32 ();
+    }
+  return GetSerializedSize ();
+}
+
+void
+MpTcpHeader::SetKind (Kind kind)
+{
+  m_kind = kind;
+}
+
+MpTcpHeader::Kind
+MpTcpHeader::GetKind (void) const
+{
+  return m_kind;
+}
+
+void
+MpTcpHeader::SetToken (uint32_t token)
+{
+  m_token = token;
+}
+
+uint32_t
+MpTcpHeader::GetToken (void) const
+{
+  return m_token;
+}
+
+void
+MpTcpHeader::SetDataSequence (uint64_t sequence)
+{
+  m_dataSequence = sequence;
+}
+
+uint64_t
+MpTcpHeader::GetDataSequence (void) const
+{
+  return m_dataSequence;
+}
+
+void
+MpTcpHeader::SetDataLength (uint16_t length)
+{
+  m_dataLength = length;
+}
+
+uint16_t
+MpTcpHeader::GetDataLength (void) const
+{
+  return m_dataLength;
+}
+
+} // namespace ns3
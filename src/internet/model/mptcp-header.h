@@ -0,0 +1,117 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_HEADER_H
+#define MPTCP_HEADER_H
+
+#include "ns3/header.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Multipath TCP signalling, carried in the byte stream of the subflows
+ *
+ * The first bytes sent by the client on a subflow are an MP_CAPABLE
+ * header, for the first subflow of a connection, or an MP_JOIN header,
+ * with the token of the connection.  Then, the data of the connection is
+ * sent as a sequence of DSS headers, each followed by the bytes it maps
+ * to the data sequence space of the connection.
+ *
+ * The kinds are numbered as the subtypes of RFC 8684, but the headers are
+ * not TCP options: they are parsed by the meta-socket, and the subflows
+ * only see a byte stream.
+ */
+class MpTcpHeader : public Header
+{
+public:
+  /**
+   * \brief The kinds of header
+   */
+  enum Kind
+  {
+    MP_CAPABLE = 0, //!< First subflow of a connection
+    MP_JOIN = 1,    //!< Additional subflow of a connection
+    DSS = 2         //!< Data sequence mapping
+  };
+
+  MpTcpHeader ();
+  virtual ~MpTcpHeader ();
+
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual void Print (std::ostream &os) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (Buffer::Iterator start) const;
+  virtual uint32_t Deserialize (Buffer::Iterator start);
+
+  /**
+   * \brief Get the size of a header from its first byte
+   * \param kind the kind, as serialized
+   * \return the serialized size, or 0 if the kind is unknown
+   */
+  static uint32_t GetSerializedSize (uint8_t kind);
+
+  /**
+   * \param kind the kind of header
+   */
+  void SetKind (Kind kind);
+  /**
+   * \return the kind of header
+   */
+  Kind GetKind (void) const;
+
+  /**
+   * \param token the token of the connection (MP_CAPABLE and MP_JOIN)
+   */
+  void SetToken (uint32_t token);
+  /**
+   * \return the token of the connection
+   */
+  uint32_t GetToken (void) const;
+
+  /**
+   * \param sequence the data sequence number of the first mapped byte (DSS)
+   */
+  void SetDataSequence (uint64_t sequence);
+  /**
+   * \return the data sequence number of the first mapped byte
+   */
+  uint64_t GetDataSequence (void) const;
+
+  /**
+   * \param length the number of bytes which follow the header (DSS)
+   */
+  void SetDataLength (uint16_t length);
+  /**
+   * \return the number of bytes which follow the header
+   */
+  uint16_t GetDataLength (void) const;
+
+private:
+  Kind m_kind;             //!< Kind of header
+  uint32_t m_token;        //!< Token of the connection
+  uint64_t m_dataSequence; //!< Data sequence number of the first mapped byte
+  uint16_t m_dataLength;   //!< Number of mapped bytes
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_HEADER_H */
@@ -0,0 +1,153 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-scheduler.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpScheduler);
+
+TypeId
+MpTcpScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpScheduler")
+    .SetParent<Object> ()
+    .SetGroupName ("Internet")
+  ;
+  return tid;
+}
+
+MpTcpScheduler::MpTcpScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpScheduler::~MpTcpScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MpTcpScheduler::RemoveSubflow (Ptr<MpTcpSubflow> subflow)
+{
+  NS_LOG_FUNCTION (this << subflow);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSchedulerMinRtt);
+
+TypeId
+MpTcpSchedulerMinRtt::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpSchedulerMinRtt")
+    .SetParent<MpTcpScheduler> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpSchedulerMinRtt> ()
+  ;
+  return tid;
+}
+
+std::vector<Ptr<MpTcpSubflow> >
+MpTcpSchedulerMinRtt::SelectSubflows (const std::vector<Ptr<MpTcpSubflow> > &subflows)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<MpTcpSubflow> best = subflows.front ();
+  for (std::vector<Ptr<MpTcpSubflow> >::const_iterator it = subflows.begin (); it != subflows.end (); it++)
+    {
+      if ((*it)->GetSrtt () < best->GetSrtt ())
+        {
+          best = *it;
+        }
+    }
+  return std::vector<Ptr<MpTcpSubflow> > (1, best);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSchedulerRoundRobin);
+
+TypeId
+MpTcpSchedulerRoundRobin::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpSchedulerRoundRobin")
+    .SetParent<MpTcpScheduler> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpSchedulerRoundRobin> ()
+  ;
+  return tid;
+}
+
+MpTcpSchedulerRoundRobin::MpTcpSchedulerRoundRobin ()
+  : m_chunks (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MpTcpSchedulerRoundRobin::DoDispose (void)
+{
+  m_lastUse.clear ();
+  MpTcpScheduler::DoDispose ();
+}
+
+std::vector<Ptr<MpTcpSubflow> >
+MpTcpSchedulerRoundRobin::SelectSubflows (const std::vector<Ptr<MpTcpSubflow> > &subflows)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<MpTcpSubflow> next;
+  uint64_t nextUse = 0;
+  for (std::vector<Ptr<MpTcpSubflow> >::const_iterator it = subflows.begin (); it != subflows.end (); it++)
+    {
+      // the subflows never used yet have a last use of 0
+      uint64_t lastUse = m_lastUse[*it];
+      if (next == 0 || lastUse < nextUse)
+        {
+          next = *it;
+          nextUse = lastUse;
+        }
+    }
+  m_lastUse[next] = ++m_chunks;
+  return std::vector<Ptr<MpTcpSubflow> > (1, next);
+}
+
+void
+MpTcpSchedulerRoundRobin::RemoveSubflow (Ptr<MpTcpSubflow> subflow)
+{
+  NS_LOG_FUNCTION (this << subflow);
+  m_lastUse.erase (subflow);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSchedulerRedundant);
+
+TypeId
+MpTcpSchedulerRedundant::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpSchedulerRedundant")
+    .SetParent<MpTcpScheduler> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpSchedulerRedundant> ()
+  ;
+  return tid;
+}
+
+std::vector<Ptr<MpTcpSubflow> >
+MpTcpSchedulerRedundant::SelectSubflows (const std::vector<Ptr<MpTcpSubflow> > &subflows)
+{
+  NS_LOG_FUNCTION (this);
+  return subflows;
+}
+
+} // namespace ns3
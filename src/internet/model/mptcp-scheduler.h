@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_SCHEDULER_H
+#define MPTCP_SCHEDULER_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "mptcp-subflow.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Packet scheduler of a Multipath TCP connection
+ *
+ * The meta-socket cuts the data of the application in chunks of about one
+ * segment, and asks the scheduler on which subflows each chunk is sent.
+ * It only offers the established subflows which have room in their
+ * congestion window, so a chunk is never queued behind a full window.
+ */
+class MpTcpScheduler : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpScheduler ();
+  virtual ~MpTcpScheduler ();
+
+  /**
+   * \brief Select the subflows on which the next chunk is sent
+   * \param subflows the available subflows, not empty
+   * \return the selected subflows, empty to wait for another opportunity
+   */
+  virtual std::vector<Ptr<MpTcpSubflow> > SelectSubflows (const std::vector<Ptr<MpTcpSubflow> > &subflows) = 0;
+
+  /**
+   * \brief Forget a subflow, once it is closed
+   *
+   * The default implementation does nothing.
+   *
+   * \param subflow the subflow
+   */
+  virtual void RemoveSubflow (Ptr<MpTcpSubflow> subflow);
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Send each chunk on the available subflow with the lowest RTT
+ *
+ * This is the default scheduler of the Linux implementation: the fast
+ * subflow is filled first, and the slower ones only carry data once its
+ * window is full.
+ */
+class MpTcpSchedulerMinRtt : public MpTcpScheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual std::vector<Ptr<MpTcpSubflow> > SelectSubflows (const std::vector<Ptr<MpTcpSubflow> > &subflows);
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Send each chunk on the available subflow which was least recently used
+ */
+class MpTcpSchedulerRoundRobin : public MpTcpScheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpSchedulerRoundRobin ();
+
+  virtual std::vector<Ptr<MpTcpSubflow> > SelectSubflows (const std::vector<Ptr<MpTcpSubflow> > &subflows);
+  virtual void RemoveSubflow (Ptr<MpTcpSubflow> subflow);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  uint64_t m_chunks;                              //!< Number of chunks scheduled
+  std::map<Ptr<MpTcpSubflow>, uint64_t> m_lastUse; //!< Chunk number of the last use of each subflow
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Send each chunk on all the available subflows
+ *
+ * The receiver keeps the first copy of each byte, so the latency is the
+ * one of the fastest subflow, at the cost of the capacity of the others.
+ */
+class MpTcpSchedulerRedundant : public MpTcpScheduler
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  virtual std::vector<Ptr<MpTcpSubflow> > SelectSubflows (const std::vector<Ptr<MpTcpSubflow> > &subflows);
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SCHEDULER_H */
@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "mptcp-socket-factory.h"
+#include "mptcp-socket.h"
+#include "tcp-l4-protocol.h"
+#include "ns3/node.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSocketFactory);
+
+TypeId
+MpTcpSocketFactory::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpSocketFactory")
+    .SetParent<SocketFactory> ()
+    .SetGroupName ("Internet")
+  ;
+  return tid;
+}
+
+MpTcpSocketFactory::MpTcpSocketFactory ()
+  : m_tcp (0)
+{
+  m_tokens = CreateObject<UniformRandomVariable> ();
+}
+
+MpTcpSocketFactory::~MpTcpSocketFactory ()
+{
+  NS_ASSERT (m_tcp == 0);
+}
+
+void
+MpTcpSocketFactory::SetTcp (Ptr<TcpL4Protocol> tcp)
+{
+  m_tcp = tcp;
+}
+
+Ptr<Socket>
+MpTcpSocketFactory::CreateSocket (void)
+{
+  Ptr<MpTcpSocket> socket = CreateObject<MpTcpSocket> ();
+  socket->SetNode (m_tcp->GetObject<Node> ());
+  socket->SetTcp (m_tcp);
+  socket->SetTokenVariable (m_tokens);
+  return socket;
+}
+
+int64_t
+MpTcpSocketFactory::AssignStreams (int64_t stream)
+{
+  m_tokens->SetStream (stream);
+  return 1;
+}
+
+void
+MpTcpSocketFactory::DoDispose (void)
+{
+  m_tcp = 0;
+  m_tokens = 0;
+  SocketFactory::DoDispose ();
+}
+
+} // namespace ns3
@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_SOCKET_FACTORY_H
+#define MPTCP_SOCKET_FACTORY_H
+
+#include "ns3/socket-factory.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class TcpL4Protocol;
+class UniformRandomVariable;
+
+/**
+ * \ingroup socket
+ * \ingroup tcp
+ *
+ * \brief API to create Multipath TCP socket instances
+ *
+ * This class is aggregated to the nodes with TCP, and creates sockets of
+ * the MpTcpSocket type.  The tokens of the connections opened by these
+ * sockets are drawn from a random variable of the factory.
+ */
+class MpTcpSocketFactory : public SocketFactory
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpSocketFactory ();
+  virtual ~MpTcpSocketFactory ();
+
+  /**
+   * \brief Set the associated TCP L4 protocol.
+   * \param tcp the TCP L4 protocol
+   */
+  void SetTcp (Ptr<TcpL4Protocol> tcp);
+
+  virtual Ptr<Socket> CreateSocket (void);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  virtual void DoDispose (void);
+private:
+  Ptr<TcpL4Protocol> m_tcp; //!< the associated TCP L4 protocol
+  Ptr<UniformRandomVariable> m_tokens; //!< the random variable of the tokens
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SOCKET_FACTORY_H */
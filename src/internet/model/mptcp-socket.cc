@@ -0,0 +1,1236 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include "mptcp-socket.h"
+#include "mptcp-header.h"
+#include "tcp-l4-protocol.h"
+#include "tcp-recovery-ops.h"
+#include "rtt-estimator.h"
+#include "ipv4.h"
+#include "ipv6.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/object-factory.h"
+#include "ns3/random-variable-stream.h"
+#include "tcp-tx-buffer.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpSocket");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSocket);
+
+TypeId
+MpTcpSocket::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpSocket")
+    .SetParent<Socket> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpSocket> ()
+    .AddAttribute ("Scheduler",
+                   "Type of the scheduler of the connection.",
+                   TypeIdValue (MpTcpSchedulerMinRtt::GetTypeId ()),
+                   MakeTypeIdAccessor (&MpTcpSocket::m_schedulerTypeId),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("CongestionControl",
+                   "Type of the congestion control of the subflows.",
+                   TypeIdValue (MpTcpLia::GetTypeId ()),
+                   MakeTypeIdAccessor (&MpTcpSocket::m_congestionTypeId),
+                   MakeTypeIdChecker ())
+    .AddAttribute ("SndBufSize",
+                   "Size of the send buffer of the connection, in bytes.",
+                   UintegerValue (131072),
+                   MakeUintegerAccessor (&MpTcpSocket::m_sndBufSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("RcvBufSize",
+                   "Size of the receive buffer of the connection and of its subflows, in bytes. "
+                   "It limits the data in flight on all the subflows together, so it must cover "
+                   "the largest round-trip time of the subflows at their combined rate.",
+                   UintegerValue (262144),
+                   MakeUintegerAccessor (&MpTcpSocket::m_rcvBufSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("MaxSubflows",
+                   "Maximum number of subflows of a connection.",
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&MpTcpSocket::m_maxSubflows),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("FullMesh",
+                   "Open a subflow from each local address, once the first one is established.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MpTcpSocket::m_fullMesh),
+                   MakeBooleanChecker ())
+    .AddTraceSource ("SubflowAdded",
+                     "A subflow is added to the connection.",
+                     MakeTraceSourceAccessor (&MpTcpSocket::m_subflowAddedTrace),
+                     "ns3::MpTcpSocket::SubflowTracedCallback")
+  ;
+  return tid;
+}
+
+MpTcpSocket::MpTcpSocket (void)
+  : m_sndBufSize (131072),
+    m_rcvBufSize (262144),
+    m_maxSubflows (8),
+    m_fullMesh (true),
+    m_errno (ERROR_NOTERROR),
+    m_coupling (Create<MpTcpCoupling> ()),
+    m_token (0),
+    m_bound (false),
+    m_connected (false),
+    m_closeOnEmpty (false),
+    m_shutdownSend (false),
+    m_shutdownRecv (false),
+    m_closeNotified (false),
+    m_sending (false),
+    m_txSize (0),
+    m_txSequence (0),
+    m_rxSize (0),
+    m_rxSequence (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpSocket::~MpTcpSocket (void)
+{
+  NS_LOG_FUNCTION (this);
+  ClearSubflows ();
+}
+
+void
+MpTcpSocket::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sendPendingEvent.Cancel ();
+  ClearSubflows ();
+  m_connections.clear ();
+  m_connectionClosed = MakeNullCallback<void, uint32_t> ();
+  m_scheduler = 0;
+  m_tokens = 0;
+  m_txData.clear ();
+  m_reinject.clear ();
+  m_rxData.clear ();
+  m_rxOutOfOrder.clear ();
+  m_node = 0;
+  m_tcp = 0;
+  Socket::DoDispose ();
+}
+
+void
+MpTcpSocket::ClearSubflows (void)
+{
+  for (std::vector<Subflow>::iterator it = m_subflows.begin (); it != m_subflows.end (); it++)
+    {
+      it->socket->SetConnectCallback (MakeNullCallback<void, Ptr<Socket> > (),
+                                      MakeNullCallback<void, Ptr<Socket> > ());
+      it->socket->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket> > (),
+                                     MakeNullCallback<void, Ptr<Socket> > ());
+      it->socket->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+      it->socket->SetSendCallback (MakeNullCallback<void, Ptr<Socket>, uint32_t> ());
+    }
+  m_subflows.clear ();
+  for (std::map<Ptr<MpTcpSubflow>, PendingSubflow>::iterator it = m_pending.begin (); it != m_pending.end (); it++)
+    {
+      it->first->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket> > (),
+                                    MakeNullCallback<void, Ptr<Socket> > ());
+      it->first->SetRecvCallback (MakeNullCallback<void, Ptr<Socket> > ());
+    }
+  m_pending.clear ();
+  if (m_listener != 0)
+    {
+      m_listener->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                                     MakeNullCallback<void, Ptr<Socket>, const Address &> ());
+      m_listener = 0;
+    }
+  for (std::map<uint32_t, Ptr<MpTcpSocket> >::iterator it = m_connections.begin (); it != m_connections.end (); it++)
+    {
+      it->second->m_connectionClosed = MakeNullCallback<void, uint32_t> ();
+    }
+}
+
+void
+MpTcpSocket::SetNode (Ptr<Node> node)
+{
+  m_node = node;
+}
+
+void
+MpTcpSocket::SetTcp (Ptr<TcpL4Protocol> tcp)
+{
+  m_tcp = tcp;
+}
+
+void
+MpTcpSocket::SetTokenVariable (Ptr<UniformRandomVariable> tokens)
+{
+  m_tokens = tokens;
+}
+
+uint32_t
+MpTcpSocket::GetNSubflows (void) const
+{
+  return m_subflows.size ();
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocket::GetSubflow (uint32_t i) const
+{
+  NS_ASSERT (i < m_subflows.size ());
+  return m_subflows[i].socket;
+}
+
+enum Socket::SocketErrno
+MpTcpSocket::GetErrno (void) const
+{
+  return m_errno;
+}
+
+enum Socket::SocketType
+MpTcpSocket::GetSocketType (void) const
+{
+  return NS3_SOCK_STREAM;
+}
+
+Ptr<Node>
+MpTcpSocket::GetNode (void) const
+{
+  return m_node;
+}
+
+int
+MpTcpSocket::Bind (void)
+{
+  NS_LOG_FUNCTION (this);
+  return Bind (InetSocketAddress (Ipv4Address::GetAny (), 0));
+}
+
+int
+MpTcpSocket::Bind6 (void)
+{
+  NS_LOG_FUNCTION (this);
+  return Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 0));
+}
+
+int
+MpTcpSocket::Bind (const Address &address)
+{
+  NS_LOG_FUNCTION (this << address);
+  if (!InetSocketAddress::IsMatchingType (address) && !Inet6SocketAddress::IsMatchingType (address))
+    {
+      m_errno = ERROR_INVAL;
+      return -1;
+    }
+  if (m_bound || !m_subflows.empty ())
+    {
+      m_errno = ERROR_INVAL;
+      return -1;
+    }
+  // the subflows are bound when they are opened
+  m_localAddress = address;
+  m_bound = true;
+  return 0;
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocket::CreateSubflow (void)
+{
+  NS_LOG_FUNCTION (this);
+  TypeIdValue rttTypeId;
+  TypeIdValue recoveryTypeId;
+  m_tcp->GetAttribute ("RttEstimatorType", rttTypeId);
+  m_tcp->GetAttribute ("RecoveryType", recoveryTypeId);
+  ObjectFactory rttFactory;
+  ObjectFactory congestionAlgorithmFactory;
+  ObjectFactory recoveryAlgorithmFactory;
+  rttFactory.SetTypeId (rttTypeId.Get ());
+  congestionAlgorithmFactory.SetTypeId (m_congestionTypeId);
+  recoveryAlgorithmFactory.SetTypeId (recoveryTypeId.Get ());
+
+  Ptr<MpTcpSubflow> subflow = CreateObject<MpTcpSubflow> ();
+  // the subflows advertise the receive window of the connection
+  subflow->SetAttribute ("RcvBufSize", UintegerValue (m_rcvBufSize));
+  subflow->SetNode (m_node);
+  subflow->SetTcp (m_tcp);
+  subflow->SetRtt (rttFactory.Create<RttEstimator> ());
+  subflow->SetCongestionControlAlgorithm (congestionAlgorithmFactory.Create<TcpCongestionOps> ());
+  subflow->SetRecoveryAlgorithm (recoveryAlgorithmFactory.Create<TcpRecoveryOps> ());
+  m_tcp->AddSocket (subflow);
+  return subflow;
+}
+
+void
+MpTcpSocket::AddSubflow (Ptr<MpTcpSubflow> subflow, bool ready)
+{
+  NS_LOG_FUNCTION (this << subflow << ready);
+  Ptr<MpTcpCongestionOps> congestion = DynamicCast<MpTcpCongestionOps> (subflow->GetCongestionControl ());
+  if (congestion != 0)
+    {
+      congestion->SetCoupling (m_coupling);
+    }
+  m_coupling->AddSubflow (subflow->GetTcb ());
+  subflow->SetConnectCallback (MakeCallback (&MpTcpSocket::SubflowConnected, this),
+                               MakeCallback (&MpTcpSocket::SubflowConnectionFailed, this));
+  subflow->SetCloseCallbacks (MakeCallback (&MpTcpSocket::SubflowNormalClose, this),
+                              MakeCallback (&MpTcpSocket::SubflowErrorClose, this));
+  subflow->SetRecvCallback (MakeCallback (&MpTcpSocket::SubflowRecv, this));
+  subflow->SetSendCallback (MakeCallback (&MpTcpSocket::SubflowSend, this));
+
+  Subflow entry;
+  entry.socket = subflow;
+  entry.ready = ready;
+  entry.closed = false;
+  entry.rxData = Create<Packet> ();
+  entry.mappingSequence = 0;
+  entry.mappingLength = 0;
+  m_subflows.push_back (entry);
+  m_subflowAddedTrace (subflow);
+}
+
+MpTcpSocket::Subflow *
+MpTcpSocket::FindSubflow (Ptr<Socket> socket)
+{
+  for (std::vector<Subflow>::iterator it = m_subflows.begin (); it != m_subflows.end (); it++)
+    {
+      if (it->socket == socket)
+        {
+          return &(*it);
+        }
+    }
+  return 0;
+}
+
+int
+MpTcpSocket::Connect (const Address &address)
+{
+  NS_LOG_FUNCTION (this << address);
+  if (!m_subflows.empty () || m_listener != 0)
+    {
+      m_errno = ERROR_ISCONN;
+      return -1;
+    }
+
+  if (m_tokens == 0)
+    {
+      m_tokens = CreateObject<UniformRandomVariable> ();
+    }
+  m_token = m_tokens->GetInteger (1, std::numeric_limits<uint32_t>::max ());
+  m_peerAddress = address;
+
+  Ptr<MpTcpSubflow> subflow = CreateSubflow ();
+  int result;
+  if (m_bound)
+    {
+      result = subflow->Bind (m_localAddress);
+    }
+  else if (Inet6SocketAddress::IsMatchingType (address))
+    {
+      result = subflow->Bind6 ();
+    }
+  else
+    {
+      result = subflow->Bind ();
+    }
+  if (result == 0)
+    {
+      AddSubflow (subflow, false);
+      result = subflow->Connect (address);
+    }
+  if (result != 0)
+    {
+      m_errno = subflow->GetErrno ();
+      ClearSubflows ();
+    }
+  return result;
+}
+
+void
+MpTcpSocket::OpenSubflows (void)
+{
+  NS_LOG_FUNCTION (this);
+  Address first;
+  m_subflows.front ().socket->GetSockName (first);
+
+  if (InetSocketAddress::IsMatchingType (first))
+    {
+      Ipv4Address firstAddress = InetSocketAddress::ConvertFrom (first).GetIpv4 ();
+      Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4> ();
+      for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+        {
+          if (!ipv4->IsUp (i))
+            {
+              continue;
+            }
+          for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+            {
+              Ipv4Address address = ipv4->GetAddress (i, j).GetLocal ();
+              if (!address.IsLocalhost () && address != firstAddress)
+                {
+                  OpenSubflow (InetSocketAddress (address, 0), ipv4->GetNetDevice (i));
+                }
+            }
+        }
+    }
+  else
+    {
+      Ipv6Address firstAddress = Inet6SocketAddress::ConvertFrom (first).GetIpv6 ();
+      Ptr<Ipv6> ipv6 = m_node->GetObject<Ipv6> ();
+      for (uint32_t i = 0; i < ipv6->GetNInterfaces (); i++)
+        {
+          if (!ipv6->IsUp (i))
+            {
+              continue;
+            }
+          for (uint32_t j = 0; j < ipv6->GetNAddresses (i); j++)
+            {
+              Ipv6InterfaceAddress address = ipv6->GetAddress (i, j);
+              if (address.GetScope () == Ipv6InterfaceAddress::GLOBAL && address.GetAddress () != firstAddress)
+                {
+                  OpenSubflow (Inet6SocketAddress (address.GetAddress (), 0), ipv6->GetNetDevice (i));
+                }
+            }
+        }
+    }
+}
+
+void
+MpTcpSocket::OpenSubflow (const Address &local, Ptr<NetDevice> device)
+{
+  NS_LOG_FUNCTION (this << local << device);
+  if (m_subflows.size () >= m_maxSubflows)
+    {
+      return;
+    }
+  Ptr<MpTcpSubflow> subflow = CreateSubflow ();
+  if (subflow->Bind (local) != 0)
+    {
+      NS_LOG_WARN ("Cannot bind a subflow to " << local);
+      return;
+    }
+  subflow->BindToNetDevice (device);
+  AddSubflow (subflow, false);
+  if (subflow->Connect (m_peerAddress) != 0)
+    {
+      NS_LOG_WARN ("Cannot connect a subflow from " << local);
+      m_subflows.back ().closed = true;
+    }
+}
+
+int
+MpTcpSocket::Listen (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_subflows.empty () || m_listener != 0)
+    {
+      m_errno = ERROR_INVAL;
+      return -1;
+    }
+  if (!m_bound)
+    {
+      Bind ();
+    }
+  m_listener = CreateSubflow ();
+  int result = m_listener->Bind (m_localAddress);
+  if (result == 0)
+    {
+      m_listener->SetAcceptCallback (MakeCallback (&MpTcpSocket::SubflowConnectionRequest, this),
+                                     MakeCallback (&MpTcpSocket::SubflowAccepted, this));
+      result = m_listener->Listen ();
+    }
+  if (result != 0)
+    {
+      m_errno = m_listener->GetErrno ();
+      m_listener = 0;
+    }
+  return result;
+}
+
+Ptr<MpTcpSocket>
+MpTcpSocket::CreateConnection (uint32_t token)
+{
+  NS_LOG_FUNCTION (this << token);
+  Ptr<MpTcpSocket> connection = CreateObject<MpTcpSocket> ();
+  connection->SetNode (m_node);
+  connection->SetTcp (m_tcp);
+  connection->m_schedulerTypeId = m_schedulerTypeId;
+  connection->m_congestionTypeId = m_congestionTypeId;
+  connection->m_sndBufSize = m_sndBufSize;
+  connection->m_rcvBufSize = m_rcvBufSize;
+  connection->m_maxSubflows = m_maxSubflows;
+  connection->m_fullMesh = m_fullMesh;
+  connection->m_token = token;
+  connection->m_localAddress = m_localAddress;
+  connection->m_bound = m_bound;
+  connection->m_connected = true;
+  return connection;
+}
+
+bool
+MpTcpSocket::SubflowConnectionRequest (Ptr<Socket> socket, const Address &from)
+{
+  NS_LOG_FUNCTION (this << socket << from);
+  return true;
+}
+
+void
+MpTcpSocket::SubflowAccepted (Ptr<Socket> socket, const Address &from)
+{
+  NS_LOG_FUNCTION (this << socket << from);
+  Ptr<MpTcpSubflow> subflow = DynamicCast<MpTcpSubflow> (socket);
+  NS_ASSERT (subflow != 0);
+  PendingSubflow pending;
+  pending.rxData = Create<Packet> ();
+  pending.from = from;
+  m_pending[subflow] = pending;
+  subflow->SetRecvCallback (MakeCallback (&MpTcpSocket::PendingSubflowRecv, this));
+  subflow->SetCloseCallbacks (MakeCallback (&MpTcpSocket::PendingSubflowClose, this),
+                              MakeCallback (&MpTcpSocket::PendingSubflowClose, this));
+}
+
+void
+MpTcpSocket::PendingSubflowClose (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  m_pending.erase (DynamicCast<MpTcpSubflow> (socket));
+}
+
+void
+MpTcpSocket::PendingSubflowRecv (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Ptr<MpTcpSubflow> subflow = DynamicCast<MpTcpSubflow> (socket);
+  std::map<Ptr<MpTcpSubflow>, PendingSubflow>::iterator it = m_pending.find (subflow);
+  NS_ASSERT (it != m_pending.end ());
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      it->second.rxData->AddAtEnd (p);
+    }
+  if (it->second.rxData->GetSize () == 0)
+    {
+      return;
+    }
+
+  uint8_t kind;
+  it->second.rxData->CopyData (&kind, 1);
+  uint32_t size = MpTcpHeader::GetSerializedSize (kind);
+  if (size != 0 && it->second.rxData->GetSize () < size)
+    {
+      return;
+    }
+
+  PendingSubflow pending = it->second;
+  m_pending.erase (it);
+  MpTcpHeader header;
+  if (size == 0 || kind == MpTcpHeader::DSS)
+    {
+      NS_LOG_WARN ("Subflow without MP_CAPABLE or MP_JOIN header");
+      subflow->Close ();
+      return;
+    }
+  PopHeader (pending.rxData, header);
+
+  Ptr<MpTcpSocket> connection;
+  if (header.GetKind () == MpTcpHeader::MP_CAPABLE)
+    {
+      if (m_connections.find (header.GetToken ()) != m_connections.end ()
+          || !NotifyConnectionRequest (pending.from))
+        {
+          subflow->Close ();
+          return;
+        }
+      connection = CreateConnection (header.GetToken ());
+      connection->m_peerAddress = pending.from;
+      connection->AddSubflow (subflow, true);
+      connection->m_connectionClosed = MakeCallback (&MpTcpSocket::ConnectionClosed, this);
+      m_connections[header.GetToken ()] = connection;
+      NotifyNewConnectionCreated (connection, pending.from);
+    }
+  else
+    {
+      std::map<uint32_t, Ptr<MpTcpSocket> >::iterator found = m_connections.find (header.GetToken ());
+      if (found == m_connections.end () || found->second->m_closeNotified
+          || found->second->m_subflows.size () >= m_maxSubflows)
+        {
+          NS_LOG_LOGIC ("Rejected MP_JOIN subflow with token " << header.GetToken ());
+          subflow->Close ();
+          return;
+        }
+      connection = found->second;
+      connection->AddSubflow (subflow, true);
+    }
+
+  Subflow *entry = connection->FindSubflow (subflow);
+  entry->rxData = pending.rxData;
+  connection->ParseSubflowData (entry);
+  connection->SendPending ();
+}
+
+void
+MpTcpSocket::SubflowConnected (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Subflow *subflow = FindSubflow (socket);
+  NS_ASSERT (subflow != 0);
+  bool first = (subflow == &m_subflows.front ());
+
+  MpTcpHeader header;
+  header.SetKind (first ? MpTcpHeader::MP_CAPABLE : MpTcpHeader::MP_JOIN);
+  header.SetToken (m_token);
+  Ptr<Packet> p = Create<Packet> ();
+  p->AddHeader (header);
+  subflow->socket->Send (p, 0);
+  subflow->ready = true;
+
+  if (first)
+    {
+      m_connected = true;
+      NotifyConnectionSucceeded ();
+      if (m_fullMesh)
+        {
+          OpenSubflows ();
+        }
+      if (GetTxAvailable () > 0)
+        {
+          NotifySend (GetTxAvailable ());
+        }
+    }
+  SendPending ();
+}
+
+void
+MpTcpSocket::SubflowConnectionFailed (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Subflow *subflow = FindSubflow (socket);
+  NS_ASSERT (subflow != 0);
+  subflow->closed = true;
+  if (!m_connected && subflow == &m_subflows.front () && !m_closeNotified)
+    {
+      m_closeNotified = true;
+      NotifyConnectionFailed ();
+    }
+}
+
+void
+MpTcpSocket::SubflowNormalClose (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Subflow *subflow = FindSubflow (socket);
+  NS_ASSERT (subflow != 0);
+  RemoveSubflow (subflow);
+  CheckClosed (false);
+  SendPending ();
+}
+
+void
+MpTcpSocket::SubflowErrorClose (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Subflow *subflow = FindSubflow (socket);
+  NS_ASSERT (subflow != 0);
+  RemoveSubflow (subflow);
+  CheckClosed (true);
+  // the other subflows go on, starting with the reinjected data
+  SendPending ();
+}
+
+void
+MpTcpSocket::RemoveSubflow (Subflow *subflow)
+{
+  NS_LOG_FUNCTION (this << subflow->socket);
+  subflow->closed = true;
+  m_coupling->RemoveSubflow (subflow->socket->GetTcb ());
+  if (m_scheduler != 0)
+    {
+      m_scheduler->RemoveSubflow (subflow->socket);
+    }
+
+  DiscardAcked (subflow);
+  if (subflow->txMappings.empty ())
+    {
+      return;
+    }
+  NS_LOG_LOGIC ("Reinjecting " << subflow->txMappings.size () << " chunks from " << subflow->socket);
+  std::deque<Mapping> reinject;
+  std::merge (m_reinject.begin (), m_reinject.end (),
+              subflow->txMappings.begin (), subflow->txMappings.end (),
+              std::back_inserter (reinject),
+              [] (const Mapping &a, const Mapping &b) { return a.sequence < b.sequence; });
+  m_reinject.swap (reinject);
+  subflow->txMappings.clear ();
+}
+
+void
+MpTcpSocket::CheckClosed (bool error)
+{
+  for (std::vector<Subflow>::const_iterator it = m_subflows.begin (); it != m_subflows.end (); it++)
+    {
+      if (!it->closed)
+        {
+          return;
+        }
+    }
+  if (!m_closeNotified)
+    {
+      NS_LOG_LOGIC ("All the subflows are closed");
+      m_closeNotified = true;
+      // the data left unacknowledged is lost
+      if (error || !m_reinject.empty ())
+        {
+          NotifyErrorClose ();
+        }
+      else
+        {
+          NotifyNormalClose ();
+        }
+      if (!m_connectionClosed.IsNull ())
+        {
+          m_connectionClosed (m_token);
+          m_connectionClosed = MakeNullCallback<void, uint32_t> ();
+        }
+    }
+}
+
+void
+MpTcpSocket::ConnectionClosed (uint32_t token)
+{
+  NS_LOG_FUNCTION (this << token);
+  // the connection may only be referenced by this socket, and is still running
+  Simulator::ScheduleNow (&MpTcpSocket::EraseConnection, Ptr<MpTcpSocket> (this), token);
+}
+
+void
+MpTcpSocket::EraseConnection (uint32_t token)
+{
+  NS_LOG_FUNCTION (this << token);
+  m_connections.erase (token);
+}
+
+void
+MpTcpSocket::SubflowSend (Ptr<Socket> socket, uint32_t available)
+{
+  NS_LOG_FUNCTION (this << socket << available);
+  // the subflow acknowledged some data
+  Subflow *subflow = FindSubflow (socket);
+  if (subflow != 0)
+    {
+      DiscardAcked (subflow);
+    }
+  SendPending ();
+}
+
+void
+MpTcpSocket::DiscardAcked (Subflow *subflow)
+{
+  SequenceNumber32 una = subflow->socket->GetTxBuffer ()->HeadSequence ();
+  while (!subflow->txMappings.empty () && subflow->txMappings.front ().end <= una)
+    {
+      subflow->txMappings.pop_front ();
+    }
+}
+
+uint64_t
+MpTcpSocket::GetDataUna (void) const
+{
+  uint64_t una = m_reinject.empty () ? m_txSequence : m_reinject.front ().sequence;
+  for (std::vector<Subflow>::const_iterator it = m_subflows.begin (); it != m_subflows.end (); it++)
+    {
+      if (!it->txMappings.empty ())
+        {
+          una = std::min (una, it->txMappings.front ().sequence);
+        }
+    }
+  return una;
+}
+
+void
+MpTcpSocket::SubflowRecv (Ptr<Socket> socket)
+{
+  NS_LOG_FUNCTION (this << socket);
+  Subflow *subflow = FindSubflow (socket);
+  NS_ASSERT (subflow != 0);
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      subflow->rxData->AddAtEnd (p);
+    }
+  ParseSubflowData (subflow);
+}
+
+void
+MpTcpSocket::ParseSubflowData (Subflow *subflow)
+{
+  NS_LOG_FUNCTION (this << subflow->socket);
+  bool received = false;
+  while (subflow->rxData->GetSize () > 0)
+    {
+      if (subflow->mappingLength == 0)
+        {
+          uint8_t kind;
+          subflow->rxData->CopyData (&kind, 1);
+          if (MpTcpHeader::GetSerializedSize (kind) == 0)
+            {
+              NS_LOG_WARN ("Malformed MPTCP header, closing the subflow");
+              subflow->rxData = Create<Packet> ();
+              subflow->socket->Close ();
+              break;
+            }
+          MpTcpHeader header;
+          if (!PopHeader (subflow->rxData, header))
+            {
+              NS_LOG_LOGIC ("Waiting for the rest of the MPTCP header");
+              break;
+            }
+          if (header.GetKind () == MpTcpHeader::DSS)
+            {
+              subflow->mappingSequence = header.GetDataSequence ();
+              subflow->mappingLength = header.GetDataLength ();
+            }
+          continue;
+        }
+      uint32_t size = std::min (subflow->mappingLength, subflow->rxData->GetSize ());
+      Ptr<Packet> data = subflow->rxData->CreateFragment (0, size);
+      subflow->rxData->RemoveAtStart (size);
+      received |= ReceiveData (subflow->mappingSequence, data);
+      subflow->mappingSequence += size;
+      subflow->mappingLength -= size;
+    }
+  if (received && m_rxSize > 0)
+    {
+      NotifyDataRecv ();
+    }
+}
+
+bool
+MpTcpSocket::ReceiveData (uint64_t sequence, Ptr<Packet> data)
+{
+  NS_LOG_FUNCTION (this << sequence << data->GetSize ());
+  uint64_t end = sequence + data->GetSize ();
+  if (end <= m_rxSequence)
+    {
+      NS_LOG_LOGIC ("Duplicate data " << sequence << " to " << end);
+      return false;
+    }
+  if (sequence > m_rxSequence)
+    {
+      if (end > m_rxSequence + m_rcvBufSize)
+        {
+          NS_LOG_LOGIC ("Data " << sequence << " to " << end << " beyond the receive window");
+          return false;
+        }
+      // keep the longest data received at a sequence number
+      std::map<uint64_t, Ptr<Packet> >::iterator it = m_rxOutOfOrder.find (sequence);
+      if (it == m_rxOutOfOrder.end () || it->second->GetSize () < data->GetSize ())
+        {
+          m_rxOutOfOrder[sequence] = data;
+        }
+      return false;
+    }
+
+  if (sequence < m_rxSequence)
+    {
+      data = data->CreateFragment (m_rxSequence - sequence, end - m_rxSequence);
+    }
+  std::map<uint64_t, Ptr<Packet> >::iterator it = m_rxOutOfOrder.begin ();
+  for (;;)
+    {
+      if (!m_shutdownRecv)
+        {
+          m_rxData.push_back (data);
+          m_rxSize += data->GetSize ();
+        }
+      m_rxSequence += data->GetSize ();
+
+      // the out of order data which now follows the received data
+      data = 0;
+      while (it != m_rxOutOfOrder.end () && it->first <= m_rxSequence && data == 0)
+        {
+          uint64_t itEnd = it->first + it->second->GetSize ();
+          if (itEnd > m_rxSequence)
+            {
+              data = it->second->CreateFragment (m_rxSequence - it->first, itEnd - m_rxSequence);
+            }
+          it = m_rxOutOfOrder.erase (it);
+        }
+      if (data == 0)
+        {
+          break;
+        }
+    }
+  return true;
+}
+
+void
+MpTcpSocket::SendPending (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_sending || !m_connected)
+    {
+      return;
+    }
+  if (m_scheduler == 0)
+    {
+      ObjectFactory schedulerFactory;
+      schedulerFactory.SetTypeId (m_schedulerTypeId);
+      m_scheduler = schedulerFactory.Create<MpTcpScheduler> ();
+    }
+
+  // sending on a subflow can notify the room left in its buffer
+  m_sending = true;
+  uint32_t sent = 0;
+  MpTcpHeader header;
+  header.SetKind (MpTcpHeader::DSS);
+  while (m_txSize > 0 || !m_reinject.empty ())
+    {
+      std::vector<Ptr<MpTcpSubflow> > available;
+      uint32_t window = 0;
+      for (std::vector<Subflow>::iterator it = m_subflows.begin (); it != m_subflows.end (); it++)
+        {
+          if (it->ready && !it->closed && it->socket->CanSendData ())
+            {
+              window = std::max (window, it->socket->GetPeerWindow ());
+              if (it->socket->GetFreeWindow () > 0
+                  && it->socket->GetTxAvailable () >= it->socket->GetSegmentSize ())
+                {
+                  available.push_back (it->socket);
+                }
+            }
+        }
+      if (available.empty ())
+        {
+          break;
+        }
+
+      // the chunks of the failed subflows go first, and the new data must
+      // fit in the window of the peer
+      uint32_t size;
+      if (!m_reinject.empty ())
+        {
+          size = m_reinject.front ().data->GetSize ();
+        }
+      else
+        {
+          uint64_t windowEnd = GetDataUna () + window;
+          if (windowEnd <= m_txSequence)
+            {
+              NS_LOG_LOGIC ("Receive window of the peer full");
+              break;
+            }
+          size = static_cast<uint32_t> (std::min<uint64_t> (std::min<uint32_t> (m_txSize, 0xffff),
+                                                            windowEnd - m_txSequence));
+        }
+      std::vector<Ptr<MpTcpSubflow> > selected = m_scheduler->SelectSubflows (available);
+      if (selected.empty ())
+        {
+          break;
+        }
+
+      for (std::vector<Ptr<MpTcpSubflow> >::const_iterator it = selected.begin (); it != selected.end (); it++)
+        {
+          NS_ASSERT ((*it)->GetSegmentSize () > header.GetSerializedSize ());
+          size = std::min (size, (*it)->GetSegmentSize () - header.GetSerializedSize ());
+        }
+      if (!m_reinject.empty ())
+        {
+          Mapping &front = m_reinject.front ();
+          uint32_t left = front.data->GetSize () - size;
+          SendChunk (front.sequence, front.data->CreateFragment (0, size), selected);
+          if (left == 0)
+            {
+              m_reinject.pop_front ();
+            }
+          else
+            {
+              front.data = front.data->CreateFragment (size, left);
+              front.sequence += size;
+            }
+          continue;
+        }
+      Ptr<Packet> chunk = PopBytes (m_txData, size);
+      m_txSize -= size;
+      SendChunk (m_txSequence, chunk, selected);
+      m_txSequence += size;
+      sent += size;
+    }
+  m_sending = false;
+
+  if (sent > 0)
+    {
+      NotifyDataSent (sent);
+    }
+  // the subflows are kept open until all the data is acknowledged, in
+  // case some has to be reinjected
+  if (m_txSize == 0 && m_closeOnEmpty && GetDataUna () == m_txSequence)
+    {
+      CloseSubflows ();
+    }
+  else if (sent > 0 && GetTxAvailable () > 0)
+    {
+      NotifySend (GetTxAvailable ());
+    }
+}
+
+void
+MpTcpSocket::SendChunk (uint64_t sequence, Ptr<Packet> chunk, const std::vector<Ptr<MpTcpSubflow> > &selected)
+{
+  MpTcpHeader header;
+  header.SetKind (MpTcpHeader::DSS);
+  header.SetDataSequence (sequence);
+  header.SetDataLength (chunk->GetSize ());
+  for (std::vector<Ptr<MpTcpSubflow> >::const_iterator it = selected.begin (); it != selected.end (); it++)
+    {
+      NS_LOG_LOGIC ("Sending " << header << " on " << *it);
+      Ptr<Packet> p = chunk->Copy ();
+      p->AddHeader (header);
+      (*it)->Send (p, 0);
+      Mapping mapping;
+      mapping.sequence = sequence;
+      mapping.data = chunk;
+      mapping.end = (*it)->GetTxBuffer ()->TailSequence ();
+      FindSubflow (*it)->txMappings.push_back (mapping);
+    }
+}
+
+bool
+MpTcpSocket::PopHeader (Ptr<Packet> data, MpTcpHeader &header)
+{
+  uint8_t kind;
+  data->CopyData (&kind, 1);
+  uint32_t size = MpTcpHeader::GetSerializedSize (kind);
+  NS_ASSERT (size > 0);
+  if (data->GetSize () < size)
+    {
+      return false;
+    }
+  uint8_t bytes[16];
+  NS_ASSERT (size <= sizeof (bytes));
+  data->CopyData (bytes, size);
+  Buffer buffer;
+  buffer.AddAtStart (size);
+  buffer.Begin ().Write (bytes, size);
+  header.Deserialize (buffer.Begin ());
+  data->RemoveAtStart (size);
+  return true;
+}
+
+Ptr<Packet>
+MpTcpSocket::PopBytes (std::deque<Ptr<Packet> > &queue, uint32_t size)
+{
+  Ptr<Packet> p = Create<Packet> ();
+  while (size > 0)
+    {
+      NS_ASSERT (!queue.empty ());
+      Ptr<Packet> front = queue.front ();
+      if (front->GetSize () <= size)
+        {
+          p->AddAtEnd (front);
+          size -= front->GetSize ();
+          queue.pop_front ();
+        }
+      else
+        {
+          // the packets of the application are not modified
+          p->AddAtEnd (front->CreateFragment (0, size));
+          queue.front () = front->CreateFragment (size, front->GetSize () - size);
+          size = 0;
+        }
+    }
+  return p;
+}
+
+void
+MpTcpSocket::CloseSubflows (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_closeOnEmpty = false;
+  for (std::vector<Subflow>::iterator it = m_subflows.begin (); it != m_subflows.end (); it++)
+    {
+      if (!it->closed)
+        {
+          it->socket->Close ();
+        }
+    }
+}
+
+int
+MpTcpSocket::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_listener != 0)
+    {
+      m_listener->Close ();
+      for (std::map<Ptr<MpTcpSubflow>, PendingSubflow>::iterator it = m_pending.begin (); it != m_pending.end (); it++)
+        {
+          it->first->Close ();
+        }
+      return 0;
+    }
+  return ShutdownSend ();
+}
+
+int
+MpTcpSocket::ShutdownSend (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_shutdownSend)
+    {
+      return 0;
+    }
+  m_shutdownSend = true;
+  if (m_connected && (m_txSize > 0 || GetDataUna () < m_txSequence))
+    {
+      m_closeOnEmpty = true;
+    }
+  else
+    {
+      CloseSubflows ();
+    }
+  return 0;
+}
+
+int
+MpTcpSocket::ShutdownRecv (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_shutdownRecv = true;
+  return 0;
+}
+
+int
+MpTcpSocket::Send (Ptr<Packet> p, uint32_t flags)
+{
+  NS_LOG_FUNCTION (this << p << flags);
+  if (m_subflows.empty () || m_closeNotified)
+    {
+      m_errno = ERROR_NOTCONN;
+      return -1;
+    }
+  if (m_shutdownSend)
+    {
+      m_errno = ERROR_SHUTDOWN;
+      return -1;
+    }
+  if (p->GetSize () > GetTxAvailable ())
+    {
+      m_errno = ERROR_MSGSIZE;
+      return -1;
+    }
+  if (p->GetSize () > 0)
+    {
+      m_txData.push_back (p);
+      m_txSize += p->GetSize ();
+      // as TcpSocketBase, do not call back the application from Send
+      if (!m_sendPendingEvent.IsRunning ())
+        {
+          m_sendPendingEvent = Simulator::Schedule (TimeStep (1), &MpTcpSocket::SendPending, this);
+        }
+    }
+  return p->GetSize ();
+}
+
+int
+MpTcpSocket::SendTo (Ptr<Packet> p, uint32_t flags, const Address &toAddress)
+{
+  NS_LOG_FUNCTION (this << p << flags << toAddress);
+  return Send (p, flags);
+}
+
+Ptr<Packet>
+MpTcpSocket::Recv (uint32_t maxSize, uint32_t flags)
+{
+  NS_LOG_FUNCTION (this << maxSize << flags);
+  if (m_rxSize == 0)
+    {
+      return 0;
+    }
+  uint32_t size = std::min (maxSize, m_rxSize);
+  m_rxSize -= size;
+  return PopBytes (m_rxData, size);
+}
+
+Ptr<Packet>
+MpTcpSocket::RecvFrom (uint32_t maxSize, uint32_t flags, Address &fromAddress)
+{
+  NS_LOG_FUNCTION (this << maxSize << flags);
+  Ptr<Packet> packet = Recv (maxSize, flags);
+  if (packet != 0)
+    {
+      fromAddress = m_peerAddress;
+    }
+  return packet;
+}
+
+uint32_t
+MpTcpSocket::GetTxAvailable (void) const
+{
+  return (m_txSize < m_sndBufSize) ? m_sndBufSize - m_txSize : 0;
+}
+
+uint32_t
+MpTcpSocket::GetRxAvailable (void) const
+{
+  return m_rxSize;
+}
+
+int
+MpTcpSocket::GetSockName (Address &address) const
+{
+  if (!m_subflows.empty ())
+    {
+      return m_subflows.front ().socket->GetSockName (address);
+    }
+  if (m_listener != 0)
+    {
+      return m_listener->GetSockName (address);
+    }
+  address = m_localAddress;
+  return 0;
+}
+
+int
+MpTcpSocket::GetPeerName (Address &address) const
+{
+  if (!m_connected)
+    {
+      m_errno = ERROR_NOTCONN;
+      return -1;
+    }
+  address = m_peerAddress;
+  return 0;
+}
+
+bool
+MpTcpSocket::SetAllowBroadcast (bool allowBroadcast)
+{
+  // Broadcast is not implemented. Return true only if allowBroadcast==false
+  return (!allowBroadcast);
+}
+
+bool
+MpTcpSocket::GetAllowBroadcast (void) const
+{
+  return false;
+}
+
+} // namespace ns3
@@ -0,0 +1,426 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_SOCKET_H
+#define MPTCP_SOCKET_H
+
+#include <deque>
+#include <map>
+#include <vector>
+#include "ns3/socket.h"
+#include "ns3/traced-callback.h"
+#include "ns3/event-id.h"
+#include "ns3/sequence-number.h"
+#include "mptcp-subflow.h"
+#include "mptcp-scheduler.h"
+#include "mptcp-congestion-ops.h"
+
+namespace ns3 {
+
+class MpTcpHeader;
+class Node;
+class Packet;
+class TcpL4Protocol;
+class UniformRandomVariable;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A Multipath TCP connection (meta-socket)
+ *
+ * The meta-socket is the socket of the application.  It spreads the data
+ * over several TCP subflows (MpTcpSubflow), and reorders the data they
+ * receive.
+ *
+ * On the client, the first subflow is opened by Connect, and sends an
+ * MP_CAPABLE header with the token of the connection.  Once it is
+ * established, with the FullMesh attribute, one more subflow is opened from
+ * each other local address of the node, bound to the device of the
+ * address, towards the address of the peer; these subflows send an MP_JOIN
+ * header with the token.  The routing of the node must therefore have a
+ * route to the peer through each device.  On the server, the listening
+ * subflow accepts the subflows, and the meta-socket given to the
+ * application is created when an MP_CAPABLE header is received; the
+ * subflows with an MP_JOIN header are added to the connection of their
+ * token.
+ *
+ * The data of the application is cut in chunks of about one segment; the
+ * scheduler (Scheduler attribute) chooses the subflows of each chunk among
+ * the established subflows with room in their congestion window, and the
+ * chunk is sent with a DSS header which maps it to the data sequence space
+ * of the connection.  The subflows use a coupled congestion control
+ * (CongestionControl attribute), which shares its state between the
+ * subflows of the connection.
+ *
+ * Each chunk is kept until a subflow which carried it acknowledges it.  If
+ * a subflow fails, the chunks it did not acknowledge are reinjected on the
+ * other subflows, before any new data; once all the subflows are closed,
+ * the application is told the connection failed if data was left
+ * unacknowledged.  The data sent and not acknowledged at the data level
+ * (by the subflows which carry the first unacknowledged chunk) never
+ * exceeds the receive window advertised by the subflows of the peer, and
+ * the receiver drops the data received out of order beyond its receive
+ * buffer (RcvBufSize attribute, which is also the receive buffer of the
+ * subflows), so its reordering buffer is bounded.
+ *
+ * The token of a connection is drawn from a random variable of the
+ * MpTcpSocketFactory of the node (see MpTcpSocketFactory::AssignStreams).
+ *
+ * \see MpTcpHeader
+ */
+class MpTcpSocket : public Socket
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpSocket (void);
+  virtual ~MpTcpSocket (void);
+
+  /**
+   * \brief Set the associated node.
+   * \param node the node
+   */
+  void SetNode (Ptr<Node> node);
+
+  /**
+   * \brief Set the associated TCP L4 protocol.
+   * \param tcp the TCP L4 protocol
+   */
+  void SetTcp (Ptr<TcpL4Protocol> tcp);
+
+  /**
+   * \brief Set the random variable the token of the connection is drawn from
+   * \param tokens the random variable
+   */
+  void SetTokenVariable (Ptr<UniformRandomVariable> tokens);
+
+  /**
+   * \brief Get the number of subflows of the connection
+   * \return the number of subflows, including the closed ones
+   */
+  uint32_t GetNSubflows (void) const;
+
+  /**
+   * \brief Get a subflow of the connection
+   * \param i the index of the subflow
+   * \return the subflow
+   */
+  Ptr<MpTcpSubflow> GetSubflow (uint32_t i) const;
+
+  virtual enum SocketErrno GetErrno (void) const;
+  virtual enum SocketType GetSocketType (void) const;
+  virtual Ptr<Node> GetNode (void) const;
+  virtual int Bind (void);
+  virtual int Bind6 (void);
+  virtual int Bind (const Address &address);
+  virtual int Connect (const Address &address);
+  virtual int Listen (void);
+  virtual int Close (void);
+  virtual int ShutdownSend (void);
+  virtual int ShutdownRecv (void);
+  virtual int Send (Ptr<Packet> p, uint32_t flags);
+  virtual int SendTo (Ptr<Packet> p, uint32_t flags, const Address &toAddress);
+  virtual Ptr<Packet> Recv (uint32_t maxSize, uint32_t flags);
+  virtual Ptr<Packet> RecvFrom (uint32_t maxSize, uint32_t flags, Address &fromAddress);
+  virtual uint32_t GetTxAvailable (void) const;
+  virtual uint32_t GetRxAvailable (void) const;
+  virtual int GetSockName (Address &address) const;
+  virtual int GetPeerName (Address &address) const;
+  virtual bool SetAllowBroadcast (bool allowBroadcast);
+  virtual bool GetAllowBroadcast (void) const;
+
+  /**
+   * TracedCallback signature for a new subflow
+   * \param [in] subflow the subflow
+   */
+  typedef void (* SubflowTracedCallback)(Ptr<MpTcpSubflow> subflow);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief A chunk of data sent on a subflow
+   */
+  struct Mapping
+  {
+    uint64_t sequence;         //!< Data sequence number of the first byte
+    Ptr<Packet> data;          //!< The data, without the DSS header
+    SequenceNumber32 end;      //!< Subflow sequence number following the chunk
+  };
+
+  /**
+   * \brief A subflow of the connection
+   */
+  struct Subflow
+  {
+    Ptr<MpTcpSubflow> socket;  //!< The subflow
+    bool ready;                //!< Whether data can be sent on the subflow
+    bool closed;               //!< Whether the subflow is closed
+    Ptr<Packet> rxData;        //!< Received bytes not parsed yet
+    uint64_t mappingSequence;  //!< Data sequence number of the next mapped byte
+    uint32_t mappingLength;    //!< Number of mapped bytes not received yet
+    std::deque<Mapping> txMappings; //!< Chunks sent and not acknowledged by the subflow
+  };
+
+  /**
+   * \brief A subflow accepted by a listening socket, before its first header
+   */
+  struct PendingSubflow
+  {
+    Ptr<Packet> rxData; //!< Received bytes
+    Address from;       //!< Address of the peer
+  };
+
+  /**
+   * \brief Create a subflow, with the congestion control of the connection
+   * \return the subflow
+   */
+  Ptr<MpTcpSubflow> CreateSubflow (void);
+
+  /**
+   * \brief Add a subflow to the connection
+   * \param subflow the subflow
+   * \param ready whether data can be sent on the subflow
+   */
+  void AddSubflow (Ptr<MpTcpSubflow> subflow, bool ready);
+
+  /**
+   * \brief Find a subflow of the connection
+   * \param socket the subflow
+   * \return the subflow, or 0 if it is not one of the connection
+   */
+  Subflow * FindSubflow (Ptr<Socket> socket);
+
+  /**
+   * \brief Open the additional subflows, from the other local addresses
+   */
+  void OpenSubflows (void);
+
+  /**
+   * \brief Open an additional subflow
+   * \param local the local address
+   * \param device the device of the local address
+   */
+  void OpenSubflow (const Address &local, Ptr<NetDevice> device);
+
+  /**
+   * \brief Create the connection of an MP_CAPABLE subflow
+   * \param token the token of the connection
+   * \return the connection
+   */
+  Ptr<MpTcpSocket> CreateConnection (uint32_t token);
+
+  /**
+   * \brief Send the data of the application on the subflows
+   */
+  void SendPending (void);
+
+  /**
+   * \brief Send a chunk on the subflows selected by the scheduler
+   * \param sequence the data sequence number of the chunk
+   * \param chunk the chunk
+   * \param selected the subflows
+   */
+  void SendChunk (uint64_t sequence, Ptr<Packet> chunk, const std::vector<Ptr<MpTcpSubflow> > &selected);
+
+  /**
+   * \brief Forget the chunks a subflow acknowledged
+   * \param subflow the subflow
+   */
+  void DiscardAcked (Subflow *subflow);
+
+  /**
+   * \brief Get the first data sequence number not acknowledged yet
+   * \return the sequence number of the first chunk not acknowledged
+   */
+  uint64_t GetDataUna (void) const;
+
+  /**
+   * \brief Forget a closed subflow, and reinject the chunks it did not acknowledge
+   * \param subflow the subflow
+   */
+  void RemoveSubflow (Subflow *subflow);
+
+  /**
+   * \brief Forget a connection accepted by this listening socket, once it is closed
+   * \param token the token of the connection
+   */
+  void ConnectionClosed (uint32_t token);
+
+  /**
+   * \brief Erase a closed connection
+   * \param token the token of the connection
+   */
+  void EraseConnection (uint32_t token);
+
+  /**
+   * \brief Parse the bytes received on a subflow
+   * \param subflow the subflow
+   */
+  void ParseSubflowData (Subflow *subflow);
+
+  /**
+   * \brief Add data received on a subflow to the data of the connection
+   * \param sequence the data sequence number of the first byte
+   * \param data the data
+   * \return true if the next bytes of the connection were received
+   */
+  bool ReceiveData (uint64_t sequence, Ptr<Packet> data);
+
+  /**
+   * \brief Close the subflows, once the data of the connection is sent
+   */
+  void CloseSubflows (void);
+
+  /**
+   * \brief Notify the application once all the subflows are closed
+   * \param error whether the last subflow was closed by an error
+   */
+  void CheckClosed (bool error);
+
+  /**
+   * \brief Clear the callbacks of the subflows and forget them
+   */
+  void ClearSubflows (void);
+
+  /**
+   * \brief Remove bytes from the front of a queue of packets
+   * \param queue the queue
+   * \param size the number of bytes, at most the bytes of the queue
+   * \return the bytes
+   */
+  static Ptr<Packet> PopBytes (std::deque<Ptr<Packet> > &queue, uint32_t size);
+  /**
+   * \brief Remove an MPTCP header from the front of the data of a subflow
+   *
+   * The header is read from a copy of its bytes, since it may span two
+   * segments of the subflow, and Packet::RemoveHeader expects the header
+   * added by the sender as a whole.
+   *
+   * \param data the data received on the subflow
+   * \param header the header read
+   * \return false if the data does not hold the whole header yet, in which
+   *         case it is left unchanged
+   */
+  static bool PopHeader (Ptr<Packet> data, MpTcpHeader &header);
+
+  // Callbacks of the subflows
+  /**
+   * \brief A subflow is established
+   * \param socket the subflow
+   */
+  void SubflowConnected (Ptr<Socket> socket);
+  /**
+   * \brief A subflow could not be established
+   * \param socket the subflow
+   */
+  void SubflowConnectionFailed (Ptr<Socket> socket);
+  /**
+   * \brief A subflow is closed
+   * \param socket the subflow
+   */
+  void SubflowNormalClose (Ptr<Socket> socket);
+  /**
+   * \brief A subflow is closed by an error
+   * \param socket the subflow
+   */
+  void SubflowErrorClose (Ptr<Socket> socket);
+  /**
+   * \brief Data is received on a subflow
+   * \param socket the subflow
+   */
+  void SubflowRecv (Ptr<Socket> socket);
+  /**
+   * \brief Room is available in the buffer of a subflow
+   * \param socket the subflow
+   * \param available the available room
+   */
+  void SubflowSend (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Accept all the subflows; the connections are accepted by the application
+   * \param socket the listening subflow
+   * \param from the address of the peer
+   * \return true
+   */
+  bool SubflowConnectionRequest (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief A listening subflow accepted a subflow
+   * \param socket the new subflow
+   * \param from the address of the peer
+   */
+  void SubflowAccepted (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Data is received on an accepted subflow, before its first header
+   * \param socket the subflow
+   */
+  void PendingSubflowRecv (Ptr<Socket> socket);
+  /**
+   * \brief An accepted subflow is closed before its first header
+   * \param socket the subflow
+   */
+  void PendingSubflowClose (Ptr<Socket> socket);
+
+  Ptr<Node> m_node;                    //!< The associated node
+  Ptr<TcpL4Protocol> m_tcp;            //!< The associated TCP L4 protocol
+  TypeId m_schedulerTypeId;            //!< Type of the scheduler
+  TypeId m_congestionTypeId;           //!< Type of the congestion control of the subflows
+  uint32_t m_sndBufSize;               //!< Size of the send buffer
+  uint32_t m_rcvBufSize;               //!< Size of the receive buffer
+  uint32_t m_maxSubflows;              //!< Maximum number of subflows
+  bool m_fullMesh;                     //!< Open a subflow from each local address
+  mutable enum SocketErrno m_errno;    //!< Error code
+
+  Ptr<MpTcpScheduler> m_scheduler;     //!< The scheduler
+  Ptr<MpTcpCoupling> m_coupling;       //!< State shared by the congestion controls
+  Ptr<UniformRandomVariable> m_tokens; //!< Random variable of the tokens
+  uint32_t m_token;                    //!< Token of the connection
+  Address m_localAddress;              //!< Address given to Bind
+  bool m_bound;                        //!< Whether Bind was called
+  Address m_peerAddress;               //!< Address of the peer
+  bool m_connected;                    //!< Whether the connection is established
+  bool m_closeOnEmpty;                 //!< Close the subflows once the data is sent
+  bool m_shutdownSend;                 //!< Whether sending is shut down
+  bool m_shutdownRecv;                 //!< Whether receiving is shut down
+  bool m_closeNotified;                //!< Whether the application was told the connection is closed
+  bool m_sending;                      //!< Whether SendPending is running
+  EventId m_sendPendingEvent;          //!< Event to send the data of the application
+
+  std::vector<Subflow> m_subflows;     //!< The subflows of the connection
+
+  Ptr<MpTcpSubflow> m_listener;                                //!< The listening subflow
+  std::map<Ptr<MpTcpSubflow>, PendingSubflow> m_pending;       //!< Accepted subflows without header
+  std::map<uint32_t, Ptr<MpTcpSocket> > m_connections;         //!< Accepted connections, by token
+  Callback<void, uint32_t> m_connectionClosed;                 //!< Tells the listening socket the connection is closed
+
+  std::deque<Ptr<Packet> > m_txData;   //!< Data of the application not sent yet
+  uint32_t m_txSize;                   //!< Number of bytes in m_txData
+  uint64_t m_txSequence;               //!< Data sequence number of the first byte of m_txData
+  std::deque<Mapping> m_reinject;      //!< Chunks of failed subflows, to send again
+  std::deque<Ptr<Packet> > m_rxData;   //!< Data received in order, not read yet
+  uint32_t m_rxSize;                   //!< Number of bytes in m_rxData
+  uint64_t m_rxSequence;               //!< Data sequence number of the next byte to receive
+  std::map<uint64_t, Ptr<Packet> > m_rxOutOfOrder; //!< Data received out of order
+
+  TracedCallback<Ptr<MpTcpSubflow> > m_subflowAddedTrace; //!< Trace of the new subflows
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SOCKET_H */
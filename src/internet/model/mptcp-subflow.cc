@@ -0,0 +1,107 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-subflow.h"
+#include "tcp-tx-buffer.h"
+#include "tcp-congestion-ops.h"
+#include "rtt-estimator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MpTcpSubflow");
+
+NS_OBJECT_ENSURE_REGISTERED (MpTcpSubflow);
+
+TypeId
+MpTcpSubflow::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MpTcpSubflow")
+    .SetParent<TcpSocketBase> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<MpTcpSubflow> ()
+  ;
+  return tid;
+}
+
+MpTcpSubflow::MpTcpSubflow (void)
+  : TcpSocketBase ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpSubflow::MpTcpSubflow (const MpTcpSubflow& sock)
+  : TcpSocketBase (sock)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MpTcpSubflow::~MpTcpSubflow (void)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ptr<TcpSocketBase>
+MpTcpSubflow::Fork (void)
+{
+  return CopyObject<MpTcpSubflow> (this);
+}
+
+uint32_t
+MpTcpSubflow::GetFreeWindow (void) const
+{
+  uint32_t used = BytesInFlight () + m_txBuffer->SizeFromSequence (m_tcb->m_nextTxSequence);
+  uint32_t window = Window ();
+  return (used > window) ? 0 : window - used;
+}
+
+Time
+MpTcpSubflow::GetSrtt (void) const
+{
+  return m_rtt->GetEstimate ();
+}
+
+uint32_t
+MpTcpSubflow::GetPeerWindow (void) const
+{
+  return m_rWnd;
+}
+
+uint32_t
+MpTcpSubflow::GetSegmentSize (void) const
+{
+  return m_tcb->m_segmentSize;
+}
+
+Ptr<TcpCongestionOps>
+MpTcpSubflow::GetCongestionControl (void) const
+{
+  return m_congestionControl;
+}
+
+Ptr<const TcpSocketState>
+MpTcpSubflow::GetTcb (void) const
+{
+  return m_tcb;
+}
+
+bool
+MpTcpSubflow::CanSendData (void) const
+{
+  return (m_state == TcpSocket::ESTABLISHED || m_state == TcpSocket::CLOSE_WAIT) && !m_shutdownSend;
+}
+
+} // namespace ns3
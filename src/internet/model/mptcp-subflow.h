@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_SUBFLOW_H
+#define MPTCP_SUBFLOW_H
+
+#include "ns3/tcp-socket-base.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A subflow of a Multipath TCP connection
+ *
+ * A subflow is a plain TCP connection, owned by an MpTcpSocket, which
+ * exposes to the meta-socket and its scheduler the state they need: the
+ * room left in the congestion window, the RTT estimate and the congestion
+ * control.
+ */
+class MpTcpSubflow : public TcpSocketBase
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MpTcpSubflow (void);
+
+  /**
+   * \brief Copy constructor, used when a listening subflow forks
+   * \param sock the subflow to copy
+   */
+  MpTcpSubflow (const MpTcpSubflow& sock);
+  virtual ~MpTcpSubflow (void);
+
+  /**
+   * \brief Get the room left in the window
+   *
+   * The data which is queued but not sent yet takes room in the window,
+   * since it will be sent before any new data.
+   *
+   * \return the number of bytes which can be queued and sent at once
+   */
+  uint32_t GetFreeWindow (void) const;
+
+  /**
+   * \brief Get the smoothed RTT
+   * \return the RTT estimate, the initial estimation before the first sample
+   */
+  Time GetSrtt (void) const;
+
+  /**
+   * \brief Get the receive window advertised by the peer
+   * \return the window, in bytes
+   */
+  uint32_t GetPeerWindow (void) const;
+
+  /**
+   * \brief Get the segment size
+   * \return the segment size, in bytes
+   */
+  uint32_t GetSegmentSize (void) const;
+
+  /**
+   * \brief Get the congestion control
+   * \return the congestion control algorithm of the subflow
+   */
+  Ptr<TcpCongestionOps> GetCongestionControl (void) const;
+
+  /**
+   * \brief Get the congestion state
+   * \return the transmission control block of the subflow
+   */
+  Ptr<const TcpSocketState> GetTcb (void) const;
+
+  /**
+   * \brief Check whether data can be sent on the subflow
+   * \return true if the connection is established and not closed for sending
+   */
+  bool CanSendData (void) const;
+
+protected:
+  virtual Ptr<TcpSocketBase> Fork (void);
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SUBFLOW_H */
@@ -0,0 +1,311 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ROUTING_PREFIX_INDEX_H
+#define ROUTING_PREFIX_INDEX_H
+
+#include <stdint.h>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv6-address.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Longest-prefix-match index of routing table entries
+ *
+ * The routing protocols keep their entries in lists, whose order matters
+ * for the tie-breaks between equivalent routes; this index sits next to
+ * such a list and answers "which entries have a prefix matching this
+ * address" without scanning it.
+ *
+ * Entries are grouped by prefix length, and for each length in use the
+ * entries are hashed by prefix.  A lookup probes the lengths in use from
+ * the longest to the shortest, so it costs at most one hash lookup per
+ * distinct prefix length in the table (typically a handful), whatever
+ * the number of routes.  Insertions and removals are incremental.
+ *
+ * Entries with the same prefix are kept in a bucket in insertion order,
+ * and each one is tagged with a sequence number increasing with insertion,
+ * so that callers can recover the list order of entries found in
+ * different buckets.  Both IPv4 (up to 32 bits) and IPv6 (up to 128 bits)
+ * prefixes are supported, through the Key type.
+ *
+ * \tparam Value the type of the indexed entries (compared with operator==
+ *         on removal)
+ */
+template <typename Value>
+class RoutingPrefixIndex
+{
+public:
+  /// An address or prefix, left-aligned on 128 bits
+  struct Key
+  {
+    uint64_t hi; //!< the 64 most significant bits
+    uint64_t lo; //!< the 64 least significant bits
+
+    /**
+     * \param o the other key
+     * \return true if both keys are equal
+     */
+    bool operator == (const Key &o) const
+    {
+      return hi == o.hi && lo == o.lo;
+    }
+  };
+
+  /// An indexed entry
+  struct Item
+  {
+    Value value;       //!< the entry
+    uint64_t sequence; //!< insertion rank
+  };
+
+  /// Entries sharing the same prefix, in insertion order
+  typedef std::vector<Item> Bucket;
+
+  RoutingPrefixIndex ();
+
+  /**
+   * \param address an IPv4 address
+   * \return the corresponding key
+   */
+  static Key MakeKey (Ipv4Address address);
+  /**
+   * \param address an IPv6 address
+   * \return the corresponding key
+   */
+  static Key MakeKey (Ipv6Address address);
+
+  /**
+   * \brief Add an entry
+   * \param prefix the prefix (bits beyond length are ignored)
+   * \param length the prefix length, in bits
+   * \param value the entry
+   */
+  void Insert (Key prefix, uint8_t length, const Value &value);
+  /**
+   * \brief Remove the first entry equal to value with the given prefix
+   * \param prefix the prefix (bits beyond length are ignored)
+   * \param length the prefix length, in bits
+   * \param value the entry
+   * \return false if no such entry was found
+   */
+  bool Remove (Key prefix, uint8_t length, const Value &value);
+  /**
+   * \brief Remove all the entries
+   */
+  void Clear (void);
+
+  /**
+   * \param prefix the prefix (bits beyond length are ignored)
+   * \param length the prefix length, in bits
+   * \return the entries with exactly this prefix, or 0 if none
+   */
+  const Bucket *Find (Key prefix, uint8_t length) const;
+  /**
+   * \brief Find the longest prefix matching an address, below a length
+   *
+   * To visit all the matching prefixes, longest first, start with a
+   * length greater than the longest possible prefix and call this method
+   * until it returns 0.
+   *
+   * \param address the address
+   * \param [in,out] length on input, only prefixes strictly shorter than
+   *        this are considered; on output, the length of the prefix found
+   * \return the entries with the prefix found, or 0 if none
+   */
+  const Bucket *FindLongestMatch (Key address, int &length) const;
+
+private:
+  /// Hash function of the keys
+  struct KeyHash
+  {
+    /**
+     * \param key the key
+     * \return the hash of the key
+     */
+    std::size_t operator () (const Key &key) const
+    {
+      return std::hash<uint64_t> () (key.hi * 0x9e3779b97f4a7c15ULL ^ key.lo);
+    }
+  };
+
+  /// Entries of a prefix length, by prefix
+  typedef std::unordered_map<Key, Bucket, KeyHash> Table;
+  /// Prefix lengths in use, longest first
+  typedef std::map<uint8_t, Table, std::greater<uint8_t> > Tables;
+
+  /**
+   * \param key a key
+   * \param length a prefix length
+   * \return key with the bits beyond length cleared
+   */
+  static Key Mask (Key key, uint8_t length);
+
+  Tables m_tables;      //!< the entries
+  uint64_t m_sequence;  //!< sequence number of the next entry
+};
+
+template <typename Value>
+RoutingPrefixIndex<Value>::RoutingPrefixIndex ()
+  : m_sequence (0)
+{
+}
+
+template <typename Value>
+typename RoutingPrefixIndex<Value>::Key
+RoutingPrefixIndex<Value>::MakeKey (Ipv4Address address)
+{
+  Key key;
+  key.hi = static_cast<uint64_t> (address.Get ()) << 32;
+  key.lo = 0;
+  return key;
+}
+
+template <typename Value>
+typename RoutingPrefixIndex<Value>::Key
+RoutingPrefixIndex<Value>::MakeKey (Ipv6Address address)
+{
+  uint8_t buf[16];
+  address.GetBytes (buf);
+  Key key;
+  key.hi = 0;
+  key.lo = 0;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      key.hi = (key.hi << 8) | buf[i];
+      key.lo = (key.lo << 8) | buf[i + 8];
+    }
+  return key;
+}
+
+template <typename Value>
+typename RoutingPrefixIndex<Value>::Key
+RoutingPrefixIndex<Value>::Mask (Key key, uint8_t length)
+{
+  if (length == 0)
+    {
+      key.hi = 0;
+      key.lo = 0;
+    }
+  else if (length < 64)
+    {
+      key.hi &= ~uint64_t (0) << (64 - length);
+      key.lo = 0;
+    }
+  else if (length == 64)
+    {
+      key.lo = 0;
+    }
+  else if (length < 128)
+    {
+      key.lo &= ~uint64_t (0) << (128 - length);
+    }
+  return key;
+}
+
+template <typename Value>
+void
+RoutingPrefixIndex<Value>::Insert (Key prefix, uint8_t length, const Value &value)
+{
+  Item item;
+  item.value = value;
+  item.sequence = m_sequence++;
+  m_tables[length][Mask (prefix, length)].push_back (item);
+}
+
+template <typename Value>
+bool
+RoutingPrefixIndex<Value>::Remove (Key prefix, uint8_t length, const Value &value)
+{
+  typename Tables::iterator t = m_tables.find (length);
+  if (t == m_tables.end ())
+    {
+      return false;
+    }
+  typename Table::iterator b = t->second.find (Mask (prefix, length));
+  if (b == t->second.end ())
+    {
+      return false;
+    }
+  for (typename Bucket::iterator i = b->second.begin (); i != b->second.end (); i++)
+    {
+      if (i->value == value)
+        {
+          b->second.erase (i);
+          if (b->second.empty ())
+            {
+              t->second.erase (b);
+              if (t->second.empty ())
+                {
+                  m_tables.erase (t);
+                }
+            }
+          return true;
+        }
+    }
+  return false;
+}
+
+template <typename Value>
+void
+RoutingPrefixIndex<Value>::Clear (void)
+{
+  m_tables.clear ();
+}
+
+template <typename Value>
+const typename RoutingPrefixIndex<Value>::Bucket *
+RoutingPrefixIndex<Value>::Find (Key prefix, uint8_t length) const
+{
+  typename Tables::const_iterator t = m_tables.find (length);
+  if (t == m_tables.end ())
+    {
+      return 0;
+    }
+  typename Table::const_iterator b = t->second.find (Mask (prefix, length));
+  return (b == t->second.end ()) ? 0 : &b->second;
+}
+
+template <typename Value>
+const typename RoutingPrefixIndex<Value>::Bucket *
+RoutingPrefixIndex<Value>::FindLongestMatch (Key address, int &length) const
+{
+  typename Tables::const_iterator t = (length > 255) ? m_tables.begin ()
+    : m_tables.upper_bound (static_cast<uint8_t> (length));
+  for (; t != m_tables.end (); t++)
+    {
+      typename Table::const_iterator b = t->second.find (Mask (address, t->first));
+      if (b != t->second.end ())
+        {
+          length = t->first;
+          return &b->second;
+        }
+    }
+  length = -1;
+  return 0;
+}
+
+} // namespace ns3
+
+#endif /* ROUTING_PREFIX_INDEX_H */
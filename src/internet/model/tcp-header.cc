@@ -311,18 +311,55 @@ TcpHeader::GetSerializedSize (void)  const
   return CalculateHeaderLength () * 4;
 }
 
+void
+TcpHeader::WriteFixedPart (uint8_t *buffer) const
+{
+  uint32_t sequenceNumber = m_sequenceNumber.GetValue ();
+  uint32_t ackNumber = m_ackNumber.GetValue ();
+  uint16_t lengthFlags = GetLength () << 12 | m_flags; //reserved bits are all zero
+
+  buffer[0] = (m_sourcePort >> 8) & 0xff;
+  buffer[1] = m_sourcePort & 0xff;
+  buffer[2] = (m_destinationPort >> 8) & 0xff;
+  buffer[3] = m_destinationPort & 0xff;
+  buffer[4] = (sequenceNumber >> 24) & 0xff;
+  buffer[5] = (sequenceNumber >> 16) & 0xff;
+  buffer[6] = (sequenceNumber >> 8) & 0xff;
+  buffer[7] = sequenceNumber & 0xff;
+  buffer[8] = (ackNumber >> 24) & 0xff;
+  buffer[9] = (ackNumber >> 16) & 0xff;
+  buffer[10] = (ackNumber >> 8) & 0xff;
+  buffer[11] = ackNumber & 0xff;
+  buffer[12] = (lengthFlags >> 8) & 0xff;
+  buffer[13] = lengthFlags & 0xff;
+  buffer[14] = (m_windowSize >> 8) & 0xff;
+  buffer[15] = m_windowSize & 0xff;
+  buffer[16] = 0;
+  buffer[17] = 0;
+  buffer[18] = (m_urgentPointer >> 8) & 0xff;
+  buffer[19] = m_urgentPointer & 0xff;
+}
+
+bool
+TcpHeader::SerializeTo (uint8_t *start, uint32_t packetSize) const
+{
+  if (m_calcChecksum || !m_options.empty ())
+    {
+      // options are serialized through a Buffer::Iterator, and the
+      // checksum covers the payload
+      return false;
+    }
+  WriteFixedPart (start);
+  return true;
+}
+
 void
 TcpHeader::Serialize (Buffer::Iterator start)  const
 {
   Buffer::Iterator i = start;
-  i.WriteHtonU16 (m_sourcePort);
-  i.WriteHtonU16 (m_destinationPort);
-  i.WriteHtonU32 (m_sequenceNumber.GetValue ());
-  i.WriteHtonU32 (m_ackNumber.GetValue ());
-  i.WriteHtonU16 (GetLength () << 12 | m_flags); //reserved bits are all zero
-  i.WriteHtonU16 (m_windowSize);
-  i.WriteHtonU16 (0);
-  i.WriteHtonU16 (m_urgentPointer);
+  uint8_t buffer[20];
+  WriteFixedPart (buffer);
+  i.Write (buffer, 20);
 
   // Serialize options if they exist
   // This implementation does not presently try to align options on word
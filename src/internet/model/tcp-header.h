@@ -298,6 +298,7 @@ public:
   virtual void Print (std::ostream &os) const;
   virtual uint32_t GetSerializedSize (void) const;
   virtual void Serialize (Buffer::Iterator start) const;
+  virtual bool SerializeTo (uint8_t *start, uint32_t packetSize) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
 
   /**
@@ -322,6 +323,13 @@ private:
    */
   uint16_t CalculateHeaderChecksum (uint16_t size) const;
 
+  /**
+   * \brief Write the first 20 bytes of the header (without the options),
+   * with a null checksum
+   * \param buffer the destination
+   */
+  void WriteFixedPart (uint8_t *buffer) const;
+
   /**
    * \brief Calculates the header length (in words)
    *
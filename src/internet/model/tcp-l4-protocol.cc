@@ -40,6 +40,7 @@
 #include "ipv6-l3-protocol.h"
 #include "ipv6-routing-protocol.h"
 #include "tcp-socket-factory-impl.h"
+#include "mptcp-socket-factory.h"
 #include "tcp-socket-base.h"
 #include "tcp-congestion-ops.h"
 #include "tcp-cubic.h"
@@ -130,6 +131,9 @@ TcpL4Protocol::NotifyNewAggregate ()
           Ptr<TcpSocketFactoryImpl> tcpFactory = CreateObject<TcpSocketFactoryImpl> ();
           tcpFactory->SetTcp (this);
           node->AggregateObject (tcpFactory);
+          Ptr<MpTcpSocketFactory> mptcpFactory = CreateObject<MpTcpSocketFactory> ();
+          mptcpFactory->SetTcp (this);
+          node->AggregateObject (mptcpFactory);
         }
     }
 
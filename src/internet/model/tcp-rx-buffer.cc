@@ -155,16 +155,21 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       if (maxSeq < tailSeq) tailSeq = maxSeq;
       if (tailSeq < headSeq) headSeq = tailSeq;
     }
-  // Remove overlapped bytes from packet
-  BufIterator i = m_data.begin ();
+  // Remove overlapped bytes from packet, starting from the block holding
+  // (or following) the head
+  BufIterator i = m_data.upper_bound (headSeq);
+  if (i != m_data.begin ())
+    {
+      --i;
+    }
   while (i != m_data.end () && i->first <= tailSeq)
     {
-      SequenceNumber32 lastByteSeq = i->first + SequenceNumber32 (i->second->GetSize ());
+      SequenceNumber32 lastByteSeq = i->second.tail;
       if (lastByteSeq > headSeq)
         {
           if (i->first > headSeq && lastByteSeq < tailSeq)
-            { // Rare case: Existing packet is embedded fully in the new packet
-              m_size -= i->second->GetSize ();
+            { // Rare case: Existing block is embedded fully in the new packet
+              m_size -= static_cast<uint32_t> (lastByteSeq - i->first);
               m_data.erase (i++);
               continue;
             }
@@ -192,31 +197,70 @@ TcpRxBuffer::Add (Ptr<Packet> p, TcpHeader const& tcph)
       p = p->CreateFragment (start, length);
       NS_ASSERT (length == p->GetSize ());
     }
-  // Insert packet into buffer
+  // Insert packet into buffer: chain it to the block ending at its head,
+  // to the block starting at its tail, or to both (merging them)
   NS_ASSERT (m_data.find (headSeq) == m_data.end ()); // Shouldn't be there yet
-  m_data [ headSeq ] = p;
+  BufIterator next = m_data.lower_bound (tailSeq);
+  if (next != m_data.end () && next->first != tailSeq)
+    {
+      next = m_data.end ();
+    }
+  BufIterator prev = m_data.lower_bound (headSeq);
+  if (prev != m_data.begin () && (--prev)->second.tail == headSeq)
+    {
+      prev->second.segments.push_back (p);
+      prev->second.tail = tailSeq;
+      if (next != m_data.end ())
+        {
+          // Move the segments of the shorter block into the other one
+          std::deque<Ptr<Packet> > &low = prev->second.segments;
+          std::deque<Ptr<Packet> > &high = next->second.segments;
+          if (low.size () >= high.size ())
+            {
+              low.insert (low.end (), high.begin (), high.end ());
+            }
+          else
+            {
+              high.insert (high.begin (), low.begin (), low.end ());
+              low.swap (high);
+            }
+          prev->second.tail = next->second.tail;
+          m_data.erase (next);
+        }
+      i = prev;
+    }
+  else if (next != m_data.end ())
+    {
+      // The block now starts at headSeq
+      std::map<SequenceNumber32, Block>::node_type node = m_data.extract (next);
+      node.key () = headSeq;
+      node.mapped ().segments.push_front (p);
+      i = m_data.insert (std::move (node)).position;
+    }
+  else
+    {
+      Block block;
+      block.tail = tailSeq;
+      block.segments.push_back (p);
+      i = m_data.insert (std::make_pair (headSeq, block)).first;
+    }
 
   if (headSeq > m_nextRxSeq)
     {
-      // Generate a new SACK block
-      UpdateSackList (headSeq, tailSeq);
+      // Generate a new SACK block, covering the whole block of data
+      UpdateSackList (i->first, i->second.tail);
     }
 
   NS_LOG_LOGIC ("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize ());
   // Update variables
   m_size += p->GetSize ();      // Occupancy
-  for (i = m_data.begin (); i != m_data.end (); ++i)
+  // Only the first block can hold the next expected byte; the blocks are
+  // maximal, so no other block follows it without a hole
+  i = m_data.begin ();
+  if (i->first <= m_nextRxSeq && i->second.tail > m_nextRxSeq)
     {
-      if (i->first < m_nextRxSeq)
-        {
-          continue;
-        }
-      else if (i->first > m_nextRxSeq)
-        {
-          break;
-        };
-      m_nextRxSeq = i->first + SequenceNumber32 (i->second->GetSize ());
-      m_availBytes += i->second->GetSize ();
+      m_availBytes += static_cast<uint32_t> (i->second.tail - m_nextRxSeq);
+      m_nextRxSeq = i->second.tail;
       ClearSackList (m_nextRxSeq);
     }
   NS_LOG_LOGIC ("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
@@ -274,7 +318,9 @@ TcpRxBuffer::UpdateSackList (const SequenceNumber32 &head, const SequenceNumber3
   m_sackList.push_front (current);
 
   // We have inserted the block at the beginning of the list. Now, we should
-  // check if any existing blocks overlap with that.
+  // check if any existing blocks overlap with that. The block covers all the
+  // contiguous data around the new segment, so the older blocks are usually
+  // parts of it (point (c) above): remove them.
   bool updated = false;
   TcpOptionSack::SackList::iterator it = m_sackList.begin ();
   TcpOptionSack::SackBlock begin = *it;
@@ -286,6 +332,12 @@ TcpRxBuffer::UpdateSackList (const SequenceNumber32 &head, const SequenceNumber3
     {
       current = *it;
 
+      if (begin.first <= current.first && current.second <= begin.second)
+        {
+          it = m_sackList.erase (it);
+          continue;
+        }
+
       // This is a left merge:
       // [current_first; current_second] [beg_first; beg_second]
       if (begin.first == current.second)
@@ -327,9 +379,8 @@ TcpRxBuffer::UpdateSackList (const SequenceNumber32 &head, const SequenceNumber3
     }
 
   // Please note that, if a block b is discarded and then a block contiguous
-  // to b is received, only that new block (without the b part) is reported.
-  // This is perfectly fine for the RFC point (a), given that we do not report any
-  // overlapping blocks shortly after.
+  // to b is received, the reported block includes b again, as required by
+  // the RFC point (a).
 }
 
 void
@@ -370,38 +421,52 @@ TcpRxBuffer::Extract (uint32_t maxSize)
   if (extractSize == 0) return nullptr;  // No contiguous block to return
   NS_ASSERT (m_data.size ()); // At least we have something to extract
   Ptr<Packet> outPkt = Create<Packet> (); // The packet that contains all the data to return
-  BufIterator i;
+  // The available bytes are all in the first block
+  BufIterator i = m_data.begin ();
+  NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
+  std::deque<Ptr<Packet> > &segments = i->second.segments;
+  uint32_t extracted = 0;
   while (extractSize)
     { // Check the buffered data for delivery
-      i = m_data.begin ();
-      NS_ASSERT (i->first <= m_nextRxSeq); // in-sequence data expected
+      NS_ASSERT (!segments.empty ());
+      Ptr<Packet> segment = segments.front ();
       // Check if we send the whole pkt or just a partial
-      uint32_t pktSize = i->second->GetSize ();
+      uint32_t pktSize = segment->GetSize ();
       if (pktSize <= extractSize)
         { // Whole packet is extracted
-          outPkt->AddAtEnd (i->second);
-          m_data.erase (i);
-          m_size -= pktSize;
-          m_availBytes -= pktSize;
+          outPkt->AddAtEnd (segment);
+          segments.pop_front ();
+          extracted += pktSize;
           extractSize -= pktSize;
         }
       else
-        { // Partial is extracted and done
-          outPkt->AddAtEnd (i->second->CreateFragment (0, extractSize));
-          m_data[i->first + SequenceNumber32 (extractSize)] = i->second->CreateFragment (extractSize, pktSize - extractSize);
-          m_data.erase (i);
-          m_size -= extractSize;
-          m_availBytes -= extractSize;
+        { // Partial is extracted and done; the segment is ours, trim it
+          outPkt->AddAtEnd (segment->CreateFragment (0, extractSize));
+          segment->RemoveAtStart (extractSize);
+          extracted += extractSize;
           extractSize = 0;
         }
     }
+  m_size -= extracted;
+  m_availBytes -= extracted;
+  if (segments.empty ())
+    {
+      m_data.erase (i);
+    }
+  else
+    {
+      // The block now starts after the extracted bytes
+      std::map<SequenceNumber32, Block>::node_type node = m_data.extract (i);
+      node.key () = node.key () + SequenceNumber32 (extracted);
+      m_data.insert (m_data.begin (), std::move (node));
+    }
   if (outPkt->GetSize () == 0)
     {
       NS_LOG_LOGIC ("Nothing extracted.");
       return nullptr;
     }
   NS_LOG_LOGIC ("Extracted " << outPkt->GetSize ( ) << " bytes, bufsize=" << m_size
-                             << ", num pkts in buffer=" << m_data.size ());
+                             << ", num blocks in buffer=" << m_data.size ());
   return outPkt;
 }
 
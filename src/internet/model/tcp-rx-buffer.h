@@ -21,6 +21,7 @@
 #ifndef TCP_RX_BUFFER_H
 #define TCP_RX_BUFFER_H
 
+#include <deque>
 #include <map>
 #include "ns3/traced-value.h"
 #include "ns3/trace-source-accessor.h"
@@ -53,6 +54,13 @@ class Packet;
  * To store data, use Add; for retrieving a certain amount of ordered data, use
  * the method Extract.
  *
+ * The data is stored as a set of disjoint blocks of contiguous bytes: a
+ * segment which touches a block is chained to it, and a segment which fills
+ * the hole between two blocks merges them. The buffer has therefore one
+ * entry per hole in the sequence space, whatever the number of segments
+ * received out of order, and the SACK blocks are the stored blocks
+ * themselves.
+ *
  * SACK list
  * ---------
  *
@@ -217,15 +225,26 @@ private:
 
   TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
+  /**
+   * \brief Contiguous bytes stored in the buffer
+   *
+   * The block starts at the sequence number used as its key in m_data.
+   */
+  struct Block
+  {
+    SequenceNumber32 tail;               //!< Seqnum following the last byte of the block
+    std::deque<Ptr<Packet> > segments;   //!< Segments making the block, in order
+  };
+
   /// container for data stored in the buffer
-  typedef std::map<SequenceNumber32, Ptr<Packet> >::iterator BufIterator;
+  typedef std::map<SequenceNumber32, Block>::iterator BufIterator;
   TracedValue<SequenceNumber32> m_nextRxSeq; //!< Seqnum of the first missing byte in data (RCV.NXT)
   SequenceNumber32 m_finSeq;                 //!< Seqnum of the FIN packet
   bool m_gotFin;                             //!< Did I received FIN packet?
   uint32_t m_size;                           //!< Number of total data bytes in the buffer, not necessarily contiguous
   uint32_t m_maxBuffer;                      //!< Upper bound of the number of data bytes in buffer (RCV.WND)
   uint32_t m_availBytes;                     //!< Number of bytes available to read, i.e. contiguous block at head
-  std::map<SequenceNumber32, Ptr<Packet> > m_data; //!< Corresponding data (may be null)
+  std::map<SequenceNumber32, Block> m_data; //!< Corresponding data, by first seqnum of the blocks
 };
 
 } //namespace ns3
@@ -52,6 +52,7 @@
 #include "tcp-rx-buffer.h"
 #include "rtt-estimator.h"
 #include "tcp-header.h"
+#include "tcp-tso-tag.h"
 #include "tcp-option-winscale.h"
 #include "tcp-option-ts.h"
 #include "tcp-option-sack-permitted.h"
@@ -62,6 +63,7 @@
 
 #include <math.h>
 #include <algorithm>
+#include <limits>
 
 namespace ns3 {
 
@@ -147,6 +149,16 @@ TcpSocketBase::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&TcpSocketBase::m_limitedTx),
                    MakeBooleanChecker ())
+    .AddAttribute ("Tso",
+                   "Send the consecutive segments sent at once as a super-segment, "
+                   "cut into segments by the IP layer (IPv4 only)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&TcpSocketBase::m_tso),
+                   MakeBooleanChecker ())
+    .AddAttribute ("TsoMaxSize", "Maximum payload size of a super-segment",
+                   UintegerValue (64000),
+                   MakeUintegerAccessor (&TcpSocketBase::m_tsoMaxSize),
+                   MakeUintegerChecker<uint32_t> (1, 65000))
     .AddAttribute ("UseEcn", "Parameter to set ECN functionality",
                    EnumValue (TcpSocketState::Off),
                    MakeEnumAccessor (&TcpSocketBase::SetUseEcn),
@@ -354,6 +366,8 @@ TcpSocketBase::TcpSocketBase (const TcpSocketBase& sock)
     m_txTrace (sock.m_txTrace),
     m_rxTrace (sock.m_rxTrace),
     m_pacingTimer (Timer::CANCEL_ON_DESTROY),
+    m_tso (sock.m_tso),
+    m_tsoMaxSize (sock.m_tsoMaxSize),
     m_ecnEchoSeq (sock.m_ecnEchoSeq),
     m_ecnCESeq (sock.m_ecnCESeq),
     m_ecnCWRSeq (sock.m_ecnCWRSeq)
@@ -3135,8 +3149,7 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
 
   if (m_endPoint)
     {
-      m_tcp->SendPacket (p, header, m_endPoint->GetLocalAddress (),
-                         m_endPoint->GetPeerAddress (), m_boundnetdevice);
+      SendSegment (p, header);
       NS_LOG_DEBUG ("Send segment of size " << sz << " with remaining data " <<
                     remainingData << " via TcpL4Protocol to " <<  m_endPoint->GetPeerAddress () <<
                     ". Header " << header);
@@ -3169,6 +3182,63 @@ TcpSocketBase::SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool with
   return sz;
 }
 
+void
+TcpSocketBase::SendSegment (Ptr<Packet> p, const TcpHeader &header)
+{
+  NS_LOG_FUNCTION (this << p << header);
+  if (!m_tsoGather || (header.GetFlags () & (TcpHeader::SYN | TcpHeader::FIN | TcpHeader::RST)))
+    {
+      SendSuperSegment ();
+      m_tcp->SendPacket (p, header, m_endPoint->GetLocalAddress (),
+                         m_endPoint->GetPeerAddress (), m_boundnetdevice);
+      return;
+    }
+  if (m_tsoPacket)
+    {
+      // The options only depend on the receive side and on the time, which
+      // do not change while SendPendingData sends.
+      TcpHeader next = header;
+      next.SetSequenceNumber (m_tsoHeader.GetSequenceNumber ());
+      if (next == m_tsoHeader
+          && next.GetOptionLength () == m_tsoHeader.GetOptionLength ()
+          && header.GetSequenceNumber () == m_tsoHeader.GetSequenceNumber () + m_tsoPacket->GetSize ()
+          && m_tsoPacket->GetSize () == m_tsoSegmentSize * m_tsoSegments
+          && p->GetSize () <= m_tsoSegmentSize
+          && m_tsoPacket->GetSize () + p->GetSize () <= m_tsoMaxSize
+          && m_tsoSegments < std::numeric_limits<uint16_t>::max ())
+        {
+          m_tsoPacket->AddAtEnd (p);
+          ++m_tsoSegments;
+          return;
+        }
+      SendSuperSegment ();
+    }
+  m_tsoPacket = p;
+  m_tsoHeader = header;
+  m_tsoSegmentSize = p->GetSize ();
+  m_tsoSegments = 1;
+}
+
+void
+TcpSocketBase::SendSuperSegment (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_tsoPacket)
+    {
+      return;
+    }
+  if (m_tsoSegments > 1)
+    {
+      m_tsoPacket->AddPacketTag (TcpTsoTag (m_tsoSegmentSize, m_tsoSegments));
+      NS_LOG_DEBUG ("Send super-segment of " << m_tsoSegments << " segments of " <<
+                    m_tsoSegmentSize << " bytes, " << m_tsoPacket->GetSize () << " bytes in all");
+    }
+  Ptr<Packet> p = m_tsoPacket;
+  m_tsoPacket = 0;
+  m_tcp->SendPacket (p, m_tsoHeader, m_endPoint->GetLocalAddress (),
+                     m_endPoint->GetPeerAddress (), m_boundnetdevice);
+}
+
 void
 TcpSocketBase::UpdateRttHistory (const SequenceNumber32 &seq, uint32_t sz,
                                  bool isRetransmission)
@@ -3211,6 +3281,8 @@ TcpSocketBase::SendPendingData (bool withAck)
 
   uint32_t nPacketsSent = 0;
   uint32_t availableWindow = AvailableWindow ();
+  // With pacing, the segments are not sent at once
+  m_tsoGather = m_tso && m_endPoint != nullptr && !IsPacingEnabled ();
 
   // RFC 6675, Section (C)
   // If cwnd - pipe >= 1 SMSS, the sender SHOULD transmit one or more
@@ -3337,6 +3409,8 @@ TcpSocketBase::SendPendingData (bool withAck)
       // (C.5) If cwnd - pipe >= 1 SMSS, return to (C.1)
       // loop again!
     }
+  m_tsoGather = false;
+  SendSuperSegment ();
 
   if (nPacketsSent > 0)
     {
@@ -3436,6 +3510,10 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
   NS_LOG_DEBUG ("Data segment, seq=" << tcpHeader.GetSequenceNumber () <<
                 " pkt size=" << p->GetSize () );
 
+  // A super-segment (see TcpTsoTag) counts as the segments it stands for
+  TcpTsoTag tsoTag;
+  uint32_t segments = p->RemovePacketTag (tsoTag) ? tsoTag.GetSegmentCount () : 1;
+
   // Put into Rx buffer
   SequenceNumber32 expectedSeq = m_tcb->m_rxBuffer->NextRxSequence ();
   if (!m_tcb->m_rxBuffer->Add (p, tcpHeader))
@@ -3489,7 +3567,8 @@ TcpSocketBase::ReceivedData (Ptr<Packet> p, const TcpHeader& tcpHeader)
     }
   else
     { // In-sequence packet: ACK if delayed ack count allows
-      if (++m_delAckCount >= m_delAckMaxCount)
+      m_delAckCount += segments;
+      if (m_delAckCount >= m_delAckMaxCount)
         {
           m_delAckEvent.Cancel ();
           m_delAckCount = 0;
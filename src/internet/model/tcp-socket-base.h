@@ -32,6 +32,7 @@
 #include "ns3/data-rate.h"
 #include "ns3/node.h"
 #include "ns3/tcp-socket-state.h"
+#include "ns3/tcp-header.h"
 
 namespace ns3 {
 
@@ -780,6 +781,25 @@ protected:
    */
   virtual uint32_t SendDataPacket (SequenceNumber32 seq, uint32_t maxSize, bool withAck);
 
+  /**
+   * \brief Hand a data segment to TcpL4Protocol, or gather it into the
+   * super-segment being built
+   *
+   * While SendPendingData gathers a super-segment (TSO), the segments with
+   * the same header as the previous ones (but their sequence number), which
+   * follow them and are full-sized, are appended to it; any other segment
+   * first sends the super-segment.
+   *
+   * \param p the payload of the segment
+   * \param header the TCP header of the segment
+   */
+  void SendSegment (Ptr<Packet> p, const TcpHeader &header);
+
+  /**
+   * \brief Send the super-segment gathered by SendSegment, if any
+   */
+  void SendSuperSegment (void);
+
   /**
    * \brief Send a empty packet that carries a flag, e.g., ACK
    *
@@ -1343,6 +1363,15 @@ protected:
   // Pacing related variable
   Timer m_pacingTimer {Timer::CANCEL_ON_DESTROY}; //!< Pacing Event
 
+  // Segmentation offload
+  bool        m_tso         {false}; //!< Send consecutive segments as super-segments
+  uint32_t    m_tsoMaxSize  {0};     //!< Maximum payload size of a super-segment
+  bool        m_tsoGather   {false}; //!< SendPendingData is gathering a super-segment
+  Ptr<Packet> m_tsoPacket;           //!< Payload of the super-segment being gathered
+  TcpHeader   m_tsoHeader;           //!< Header of the super-segment being gathered
+  uint32_t    m_tsoSegmentSize {0};  //!< Payload size of the segments of the super-segment
+  uint16_t    m_tsoSegments {0};     //!< Number of segments in the super-segment
+
   // Parameters related to Explicit Congestion Notification
   TracedValue<SequenceNumber32> m_ecnEchoSeq {0};      //!< Sequence number of the last received ECN Echo
   TracedValue<SequenceNumber32> m_ecnCESeq   {0};      //!< Sequence number of the last received Congestion Experienced
@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-tso-tag.h"
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (TcpTsoTag);
+
+TypeId
+TcpTsoTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TcpTsoTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<TcpTsoTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+TcpTsoTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+TcpTsoTag::TcpTsoTag ()
+  : m_segmentSize (0),
+    m_segmentCount (0)
+{
+}
+
+TcpTsoTag::TcpTsoTag (uint16_t segmentSize, uint16_t segmentCount)
+  : m_segmentSize (segmentSize),
+    m_segmentCount (segmentCount)
+{
+}
+
+uint32_t
+TcpTsoTag::GetSerializedSize (void) const
+{
+  return 4;
+}
+
+void
+TcpTsoTag::Serialize (TagBuffer buf) const
+{
+  buf.WriteU16 (m_segmentSize);
+  buf.WriteU16 (m_segmentCount);
+}
+
+void
+TcpTsoTag::Deserialize (TagBuffer buf)
+{
+  m_segmentSize = buf.ReadU16 ();
+  m_segmentCount = buf.ReadU16 ();
+}
+
+void
+TcpTsoTag::Print (std::ostream &os) const
+{
+  os << "SegmentSize=" << m_segmentSize << " SegmentCount=" << m_segmentCount;
+}
+
+uint16_t
+TcpTsoTag::GetSegmentSize (void) const
+{
+  return m_segmentSize;
+}
+
+uint16_t
+TcpTsoTag::GetSegmentCount (void) const
+{
+  return m_segmentCount;
+}
+
+} // namespace ns3
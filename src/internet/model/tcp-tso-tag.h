@@ -0,0 +1,77 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TCP_TSO_TAG_H
+#define TCP_TSO_TAG_H
+
+#include "ns3/tag.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Marks a TCP super-segment
+ *
+ * With segmentation offload (see the TcpSocketBase "Tso" attribute), a
+ * socket sends several consecutive segments with identical headers as one
+ * packet, carrying this tag.  The packet stands for SegmentCount segments of
+ * SegmentSize bytes (the last one may be shorter).  Ipv4L3Protocol cuts it
+ * into these segments before its SendOutgoing trace, unless its
+ * "TsoCarryWhole" attribute is set and the super-segment fits in the MTU
+ * of the output device: it is then carried whole, and the receiving socket
+ * processes it at once (as a GRO packet).
+ */
+class TcpTsoTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual TypeId GetInstanceTypeId (void) const;
+  virtual uint32_t GetSerializedSize (void) const;
+  virtual void Serialize (TagBuffer buf) const;
+  virtual void Deserialize (TagBuffer buf);
+  virtual void Print (std::ostream &os) const;
+
+  TcpTsoTag ();
+  /**
+   * \brief Constructor
+   * \param segmentSize size of the payload of the segments
+   * \param segmentCount number of segments
+   */
+  TcpTsoTag (uint16_t segmentSize, uint16_t segmentCount);
+
+  /**
+   * \brief Get the size of the segments payload
+   * \return the size of the segments payload
+   */
+  uint16_t GetSegmentSize (void) const;
+  /**
+   * \brief Get the number of segments
+   * \return the number of segments in the super-segment
+   */
+  uint16_t GetSegmentCount (void) const;
+
+private:
+  uint16_t m_segmentSize;  //!< Size of the payload of the segments
+  uint16_t m_segmentCount; //!< Number of segments
+};
+
+} // namespace ns3
+
+#endif /* TCP_TSO_TAG_H */
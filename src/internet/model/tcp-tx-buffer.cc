@@ -58,7 +58,8 @@ TcpTxBuffer::GetTypeId (void)
  * initialized below is insignificant.
  */
 TcpTxBuffer::TcpTxBuffer (uint32_t n)
-  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n)
+  : m_maxBuffer (32768), m_size (0), m_sentSize (0), m_firstByteSeq (n),
+    m_lostFrontier (n), m_lostHigh (n), m_nextSegHint (n)
 {
   m_rWndCallback = MakeNullCallback<uint32_t> ();
 }
@@ -174,6 +175,7 @@ TcpTxBuffer::SetHeadSequence (const SequenceNumber32& seq)
   // if you change the head with data already sent, something bad will happen
   NS_ASSERT (m_sentList.size () == 0);
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_lostFrontier = m_lostHigh = m_nextSegHint = seq;
 }
 
 bool
@@ -296,7 +298,8 @@ TcpTxBuffer::GetNewSegment (uint32_t numBytes)
   NS_ASSERT (it != m_appList.end ());
 
   m_appList.erase (it);
-  m_sentList.insert (m_sentList.end (), item);
+  m_sentIndex.insert (m_sentIndex.end (),
+                      std::make_pair (item->m_startSeq, m_sentList.insert (m_sentList.end (), item)));
   m_sentSize += item->m_packet->GetSize ();
 
   return item;
@@ -310,36 +313,33 @@ TcpTxBuffer::GetTransmittedSegment (uint32_t numBytes, const SequenceNumber32 &s
   NS_ASSERT (numBytes <= m_sentSize);
   NS_ASSERT (m_sentList.size () >= 1);
 
-  auto it = m_sentList.begin ();
   bool listEdited = false;
   uint32_t s = numBytes;
 
   // Avoid to merge different packet for this retransmission if flags are
   // different.
-  for (; it != m_sentList.end(); ++it)
+  auto entry = m_sentIndex.find (seq);
+  if (entry != m_sentIndex.end ())
     {
-      if ((*it)->m_startSeq == seq)
+      auto it = entry->second;
+      auto next = it;
+      next++;
+      if (next != m_sentList.end ())
         {
-          auto next = it;
-          next++;
-          if (next != m_sentList.end ())
+          // Next is not sacked and have the same value for m_lost ... there is the possibility to merge
+          if ((! (*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
             {
-              // Next is not sacked and have the same value for m_lost ... there is the possibility to merge
-              if ((! (*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                  s = std::min(s, (*it)->m_packet->GetSize () + (*next)->m_packet->GetSize ());
-                }
-              else
-                {
-                  // Next is sacked... better to retransmit only the first segment
-                  s = std::min(s, (*it)->m_packet->GetSize ());
-                }
+              s = std::min(s, (*it)->m_packet->GetSize () + (*next)->m_packet->GetSize ());
             }
           else
             {
+              // Next is sacked... better to retransmit only the first segment
               s = std::min(s, (*it)->m_packet->GetSize ());
             }
-          break;
+        }
+      else
+        {
+          s = std::min(s, (*it)->m_packet->GetSize ());
         }
     }
 
@@ -376,6 +376,29 @@ TcpTxBuffer::FindHighestSacked () const
   return ret;
 }
 
+TcpTxBuffer::SentIndex::const_iterator
+TcpTxBuffer::FindSentItem (const SequenceNumber32 &seq) const
+{
+  NS_ASSERT (!m_sentIndex.empty () && seq >= m_firstByteSeq);
+
+  // The last item starting at, or before, seq
+  SentIndex::const_iterator entry = m_sentIndex.upper_bound (seq);
+  NS_ASSERT (entry != m_sentIndex.begin ());
+  return --entry;
+}
+
+void
+TcpTxBuffer::ClampScoreboardBounds (void)
+{
+  SequenceNumber32 head = m_firstByteSeq.Get ();
+  SequenceNumber32 tail = head + m_sentSize;
+
+  // Stale bounds outside the sent list would be meaningless (and could
+  // compare wrongly once the sequence numbers wrap around)
+  m_lostFrontier = std::min (std::max (m_lostFrontier, head), tail);
+  m_lostHigh = std::min (std::max (m_lostHigh, head), tail);
+  m_nextSegHint = std::min (std::max (m_nextSegHint, head), tail);
+}
 
 void
 TcpTxBuffer::SplitItems (TcpTxItem *t1, TcpTxItem *t2, uint32_t size) const
@@ -437,11 +460,22 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
   PacketList::iterator it = list.begin ();
   SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+  // The sent list is indexed: start from the item holding seq, and keep the
+  // index in sync with the splits and merges made below
+  SentIndex *index = nullptr;
+  if (&list == &m_sentList)
+    {
+      index = &const_cast<TcpTxBuffer*> (this)->m_sentIndex;
+      SentIndex::const_iterator entry = FindSentItem (seq);
+      it = entry->second;
+      beginOfCurrentPacket = entry->first;
+    }
+
   while (it != list.end ())
     {
       currentItem = *it;
       currentPacket = currentItem->m_packet;
-      NS_ASSERT_MSG (list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+      NS_ASSERT_MSG (&list != &m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
                      "start: " << m_firstByteSeq << " currentItem start: " <<
                      currentItem->m_startSeq);
 
@@ -471,7 +505,12 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
               SplitItems (firstPart, currentItem, seq - beginOfCurrentPacket);
 
               // insert firstPart before currentItem
-              list.insert (it, firstPart);
+              PacketList::iterator first = list.insert (it, firstPart);
+              if (index != nullptr)
+                {
+                  (*index)[firstPart->m_startSeq] = first;
+                  (*index)[currentItem->m_startSeq] = it;
+                }
               if (listEdited)
                 {
                   *listEdited = true;
@@ -515,8 +554,13 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
                   // current > outPacket in the list. Merge current with the
                   // previous, and recurse.
                   NS_ASSERT (it != list.begin ());
-                  TcpTxItem *previous = *(--it);
+                  PacketList::iterator prev = it;
+                  TcpTxItem *previous = *(--prev);
 
+                  if (index != nullptr)
+                    {
+                      index->erase (currentItem->m_startSeq);
+                    }
                   list.erase (it);
 
                   MergeItems (previous, currentItem);
@@ -537,7 +581,12 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
               SplitItems (firstPart, currentItem, numBytes);
 
               // insert firstPart before currentItem
-              list.insert (it, firstPart);
+              PacketList::iterator first = list.insert (it, firstPart);
+              if (index != nullptr)
+                {
+                  (*index)[firstPart->m_startSeq] = first;
+                  (*index)[currentItem->m_startSeq] = it;
+                }
               if (listEdited)
                 {
                   *listEdited = true;
@@ -566,6 +615,10 @@ TcpTxBuffer::GetPacketFromList (PacketList &list, const SequenceNumber32 &listSt
                                    // in the previous if
 
           MergeItems (currentItem, next);
+          if (index != nullptr)
+            {
+              index->erase (next->m_startSeq);
+            }
           list.erase (it);
 
           delete next;
@@ -650,16 +703,18 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked (const SequenceNumber32& ack) const
 {
   NS_LOG_FUNCTION (this);
-  for (const auto &it : m_sentList)
-     {
-       TcpTxItem *item = it;
-       Ptr<Packet> p = item->m_packet;
-       if (item->m_startSeq + p->GetSize () == ack && !item->m_sacked && item->m_retrans)
-         {
-           return true;
-         }
-     }
-  return false;
+
+  // Only the item holding the byte before ack can end at ack
+  SentIndex::const_iterator entry = m_sentIndex.lower_bound (ack);
+  if (entry == m_sentIndex.begin ())
+    {
+      return false;
+    }
+  --entry;
+
+  TcpTxItem *item = *entry->second;
+  Ptr<Packet> p = item->m_packet;
+  return item->m_startSeq + p->GetSize () == ack && !item->m_sacked && item->m_retrans;
 }
 
 void
@@ -708,6 +763,8 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
 
           RemoveFromCounts (item, pktSize);
 
+          NS_ASSERT (m_sentIndex.begin ()->second == i);
+          m_sentIndex.erase (m_sentIndex.begin ());
           i = m_sentList.erase (i);
           NS_LOG_INFO ("Removed " << *item << " lost: " << m_lostOut <<
                        " retrans: " << m_retrans << " sacked: " << m_sackedOut <<
@@ -727,7 +784,9 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
           NS_LOG_INFO (*item);
           // PacketTags are preserved when fragmenting
           item->m_packet = item->m_packet->CreateFragment (offset, pktSize);
+          m_sentIndex.erase (m_sentIndex.begin ());
           item->m_startSeq += offset;
+          m_sentIndex.insert (m_sentIndex.begin (), std::make_pair (item->m_startSeq, i));
           m_size -= offset;
           m_sentSize -= offset;
           m_firstByteSeq += offset;
@@ -745,6 +804,7 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
     {
       m_firstByteSeq = seq;
     }
+  ClampScoreboardBounds ();
 
   if (!m_sentList.empty ())
     {
@@ -757,6 +817,7 @@ TcpTxBuffer::DiscardUpTo (const SequenceNumber32& seq,
           // when adding Reno dupacks in the count.
           head->m_sacked = false;
           m_sackedOut -= head->m_packet->GetSize ();
+          m_nextSegHint = m_firstByteSeq;
           NS_LOG_INFO ("Moving the SACK flag from the HEAD to another segment");
           AddRenoSack ();
           MarkHeadAsLost ();
@@ -791,15 +852,21 @@ TcpTxBuffer::Update (const TcpOptionSack::SackList &list,
 
   for (auto option_it = list.begin (); option_it != list.end (); ++option_it)
     {
-      PacketList::iterator item_it = m_sentList.begin ();
-      SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
       if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
           NS_LOG_INFO ("Not updating scoreboard, the option block is outside the sent list");
           return bytesSacked;
         }
 
+      // Only the items starting inside the block can be sacked by it
+      SentIndex::iterator entry = m_sentIndex.lower_bound ((*option_it).first);
+      if (entry == m_sentIndex.end ())
+        {
+          continue;
+        }
+      PacketList::iterator item_it = entry->second;
+      SequenceNumber32 beginOfCurrentPacket = entry->first;
+
       while (item_it != m_sentList.end ())
         {
           uint32_t pktSize = (*item_it)->m_packet->GetSize ();
@@ -893,6 +960,8 @@ TcpTxBuffer::UpdateLostCount ()
                    ", will start from item " << *(*m_highestSack.first));
     }
 
+  SequenceNumber32 frontier = m_lostFrontier;
+  bool marking = false;
   for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
     {
       TcpTxItem *item = *it;
@@ -903,6 +972,17 @@ TcpTxBuffer::UpdateLostCount ()
 
       if (sacked >= m_dupAckThresh)
         {
+          if (item->m_startSeq < m_lostFrontier)
+            {
+              // This item and the ones below are already sacked or lost
+              break;
+            }
+          if (!marking)
+            {
+              // Once marked, everything up to this item is sacked or lost
+              marking = true;
+              frontier = std::max (frontier, item->m_startSeq + item->m_packet->GetSize ());
+            }
           if (!item->m_sacked && !item->m_lost)
             {
               item->m_lost = true;
@@ -920,6 +1000,9 @@ TcpTxBuffer::UpdateLostCount ()
           item->m_lost = true;
           m_lostOut += item->m_packet->GetSize ();
         }
+      frontier = std::max (frontier, item->m_startSeq + item->m_packet->GetSize ());
+      m_lostFrontier = frontier;
+      m_lostHigh = std::max (m_lostHigh, m_lostFrontier);
     }
   NS_LOG_INFO ("Status after the update: " << *this);
   ConsistencyCheck ();
@@ -930,35 +1013,38 @@ TcpTxBuffer::IsLost (const SequenceNumber32 &seq) const
 {
   NS_LOG_FUNCTION (this << seq);
 
-  SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-  PacketList::const_iterator it;
-
   if (seq >= m_highestSack.second)
     {
       return false;
     }
 
-  // In theory, using a map and hints when inserting elements can improve
-  // performance
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // Search for the first item starting from seq which is lost or sacked.
+  // Below the lost frontier it is the first item; from m_lostHigh on no
+  // item is lost, so the answer is no.
+  SentIndex::const_iterator entry = m_sentIndex.lower_bound (seq);
+  if (entry == m_sentIndex.end ())
+    {
+      return false;
+    }
+
+  for (PacketList::const_iterator it = entry->second; it != m_sentList.end (); ++it)
     {
-      // Search for the right iterator before calling IsLost()
-      if (beginOfCurrentPacket >= seq)
+      if ((*it)->m_lost == true)
         {
-          if ((*it)->m_lost == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
-              return true;
-            }
+          NS_LOG_INFO ("seq=" << seq << " is lost because of lost flag");
+          return true;
+        }
 
-          if ((*it)->m_sacked == true)
-            {
-              NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
-              return false;
-            }
+      if ((*it)->m_sacked == true)
+        {
+          NS_LOG_INFO ("seq=" << seq << " is not lost because of sacked flag");
+          return false;
         }
 
-      beginOfCurrentPacket += (*it)->m_packet->GetSize ();
+      if ((*it)->m_startSeq >= m_lostHigh)
+        {
+          break;
+        }
     }
 
   return false;
@@ -986,15 +1072,31 @@ TcpTxBuffer::NextSeg (SequenceNumber32 *seq, SequenceNumber32 *seqHigh, bool isR
   TcpTxItem *item;
   SequenceNumber32 seqPerRule3;
   bool isSeqPerRule3Valid = false;
+  bool isHintValid = false;
   SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
 
-  for (it = m_sentList.begin (); it != m_sentList.end (); ++it)
+  // The items below the hint are retransmitted or sacked: skip them
+  it = m_sentList.end ();
+  SentIndex::const_iterator entry = m_sentIndex.lower_bound (m_nextSegHint);
+  if (entry != m_sentIndex.end ())
+    {
+      it = entry->second;
+      beginOfCurrentPkt = entry->first;
+    }
+
+  for (; it != m_sentList.end (); ++it)
     {
       item = *it;
 
       // Condition 1.a , 1.b , and 1.c
       if (item->m_retrans == false && item->m_sacked == false)
         {
+          if (!isHintValid)
+            {
+              m_nextSegHint = beginOfCurrentPkt;
+              isHintValid = true;
+            }
+
           if (item->m_lost)
             {
               NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
@@ -1008,12 +1110,23 @@ TcpTxBuffer::NextSeg (SequenceNumber32 *seq, SequenceNumber32 *seqHigh, bool isR
               isSeqPerRule3Valid = true;
               seqPerRule3 = beginOfCurrentPkt;
             }
+
+          if (beginOfCurrentPkt >= m_lostHigh)
+            {
+              // No item is lost from here
+              break;
+            }
         }
 
       // Nothing found, iterate
       beginOfCurrentPkt += item->m_packet->GetSize ();
     }
 
+  if (!isHintValid)
+    {
+      m_nextSegHint = m_firstByteSeq + m_sentSize;
+    }
+
   /* (2) If no sequence number 'S2' per rule (1) exists but there
    *     exists available unsent data and the receiver's advertised
    *     window allows, the sequence range of one segment of up to SMSS
@@ -1225,6 +1338,7 @@ TcpTxBuffer::ResetRenoSack ()
     }
 
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_lostFrontier = m_nextSegHint = m_firstByteSeq;
 }
 
 void
@@ -1249,11 +1363,13 @@ TcpTxBuffer::ResetSentList ()
       m_sentList.pop_back ();
     }
 
+  m_sentIndex.clear ();
   m_sentSize = 0;
   m_lostOut = 0;
   m_retrans = 0;
   m_sackedOut = 0;
   m_highestSack = std::make_pair (m_sentList.end (), SequenceNumber32 (0));
+  m_lostFrontier = m_lostHigh = m_nextSegHint = m_firstByteSeq;
 }
 
 void
@@ -1265,12 +1381,14 @@ TcpTxBuffer::ResetLastSegmentSent ()
       TcpTxItem *item = m_sentList.back ();
 
       m_sentList.pop_back ();
+      m_sentIndex.erase (--m_sentIndex.end ());
       m_sentSize -= item->m_packet->GetSize ();
       if (item->m_retrans)
         {
           m_retrans -= item->m_packet->GetSize ();
         }
       m_appList.insert (m_appList.begin (), item);
+      ClampScoreboardBounds ();
     }
   ConsistencyCheck ();
 }
@@ -1317,6 +1435,10 @@ TcpTxBuffer::SetSentListLost (bool resetSack)
       (*it)->m_retrans = false;
     }
 
+  // Every item is now sacked or lost, and none is retransmitted
+  m_lostFrontier = m_lostHigh = m_firstByteSeq + m_sentSize;
+  m_nextSegHint = m_firstByteSeq;
+
   NS_LOG_INFO ("Set sent list lost, status: " << *this);
   NS_ASSERT_MSG (m_sentSize >= m_sackedOut + m_lostOut, *this);
   ConsistencyCheck ();
@@ -1349,6 +1471,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead ()
     {
       m_sentList.front ()->m_retrans = false;
       m_retrans -= m_sentList.front ()->m_packet->GetSize ();
+      m_nextSegHint = m_firstByteSeq;
     }
   ConsistencyCheck ();
 }
@@ -1378,6 +1501,11 @@ TcpTxBuffer::MarkHeadAsLost ()
           m_sentList.front()->m_lost = true;
           m_lostOut += m_sentList.front ()->m_packet->GetSize ();
         }
+
+      SequenceNumber32 headEnd = m_firstByteSeq + m_sentList.front ()->m_packet->GetSize ();
+      m_lostFrontier = std::max (m_lostFrontier, headEnd);
+      m_lostHigh = std::max (m_lostHigh, headEnd);
+      m_nextSegHint = m_firstByteSeq;
     }
   ConsistencyCheck ();
 }
@@ -22,6 +22,9 @@
 #ifndef TCP_TX_BUFFER_H
 #define TCP_TX_BUFFER_H
 
+#include <list>
+#include <map>
+
 #include "ns3/object.h"
 #include "ns3/traced-value.h"
 #include "ns3/sequence-number.h"
@@ -90,6 +93,16 @@ class Packet;
  * segments that can be lost (\see UpdateLostCount), and we set the flags
  * accordingly.
  *
+ * With large windows the sent list holds many thousands of items, so the
+ * scoreboard is never walked from its beginning on each ACK. The sent items
+ * are indexed by their first sequence number, which gives the item holding a
+ * SACK block edge or a retransmitted sequence in logarithmic time. Three
+ * bounds summarize the flags: below the "lost frontier" every item is sacked
+ * or lost, from the "lost high" boundary no item is lost, and below the
+ * NextSeg hint every item is sacked or retransmitted. UpdateLostCount, IsLost
+ * and NextSeg walk only the part of the list above these bounds, which makes
+ * their cost amortized constant in the usual recovery phases.
+ *
  * Management of bytes in flight
  * -----------------------------
  *
@@ -411,6 +424,7 @@ private:
   friend std::ostream & operator<< (std::ostream & os, TcpTxBuffer const & tcpTxBuf);
 
   typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+  typedef std::map<SequenceNumber32, PacketList::iterator> SentIndex; //!< sent items, by first sequence number
 
   /**
    * \brief Update the lost count
@@ -427,9 +441,9 @@ private:
    * The {New}Reno cases, for now, are managed in TcpSocketBase through the
    * call to MarkHeadAsLost.
    * This function is, therefore, called after a SACK option has been received,
-   * and updates the lost count. It can be probably optimized by not walking
-   * the entire list, but a subset.
-   *
+   * and updates the lost count. The walk stops at the lost frontier once
+   * enough sacked segments have been counted, since the items below are
+   * already sacked or lost.
    */
   void UpdateLostCount ();
 
@@ -600,6 +614,20 @@ private:
   std::pair <TcpTxBuffer::PacketList::const_iterator, SequenceNumber32>
   FindHighestSacked () const;
 
+  /**
+   * \brief Find the sent item holding a sequence number
+   * \param seq the sequence number, which must be inside the sent list
+   * \return the entry of the item in the index of the sent list
+   */
+  SentIndex::const_iterator FindSentItem (const SequenceNumber32 &seq) const;
+
+  /**
+   * \brief Keep the scoreboard bounds inside the sent list
+   *
+   * Called when the head or the tail of the sent list moves back or forth.
+   */
+  void ClampScoreboardBounds (void);
+
   PacketList m_appList;  //!< Buffer for application data
   PacketList m_sentList; //!< Buffer for sent (but not acked) data
   uint32_t m_maxBuffer;  //!< Max number of data bytes in buffer (SND.WND)
@@ -609,6 +637,10 @@ private:
 
   TracedValue<SequenceNumber32> m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
   std::pair <PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
+  SentIndex m_sentIndex;                   //!< Items of the sent list, by first sequence number
+  SequenceNumber32 m_lostFrontier;         //!< Items starting before are all sacked or lost
+  SequenceNumber32 m_lostHigh;             //!< No item starting from here is lost
+  mutable SequenceNumber32 m_nextSegHint;  //!< Items starting before are all sacked or retransmitted
 
   uint32_t m_lostOut   {0}; //!< Number of lost bytes
   uint32_t m_sackedOut {0}; //!< Number of sacked bytes
@@ -180,41 +180,54 @@ UdpHeader::GetSerializedSize (void) const
   return 8;
 }
 
+void
+UdpHeader::WriteFixedPart (uint8_t *buffer, uint32_t packetSize) const
+{
+  uint16_t length = (m_payloadSize == 0) ? packetSize : m_payloadSize;
+
+  buffer[0] = (m_sourcePort >> 8) & 0xff;
+  buffer[1] = m_sourcePort & 0xff;
+  buffer[2] = (m_destinationPort >> 8) & 0xff;
+  buffer[3] = m_destinationPort & 0xff;
+  buffer[4] = (length >> 8) & 0xff;
+  buffer[5] = length & 0xff;
+  // the checksum is stored in network order already (see WriteU16 below)
+  buffer[6] = m_checksum & 0xff;
+  buffer[7] = (m_checksum >> 8) & 0xff;
+}
+
 void
 UdpHeader::Serialize (Buffer::Iterator start) const
 {
   Buffer::Iterator i = start;
 
-  i.WriteHtonU16 (m_sourcePort);
-  i.WriteHtonU16 (m_destinationPort);
-  if (m_payloadSize == 0)
-    {
-      i.WriteHtonU16 (start.GetSize ());
-    }
-  else
-    {
-      i.WriteHtonU16 (m_payloadSize);
-    }
+  uint8_t buffer[8];
+  WriteFixedPart (buffer, start.GetSize ());
+  i.Write (buffer, 8);
 
-  if ( m_checksum == 0)
+  if (m_checksum == 0 && m_calcChecksum)
     {
-      i.WriteU16 (0);
-
-      if (m_calcChecksum)
-        {
-          uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
-          i = start;
-          uint16_t checksum = i.CalculateIpChecksum (start.GetSize (), headerChecksum);
-
-          i = start;
-          i.Next (6);
-          i.WriteU16 (checksum);
-        }
+      uint16_t headerChecksum = CalculateHeaderChecksum (start.GetSize ());
+      i = start;
+      uint16_t checksum = i.CalculateIpChecksum (start.GetSize (), headerChecksum);
+
+      i = start;
+      i.Next (6);
+      i.WriteU16 (checksum);
     }
-  else
+}
+
+bool
+UdpHeader::SerializeTo (uint8_t *start, uint32_t packetSize) const
+{
+  if (m_checksum == 0 && m_calcChecksum)
     {
-      i.WriteU16 (m_checksum);
+      // the checksum covers the payload, which is only reachable through
+      // a Buffer::Iterator
+      return false;
     }
+  WriteFixedPart (start, packetSize);
+  return true;
 }
 uint32_t
 UdpHeader::Deserialize (Buffer::Iterator start)
@@ -123,6 +123,7 @@ public:
   virtual void Print (std::ostream &os) const;
   virtual uint32_t GetSerializedSize (void) const;
   virtual void Serialize (Buffer::Iterator start) const;
+  virtual bool SerializeTo (uint8_t *start, uint32_t packetSize) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
 
   /**
@@ -173,6 +174,13 @@ private:
    * \returns the checksum
    */
   uint16_t CalculateHeaderChecksum (uint16_t size) const;
+
+  /**
+   * \brief Write the 8 bytes of the header, with the stored checksum
+   * \param buffer the destination
+   * \param packetSize the size of the UDP packet, header included
+   */
+  void WriteFixedPart (uint8_t *buffer, uint32_t packetSize) const;
   uint16_t m_sourcePort;      //!< Source port
   uint16_t m_destinationPort; //!< Destination port
   uint16_t m_payloadSize;     //!< Payload size
@@ -0,0 +1,175 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-end-point-demux.h"
+#include "ns3/ipv4-end-point.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-end-point-demux.h"
+#include "ns3/ipv6-end-point.h"
+#include "ns3/ipv6-interface.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * Check the precedence of the IPv4 endpoint lookups (connection, then
+ * bound address, then listening endpoint) with many connections, and that
+ * endpoints are found after their peer or local address changes.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("IPv4 endpoint demux lookups")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4EndPointDemux demux;
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  Ipv4Address local ("10.0.0.1");
+
+  Ipv4EndPoint *listener = demux.Allocate (0, Ipv4Address::GetAny (), 80);
+  NS_TEST_ASSERT_MSG_NE (listener, 0, "Listening endpoint");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, Ipv4Address::GetAny (), 80), 0, "Port already bound");
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (80), true, "Port in use");
+
+  Ipv4EndPoint *bound = demux.Allocate (0, local, 80);
+  NS_TEST_ASSERT_MSG_NE (bound, 0, "Endpoint bound to an address");
+
+  std::vector<Ipv4EndPoint *> connections;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      Ipv4Address peer (Ipv4Address ("10.1.0.0").Get () + i);
+      connections.push_back (demux.Allocate (0, local, 80, peer, 1024 + i % 7));
+      NS_TEST_ASSERT_MSG_NE (connections.back (), 0, "Connected endpoint");
+    }
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, 80, Ipv4Address ("10.1.0.5"), 1024 + 5), 0, "Duplicated connection");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, 80), 0, "Address already bound");
+
+  Ipv4EndPointDemux::EndPoints found = demux.Lookup (local, 80, Ipv4Address ("10.1.0.42"), 1024 + 42 % 7, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "One endpoint per connection");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), connections[42], "Connection before bound address");
+
+  found = demux.Lookup (local, 80, Ipv4Address ("10.2.0.1"), 5000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Unknown peer");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), bound, "Bound address before listener");
+  found = demux.Lookup (Ipv4Address ("10.0.0.2"), 80, Ipv4Address ("10.2.0.1"), 5000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Other local address");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), listener, "Listener for the other addresses");
+
+  demux.DeAllocate (connections[42]);
+  found = demux.Lookup (local, 80, Ipv4Address ("10.1.0.42"), 1024 + 42 % 7, interface);
+  NS_TEST_EXPECT_MSG_EQ (found.front (), bound, "Closed connection");
+
+  // a client endpoint is connected after its allocation
+  Ipv4EndPoint *client = demux.Allocate ();
+  uint16_t port = client->GetLocalPort ();
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), true, "Ephemeral port in use");
+  found = demux.Lookup (local, port, Ipv4Address ("10.3.0.1"), 80, interface);
+  NS_TEST_EXPECT_MSG_EQ (found.front (), client, "Unconnected client");
+  client->SetPeer (Ipv4Address ("10.3.0.1"), 80);
+  client->SetLocalAddress (local);
+  found = demux.Lookup (local, port, Ipv4Address ("10.3.0.1"), 80, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Connected client");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), client, "Connected client");
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, Ipv4Address ("10.3.0.2"), 80, interface).size (), 0, "Other peer");
+
+  client->SetRxEnabled (false);
+  NS_TEST_EXPECT_MSG_EQ (demux.Lookup (local, port, Ipv4Address ("10.3.0.1"), 80, interface).size (), 0, "Rx disabled");
+
+  demux.DeAllocate (client);
+  NS_TEST_EXPECT_MSG_EQ (demux.LookupPortLocal (port), false, "Ephemeral port released");
+  NS_TEST_EXPECT_MSG_EQ (demux.GetAllEndPoints ().size (), 1000 + 1, "Remaining endpoints");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * Check the precedence of the IPv6 endpoint lookups, and that endpoints
+ * are found after their peer changes.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+  virtual void DoRun (void);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("IPv6 endpoint demux lookups")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6EndPointDemux demux;
+  Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+  Ipv6Address local ("2001:db8::1");
+  Ipv6Address peer ("2001:db8::2");
+
+  Ipv6EndPoint *listener = demux.Allocate (0, Ipv6Address::GetAny (), 80);
+  Ipv6EndPoint *connection = demux.Allocate (0, local, 80, peer, 4000);
+  NS_TEST_ASSERT_MSG_NE (connection, 0, "Connected endpoint");
+  NS_TEST_EXPECT_MSG_EQ (demux.Allocate (0, local, 80, peer, 4000), 0, "Duplicated connection");
+
+  Ipv6EndPointDemux::EndPoints found = demux.Lookup (local, 80, peer, 4000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "One endpoint per connection");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), connection, "Connection before listener");
+  found = demux.Lookup (local, 80, peer, 4001, interface);
+  NS_TEST_EXPECT_MSG_EQ (found.front (), listener, "Listener for new connections");
+
+  // connected, but not bound to an address
+  Ipv6EndPoint *client = demux.Allocate ();
+  client->SetPeer (peer, 443);
+  found = demux.Lookup (local, client->GetLocalPort (), peer, 443, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Client connected from Any");
+  NS_TEST_EXPECT_MSG_EQ (found.front (), client, "Client connected from Any");
+
+  demux.DeAllocate (connection);
+  found = demux.Lookup (local, 80, peer, 4000, interface);
+  NS_TEST_EXPECT_MSG_EQ (found.front (), listener, "Closed connection");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Endpoint demux TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase (), TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase (), TestCase::QUICK);
+  }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite; //!< Static variable for test initialization
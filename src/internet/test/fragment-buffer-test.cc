@@ -0,0 +1,232 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/fragment-buffer.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the reassembly of fragments received in any order, with
+ * holes, duplicates and overlaps.
+ */
+class FragmentBufferTestCase : public TestCase
+{
+public:
+  FragmentBufferTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Create a fragment of a packet whose byte i is i % 256
+   * \param offset the offset of the fragment
+   * \param size the size of the fragment
+   * \return the fragment
+   */
+  Ptr<Packet> MakeFragment (uint32_t offset, uint32_t size);
+
+  /**
+   * \brief Check that a packet is the beginning of the original packet
+   * \param packet the packet
+   * \return true if the bytes are the ones of the original packet
+   */
+  bool CheckData (Ptr<Packet> packet);
+};
+
+FragmentBufferTestCase::FragmentBufferTestCase ()
+  : TestCase ("Fragment buffer")
+{
+}
+
+Ptr<Packet>
+FragmentBufferTestCase::MakeFragment (uint32_t offset, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data[i] = (offset + i) % 256;
+    }
+  return Create<Packet> (data.data (), size);
+}
+
+bool
+FragmentBufferTestCase::CheckData (Ptr<Packet> packet)
+{
+  std::vector<uint8_t> data (packet->GetSize ());
+  packet->CopyData (data.data (), data.size ());
+  for (uint32_t i = 0; i < data.size (); i++)
+    {
+      if (data[i] != i % 256)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+void
+FragmentBufferTestCase::DoRun (void)
+{
+  // 100 fragments of 8 bytes, the last one first, then in a scrambled order
+  FragmentBuffer buffer;
+  buffer.AddFragment (MakeFragment (99 * 8, 8), 99 * 8, false);
+  NS_TEST_EXPECT_MSG_EQ (buffer.IsEntire (), false, "Only the last fragment");
+  NS_TEST_EXPECT_MSG_EQ (buffer.GetPacket ()->GetSize (), 0, "No data from offset 0");
+  for (uint32_t i = 0; i < 99; i++)
+    {
+      uint32_t index = (i * 37) % 99;
+      buffer.AddFragment (MakeFragment (index * 8, 8), index * 8, true);
+      NS_TEST_EXPECT_MSG_EQ (buffer.IsEntire (), (i == 98), "Entire with the last missing fragment");
+    }
+  NS_TEST_EXPECT_MSG_EQ (buffer.HasOverlaps (), false, "No overlap");
+  Ptr<Packet> p = buffer.GetPacket ();
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 800, "Entire packet");
+  NS_TEST_EXPECT_MSG_EQ (CheckData (p), true, "Fragments in order");
+
+  // a hole, then a fragment which covers it and overlaps its neighbours
+  FragmentBuffer overlapping;
+  overlapping.AddFragment (MakeFragment (0, 16), 0, true);
+  overlapping.AddFragment (MakeFragment (32, 16), 32, false);
+  NS_TEST_EXPECT_MSG_EQ (overlapping.IsEntire (), false, "Hole");
+  NS_TEST_EXPECT_MSG_EQ (overlapping.GetPacket ()->GetSize (), 16, "Data up to the hole");
+  NS_TEST_EXPECT_MSG_EQ (overlapping.HasOverlaps (), false, "No overlap yet");
+  overlapping.AddFragment (MakeFragment (8, 32), 8, true);
+  NS_TEST_EXPECT_MSG_EQ (overlapping.IsEntire (), true, "Hole covered");
+  NS_TEST_EXPECT_MSG_EQ (overlapping.HasOverlaps (), true, "Overlapping fragment");
+  p = overlapping.GetPacket ();
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 48, "Overlapping bytes counted once");
+  NS_TEST_EXPECT_MSG_EQ (CheckData (p), true, "Overlapping bytes");
+
+  // a duplicated fragment, and one inside another
+  FragmentBuffer duplicated;
+  duplicated.AddFragment (MakeFragment (0, 24), 0, true);
+  duplicated.AddFragment (MakeFragment (8, 8), 8, true);
+  duplicated.AddFragment (MakeFragment (24, 8), 24, false);
+  duplicated.AddFragment (MakeFragment (24, 8), 24, false);
+  NS_TEST_EXPECT_MSG_EQ (duplicated.IsEntire (), true, "Entire with duplicates");
+  NS_TEST_EXPECT_MSG_EQ (duplicated.HasOverlaps (), true, "Duplicated fragments");
+  p = duplicated.GetPacket ();
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 32, "Duplicated bytes counted once");
+  NS_TEST_EXPECT_MSG_EQ (CheckData (p), true, "Duplicated bytes");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the reassembly timeouts expire at their time, except
+ * the removed ones.
+ */
+class FragmentTimeoutsTestCase : public TestCase
+{
+public:
+  FragmentTimeoutsTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Start the timeout of a reassembly
+   * \param key the reassembly
+   */
+  void Start (uint32_t key);
+  /**
+   * \brief Remove the timeout of a completed reassembly
+   * \param key the reassembly
+   */
+  void Complete (uint32_t key);
+  /**
+   * \brief Record an expired reassembly
+   * \param key the reassembly
+   */
+  void Expire (uint32_t key);
+
+  FragmentTimeouts<uint32_t> m_timeouts;                         //!< The timeouts
+  std::vector<FragmentTimeouts<uint32_t>::Iterator> m_iterators; //!< The timeouts, by key
+  std::vector<Time> m_expired;                                   //!< The expiration times, by key
+};
+
+FragmentTimeoutsTestCase::FragmentTimeoutsTestCase ()
+  : TestCase ("Fragment reassembly timeouts")
+{
+}
+
+void
+FragmentTimeoutsTestCase::Start (uint32_t key)
+{
+  m_iterators[key] = m_timeouts.Add (Seconds (30), key);
+}
+
+void
+FragmentTimeoutsTestCase::Complete (uint32_t key)
+{
+  m_timeouts.Remove (m_iterators[key]);
+}
+
+void
+FragmentTimeoutsTestCase::Expire (uint32_t key)
+{
+  m_expired[key] = Simulator::Now ();
+}
+
+void
+FragmentTimeoutsTestCase::DoRun (void)
+{
+  m_timeouts.SetExpireCallback (MakeCallback (&FragmentTimeoutsTestCase::Expire, this));
+  m_iterators.resize (4);
+  m_expired.resize (4, Seconds (-1));
+
+  // two reassemblies start together, the first one completes
+  Simulator::Schedule (Seconds (1), &FragmentTimeoutsTestCase::Start, this, 0);
+  Simulator::Schedule (Seconds (1), &FragmentTimeoutsTestCase::Start, this, 1);
+  Simulator::Schedule (Seconds (2), &FragmentTimeoutsTestCase::Complete, this, 0);
+  Simulator::Schedule (Seconds (5), &FragmentTimeoutsTestCase::Start, this, 2);
+  // one starts after all the others have expired
+  Simulator::Schedule (Seconds (40), &FragmentTimeoutsTestCase::Start, this, 3);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_expired[0], Seconds (-1), "Completed reassembly");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[1], Seconds (31), "Reassembly started at 1 s");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[2], Seconds (35), "Reassembly started at 5 s");
+  NS_TEST_EXPECT_MSG_EQ (m_expired[3], Seconds (70), "Reassembly started at 40 s");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Fragment buffer TestSuite
+ */
+class FragmentBufferTestSuite : public TestSuite
+{
+public:
+  FragmentBufferTestSuite ()
+    : TestSuite ("fragment-buffer", UNIT)
+  {
+    AddTestCase (new FragmentBufferTestCase (), TestCase::QUICK);
+    AddTestCase (new FragmentTimeoutsTestCase (), TestCase::QUICK);
+  }
+};
+
+static FragmentBufferTestSuite g_fragmentBufferTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,256 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <limits>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node-container.h"
+#include "ns3/uinteger.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-list-routing-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-contact-plan-routing-helper.h"
+#include "ns3/ipv4-routing-protocol.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * Diamond topology A-B-D, A-C-D, where the faster path through C is only
+ * available part of the time:
+ *
+ * - A-B and B-D, 10 ms, from 0 to 100 s;
+ * - A-C and C-D, 1 ms, from 0 to 5 s and from 10 to 100 s.
+ *
+ * Check the epochs, the routes of each epoch, their sharing between the
+ * two epochs with the same topology, the parallel computation and the
+ * switch of the routes during the simulation.
+ */
+class Ipv4ContactPlanRoutingTestCase : public TestCase
+{
+public:
+  Ipv4ContactPlanRoutingTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /**
+   * Check the route of node A towards node D
+   * \param expected the expected gateway (any address if no route expected)
+   * \param found whether a route is expected
+   */
+  void CheckRoute (Ipv4Address expected, bool found);
+  /**
+   * Send a packet from A to D
+   */
+  void SendPacket (void);
+  /**
+   * Receive a packet
+   * \param socket the receiving socket
+   */
+  void ReceivePacket (Ptr<Socket> socket);
+
+  Ptr<Node> m_a;          //!< node A
+  Ipv4Address m_dest;     //!< an address of node D
+  Ptr<Socket> m_txSocket; //!< sending socket on node A
+  uint32_t m_received;    //!< packets received on node D
+};
+
+Ipv4ContactPlanRoutingTestCase::Ipv4ContactPlanRoutingTestCase ()
+  : TestCase ("Routes of a time-varying diamond topology"),
+    m_received (0)
+{
+}
+
+void
+Ipv4ContactPlanRoutingTestCase::CheckRoute (Ipv4Address expected, bool found)
+{
+  Ipv4Header header;
+  header.SetDestination (m_dest);
+  Socket::SocketErrno sockerr;
+  Ptr<Ipv4Route> route = m_a->GetObject<Ipv4> ()->GetRoutingProtocol ()->RouteOutput (Create<Packet> (), header, 0, sockerr);
+  NS_TEST_ASSERT_MSG_EQ ((route != 0), found, "Route at " << Simulator::Now ().As (Time::S));
+  if (found)
+    {
+      NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), expected, "Gateway at " << Simulator::Now ().As (Time::S));
+    }
+}
+
+void
+Ipv4ContactPlanRoutingTestCase::SendPacket (void)
+{
+  m_txSocket->SendTo (Create<Packet> (100), 0, InetSocketAddress (m_dest, 1234));
+}
+
+void
+Ipv4ContactPlanRoutingTestCase::ReceivePacket (Ptr<Socket> socket)
+{
+  while (socket->Recv (std::numeric_limits<uint32_t>::max (), 0))
+    {
+      m_received++;
+    }
+}
+
+void
+Ipv4ContactPlanRoutingTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+  Ptr<Node> a = nodes.Get (0);
+  Ptr<Node> b = nodes.Get (1);
+  Ptr<Node> c = nodes.Get (2);
+  Ptr<Node> d = nodes.Get (3);
+
+  Ipv4ContactPlanRoutingHelper contactPlanRouting;
+  Ipv4StaticRoutingHelper staticRouting;
+  Ipv4ListRoutingHelper list;
+  list.Add (staticRouting, 0);
+  list.Add (contactPlanRouting, 10);
+  InternetStackHelper internet;
+  internet.SetRoutingHelper (list);
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper p2pHelper;
+  p2pHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  NetDeviceContainer ab = p2pHelper.Install (NodeContainer (a, b));
+  Ipv4InterfaceContainer abIf = ipv4.Assign (ab);
+  ipv4.NewNetwork ();
+  NetDeviceContainer bd = p2pHelper.Install (NodeContainer (b, d));
+  ipv4.Assign (bd);
+  ipv4.NewNetwork ();
+  NetDeviceContainer ac = p2pHelper.Install (NodeContainer (a, c));
+  Ipv4InterfaceContainer acIf = ipv4.Assign (ac);
+  ipv4.NewNetwork ();
+  NetDeviceContainer cd = p2pHelper.Install (NodeContainer (c, d));
+  Ipv4InterfaceContainer cdIf = ipv4.Assign (cd);
+
+  Ptr<ContactPlan> plan = contactPlanRouting.GetContactPlan ();
+  Ipv4ContactPlanRoutingHelper parallel;
+  parallel.GetContactPlan ()->SetAttribute ("Threads", UintegerValue (3));
+  Ipv4ContactPlanRoutingHelper *helpers[2] = {&contactPlanRouting, &parallel};
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      helpers[i]->AddLink (ab.Get (0), ab.Get (1), Seconds (0), Seconds (100), MilliSeconds (10));
+      helpers[i]->AddLink (bd.Get (0), bd.Get (1), Seconds (0), Seconds (100), MilliSeconds (10));
+      helpers[i]->AddLink (ac.Get (0), ac.Get (1), Seconds (0), Seconds (5), MilliSeconds (1));
+      helpers[i]->AddLink (cd.Get (0), cd.Get (1), Seconds (0), Seconds (5), MilliSeconds (1));
+      helpers[i]->AddLink (ac.Get (0), ac.Get (1), Seconds (10), Seconds (100), MilliSeconds (1));
+      helpers[i]->AddLink (cd.Get (0), cd.Get (1), Seconds (10), Seconds (100), MilliSeconds (1));
+    }
+  NS_TEST_EXPECT_MSG_EQ (plan->GetNContacts (), 12, "Two contacts per link and interval");
+
+  plan->Compute ();
+  parallel.GetContactPlan ()->Compute ();
+  NS_TEST_ASSERT_MSG_EQ (plan->GetNEpochs (), 4, "Epochs start at 0, 5, 10 and 100 s");
+  NS_TEST_EXPECT_MSG_EQ (plan->GetEpochStart (2), Seconds (10), "Third epoch");
+
+  m_dest = cdIf.GetAddress (1);
+  Ipv4Address viaB = abIf.GetAddress (1);
+  Ipv4Address viaC = acIf.GetAddress (1);
+  uint32_t interface;
+  Ipv4Address gateway;
+  NS_TEST_EXPECT_MSG_EQ (plan->Lookup (0, a->GetId (), m_dest, interface, gateway), true, "Route in epoch 0");
+  NS_TEST_EXPECT_MSG_EQ (gateway, viaC, "Fastest path in epoch 0");
+  NS_TEST_EXPECT_MSG_EQ (interface, acIf.Get (0).second, "Output interface in epoch 0");
+  NS_TEST_EXPECT_MSG_EQ (plan->Lookup (1, a->GetId (), m_dest, interface, gateway), true, "Route in epoch 1");
+  NS_TEST_EXPECT_MSG_EQ (gateway, viaB, "Only path in epoch 1");
+  NS_TEST_EXPECT_MSG_EQ (plan->Lookup (2, a->GetId (), m_dest, interface, gateway), true, "Route in epoch 2");
+  NS_TEST_EXPECT_MSG_EQ (gateway, viaC, "Fastest path in epoch 2");
+  NS_TEST_EXPECT_MSG_EQ (plan->Lookup (3, a->GetId (), m_dest, interface, gateway), false, "No route in epoch 3");
+  // an address of a network of the plan, but of no node: the packet goes to
+  // the node of the c-d network it reaches first (c in epoch 0, d in epoch 1)
+  NS_TEST_EXPECT_MSG_EQ (plan->Lookup (0, a->GetId (), Ipv4Address ("10.1.0.15"), interface, gateway), true, "Route to a prefix in epoch 0");
+  NS_TEST_EXPECT_MSG_EQ (gateway, viaC, "Route to c, on the c-d network");
+  NS_TEST_EXPECT_MSG_EQ (plan->Lookup (1, a->GetId (), Ipv4Address ("10.1.0.15"), interface, gateway), true, "Route to a prefix");
+  NS_TEST_EXPECT_MSG_EQ (gateway, viaB, "Route to d, on the c-d network");
+  NS_TEST_EXPECT_MSG_EQ (plan->Lookup (3, a->GetId (), Ipv4Address ("10.1.0.15"), interface, gateway), false, "Unreachable prefix");
+  NS_TEST_EXPECT_MSG_EQ (plan->Lookup (0, c->GetId (), Ipv4Address ("10.1.0.15"), interface, gateway), false, "c is on the c-d network");
+  NS_TEST_EXPECT_MSG_EQ (parallel.GetContactPlan ()->Lookup (1, a->GetId (), Ipv4Address ("10.1.0.15"), interface, gateway), true, "Route to a prefix in parallel");
+  NS_TEST_EXPECT_MSG_EQ (gateway, viaB, "Route to d, on the c-d network, in parallel");
+  NS_TEST_EXPECT_MSG_EQ (plan->Lookup (0, a->GetId (), Ipv4Address ("10.9.0.1"), interface, gateway), false, "Unknown address");
+
+  // epochs 0 and 2 have the same topology
+  NS_TEST_EXPECT_MSG_LT (plan->GetNTables (), plan->GetNEpochs () * nodes.GetN (), "Tables are shared between epochs");
+  NS_TEST_EXPECT_MSG_EQ (parallel.GetContactPlan ()->GetNTables (), plan->GetNTables (), "Same tables in parallel");
+  for (uint32_t e = 0; e < plan->GetNEpochs (); e++)
+    {
+      for (uint32_t n = 0; n < nodes.GetN (); n++)
+        {
+          for (uint32_t m = 0; m < nodes.GetN (); m++)
+            {
+              uint32_t parallelInterface = 0;
+              Ipv4Address parallelGateway;
+              bool found = plan->LookupNode (e, n, m, interface, gateway);
+              NS_TEST_EXPECT_MSG_EQ (parallel.GetContactPlan ()->LookupNode (e, n, m, parallelInterface, parallelGateway),
+                                     found, "Same routes in parallel");
+              if (found)
+                {
+                  NS_TEST_EXPECT_MSG_EQ (parallelGateway, gateway, "Same routes in parallel");
+                  NS_TEST_EXPECT_MSG_EQ (parallelInterface, interface, "Same routes in parallel");
+                }
+            }
+        }
+    }
+
+  m_a = a;
+  m_txSocket = a->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  Ptr<Socket> rxSocket = d->GetObject<UdpSocketFactory> ()->CreateSocket ();
+  rxSocket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234));
+  rxSocket->SetRecvCallback (MakeCallback (&Ipv4ContactPlanRoutingTestCase::ReceivePacket, this));
+
+  Simulator::Schedule (Seconds (1), &Ipv4ContactPlanRoutingTestCase::CheckRoute, this, viaC, true);
+  Simulator::Schedule (Seconds (6), &Ipv4ContactPlanRoutingTestCase::CheckRoute, this, viaB, true);
+  Simulator::Schedule (Seconds (11), &Ipv4ContactPlanRoutingTestCase::CheckRoute, this, viaC, true);
+  Simulator::Schedule (Seconds (101), &Ipv4ContactPlanRoutingTestCase::CheckRoute, this, viaC, false);
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (6), &Ipv4ContactPlanRoutingTestCase::SendPacket, this);
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (11), &Ipv4ContactPlanRoutingTestCase::SendPacket, this);
+  Simulator::ScheduleWithContext (a->GetId (), Seconds (101), &Ipv4ContactPlanRoutingTestCase::SendPacket, this);
+  Simulator::Stop (Seconds (102));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, 2, "Packets are only delivered while a path exists");
+  NS_TEST_EXPECT_MSG_EQ (plan->GetCurrentEpoch (), 3, "Last epoch at the end");
+  m_txSocket = 0;
+  m_a = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 contact plan routing TestSuite
+ */
+class Ipv4ContactPlanRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv4ContactPlanRoutingTestSuite ()
+    : TestSuite ("ipv4-contact-plan-routing", UNIT)
+  {
+    AddTestCase (new Ipv4ContactPlanRoutingTestCase (), TestCase::QUICK);
+  }
+};
+
+static Ipv4ContactPlanRoutingTestSuite g_ipv4ContactPlanRoutingTestSuite; //!< Static variable for test initialization
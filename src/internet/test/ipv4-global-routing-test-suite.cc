@@ -14,6 +14,8 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <set>
+#include <sstream>
 #include <vector>
 #include "ns3/boolean.h"
 #include "ns3/config.h"
@@ -42,6 +44,8 @@
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-global-routing.h"
 #include "ns3/bridge-helper.h"
+#include "ns3/global-value.h"
+#include "ns3/global-router-interface.h"
 
 using namespace ns3;
 
@@ -1244,6 +1248,232 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the parallel and incremental SPF calculations find the
+ * same routes as the serial, full one, as links change.
+ */
+class Ipv4GlobalRoutingIncrementalSpfTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingIncrementalSpfTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \param nodes the nodes
+   * \return the global routes of all the nodes
+   */
+  static std::string DumpRoutes (NodeContainer nodes);
+  /**
+   * \brief Recompute the routes in each mode and compare them
+   * \param nodes the nodes
+   * \param step the name of the topology change, for the messages
+   */
+  void CheckRoutes (NodeContainer nodes, std::string step);
+};
+
+Ipv4GlobalRoutingIncrementalSpfTestCase::Ipv4GlobalRoutingIncrementalSpfTestCase ()
+  : TestCase ("Parallel and incremental SPF calculations")
+{
+}
+
+std::string
+Ipv4GlobalRoutingIncrementalSpfTestCase::DumpRoutes (NodeContainer nodes)
+{
+  std::ostringstream os;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<Ipv4GlobalRouting> routing = nodes.Get (i)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+      os << "node " << i << ":";
+      for (uint32_t j = 0; j < routing->GetNRoutes (); j++)
+        {
+          os << " [" << *routing->GetRoute (j) << "]";
+        }
+      os << std::endl;
+    }
+  return os.str ();
+}
+
+void
+Ipv4GlobalRoutingIncrementalSpfTestCase::CheckRoutes (NodeContainer nodes, std::string step)
+{
+  // incremental update of the trees of the previous calculation
+  GlobalValue::Bind ("GlobalRoutingIncrementalSpf", BooleanValue (true));
+  GlobalValue::Bind ("GlobalRoutingSpfThreads", UintegerValue (3));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::string incremental = DumpRoutes (nodes);
+
+  GlobalValue::Bind ("GlobalRoutingIncrementalSpf", BooleanValue (false));
+  GlobalValue::Bind ("GlobalRoutingSpfThreads", UintegerValue (1));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  std::string reference = DumpRoutes (nodes);
+  NS_TEST_EXPECT_MSG_EQ (incremental, reference, "Incremental SPF after " << step);
+
+  // full calculation, keeping the trees for the next step
+  GlobalValue::Bind ("GlobalRoutingIncrementalSpf", BooleanValue (true));
+  GlobalValue::Bind ("GlobalRoutingSpfThreads", UintegerValue (3));
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  NS_TEST_EXPECT_MSG_EQ (DumpRoutes (nodes), reference, "Parallel SPF after " << step);
+}
+
+// Test program for a 4x4 grid of routers, linked by point-to-point links,
+// the first three of which are also on a LAN.
+void
+Ipv4GlobalRoutingIncrementalSpfTestCase::DoRun (void)
+{
+  const uint32_t side = 4;
+  NodeContainer nodes;
+  nodes.Create (side * side);
+  InternetStackHelper internet;
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper p2pHelper;
+  p2pHelper.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.0.0", "255.255.255.252");
+  std::vector<Ipv4InterfaceContainer> links;
+  for (uint32_t i = 0; i < side * side; i++)
+    {
+      uint32_t x = i % side;
+      uint32_t y = i / side;
+      if (x + 1 < side)
+        {
+          links.push_back (ipv4.Assign (p2pHelper.Install (NodeContainer (nodes.Get (i), nodes.Get (i + 1)))));
+          ipv4.NewNetwork ();
+        }
+      if (y + 1 < side)
+        {
+          links.push_back (ipv4.Assign (p2pHelper.Install (NodeContainer (nodes.Get (i), nodes.Get (i + side)))));
+          ipv4.NewNetwork ();
+        }
+    }
+  SimpleNetDeviceHelper lanHelper;
+  ipv4.SetBase ("10.2.0.0", "255.255.255.0");
+  ipv4.Assign (lanHelper.Install (NodeContainer (nodes.Get (0), nodes.Get (1), nodes.Get (2))));
+
+  GlobalValue::Bind ("GlobalRoutingIncrementalSpf", BooleanValue (true));
+  GlobalValue::Bind ("GlobalRoutingSpfThreads", UintegerValue (3));
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  // a link far from most routers gets more expensive
+  Ipv4InterfaceContainer link = links.back ();
+  link.Get (0).first->SetMetric (link.Get (0).second, 5);
+  link.Get (1).first->SetMetric (link.Get (1).second, 5);
+  CheckRoutes (nodes, "metric increase");
+
+  // a link in the middle goes down, then up again
+  link = links[links.size () / 2];
+  link.Get (0).first->SetDown (link.Get (0).second);
+  link.Get (1).first->SetDown (link.Get (1).second);
+  CheckRoutes (nodes, "link down");
+  link.Get (0).first->SetUp (link.Get (0).second);
+  link.Get (1).first->SetUp (link.Get (1).second);
+  CheckRoutes (nodes, "link up");
+
+  // a link gets cheaper, on one side only
+  link = links[3];
+  link.Get (0).first->SetMetric (link.Get (0).second, 1);
+  link.Get (1).first->SetMetric (link.Get (1).second, 3);
+  CheckRoutes (nodes, "asymmetric metric change");
+
+  // nothing changes
+  CheckRoutes (nodes, "no change");
+
+  GlobalValue::Bind ("GlobalRoutingIncrementalSpf", BooleanValue (false));
+  GlobalValue::Bind ("GlobalRoutingSpfThreads", UintegerValue (1));
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the equal-cost routes to the routers behind a LAN which is
+ * not adjacent to the root and is reached through equal-cost paths.
+ *
+ * \verbatim
+               10.1.1.0/30   +----+
+            +----------------| n1 |----+
+   +----+   |                +----+    |  10.2.0.0/24   +----+ 10.3.0.0/30 +----+
+   | n0 |---+                          +----------------| n3 |-------------| n4 |
+   +----+   |   10.1.2.0/30  +----+    |      LAN       +----+             +----+
+            +----------------| n2 |----+
+                             +----+
+   \endverbatim
+ *
+ * The LAN has two root exits as seen from n0, through n1 and n2, and the
+ * routers behind it inherit both, so n0 has one route through each of n1
+ * and n2 to the network between n3 and n4.
+ */
+class Ipv4GlobalRoutingEcmpBehindLanTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingEcmpBehindLanTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingEcmpBehindLanTestCase::Ipv4GlobalRoutingEcmpBehindLanTestCase ()
+  : TestCase ("Global routing with equal-cost paths to the routers behind a LAN")
+{
+}
+
+void
+Ipv4GlobalRoutingEcmpBehindLanTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (5);
+  InternetStackHelper internet;
+  Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+  internet.SetRoutingHelper (ipv4RoutingHelper);
+  internet.Install (nodes);
+
+  SimpleNetDeviceHelper p2pHelper;
+  p2pHelper.SetNetDevicePointToPointMode (true);
+  SimpleNetDeviceHelper lanHelper;
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.252");
+  ipv4.Assign (p2pHelper.Install (NodeContainer (nodes.Get (0), nodes.Get (1))));
+  ipv4.SetBase ("10.1.2.0", "255.255.255.252");
+  ipv4.Assign (p2pHelper.Install (NodeContainer (nodes.Get (0), nodes.Get (2))));
+  ipv4.SetBase ("10.2.0.0", "255.255.255.0");
+  ipv4.Assign (lanHelper.Install (NodeContainer (nodes.Get (1), nodes.Get (2), nodes.Get (3))));
+  ipv4.SetBase ("10.3.0.0", "255.255.255.252");
+  ipv4.Assign (p2pHelper.Install (NodeContainer (nodes.Get (3), nodes.Get (4))));
+
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  Ptr<Ipv4GlobalRouting> globalRouting0 = nodes.Get (0)->GetObject<GlobalRouter> ()->GetRoutingProtocol ();
+  NS_TEST_ASSERT_MSG_NE (globalRouting0, 0, "Error-- no Ipv4GlobalRouting object");
+
+  std::set<Ipv4Address> networkGateways;
+  std::set<Ipv4Address> hostGateways;
+  for (uint32_t i = 0; i < globalRouting0->GetNRoutes (); i++)
+    {
+      Ipv4RoutingTableEntry* route = globalRouting0->GetRoute (i);
+      NS_LOG_DEBUG ("entry dest " << route->GetDest () << " gw " << route->GetGateway ());
+      if (route->GetDest () == Ipv4Address ("10.3.0.0"))
+        {
+          networkGateways.insert (route->GetGateway ());
+        }
+      else if (route->GetDest () == Ipv4Address ("10.3.0.2"))
+        {
+          hostGateways.insert (route->GetGateway ());
+        }
+    }
+  std::set<Ipv4Address> expected {Ipv4Address ("10.1.1.2"), Ipv4Address ("10.1.2.2")};
+  NS_TEST_EXPECT_MSG_EQ ((networkGateways == expected), true,
+                         "Error-- the network behind the LAN should be reached through both n1 and n2");
+  NS_TEST_EXPECT_MSG_EQ ((hostGateways == expected), true,
+                         "Error-- the router behind the LAN should be reached through both n1 and n2");
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -1267,6 +1497,8 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingIncrementalSpfTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingEcmpBehindLanTestCase, TestCase::QUICK);
   }
 
 static Ipv4GlobalRoutingTestSuite g_globalRoutingTestSuite; //!< Static variable for test initialization
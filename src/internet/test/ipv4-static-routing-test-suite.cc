@@ -20,6 +20,9 @@
 #include "ns3/config.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/node.h"
@@ -201,6 +204,111 @@ Ipv4StaticRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv4 StaticRouting longest prefix match and metric Test
+ *
+ * Checks the route selected among overlapping prefixes, equal prefixes
+ * with different or equal metrics and duplicate host routes, and that
+ * added and removed routes are taken into account.
+ */
+class Ipv4StaticRoutingLookupTestCase : public TestCase
+{
+public:
+  Ipv4StaticRoutingLookupTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * \brief Look up a route.
+   * \param dest destination address
+   * \param oif output device, if any
+   * \return the gateway of the route found, or 0.0.0.0 if none
+   */
+  Ipv4Address Lookup (std::string dest, Ptr<NetDevice> oif = 0);
+
+  Ptr<Ipv4StaticRouting> m_routing; //!< routing protocol under test
+};
+
+Ipv4StaticRoutingLookupTestCase::Ipv4StaticRoutingLookupTestCase ()
+  : TestCase ("Longest prefix match and metric tie-breaks")
+{
+}
+
+Ipv4Address
+Ipv4StaticRoutingLookupTestCase::Lookup (std::string dest, Ptr<NetDevice> oif)
+{
+  Ipv4Header header;
+  header.SetDestination (Ipv4Address (dest.c_str ()));
+  Socket::SocketErrno err;
+  Ptr<Ipv4Route> route = m_routing->RouteOutput (Create<Packet> (), header, oif, err);
+  return (route != 0) ? route->GetGateway () : Ipv4Address::GetAny ();
+}
+
+void
+Ipv4StaticRoutingLookupTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  NodeContainer peers (2);
+  SimpleNetDeviceHelper devHelper;
+  NetDeviceContainer devices;
+  devices.Add (devHelper.Install (NodeContainer (node, peers.Get (0))).Get (0));
+  devices.Add (devHelper.Install (NodeContainer (node, peers.Get (1))).Get (0));
+
+  InternetStackHelper internet;
+  internet.Install (node);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      int32_t ifIndex = ipv4->AddInterface (devices.Get (i));
+      std::ostringstream address;
+      address << "10.0." << i + 1 << ".1";
+      ipv4->AddAddress (ifIndex, Ipv4InterfaceAddress (Ipv4Address (address.str ().c_str ()), Ipv4Mask ("/24")));
+      ipv4->SetUp (ifIndex);
+    }
+  Ipv4StaticRoutingHelper helper;
+  m_routing = helper.GetStaticRouting (ipv4);
+
+  Ipv4Address gw1 ("10.0.1.2");
+  Ipv4Address gw2 ("10.0.2.2");
+  m_routing->SetDefaultRoute (gw1, 1);
+  m_routing->AddNetworkRouteTo ("10.1.0.0", "/16", gw1, 1, 5);
+  m_routing->AddNetworkRouteTo ("10.1.0.0", "/16", gw2, 2, 5);
+  m_routing->AddNetworkRouteTo ("10.1.2.0", "/24", gw1, 1, 10);
+  m_routing->AddNetworkRouteTo ("10.1.2.0", "/24", gw2, 2, 1);
+  m_routing->AddNetworkRouteTo ("10.1.2.0", "/24", gw1, 1, 3);
+  m_routing->AddHostRouteTo ("10.1.2.3", gw2, 2, 7);
+  m_routing->AddHostRouteTo ("10.1.2.3", gw1, 1, 0);
+
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("192.168.0.1"), gw1, "Default route");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.200.1"), gw2, "Equal metrics: the last route added wins");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.200"), gw2, "Longest prefix, then lowest metric");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3"), gw2, "Host routes: the first one added wins");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3", devices.Get (0)), gw1, "Routes on other interfaces are skipped");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.200", devices.Get (0)), gw1, "Lowest metric on the requested interface");
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.0.2.9"), Ipv4Address::GetAny (), "Connected network");
+
+  // remove both host routes and the /24 with metric 1
+  for (uint32_t i = m_routing->GetNRoutes (); i > 0; i--)
+    {
+      Ipv4RoutingTableEntry route = m_routing->GetRoute (i - 1);
+      if (route.IsHost () || (route.GetDestNetworkMask () == Ipv4Mask ("/24") && m_routing->GetMetric (i - 1) == 1))
+        {
+          m_routing->RemoveRoute (i - 1);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3"), gw1, "Removed routes are no longer used");
+  m_routing->AddNetworkRouteTo ("10.1.2.0", "/25", gw2, 2, 100);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3"), gw2, "Added routes are used");
+  ipv4->SetDown (2);
+  NS_TEST_EXPECT_MSG_EQ (Lookup ("10.1.2.3"), gw1, "Routes of an interface going down are removed");
+
+  m_routing = 0;
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -217,6 +325,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite ()
   : TestSuite ("ipv4-static-routing", UNIT)
 {
   AddTestCase (new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+  AddTestCase (new Ipv4StaticRoutingLookupTestCase, TestCase::QUICK);
 }
 
 static Ipv4StaticRoutingTestSuite ipv4StaticRoutingTestSuite; //!< Static variable for test initialization
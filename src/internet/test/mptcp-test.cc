@@ -0,0 +1,735 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/tcp-socket-state.h"
+#include "ns3/mptcp-socket.h"
+#include "ns3/mptcp-socket-factory.h"
+#include "ns3/mptcp-congestion-ops.h"
+#include "ns3/error-model.h"
+#include "ns3/pointer.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the window increase of the coupled congestion controls
+ */
+class MpTcpCoupledIncreaseTestCase : public TestCase
+{
+public:
+  MpTcpCoupledIncreaseTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Create the congestion state of a subflow in congestion avoidance
+   * \param cWnd the congestion window, in segments
+   * \return the congestion state
+   */
+  Ptr<TcpSocketState> CreateTcb (uint32_t cWnd);
+};
+
+MpTcpCoupledIncreaseTestCase::MpTcpCoupledIncreaseTestCase ()
+  : TestCase ("Coupled window increase of LIA, OLIA and BALIA")
+{
+}
+
+Ptr<TcpSocketState>
+MpTcpCoupledIncreaseTestCase::CreateTcb (uint32_t cWnd)
+{
+  Ptr<TcpSocketState> tcb = CreateObject<TcpSocketState> ();
+  tcb->m_segmentSize = 1000;
+  tcb->m_cWnd = cWnd * 1000;
+  tcb->m_ssThresh = 1000;
+  return tcb;
+}
+
+void
+MpTcpCoupledIncreaseTestCase::DoRun (void)
+{
+  // a single subflow increases as NewReno, by 1 / w per segment
+  std::vector<Ptr<MpTcpCongestionOps> > algorithms;
+  algorithms.push_back (CreateObject<MpTcpLia> ());
+  algorithms.push_back (CreateObject<MpTcpOlia> ());
+  algorithms.push_back (CreateObject<MpTcpBalia> ());
+  for (std::vector<Ptr<MpTcpCongestionOps> >::iterator it = algorithms.begin (); it != algorithms.end (); it++)
+    {
+      Ptr<TcpSocketState> tcb = CreateTcb (10);
+      Ptr<MpTcpCoupling> coupling = Create<MpTcpCoupling> ();
+      coupling->AddSubflow (tcb);
+      (*it)->SetCoupling (coupling);
+      (*it)->PktsAcked (tcb, 1, MilliSeconds (100));
+      (*it)->IncreaseWindow (tcb, 5);
+      NS_TEST_EXPECT_MSG_EQ_TOL (tcb->m_cWnd.Get (), 10500, 1, (*it)->GetName () << " with a single subflow");
+      NS_TEST_EXPECT_MSG_EQ ((*it)->GetSsThresh (tcb, 10000), 5000, (*it)->GetName () << " reduction with a single subflow");
+    }
+
+  // LIA: alpha = 20 * (10 / 0.1^2) / (10 / 0.1 + 10 / 0.2)^2 = 8 / 9,
+  // and the increase is alpha / 20 per segment
+  Ptr<MpTcpCoupling> coupling = Create<MpTcpCoupling> ();
+  Ptr<TcpSocketState> fast = CreateTcb (10);
+  Ptr<TcpSocketState> slow = CreateTcb (10);
+  coupling->AddSubflow (fast);
+  coupling->AddSubflow (slow);
+  Ptr<MpTcpLia> liaFast = CreateObject<MpTcpLia> ();
+  Ptr<MpTcpLia> liaSlow = CreateObject<MpTcpLia> ();
+  liaFast->SetCoupling (coupling);
+  liaSlow->SetCoupling (coupling);
+  liaFast->PktsAcked (fast, 1, MilliSeconds (100));
+  liaSlow->PktsAcked (slow, 1, MilliSeconds (200));
+  liaFast->IncreaseWindow (fast, 9);
+  NS_TEST_EXPECT_MSG_EQ_TOL (fast->m_cWnd.Get (), 10400, 1, "LIA increase of the fast subflow");
+  fast->m_cWnd = 10000;
+  liaSlow->IncreaseWindow (slow, 9);
+  NS_TEST_EXPECT_MSG_EQ_TOL (slow->m_cWnd.Get (), 10400, 1, "LIA increase of the slow subflow");
+
+  // OLIA: the second subflow is the best one, without the largest window,
+  // so the window moves from the first one to it
+  coupling = Create<MpTcpCoupling> ();
+  Ptr<TcpSocketState> large = CreateTcb (20);
+  Ptr<TcpSocketState> best = CreateTcb (10);
+  coupling->AddSubflow (large);
+  coupling->AddSubflow (best);
+  Ptr<MpTcpOlia> oliaLarge = CreateObject<MpTcpOlia> ();
+  Ptr<MpTcpOlia> oliaBest = CreateObject<MpTcpOlia> ();
+  oliaLarge->SetCoupling (coupling);
+  oliaBest->SetCoupling (coupling);
+  oliaLarge->PktsAcked (large, 1, MilliSeconds (100));
+  oliaBest->PktsAcked (best, 50, MilliSeconds (100));
+  // (20 / 0.01) / 300^2 - 0.5 / 20 = -1 / 360 per segment
+  oliaLarge->IncreaseWindow (large, 360);
+  NS_TEST_EXPECT_MSG_EQ_TOL (large->m_cWnd.Get (), 19000, 1, "OLIA decrease of the largest window");
+  // (10 / 0.01) / 290^2 + 0.5 / 10 per segment
+  oliaBest->IncreaseWindow (best, 10);
+  NS_TEST_EXPECT_MSG_EQ_TOL (best->m_cWnd.Get (), 10618, 1, "OLIA increase of the best subflow");
+
+  // BALIA: x = 100 and 50, alpha = 1 and 2
+  coupling = Create<MpTcpCoupling> ();
+  fast = CreateTcb (10);
+  slow = CreateTcb (10);
+  coupling->AddSubflow (fast);
+  coupling->AddSubflow (slow);
+  Ptr<MpTcpBalia> baliaFast = CreateObject<MpTcpBalia> ();
+  Ptr<MpTcpBalia> baliaSlow = CreateObject<MpTcpBalia> ();
+  baliaFast->SetCoupling (coupling);
+  baliaSlow->SetCoupling (coupling);
+  baliaFast->PktsAcked (fast, 1, MilliSeconds (100));
+  baliaSlow->PktsAcked (slow, 1, MilliSeconds (200));
+  // 100 / (0.1 * 150^2) per segment
+  baliaFast->IncreaseWindow (fast, 9);
+  NS_TEST_EXPECT_MSG_EQ_TOL (fast->m_cWnd.Get (), 10400, 1, "BALIA increase of the fast subflow");
+  fast->m_cWnd = 10000;
+  // 50 / (0.2 * 150^2) * 1.5 * 1.2 per segment
+  baliaSlow->IncreaseWindow (slow, 10);
+  NS_TEST_EXPECT_MSG_EQ_TOL (slow->m_cWnd.Get (), 10200, 1, "BALIA increase of the slow subflow");
+  NS_TEST_EXPECT_MSG_EQ (baliaSlow->GetSsThresh (slow, 10000), 2500, "BALIA reduction of the slow subflow");
+
+  // a subflow removed from the coupling is not added back by a late ACK
+  coupling->RemoveSubflow (slow);
+  baliaSlow->PktsAcked (slow, 1, MilliSeconds (200));
+  NS_TEST_EXPECT_MSG_EQ (coupling->GetActiveSubflows ().size (), 1, "Removed subflow not coupled anymore");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check a transfer over two paths
+ *
+ * The client and the server are connected by two links, with different
+ * rates and delays, and the client sends 1 MB to the server.  The data must
+ * be received in order, on both links, and faster than over the fastest
+ * link alone (except with the redundant scheduler).
+ */
+class MpTcpTransferTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param scheduler the type of scheduler
+   * \param congestion the type of congestion control
+   */
+  MpTcpTransferTestCase (TypeId scheduler, TypeId congestion);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send data while there is room in the buffer of the socket
+   * \param socket the socket
+   * \param available the room in the buffer
+   */
+  void SendData (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Start to send, once the client is connected
+   * \param socket the socket
+   */
+  void Connected (Ptr<Socket> socket);
+  /**
+   * \brief Accept a connection
+   * \param socket the socket of the connection
+   * \param from the address of the client
+   */
+  void Accept (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Receive and check data
+   * \param socket the socket
+   */
+  void Receive (Ptr<Socket> socket);
+  /**
+   * \brief Count the bytes received on an interface of the server
+   * \param packet the packet
+   * \param ipv4 the IPv4 stack
+   * \param interface the interface
+   */
+  void IpRx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  TypeId m_scheduler;                //!< Type of scheduler
+  TypeId m_congestion;               //!< Type of congestion control
+  uint32_t m_sent;                   //!< Bytes sent
+  uint32_t m_received;               //!< Bytes received
+  bool m_inOrder;                    //!< Whether the received bytes were the sent ones, in order
+  Time m_lastRx;                     //!< Time of the last received byte
+  uint32_t m_connections;            //!< Connections accepted
+  std::vector<uint32_t> m_interfaceRx; //!< Bytes received by interface of the server
+  static const uint32_t TOTAL = 1000000; //!< Bytes to send
+};
+
+MpTcpTransferTestCase::MpTcpTransferTestCase (TypeId scheduler, TypeId congestion)
+  : TestCase ("MPTCP transfer with " + scheduler.GetName () + " and " + congestion.GetName ()),
+    m_scheduler (scheduler),
+    m_congestion (congestion),
+    m_sent (0),
+    m_received (0),
+    m_inOrder (true),
+    m_connections (0),
+    m_interfaceRx (3, 0)
+{
+}
+
+void
+MpTcpTransferTestCase::SendData (Ptr<Socket> socket, uint32_t available)
+{
+  while (m_sent < TOTAL && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (std::min (socket->GetTxAvailable (), TOTAL - m_sent), 1400u);
+      std::vector<uint8_t> data (size);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          data[i] = (m_sent + i) % 251;
+        }
+      NS_TEST_ASSERT_MSG_EQ (socket->Send (Create<Packet> (data.data (), size)), static_cast<int> (size), "Data sent");
+      m_sent += size;
+    }
+  if (m_sent == TOTAL)
+    {
+      socket->Close ();
+      m_sent++;
+    }
+}
+
+void
+MpTcpTransferTestCase::Connected (Ptr<Socket> socket)
+{
+  SendData (socket, socket->GetTxAvailable ());
+}
+
+void
+MpTcpTransferTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  m_connections++;
+  socket->SetRecvCallback (MakeCallback (&MpTcpTransferTestCase::Receive, this));
+}
+
+void
+MpTcpTransferTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      std::vector<uint8_t> data (p->GetSize ());
+      p->CopyData (data.data (), data.size ());
+      for (uint32_t i = 0; i < data.size (); i++)
+        {
+          m_inOrder &= (data[i] == (m_received + i) % 251);
+        }
+      m_received += p->GetSize ();
+      m_lastRx = Simulator::Now ();
+    }
+}
+
+void
+MpTcpTransferTestCase::IpRx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  m_interfaceRx[interface] += packet->GetSize ();
+}
+
+void
+MpTcpTransferTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1400));
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  simple.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  NetDeviceContainer fastDevices = simple.Install (nodes);
+  simple.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  simple.SetChannelAttribute ("Delay", StringValue ("30ms"));
+  NetDeviceContainer slowDevices = simple.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (fastDevices);
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  ipv4.Assign (slowDevices);
+
+  // the client reaches the address of the server on the fast link through the slow link too
+  Ipv4StaticRoutingHelper routingHelper;
+  Ptr<Ipv4StaticRouting> routing = routingHelper.GetStaticRouting (nodes.Get (0)->GetObject<Ipv4> ());
+  routing->AddNetworkRouteTo (Ipv4Address ("10.1.1.0"), Ipv4Mask ("255.255.255.0"),
+                              Ipv4Address ("10.1.2.2"), 2, 10);
+  nodes.Get (1)->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Rx", MakeCallback (&MpTcpTransferTestCase::IpRx, this));
+
+  Ptr<Socket> server = Socket::CreateSocket (nodes.Get (1), MpTcpSocketFactory::GetTypeId ());
+  server->SetAttribute ("Scheduler", TypeIdValue (m_scheduler));
+  server->SetAttribute ("CongestionControl", TypeIdValue (m_congestion));
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), 5000));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                             MakeCallback (&MpTcpTransferTestCase::Accept, this));
+
+  Ptr<Socket> client = Socket::CreateSocket (nodes.Get (0), MpTcpSocketFactory::GetTypeId ());
+  client->SetAttribute ("Scheduler", TypeIdValue (m_scheduler));
+  client->SetAttribute ("CongestionControl", TypeIdValue (m_congestion));
+  client->SetConnectCallback (MakeCallback (&MpTcpTransferTestCase::Connected, this),
+                              MakeNullCallback<void, Ptr<Socket> > ());
+  client->SetSendCallback (MakeCallback (&MpTcpTransferTestCase::SendData, this));
+  Simulator::Schedule (Seconds (1), &Socket::Connect, client, InetSocketAddress (Ipv4Address ("10.1.1.2"), 5000));
+
+  Simulator::Stop (Seconds (20));
+  Simulator::Run ();
+
+  Ptr<MpTcpSocket> meta = DynamicCast<MpTcpSocket> (client);
+  NS_TEST_EXPECT_MSG_EQ (meta->GetNSubflows (), 2, "One subflow per address of the client");
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (536));
+
+  NS_TEST_EXPECT_MSG_EQ (m_connections, 1, "A single connection");
+  NS_TEST_EXPECT_MSG_EQ (m_received, TOTAL, "All the data received");
+  NS_TEST_EXPECT_MSG_EQ (m_inOrder, true, "Data received in order");
+  NS_TEST_EXPECT_MSG_GT (m_interfaceRx[1], TOTAL / 10, "Data received on the fast link");
+  NS_TEST_EXPECT_MSG_GT (m_interfaceRx[2], TOTAL / 10, "Data received on the slow link");
+  if (m_scheduler != MpTcpSchedulerRedundant::GetTypeId ())
+    {
+      // 1 MB takes 0.8 s at 10 Mbps, without the connection setup and slow start
+      NS_TEST_EXPECT_MSG_LT (m_lastRx, Seconds (1.8), "Faster than the fast link alone");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the data of a failed subflow is reinjected
+ *
+ * The client sends 1 MB to the server over two links, and the slow link
+ * drops all the packets from the middle of the transfer on, until the
+ * subflow on it fails.  The data it did not deliver must be sent again on
+ * the fast link, and the whole data received in order.  Meanwhile, the
+ * client can only send on the fast subflow up to the receive window of the
+ * server past the first lost byte, or the server would drop the data.
+ */
+class MpTcpSubflowFailureTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param scheduler the type of scheduler
+   */
+  MpTcpSubflowFailureTestCase (TypeId scheduler);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send data while there is room in the buffer of the socket
+   * \param socket the socket
+   * \param available the room in the buffer
+   */
+  void SendData (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Start to send, once the client is connected
+   * \param socket the socket
+   */
+  void Connected (Ptr<Socket> socket);
+  /**
+   * \brief Accept a connection
+   * \param socket the socket of the connection
+   * \param from the address of the client
+   */
+  void Accept (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Receive and check data
+   * \param socket the socket
+   */
+  void Receive (Ptr<Socket> socket);
+  /**
+   * \brief The connection of the client failed
+   * \param socket the socket
+   */
+  void ErrorClose (Ptr<Socket> socket);
+  /**
+   * \brief Drop all the packets received on a device
+   * \param device the device
+   */
+  static void BreakLink (Ptr<NetDevice> device);
+
+  TypeId m_scheduler;                //!< Type of scheduler
+  uint32_t m_sent;                   //!< Bytes sent
+  uint32_t m_received;               //!< Bytes received
+  bool m_inOrder;                    //!< Whether the received bytes were the sent ones, in order
+  bool m_failed;                     //!< Whether the connection of the client failed
+  static const uint32_t TOTAL = 1000000; //!< Bytes to send
+};
+
+MpTcpSubflowFailureTestCase::MpTcpSubflowFailureTestCase (TypeId scheduler)
+  : TestCase ("MPTCP reinjection of the data of a failed subflow with " + scheduler.GetName ()),
+    m_scheduler (scheduler),
+    m_sent (0),
+    m_received (0),
+    m_inOrder (true),
+    m_failed (false)
+{
+}
+
+void
+MpTcpSubflowFailureTestCase::SendData (Ptr<Socket> socket, uint32_t available)
+{
+  while (m_sent < TOTAL && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (std::min (socket->GetTxAvailable (), TOTAL - m_sent), 1400u);
+      std::vector<uint8_t> data (size);
+      for (uint32_t i = 0; i < size; i++)
+        {
+          data[i] = (m_sent + i) % 251;
+        }
+      NS_TEST_ASSERT_MSG_EQ (socket->Send (Create<Packet> (data.data (), size)), static_cast<int> (size), "Data sent");
+      m_sent += size;
+    }
+  if (m_sent == TOTAL)
+    {
+      socket->Close ();
+      m_sent++;
+    }
+}
+
+void
+MpTcpSubflowFailureTestCase::Connected (Ptr<Socket> socket)
+{
+  SendData (socket, socket->GetTxAvailable ());
+}
+
+void
+MpTcpSubflowFailureTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&MpTcpSubflowFailureTestCase::Receive, this));
+}
+
+void
+MpTcpSubflowFailureTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      std::vector<uint8_t> data (p->GetSize ());
+      p->CopyData (data.data (), data.size ());
+      for (uint32_t i = 0; i < data.size (); i++)
+        {
+          m_inOrder &= (data[i] == (m_received + i) % 251);
+        }
+      m_received += p->GetSize ();
+    }
+}
+
+void
+MpTcpSubflowFailureTestCase::ErrorClose (Ptr<Socket> socket)
+{
+  m_failed = true;
+}
+
+void
+MpTcpSubflowFailureTestCase::BreakLink (Ptr<NetDevice> device)
+{
+  Ptr<RateErrorModel> errorModel = CreateObject<RateErrorModel> ();
+  errorModel->SetUnit (RateErrorModel::ERROR_UNIT_PACKET);
+  errorModel->SetRate (1.0);
+  device->SetAttribute ("ReceiveErrorModel", PointerValue (errorModel));
+}
+
+void
+MpTcpSubflowFailureTestCase::DoRun (void)
+{
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1400));
+  // the subflow on the broken link fails after about 7 s
+  Config::SetDefault ("ns3::TcpSocket::DataRetries", UintegerValue (2));
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  simple.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  NetDeviceContainer fastDevices = simple.Install (nodes);
+  simple.SetDeviceAttribute ("DataRate", StringValue ("5Mbps"));
+  simple.SetChannelAttribute ("Delay", StringValue ("30ms"));
+  NetDeviceContainer slowDevices = simple.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (fastDevices);
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  ipv4.Assign (slowDevices);
+
+  Ipv4StaticRoutingHelper routingHelper;
+  Ptr<Ipv4StaticRouting> routing = routingHelper.GetStaticRouting (nodes.Get (0)->GetObject<Ipv4> ());
+  routing->AddNetworkRouteTo (Ipv4Address ("10.1.1.0"), Ipv4Mask ("255.255.255.0"),
+                              Ipv4Address ("10.1.2.2"), 2, 10);
+
+  Ptr<Socket> server = Socket::CreateSocket (nodes.Get (1), MpTcpSocketFactory::GetTypeId ());
+  server->SetAttribute ("Scheduler", TypeIdValue (m_scheduler));
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), 5000));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                             MakeCallback (&MpTcpSubflowFailureTestCase::Accept, this));
+
+  Ptr<Socket> client = Socket::CreateSocket (nodes.Get (0), MpTcpSocketFactory::GetTypeId ());
+  client->SetAttribute ("Scheduler", TypeIdValue (m_scheduler));
+  client->SetConnectCallback (MakeCallback (&MpTcpSubflowFailureTestCase::Connected, this),
+                              MakeNullCallback<void, Ptr<Socket> > ());
+  client->SetSendCallback (MakeCallback (&MpTcpSubflowFailureTestCase::SendData, this));
+  client->SetCloseCallbacks (MakeNullCallback<void, Ptr<Socket> > (),
+                             MakeCallback (&MpTcpSubflowFailureTestCase::ErrorClose, this));
+  Simulator::Schedule (Seconds (1), &Socket::Connect, client, InetSocketAddress (Ipv4Address ("10.1.1.2"), 5000));
+  Simulator::Schedule (Seconds (1.4), &MpTcpSubflowFailureTestCase::BreakLink, slowDevices.Get (0));
+  Simulator::Schedule (Seconds (1.4), &MpTcpSubflowFailureTestCase::BreakLink, slowDevices.Get (1));
+
+  Simulator::Stop (Seconds (30));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (536));
+  Config::SetDefault ("ns3::TcpSocket::DataRetries", UintegerValue (6));
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, TOTAL, "All the data received");
+  NS_TEST_EXPECT_MSG_EQ (m_inOrder, true, "Data received in order");
+  NS_TEST_EXPECT_MSG_EQ (m_failed, false, "The connection survives the failure of a subflow");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that the MPTCP headers split across segments are parsed
+ *
+ * The client writes 100 bytes every 50 us, faster than the link, and the
+ * subflows use the Nagle algorithm, so they pack several data chunks, each
+ * with its DSS header, in a segment, and split some headers between two
+ * segments.  The headers must be parsed once all
+ * their bytes are received, with the packet checks enabled, and the whole
+ * data received in order.
+ */
+class MpTcpSplitHeaderTestCase : public TestCase
+{
+public:
+  MpTcpSplitHeaderTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send the next bytes, and schedule the next write
+   * \param socket the socket
+   */
+  void Write (Ptr<Socket> socket);
+  /**
+   * \brief Start to send, once the client is connected
+   * \param socket the socket
+   */
+  void Connected (Ptr<Socket> socket);
+  /**
+   * \brief Accept a connection
+   * \param socket the socket of the connection
+   * \param from the address of the client
+   */
+  void Accept (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Receive and check data
+   * \param socket the socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  uint32_t m_sent;                   //!< Bytes sent
+  uint32_t m_received;               //!< Bytes received
+  bool m_inOrder;                    //!< Whether the received bytes were the sent ones, in order
+  static const uint32_t TOTAL = 200000; //!< Bytes to send
+  static const uint32_t WRITE_SIZE = 100; //!< Bytes sent at a time
+};
+
+MpTcpSplitHeaderTestCase::MpTcpSplitHeaderTestCase ()
+  : TestCase ("MPTCP headers split across segments"),
+    m_sent (0),
+    m_received (0),
+    m_inOrder (true)
+{
+}
+
+void
+MpTcpSplitHeaderTestCase::Write (Ptr<Socket> socket)
+{
+  uint32_t size = WRITE_SIZE;
+  std::vector<uint8_t> data (size);
+  for (uint32_t i = 0; i < size; i++)
+    {
+      data[i] = (m_sent + i) % 251;
+    }
+  NS_TEST_ASSERT_MSG_EQ (socket->Send (Create<Packet> (data.data (), size)), static_cast<int> (size), "Data sent");
+  m_sent += size;
+  if (m_sent < TOTAL)
+    {
+      Simulator::Schedule (MicroSeconds (50), &MpTcpSplitHeaderTestCase::Write, this, socket);
+    }
+  else
+    {
+      socket->Close ();
+    }
+}
+
+void
+MpTcpSplitHeaderTestCase::Connected (Ptr<Socket> socket)
+{
+  Write (socket);
+}
+
+void
+MpTcpSplitHeaderTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&MpTcpSplitHeaderTestCase::Receive, this));
+}
+
+void
+MpTcpSplitHeaderTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      std::vector<uint8_t> data (p->GetSize ());
+      p->CopyData (data.data (), data.size ());
+      for (uint32_t i = 0; i < data.size (); i++)
+        {
+          m_inOrder &= (data[i] == (m_received + i) % 251);
+        }
+      m_received += p->GetSize ();
+    }
+}
+
+void
+MpTcpSplitHeaderTestCase::DoRun (void)
+{
+  // RemoveHeader aborts if a header is not at the start of a single packet
+  Packet::EnableChecking ();
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (1400));
+  Config::SetDefault ("ns3::TcpSocket::TcpNoDelay", BooleanValue (false));
+  NodeContainer nodes;
+  nodes.Create (2);
+  SimpleNetDeviceHelper simple;
+  simple.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  simple.SetChannelAttribute ("Delay", StringValue ("10ms"));
+  NetDeviceContainer devices = simple.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (devices);
+
+  Ptr<Socket> server = Socket::CreateSocket (nodes.Get (1), MpTcpSocketFactory::GetTypeId ());
+  server->Bind (InetSocketAddress (Ipv4Address::GetAny (), 5000));
+  server->Listen ();
+  server->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                             MakeCallback (&MpTcpSplitHeaderTestCase::Accept, this));
+
+  Ptr<Socket> client = Socket::CreateSocket (nodes.Get (0), MpTcpSocketFactory::GetTypeId ());
+  client->SetConnectCallback (MakeCallback (&MpTcpSplitHeaderTestCase::Connected, this),
+                              MakeNullCallback<void, Ptr<Socket> > ());
+  Simulator::Schedule (Seconds (1), &Socket::Connect, client, InetSocketAddress (Ipv4Address ("10.1.1.2"), 5000));
+
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::TcpSocket::SegmentSize", UintegerValue (536));
+  Config::SetDefault ("ns3::TcpSocket::TcpNoDelay", BooleanValue (true));
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, TOTAL, "All the data received");
+  NS_TEST_EXPECT_MSG_EQ (m_inOrder, true, "Data received in order");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Multipath TCP TestSuite
+ */
+class MpTcpTestSuite : public TestSuite
+{
+public:
+  MpTcpTestSuite ()
+    : TestSuite ("mptcp", UNIT)
+  {
+    // the packet checks must be enabled before any packet is created
+    AddTestCase (new MpTcpSplitHeaderTestCase (), TestCase::QUICK);
+    AddTestCase (new MpTcpCoupledIncreaseTestCase (), TestCase::QUICK);
+    AddTestCase (new MpTcpTransferTestCase (MpTcpSchedulerMinRtt::GetTypeId (), MpTcpLia::GetTypeId ()), TestCase::QUICK);
+    AddTestCase (new MpTcpTransferTestCase (MpTcpSchedulerRoundRobin::GetTypeId (), MpTcpLia::GetTypeId ()), TestCase::QUICK);
+    AddTestCase (new MpTcpTransferTestCase (MpTcpSchedulerRedundant::GetTypeId (), MpTcpLia::GetTypeId ()), TestCase::QUICK);
+    AddTestCase (new MpTcpTransferTestCase (MpTcpSchedulerMinRtt::GetTypeId (), MpTcpOlia::GetTypeId ()), TestCase::QUICK);
+    AddTestCase (new MpTcpTransferTestCase (MpTcpSchedulerMinRtt::GetTypeId (), MpTcpBalia::GetTypeId ()), TestCase::QUICK);
+    AddTestCase (new MpTcpSubflowFailureTestCase (MpTcpSchedulerMinRtt::GetTypeId ()), TestCase::QUICK);
+    AddTestCase (new MpTcpSubflowFailureTestCase (MpTcpSchedulerRoundRobin::GetTypeId ()), TestCase::QUICK);
+  }
+};
+
+static MpTcpTestSuite g_mptcpTestSuite; //!< Static variable for test initialization
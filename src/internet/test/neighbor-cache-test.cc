@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/socket.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ndisc-cache.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the neighbor caches filled from the topology
+ *
+ * Three nodes share a subnet, and a fourth node is on another subnet of
+ * the same channel.  The caches must hold the addresses of the subnet
+ * only, and the first packets must be sent without any resolution.
+ */
+class NeighborCacheTestCase : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   * \param permanent whether the entries are permanent
+   */
+  NeighborCacheTestCase (bool permanent);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Record the time of arrival of a packet
+   * \param socket the receiving socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  /**
+   * \brief Send a packet
+   * \param socket the sending socket
+   * \param to the destination
+   */
+  void Send (Ptr<Socket> socket, Address to);
+
+  bool m_permanent;             //!< Whether the entries are permanent
+  std::vector<Time> m_received; //!< Times of arrival of the packets
+};
+
+NeighborCacheTestCase::NeighborCacheTestCase (bool permanent)
+  : TestCase (std::string ("Neighbor cache helper, ") + (permanent ? "permanent" : "dynamic") + " entries"),
+    m_permanent (permanent)
+{
+}
+
+void
+NeighborCacheTestCase::Receive (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      m_received.push_back (Simulator::Now ());
+    }
+}
+
+void
+NeighborCacheTestCase::Send (Ptr<Socket> socket, Address to)
+{
+  socket->SendTo (Create<Packet> (100), 0, to);
+}
+
+void
+NeighborCacheTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (4);
+  SimpleNetDeviceHelper simple;
+  simple.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = simple.Install (nodes);
+
+  InternetStackHelper internet;
+  internet.Install (nodes);
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (NetDeviceContainer (devices.Get (0), devices.Get (1)));
+  ipv4.NewNetwork ();
+  ipv4.Assign (NetDeviceContainer (devices.Get (2)));
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0", "0.0.0.3");
+  ipv4.Assign (NetDeviceContainer (devices.Get (3)));
+  Ipv6AddressHelper ipv6;
+  ipv6.SetBase (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ipv6Interfaces = ipv6.Assign (devices);
+
+  NeighborCacheHelper neighbors;
+  neighbors.SetPermanent (m_permanent);
+  neighbors.PopulateNeighborCache ();
+
+  Ptr<Ipv4Interface> interface = nodes.Get (0)->GetObject<Ipv4L3Protocol> ()->GetInterface (1);
+  Ptr<ArpCache> arpCache = interface->GetArpCache ();
+  ArpCache::Entry *entry = arpCache->Lookup (Ipv4Address ("10.1.1.3"));
+  NS_TEST_ASSERT_MSG_NE (entry, 0, "Neighbor on the same subnet");
+  NS_TEST_EXPECT_MSG_EQ (entry->GetMacAddress (), devices.Get (3)->GetAddress (), "MAC address of the neighbor");
+  NS_TEST_EXPECT_MSG_EQ (entry->IsPermanent (), m_permanent, "Permanent entry");
+  NS_TEST_EXPECT_MSG_EQ (entry->IsAlive (), !m_permanent, "Alive entry");
+  NS_TEST_EXPECT_MSG_NE (arpCache->Lookup (Ipv4Address ("10.1.1.2")), 0, "Neighbor on the same subnet");
+  NS_TEST_EXPECT_MSG_EQ (arpCache->Lookup (Ipv4Address ("10.1.2.1")), 0, "Neighbor on another subnet");
+  NS_TEST_EXPECT_MSG_EQ (arpCache->Lookup (Ipv4Address ("10.1.1.1")), 0, "Own address");
+
+  Ptr<Ipv6Interface> interface6 = nodes.Get (0)->GetObject<Ipv6L3Protocol> ()->GetInterface (1);
+  Ptr<NdiscCache> ndiscCache = interface6->GetNdiscCache ();
+  for (uint32_t i = 1; i < 4; i++)
+    {
+      Ptr<Ipv6Interface> neighbor = nodes.Get (i)->GetObject<Ipv6L3Protocol> ()->GetInterface (1);
+      NdiscCache::Entry *entry6 = ndiscCache->Lookup (neighbor->GetLinkLocalAddress ().GetAddress ());
+      NS_TEST_ASSERT_MSG_NE (entry6, 0, "Link-local address of the neighbor");
+      NS_TEST_EXPECT_MSG_EQ (entry6->GetMacAddress (), devices.Get (i)->GetAddress (), "MAC address of the neighbor");
+      NS_TEST_EXPECT_MSG_EQ (entry6->IsPermanent (), m_permanent, "Permanent entry");
+      NS_TEST_EXPECT_MSG_NE (ndiscCache->Lookup (ipv6Interfaces.GetAddress (i, 1)), 0, "Global address of the neighbor");
+    }
+
+  // the first packets are sent at once, after the duplicate address detection
+  Ptr<Socket> receiver = Socket::CreateSocket (nodes.Get (3), UdpSocketFactory::GetTypeId ());
+  receiver->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234));
+  receiver->SetRecvCallback (MakeCallback (&NeighborCacheTestCase::Receive, this));
+  Ptr<Socket> receiver4 = Socket::CreateSocket (nodes.Get (3), UdpSocketFactory::GetTypeId ());
+  receiver4->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234));
+  receiver4->SetRecvCallback (MakeCallback (&NeighborCacheTestCase::Receive, this));
+  Ptr<Socket> sender = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  Simulator::Schedule (Seconds (3), &NeighborCacheTestCase::Send, this, sender,
+                       InetSocketAddress (Ipv4Address ("10.1.1.3"), 1234));
+  Ptr<Socket> sender6 = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  Simulator::Schedule (Seconds (4), &NeighborCacheTestCase::Send, this, sender6,
+                       Inet6SocketAddress (ipv6Interfaces.GetAddress (3, 1), 1234));
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 2, "Packets received");
+  NS_TEST_EXPECT_MSG_EQ (m_received[0], Seconds (3) + MilliSeconds (2), "IPv4 packet sent without ARP resolution");
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], Seconds (4) + MilliSeconds (2), "IPv6 packet sent without NDISC resolution");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Neighbor cache helper TestSuite
+ */
+class NeighborCacheTestSuite : public TestSuite
+{
+public:
+  NeighborCacheTestSuite ()
+    : TestSuite ("neighbor-cache", UNIT)
+  {
+    AddTestCase (new NeighborCacheTestCase (false), TestCase::QUICK);
+    AddTestCase (new NeighborCacheTestCase (true), TestCase::QUICK);
+  }
+};
+
+static NeighborCacheTestSuite g_neighborCacheTestSuite; //!< Static variable for test initialization
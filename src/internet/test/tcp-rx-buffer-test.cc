@@ -44,6 +44,11 @@ private:
    * \brief Test the SACK list update.
    */
   void TestUpdateSACKList ();
+
+  /**
+   * \brief Test the delivery of reordered and overlapping segments.
+   */
+  void TestReordering ();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase ()
@@ -55,6 +60,7 @@ void
 TcpRxBufferTestCase::DoRun ()
 {
   TestUpdateSACKList ();
+  TestReordering ();
 }
 
 void
@@ -338,6 +344,54 @@ TcpRxBufferTestCase::TestUpdateSACKList ()
                          "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestReordering ()
+{
+  TcpRxBuffer rxBuf;
+  TcpHeader h;
+  uint32_t segmentSize = 100;
+  uint32_t nSegments = 1024;
+  uint32_t window = 16;
+  uint32_t read = 0;
+  rxBuf.SetNextRxSequence (SequenceNumber32 (1));
+  rxBuf.SetMaxBufferSize (segmentSize * nSegments);
+
+  for (uint32_t start = 0; start < nSegments; start += window)
+    {
+      // Each window arrives in a scrambled order, with an overlapping
+      // retransmission in the middle of it
+      for (uint32_t k = 0; k < window; ++k)
+        {
+          uint32_t index = start + (k * 7) % window;
+          SequenceNumber32 seq (1 + index * segmentSize);
+          h.SetSequenceNumber (seq);
+          bool added = rxBuf.Add (Create<Packet> (segmentSize), h);
+          if (added && seq > rxBuf.NextRxSequence ())
+            {
+              TcpOptionSack::SackList sackList = rxBuf.GetSackList ();
+              NS_TEST_ASSERT_MSG_EQ (sackList.empty (), false, "No SACK block for out-of-order data");
+              NS_TEST_ASSERT_MSG_EQ ((sackList.front ().first <= seq && seq + segmentSize <= sackList.front ().second),
+                                     true, "The first SACK block does not hold the last segment");
+            }
+          if (k == window / 2)
+            {
+              h.SetSequenceNumber (SequenceNumber32 (1 + start * segmentSize + segmentSize / 2));
+              rxBuf.Add (Create<Packet> (segmentSize * 3), h);
+            }
+          if (rxBuf.Available () > 0)
+            {
+              read += rxBuf.Extract (rxBuf.Available ())->GetSize ();
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (rxBuf.NextRxSequence (), SequenceNumber32 (1 + (start + window) * segmentSize),
+                             "Sequence number differs from expected");
+      NS_TEST_ASSERT_MSG_EQ (rxBuf.GetSackListSize (), 0, "SACK list should be empty");
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (read, segmentSize * nSegments, "Data not delivered");
+  NS_TEST_ASSERT_MSG_EQ (rxBuf.Size (), 0, "Data left in the buffer");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown ()
 {
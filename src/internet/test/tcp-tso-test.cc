@@ -0,0 +1,294 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/socket-factory.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4-list-routing.h"
+#include "ns3/node.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/log.h"
+
+#include "ns3/arp-l3-protocol.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/icmpv4-l4-protocol.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/tcp-l4-protocol.h"
+#include "ns3/tcp-header.h"
+#include "ns3/traffic-control-layer.h"
+
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("TcpTsoTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the TCP segmentation offload
+ *
+ * A bulk transfer is run on a 1500 bytes MTU link with and without TSO:
+ * the super-segments are cut by the IP layer, so the receiver must get
+ * exactly the same packets at the same times.  On a link with a 64 KB MTU
+ * the same holds by default, while the super-segments are carried whole
+ * when the sender sets the Ipv4L3Protocol "TsoCarryWhole" attribute: the
+ * receiver then gets all the data in fewer packets.
+ */
+class TcpTsoTestCase : public TestCase
+{
+public:
+  TcpTsoTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Run a bulk transfer
+   * \param tso whether the sender uses TSO
+   * \param mtu the MTU of the devices
+   * \param carryWhole whether the sender carries the super-segments whole
+   * \return the packets received by the receiver IP layer
+   */
+  std::vector<std::string> RunTransfer (bool tso, uint16_t mtu, bool carryWhole);
+
+  /**
+   * \brief Create a node with the IPv4, TCP and UDP stacks
+   * \return the node
+   */
+  Ptr<Node> CreateInternetNode (void);
+  /**
+   * \brief Add a device to a node
+   * \param node the node
+   * \param address the IPv4 address of the device
+   * \param mtu the MTU of the device
+   * \return the device
+   */
+  Ptr<SimpleNetDevice> AddDevice (Ptr<Node> node, const char *address, uint16_t mtu);
+
+  /**
+   * \brief Fill the sender buffer
+   * \param socket the sender socket
+   * \param available the available space in the buffer
+   */
+  void Send (Ptr<Socket> socket, uint32_t available);
+  /**
+   * \brief Accept a connection
+   * \param socket the accepted socket
+   * \param from the address of the peer
+   */
+  void Accept (Ptr<Socket> socket, const Address &from);
+  /**
+   * \brief Read the received data
+   * \param socket the receiver socket
+   */
+  void Receive (Ptr<Socket> socket);
+  /**
+   * \brief Record a packet received by the receiver IP layer
+   * \param packet the packet
+   * \param ipv4 the IPv4 stack
+   * \param interface the interface
+   */
+  void IpRx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+  uint32_t m_totalBytes;                 //!< Bytes to transfer
+  uint32_t m_sentBytes;                  //!< Bytes given to the sender socket
+  uint32_t m_receivedBytes;              //!< Bytes read from the receiver socket
+  std::vector<std::string> m_received;   //!< Packets received by the receiver IP layer
+};
+
+TcpTsoTestCase::TcpTsoTestCase ()
+  : TestCase ("TCP segmentation offload"),
+    m_totalBytes (2000000),
+    m_sentBytes (0),
+    m_receivedBytes (0)
+{
+}
+
+Ptr<Node>
+TcpTsoTestCase::CreateInternetNode (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer> ();
+  node->AggregateObject (tc);
+  // no random ARP jitter, so that the runs can be compared
+  Ptr<ArpL3Protocol> arp = CreateObjectWithAttributes<ArpL3Protocol> ("RequestJitter", StringValue ("ns3::ConstantRandomVariable[Constant=0.0]"));
+  node->AggregateObject (arp);
+  arp->SetTrafficControl (tc);
+  Ptr<Ipv4L3Protocol> ipv4 = CreateObject<Ipv4L3Protocol> ();
+  Ptr<Ipv4ListRouting> ipv4Routing = CreateObject<Ipv4ListRouting> ();
+  ipv4->SetRoutingProtocol (ipv4Routing);
+  Ptr<Ipv4StaticRouting> ipv4staticRouting = CreateObject<Ipv4StaticRouting> ();
+  ipv4Routing->AddRoutingProtocol (ipv4staticRouting, 0);
+  node->AggregateObject (ipv4);
+  node->AggregateObject (CreateObject<Icmpv4L4Protocol> ());
+  node->AggregateObject (CreateObject<UdpL4Protocol> ());
+  node->AggregateObject (CreateObject<TcpL4Protocol> ());
+  return node;
+}
+
+Ptr<SimpleNetDevice>
+TcpTsoTestCase::AddDevice (Ptr<Node> node, const char *address, uint16_t mtu)
+{
+  Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice> ();
+  dev->SetAddress (Mac48Address::ConvertFrom (Mac48Address::Allocate ()));
+  dev->SetMtu (mtu);
+  dev->SetAttribute ("DataRate", StringValue ("100Mbps"));
+  Ptr<Queue<Packet> > queue = CreateObjectWithAttributes<DropTailQueue<Packet> > ("MaxSize", StringValue ("10000p"));
+  dev->SetAttribute ("TxQueue", PointerValue (queue));
+  node->AddDevice (dev);
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  uint32_t ndid = ipv4->AddInterface (dev);
+  ipv4->AddAddress (ndid, Ipv4InterfaceAddress (Ipv4Address (address), Ipv4Mask ("255.255.255.0")));
+  ipv4->SetUp (ndid);
+  return dev;
+}
+
+void
+TcpTsoTestCase::Send (Ptr<Socket> socket, uint32_t available)
+{
+  while (m_sentBytes < m_totalBytes && socket->GetTxAvailable () > 0)
+    {
+      uint32_t size = std::min (socket->GetTxAvailable (), m_totalBytes - m_sentBytes);
+      int sent = socket->Send (Create<Packet> (size));
+      if (sent <= 0)
+        {
+          break;
+        }
+      m_sentBytes += sent;
+    }
+}
+
+void
+TcpTsoTestCase::Accept (Ptr<Socket> socket, const Address &from)
+{
+  socket->SetRecvCallback (MakeCallback (&TcpTsoTestCase::Receive, this));
+}
+
+void
+TcpTsoTestCase::Receive (Ptr<Socket> socket)
+{
+  Ptr<Packet> p;
+  while ((p = socket->Recv ()))
+    {
+      m_receivedBytes += p->GetSize ();
+    }
+}
+
+void
+TcpTsoTestCase::IpRx (Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+  Ptr<Packet> p = packet->Copy ();
+  Ipv4Header ipHeader;
+  p->RemoveHeader (ipHeader);
+  TcpHeader tcpHeader;
+  p->RemoveHeader (tcpHeader);
+  std::ostringstream oss;
+  oss << Simulator::Now ().GetNanoSeconds () << " id=" << ipHeader.GetIdentification ()
+      << " seq=" << tcpHeader.GetSequenceNumber () << " ack=" << tcpHeader.GetAckNumber ()
+      << " flags=" << TcpHeader::FlagsToString (tcpHeader.GetFlags ())
+      << " win=" << tcpHeader.GetWindowSize () << " size=" << p->GetSize ();
+  m_received.push_back (oss.str ());
+}
+
+std::vector<std::string>
+TcpTsoTestCase::RunTransfer (bool tso, uint16_t mtu, bool carryWhole)
+{
+  m_sentBytes = 0;
+  m_receivedBytes = 0;
+  m_received.clear ();
+
+  Ptr<Node> node0 = CreateInternetNode ();
+  Ptr<Node> node1 = CreateInternetNode ();
+  node0->GetObject<Ipv4L3Protocol> ()->SetAttribute ("TsoCarryWhole", BooleanValue (carryWhole));
+  Ptr<SimpleNetDevice> dev0 = AddDevice (node0, "10.1.1.1", mtu);
+  Ptr<SimpleNetDevice> dev1 = AddDevice (node1, "10.1.1.2", mtu);
+  Ptr<SimpleChannel> channel = CreateObjectWithAttributes<SimpleChannel> ("Delay", StringValue ("5ms"));
+  dev0->SetChannel (channel);
+  dev1->SetChannel (channel);
+  node1->GetObject<Ipv4L3Protocol> ()->TraceConnectWithoutContext ("Rx", MakeCallback (&TcpTsoTestCase::IpRx, this));
+
+  Ptr<Socket> receiver = node1->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  receiver->Bind (InetSocketAddress (Ipv4Address::GetAny (), 5000));
+  receiver->Listen ();
+  receiver->SetAcceptCallback (MakeNullCallback<bool, Ptr<Socket>, const Address &> (),
+                               MakeCallback (&TcpTsoTestCase::Accept, this));
+
+  Ptr<Socket> sender = node0->GetObject<TcpSocketFactory> ()->CreateSocket ();
+  sender->SetAttribute ("SegmentSize", UintegerValue (1448));
+  sender->SetAttribute ("SndBufSize", UintegerValue (1 << 20));
+  sender->SetAttribute ("Tso", BooleanValue (tso));
+  sender->SetSendCallback (MakeCallback (&TcpTsoTestCase::Send, this));
+  sender->Connect (InetSocketAddress (Ipv4Address ("10.1.1.2"), 5000));
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_receivedBytes, m_totalBytes, "All the data is received");
+  return m_received;
+}
+
+void
+TcpTsoTestCase::DoRun (void)
+{
+  std::vector<std::string> reference = RunTransfer (false, 1500, false);
+  std::vector<std::string> split = RunTransfer (true, 1500, true);
+  NS_TEST_ASSERT_MSG_EQ (split.size (), reference.size (), "Same number of packets with TSO");
+  for (uint32_t i = 0; i < reference.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (split[i], reference[i], "Same packet " << i << " with TSO");
+    }
+
+  std::vector<std::string> large = RunTransfer (true, 0xffff, false);
+  NS_TEST_ASSERT_MSG_EQ (large.size (), reference.size (), "Same number of packets with TSO by default");
+  for (uint32_t i = 0; i < reference.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (large[i], reference[i], "Same packet " << i << " with TSO by default");
+    }
+
+  std::vector<std::string> whole = RunTransfer (true, 0xffff, true);
+  NS_TEST_EXPECT_MSG_LT (whole.size (), reference.size () / 4, "Super-segments carried whole");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP segmentation offload TestSuite
+ */
+class TcpTsoTestSuite : public TestSuite
+{
+public:
+  TcpTsoTestSuite ()
+    : TestSuite ("tcp-tso", UNIT)
+  {
+    AddTestCase (new TcpTsoTestCase (), TestCase::QUICK);
+  }
+};
+
+static TcpTsoTestSuite g_tcpTsoTestSuite; //!< Static variable for test initialization
@@ -53,6 +53,8 @@ private:
   /** \brief Test the logic of merging items in GetTransmittedSegment()
    * which is triggered by CopyFromSequence()*/
   void TestMergeItemsWhenGetTransmittedSegment ();
+  /** \brief Test the scoreboard with a large window and scattered losses */
+  void TestLargeWindow ();
   /**
    * \brief Callback to provide a value of receiver window
    * \returns the receiver window size
@@ -101,6 +103,13 @@ TcpTxBufferTestCase::DoRun ()
   Simulator::Schedule (Seconds (0.0),
                          &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment, this);
 
+  /*
+   * Case for a large window:
+   *  -> one segment every hundred is lost, the others are sacked one by one
+   *  -> every lost segment is detected, and NextSeg returns them in order
+   */
+  Simulator::Schedule (Seconds (0.0), &TcpTxBufferTestCase::TestLargeWindow, this);
+
   Simulator::Run ();
   Simulator::Destroy ();
 }
@@ -385,6 +394,74 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment ()
   txBuf.CopyFromSequence (2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestLargeWindow ()
+{
+  Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer> ();
+  txBuf->SetRWndCallback (MakeCallback (&TcpTxBufferTestCase::GetRWnd, this));
+  SequenceNumber32 head (1);
+  SequenceNumber32 ret;
+  SequenceNumber32 retHigh;
+  uint32_t segmentSize = 1000;
+  uint32_t nSegments = 10000;
+  txBuf->SetHeadSequence (head);
+  txBuf->SetSegmentSize (segmentSize);
+  txBuf->SetDupAckThresh (3);
+  txBuf->SetMaxBufferSize (segmentSize * nSegments);
+  Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack> ();
+
+  txBuf->Add (Create<Packet> (segmentSize * nSegments));
+  for (uint32_t i = 0; i < nSegments; ++i)
+    {
+      txBuf->CopyFromSequence (segmentSize, head + (segmentSize * i));
+    }
+
+  // Every segment but one every hundred reaches the other end
+  for (uint32_t i = 0; i < nSegments; ++i)
+    {
+      if (i % 100 != 0)
+        {
+          sack->AddSackBlock (TcpOptionSack::SackBlock (head + (segmentSize * i),
+                                                        head + (segmentSize * (i + 1))));
+          txBuf->Update (sack->GetSackList ());
+          sack->ClearSackList ();
+        }
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetLost (), segmentSize * nSegments / 100,
+                         "Lost segments not detected");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->GetSacked (), segmentSize * (nSegments - nSegments / 100),
+                         "Sacked segments not counted");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), 0,
+                         "TxBuf miscalculates size of in flight segments");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsLost (head + (segmentSize * 4200)), true,
+                         "Lost is false, but it's not");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->IsLost (head + (segmentSize * 4201)), false,
+                         "Lost is true, but it's not");
+
+  // The lost segments are retransmitted in order
+  for (uint32_t i = 0; i < nSegments; i += 100)
+    {
+      NS_TEST_ASSERT_MSG_EQ (txBuf->NextSeg (&ret, &retHigh, true), true,
+                             "No NextSeq with lost segments");
+      NS_TEST_ASSERT_MSG_EQ (ret, head + (segmentSize * i),
+                             "Different NextSeq than expected in recovery");
+      NS_TEST_ASSERT_MSG_EQ (txBuf->IsRetransmittedDataAcked (ret + segmentSize), false,
+                             "Data acked before the retransmission");
+      txBuf->CopyFromSequence (segmentSize, ret);
+      NS_TEST_ASSERT_MSG_EQ (txBuf->IsRetransmittedDataAcked (ret + segmentSize), true,
+                             "Retransmission not found");
+    }
+  NS_TEST_ASSERT_MSG_EQ (txBuf->NextSeg (&ret, &retHigh, true), false,
+                         "NextSeq returned without lost nor new data");
+  NS_TEST_ASSERT_MSG_EQ (txBuf->BytesInFlight (), segmentSize * nSegments / 100,
+                         "TxBuf miscalculates size of in flight segments");
+
+  txBuf->DiscardUpTo (head + (segmentSize * nSegments));
+  NS_TEST_ASSERT_MSG_EQ (txBuf->Size (), 0,
+                         "Data inside the buffer");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock ()
 {
@@ -0,0 +1,228 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/callback.h"
+#include "mobility-model.h"
+#include "mobility-grid-index.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityGridIndex");
+
+MobilityGridIndex::MobilityGridIndex ()
+  : m_cellSize (100.0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilityGridIndex::~MobilityGridIndex ()
+{
+  NS_LOG_FUNCTION (this);
+  Clear ();
+}
+
+void
+MobilityGridIndex::SetCellSize (double size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT_MSG (size > 0, "The cells must have a positive size");
+  if (size == m_cellSize)
+    {
+      return;
+    }
+  m_cellSize = size;
+  for (uint32_t i = 0; i < m_items.size (); i++)
+    {
+      if (!m_items[i].dirty)
+        {
+          Unplace (i);
+          m_items[i].dirty = true;
+          m_dirty.push_back (i);
+        }
+    }
+}
+
+double
+MobilityGridIndex::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint32_t
+MobilityGridIndex::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  uint32_t item = m_items.size ();
+  m_items.push_back ({mobility, false, 0, true});
+  m_dirty.push_back (item);
+  if (mobility != 0)
+    {
+      std::vector<uint32_t> &items = m_models[PeekPointer (mobility)];
+      if (items.empty ())
+        {
+          mobility->TraceConnectWithoutContext ("CourseChange",
+                                                MakeCallback (&MobilityGridIndex::NotifyCourseChange, this));
+        }
+      items.push_back (item);
+    }
+  return item;
+}
+
+uint32_t
+MobilityGridIndex::GetN (void) const
+{
+  return m_items.size ();
+}
+
+void
+MobilityGridIndex::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (const auto &model : m_models)
+    {
+      m_items[model.second.front ()].mobility->TraceDisconnectWithoutContext ("CourseChange",
+                                                                              MakeCallback (&MobilityGridIndex::NotifyCourseChange, this));
+    }
+  m_models.clear ();
+  m_items.clear ();
+  m_cells.clear ();
+  m_unplaced.clear ();
+  m_dirty.clear ();
+}
+
+void
+MobilityGridIndex::GetCandidates (const Vector &position, double range,
+                                  std::vector<uint32_t> &items)
+{
+  NS_LOG_FUNCTION (this << position << range);
+  Update ();
+  items = m_unplaced;
+  int64_t xMin = GetCellIndex (position.x - range);
+  int64_t xMax = GetCellIndex (position.x + range);
+  int64_t yMin = GetCellIndex (position.y - range);
+  int64_t yMax = GetCellIndex (position.y + range);
+  if (static_cast<double> (xMax - xMin + 1) * (yMax - yMin + 1) > m_cells.size ())
+    {
+      // the range covers more cells than there are non-empty ones
+      for (const auto &cell : m_cells)
+        {
+          items.insert (items.end (), cell.second.begin (), cell.second.end ());
+        }
+    }
+  else
+    {
+      for (int64_t x = xMin; x <= xMax; x++)
+        {
+          for (int64_t y = yMin; y <= yMax; y++)
+            {
+              auto cell = m_cells.find (GetCellKey (x, y));
+              if (cell != m_cells.end ())
+                {
+                  items.insert (items.end (), cell->second.begin (), cell->second.end ());
+                }
+            }
+        }
+    }
+  std::sort (items.begin (), items.end ());
+}
+
+uint64_t
+MobilityGridIndex::GetCellKey (int64_t x, int64_t y)
+{
+  return (static_cast<uint64_t> (static_cast<uint32_t> (x)) << 32)
+         | static_cast<uint32_t> (y);
+}
+
+int64_t
+MobilityGridIndex::GetCellIndex (double coordinate) const
+{
+  return static_cast<int64_t> (std::floor (coordinate / m_cellSize));
+}
+
+void
+MobilityGridIndex::Unplace (uint32_t item)
+{
+  std::vector<uint32_t> *items;
+  if (m_items[item].inCell)
+    {
+      auto cell = m_cells.find (m_items[item].cell);
+      NS_ASSERT (cell != m_cells.end ());
+      items = &cell->second;
+    }
+  else
+    {
+      items = &m_unplaced;
+    }
+  auto it = std::find (items->begin (), items->end (), item);
+  NS_ASSERT (it != items->end ());
+  items->erase (it);
+  if (m_items[item].inCell && items->empty ())
+    {
+      m_cells.erase (m_items[item].cell);
+    }
+  m_items[item].inCell = false;
+}
+
+void
+MobilityGridIndex::Place (uint32_t item)
+{
+  Ptr<MobilityModel> mobility = m_items[item].mobility;
+  if (mobility == 0 || mobility->GetVelocity () != Vector (0, 0, 0))
+    {
+      NS_LOG_LOGIC ("Item " << item << " is returned by all the lookups");
+      m_items[item].inCell = false;
+      m_unplaced.push_back (item);
+      return;
+    }
+  Vector position = mobility->GetPosition ();
+  m_items[item].inCell = true;
+  m_items[item].cell = GetCellKey (GetCellIndex (position.x), GetCellIndex (position.y));
+  m_cells[m_items[item].cell].push_back (item);
+}
+
+void
+MobilityGridIndex::Update (void)
+{
+  for (uint32_t item : m_dirty)
+    {
+      Place (item);
+      m_items[item].dirty = false;
+    }
+  m_dirty.clear ();
+}
+
+void
+MobilityGridIndex::NotifyCourseChange (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  auto model = m_models.find (PeekPointer (mobility));
+  NS_ASSERT (model != m_models.end ());
+  for (uint32_t item : model->second)
+    {
+      if (!m_items[item].dirty)
+        {
+          Unplace (item);
+          m_items[item].dirty = true;
+          m_dirty.push_back (item);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,160 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_GRID_INDEX_H
+#define MOBILITY_GRID_INDEX_H
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+class MobilityModel;
+
+/**
+ * \ingroup mobility
+ * \brief Uniform grid over the positions of mobility models
+ *
+ * The grid finds the mobility models which may be within a given range of
+ * a position, without looking at all of them; the channels use it to skip
+ * the receivers out of range of a transmitter.  The items are numbered in
+ * the order they are added.
+ *
+ * The grid has square cells in the x-y plane; the z coordinate is
+ * ignored.  Only the items which do not move are put in the cells: the
+ * items which move, and the items without mobility model, are returned by
+ * every lookup.  The positions are not sampled at each lookup: the
+ * CourseChange trace of the mobility models marks their items, which are
+ * moved to their new cell at the next lookup.
+ */
+class MobilityGridIndex
+{
+public:
+  MobilityGridIndex ();
+  ~MobilityGridIndex ();
+
+  /**
+   * \brief Set the size of the cells
+   *
+   * The lookups are fastest with cells about the size of their range.
+   *
+   * \param size the size of the cells (m), strictly positive
+   */
+  void SetCellSize (double size);
+
+  /**
+   * \return the size of the cells (m)
+   */
+  double GetCellSize (void) const;
+
+  /**
+   * \brief Add an item
+   * \param mobility the mobility model of the item, possibly 0
+   * \return the number of the item
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+
+  /**
+   * \return the number of items
+   */
+  uint32_t GetN (void) const;
+
+  /**
+   * \brief Remove all the items
+   */
+  void Clear (void);
+
+  /**
+   * \brief Get the items which may be within a range of a position
+   *
+   * All the items within the range are returned, and possibly some more:
+   * the caller checks the actual distance.
+   *
+   * \param position the position
+   * \param range the range (m)
+   * \param items the numbers of the items, in increasing order
+   */
+  void GetCandidates (const Vector &position, double range,
+                      std::vector<uint32_t> &items);
+
+private:
+  /**
+   * \brief An item of the grid
+   */
+  struct Item
+  {
+    Ptr<MobilityModel> mobility; //!< The mobility model, possibly 0
+    bool inCell;                 //!< Whether the item is in a cell
+    uint64_t cell;               //!< The key of the cell of the item
+    bool dirty;                  //!< Whether the item must be placed again
+  };
+
+  /// Disable copy: the mobility models call back this object
+  MobilityGridIndex (const MobilityGridIndex &) = delete;
+  /// Disable assignment
+  MobilityGridIndex & operator = (const MobilityGridIndex &) = delete;
+
+  /**
+   * \brief Get the key of a cell
+   * \param x the x index of the cell
+   * \param y the y index of the cell
+   * \return the key
+   */
+  static uint64_t GetCellKey (int64_t x, int64_t y);
+
+  /**
+   * \brief Get the index of the cell of a coordinate
+   * \param coordinate the coordinate (m)
+   * \return the index
+   */
+  int64_t GetCellIndex (double coordinate) const;
+
+  /**
+   * \brief Take an item out of its cell, or out of the unplaced items
+   * \param item the number of the item
+   */
+  void Unplace (uint32_t item);
+
+  /**
+   * \brief Put an item in the cell of its position, or in the unplaced items
+   * \param item the number of the item
+   */
+  void Place (uint32_t item);
+
+  /**
+   * \brief Place again the items whose mobility model changed course
+   */
+  void Update (void);
+
+  /**
+   * \brief Mark the items of a mobility model which changed course
+   * \param mobility the mobility model
+   */
+  void NotifyCourseChange (Ptr<const MobilityModel> mobility);
+
+  double m_cellSize;                                           //!< Size of the cells (m)
+  std::vector<Item> m_items;                                   //!< The items
+  std::unordered_map<uint64_t, std::vector<uint32_t> > m_cells; //!< Items of each cell
+  std::vector<uint32_t> m_unplaced;                            //!< Items in no cell
+  std::vector<uint32_t> m_dirty;                               //!< Items to place again
+  std::map<const MobilityModel *, std::vector<uint32_t> > m_models; //!< Items of each mobility model
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_GRID_INDEX_H */
@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/test.h"
+#include "ns3/mobility-grid-index.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the grid returns all the items in range, and follows
+ * the course changes of the mobility models
+ */
+class MobilityGridIndexTestCase : public TestCase
+{
+public:
+  MobilityGridIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check that the candidates of a lookup contain the items in range
+   * \param index the grid
+   * \param models the mobility models of the items
+   * \param position the position of the lookup
+   * \param range the range of the lookup
+   * \return the candidates
+   */
+  std::vector<uint32_t> CheckLookup (MobilityGridIndex &index,
+                                     const std::vector<Ptr<MobilityModel> > &models,
+                                     const Vector &position, double range);
+};
+
+MobilityGridIndexTestCase::MobilityGridIndexTestCase ()
+  : TestCase ("Check the lookups of the mobility grid index")
+{
+}
+
+std::vector<uint32_t>
+MobilityGridIndexTestCase::CheckLookup (MobilityGridIndex &index,
+                                        const std::vector<Ptr<MobilityModel> > &models,
+                                        const Vector &position, double range)
+{
+  std::vector<uint32_t> candidates;
+  index.GetCandidates (position, range, candidates);
+  NS_TEST_EXPECT_MSG_EQ (std::is_sorted (candidates.begin (), candidates.end ()), true,
+                         "The candidates are not in increasing order");
+  for (uint32_t i = 0; i < models.size (); i++)
+    {
+      if (models[i] == 0
+          || CalculateDistance (models[i]->GetPosition (), position) <= range)
+        {
+          NS_TEST_EXPECT_MSG_EQ (std::binary_search (candidates.begin (), candidates.end (), i),
+                                 true, "Item " << i << " in range is not a candidate");
+        }
+    }
+  return candidates;
+}
+
+void
+MobilityGridIndexTestCase::DoRun (void)
+{
+  MobilityGridIndex index;
+  index.SetCellSize (25);
+  std::vector<Ptr<MobilityModel> > models;
+
+  // 10x10 items, 10 m apart
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Ptr<MobilityModel> model = CreateObject<ConstantPositionMobilityModel> ();
+      model->SetPosition (Vector (10.0 * (i % 10), 10.0 * (i / 10), 0));
+      models.push_back (model);
+      NS_TEST_EXPECT_MSG_EQ (index.Add (model), i, "Unexpected item number");
+    }
+  std::vector<uint32_t> candidates = CheckLookup (index, models, Vector (45, 45, 0), 25);
+  NS_TEST_EXPECT_MSG_LT (candidates.size (), 100, "The lookup did not skip the far items");
+
+  // an item without mobility model, and a moving item, are always candidates
+  models.push_back (0);
+  index.Add (0);
+  Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel> ();
+  moving->SetPosition (Vector (1000, 1000, 0));
+  moving->SetVelocity (Vector (1, 0, 0));
+  models.push_back (moving);
+  index.Add (moving);
+  candidates = CheckLookup (index, models, Vector (0, 0, 0), 10);
+  NS_TEST_EXPECT_MSG_EQ (std::binary_search (candidates.begin (), candidates.end (), 100u), true,
+                         "The item without mobility model is not a candidate");
+  NS_TEST_EXPECT_MSG_EQ (std::binary_search (candidates.begin (), candidates.end (), 101u), true,
+                         "The moving item is not a candidate");
+
+  // a course change moves the item to its new cell
+  models[99]->SetPosition (Vector (0, 0, 0));
+  candidates = CheckLookup (index, models, Vector (0, 0, 0), 10);
+  NS_TEST_EXPECT_MSG_EQ (std::binary_search (candidates.begin (), candidates.end (), 99u), true,
+                         "The moved item is not a candidate");
+  models[99]->SetPosition (Vector (500, 500, 0));
+  candidates = CheckLookup (index, models, Vector (0, 0, 0), 10);
+  NS_TEST_EXPECT_MSG_EQ (std::binary_search (candidates.begin (), candidates.end (), 99u), false,
+                         "The item moved away is still a candidate");
+
+  // the item stops: it is in a cell again
+  moving->SetVelocity (Vector (0, 0, 0));
+  candidates = CheckLookup (index, models, Vector (0, 0, 0), 10);
+  NS_TEST_EXPECT_MSG_EQ (std::binary_search (candidates.begin (), candidates.end (), 101u), false,
+                         "The stopped item is still a candidate");
+
+  // a change of cell size places all the items again
+  index.SetCellSize (7);
+  CheckLookup (index, models, Vector (33, 58, 0), 17);
+  CheckLookup (index, models, Vector (-1000, -1000, 0), 5000);
+
+  index.Clear ();
+  NS_TEST_EXPECT_MSG_EQ (index.GetN (), 0, "The grid is not empty");
+  models[0]->SetPosition (Vector (1, 1, 0));
+  index.GetCandidates (Vector (0, 0, 0), 10, candidates);
+  NS_TEST_EXPECT_MSG_EQ (candidates.size (), 0, "An empty grid returned candidates");
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Mobility grid index test suite
+ */
+class MobilityGridIndexTestSuite : public TestSuite
+{
+public:
+  MobilityGridIndexTestSuite ();
+};
+
+MobilityGridIndexTestSuite::MobilityGridIndexTestSuite ()
+  : TestSuite ("mobility-grid-index", UNIT)
+{
+  AddTestCase (new MobilityGridIndexTestCase, TestCase::QUICK);
+}
+
+static MobilityGridIndexTestSuite g_mobilityGridIndexTestSuite; //!< Static variable for test initialization
@@ -350,6 +350,15 @@ Buffer::AddAtStart (uint32_t start)
   LOG_INTERNAL_STATE ("add start=" << start << ", ");
   NS_ASSERT (CheckInternalState ());
 }
+uint8_t *
+Buffer::AddAtStartForWrite (uint32_t start)
+{
+  NS_LOG_FUNCTION (this << start);
+  AddAtStart (start);
+  // The bytes just added always lie before the zero area
+  NS_ASSERT (m_start + start <= m_zeroAreaStart);
+  return m_data->m_data + m_start;
+}
 void
 Buffer::AddAtEnd (uint32_t end)
 {
@@ -954,7 +963,7 @@ void
 Buffer::Iterator::Write (uint8_t const*buffer, uint32_t size)
 {
   NS_LOG_FUNCTION (this << &buffer << size);
-  NS_ASSERT_MSG (CheckNoZero (m_current, size),
+  NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
   uint8_t *to;
   if (m_current <= m_zeroStart)
@@ -510,6 +510,15 @@ private:
    * pointing to this Buffer.
    */
   void AddAtStart (uint32_t start);
+  /**
+   * \param start size to reserve
+   * \returns a pointer to the \p start bytes added
+   *
+   * Same as AddAtStart, but also return a pointer to the new bytes so that
+   * they can be written in bulk, without an Iterator. The pointer is
+   * invalidated by any subsequent change to the Buffer.
+   */
+  uint8_t *AddAtStartForWrite (uint32_t start);
   /**
    * \param end size to reserve
    *
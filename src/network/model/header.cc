@@ -42,6 +42,12 @@ Header::GetTypeId (void)
   return tid;
 }
 
+bool
+Header::SerializeTo (uint8_t *start, uint32_t packetSize) const
+{
+  return false;
+}
+
 std::ostream & operator << (std::ostream &os, const Header &header)
 {
   header.Print (os);
@@ -70,6 +70,25 @@ public:
    * header in a real network.
    */
   virtual void Serialize (Buffer::Iterator start) const = 0;
+  /**
+   * \param start a pointer to GetSerializedSize () contiguous bytes
+   *        where the header should be written.
+   * \param packetSize the number of bytes in the packet, counting from
+   *        \p start (i.e., including this header).
+   * \returns true if the header was written, false if it must be
+   *          written by Serialize (Buffer::Iterator) instead.
+   *
+   * This method is the fast path of Packet::AddHeader. Headers with a
+   * fixed wire layout can override it to build their representation in
+   * a flat array and store it with a single copy, instead of writing it
+   * byte by byte through a Buffer::Iterator. The bytes written must match
+   * those written by Serialize. Headers whose serialization depends on
+   * the rest of the packet (e.g., to compute a checksum) should return
+   * false in that case.
+   *
+   * The default implementation returns false.
+   */
+  virtual bool SerializeTo (uint8_t *start, uint32_t packetSize) const;
   /**
    * \param start an iterator which points to where the header should
    *        read from.
@@ -29,11 +29,52 @@
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
 #include <cstring>
+#include <cstdlib>
+#include <vector>
+
+#define USE_FREE_LIST 1
+#define FREE_LIST_SIZE 1000
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
+#ifdef USE_FREE_LIST
+/**
+ * \ingroup packet
+ *
+ * \brief Container class for pooled PacketTagList::TagData slots
+ *
+ * Every slot is large enough to hold PacketTagList::POOLED_TAG_SIZE
+ * bytes of tag data.  At most FREE_LIST_SIZE released slots are kept
+ * for reuse, further releases go back to the system allocator, so the
+ * memory held by the list is bounded.  Internal use only.
+ */
+static class PacketTagListFreeList : public std::vector<void *>
+{
+public:
+  PacketTagListFreeList ();
+  ~PacketTagListFreeList ();
+  bool m_destroyed; //!< set once the list has been torn down at exit
+} g_freeList; //!< Container for pooled TagData slots
+
+PacketTagListFreeList::PacketTagListFreeList ()
+  : m_destroyed (false)
+{
+}
+
+PacketTagListFreeList::~PacketTagListFreeList ()
+{
+  for (PacketTagListFreeList::iterator i = begin ();
+       i != end (); i++)
+    {
+      std::free (*i);
+    }
+  clear ();
+  m_destroyed = true;
+}
+#endif /* USE_FREE_LIST */
+
 PacketTagList::TagData *
 PacketTagList::CreateTagData (size_t dataSize)
 {
@@ -43,14 +84,49 @@ PacketTagList::CreateTagData (size_t dataSize)
                  << " exceeds maximum "
                  << std::numeric_limits<decltype(TagData::size)>::max () );
 
-  void * p = std::malloc (sizeof (TagData) + dataSize - 1);
-  // The matching frees are in RemoveAll and RemoveWriter
+  void * p = 0;
+#ifdef USE_FREE_LIST
+  if (dataSize <= POOLED_TAG_SIZE)
+    {
+      if (!g_freeList.empty ())
+        {
+          p = g_freeList.back ();
+          g_freeList.pop_back ();
+        }
+      else
+        {
+          p = std::malloc (sizeof (TagData) + POOLED_TAG_SIZE - 1);
+        }
+    }
+  else
+#endif /* USE_FREE_LIST */
+    {
+      p = std::malloc (sizeof (TagData) + dataSize - 1);
+    }
+  // The matching releases are in FreeTagData
 
   TagData * tag = new (p) TagData;
   tag->size = dataSize;
   return tag;
 }
 
+void
+PacketTagList::FreeTagData (TagData * tag)
+{
+  uint32_t size = tag->size;
+  tag->~TagData ();
+#ifdef USE_FREE_LIST
+  if (size <= POOLED_TAG_SIZE
+      && !g_freeList.m_destroyed
+      && g_freeList.size () < FREE_LIST_SIZE)
+    {
+      g_freeList.push_back (tag);
+      return;
+    }
+#endif /* USE_FREE_LIST */
+  std::free (tag);
+}
+
 bool
 PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
 {
@@ -194,8 +270,7 @@ PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
   if (preMerge)
     {
       // found tid before first merge, so delete cur
-      cur->~TagData ();
-      std::free (cur);
+      FreeTagData (cur);
     }
   else
     {
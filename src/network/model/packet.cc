@@ -257,10 +257,13 @@ Packet::AddHeader (const Header &header)
 {
   uint32_t size = header.GetSerializedSize ();
   NS_LOG_FUNCTION (this << header.GetInstanceTypeId ().GetName () << size);
-  m_buffer.AddAtStart (size);
+  uint8_t *start = m_buffer.AddAtStartForWrite (size);
   m_byteTagList.Adjust (size);
   m_byteTagList.AddAtStart (size);
-  header.Serialize (m_buffer.Begin ());
+  if (!header.SerializeTo (start, m_buffer.GetSize ()))
+    {
+      header.Serialize (m_buffer.Begin ());
+    }
   m_metadata.AddHeader (header, size);
 }
 uint32_t
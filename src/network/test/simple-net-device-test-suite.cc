@@ -0,0 +1,230 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/node.h"
+#include "ns3/queue.h"
+#include "ns3/uinteger.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simple-channel.h"
+#include "ns3/error-channel.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * Test the burst mode of the SimpleNetDevice.
+ *
+ * A device sends the same packets over a SimpleChannel with a long delay,
+ * first with burst mode disabled and then with a MaxBurstSize larger than
+ * one, and every packet must be dequeued and received at the same time in
+ * both cases.  With a finite data rate the packets are received at
+ * different times, so the number of events is unchanged; with an infinite
+ * one, the packets sent at the same time must be received by one event per
+ * MaxBurstSize packets.  Then, the same packets are sent in burst mode over
+ * a channel that overrides SimpleChannel::Send, which must see every
+ * packet.
+ */
+class SimpleNetDeviceBurstTestCase : public TestCase
+{
+public:
+  SimpleNetDeviceBurstTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /// The events recorded while running the scenario
+  struct Events
+  {
+    std::vector<std::pair<Time, uint32_t> > rx;      //!< receive time and size of each packet
+    std::vector<std::pair<Time, uint32_t> > dequeue; //!< dequeue time and queue length after each dequeue
+    uint64_t nEvents;                                //!< number of events executed
+  };
+
+  /**
+   * Run the scenario
+   *
+   * \param channel the channel
+   * \param maxBurstSize the MaxBurstSize of the sending device
+   * \param dataRate the data rate of the sending device
+   * \return the recorded events
+   */
+  Events RunScenario (Ptr<SimpleChannel> channel, uint32_t maxBurstSize, DataRate dataRate);
+  /**
+   * Check that burst mode does not change the times at which the packets
+   * are dequeued and received
+   *
+   * \param reference the events with burst mode disabled
+   * \param burst the events in burst mode
+   */
+  void CheckEvents (const Events &reference, const Events &burst);
+  /**
+   * Callback function which records the received packets
+   *
+   * \param dev the receiving device
+   * \param pkt the received packet
+   * \param protocol the protocol number
+   * \param sender the sender address
+   * \return true
+   */
+  bool RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t protocol, const Address &sender);
+  /**
+   * Trace sink for the Dequeue trace of the transmit queue
+   *
+   * \param pkt the dequeued packet
+   */
+  void Dequeue (Ptr<const Packet> pkt);
+
+  Events m_events;                  //!< the events recorded in the current run
+  Ptr<Queue<Packet> > m_queue;      //!< the transmit queue of the sending device
+};
+
+SimpleNetDeviceBurstTestCase::SimpleNetDeviceBurstTestCase ()
+  : TestCase ("Check the burst mode of the SimpleNetDevice")
+{
+}
+
+bool
+SimpleNetDeviceBurstTestCase::RxPacket (Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t protocol,
+                                        const Address &sender)
+{
+  m_events.rx.push_back ({Simulator::Now (), pkt->GetSize ()});
+  return true;
+}
+
+void
+SimpleNetDeviceBurstTestCase::Dequeue (Ptr<const Packet> pkt)
+{
+  m_events.dequeue.push_back ({Simulator::Now (), m_queue->GetNPackets ()});
+}
+
+SimpleNetDeviceBurstTestCase::Events
+SimpleNetDeviceBurstTestCase::RunScenario (Ptr<SimpleChannel> channel, uint32_t maxBurstSize, DataRate dataRate)
+{
+  m_events = Events ();
+
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<SimpleNetDevice> devA = CreateObject<SimpleNetDevice> ();
+  Ptr<SimpleNetDevice> devB = CreateObject<SimpleNetDevice> ();
+
+  devA->SetAttribute ("MaxBurstSize", UintegerValue (maxBurstSize));
+  devA->SetAttribute ("DataRate", DataRateValue (dataRate));
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetChannel (channel);
+  a->AddDevice (devA);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetChannel (channel);
+  b->AddDevice (devB);
+
+  devB->SetReceiveCallback (MakeCallback (&SimpleNetDeviceBurstTestCase::RxPacket, this));
+  m_queue = devA->GetQueue ();
+  m_queue->TraceConnectWithoutContext ("Dequeue", MakeCallback (&SimpleNetDeviceBurstTestCase::Dequeue, this));
+
+  // a backlog of 10 packets, and 5 more packets while the first ones are
+  // still propagating
+  for (uint32_t i = 0; i < 15; i++)
+    {
+      Simulator::Schedule (i < 10 ? Seconds (1.0) : Seconds (1.003), &SimpleNetDevice::Send, devA,
+                           Create<Packet> (100 + i), devB->GetAddress (), 0x800);
+    }
+
+  Simulator::Run ();
+  m_events.nEvents = Simulator::GetEventCount ();
+  Simulator::Destroy ();
+  m_queue = 0;
+
+  return m_events;
+}
+
+void
+SimpleNetDeviceBurstTestCase::CheckEvents (const Events &reference, const Events &burst)
+{
+  NS_TEST_ASSERT_MSG_EQ (reference.rx.size (), 15, "Every packet should be received");
+  NS_TEST_ASSERT_MSG_EQ (burst.rx.size (), reference.rx.size (), "Every packet of the bursts should be received");
+  for (std::size_t i = 0; i < reference.rx.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (burst.rx[i].second, reference.rx[i].second, "Packets should be received in order");
+      NS_TEST_EXPECT_MSG_EQ (burst.rx[i].first, reference.rx[i].first,
+                             "Packet " << i << " should be received at the end of its propagation delay");
+    }
+  NS_TEST_ASSERT_MSG_EQ (burst.dequeue.size (), reference.dequeue.size (), "Unexpected number of dequeued packets");
+  for (std::size_t i = 0; i < reference.dequeue.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (burst.dequeue[i].first, reference.dequeue[i].first,
+                             "Packet " << i << " should be dequeued when its transmission starts");
+      NS_TEST_EXPECT_MSG_EQ (burst.dequeue[i].second, reference.dequeue[i].second,
+                             "Unexpected queue length after dequeuing packet " << i);
+    }
+}
+
+void
+SimpleNetDeviceBurstTestCase::DoRun (void)
+{
+  Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (5)));
+  Events reference = RunScenario (channel, 1, DataRate ("1Mbps"));
+
+  channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (5)));
+  Events burst = RunScenario (channel, 4, DataRate ("1Mbps"));
+
+  CheckEvents (reference, burst);
+  NS_TEST_EXPECT_MSG_EQ (burst.nEvents, reference.nEvents, "Packets received at different times are not coalesced");
+
+  channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (5)));
+  reference = RunScenario (channel, 1, DataRate ());
+
+  channel = CreateObject<SimpleChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (5)));
+  burst = RunScenario (channel, 4, DataRate ());
+
+  CheckEvents (reference, burst);
+  // 10 packets received at once take 3 events instead of 10, and 5 packets
+  // take 2 events instead of 5
+  NS_TEST_EXPECT_MSG_EQ (burst.nEvents, reference.nEvents - 10, "Packets received at the same time are coalesced");
+
+  // ErrorChannel overrides SimpleChannel::Send and delivers packets without delay
+  Events errorChannel = RunScenario (CreateObject<ErrorChannel> (), 4, DataRate ("1Mbps"));
+  NS_TEST_EXPECT_MSG_EQ (errorChannel.rx.size (), 15,
+                         "Every packet should be received through a channel overriding Send");
+}
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief SimpleNetDevice TestSuite
+ */
+class SimpleNetDeviceTestSuite : public TestSuite
+{
+public:
+  SimpleNetDeviceTestSuite ();
+};
+
+SimpleNetDeviceTestSuite::SimpleNetDeviceTestSuite ()
+  : TestSuite ("simple-net-device", UNIT)
+{
+  AddTestCase (new SimpleNetDeviceBurstTestCase, TestCase::QUICK);
+}
+
+static SimpleNetDeviceTestSuite g_simpleNetDeviceTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,169 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/spsc-ring.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include <thread>
+#endif
+
+using namespace ns3;
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * SpscRing unit tests: the capacity is rounded up to a power of two, a
+ * full ring rejects new values and values come out in order.
+ */
+class SpscRingTestCase : public TestCase
+{
+public:
+  SpscRingTestCase ();
+  virtual void DoRun (void);
+};
+
+SpscRingTestCase::SpscRingTestCase ()
+  : TestCase ("Sanity check on the SPSC ring implementation")
+{
+}
+
+void
+SpscRingTestCase::DoRun (void)
+{
+  SpscRing<uint32_t> ring (3);
+  NS_TEST_EXPECT_MSG_EQ (ring.GetCapacity (), 4, "The capacity should be rounded up to a power of two");
+  NS_TEST_EXPECT_MSG_EQ (ring.IsEmpty (), true, "The ring should be empty");
+
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (ring.Push (i), (i < 4), "The ring holds four values");
+    }
+  NS_TEST_EXPECT_MSG_EQ (ring.GetSize (), 4, "The ring should be full");
+
+  uint32_t value;
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (ring.Pop (value), true, "There should be a value to pop");
+      NS_TEST_EXPECT_MSG_EQ (value, i, "Values should be popped in order");
+    }
+
+  // wrap around the end of the storage
+  NS_TEST_EXPECT_MSG_EQ (ring.Push (10), true, "There should be room for a value");
+  NS_TEST_EXPECT_MSG_EQ (ring.Push (11), true, "There should be room for a value");
+  NS_TEST_EXPECT_MSG_EQ (ring.Push (12), false, "The ring should be full");
+  const uint32_t expected[] = {2, 3, 10, 11};
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (ring.Pop (value), true, "There should be a value to pop");
+      NS_TEST_EXPECT_MSG_EQ (value, expected[i], "Values should be popped in order");
+    }
+  NS_TEST_EXPECT_MSG_EQ (ring.Pop (value), false, "The ring should be empty");
+  NS_TEST_EXPECT_MSG_EQ (ring.IsEmpty (), true, "The ring should be empty");
+}
+
+#ifdef HAVE_PTHREAD_H
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * SpscRing test with a real producer thread: every value must come out
+ * exactly once and in order.
+ */
+class SpscRingThreadTestCase : public TestCase
+{
+public:
+  SpscRingThreadTestCase ();
+  virtual void DoRun (void);
+
+private:
+  /// Producer thread body
+  void Produce (void);
+
+  SpscRing<uint32_t> m_ring; //!< the ring under test
+  uint32_t m_n;              //!< number of values to transfer
+};
+
+SpscRingThreadTestCase::SpscRingThreadTestCase ()
+  : TestCase ("SPSC ring with a concurrent producer"),
+    m_ring (64),
+    m_n (10000)
+{
+}
+
+void
+SpscRingThreadTestCase::Produce (void)
+{
+  for (uint32_t i = 0; i < m_n; i++)
+    {
+      while (!m_ring.Push (i))
+        {
+          // let the consumer run, even on a single CPU
+          std::this_thread::yield ();
+        }
+    }
+}
+
+void
+SpscRingThreadTestCase::DoRun (void)
+{
+  Ptr<SystemThread> producer = Create<SystemThread> (MakeCallback (&SpscRingThreadTestCase::Produce, this));
+  producer->Start ();
+
+  uint32_t expected = 0;
+  bool inOrder = true;
+  while (expected < m_n)
+    {
+      uint32_t value;
+      if (m_ring.Pop (value))
+        {
+          inOrder = inOrder && (value == expected);
+          expected++;
+        }
+      else
+        {
+          std::this_thread::yield ();
+        }
+    }
+  producer->Join ();
+
+  NS_TEST_EXPECT_MSG_EQ (inOrder, true, "Values should come out in order");
+  NS_TEST_EXPECT_MSG_EQ (m_ring.IsEmpty (), true, "The ring should be empty");
+}
+#endif /* HAVE_PTHREAD_H */
+
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * \brief SpscRing TestSuite
+ */
+class SpscRingTestSuite : public TestSuite
+{
+public:
+  SpscRingTestSuite ()
+    : TestSuite ("spsc-ring", UNIT)
+  {
+    AddTestCase (new SpscRingTestCase (), TestCase::QUICK);
+#ifdef HAVE_PTHREAD_H
+    AddTestCase (new SpscRingThreadTestCase (), TestCase::QUICK);
+#endif
+  }
+};
+
+static SpscRingTestSuite g_spscRingTestSuite; //!< Static variable for test initialization
@@ -64,19 +64,61 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
         {
           continue;
         }
-      if (m_blackListedDevices.find (tmp) != m_blackListedDevices.end ())
+      if (IsBlackListed (tmp, sender))
         {
-          if (find (m_blackListedDevices[tmp].begin (), m_blackListedDevices[tmp].end (), sender) !=
-              m_blackListedDevices[tmp].end () )
+          continue;
+        }
+      if (sender->GetMaxBurstSize () > 1)
+        {
+          Ptr<InFlightBurst>& burst = m_bursts[tmp];
+          if (burst == 0 || burst->sender != sender || burst->rxTime != Simulator::Now () + m_delay
+              || burst->packets.size () >= sender->GetMaxBurstSize ())
             {
-              continue;
+              // no receive event is pending for packets received at the same time
+              burst = Create<InFlightBurst> ();
+              burst->sender = sender;
+              burst->rxTime = Simulator::Now () + m_delay;
+              Simulator::ScheduleWithContext (tmp->GetNode ()->GetId (), m_delay,
+                                              &SimpleChannel::DeliverBurst, this, burst, tmp);
             }
+          burst->packets.push_back ({p->Copy (), protocol, to, from});
+          continue;
         }
       Simulator::ScheduleWithContext (tmp->GetNode ()->GetId (), m_delay,
                                       &SimpleNetDevice::Receive, tmp, p->Copy (), protocol, to, from);
     }
 }
 
+void
+SimpleChannel::DeliverBurst (Ptr<InFlightBurst> burst, Ptr<SimpleNetDevice> receiver)
+{
+  NS_LOG_FUNCTION (this << receiver << burst->packets.size ());
+  NS_ASSERT (burst->rxTime == Simulator::Now ());
+
+  // the packets sent from now on go through another event
+  std::map<Ptr<SimpleNetDevice>, Ptr<InFlightBurst> >::iterator it = m_bursts.find (receiver);
+  if (it != m_bursts.end () && it->second == burst)
+    {
+      m_bursts.erase (it);
+    }
+  for (std::vector<InFlightPacket>::const_iterator i = burst->packets.begin (); i != burst->packets.end (); ++i)
+    {
+      receiver->Receive (i->packet, i->protocol, i->to, i->from);
+    }
+}
+
+bool
+SimpleChannel::IsBlackListed (Ptr<SimpleNetDevice> receiver, Ptr<SimpleNetDevice> sender) const
+{
+  std::map<Ptr<SimpleNetDevice>, std::vector<Ptr<SimpleNetDevice> > >::const_iterator it;
+  it = m_blackListedDevices.find (receiver);
+  if (it == m_blackListedDevices.end ())
+    {
+      return false;
+    }
+  return find (it->second.begin (), it->second.end (), sender) != it->second.end ();
+}
+
 void
 SimpleChannel::Add (Ptr<SimpleNetDevice> device)
 {
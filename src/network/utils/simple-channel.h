@@ -23,6 +23,7 @@
 #include "ns3/channel.h"
 #include "ns3/nstime.h"
 #include "mac48-address.h"
+#include "ns3/simple-ref-count.h"
 #include <vector>
 #include <map>
 
@@ -58,6 +59,14 @@ public:
    * scheduled for all net device connected to the channel other 
    * than the net device who sent the packet
    *
+   * If the sender runs in burst mode (see the MaxBurstSize attribute of
+   * SimpleNetDevice), the packets that it sends to a device at the same
+   * time, hence which are received at the same time, are delivered in
+   * order by a single receive event, instead of one event each.  They are
+   * then processed before the other events of that time, rather than
+   * interleaved with them.  Subclasses overriding this method do not have
+   * to care about burst mode.
+   *
    * \param p packet to be sent
    * \param protocol protocol number
    * \param to address to send packet to
@@ -98,9 +107,42 @@ public:
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
 private:
+  /// A packet propagating to a device, with its addressing information
+  struct InFlightPacket
+  {
+    Ptr<Packet> packet;     //!< the packet
+    uint16_t protocol;      //!< the protocol number
+    Mac48Address to;        //!< the destination address
+    Mac48Address from;      //!< the source address
+  };
+
+  /// Packets of a burst that are propagating to a device
+  struct InFlightBurst : public SimpleRefCount<InFlightBurst>
+  {
+    Ptr<SimpleNetDevice> sender;          //!< the device that sent the burst
+    Time rxTime;                          //!< the (absolute) receive time of the packets
+    std::vector<InFlightPacket> packets;  //!< the packets to be received
+  };
+
+  /**
+   * Deliver the packets of a burst to the given device, in order.
+   *
+   * \param burst the burst
+   * \param receiver the receiving device
+   */
+  void DeliverBurst (Ptr<InFlightBurst> burst, Ptr<SimpleNetDevice> receiver);
+
+  /**
+   * \param receiver a device connected to the channel
+   * \param sender the device sending a packet
+   * \returns true if receiver has blacklisted sender
+   */
+  bool IsBlackListed (Ptr<SimpleNetDevice> receiver, Ptr<SimpleNetDevice> sender) const;
+
   Time m_delay; //!< The assigned speed-of-light delay of the channel
   std::vector<Ptr<SimpleNetDevice> > m_devices; //!< devices connected by the channel
   std::map<Ptr<SimpleNetDevice>, std::vector<Ptr<SimpleNetDevice> > > m_blackListedDevices; //!< devices blocked on a device
+  std::map<Ptr<SimpleNetDevice>, Ptr<InFlightBurst> > m_bursts; //!< pending burst that the packets sent to each device can join (burst mode only)
 };
 
 } // namespace ns3
@@ -30,6 +30,7 @@
 #include "ns3/tag.h"
 #include "ns3/simulator.h"
 #include "ns3/queue.h"
+#include "ns3/uinteger.h"
 
 namespace ns3 {
 
@@ -210,6 +211,14 @@ SimpleNetDevice::GetTypeId (void)
                    DataRateValue (DataRate ("0b/s")),
                    MakeDataRateAccessor (&SimpleNetDevice::m_bps),
                    MakeDataRateChecker ())
+    .AddAttribute ("MaxBurstSize",
+                   "The maximum number of packets sent at the same time by this "
+                   "device that the channel delivers to each receiving device "
+                   "by a single receive event.  A value of 1 disables burst "
+                   "mode.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&SimpleNetDevice::m_maxBurstSize),
+                   MakeUintegerChecker<uint32_t> (1))
     .AddTraceSource ("PhyRxDrop",
                      "Trace source indicating a packet has been dropped "
                      "by the device during reception",
@@ -224,7 +233,8 @@ SimpleNetDevice::SimpleNetDevice ()
     m_node (0),
     m_mtu (0xffff),
     m_ifIndex (0),
-    m_linkUp (false)
+    m_linkUp (false),
+    m_maxBurstSize (1)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -287,6 +297,12 @@ SimpleNetDevice::GetQueue () const
   return m_queue;
 }
 
+uint32_t
+SimpleNetDevice::GetMaxBurstSize (void) const
+{
+  return m_maxBurstSize;
+}
+
 void
 SimpleNetDevice::SetQueue (Ptr<Queue<Packet> > q)
 {
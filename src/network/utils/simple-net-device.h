@@ -96,6 +96,15 @@ public:
    */
   Ptr<Queue<Packet> > GetQueue (void) const;
 
+  /**
+   * Get the maximum number of packets that a SimpleChannel delivers to
+   * each receiving device through a single receive event (see the
+   * MaxBurstSize attribute).
+   *
+   * \returns the maximum burst size (1 if burst mode is disabled)
+   */
+  uint32_t GetMaxBurstSize (void) const;
+
   /**
    * Attach a receive ErrorModel to the SimpleNetDevice.
    *
@@ -183,6 +192,7 @@ private:
 
   Ptr<Queue<Packet> > m_queue; //!< The Queue for outgoing packets.
   DataRate m_bps; //!< The device nominal Data rate. Zero means infinite
+  uint32_t m_maxBurstSize; //!< Max number of packets received as one burst
   EventId FinishTransmissionEvent; //!< the Tx Complete event
 
   /**
@@ -0,0 +1,176 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup queue
+ *
+ * \brief A bounded, lock-free, single-producer/single-consumer ring buffer
+ *
+ * One thread (the producer) may call Push while another thread (the
+ * consumer) calls Pop, IsEmpty or GetSize, without any lock.  No other
+ * concurrent use is allowed.  The capacity is rounded up to a power of two
+ * and can only be changed while the ring is not being used by another
+ * thread.
+ *
+ * This is a plain container, not an ns-3 Object: it is meant to hand data
+ * from device reader threads (e.g., FdNetDevice, TapBridge) to the
+ * simulator thread, where packets can then be built and traced.  It must
+ * not carry reference-counted ns-3 objects such as Ptr<Packet>, since
+ * their reference counts are not atomic.
+ */
+template <typename T>
+class SpscRing
+{
+public:
+  /**
+   * \brief Constructor
+   * \param capacity the minimum number of elements the ring can hold
+   */
+  explicit SpscRing (uint32_t capacity = 1024);
+
+  /**
+   * \brief Change the capacity of the ring, discarding its content
+   * \param capacity the minimum number of elements the ring can hold
+   */
+  void SetCapacity (uint32_t capacity);
+  /**
+   * \return the number of elements the ring can hold
+   */
+  uint32_t GetCapacity (void) const;
+
+  /**
+   * \brief Append an element (producer side)
+   * \param value the element to append
+   * \return false if the ring is full, true otherwise
+   */
+  bool Push (const T &value);
+  /**
+   * \brief Remove the oldest element (consumer side)
+   * \param [out] value the element removed
+   * \return false if the ring is empty, true otherwise
+   */
+  bool Pop (T &value);
+  /**
+   * \return true if the ring is empty (exact on the consumer side)
+   */
+  bool IsEmpty (void) const;
+  /**
+   * \return the number of elements in the ring (a snapshot, which may be
+   *         stale by the time it is used if the other side is active)
+   */
+  uint32_t GetSize (void) const;
+
+private:
+  std::vector<T> m_slots;            //!< storage, power-of-two sized
+  uint32_t m_mask;                   //!< m_slots.size () - 1
+  // head and tail are kept on separate cache lines to avoid false sharing
+  // between the producer and the consumer
+  alignas (64) std::atomic<uint32_t> m_head; //!< next slot to read (consumer)
+  alignas (64) std::atomic<uint32_t> m_tail; //!< next slot to write (producer)
+};
+
+/**
+ * Implementation of the templates declared above.
+ */
+
+template <typename T>
+SpscRing<T>::SpscRing (uint32_t capacity)
+  : m_mask (0),
+    m_head (0),
+    m_tail (0)
+{
+  SetCapacity (capacity);
+}
+
+template <typename T>
+void
+SpscRing<T>::SetCapacity (uint32_t capacity)
+{
+  uint32_t size = 1;
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  m_slots.assign (size, T ());
+  m_mask = size - 1;
+  m_head.store (0, std::memory_order_relaxed);
+  m_tail.store (0, std::memory_order_relaxed);
+}
+
+template <typename T>
+uint32_t
+SpscRing<T>::GetCapacity (void) const
+{
+  return m_mask + 1;
+}
+
+template <typename T>
+bool
+SpscRing<T>::Push (const T &value)
+{
+  uint32_t tail = m_tail.load (std::memory_order_relaxed);
+  uint32_t head = m_head.load (std::memory_order_acquire);
+  if (tail - head > m_mask)
+    {
+      return false;
+    }
+  m_slots[tail & m_mask] = value;
+  m_tail.store (tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool
+SpscRing<T>::Pop (T &value)
+{
+  uint32_t head = m_head.load (std::memory_order_relaxed);
+  uint32_t tail = m_tail.load (std::memory_order_acquire);
+  if (head == tail)
+    {
+      return false;
+    }
+  value = m_slots[head & m_mask];
+  m_slots[head & m_mask] = T ();
+  m_head.store (head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool
+SpscRing<T>::IsEmpty (void) const
+{
+  return m_head.load (std::memory_order_acquire) == m_tail.load (std::memory_order_acquire);
+}
+
+template <typename T>
+uint32_t
+SpscRing<T>::GetSize (void) const
+{
+  return m_tail.load (std::memory_order_acquire) - m_head.load (std::memory_order_acquire);
+}
+
+} // namespace ns3
+
+#endif /* SPSC_RING_H */
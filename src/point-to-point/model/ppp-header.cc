@@ -85,6 +85,14 @@ PppHeader::Serialize (Buffer::Iterator start) const
   start.WriteHtonU16 (m_protocol);
 }
 
+bool
+PppHeader::SerializeTo (uint8_t *start, uint32_t packetSize) const
+{
+  start[0] = (m_protocol >> 8) & 0xff;
+  start[1] = m_protocol & 0xff;
+  return true;
+}
+
 uint32_t
 PppHeader::Deserialize (Buffer::Iterator start)
 {
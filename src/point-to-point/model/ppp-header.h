@@ -76,6 +76,7 @@ public:
 
   virtual void Print (std::ostream &os) const;
   virtual void Serialize (Buffer::Iterator start) const;
+  virtual bool SerializeTo (uint8_t *start, uint32_t packetSize) const;
   virtual uint32_t Deserialize (Buffer::Iterator start);
   virtual uint32_t GetSerializedSize (void) const;
 
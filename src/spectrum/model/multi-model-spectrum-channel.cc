@@ -134,6 +134,9 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
     }
 
   ++m_numDevices;
+  // the receivers are numbered in the order of the SpectrumModels, so
+  // the index is built again at the next transmission
+  m_receiverIndex.Clear ();
 
   RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.find (rxSpectrumModelUid);
 
@@ -235,10 +238,39 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // with MaxRange, the receivers are numbered in the order of the loops
+  // below, and the ones which are not candidates are skipped
+  std::vector<uint32_t> candidates;
+  bool useIndex = m_maxRange > 0 && txMobility;
+  if (useIndex)
+    {
+      if (m_receiverIndex.GetN () == 0)
+        {
+          for (const auto &rxInfo : m_rxSpectrumModelInfoMap)
+            {
+              for (const auto &rxPhy : rxInfo.second.m_rxPhys)
+                {
+                  m_receiverIndex.Add (rxPhy->GetMobility ());
+                }
+            }
+        }
+      m_receiverIndex.SetCellSize (m_maxRange);
+      m_receiverIndex.GetCandidates (txMobility->GetPosition (), m_maxRange, candidates);
+      m_nCulledByRange += m_receiverIndex.GetN () - candidates.size ();
+    }
+  std::vector<uint32_t>::const_iterator nextCandidate = candidates.begin ();
+  uint32_t receiver = 0;
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
-       ++rxInfoIterator)
+       receiver += rxInfoIterator->second.m_rxPhys.size (), ++rxInfoIterator)
     {
+      if (useIndex && (nextCandidate == candidates.end ()
+                       || *nextCandidate >= receiver + rxInfoIterator->second.m_rxPhys.size ()))
+        {
+          // no candidate receiver uses this SpectrumModel
+          continue;
+        }
       SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid ();
       NS_LOG_LOGIC ("rxSpectrumModelUids " << rxSpectrumModelUid);
 
@@ -255,15 +287,29 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           if (rxConverterIterator == txInfoIteratorerator->second.m_spectrumConverterMap.end ())
             {
               // No converter means TX SpectrumModel is orthogonal to RX SpectrumModel
+              while (nextCandidate != candidates.end ()
+                     && *nextCandidate < receiver + rxInfoIterator->second.m_rxPhys.size ())
+                {
+                  ++nextCandidate;
+                }
               continue;
             }
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
+      uint32_t rxPhyNumber = receiver;
       for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin ();
            rxPhyIterator != rxInfoIterator->second.m_rxPhys.end ();
-           ++rxPhyIterator)
+           ++rxPhyIterator, ++rxPhyNumber)
         {
+          if (useIndex)
+            {
+              if (nextCandidate == candidates.end () || *nextCandidate != rxPhyNumber)
+                {
+                  continue;
+                }
+              ++nextCandidate;
+            }
           NS_ASSERT_MSG ((*rxPhyIterator)->GetRxSpectrumModel ()->GetUid () == rxSpectrumModelUid,
                          "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
 
@@ -275,6 +321,10 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
               Time delay = MicroSeconds (0);
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+              if (IsBeyondMaxRange (txMobility, receiverMobility))
+                {
+                  continue;
+                }
 
               if (txMobility && receiverMobility)
                 {
@@ -311,6 +361,7 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   if (pathLossDb > m_maxLossDb)
                     {
                       // beyond range
+                      m_nCulledByLoss++;
                       continue;
                     }
                   double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
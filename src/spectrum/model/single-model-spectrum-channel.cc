@@ -106,15 +106,35 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
   Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility ();
 
-  for (PhyList::const_iterator rxPhyIterator = m_phyList.begin ();
-       rxPhyIterator != m_phyList.end ();
-       ++rxPhyIterator)
+  std::vector<uint32_t> candidates;
+  std::size_t nReceivers = m_phyList.size ();
+  bool useIndex = m_maxRange > 0 && senderMobility;
+  if (useIndex)
     {
+      // the mobility models are looked up only now, since they may be
+      // set after the PHYs are added to the channel
+      for (std::size_t i = m_receiverIndex.GetN (); i < m_phyList.size (); i++)
+        {
+          m_receiverIndex.Add (m_phyList[i]->GetMobility ());
+        }
+      m_receiverIndex.SetCellSize (m_maxRange);
+      m_receiverIndex.GetCandidates (senderMobility->GetPosition (), m_maxRange, candidates);
+      m_nCulledByRange += m_phyList.size () - candidates.size ();
+      nReceivers = candidates.size ();
+    }
+
+  for (std::size_t j = 0; j < nReceivers; j++)
+    {
+      PhyList::const_iterator rxPhyIterator = m_phyList.begin () + (useIndex ? candidates[j] : j);
       if ((*rxPhyIterator) != txParams->txPhy)
         {
           Time delay  = MicroSeconds (0);
 
           Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
+          if (IsBeyondMaxRange (senderMobility, receiverMobility))
+            {
+              continue;
+            }
           NS_LOG_LOGIC ("copying signal parameters " << txParams);
           Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
 
@@ -153,6 +173,7 @@ SingleModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
               if ( pathLossDb > m_maxLossDb)
                 {
                   // beyond range
+                  m_nCulledByLoss++;
                   continue;
                 }
               double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
@@ -32,6 +32,9 @@ NS_LOG_COMPONENT_DEFINE ("SpectrumChannel");
 NS_OBJECT_ENSURE_REGISTERED (SpectrumChannel);
 
 SpectrumChannel::SpectrumChannel ()
+  : m_maxRange (0),
+    m_nCulledByRange (0),
+    m_nCulledByLoss (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -47,6 +50,7 @@ SpectrumChannel::DoDispose ()
   m_propagationLoss = 0;
   m_propagationDelay = 0;
   m_spectrumPropagationLoss = 0;
+  m_receiverIndex.Clear ();
 }
 
 TypeId
@@ -70,6 +74,17 @@ SpectrumChannel::GetTypeId (void)
                    MakeDoubleAccessor (&SpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
 
+    .AddAttribute ("MaxRange",
+                   "The distance in meters beyond which transmissions are not "
+                   "passed to the receiving PHY, and the loss is not computed. "
+                   "The receivers are found through a grid of their positions, "
+                   "so that a transmission costs only for the receivers near "
+                   "the transmitter. The default value 0 considers all the "
+                   "receivers.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&SpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
+
     .AddAttribute ("PropagationLossModel",
                    "A pointer to the propagation loss model attached to this channel.",
                    PointerValue (0),
@@ -155,5 +170,30 @@ SpectrumChannel::GetPropagationLossModel ()
   return m_propagationLoss;
 }
 
+uint64_t
+SpectrumChannel::GetNCulledByRange (void) const
+{
+  return m_nCulledByRange;
+}
+
+uint64_t
+SpectrumChannel::GetNCulledByLoss (void) const
+{
+  return m_nCulledByLoss;
+}
+
+bool
+SpectrumChannel::IsBeyondMaxRange (Ptr<const MobilityModel> txMobility,
+                                   Ptr<const MobilityModel> rxMobility)
+{
+  if (m_maxRange > 0 && txMobility && rxMobility
+      && txMobility->GetDistanceFrom (rxMobility) > m_maxRange)
+    {
+      m_nCulledByRange++;
+      return true;
+    }
+  return false;
+}
+
 
 } // namespace
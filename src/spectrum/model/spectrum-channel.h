@@ -32,6 +32,7 @@
 #include <ns3/spectrum-phy.h>
 #include <ns3/traced-callback.h>
 #include <ns3/mobility-model.h>
+#include <ns3/mobility-grid-index.h>
 
 namespace ns3 {
 
@@ -44,6 +45,11 @@ class SpectrumValue;
  *
  * Defines the interface for spectrum-aware channel implementations
  *
+ * The receivers are skipped, without scheduling their reception, when the
+ * loss is above the MaxLossDb attribute, or when they are farther than the
+ * MaxRange attribute from the transmitter; in the latter case, the loss is
+ * not computed, and the implementations can look up the receivers near the
+ * transmitter in a MobilityGridIndex.
  */
 class SpectrumChannel : public Channel
 {
@@ -125,6 +131,18 @@ public:
    */
   virtual void AddRx (Ptr<SpectrumPhy> phy) = 0;
 
+  /**
+   * \return the number of receivers skipped because they were beyond
+   *         the MaxRange attribute
+   */
+  uint64_t GetNCulledByRange (void) const;
+
+  /**
+   * \return the number of receivers skipped because the loss was above
+   *         the MaxLossDb attribute
+   */
+  uint64_t GetNCulledByLoss (void) const;
+
   /**
    * TracedCallback signature for path loss calculation events.
    *
@@ -157,6 +175,16 @@ public:
   typedef void (* SignalParametersTracedCallback) (Ptr<SpectrumSignalParameters> params);
 
 protected:
+  /**
+   * Check whether a receiver is beyond the MaxRange attribute, and count
+   * it if so
+   *
+   * \param txMobility the mobility model of the transmitter
+   * \param rxMobility the mobility model of the receiver
+   * \return true if the receiver must be skipped
+   */
+  bool IsBeyondMaxRange (Ptr<const MobilityModel> txMobility,
+                         Ptr<const MobilityModel> rxMobility);
 
   /**
    * The `PathLoss` trace source. Exporting the pointers to the Tx and Rx
@@ -183,6 +211,29 @@ protected:
    */
   double m_maxLossDb;
 
+  /**
+   * Maximum distance between the transmitter and a receiver [m], 0 if none.
+   */
+  double m_maxRange;
+
+  /**
+   * Positions of the receivers, used with m_maxRange.
+   *
+   * The implementations add the receivers, and look up the ones near the
+   * transmitter; the cell size is set to m_maxRange.
+   */
+  MobilityGridIndex m_receiverIndex;
+
+  /**
+   * Number of receivers skipped because they were beyond m_maxRange.
+   */
+  uint64_t m_nCulledByRange;
+
+  /**
+   * Number of receivers skipped because the loss was above m_maxLossDb.
+   */
+  uint64_t m_nCulledByLoss;
+
   /**
    * Single-frequency propagation loss model to be used with this channel.
    */
@@ -34,6 +34,7 @@
 #include "ns3/realtime-simulator-impl.h"
 #include "ns3/unix-fd-reader.h"
 #include "ns3/uinteger.h"
+#include "ns3/trace-source-accessor.h"
 
 #include <sys/wait.h>
 #include <sys/stat.h>
@@ -137,6 +138,18 @@ TapBridge::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&TapBridge::m_verbose),
                    MakeBooleanChecker ())
+    .AddAttribute ("RxQueueSize",
+                   "Maximum size of the read queue.  This value limits the "
+                   "number of packets that have been read from the tap device "
+                   "but have not yet been processed by the simulator.",
+                   UintegerValue (1000),
+                   MakeUintegerAccessor (&TapBridge::m_maxPendingReads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddTraceSource ("RxQueueDrop",
+                     "A packet read from the tap device has been dropped "
+                     "because the read queue is full (see RxQueueSize).",
+                     MakeTraceSourceAccessor (&TapBridge::m_rxQueueDropTrace),
+                     "ns3::Packet::TracedCallback")
   ;
   return tid;
 }
@@ -152,6 +165,7 @@ TapBridge::TapBridge ()
 {
   NS_LOG_FUNCTION (this);
   m_packetBuffer = new uint8_t[65536];
+  m_forwardPending = false;
   Start (m_tStart);
 }
 
@@ -233,6 +247,8 @@ TapBridge::StartTapDevice (void)
   // Now spin up a read thread to read packets from the tap device.
   //
   NS_ABORT_MSG_IF (m_fdReader != 0,"TapBridge::StartTapDevice(): Receive thread is already running");
+  m_pendingQueue.SetCapacity (m_maxPendingReads);
+  m_forwardPending = false;
   NS_LOG_LOGIC ("Spinning up read thread");
 
   m_fdReader = Create<TapBridgeFdReader> ();
@@ -255,6 +271,12 @@ TapBridge::StopTapDevice (void)
       close (m_sock);
       m_sock = -1;
     }
+
+  std::pair<uint8_t *, ssize_t> next;
+  while (m_pendingQueue.Pop (next))
+    {
+      std::free (next.first);
+    }
 }
 
 void
@@ -709,12 +731,52 @@ TapBridge::ReadCallback (uint8_t *buf, ssize_t len)
   // are talking about two threads here, so it is very, very dangerous to do
   // any kind of reference counting on a shared object.  Just don't do it.
   // So what we're going to do is pass the buffer allocated on the heap
-  // into the ns-3 context thread where it will create the packet.
+  // into the ns-3 context thread where it will create the packet.  The
+  // buffers go through a lock-free ring, and a single event drains all the
+  // buffers read since the previous one, instead of one event per packet.
   //
 
   NS_LOG_INFO ("TapBridge::ReadCallback(): Received packet on node " << m_nodeId);
-  NS_LOG_INFO ("TapBridge::ReadCallback(): Scheduling handler");
-  Simulator::ScheduleWithContext (m_nodeId, Seconds (0.0), MakeEvent (&TapBridge::ForwardToBridgedDevice, this, buf, len));
+  if (m_pendingQueue.GetSize () >= m_maxPendingReads
+      || !m_pendingQueue.Push (std::make_pair (buf, len)))
+    {
+      NS_LOG_WARN ("TapBridge::ReadCallback(): Packet dropped");
+      // the packet is built and traced in the simulator thread
+      Simulator::ScheduleWithContext (m_nodeId, Seconds (0.0), MakeEvent (&TapBridge::DropPending, this, buf, len));
+      return;
+    }
+
+  if (!m_forwardPending.exchange (true))
+    {
+      NS_LOG_INFO ("TapBridge::ReadCallback(): Scheduling handler");
+      Simulator::ScheduleWithContext (m_nodeId, Seconds (0.0), MakeEvent (&TapBridge::ForwardPending, this));
+    }
+}
+
+void
+TapBridge::ForwardPending (void)
+{
+  NS_LOG_FUNCTION (this);
+
+  // Clear the flag before draining, so that a buffer pushed after the last
+  // Pop below schedules a new event
+  m_forwardPending = false;
+
+  std::pair<uint8_t *, ssize_t> next;
+  while (m_pendingQueue.Pop (next))
+    {
+      ForwardToBridgedDevice (next.first, next.second);
+    }
+}
+
+void
+TapBridge::DropPending (uint8_t *buf, ssize_t len)
+{
+  NS_LOG_FUNCTION (this << buf << len);
+
+  Ptr<Packet> packet = Create<Packet> (reinterpret_cast<const uint8_t *> (buf), len);
+  std::free (buf);
+  m_rxQueueDropTrace (packet);
 }
 
 void
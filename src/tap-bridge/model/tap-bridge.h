@@ -32,6 +32,9 @@
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
 #include "ns3/unix-fd-reader.h"
+#include "ns3/spsc-ring.h"
+#include <atomic>
+#include <utility>
 
 namespace ns3 {
 
@@ -274,6 +277,21 @@ private:
    */
   void ReadCallback (uint8_t *buf, ssize_t len);
 
+  /**
+   * Forward all the packets queued by the read thread to the bridged
+   * ns-3 device
+   */
+  void ForwardPending (void);
+
+  /**
+   * Fire the RxQueueDrop trace for a packet which did not fit in the read
+   * queue
+   *
+   * \param buf the packet buffer, freed by this method
+   * \param len the length of the buffer
+   */
+  void DropPending (uint8_t *buf, ssize_t len);
+
   /**
    * Forward a packet received from the tap device to the bridged ns-3 
    * device
@@ -443,6 +461,23 @@ private:
    */
   uint32_t m_nodeId;
 
+  /**
+   * Buffers read from the tap device and not yet forwarded.  The read
+   * thread is the only producer and the simulator thread the only consumer.
+   */
+  SpscRing< std::pair<uint8_t *, ssize_t> > m_pendingQueue;
+
+  /**
+   * Maximum number of buffers in m_pendingQueue (see the RxQueueSize
+   * attribute).
+   */
+  uint32_t m_maxPendingReads;
+
+  /**
+   * Whether a ForwardPending event is already scheduled.
+   */
+  std::atomic<bool> m_forwardPending;
+
   /**
    * Flag indicating whether or not the link is up.  In this case,
    * whether or not ns-3 is connected to the underlying TAP device
@@ -461,6 +496,13 @@ private:
    * Callbacks to fire if the link changes state (up or down).
    */
   TracedCallback<> m_linkChangeCallbacks;
+
+  /**
+   * The trace source fired for the packets read from the tap device which
+   * are dropped because the read queue is full (see the RxQueueSize
+   * attribute).  It is fired in the simulator thread.
+   */
+  TracedCallback<Ptr<const Packet> > m_rxQueueDropTrace;
 };
 
 } // namespace ns3
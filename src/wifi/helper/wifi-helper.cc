@@ -36,6 +36,7 @@
 #include "ns3/vht-configuration.h"
 #include "ns3/he-configuration.h"
 #include "ns3/obss-pd-algorithm.h"
+#include "ns3/multi-link-scheduler.h"
 #include "wifi-helper.h"
 
 namespace ns3 {
@@ -628,6 +629,28 @@ WifiPhyHelper::EnablePcapInternal (std::string prefix, Ptr<NetDevice> nd, bool p
 
   phy->TraceConnectWithoutContext ("MonitorSnifferTx", MakeBoundCallback (&WifiPhyHelper::PcapSniffTxEvent, file));
   phy->TraceConnectWithoutContext ("MonitorSnifferRx", MakeBoundCallback (&WifiPhyHelper::PcapSniffRxEvent, file));
+
+  //The PHYs of the other links of a multi-link device are traced in files
+  //whose name has the ID of the link appended to the name of the file of
+  //the first link
+  for (uint8_t linkId = 1; linkId < device->GetNLinks (); linkId++)
+    {
+      std::string linkFilename = filename;
+      std::size_t pos = linkFilename.rfind (".pcap");
+      std::string suffix = "-link" + std::to_string (linkId);
+      if (pos != std::string::npos && pos + 5 == linkFilename.size ())
+        {
+          linkFilename.insert (pos, suffix);
+        }
+      else
+        {
+          linkFilename += suffix;
+        }
+      Ptr<PcapFileWrapper> linkFile = pcapHelper.CreateFile (linkFilename, std::ios::out, m_pcapDlt);
+      Ptr<WifiPhy> linkPhy = device->GetPhy (linkId);
+      linkPhy->TraceConnectWithoutContext ("MonitorSnifferTx", MakeBoundCallback (&WifiPhyHelper::PcapSniffTxEvent, linkFile));
+      linkPhy->TraceConnectWithoutContext ("MonitorSnifferRx", MakeBoundCallback (&WifiPhyHelper::PcapSniffRxEvent, linkFile));
+    }
 }
 
 void
@@ -781,12 +804,32 @@ WifiHelper::Install (const WifiPhyHelper &phyHelper,
                      NodeContainer::Iterator first,
                      NodeContainer::Iterator last) const
 {
+  return DoInstall ({&phyHelper}, {m_standard}, macHelper, first, last);
+}
+
+NetDeviceContainer
+WifiHelper::Install (const std::vector<const WifiPhyHelper*> &phys,
+                     const std::vector<WifiStandard> &standards,
+                     const WifiMacHelper &mac, NodeContainer c) const
+{
+  return DoInstall (phys, standards, mac, c.Begin (), c.End ());
+}
+
+NetDeviceContainer
+WifiHelper::DoInstall (const std::vector<const WifiPhyHelper*> &phys,
+                       const std::vector<WifiStandard> &standards,
+                       const WifiMacHelper &macHelper,
+                       NodeContainer::Iterator first,
+                       NodeContainer::Iterator last) const
+{
+  NS_ABORT_MSG_IF (phys.empty () || phys.size () != standards.size (),
+                   "A PHY helper and a standard are needed for each link");
   NetDeviceContainer devices;
   for (NodeContainer::Iterator i = first; i != last; ++i)
     {
       Ptr<Node> node = *i;
       Ptr<WifiNetDevice> device = CreateObject<WifiNetDevice> ();
-      auto it = wifiStandards.find (m_standard);
+      auto it = wifiStandards.find (standards.front ());
       if (it == wifiStandards.end ())
         {
           NS_FATAL_ERROR ("Selected standard is not defined!");
@@ -808,12 +851,22 @@ WifiHelper::Install (const WifiPhyHelper &phyHelper,
           device->SetHeConfiguration (heConfiguration);
         }
       Ptr<WifiRemoteStationManager> manager = m_stationManager.Create<WifiRemoteStationManager> ();
-      Ptr<WifiPhy> phy = phyHelper.Create (node, device);
+      Ptr<WifiPhy> phy = phys.front ()->Create (node, device);
       phy->ConfigureStandardAndBand (it->second.phyStandard, it->second.phyBand);
       device->SetPhy (phy);
-      Ptr<WifiMac> mac = macHelper.Create (device, m_standard);
+      Ptr<WifiMac> mac = macHelper.Create (device, standards.front ());
       device->SetMac (mac);
       device->SetRemoteStationManager (manager);
+      for (std::size_t linkId = 1; linkId < phys.size (); linkId++)
+        {
+          auto linkIt = wifiStandards.find (standards[linkId]);
+          NS_ABORT_MSG_IF (linkIt == wifiStandards.end (), "Selected standard is not defined!");
+          Ptr<WifiRemoteStationManager> linkManager = m_stationManager.Create<WifiRemoteStationManager> ();
+          Ptr<WifiPhy> linkPhy = phys[linkId]->Create (node, device);
+          linkPhy->ConfigureStandardAndBand (linkIt->second.phyStandard, linkIt->second.phyBand);
+          Ptr<WifiMac> linkMac = macHelper.Create (device, standards[linkId]);
+          device->AddLink (linkPhy, linkMac, linkManager);
+        }
       node->AddDevice (device);
       if ((it->second.phyStandard >= WIFI_PHY_STANDARD_80211ax) && (m_obssPdAlgorithm.IsTypeIdSet ()))
         {
@@ -830,6 +883,7 @@ WifiHelper::Install (const WifiPhyHelper &phyHelper,
           Ptr<NetDeviceQueueInterface> ndqi;
           BooleanValue qosSupported;
           Ptr<WifiMacQueue> wmq;
+          Ptr<MultiLinkScheduler> mlScheduler = device->GetMultiLinkScheduler ();
 
           rmac->GetAttributeFailSafe ("QosSupported", qosSupported);
           if (qosSupported.Get ())
@@ -838,8 +892,16 @@ WifiHelper::Install (const WifiPhyHelper &phyHelper,
                                                                           UintegerValue (4));
               for (auto& ac : {AC_BE, AC_BK, AC_VI, AC_VO})
                 {
-                  Ptr<QosTxop> qosTxop = rmac->GetQosTxop (ac);
-                  wmq = qosTxop->GetWifiMacQueue ();
+                  if (mlScheduler != 0)
+                    {
+                      // the packets of a multi-link device wait in the MLD queues
+                      wmq = mlScheduler->GetQueue (ac);
+                    }
+                  else
+                    {
+                      Ptr<QosTxop> qosTxop = rmac->GetQosTxop (ac);
+                      wmq = qosTxop->GetWifiMacQueue ();
+                    }
                   ndqi->GetTxQueue (static_cast<std::size_t> (ac))->ConnectQueueTraces (wmq);
                 }
               ndqi->SetSelectQueueCallback (m_selectQueueCallback);
@@ -988,43 +1050,47 @@ WifiHelper::AssignStreams (NetDeviceContainer c, int64_t stream)
       Ptr<WifiNetDevice> wifi = DynamicCast<WifiNetDevice> (netDevice);
       if (wifi)
         {
-          //Handle any random numbers in the PHY objects.
-          currentStream += wifi->GetPhy ()->AssignStreams (currentStream);
+          //Handle the random numbers of each link in turn
+          for (uint8_t linkId = 0; linkId < wifi->GetNLinks (); linkId++)
+            {
+              //Handle any random numbers in the PHY objects.
+              currentStream += wifi->GetPhy (linkId)->AssignStreams (currentStream);
 
-          //Handle any random numbers in the station managers.
-          currentStream += wifi->GetRemoteStationManager ()->AssignStreams (currentStream);
+              //Handle any random numbers in the station managers.
+              currentStream += wifi->GetRemoteStationManager (linkId)->AssignStreams (currentStream);
 
-          //Handle any random numbers in the MAC objects.
-          Ptr<WifiMac> mac = wifi->GetMac ();
-          Ptr<RegularWifiMac> rmac = DynamicCast<RegularWifiMac> (mac);
-          if (rmac)
-            {
-              PointerValue ptr;
-              rmac->GetAttribute ("Txop", ptr);
-              Ptr<Txop> txop = ptr.Get<Txop> ();
-              currentStream += txop->AssignStreams (currentStream);
-
-              rmac->GetAttribute ("VO_Txop", ptr);
-              Ptr<QosTxop> vo_txop = ptr.Get<QosTxop> ();
-              currentStream += vo_txop->AssignStreams (currentStream);
-
-              rmac->GetAttribute ("VI_Txop", ptr);
-              Ptr<QosTxop> vi_txop = ptr.Get<QosTxop> ();
-              currentStream += vi_txop->AssignStreams (currentStream);
-
-              rmac->GetAttribute ("BE_Txop", ptr);
-              Ptr<QosTxop> be_txop = ptr.Get<QosTxop> ();
-              currentStream += be_txop->AssignStreams (currentStream);
-
-              rmac->GetAttribute ("BK_Txop", ptr);
-              Ptr<QosTxop> bk_txop = ptr.Get<QosTxop> ();
-              currentStream += bk_txop->AssignStreams (currentStream);
-
-              //if an AP, handle any beacon jitter
-              Ptr<ApWifiMac> apmac = DynamicCast<ApWifiMac> (rmac);
-              if (apmac)
+              //Handle any random numbers in the MAC objects.
+              Ptr<WifiMac> mac = wifi->GetMac (linkId);
+              Ptr<RegularWifiMac> rmac = DynamicCast<RegularWifiMac> (mac);
+              if (rmac)
                 {
-                  currentStream += apmac->AssignStreams (currentStream);
+                  PointerValue ptr;
+                  rmac->GetAttribute ("Txop", ptr);
+                  Ptr<Txop> txop = ptr.Get<Txop> ();
+                  currentStream += txop->AssignStreams (currentStream);
+
+                  rmac->GetAttribute ("VO_Txop", ptr);
+                  Ptr<QosTxop> vo_txop = ptr.Get<QosTxop> ();
+                  currentStream += vo_txop->AssignStreams (currentStream);
+
+                  rmac->GetAttribute ("VI_Txop", ptr);
+                  Ptr<QosTxop> vi_txop = ptr.Get<QosTxop> ();
+                  currentStream += vi_txop->AssignStreams (currentStream);
+
+                  rmac->GetAttribute ("BE_Txop", ptr);
+                  Ptr<QosTxop> be_txop = ptr.Get<QosTxop> ();
+                  currentStream += be_txop->AssignStreams (currentStream);
+
+                  rmac->GetAttribute ("BK_Txop", ptr);
+                  Ptr<QosTxop> bk_txop = ptr.Get<QosTxop> ();
+                  currentStream += bk_txop->AssignStreams (currentStream);
+
+                  //if an AP, handle any beacon jitter
+                  Ptr<ApWifiMac> apmac = DynamicCast<ApWifiMac> (rmac);
+                  if (apmac)
+                    {
+                      currentStream += apmac->AssignStreams (currentStream);
+                    }
                 }
             }
         }
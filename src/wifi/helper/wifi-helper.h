@@ -29,6 +29,7 @@
 #include "ns3/deprecated.h"
 #include "wifi-mac-helper.h"
 #include <functional>
+#include <vector>
 
 namespace ns3 {
 
@@ -448,6 +449,23 @@ public:
    */
   virtual NetDeviceContainer Install (const WifiPhyHelper &phy,
                                       const WifiMacHelper &mac, std::string nodeName) const;
+  /**
+   * Install a multi-link device (MLD) on each node, with as many links as
+   * PHY helpers: the PHY of each link is created by the PHY helper at the same
+   * index and configured for the standard at the same index (the standard
+   * set by SetStandard is not used), while the MAC affiliated with each link
+   * is created by the given MAC helper and must support QoS. The HT, VHT and
+   * HE configurations of the devices follow the standard of the first link.
+   *
+   * \param phys the PHY helper of each link
+   * \param standards the standard of each link
+   * \param mac the MAC helper to create MAC objects
+   * \param c the set of nodes on which a wifi device must be created
+   * \returns a device container which contains all the devices created by this method.
+   */
+  NetDeviceContainer Install (const std::vector<const WifiPhyHelper*> &phys,
+                              const std::vector<WifiStandard> &standards,
+                              const WifiMacHelper &mac, NodeContainer c) const;
   /**
    * \param standard the standard to configure during installation
    *
@@ -497,6 +515,22 @@ public:
 
 
 protected:
+  /**
+   * Install a device with a link per PHY helper on each node.
+   *
+   * \param phys the PHY helper of each link
+   * \param standards the standard of each link
+   * \param mac the MAC helper to create MAC objects
+   * \param first lower bound on the set of nodes on which a wifi device must be created
+   * \param last upper bound on the set of nodes on which a wifi device must be created
+   * \returns a device container which contains all the devices created by this method.
+   */
+  NetDeviceContainer DoInstall (const std::vector<const WifiPhyHelper*> &phys,
+                                const std::vector<WifiStandard> &standards,
+                                const WifiMacHelper &mac,
+                                NodeContainer::Iterator first,
+                                NodeContainer::Iterator last) const;
+
   ObjectFactory m_stationManager;            ///< station manager
   ObjectFactory m_ackPolicySelector[4];      ///< ack policy selector for all ACs
   WifiStandard m_standard;                   ///< wifi standard
@@ -352,7 +352,7 @@ void
 ApWifiMac::Enqueue (Ptr<Packet> packet, Mac48Address to, Mac48Address from)
 {
   NS_LOG_FUNCTION (this << packet << to << from);
-  if (to.IsGroup () || m_stationManager->IsAssociated (to))
+  if (CanForwardPacketsTo (to))
     {
       ForwardDown (packet, from, to);
     }
@@ -379,6 +379,12 @@ ApWifiMac::SupportsSendFrom (void) const
   return true;
 }
 
+bool
+ApWifiMac::CanForwardPacketsTo (Mac48Address to) const
+{
+  return (to.IsGroup () || m_stationManager->IsAssociated (to));
+}
+
 SupportedRates
 ApWifiMac::GetSupportedRates (void) const
 {
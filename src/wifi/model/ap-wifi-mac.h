@@ -62,6 +62,7 @@ public:
   void Enqueue (Ptr<Packet> packet, Mac48Address to) override;
   void Enqueue (Ptr<Packet> packet, Mac48Address to, Mac48Address from) override;
   bool SupportsSendFrom (void) const override;
+  bool CanForwardPacketsTo (Mac48Address to) const override;
   void SetAddress (Mac48Address address) override;
   Ptr<WifiMacQueue> GetTxopQueue (AcIndex ac) const override;
 
@@ -330,13 +330,12 @@ BlockAckManager::GetBar (bool remove, uint8_t tid, Mac48Address address)
             }
           // update BAR if the starting sequence number changed
           CtrlBAckRequestHeader reqHdr;
-          nextBar->bar->GetPacket ()->PeekHeader (reqHdr);
+          nextBar->bar->PeekFrameBody (reqHdr);
           if (reqHdr.GetStartingSequence () != it->second.first.GetStartingSequence ())
             {
               reqHdr.SetStartingSequence (it->second.first.GetStartingSequence ());
-              Ptr<Packet> packet = Create<Packet> ();
-              packet->AddHeader (reqHdr);
-              nextBar->bar = Create<const WifiMacQueueItem> (packet, nextBar->bar->GetHeader ());
+              nextBar->bar = Create<const WifiMacQueueItem> (Create<Packet> (), reqHdr,
+                                                             nextBar->bar->GetHeader ());
             }
         }
 
@@ -623,8 +622,6 @@ BlockAckManager::NotifyDiscardedMpdu (Ptr<const WifiMacQueueItem> mpdu)
 
   // schedule a BlockAckRequest
   NS_LOG_DEBUG ("Schedule a Block Ack Request for agreement (" << recipient << ", " << +tid << ")");
-  Ptr<Packet> bar = Create<Packet> ();
-  bar->AddHeader (GetBlockAckReqHeader (recipient, tid));
 
   WifiMacHeader hdr;
   hdr.SetType (WIFI_MAC_CTL_BACKREQ);
@@ -636,7 +633,8 @@ BlockAckManager::NotifyDiscardedMpdu (Ptr<const WifiMacQueueItem> mpdu)
   hdr.SetNoRetry ();
   hdr.SetNoMoreFragments ();
 
-  ScheduleBar (Create<const WifiMacQueueItem> (bar, hdr));
+  ScheduleBar (Create<const WifiMacQueueItem> (Create<Packet> (),
+                                               GetBlockAckReqHeader (recipient, tid), hdr));
 }
 
 CtrlBAckRequestHeader
@@ -663,14 +661,14 @@ BlockAckManager::ScheduleBar (Ptr<const WifiMacQueueItem> bar, bool skipIfNoData
   if (bar->GetHeader ().IsBlockAckReq ())
     {
       CtrlBAckRequestHeader reqHdr;
-      bar->GetPacket ()->PeekHeader (reqHdr);
+      bar->PeekFrameBody (reqHdr);
       tid = reqHdr.GetTidInfo ();
     }
 #ifdef NS3_BUILD_PROFILE_DEBUG
   else
     {
       CtrlTriggerHeader triggerHdr;
-      bar->GetPacket ()->PeekHeader (triggerHdr);
+      bar->PeekFrameBody (triggerHdr);
       NS_ASSERT (triggerHdr.IsMuBar ());
     }
 #endif
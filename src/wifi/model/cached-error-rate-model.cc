@@ -0,0 +1,400 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+#include "ns3/abort.h"
+#include "cached-error-rate-model.h"
+#include "nist-error-rate-model.h"
+
+namespace ns3 {
+
+static const double CACHED_MIN_SNR_DB = -10;        //!< SNR of the first grid point (dB)
+static const double CACHED_SNR_STEP_DB = 0.05;      //!< SNR step of the grid (dB)
+static const std::size_t CACHED_N_SNRS = 1201;      //!< Number of SNR grid points, up to 50 dB
+static const std::size_t CACHED_MIN_SIZE_LOG = 4;   //!< log2 of the size of the first grid point (bits)
+static const std::size_t CACHED_N_SIZES = 17;       //!< Number of size grid points, up to 2^20 bits
+static const uint8_t CACHED_NO_RU = 0xff;           //!< RU type of the keys of SU and PHY header chunks
+
+NS_LOG_COMPONENT_DEFINE ("CachedErrorRateModel");
+
+NS_OBJECT_ENSURE_REGISTERED (CachedErrorRateModel);
+
+std::map<std::string, std::weak_ptr<CachedErrorRateModel::Tables> > CachedErrorRateModel::m_allTables;
+
+TypeId
+CachedErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::CachedErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<CachedErrorRateModel> ()
+    .AddAttribute ("ErrorRateModel",
+                   "The error rate model whose chunk success rates are tabulated. "
+                   "The cached models wrapping models of the same type and attribute "
+                   "values share their tables.",
+                   PointerValue (CreateObject<NistErrorRateModel> ()),
+                   MakePointerAccessor (&CachedErrorRateModel::SetErrorRateModel,
+                                        &CachedErrorRateModel::GetErrorRateModel),
+                   MakePointerChecker<ErrorRateModel> ())
+    .AddAttribute ("TableFile",
+                   "The name of a file saved by SaveTables, whose tables are loaded "
+                   "at the first chunk. No file is loaded if empty or if the file "
+                   "does not exist.",
+                   StringValue (""),
+                   MakeStringAccessor (&CachedErrorRateModel::m_tableFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+CachedErrorRateModel::CachedErrorRateModel ()
+  : m_lastTable (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+CachedErrorRateModel::~CachedErrorRateModel ()
+{
+  NS_LOG_FUNCTION (this);
+  m_model = 0;
+}
+
+void
+CachedErrorRateModel::SetErrorRateModel (Ptr<ErrorRateModel> model)
+{
+  NS_LOG_FUNCTION (this << model);
+  m_model = model;
+  m_tables.reset ();
+  m_lastTable = 0;
+}
+
+Ptr<ErrorRateModel>
+CachedErrorRateModel::GetErrorRateModel (void) const
+{
+  return m_model;
+}
+
+bool
+CachedErrorRateModel::IsAwgn (void) const
+{
+  return m_model->IsAwgn ();
+}
+
+int64_t
+CachedErrorRateModel::AssignStreams (int64_t stream)
+{
+  return m_model->AssignStreams (stream);
+}
+
+CachedErrorRateModel::TableKey
+CachedErrorRateModel::GetKey (WifiMode mode, const WifiTxVector& txVector, uint8_t numRxAntennas,
+                              WifiPpduField field, uint16_t staId)
+{
+  if ((txVector.IsMu () && (staId == SU_STA_ID)) || (mode != txVector.GetMode (staId)))
+    {
+      // PHY header
+      return TableKey (mode.GetUid (), txVector.GetChannelWidth (), 0, 0, CACHED_NO_RU, numRxAntennas,
+                       field);
+    }
+  return TableKey (mode.GetUid (), txVector.GetChannelWidth (), txVector.GetGuardInterval (),
+                   txVector.GetNss (staId),
+                   txVector.IsMu () ? txVector.GetRu (staId).GetRuType () : CACHED_NO_RU,
+                   numRxAntennas, field);
+}
+
+std::string
+CachedErrorRateModel::GetModelKey (Ptr<const Object> object)
+{
+  if (object == 0)
+    {
+      return "0";
+    }
+  TypeId tid = object->GetInstanceTypeId ();
+  std::ostringstream oss;
+  oss << tid.GetName () << "{";
+  while (true)
+    {
+      for (std::size_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          if (!(info.flags & TypeId::ATTR_GET) || !info.accessor->HasGetter ())
+            {
+              continue;
+            }
+          Ptr<AttributeValue> value = info.checker->Create ();
+          info.accessor->Get (PeekPointer (object), *value);
+          Ptr<PointerValue> pointer = DynamicCast<PointerValue> (value);
+          // an address would not tell the attributes of the object
+          oss << info.name << "="
+              << (pointer != 0 ? GetModelKey (pointer->GetObject ()) : value->SerializeToString (info.checker))
+              << ";";
+        }
+      if (tid == tid.GetParent ())
+        {
+          break;
+        }
+      tid = tid.GetParent ();
+    }
+  oss << "}";
+  return oss.str ();
+}
+
+CachedErrorRateModel::Tables &
+CachedErrorRateModel::GetTables (void) const
+{
+  NS_ASSERT_MSG (m_model != 0, "No error rate model to cache");
+  if (!m_tables)
+    {
+      std::string key = GetModelKey (m_model);
+      m_tables = m_allTables[key].lock ();
+      if (!m_tables)
+        {
+          NS_LOG_DEBUG ("New tables for " << key);
+          m_tables = std::make_shared<Tables> ();
+          m_allTables[key] = m_tables;
+          // forget the tables freed with their last cached model
+          for (auto it = m_allTables.begin (); it != m_allTables.end (); )
+            {
+              it = it->second.expired () ? m_allTables.erase (it) : std::next (it);
+            }
+        }
+    }
+  if (!m_tableFile.empty () && m_tables->loadedFiles.insert (m_tableFile).second)
+    {
+      LoadTables (*m_tables, m_tableFile);
+    }
+  return *m_tables;
+}
+
+CachedErrorRateModel::Table &
+CachedErrorRateModel::GetTable (WifiMode mode, const WifiTxVector& txVector, uint8_t numRxAntennas,
+                                WifiPpduField field, uint16_t staId) const
+{
+  TableKey key = GetKey (mode, txVector, numRxAntennas, field, staId);
+  if (m_lastTable != 0 && key == m_lastKey)
+    {
+      return *m_lastTable;
+    }
+  Tables &tables = GetTables ();
+  auto it = tables.tables.find (key);
+  if (it == tables.tables.end ())
+    {
+      NS_LOG_DEBUG ("New table for " << mode << " width=" << std::get<1> (key)
+                    << " gi=" << std::get<2> (key) << " nss=" << +std::get<3> (key)
+                    << " ru=" << +std::get<4> (key) << " antennas=" << +numRxAntennas
+                    << " field=" << field);
+      Table table {mode, txVector, numRxAntennas, field, staId, {}};
+      auto loaded = tables.loaded.find (GetFileKey (mode, key));
+      if (loaded != tables.loaded.end ())
+        {
+          table.values = std::move (loaded->second);
+          tables.loaded.erase (loaded);
+        }
+      else
+        {
+          table.values.assign (CACHED_N_SNRS * CACHED_N_SIZES, std::numeric_limits<double>::quiet_NaN ());
+        }
+      it = tables.tables.insert ({key, table}).first;
+    }
+  m_lastKey = key;
+  m_lastTable = &it->second;
+  return it->second;
+}
+
+double
+CachedErrorRateModel::GetValue (Table &table, std::size_t snrIndex, std::size_t sizeIndex) const
+{
+  double *row = &table.values[snrIndex * CACHED_N_SIZES];
+  if (std::isnan (row[0]))
+    {
+      double snr = std::pow (10.0, (CACHED_MIN_SNR_DB + snrIndex * CACHED_SNR_STEP_DB) / 10.0);
+      for (std::size_t k = 0; k < CACHED_N_SIZES; k++)
+        {
+          double csr = m_model->GetChunkSuccessRate (table.mode, table.txVector, snr,
+                                                     uint64_t (1) << (CACHED_MIN_SIZE_LOG + k),
+                                                     table.numRxAntennas, table.field, table.staId);
+          if (csr >= 1)
+            {
+              row[k] = -std::numeric_limits<double>::infinity ();
+            }
+          else if (csr <= 0)
+            {
+              row[k] = std::numeric_limits<double>::infinity ();
+            }
+          else
+            {
+              row[k] = std::log (-std::log (csr));
+            }
+        }
+    }
+  return row[sizeIndex];
+}
+
+double
+CachedErrorRateModel::DoGetChunkSuccessRate (WifiMode mode, const WifiTxVector& txVector, double snr, uint64_t nbits,
+                                             uint8_t numRxAntennas, WifiPpduField field, uint16_t staId) const
+{
+  NS_LOG_FUNCTION (this << mode << snr << nbits << +numRxAntennas << field << staId);
+  double x = (10 * std::log10 (snr) - CACHED_MIN_SNR_DB) / CACHED_SNR_STEP_DB;
+  double y = std::log2 (static_cast<double> (nbits)) - CACHED_MIN_SIZE_LOG;
+  if (!(x >= 0) || x >= CACHED_N_SNRS - 1 || !(y >= 0) || y >= CACHED_N_SIZES - 1)
+    {
+      NS_LOG_LOGIC ("Outside of the tables");
+      return m_model->GetChunkSuccessRate (mode, txVector, snr, nbits, numRxAntennas, field, staId);
+    }
+  std::size_t i = static_cast<std::size_t> (x);
+  std::size_t j = static_cast<std::size_t> (y);
+  Table &table = GetTable (mode, txVector, numRxAntennas, field, staId);
+  double h00 = GetValue (table, i, j);
+  double h01 = GetValue (table, i, j + 1);
+  double h10 = GetValue (table, i + 1, j);
+  double h11 = GetValue (table, i + 1, j + 1);
+  if (std::isfinite (h00) && std::isfinite (h01) && std::isfinite (h10) && std::isfinite (h11))
+    {
+      double fx = x - i;
+      double fy = y - j;
+      double h = (1 - fx) * ((1 - fy) * h00 + fy * h01) + fx * ((1 - fy) * h10 + fy * h11);
+      return std::exp (-std::exp (h));
+    }
+  if (h00 < 0 && std::isinf (h00) && h01 == h00 && h10 == h00 && h11 == h00)
+    {
+      return 1;
+    }
+  if (h00 > 0 && std::isinf (h00) && h01 == h00 && h10 == h00 && h11 == h00)
+    {
+      return 0;
+    }
+  NS_LOG_LOGIC ("Success rates of the grid points not all in ]0, 1[");
+  return m_model->GetChunkSuccessRate (mode, txVector, snr, nbits, numRxAntennas, field, staId);
+}
+
+CachedErrorRateModel::FileTableKey
+CachedErrorRateModel::GetFileKey (WifiMode mode, const TableKey &key)
+{
+  return FileTableKey (mode.GetUniqueName (), std::get<1> (key), std::get<2> (key),
+                       std::get<3> (key), std::get<4> (key), std::get<5> (key), std::get<6> (key));
+}
+
+void
+CachedErrorRateModel::SaveTables (std::string fileName) const
+{
+  NS_LOG_FUNCTION (this << fileName);
+  std::ofstream file (fileName);
+  NS_ABORT_MSG_IF (!file.is_open (), "Cannot open " << fileName);
+  file << "# mode channel-width guard-interval nss ru-type rx-antennas ppdu-field snr-index"
+       << " ln(-ln(success rate)) for 2^" << CACHED_MIN_SIZE_LOG << " to 2^"
+       << CACHED_MIN_SIZE_LOG + CACHED_N_SIZES - 1 << " bits" << std::endl;
+  file << std::setprecision (17);
+  auto writeRows = [&file] (const FileTableKey &key, const std::vector<double> &values)
+    {
+      for (std::size_t i = 0; i < CACHED_N_SNRS; i++)
+        {
+          if (std::isnan (values[i * CACHED_N_SIZES]))
+            {
+              continue;
+            }
+          file << std::get<0> (key) << " " << std::get<1> (key) << " " << std::get<2> (key)
+               << " " << +std::get<3> (key) << " " << +std::get<4> (key) << " " << +std::get<5> (key)
+               << " " << +std::get<6> (key) << " " << i;
+          for (std::size_t k = 0; k < CACHED_N_SIZES; k++)
+            {
+              file << " " << values[i * CACHED_N_SIZES + k];
+            }
+          file << std::endl;
+        }
+    };
+  Tables &tables = GetTables ();
+  for (const auto &table : tables.tables)
+    {
+      writeRows (GetFileKey (table.second.mode, table.first), table.second.values);
+    }
+  for (const auto &loaded : tables.loaded)
+    {
+      writeRows (loaded.first, loaded.second);
+    }
+}
+
+void
+CachedErrorRateModel::LoadTables (Tables &tables, std::string fileName)
+{
+  NS_LOG_FUNCTION (fileName);
+  std::ifstream file (fileName);
+  if (!file.is_open ())
+    {
+      NS_LOG_WARN ("Cannot open " << fileName << ": the tables are computed");
+      return;
+    }
+  std::string line;
+  while (std::getline (file, line))
+    {
+      if (line.empty () || line[0] == '#')
+        {
+          continue;
+        }
+      std::istringstream iss (line);
+      std::string name;
+      uint16_t channelWidth;
+      uint16_t guardInterval;
+      uint16_t nss;
+      uint16_t ruType;
+      uint16_t numRxAntennas;
+      uint16_t field;
+      std::size_t snrIndex;
+      iss >> name >> channelWidth >> guardInterval >> nss >> ruType >> numRxAntennas >> field >> snrIndex;
+      NS_ABORT_MSG_IF (iss.fail () || snrIndex >= CACHED_N_SNRS, "Bad line in " << fileName << ": " << line);
+      FileTableKey key (name, channelWidth, guardInterval, nss, ruType, numRxAntennas, field);
+      std::vector<double> *values;
+      auto table = std::find_if (tables.tables.begin (), tables.tables.end (),
+                                 [&key] (const std::pair<const TableKey, Table> &t)
+                                 {
+                                   return GetFileKey (t.second.mode, t.first) == key;
+                                 });
+      if (table != tables.tables.end ())
+        {
+          values = &table->second.values;
+        }
+      else
+        {
+          values = &tables.loaded[key];
+          if (values->empty ())
+            {
+              values->assign (CACHED_N_SNRS * CACHED_N_SIZES, std::numeric_limits<double>::quiet_NaN ());
+            }
+        }
+      for (std::size_t k = 0; k < CACHED_N_SIZES; k++)
+        {
+          std::string token;
+          iss >> token;
+          const char *start = token.c_str ();
+          char *end;
+          double value = std::strtod (start, &end);
+          NS_ABORT_MSG_IF (token.empty () || *end != '\0', "Bad line in " << fileName << ": " << line);
+          (*values)[snrIndex * CACHED_N_SIZES + k] = value;
+        }
+    }
+}
+
+} //namespace ns3
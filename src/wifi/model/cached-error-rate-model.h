@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CACHED_ERROR_RATE_MODEL_H
+#define CACHED_ERROR_RATE_MODEL_H
+
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <vector>
+#include "error-rate-model.h"
+#include "wifi-tx-vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief An error rate model answering from tables of another error rate model
+ *
+ * The chunk success rates of the wrapped model (ErrorRateModel attribute)
+ * are tabulated on a grid of SNRs, from -10 dB to 50 dB by steps of
+ * 0.05 dB, and of chunk sizes, the powers of 2 from 16 to 2^20 bits.  The
+ * other values are interpolated linearly, in SNR (dB) and in log2 of the
+ * size, on ln (-ln (success rate)).  This quantity is linear in log2 of the
+ * size for the models where the success rate is the bit success rate to the
+ * power of the size, such as NistErrorRateModel and YansErrorRateModel: the
+ * interpolation in size is then exact, and the interpolation in SNR is
+ * smooth, since the bit error rate is close to exponential in the SNR (dB).
+ * With these two models, the chunk success rates are within 1e-4 of the
+ * exact ones (see the wifi-error-rate-models test suite).  The wrapped
+ * model is called outside the grid, and between grid points whose success
+ * rates are not all in ]0, 1[ (for instance, where the bit error rate is
+ * too small to be seen on 16 bits).  Chunks of less than 16 bits are
+ * rare, and their success rate is not smooth where the bit error rate of
+ * these models is capped to 1.
+ *
+ * A table is made for each mode, number of RX antennas, PPDU field, and
+ * parameters of the TXVECTOR setting the PHY rate of the chunk (channel
+ * width, guard interval, number of spatial streams and RU type), which are
+ * all the parameters NistErrorRateModel and YansErrorRateModel depend on;
+ * the wrapped model must not depend on other parameters of the TXVECTOR.
+ * The rows of the tables (an SNR grid point, all the sizes) are computed
+ * the first time they are needed.  The tables are shared by the cached
+ * models wrapping models of the same type with the same attribute values,
+ * and freed with the last of them; the wrapped model must not be
+ * configured differently after the first chunk.  The tables can be saved
+ * to a file and loaded from it (TableFile attribute) by the next
+ * simulations.
+ */
+class CachedErrorRateModel : public ErrorRateModel
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  CachedErrorRateModel ();
+  virtual ~CachedErrorRateModel ();
+
+  bool IsAwgn (void) const override;
+  int64_t AssignStreams (int64_t stream) override;
+
+  /**
+   * Save the rows of the tables computed so far.  They can be loaded by
+   * setting the TableFile attribute to the name of the file.
+   *
+   * \param fileName the name of the file
+   */
+  void SaveTables (std::string fileName) const;
+
+private:
+  double DoGetChunkSuccessRate (WifiMode mode, const WifiTxVector& txVector, double snr, uint64_t nbits,
+                                uint8_t numRxAntennas, WifiPpduField field, uint16_t staId) const override;
+
+  /**
+   * The table of a mode, PHY rate parameters, number of RX antennas and
+   * PPDU field
+   */
+  struct Table
+  {
+    WifiMode mode;          //!< Mode of the chunks
+    WifiTxVector txVector;  //!< TXVECTOR of the first chunk using the table
+    uint8_t numRxAntennas;  //!< Number of RX antennas
+    WifiPpduField field;    //!< PPDU field of the chunks
+    uint16_t staId;         //!< Station ID of the first chunk using the table
+    std::vector<double> values; //!< ln (-ln (success rate)), by SNR then size, NaN if not computed
+  };
+
+  /**
+   * Mode UID, channel width, guard interval, number of spatial streams, RU
+   * type, number of RX antennas and PPDU field of a table.  The guard
+   * interval and the number of spatial streams are 0, and the RU type is
+   * NO_RU, for the PHY header, whose PHY rate depends only on the mode and
+   * channel width.
+   */
+  typedef std::tuple<uint32_t, uint16_t, uint16_t, uint8_t, uint8_t, uint8_t, uint8_t> TableKey;
+
+  /// The key of a table in a file: the mode name instead of its UID
+  typedef std::tuple<std::string, uint16_t, uint16_t, uint8_t, uint8_t, uint8_t, uint8_t> FileTableKey;
+
+  /**
+   * The tables of the wrapped models of a type and attribute values
+   */
+  struct Tables
+  {
+    std::map<TableKey, Table> tables;   //!< The tables
+    std::map<FileTableKey, std::vector<double> > loaded; //!< Tables loaded from files, not used yet
+    std::set<std::string> loadedFiles;  //!< The table files loaded
+  };
+
+  /**
+   * Get the table of a chunk, loading the table file first if needed
+   *
+   * \param mode the Wi-Fi mode of the chunk
+   * \param txVector TXVECTOR of the overall transmission
+   * \param numRxAntennas the number of active RX antennas
+   * \param field the PPDU field to which the chunk belongs
+   * \param staId the station ID for MU
+   * \return the table
+   */
+  Table & GetTable (WifiMode mode, const WifiTxVector& txVector, uint8_t numRxAntennas,
+                    WifiPpduField field, uint16_t staId) const;
+
+  /**
+   * Get the tables of the wrapped model, loading the table file if needed
+   *
+   * \return the tables
+   */
+  Tables & GetTables (void) const;
+
+  /**
+   * Set the wrapped model
+   *
+   * \param model the error rate model whose chunk success rates are tabulated
+   */
+  void SetErrorRateModel (Ptr<ErrorRateModel> model);
+
+  /**
+   * Get the wrapped model
+   *
+   * \return the error rate model whose chunk success rates are tabulated
+   */
+  Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+
+  /**
+   * Get a value of a table, computing its row if needed
+   *
+   * \param table the table
+   * \param snrIndex the index of the SNR grid point
+   * \param sizeIndex the log2 of the size
+   * \return ln (-ln (success rate))
+   */
+  double GetValue (Table &table, std::size_t snrIndex, std::size_t sizeIndex) const;
+
+  /**
+   * Load the rows of a table file
+   *
+   * \param tables the tables to add the rows to
+   * \param fileName the name of the file
+   */
+  static void LoadTables (Tables &tables, std::string fileName);
+
+  /**
+   * Get the key of the table of a chunk
+   *
+   * \param mode the Wi-Fi mode of the chunk
+   * \param txVector TXVECTOR of the overall transmission
+   * \param numRxAntennas the number of active RX antennas
+   * \param field the PPDU field to which the chunk belongs
+   * \param staId the station ID for MU
+   * \return the key
+   */
+  static TableKey GetKey (WifiMode mode, const WifiTxVector& txVector, uint8_t numRxAntennas,
+                          WifiPpduField field, uint16_t staId);
+
+  /**
+   * Get the type and the attribute values of an object, and of the objects
+   * its attributes point to, as a string
+   *
+   * \param object the object
+   * \return the key of the tables of the object
+   */
+  static std::string GetModelKey (Ptr<const Object> object);
+
+  /**
+   * Get the key of a table in a file
+   *
+   * \param mode the Wi-Fi mode of the table
+   * \param key the key of the table
+   * \return the key in a file
+   */
+  static FileTableKey GetFileKey (WifiMode mode, const TableKey &key);
+
+  Ptr<ErrorRateModel> m_model;   //!< The wrapped model
+  std::string m_tableFile;       //!< The file to load the tables from
+  mutable std::shared_ptr<Tables> m_tables; //!< The tables of the wrapped model
+  mutable Table *m_lastTable;    //!< The table of the last chunk
+  mutable TableKey m_lastKey;    //!< The key of m_lastTable
+
+  /// The tables in use, by type and attribute values of the wrapped model
+  static std::map<std::string, std::weak_ptr<Tables> > m_allTables;
+};
+
+} //namespace ns3
+
+#endif /* CACHED_ERROR_RATE_MODEL_H */
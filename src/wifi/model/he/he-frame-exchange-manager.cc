@@ -452,7 +452,7 @@ HeFrameExchangeManager::SendPsduMap (void)
            && (mpdu = *m_psduMap.begin ()->second->begin ())->GetHeader ().IsTrigger ())
     {
       CtrlTriggerHeader trigger;
-      mpdu->GetPacket ()->PeekHeader (trigger);
+      mpdu->PeekFrameBody (trigger);
       NS_ASSERT (trigger.IsBsrp ());
       NS_ASSERT (m_apMac != 0);
 
@@ -625,7 +625,6 @@ HeFrameExchangeManager::PrepareMuBar (const WifiTxVector& responseTxVector,
     }
 
   Ptr<Packet> bar = Create<Packet> ();
-  bar->AddHeader (muBar);
   // "If the Trigger frame has one User Info field and the AID12 subfield of the
   // User Info contains the AID of a STA, then the RA field is set to the address
   // of that STA". Otherwise, it is set to the broadcast address (Sec. 9.3.1.23 -
@@ -649,7 +648,7 @@ HeFrameExchangeManager::PrepareMuBar (const WifiTxVector& responseTxVector,
   hdr.SetNoRetry ();
   hdr.SetNoMoreFragments ();
 
-  return Create<WifiMacQueueItem> (bar, hdr);
+  return Create<WifiMacQueueItem> (bar, muBar, hdr);
 }
 
 void
@@ -1093,8 +1092,8 @@ HeFrameExchangeManager::SendMultiStaBlockAck (const WifiTxParameters& txParams)
   hdr.SetDsNotTo ();
 
   Ptr<Packet> packet = Create<Packet> ();
-  packet->AddHeader (blockAck);
-  Ptr<WifiPsdu> psdu = GetWifiPsdu (Create<WifiMacQueueItem> (packet, hdr),
+  packet->AddPacketTag (m_muSnrTag);
+  Ptr<WifiPsdu> psdu = GetWifiPsdu (Create<WifiMacQueueItem> (packet, blockAck, hdr),
                                     acknowledgment->multiStaBaTxVector);
 
   // The Duration/ID field in a BlockAck frame transmitted in response to a frame
@@ -1109,8 +1108,6 @@ HeFrameExchangeManager::SendMultiStaBlockAck (const WifiTxParameters& txParams)
   params.m_acknowledgment = std::unique_ptr<WifiAcknowledgment> (new WifiNoAck);
   psdu->SetDuration (GetPsduDurationId (txDuration, params));
 
-  psdu->GetPayload (0)->AddPacketTag (m_muSnrTag);
-
   ForwardPsduDown (psdu, acknowledgment->multiStaBaTxVector);
 
   // continue with the TXOP if time remains
@@ -1322,7 +1319,7 @@ HeFrameExchangeManager::ReceiveMpdu (Ptr<WifiMacQueueItem> mpdu, RxSignalInfo rx
           NS_LOG_DEBUG ("Received a BlockAckReq in a TB PPDU from " << sender);
 
           CtrlBAckRequestHeader blockAckReq;
-          mpdu->GetPacket ()->PeekHeader (blockAckReq);
+          mpdu->PeekFrameBody (blockAckReq);
           NS_ABORT_MSG_IF (blockAckReq.IsMultiTid (), "Multi-TID BlockAckReq not supported");
           uint8_t tid = blockAckReq.GetTidInfo ();
           auto agreementIt = m_agreements.find ({sender, tid});
@@ -1409,7 +1406,7 @@ HeFrameExchangeManager::ReceiveMpdu (Ptr<WifiMacQueueItem> mpdu, RxSignalInfo rx
           NS_ASSERT (it != m_psduMap.end ());
           NS_ASSERT (it->second->GetAddr1 () == acknowledgment->stationsReplyingWithNormalAck.begin ()->first);
           SnrTag tag;
-          mpdu->GetPacket ()->PeekPacketTag (tag);
+          mpdu->PeekPacketTag (tag);
           ReceivedNormalAck (*it->second->begin (), m_txParams.m_txVector, txVector, rxSignalInfo, tag.Get ());
         }
       else if (hdr.IsBlockAck () && m_txTimer.IsRunning ()
@@ -1419,11 +1416,11 @@ HeFrameExchangeManager::ReceiveMpdu (Ptr<WifiMacQueueItem> mpdu, RxSignalInfo rx
           NS_LOG_DEBUG ("Received BlockAck in TB PPDU from=" << sender);
 
           SnrTag tag;
-          mpdu->GetPacket ()->PeekPacketTag (tag);
+          mpdu->PeekPacketTag (tag);
 
           // notify the Block Ack Manager
           CtrlBAckResponseHeader blockAck;
-          mpdu->GetPacket ()->PeekHeader (blockAck);
+          mpdu->PeekFrameBody (blockAck);
           uint8_t tid = blockAck.GetTidInfo ();
           std::pair<uint16_t,uint16_t> ret = GetBaManager (tid)->NotifyGotBlockAck (blockAck, hdr.GetAddr2 (),
                                                                                     {tid});
@@ -1453,7 +1450,7 @@ HeFrameExchangeManager::ReceiveMpdu (Ptr<WifiMacQueueItem> mpdu, RxSignalInfo rx
                && m_txTimer.GetReason () == WifiTxTimer::WAIT_BLOCK_ACK_AFTER_TB_PPDU)
         {
           CtrlBAckResponseHeader blockAck;
-          mpdu->GetPacket ()->PeekHeader (blockAck);
+          mpdu->PeekFrameBody (blockAck);
 
           NS_ABORT_MSG_IF (!blockAck.IsMultiSta (),
                            "A Multi-STA BlockAck is expected after a TB PPDU");
@@ -1470,7 +1467,7 @@ HeFrameExchangeManager::ReceiveMpdu (Ptr<WifiMacQueueItem> mpdu, RxSignalInfo rx
             }
 
           MuSnrTag tag;
-          mpdu->GetPacket ()->PeekPacketTag (tag);
+          mpdu->PeekPacketTag (tag);
 
           // notify the Block Ack Manager
           for (const auto& index : indices)
@@ -1541,7 +1538,7 @@ HeFrameExchangeManager::ReceiveMpdu (Ptr<WifiMacQueueItem> mpdu, RxSignalInfo rx
             }
 
           CtrlTriggerHeader trigger;
-          mpdu->GetPacket ()->PeekHeader (trigger);
+          mpdu->PeekFrameBody (trigger);
 
           if (hdr.GetAddr1 () != m_self
               && (!hdr.GetAddr1 ().IsBroadcast ()
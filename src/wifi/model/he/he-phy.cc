@@ -512,7 +512,7 @@ HePhy::GetStaId (const Ptr<const WifiPpdu> ppdu) const
       Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (m_wifiPhy->GetDevice ());
       if (device)
         {
-          Ptr<StaWifiMac> mac = DynamicCast<StaWifiMac> (device->GetMac ());
+          Ptr<StaWifiMac> mac = DynamicCast<StaWifiMac> (device->GetMac (device->GetLinkId (m_wifiPhy)));
           if (mac && mac->IsAssociated ())
             {
               return mac->GetAssociationId ();
@@ -635,7 +635,7 @@ HePhy::DoStartReceivePayload (Ptr<Event> event)
     {
       NS_ASSERT (txVector.GetModulationClass () == WIFI_MOD_CLASS_HE);
       Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (m_wifiPhy->GetDevice ());
-      bool isAp = device != 0 && (DynamicCast<ApWifiMac> (device->GetMac ()) != 0);
+      bool isAp = device != 0 && (DynamicCast<ApWifiMac> (device->GetMac (device->GetLinkId (m_wifiPhy))) != 0);
       if (!isAp)
         {
           NS_LOG_DEBUG ("Ignore HE TB PPDU payload received by STA but keep state in Rx");
@@ -21,6 +21,7 @@
 #include "he-ru.h"
 #include "ns3/abort.h"
 #include "ns3/assert.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -598,5 +599,37 @@ HeRu::GetEqualSizedRusForStations (uint16_t bandwidth, std::size_t& nStations,
   return ruType;
 }
 
+const HeRu::EqualSizedRuAllocation&
+HeRu::GetEqualSizedRuAllocation (uint16_t bandwidth, std::size_t nStations)
+{
+  // for every bandwidth, the allocations for 1 to the maximum number of stations
+  static const std::map<uint16_t, std::vector<EqualSizedRuAllocation>> allocations = []
+    {
+      std::map<uint16_t, std::vector<EqualSizedRuAllocation>> table;
+      for (uint16_t bw : {20, 40, 80, 160})
+        {
+          std::size_t maxStations = GetNRus (bw, RU_26_TONE);
+          for (std::size_t n = 1; n <= maxStations; n++)
+            {
+              std::size_t nRus = n;
+              std::size_t nCentral26TonesRus;
+              RuType ruType = GetEqualSizedRusForStations (bw, nRus, nCentral26TonesRus);
+              EqualSizedRuAllocation allocation {ruType, GetRusOfType (bw, ruType),
+                                                 GetCentral26TonesRus (bw, ruType)};
+              NS_ASSERT (allocation.rus.size () == nRus
+                         && allocation.central26TonesRus.size () == nCentral26TonesRus);
+              table[bw].push_back (std::move (allocation));
+            }
+        }
+      return table;
+    } ();
+
+  NS_ASSERT (nStations > 0);
+  auto it = allocations.find (bandwidth);
+  NS_ABORT_MSG_IF (it == allocations.end (), "Unsupported channel bandwidth: " << bandwidth);
+  // more stations than 26-tone RUs are assigned the 26-tone RUs
+  return it->second.at (std::min (nStations, it->second.size ()) - 1);
+}
+
 
 } //namespace ns3
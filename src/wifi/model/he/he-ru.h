@@ -244,6 +244,28 @@ public:
   static RuType GetEqualSizedRusForStations (uint16_t bandwidth, std::size_t& nStations,
                                              std::size_t& nCentral26TonesRus);
 
+  /// Allocation of RUs of equal size, plus the central 26-tone RUs left over
+  struct EqualSizedRuAllocation
+  {
+    RuType ruType;                          //!< the type of the RUs of equal size
+    std::vector<RuSpec> rus;                //!< the RUs of equal size
+    std::vector<RuSpec> central26TonesRus;  //!< the 26-tone RUs that can be additionally allocated
+  };
+
+  /**
+   * Get the allocation of RUs of equal size returned by GetEqualSizedRusForStations
+   * for the given channel bandwidth and number of candidate stations, along with
+   * the RUs returned by GetRusOfType and GetCentral26TonesRus for the selected RU
+   * type. The allocations for all the channel bandwidths and numbers of stations
+   * are computed once and stored in a table.
+   *
+   * \param bandwidth the channel bandwidth in MHz (20, 40, 80, 160)
+   * \param nStations the number of candidate stations (at least one)
+   * eturn the allocation of RUs of equal size
+   */
+  static const EqualSizedRuAllocation& GetEqualSizedRuAllocation (uint16_t bandwidth,
+                                                                  std::size_t nStations);
+
   /// (bandwidth, number of tones) pair
   typedef std::pair<uint8_t, RuType> BwTonesPair;
 
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ofdma-scheduling-policy.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("OfdmaSchedulingPolicy");
+
+NS_OBJECT_ENSURE_REGISTERED (OfdmaSchedulingPolicy);
+
+TypeId
+OfdmaSchedulingPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::OfdmaSchedulingPolicy")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+  ;
+  return tid;
+}
+
+OfdmaSchedulingPolicy::~OfdmaSchedulingPolicy ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+void
+OfdmaSchedulingPolicy::NotifyScheduled (Mac48Address address, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << address << size);
+}
+
+void
+OfdmaSchedulingPolicy::NotifyStationRemoved (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (MaxThroughputSchedulingPolicy);
+
+TypeId
+MaxThroughputSchedulingPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MaxThroughputSchedulingPolicy")
+    .SetParent<OfdmaSchedulingPolicy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<MaxThroughputSchedulingPolicy> ()
+  ;
+  return tid;
+}
+
+MaxThroughputSchedulingPolicy::MaxThroughputSchedulingPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MaxThroughputSchedulingPolicy::~MaxThroughputSchedulingPolicy ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+double
+MaxThroughputSchedulingPolicy::GetPriority (Mac48Address address, uint64_t rate)
+{
+  NS_LOG_FUNCTION (this << address << rate);
+  return static_cast<double> (rate);
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (ProportionalFairSchedulingPolicy);
+
+TypeId
+ProportionalFairSchedulingPolicy::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::ProportionalFairSchedulingPolicy")
+    .SetParent<OfdmaSchedulingPolicy> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<ProportionalFairSchedulingPolicy> ()
+    .AddAttribute ("TimeConstant",
+                   "The time constant of the exponential moving average of the "
+                   "throughput scheduled for each station.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&ProportionalFairSchedulingPolicy::m_timeConstant),
+                   MakeTimeChecker (MicroSeconds (1)))
+  ;
+  return tid;
+}
+
+ProportionalFairSchedulingPolicy::ProportionalFairSchedulingPolicy ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+ProportionalFairSchedulingPolicy::~ProportionalFairSchedulingPolicy ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+ProportionalFairSchedulingPolicy::AverageThroughput&
+ProportionalFairSchedulingPolicy::UpdateAverageThroughput (Mac48Address address)
+{
+  Time now = Simulator::Now ();
+  auto it = m_avgThroughput.emplace (address, AverageThroughput {0.0, now}).first;
+  if (it->second.lastUpdate < now)
+    {
+      // the average decays exponentially while nothing is scheduled
+      it->second.value *= std::exp (-(now - it->second.lastUpdate).GetSeconds ()
+                                    / m_timeConstant.GetSeconds ());
+      it->second.lastUpdate = now;
+    }
+  return it->second;
+}
+
+double
+ProportionalFairSchedulingPolicy::GetAverageThroughput (Mac48Address address)
+{
+  return UpdateAverageThroughput (address).value;
+}
+
+double
+ProportionalFairSchedulingPolicy::GetPriority (Mac48Address address, uint64_t rate)
+{
+  NS_LOG_FUNCTION (this << address << rate);
+  // stations for which nothing was scheduled yet have an average throughput
+  // close to zero and hence the highest priorities, in order of data rate
+  return rate / std::max (UpdateAverageThroughput (address).value, 1.0);
+}
+
+void
+ProportionalFairSchedulingPolicy::NotifyScheduled (Mac48Address address, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << address << size);
+  UpdateAverageThroughput (address).value += size * 8 / m_timeConstant.GetSeconds ();
+}
+
+void
+ProportionalFairSchedulingPolicy::NotifyStationRemoved (Mac48Address address)
+{
+  NS_LOG_FUNCTION (this << address);
+  m_avgThroughput.erase (address);
+}
+
+} //namespace ns3
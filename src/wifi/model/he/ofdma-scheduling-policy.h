@@ -0,0 +1,157 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OFDMA_SCHEDULING_POLICY_H
+#define OFDMA_SCHEDULING_POLICY_H
+
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "ns3/mac48-address.h"
+#include "ns3/qos-utils.h"
+#include <unordered_map>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ *
+ * OfdmaSchedulingPolicy is the abstract base class of the policies that a
+ * multi-user scheduler can use to rank the stations that are candidate for
+ * being assigned an RU in a DL MU PPDU. The stations are considered in
+ * decreasing order of priority, hence a policy only has to provide the
+ * priority of a station and may keep track of the amount of data scheduled
+ * for each station.
+ *
+ * Stations are identified by their MAC address, hence a policy can be
+ * shared among multiple APs.
+ */
+class OfdmaSchedulingPolicy : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  virtual ~OfdmaSchedulingPolicy ();
+
+  /**
+   * Get the priority of the given station.
+   *
+   * \param address the MAC address of the station
+   * \param rate the data rate (bps) used by the AP to transmit to the station
+   *             on a 20 MHz channel
+   * \return the priority of the station (the higher, the sooner it is served)
+   */
+  virtual double GetPriority (Mac48Address address, uint64_t rate) = 0;
+
+  /**
+   * Notify that a PSDU of the given size has been scheduled for transmission
+   * to the given station.
+   *
+   * \param address the MAC address of the station
+   * \param size the size in bytes of the PSDU
+   */
+  virtual void NotifyScheduled (Mac48Address address, uint32_t size);
+
+  /**
+   * Notify that the given station is no longer served (e.g., it deassociated),
+   * so that the state kept for it can be released.
+   *
+   * \param address the MAC address of the station
+   */
+  virtual void NotifyStationRemoved (Mac48Address address);
+};
+
+
+/**
+ * \ingroup wifi
+ *
+ * MaxThroughputSchedulingPolicy gives priority to the stations with the
+ * highest data rate, thus maximizing the throughput of the DL MU PPDUs at the
+ * cost of starving the stations with low data rates.
+ */
+class MaxThroughputSchedulingPolicy : public OfdmaSchedulingPolicy
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  MaxThroughputSchedulingPolicy ();
+  virtual ~MaxThroughputSchedulingPolicy ();
+
+  double GetPriority (Mac48Address address, uint64_t rate) override;
+};
+
+
+/**
+ * \ingroup wifi
+ *
+ * ProportionalFairSchedulingPolicy gives priority to the stations with the
+ * highest ratio between their data rate and the average throughput scheduled
+ * for them. The average throughput is an exponential moving average with a
+ * configurable time constant, which is updated only when a station is
+ * scheduled or ranked; hence, the cost of the policy does not depend on the
+ * number of stations that have no frames queued.
+ */
+class ProportionalFairSchedulingPolicy : public OfdmaSchedulingPolicy
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+  ProportionalFairSchedulingPolicy ();
+  virtual ~ProportionalFairSchedulingPolicy ();
+
+  double GetPriority (Mac48Address address, uint64_t rate) override;
+  void NotifyScheduled (Mac48Address address, uint32_t size) override;
+  void NotifyStationRemoved (Mac48Address address) override;
+
+  /**
+   * \param address the MAC address of a station
+   * \return the average throughput (bps) scheduled for the given station
+   */
+  double GetAverageThroughput (Mac48Address address);
+
+private:
+  /// Average throughput scheduled for a station
+  struct AverageThroughput
+  {
+    double value;       //!< the average throughput (bps) at the time of the last update
+    Time lastUpdate;    //!< the time of the last update
+  };
+
+  /**
+   * Get the average throughput scheduled for the given station, updated to
+   * the current time.
+   *
+   * \param address the MAC address of the station
+   * \return a reference to the average throughput of the station
+   */
+  AverageThroughput& UpdateAverageThroughput (Mac48Address address);
+
+  Time m_timeConstant;      //!< the time constant of the exponential moving average
+  /// the average throughput scheduled for each station
+  std::unordered_map<Mac48Address, AverageThroughput, WifiAddressHash> m_avgThroughput;
+};
+
+} //namespace ns3
+
+#endif /* OFDMA_SCHEDULING_POLICY_H */
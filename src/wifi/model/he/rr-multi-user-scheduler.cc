@@ -26,7 +26,10 @@
 #include "he-frame-exchange-manager.h"
 #include "he-configuration.h"
 #include "he-phy.h"
+#include "ofdma-scheduling-policy.h"
+#include "ns3/pointer.h"
 #include <algorithm>
+#include <unordered_set>
 
 namespace ns3 {
 
@@ -86,6 +89,13 @@ RrMultiUserScheduler::GetTypeId (void)
                    TimeValue (Seconds (1)),
                    MakeTimeAccessor (&RrMultiUserScheduler::m_maxCredits),
                    MakeTimeChecker ())
+    .AddAttribute ("SchedulingPolicy",
+                   "The policy used to rank the stations that are candidate for being "
+                   "granted an RU in a DL MU OFDMA transmission. If null, stations are "
+                   "served in a round robin fashion based on their credits.",
+                   PointerValue (),
+                   MakePointerAccessor (&RrMultiUserScheduler::m_policy),
+                   MakePointerChecker<OfdmaSchedulingPolicy> ())
   ;
   return tid;
 }
@@ -113,6 +123,15 @@ RrMultiUserScheduler::DoInitialize (void)
   for (const auto& ac : wifiAcList)
     {
       m_staList.insert ({ac.first, {}});
+      m_staListIndex.insert ({ac.first, {}});
+      m_nQueuedMpdus.insert ({ac.first, {}});
+      Ptr<WifiMacQueue> queue = m_apMac->GetQosTxop (ac.first)->GetWifiMacQueue ();
+      queue->TraceConnectWithoutContext ("Enqueue",
+                                         MakeCallback (&RrMultiUserScheduler::NotifyEnqueue, this)
+                                         .Bind (ac.first));
+      queue->TraceConnectWithoutContext ("Dequeue",
+                                         MakeCallback (&RrMultiUserScheduler::NotifyDequeue, this)
+                                         .Bind (ac.first));
     }
   MultiUserScheduler::DoInitialize ();
 }
@@ -122,7 +141,10 @@ RrMultiUserScheduler::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
   m_staList.clear ();
+  m_staListIndex.clear ();
+  m_nQueuedMpdus.clear ();
   m_candidates.clear ();
+  m_policy = nullptr;
   m_trigger = nullptr;
   m_txParams.Clear ();
   m_apMac->TraceDisconnectWithoutContext ("AssociatedSta",
@@ -173,9 +195,6 @@ RrMultiUserScheduler::TrySendingBsrpTf (void)
   WifiTxVector txVector = GetDlMuInfo ().txParams.m_txVector;
   txVector.SetGuardInterval (trigger.GetGuardInterval ());
 
-  Ptr<Packet> packet = Create<Packet> ();
-  packet->AddHeader (trigger);
-
   Mac48Address receiver = Mac48Address::GetBroadcast ();
   if (trigger.GetNUserInfoFields () == 1)
     {
@@ -189,7 +208,7 @@ RrMultiUserScheduler::TrySendingBsrpTf (void)
   hdr.SetDsNotTo ();
   hdr.SetDsNotFrom ();
 
-  Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> (packet, hdr);
+  Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> (Create<Packet> (), trigger, hdr);
 
   m_txParams.Clear ();
   // set the TXVECTOR used to send the Trigger Frame
@@ -238,9 +257,7 @@ RrMultiUserScheduler::TrySendingBsrpTf (void)
   trigger.SetCsRequired (true);
   m_heFem->SetTargetRssi (trigger);
 
-  packet = Create<Packet> ();
-  packet->AddHeader (trigger);
-  m_trigger = Create<WifiMacQueueItem> (packet, hdr);
+  m_trigger = Create<WifiMacQueueItem> (Create<Packet> (), trigger, hdr);
 
   m_ulTriggerType = TriggerFrameType::BSRP_TRIGGER;
   m_tbPpduDuration = qosNullTxDuration;
@@ -290,10 +307,12 @@ RrMultiUserScheduler::TrySendingBasicTf (void)
   if (maxBufferSize > 0)
     {
       NS_ASSERT (!ulCandidates.empty ());
-      std::size_t count = ulCandidates.size ();
-      std::size_t nCentral26TonesRus;
-      HeRu::RuType ruType = HeRu::GetEqualSizedRusForStations (m_apMac->GetWifiPhy ()->GetChannelWidth (),
-                                                               count, nCentral26TonesRus);
+      const HeRu::EqualSizedRuAllocation& allocation
+        = HeRu::GetEqualSizedRuAllocation (m_apMac->GetWifiPhy ()->GetChannelWidth (),
+                                           ulCandidates.size ());
+      std::size_t count = allocation.rus.size ();
+      std::size_t nCentral26TonesRus = allocation.central26TonesRus.size ();
+      HeRu::RuType ruType = allocation.ruType;
       if (!m_useCentral26TonesRus || ulCandidates.size () == count)
         {
           nCentral26TonesRus = 0;
@@ -328,7 +347,7 @@ RrMultiUserScheduler::TrySendingBasicTf (void)
       else
         {
           CtrlTriggerHeader trigger;
-          GetUlMuInfo ().trigger->GetPacket ()->PeekHeader (trigger);
+          GetUlMuInfo ().trigger->PeekFrameBody (trigger);
 
           txVector.SetChannelWidth (trigger.GetUlBandwidth ());
           txVector.SetGuardInterval (trigger.GetGuardInterval ());
@@ -354,8 +373,6 @@ RrMultiUserScheduler::TrySendingBasicTf (void)
       AssignRuIndices (txVector);
 
       CtrlTriggerHeader trigger (TriggerFrameType::BASIC_TRIGGER, txVector);
-      Ptr<Packet> packet = Create<Packet> ();
-      packet->AddHeader (trigger);
 
       Mac48Address receiver = Mac48Address::GetBroadcast ();
       if (ulCandidates.size () == 1)
@@ -369,7 +386,7 @@ RrMultiUserScheduler::TrySendingBasicTf (void)
       hdr.SetDsNotTo ();
       hdr.SetDsNotFrom ();
 
-      Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> (packet, hdr);
+      Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> (Create<Packet> (), trigger, hdr);
 
       // compute the maximum amount of time that can be granted to stations.
       // This value is limited by the max PPDU duration
@@ -457,9 +474,7 @@ RrMultiUserScheduler::TrySendingBasicTf (void)
           userInfo.SetBasicTriggerDepUserInfo (0, 0, m_edca->GetAccessCategory ());
         }
 
-      packet = Create<Packet> ();
-      packet->AddHeader (trigger);
-      m_trigger = Create<WifiMacQueueItem> (packet, hdr);
+      m_trigger = Create<WifiMacQueueItem> (Create<Packet> (), trigger, hdr);
 
       m_ulTriggerType = TriggerFrameType::BASIC_TRIGGER;
       m_tbPpduDuration = maxDuration;
@@ -479,6 +494,7 @@ RrMultiUserScheduler::NotifyStationAssociated (uint16_t aid, Mac48Address addres
       for (auto& staList : m_staList)
         {
           staList.second.push_back (MasterInfo {aid, address, 0.0});
+          m_staListIndex[staList.first][address] = std::prev (staList.second.end ());
         }
     }
 }
@@ -494,8 +510,108 @@ RrMultiUserScheduler::NotifyStationDeassociated (uint16_t aid, Mac48Address addr
         {
           staList.second.remove_if ([&aid, &address] (const MasterInfo& info)
                                     { return info.aid == aid && info.address == address; });
+          m_staListIndex[staList.first].erase (address);
+        }
+      if (m_policy != nullptr)
+        {
+          m_policy->NotifyStationRemoved (address);
+        }
+    }
+}
+
+void
+RrMultiUserScheduler::NotifyEnqueue (AcIndex ac, Ptr<const WifiMacQueueItem> mpdu)
+{
+  NS_LOG_FUNCTION (this << ac << *mpdu);
+
+  if (mpdu->GetHeader ().IsQosData ())
+    {
+      m_nQueuedMpdus[ac][mpdu->GetHeader ().GetAddr1 ()]++;
+    }
+}
+
+void
+RrMultiUserScheduler::NotifyDequeue (AcIndex ac, Ptr<const WifiMacQueueItem> mpdu)
+{
+  NS_LOG_FUNCTION (this << ac << *mpdu);
+
+  if (mpdu->GetHeader ().IsQosData ())
+    {
+      auto it = m_nQueuedMpdus[ac].find (mpdu->GetHeader ().GetAddr1 ());
+      NS_ASSERT (it != m_nQueuedMpdus[ac].end () && it->second > 0);
+      // only the stations to which MPDUs are queued are kept
+      if (--it->second == 0)
+        {
+          m_nQueuedMpdus[ac].erase (it);
+        }
+    }
+}
+
+std::vector<std::list<RrMultiUserScheduler::MasterInfo>::iterator>
+RrMultiUserScheduler::GetDlCandidateStations (AcIndex primaryAc, const std::vector<uint8_t>& tids)
+{
+  NS_LOG_FUNCTION (this << primaryAc);
+
+  std::set<AcIndex> acs;
+  for (uint8_t tid : tids)
+    {
+      acs.insert (QosUtilsMapTidToAc (tid));
+    }
+
+  std::vector<std::list<MasterInfo>::iterator> stations;
+
+  if (m_policy == nullptr)
+    {
+      // serve the stations in decreasing order of credits
+      for (auto staIt = m_staList[primaryAc].begin (); staIt != m_staList[primaryAc].end (); staIt++)
+        {
+          if (std::any_of (acs.begin (), acs.end (),
+                           [this, &staIt] (AcIndex ac)
+                           { return m_nQueuedMpdus[ac].find (staIt->address) != m_nQueuedMpdus[ac].end (); }))
+            {
+              stations.push_back (staIt);
+            }
+        }
+      return stations;
+    }
+
+  // rank the associated stations to which frames are queued
+  std::vector<std::pair<double, std::list<MasterInfo>::iterator>> ranking;
+  std::unordered_set<Mac48Address, WifiAddressHash> ranked;
+  WifiMacHeader hdr (WIFI_MAC_QOSDATA);
+
+  for (AcIndex ac : acs)
+    {
+      for (const auto& queued : m_nQueuedMpdus[ac])
+        {
+          auto indexIt = m_staListIndex[primaryAc].find (queued.first);
+          if (indexIt == m_staListIndex[primaryAc].end () || !ranked.insert (queued.first).second)
+            {
+              // not an associated HE station or already ranked
+              continue;
+            }
+          hdr.SetAddr1 (queued.first);
+          WifiTxVector txVector = GetWifiRemoteStationManager ()->GetDataTxVector (hdr);
+          uint64_t rate = txVector.GetMode ().GetDataRate (20, txVector.GetGuardInterval (),
+                                                           txVector.GetNss ());
+          ranking.push_back ({m_policy->GetPriority (queued.first, rate), indexIt->second});
         }
     }
+
+  // sort in decreasing order of priority (and increasing order of AID, to
+  // break ties in a deterministic way)
+  std::sort (ranking.begin (), ranking.end (),
+             [] (const std::pair<double, std::list<MasterInfo>::iterator>& a,
+                 const std::pair<double, std::list<MasterInfo>::iterator>& b)
+             {
+               return a.first > b.first || (a.first == b.first && a.second->aid < b.second->aid);
+             });
+
+  for (const auto& station : ranking)
+    {
+      stations.push_back (station.second);
+    }
+  return stations;
 }
 
 MultiUserScheduler::TxFormat
@@ -511,17 +627,6 @@ RrMultiUserScheduler::TrySendingDlMuPpdu (void)
       return TxFormat::SU_TX;
     }
 
-  std::size_t count = std::min (static_cast<std::size_t> (m_nStations), m_staList[primaryAc].size ());
-  std::size_t nCentral26TonesRus;
-  HeRu::RuType ruType = HeRu::GetEqualSizedRusForStations (m_apMac->GetWifiPhy ()->GetChannelWidth (), count,
-                                                           nCentral26TonesRus);
-  NS_ASSERT (count >= 1);
-
-  if (!m_useCentral26TonesRus)
-    {
-      nCentral26TonesRus = 0;
-    }
-
   uint8_t currTid = wifiAcList.at (primaryAc).GetHighTid ();
 
   Ptr<const WifiMacQueueItem> mpdu = m_edca->PeekNextMpdu ();
@@ -548,6 +653,22 @@ RrMultiUserScheduler::TrySendingDlMuPpdu (void)
       tids.push_back (currTid);
     }
 
+  // the stations to which the AP has frames to send, in the order they are considered
+  std::vector<std::list<MasterInfo>::iterator> stations = GetDlCandidateStations (primaryAc, tids);
+
+  // RUs are sized based on the number of associated stations in case of round robin
+  // and on the number of stations with frames queued in case of a scheduling policy
+  std::size_t nStations = (m_policy == nullptr ? m_staList[primaryAc].size () : stations.size ());
+  const HeRu::EqualSizedRuAllocation& allocation
+    = HeRu::GetEqualSizedRuAllocation (m_apMac->GetWifiPhy ()->GetChannelWidth (),
+                                       std::max<std::size_t> (std::min (static_cast<std::size_t> (m_nStations),
+                                                                        nStations),
+                                                              1));
+  std::size_t count = allocation.rus.size ();
+  std::size_t nCentral26TonesRus = (m_useCentral26TonesRus ? allocation.central26TonesRus.size () : 0);
+  HeRu::RuType ruType = allocation.ruType;
+  NS_ASSERT (count >= 1);
+
   Ptr<HeConfiguration> heConfiguration = m_apMac->GetHeConfiguration ();
   NS_ASSERT (heConfiguration != 0);
 
@@ -563,14 +684,14 @@ RrMultiUserScheduler::TrySendingDlMuPpdu (void)
   // For the moment, we are considering just one MPDU per receiver.
   Time actualAvailableTime = (m_initialFrame ? Time::Min () : m_availableTime);
 
-  // iterate over the associated stations until an enough number of stations is identified
-  auto staIt = m_staList[primaryAc].begin ();
+  // iterate over the candidate stations until an enough number of stations is identified
+  auto staIt = stations.begin ();
   m_candidates.clear ();
 
-  while (staIt != m_staList[primaryAc].end ()
+  while (staIt != stations.end ()
          && m_candidates.size () < std::min (static_cast<std::size_t> (m_nStations), count + nCentral26TonesRus))
     {
-      NS_LOG_DEBUG ("Next candidate STA (MAC=" << staIt->address << ", AID=" << staIt->aid << ")");
+      NS_LOG_DEBUG ("Next candidate STA (MAC=" << (*staIt)->address << ", AID=" << (*staIt)->aid << ")");
 
       HeRu::RuType currRuType = (m_candidates.size () < count ? ruType : HeRu::RU_26_TONE);
 
@@ -581,9 +702,9 @@ RrMultiUserScheduler::TrySendingDlMuPpdu (void)
           NS_ASSERT (ac >= primaryAc);
           // check that a BA agreement is established with the receiver for the
           // considered TID, since ack sequences for DL MU PPDUs require block ack
-          if (m_apMac->GetQosTxop (ac)->GetBaAgreementEstablished (staIt->address, tid))
+          if (m_apMac->GetQosTxop (ac)->GetBaAgreementEstablished ((*staIt)->address, tid))
             {
-              mpdu = m_apMac->GetQosTxop (ac)->PeekNextMpdu (tid, staIt->address);
+              mpdu = m_apMac->GetQosTxop (ac)->PeekNextMpdu (tid, (*staIt)->address);
 
               // we only check if the first frame of the current TID meets the size
               // and duration constraints. We do not explore the queues further.
@@ -596,7 +717,7 @@ RrMultiUserScheduler::TrySendingDlMuPpdu (void)
                   WifiTxVector suTxVector = GetWifiRemoteStationManager ()->GetDataTxVector (mpdu->GetHeader ()),
                                txVectorCopy = m_txParams.m_txVector;
 
-                  m_txParams.m_txVector.SetHeMuUserInfo (staIt->aid,
+                  m_txParams.m_txVector.SetHeMuUserInfo ((*staIt)->aid,
                                                          {{currRuType, 1, false},
                                                           suTxVector.GetMode (),
                                                           suTxVector.GetNss ()});
@@ -609,15 +730,15 @@ RrMultiUserScheduler::TrySendingDlMuPpdu (void)
                   else
                     {
                       // the frame meets the constraints
-                      NS_LOG_DEBUG ("Adding candidate STA (MAC=" << staIt->address << ", AID="
-                                    << staIt->aid << ") TID=" << +tid);
-                      m_candidates.push_back ({staIt, mpdu});
+                      NS_LOG_DEBUG ("Adding candidate STA (MAC=" << (*staIt)->address << ", AID="
+                                    << (*staIt)->aid << ") TID=" << +tid);
+                      m_candidates.push_back ({*staIt, mpdu});
                       break;    // terminate the for loop
                     }
                 }
               else
                 {
-                  NS_LOG_DEBUG ("No frames to send to " << staIt->address << " with TID=" << +tid);
+                  NS_LOG_DEBUG ("No frames to send to " << (*staIt)->address << " with TID=" << +tid);
                 }
             }
         }
@@ -653,9 +774,11 @@ RrMultiUserScheduler::ComputeDlMuInfo (void)
   uint16_t bw = m_apMac->GetWifiPhy ()->GetChannelWidth ();
 
   // compute how many stations can be granted an RU and the RU size
-  std::size_t nRusAssigned = m_txParams.GetPsduInfoMap ().size ();
-  std::size_t nCentral26TonesRus;
-  HeRu::RuType ruType = HeRu::GetEqualSizedRusForStations (bw, nRusAssigned, nCentral26TonesRus);
+  const HeRu::EqualSizedRuAllocation& allocation
+    = HeRu::GetEqualSizedRuAllocation (bw, m_txParams.GetPsduInfoMap ().size ());
+  std::size_t nRusAssigned = allocation.rus.size ();
+  std::size_t nCentral26TonesRus = allocation.central26TonesRus.size ();
+  HeRu::RuType ruType = allocation.ruType;
 
   NS_LOG_DEBUG (nRusAssigned << " stations are being assigned a " << ruType << " RU");
 
@@ -760,6 +883,17 @@ RrMultiUserScheduler::ComputeDlMuInfo (void)
         }
     }
 
+  if (m_policy != nullptr)
+    {
+      // the scheduling policy keeps track of the data scheduled for each station
+      for (const auto& candidate : m_candidates)
+        {
+          m_policy->NotifyScheduled (candidate.first->address,
+                                     dlMuInfo.psduMap[candidate.first->aid]->GetSize ());
+        }
+      return dlMuInfo;
+    }
+
   AcIndex primaryAc = m_edca->GetAccessCategory ();
 
   // The amount of credits received by each station equals the TX duration (in
@@ -807,42 +941,35 @@ RrMultiUserScheduler::AssignRuIndices (WifiTxVector& txVector)
 
   uint8_t bw = txVector.GetChannelWidth ();
 
-  // find the RU types allocated in the TXVECTOR
-  std::set<HeRu::RuType> ruTypeSet;
+  // find the RU types allocated in the TXVECTOR and the number of RUs of each type
+  std::map<HeRu::RuType, std::size_t> ruTypes;
   for (const auto& userInfo : txVector.GetHeMuUserInfoMap ())
     {
-      ruTypeSet.insert (userInfo.second.ru.GetRuType ());
+      ruTypes[userInfo.second.ru.GetRuType ()]++;
     }
 
-  std::vector<HeRu::RuSpec> ruSet, central26TonesRus;
-
   // This scheduler allocates equal sized RUs and optionally the remaining 26-tone RUs
-  if (ruTypeSet.size () == 2)
-    {
-      // central 26-tone RUs have been allocated
-      NS_ASSERT (ruTypeSet.find (HeRu::RU_26_TONE) != ruTypeSet.end ());
-      ruTypeSet.erase (HeRu::RU_26_TONE);
-      NS_ASSERT (ruTypeSet.size () == 1);
-      central26TonesRus = HeRu::GetCentral26TonesRus (bw, *ruTypeSet.begin ());
-    }
-
-  NS_ASSERT (ruTypeSet.size () == 1);
-  ruSet = HeRu::GetRusOfType (bw, *ruTypeSet.begin ());
+  // (which are of the smallest type, if any)
+  NS_ASSERT (ruTypes.size () == 1 || (ruTypes.size () == 2 && ruTypes.begin ()->first == HeRu::RU_26_TONE));
+  HeRu::RuType ruType = ruTypes.rbegin ()->first;
+  const HeRu::EqualSizedRuAllocation& allocation
+    = HeRu::GetEqualSizedRuAllocation (bw, ruTypes.rbegin ()->second);
+  NS_ASSERT (allocation.ruType == ruType);
 
-  auto ruSetIt = ruSet.begin ();
-  auto central26TonesRusIt = central26TonesRus.begin ();
+  auto ruSetIt = allocation.rus.begin ();
+  auto central26TonesRusIt = allocation.central26TonesRus.begin ();
 
   for (const auto& userInfo : txVector.GetHeMuUserInfoMap ())
     {
-      if (userInfo.second.ru.GetRuType () == *ruTypeSet.begin ())
+      if (userInfo.second.ru.GetRuType () == ruType)
         {
-          NS_ASSERT (ruSetIt != ruSet.end ());
+          NS_ASSERT (ruSetIt != allocation.rus.end ());
           txVector.SetRu (*ruSetIt, userInfo.first);
           ruSetIt++;
         }
       else
         {
-          NS_ASSERT (central26TonesRusIt != central26TonesRus.end ());
+          NS_ASSERT (central26TonesRusIt != allocation.central26TonesRus.end ());
           txVector.SetRu (*central26TonesRusIt, userInfo.first);
           central26TonesRusIt++;
         }
@@ -23,9 +23,12 @@
 
 #include "multi-user-scheduler.h"
 #include <list>
+#include <unordered_map>
 
 namespace ns3 {
 
+class OfdmaSchedulingPolicy;
+
 /**
  * \ingroup wifi
  *
@@ -34,7 +37,14 @@ namespace ns3 {
  * RrMultiUserScheduler assigns RUs of equal size (in terms of tones) to stations to
  * which the AP has frames to transmit belonging to the AC who gained access to the
  * channel or higher. The maximum number of stations that can be granted an RU
- * is configurable. Associated stations are served in a round robin fashion.
+ * is configurable. Associated stations are served in a round robin fashion,
+ * unless a scheduling policy (e.g., proportional fair or max throughput) is set
+ * through the SchedulingPolicy attribute, in which case the stations are served
+ * in decreasing order of the priority returned by the policy.
+ *
+ * The scheduler keeps track of the stations to which the AP has frames queued,
+ * so that stations with no frames queued are not considered, and takes the
+ * RUs to assign from the table of RU allocations provided by HeRu.
  *
  * \todo Take the supported channel width of the stations into account while selecting
  * stations and assigning RUs to them.
@@ -109,6 +119,21 @@ private:
    */
   void NotifyStationDeassociated (uint16_t aid, Mac48Address address);
 
+  /**
+   * Notify the scheduler that an MPDU was enqueued in the queue of the given AC
+   *
+   * \param ac the Access Category
+   * \param mpdu the MPDU
+   */
+  void NotifyEnqueue (AcIndex ac, Ptr<const WifiMacQueueItem> mpdu);
+  /**
+   * Notify the scheduler that an MPDU was removed from the queue of the given AC
+   *
+   * \param ac the Access Category
+   * \param mpdu the MPDU
+   */
+  void NotifyDequeue (AcIndex ac, Ptr<const WifiMacQueueItem> mpdu);
+
   /**
    * Information used to sort stations
    */
@@ -124,6 +149,24 @@ private:
    */
   typedef std::pair<std::list<MasterInfo>::iterator, Ptr<const WifiMacQueueItem>> CandidateInfo;
 
+  /**
+   * Get the associated stations to which the AP has frames queued with any of
+   * the given TIDs, in the order in which they are considered as recipients of
+   * a DL MU PPDU: decreasing order of credits if no scheduling policy is set,
+   * decreasing order of the priority returned by the scheduling policy otherwise.
+   *
+   * \param primaryAc the AC that gained channel access
+   * \param tids the TIDs to check
+   * \return the stations to consider as recipients of a DL MU PPDU
+   */
+  std::vector<std::list<MasterInfo>::iterator> GetDlCandidateStations (AcIndex primaryAc,
+                                                                      const std::vector<uint8_t>& tids);
+
+  /// Map the MAC addresses of the stations to their number of queued MPDUs
+  typedef std::unordered_map<Mac48Address, uint32_t, WifiAddressHash> QueuedMpduCounts;
+  /// Map the MAC addresses of the stations to their position in a list of stations
+  typedef std::unordered_map<Mac48Address, std::list<MasterInfo>::iterator, WifiAddressHash> StaListIndex;
+
   uint8_t m_nStations;                                  //!< Number of stations/slots to fill
   bool m_enableTxopSharing;                             //!< allow A-MPDUs of different TIDs in a DL MU PPDU
   bool m_forceDlOfdma;                                  //!< return DL_OFDMA even if no DL MU PPDU was built
@@ -132,6 +175,9 @@ private:
   bool m_useCentral26TonesRus;                          //!< whether to allocate central 26-tone RUs
   uint32_t m_ulPsduSize;                                //!< the size in byte of the solicited PSDU
   std::map<AcIndex, std::list<MasterInfo>> m_staList;   //!< Per-AC list of stations (next to serve first)
+  std::map<AcIndex, StaListIndex> m_staListIndex;      //!< Per-AC index of the list of stations
+  std::map<AcIndex, QueuedMpduCounts> m_nQueuedMpdus;   //!< Per-AC number of MPDUs queued for each station (if any)
+  Ptr<OfdmaSchedulingPolicy> m_policy;                  //!< Scheduling policy (null for round robin)
   std::list<CandidateInfo> m_candidates;                //!< Candidate stations for MU TX
   Time m_maxCredits;                                    //!< Max amount of credits a station can have
   Ptr<WifiMacQueueItem> m_trigger;                      //!< Trigger Frame to send
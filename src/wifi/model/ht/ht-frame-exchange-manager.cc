@@ -1159,7 +1159,7 @@ HtFrameExchangeManager::MissedBlockAck (Ptr<WifiPsdu> psdu, const WifiTxVector&
     {
       isBar = true;
       CtrlBAckRequestHeader baReqHdr;
-      psdu->GetPayload (0)->PeekHeader (baReqHdr);
+      (*psdu->begin ())->PeekFrameBody (baReqHdr);
       tid = baReqHdr.GetTidInfo ();
     }
   else
@@ -1250,9 +1250,11 @@ HtFrameExchangeManager::SendBlockAck (const RecipientBlockAckAgreement& agreemen
   blockAck.SetTidInfo (agreement.GetTid ());
   agreement.FillBlockAckBitmap (&blockAck);
 
+  SnrTag tag;
+  tag.Set (rxSnr);
   Ptr<Packet> packet = Create<Packet> ();
-  packet->AddHeader (blockAck);
-  Ptr<WifiPsdu> psdu = GetWifiPsdu (Create<WifiMacQueueItem> (packet, hdr), blockAckTxVector);
+  packet->AddPacketTag (tag);
+  Ptr<WifiPsdu> psdu = GetWifiPsdu (Create<WifiMacQueueItem> (packet, blockAck, hdr), blockAckTxVector);
 
   // 802.11-2016, Section 9.2.5.7: In a BlockAck frame transmitted in response
   // to a BlockAckReq frame or transmitted in response to a frame containing an
@@ -1269,10 +1271,6 @@ HtFrameExchangeManager::SendBlockAck (const RecipientBlockAckAgreement& agreemen
     }
   psdu->GetHeader (0).SetDuration (baDurationId);
 
-  SnrTag tag;
-  tag.Set (rxSnr);
-  psdu->GetPayload (0)->AddPacketTag (tag);
-
   ForwardPsduDown (psdu, blockAckTxVector);
 }
 
@@ -1330,11 +1328,11 @@ HtFrameExchangeManager::ReceiveMpdu (Ptr<WifiMacQueueItem> mpdu, RxSignalInfo rx
           NS_LOG_DEBUG ("Received BlockAck from=" << sender);
 
           SnrTag tag;
-          mpdu->GetPacket ()->PeekPacketTag (tag);
+          mpdu->PeekPacketTag (tag);
 
           // notify the Block Ack Manager
           CtrlBAckResponseHeader blockAck;
-          mpdu->GetPacket ()->PeekHeader (blockAck);
+          mpdu->PeekFrameBody (blockAck);
           uint8_t tid = blockAck.GetTidInfo ();
           std::pair<uint16_t,uint16_t> ret = GetBaManager (tid)->NotifyGotBlockAck (blockAck, hdr.GetAddr2 (), {tid});
           m_mac->GetWifiRemoteStationManager ()->ReportAmpduTxStatus (hdr.GetAddr2 (), ret.first, ret.second,
@@ -1359,7 +1357,7 @@ HtFrameExchangeManager::ReceiveMpdu (Ptr<WifiMacQueueItem> mpdu, RxSignalInfo rx
           NS_LOG_DEBUG ("Received BlockAckReq from=" << sender);
 
           CtrlBAckRequestHeader blockAckReq;
-          mpdu->GetPacket ()->PeekHeader (blockAckReq);
+          mpdu->PeekFrameBody (blockAckReq);
           NS_ABORT_MSG_IF (blockAckReq.IsMultiTid (), "Multi-TID BlockAckReq not supported");
           uint8_t tid = blockAckReq.GetTidInfo ();
           
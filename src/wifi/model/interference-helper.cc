@@ -139,33 +139,51 @@ std::ostream & operator << (std::ostream &os, const Event &event)
  *       short period of time.
  ****************************************************************/
 
-InterferenceHelper::NiChange::NiChange (double power, Ptr<Event> event)
-  : m_power (power),
-    m_event (event)
+std::size_t
+InterferenceHelper::NiChanges::GetSize (void) const
 {
+  return times.size ();
 }
 
-InterferenceHelper::NiChange::~NiChange ()
+std::size_t
+InterferenceHelper::NiChanges::Insert (Time moment, double power, Ptr<Event> event)
 {
-  m_event = 0;
+  std::size_t index = GetNextPosition (moment, *this);
+  times.insert (times.begin () + index, moment);
+  powers.insert (powers.begin () + index, power);
+  events.insert (events.begin () + index, event);
+  return index;
 }
 
-double
-InterferenceHelper::NiChange::GetPower (void) const
+void
+InterferenceHelper::NiChanges::Erase (std::size_t first, std::size_t last)
 {
-  return m_power;
+  NS_ASSERT (first <= last && last <= GetSize ());
+  times.erase (times.begin () + first, times.begin () + last);
+  powers.erase (powers.begin () + first, powers.begin () + last);
+  events.erase (events.begin () + first, events.begin () + last);
 }
 
 void
-InterferenceHelper::NiChange::AddPower (double power)
+InterferenceHelper::NiChanges::AddPower (std::size_t first, std::size_t last, double power)
 {
-  m_power += power;
+  NS_ASSERT (first <= last && last <= GetSize ());
+  double *p = powers.data ();
+  for (std::size_t i = first; i < last; i++)
+    {
+      p[i] += power;
+    }
 }
 
-Ptr<Event>
-InterferenceHelper::NiChange::GetEvent (void) const
+void
+InterferenceHelper::NiChanges::Reset (void)
 {
-  return m_event;
+  times.clear ();
+  powers.clear ();
+  events.clear ();
+  // Always have a zero power noise event in the list
+  Insert (Time (0), 0.0, 0);
+  firstPower = 0.0;
 }
 
 
@@ -211,12 +229,7 @@ void
 InterferenceHelper::RemoveBands(void)
 {
   NS_LOG_FUNCTION (this);
-  for (auto it : m_niChangesPerBand)
-    {
-      it.second.clear ();
-    }
   m_niChangesPerBand.clear();
-  m_firstPowerPerBand.clear();
 }
 
 void
@@ -224,12 +237,9 @@ InterferenceHelper::AddBand (WifiSpectrumBand band)
 {
   NS_LOG_FUNCTION (this << band.first << band.second);
   NS_ASSERT (m_niChangesPerBand.find (band) == m_niChangesPerBand.end ());
-  NiChanges niChanges;
-  auto result = m_niChangesPerBand.insert ({band, niChanges});
+  auto result = m_niChangesPerBand.insert ({band, NiChanges ()});
   NS_ASSERT (result.second);
-  // Always have a zero power noise event in the list
-  AddNiChangeEvent (Time (0), NiChange (0.0, 0), result.first);
-  m_firstPowerPerBand.insert ({band, 0.0});
+  result.first->second.Reset ();
 }
 
 void
@@ -262,12 +272,13 @@ InterferenceHelper::GetEnergyDuration (double energyW, WifiSpectrumBand band)
   Time now = Simulator::Now ();
   auto niIt = m_niChangesPerBand.find (band);
   NS_ASSERT (niIt != m_niChangesPerBand.end ());
-  auto i = GetPreviousPosition (now, niIt);
-  Time end = i->first;
-  for (; i != niIt->second.end (); ++i)
+  const NiChanges &changes = niIt->second;
+  std::size_t i = GetPreviousPosition (now, changes);
+  Time end = changes.times[i];
+  for (; i < changes.GetSize (); ++i)
     {
-      double noiseInterferenceW = i->second.GetPower ();
-      end = i->first;
+      double noiseInterferenceW = changes.powers[i];
+      end = changes.times[i];
       if (noiseInterferenceW < energyW)
         {
           break;
@@ -285,30 +296,26 @@ InterferenceHelper::AppendEvent (Ptr<Event> event, bool isStartOfdmaRxing)
       WifiSpectrumBand band = it.first;
       auto niIt = m_niChangesPerBand.find (band);
       NS_ASSERT (niIt != m_niChangesPerBand.end ());
-      double previousPowerStart = 0;
-      double previousPowerEnd = 0;
-      auto previousPowerPosition = GetPreviousPosition (event->GetStartTime (), niIt);
-      previousPowerStart = previousPowerPosition->second.GetPower ();
-      previousPowerEnd = GetPreviousPosition (event->GetEndTime (), niIt)->second.GetPower ();
+      NiChanges &changes = niIt->second;
+      std::size_t previousPowerPosition = GetPreviousPosition (event->GetStartTime (), changes);
+      double previousPowerStart = changes.powers[previousPowerPosition];
+      double previousPowerEnd = changes.powers[GetPreviousPosition (event->GetEndTime (), changes)];
       if (!m_rxing)
         {
-          m_firstPowerPerBand.find (band)->second = previousPowerStart;
+          changes.firstPower = previousPowerStart;
           // Always leave the first zero power noise event in the list
-          niIt->second.erase (++(niIt->second.begin ()), ++previousPowerPosition);
+          changes.Erase (1, previousPowerPosition + 1);
         }
       else if (isStartOfdmaRxing)
         {
-          //When the first UL-OFDMA payload is received, we need to set m_firstPowerPerBand
+          //When the first UL-OFDMA payload is received, we need to set the first power
           //so that it takes into account interferences that arrived between the start of the
           //UL MU transmission and the start of UL-OFDMA payload.
-          m_firstPowerPerBand.find (band)->second = previousPowerStart;
-        }
-      auto first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event), niIt);
-      auto last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event), niIt);
-      for (auto i = first; i != last; ++i)
-        {
-          i->second.AddPower (it.second);
+          changes.firstPower = previousPowerStart;
         }
+      std::size_t first = changes.Insert (event->GetStartTime (), previousPowerStart, event);
+      std::size_t last = changes.Insert (event->GetEndTime (), previousPowerEnd, event);
+      changes.AddPower (first, last, it.second);
     }
 }
 
@@ -322,12 +329,10 @@ InterferenceHelper::UpdateEvent (Ptr<Event> event, const RxPowerWattPerChannelBa
       WifiSpectrumBand band = it.first;
       auto niIt = m_niChangesPerBand.find (band);
       NS_ASSERT (niIt != m_niChangesPerBand.end ());
-      auto first = GetPreviousPosition (event->GetStartTime (), niIt);
-      auto last = GetPreviousPosition (event->GetEndTime (), niIt);
-      for (auto i = first; i != last; ++i)
-        {
-          i->second.AddPower (it.second);
-        }
+      NiChanges &changes = niIt->second;
+      std::size_t first = GetPreviousPosition (event->GetStartTime (), changes);
+      std::size_t last = GetPreviousPosition (event->GetEndTime (), changes);
+      changes.AddPower (first, last, it.second);
     }
     event->UpdateRxPowerW (rxPower);
 }
@@ -359,30 +364,30 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint1
 }
 
 double
-InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, NiChangesPerBand *nis, WifiSpectrumBand band) const
+InterferenceHelper::CalculateNoiseInterferenceW (Ptr<Event> event, EventNiChanges *nis, WifiSpectrumBand band) const
 {
   NS_LOG_FUNCTION (this << band.first << band.second);
-  auto firstPower_it = m_firstPowerPerBand.find (band);
-  NS_ASSERT (firstPower_it != m_firstPowerPerBand.end ());
-  double noiseInterferenceW = firstPower_it->second;
   auto niIt = m_niChangesPerBand.find (band);
   NS_ASSERT (niIt != m_niChangesPerBand.end ());
-  auto it = niIt->second.find (event->GetStartTime ());
-  for (; it != niIt->second.end () && it->first < Simulator::Now (); ++it)
-    {
-      noiseInterferenceW = it->second.GetPower () - event->GetRxPowerW (band);
-    }
-  it = niIt->second.find (event->GetStartTime ());
-  NS_ASSERT (it != niIt->second.end ());
-  for (; it != niIt->second.end () && it->second.GetEvent () != event; ++it);
-  NiChanges ni;
-  ni.emplace (event->GetStartTime (), NiChange (0, event));
-  while (++it != niIt->second.end () && it->second.GetEvent () != event)
+  const NiChanges &changes = niIt->second;
+  double noiseInterferenceW = changes.firstPower;
+  double powerW = event->GetRxPowerW (band);
+  Time now = Simulator::Now ();
+  std::size_t start = std::lower_bound (changes.times.begin (), changes.times.end (), event->GetStartTime ())
+                      - changes.times.begin ();
+  NS_ASSERT (start < changes.GetSize () && changes.times[start] == event->GetStartTime ());
+  for (std::size_t i = start; i < changes.GetSize () && changes.times[i] < now; ++i)
     {
-      ni.insert (*it);
+      noiseInterferenceW = changes.powers[i] - powerW;
     }
-  ni.emplace (event->GetEndTime (), NiChange (0, event));
-  nis->insert ({band, ni});
+  for (; start < changes.GetSize () && changes.events[start] != event; ++start);
+  NS_ASSERT (start < changes.GetSize ());
+  std::size_t end = start + 1;
+  for (; end < changes.GetSize () && changes.events[end] != event; ++end);
+  NS_ASSERT (end < changes.GetSize ());
+  nis->changes = &changes;
+  nis->first = start;
+  nis->last = end;
   NS_ASSERT_MSG (noiseInterferenceW >= 0, "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
   return noiseInterferenceW;
 }
@@ -417,30 +422,31 @@ InterferenceHelper::CalculatePayloadChunkSuccessRate (double snir, Time duration
 
 double
 InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, uint16_t channelWidth,
-                                         NiChangesPerBand *nis, WifiSpectrumBand band,
+                                         const EventNiChanges &nis, WifiSpectrumBand band,
                                          uint16_t staId, std::pair<Time, Time> window) const
 {
   NS_LOG_FUNCTION (this << channelWidth << band.first << band.second << staId << window.first << window.second);
   double psr = 1.0; /* Packet Success Rate */
-  auto niIt = nis->find (band)->second;
-  auto j = niIt.begin ();
-  Time previous = j->first;
+  const NiChanges &changes = *nis.changes;
+  std::size_t j = nis.first;
+  Time previous = changes.times[j];
   WifiMode payloadMode = event->GetTxVector ().GetMode (staId);
-  Time phyPayloadStart = j->first;
-  if (event->GetPpdu ()->GetType () != WIFI_PPDU_TYPE_UL_MU) //j->first corresponds to the start of the UL-OFDMA payload
+  Time phyPayloadStart = changes.times[j];
+  if (event->GetPpdu ()->GetType () != WIFI_PPDU_TYPE_UL_MU) //changes.times[j] corresponds to the start of the UL-OFDMA payload
     {
-      phyPayloadStart = j->first + WifiPhy::CalculatePhyPreambleAndHeaderDuration (event->GetTxVector ());
+      phyPayloadStart = changes.times[j] + WifiPhy::CalculatePhyPreambleAndHeaderDuration (event->GetTxVector ());
     }
   Time windowStart = phyPayloadStart + window.first;
   Time windowEnd = phyPayloadStart + window.second;
-  double noiseInterferenceW = m_firstPowerPerBand.find (band)->second;
+  double noiseInterferenceW = changes.firstPower;
   double powerW = event->GetRxPowerW (band);
-  while (++j != niIt.end ())
+  uint8_t nss = event->GetTxVector ().GetNss (staId);
+  while (++j <= nis.last)
     {
-      Time current = j->first;
+      Time current = changes.times[j];
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
-      double snr = CalculateSnr (powerW, noiseInterferenceW, channelWidth, event->GetTxVector ().GetNss (staId));
+      double snr = CalculateSnr (powerW, noiseInterferenceW, channelWidth, nss);
       //Case 1: Both previous and current point to the windowed payload
       if (previous >= windowStart)
         {
@@ -453,8 +459,8 @@ InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, uint16_t channe
           psr *= CalculatePayloadChunkSuccessRate (snr, Min (windowEnd, current) - windowStart, event->GetTxVector (), staId);
           NS_LOG_DEBUG ("previous is before windowed payload and current is in the windowed payload: mode=" << payloadMode << ", psr=" << psr);
         }
-      noiseInterferenceW = j->second.GetPower () - powerW;
-      previous = j->first;
+      noiseInterferenceW = changes.powers[j] - powerW;
+      previous = changes.times[j];
       if (previous > windowEnd)
         {
           NS_LOG_DEBUG ("Stop: new previous=" << previous << " after time window end=" << windowEnd);
@@ -466,14 +472,14 @@ InterferenceHelper::CalculatePayloadPer (Ptr<const Event> event, uint16_t channe
 }
 
 double
-InterferenceHelper::CalculatePhyHeaderSectionPsr (Ptr<const Event> event, NiChangesPerBand *nis,
+InterferenceHelper::CalculatePhyHeaderSectionPsr (Ptr<const Event> event, const EventNiChanges &nis,
                                                   uint16_t channelWidth, WifiSpectrumBand band,
                                                   PhyEntity::PhyHeaderSections phyHeaderSections) const
 {
   NS_LOG_FUNCTION (this << band.first << band.second);
   double psr = 1.0; /* Packet Success Rate */
-  auto niIt = nis->find (band)->second;
-  auto j = niIt.begin ();
+  const NiChanges &changes = *nis.changes;
+  std::size_t j = nis.first;
 
   NS_ASSERT (!phyHeaderSections.empty ());
   Time stopLastSection = Seconds (0);
@@ -482,12 +488,12 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr (Ptr<const Event> event, NiChan
       stopLastSection = Max (stopLastSection, section.second.first.second);
     }
 
-  Time previous = j->first;
-  double noiseInterferenceW = m_firstPowerPerBand.find (band)->second;
+  Time previous = changes.times[j];
+  double noiseInterferenceW = changes.firstPower;
   double powerW = event->GetRxPowerW (band);
-  while (++j != niIt.end ())
+  while (++j <= nis.last)
     {
-      Time current = j->first;
+      Time current = changes.times[j];
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
       double snr = CalculateSnr (powerW, noiseInterferenceW, channelWidth, 1);
@@ -507,8 +513,8 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr (Ptr<const Event> event, NiChan
                 }
             }
         }
-      noiseInterferenceW = j->second.GetPower () - powerW;
-      previous = j->first;
+      noiseInterferenceW = changes.powers[j] - powerW;
+      previous = changes.times[j];
       if (previous > stopLastSection)
         {
           NS_LOG_DEBUG ("Stop: new previous=" << previous << " after stop of last section=" << stopLastSection);
@@ -519,16 +525,15 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr (Ptr<const Event> event, NiChan
 }
 
 double
-InterferenceHelper::CalculatePhyHeaderPer (Ptr<const Event> event, NiChangesPerBand *nis,
+InterferenceHelper::CalculatePhyHeaderPer (Ptr<const Event> event, const EventNiChanges &nis,
                                            uint16_t channelWidth, WifiSpectrumBand band,
                                            WifiPpduField header) const
 {
   NS_LOG_FUNCTION (this << band.first << band.second << header);
-  auto niIt = nis->find (band)->second;
   auto phyEntity = WifiPhy::GetStaticPhyEntity (event->GetTxVector ().GetModulationClass ());
 
   PhyEntity::PhyHeaderSections sections;
-  for (const auto & section : phyEntity->GetPhyHeaderSections (event->GetTxVector (), niIt.begin ()->first))
+  for (const auto & section : phyEntity->GetPhyHeaderSections (event->GetTxVector (), nis.changes->times[nis.first]))
     {
       if (section.first == header)
         {
@@ -549,7 +554,7 @@ InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, uint16_t channelWi
                                             uint16_t staId, std::pair<Time, Time> relativeMpduStartStop) const
 {
   NS_LOG_FUNCTION (this << channelWidth << band.first << band.second << staId << relativeMpduStartStop.first << relativeMpduStartStop.second);
-  NiChangesPerBand ni;
+  EventNiChanges ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni, band);
   double snr = CalculateSnr (event->GetRxPowerW (band),
                              noiseInterferenceW,
@@ -559,7 +564,7 @@ InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, uint16_t channelWi
   /* calculate the SNIR at the start of the MPDU (located through windowing) and accumulate
    * all SNIR changes in the SNIR vector.
    */
-  double per = CalculatePayloadPer (event, channelWidth, &ni, band, staId, relativeMpduStartStop);
+  double per = CalculatePayloadPer (event, channelWidth, ni, band, staId, relativeMpduStartStop);
 
   return PhyEntity::SnrPer (snr, per);
 }
@@ -567,7 +572,7 @@ InterferenceHelper::CalculatePayloadSnrPer (Ptr<Event> event, uint16_t channelWi
 double
 InterferenceHelper::CalculateSnr (Ptr<Event> event, uint16_t channelWidth, uint8_t nss, WifiSpectrumBand band) const
 {
-  NiChangesPerBand ni;
+  EventNiChanges ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni, band);
   double snr = CalculateSnr (event->GetRxPowerW (band),
                              noiseInterferenceW,
@@ -581,7 +586,7 @@ InterferenceHelper::CalculatePhyHeaderSnrPer (Ptr<Event> event, uint16_t channel
                                               WifiPpduField header) const
 {
   NS_LOG_FUNCTION (this << band.first << band.second << header);
-  NiChangesPerBand ni;
+  EventNiChanges ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni, band);
   double snr = CalculateSnr (event->GetRxPowerW (band),
                              noiseInterferenceW,
@@ -591,44 +596,148 @@ InterferenceHelper::CalculatePhyHeaderSnrPer (Ptr<Event> event, uint16_t channel
   /* calculate the SNIR at the start of the PHY header and accumulate
    * all SNIR changes in the SNIR vector.
    */
-  double per = CalculatePhyHeaderPer (event, &ni, channelWidth, band, header);
+  double per = CalculatePhyHeaderPer (event, ni, channelWidth, band, header);
   
   return PhyEntity::SnrPer (snr, per);
 }
 
+double
+InterferenceHelper::CalculateEffectiveSnr (Ptr<const Event> event, const EventNiChanges &nis, uint16_t channelWidth,
+                                           uint8_t nss, WifiSpectrumBand band, WifiMode mode, Time start, Time stop) const
+{
+  NS_LOG_FUNCTION (this << channelWidth << +nss << band.first << band.second << mode << start << stop);
+  NS_ASSERT (stop > start);
+  uint16_t constellationSize = mode.GetConstellationSize ();
+  double beta = (constellationSize <= 2) ? 1.0 : 2.0 * (constellationSize - 1) / 3.0;
+  const NiChanges &changes = *nis.changes;
+  double noiseInterferenceW = changes.firstPower;
+  double powerW = event->GetRxPowerW (band);
+  double windowDuration = (stop - start).GetSeconds ();
+  //The sum is kept relative to the smallest SNR, so that the exponentials do not underflow
+  double minSnr = 0.0;
+  double sum = 0.0;
+  Time previous = changes.times[nis.first];
+  for (std::size_t j = nis.first + 1; j <= nis.last && previous < stop; ++j)
+    {
+      Time current = changes.times[j];
+      Time duration = Min (current, stop) - Max (previous, start);
+      if (duration.IsStrictlyPositive ())
+        {
+          double snr = CalculateSnr (powerW, noiseInterferenceW, channelWidth, nss);
+          double weight = duration.GetSeconds () / windowDuration;
+          if (sum == 0.0)
+            {
+              minSnr = snr;
+              sum = weight;
+            }
+          else if (snr < minSnr)
+            {
+              sum = sum * std::exp ((snr - minSnr) / beta) + weight;
+              minSnr = snr;
+            }
+          else
+            {
+              sum += weight * std::exp ((minSnr - snr) / beta);
+            }
+        }
+      noiseInterferenceW = changes.powers[j] - powerW;
+      previous = current;
+    }
+  NS_ASSERT (sum > 0.0);
+  double snr = minSnr - beta * std::log (sum);
+  NS_LOG_DEBUG ("mode=" << mode << ", beta=" << beta << ", effective SNR(dB)=" << RatioToDb (snr));
+  return snr;
+}
+
+double
+InterferenceHelper::CalculatePayloadEffectiveSnr (Ptr<Event> event, uint16_t channelWidth, WifiSpectrumBand band,
+                                                  uint16_t staId) const
+{
+  NS_LOG_FUNCTION (this << channelWidth << band.first << band.second << staId);
+  EventNiChanges ni;
+  CalculateNoiseInterferenceW (event, &ni, band);
+  const WifiTxVector& txVector = event->GetTxVector ();
+  Time payloadStart = event->GetStartTime ();
+  if (event->GetPpdu ()->GetType () != WIFI_PPDU_TYPE_UL_MU) //the event of a HE TB PPDU starts with the UL-OFDMA payload
+    {
+      payloadStart += WifiPhy::CalculatePhyPreambleAndHeaderDuration (txVector);
+    }
+  return CalculateEffectiveSnr (event, ni, channelWidth, txVector.GetNss (staId), band,
+                                txVector.GetMode (staId), payloadStart, event->GetEndTime ());
+}
+
+double
+InterferenceHelper::CalculateMpduPer (double snr, uint32_t size, const WifiTxVector& txVector, uint16_t staId) const
+{
+  NS_LOG_FUNCTION (this << snr << size << staId);
+  uint64_t nbits = static_cast<uint64_t> (size) * 8;
+  nbits /= txVector.GetNss (staId); //divide effective number of bits by NSS to achieve same chunk error rate as SISO for AWGN
+  double csr = m_errorRateModel->GetChunkSuccessRate (txVector.GetMode (staId), txVector, snr, nbits, m_numRxAntennas,
+                                                      WIFI_PPDU_FIELD_DATA, staId);
+  return 1 - csr;
+}
+
+struct PhyEntity::SnrPer
+InterferenceHelper::CalculatePhyHeaderEffectiveSnrPer (Ptr<Event> event, uint16_t channelWidth,
+                                                       WifiSpectrumBand band) const
+{
+  NS_LOG_FUNCTION (this << channelWidth << band.first << band.second);
+  EventNiChanges ni;
+  CalculateNoiseInterferenceW (event, &ni, band);
+  const WifiTxVector& txVector = event->GetTxVector ();
+  auto phyEntity = WifiPhy::GetStaticPhyEntity (txVector.GetModulationClass ());
+  double psr = 1.0;
+  double snr = 0.0;
+  bool first = true;
+  for (const auto & section : phyEntity->GetPhyHeaderSections (txVector, event->GetStartTime ()))
+    {
+      //the preamble and training fields are not decoded
+      if (section.first == WIFI_PPDU_FIELD_PREAMBLE || section.first == WIFI_PPDU_FIELD_TRAINING)
+        {
+          continue;
+        }
+      Time start = section.second.first.first;
+      Time stop = section.second.first.second;
+      if (stop <= start)
+        {
+          continue;
+        }
+      double sectionSnr = CalculateEffectiveSnr (event, ni, channelWidth, 1, band, section.second.second, start, stop);
+      psr *= CalculateChunkSuccessRate (sectionSnr, stop - start, section.second.second, txVector, section.first);
+      NS_LOG_DEBUG (section.first << ": effective SNR(dB)=" << RatioToDb (sectionSnr) << ", psr=" << psr);
+      if (first)
+        {
+          snr = sectionSnr;
+          first = false;
+        }
+    }
+  return PhyEntity::SnrPer (snr, 1 - psr);
+}
+
 void
 InterferenceHelper::EraseEvents (void)
 {
   for (auto niIt = m_niChangesPerBand.begin(); niIt != m_niChangesPerBand.end(); ++niIt)
     {
-      niIt->second.clear ();
-      // Always have a zero power noise event in the list
-      AddNiChangeEvent (Time (0), NiChange (0.0, 0), niIt);
-      m_firstPowerPerBand.at (niIt->first) = 0.0;
+      niIt->second.Reset ();
     }
   m_rxing = false;
 }
 
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetNextPosition (Time moment, NiChangesPerBand::iterator niIt)
+std::size_t
+InterferenceHelper::GetNextPosition (Time moment, const NiChanges &changes)
 {
-  return niIt->second.upper_bound (moment);
+  return std::upper_bound (changes.times.begin (), changes.times.end (), moment) - changes.times.begin ();
 }
 
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetPreviousPosition (Time moment, NiChangesPerBand::iterator niIt)
+std::size_t
+InterferenceHelper::GetPreviousPosition (Time moment, const NiChanges &changes)
 {
-  auto it = GetNextPosition (moment, niIt);
+  std::size_t index = GetNextPosition (moment, changes);
   // This is safe since there is always an NiChange at time 0,
   // before moment.
-  --it;
-  return it;
-}
-
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::AddNiChangeEvent (Time moment, NiChange change, NiChangesPerBand::iterator niIt)
-{
-  return niIt->second.insert (GetNextPosition (moment, niIt), std::make_pair (moment, change));
+  NS_ASSERT (index > 0);
+  return index - 1;
 }
 
 void
@@ -643,13 +752,14 @@ InterferenceHelper::NotifyRxEnd (Time endTime)
 {
   NS_LOG_FUNCTION (this << endTime);
   m_rxing = false;
-  //Update m_firstPowerPerBand for frame capture
+  //Update the first power of each band for frame capture
   for (auto niIt = m_niChangesPerBand.begin(); niIt != m_niChangesPerBand.end(); ++niIt)
     {
-      NS_ASSERT (niIt->second.size () > 1);
-      auto it = GetPreviousPosition (endTime, niIt);
-      it--;
-      m_firstPowerPerBand.find (niIt->first)->second = it->second.GetPower ();
+      NiChanges &changes = niIt->second;
+      NS_ASSERT (changes.GetSize () > 1);
+      std::size_t index = GetPreviousPosition (endTime, changes);
+      NS_ASSERT (index > 0);
+      changes.firstPower = changes.powers[index - 1];
     }
 }
 
@@ -21,6 +21,7 @@
 #ifndef INTERFERENCE_HELPER_H
 #define INTERFERENCE_HELPER_H
 
+#include <vector>
 #include "phy-entity.h"
 
 namespace ns3 {
@@ -245,6 +246,47 @@ public:
   struct PhyEntity::SnrPer CalculatePhyHeaderSnrPer (Ptr<Event> event, uint16_t channelWidth, WifiSpectrumBand band,
                                                               WifiPpduField header) const;
 
+  /**
+   * Calculate the effective SNR of the PHY payload of the event, from the SNIR
+   * of each of its chunks of constant interference, with the exponential
+   * effective SINR mapping (EESM).  This is used when the reception is
+   * abstracted (see the AbstractedReception attribute of WifiPhy).
+   *
+   * \param event the event corresponding to the first time the corresponding PPDU arrives
+   * \param channelWidth the channel width used to transmit the PSDU (in MHz)
+   * \param band identify the band used by the PSDU
+   * \param staId the station ID of the PSDU (only used for MU)
+   *
+   * \return the effective SNR of the PHY payload in linear scale
+   */
+  double CalculatePayloadEffectiveSnr (Ptr<Event> event, uint16_t channelWidth, WifiSpectrumBand band,
+                                       uint16_t staId) const;
+  /**
+   * Calculate the error rate of an MPDU received at a constant SNR, such as
+   * the effective SNR of the PHY payload.
+   *
+   * \param snr the SNR in linear scale
+   * \param size the size of the MPDU in bytes
+   * \param txVector the TXVECTOR of the PPDU
+   * \param staId the station ID of the PSDU (only used for MU)
+   *
+   * \return the error rate of the MPDU
+   */
+  double CalculateMpduPer (double snr, uint32_t size, const WifiTxVector& txVector, uint16_t staId) const;
+  /**
+   * Calculate the effective SNR of each PHY header field of the event with
+   * the exponential effective SINR mapping (EESM), and the error rate of the
+   * PHY header at these effective SNRs.
+   *
+   * \param event the event corresponding to the first time the corresponding PPDU arrives
+   * \param channelWidth the channel width (in MHz) for header measurement
+   * \param band identify the band used by the PSDU
+   *
+   * \return struct of SNR (the effective SNR of the first PHY header field) and PER
+   */
+  struct PhyEntity::SnrPer CalculatePhyHeaderEffectiveSnrPer (Ptr<Event> event, uint16_t channelWidth,
+                                                              WifiSpectrumBand band) const;
+
   /**
    * Notify that RX has started.
    */
@@ -309,53 +351,70 @@ protected:
 
 private:
   /**
-   * Noise and Interference (thus Ni) event.
+   * The noise and interference (thus Ni) changes of a band, sorted by time.
+   * Each change stores the power in watts after the change and the event
+   * causing it; the first change is a zero power change at time 0.  The
+   * changes are kept in a structure of arrays, so that the loops adding
+   * the power of an event to the changes it overlaps run on contiguous
+   * memory and can be vectorized by the compiler.
    */
-  class NiChange
+  struct NiChanges
   {
-public:
+    std::vector<Time> times;           //!< the times of the changes
+    std::vector<double> powers;        //!< the powers after the changes in watts
+    std::vector<Ptr<Event> > events;   //!< the events causing the changes
+    double firstPower;                 //!< the power in watts at the start of the event being received
+
     /**
-     * Create a NiChange at the given time and the amount of NI change.
-     *
-     * \param power the power in watts
-     * \param event causes this NI change
+     * \return the number of changes
      */
-    NiChange (double power, Ptr<Event> event);
-    ~NiChange ();
+    std::size_t GetSize (void) const;
     /**
-     * Return the power
+     * Insert a change after the changes at the same time.
      *
-     * \return the power in watts
+     * \param moment the time of the change
+     * \param power the power after the change in watts
+     * \param event the event causing the change
+     * \return the index of the change
      */
-    double GetPower (void) const;
+    std::size_t Insert (Time moment, double power, Ptr<Event> event);
     /**
-     * Add a given amount of power.
+     * Erase the changes in a range.
      *
-     * \param power the power to be added to the existing value in watts
+     * \param first the index of the first change to erase
+     * \param last the index after the last change to erase
      */
-    void AddPower (double power);
+    void Erase (std::size_t first, std::size_t last);
     /**
-     * Return the event causes the corresponding NI change
+     * Add a power to the changes in a range.
      *
-     * \return the event
+     * \param first the index of the first change
+     * \param last the index after the last change
+     * \param power the power to add in watts
      */
-    Ptr<Event> GetEvent (void) const;
-
-
-private:
-    double m_power; ///< power in watts
-    Ptr<Event> m_event; ///< event
+    void AddPower (std::size_t first, std::size_t last, double power);
+    /**
+     * Remove all the changes, but the zero power change at time 0.
+     */
+    void Reset (void);
   };
 
   /**
-   * typedef for a multimap of NiChange
+   * Map of NiChanges per band
    */
-  typedef std::multimap<Time, NiChange> NiChanges;
+  typedef std::map <WifiSpectrumBand, NiChanges> NiChangesPerBand;
 
   /**
-   * Map of NiChanges per band
+   * The changes of a band during the reception of an event, which are not
+   * copied: the changes with indices in ]first, last[ occur between the
+   * start of the event and its end, at index last.
    */
-  typedef std::map <WifiSpectrumBand, NiChanges> NiChangesPerBand;
+  struct EventNiChanges
+  {
+    const NiChanges *changes; //!< the changes of the band
+    std::size_t first;        //!< the index of the start of the event
+    std::size_t last;         //!< the index of the end of the event
+  };
 
   /**
    * Append the given Event.
@@ -369,12 +428,12 @@ private:
    * Calculate noise and interference power in W.
    *
    * \param event the event
-   * \param nis the NiChanges
+   * \param nis the NiChanges during the event, set by this method
    * \param band the band
    *
    * \return noise and interference power
    */
-  double CalculateNoiseInterferenceW (Ptr<Event> event, NiChangesPerBand *nis, WifiSpectrumBand band) const;
+  double CalculateNoiseInterferenceW (Ptr<Event> event, EventNiChanges *nis, WifiSpectrumBand band) const;
   /**
    * Calculate the error rate of the given PHY payload only in the provided time
    * window (thus enabling per MPDU PER information). The PHY payload can be divided into
@@ -382,79 +441,90 @@ private:
    *
    * \param event the event
    * \param channelWidth the channel width used to transmit the PSDU (in MHz)
-   * \param nis the NiChanges
+   * \param nis the NiChanges during the event
    * \param band identify the band used by the PSDU
    * \param staId the station ID of the PSDU (only used for MU)
    * \param window time window (pair of start and end times) of PHY payload to focus on
    *
    * \return the error rate of the payload
    */
-  double CalculatePayloadPer (Ptr<const Event> event, uint16_t channelWidth, NiChangesPerBand *nis, WifiSpectrumBand band,
+  double CalculatePayloadPer (Ptr<const Event> event, uint16_t channelWidth, const EventNiChanges &nis, WifiSpectrumBand band,
                               uint16_t staId, std::pair<Time, Time> window) const;
   /**
    * Calculate the error rate of the PHY header. The PHY header
    * can be divided into multiple chunks (e.g. due to interference from other transmissions).
    *
    * \param event the event
-   * \param nis the NiChanges
+   * \param nis the NiChanges during the event
    * \param channelWidth the channel width (in MHz) for header measurement
    * \param band the band
    * \param header the PHY header to consider
    *
    * \return the error rate of the HT PHY header
    */
-  double CalculatePhyHeaderPer (Ptr<const Event> event, NiChangesPerBand *nis,
+  double CalculatePhyHeaderPer (Ptr<const Event> event, const EventNiChanges &nis,
                                 uint16_t channelWidth, WifiSpectrumBand band,
                                 WifiPpduField header) const;
   /**
    * Calculate the success rate of the PHY header sections for the provided event.
    *
    * \param event the event
-   * \param nis the NiChanges
+   * \param nis the NiChanges during the event
    * \param channelWidth the channel width (in MHz) for header measurement
    * \param band the band
    * \param phyHeaderSections the map of PHY header sections (\see PhyEntity::PhyHeaderSections)
    *
    * \return the success rate of the PHY header sections
    */
-  double CalculatePhyHeaderSectionPsr (Ptr<const Event> event, NiChangesPerBand *nis,
+  double CalculatePhyHeaderSectionPsr (Ptr<const Event> event, const EventNiChanges &nis,
                                        uint16_t channelWidth, WifiSpectrumBand band,
                                        PhyEntity::PhyHeaderSections phyHeaderSections) const;
 
+  /**
+   * Calculate the effective SNR of a time window of the event with the
+   * exponential effective SINR mapping (EESM):
+   * SNR_eff = -beta ln (sum_k w_k exp (-SNR_k / beta)), where SNR_k is the SNIR
+   * of the k-th chunk of constant interference of the window and w_k its share
+   * of the window.  beta is the value given by the Chernoff bound of the error
+   * rate of the constellation of the mode: 1 for BPSK and 2 (M - 1) / 3 for
+   * M-QAM (e.g. 2 for QPSK, 10 for 16-QAM).
+   *
+   * \param event the event
+   * \param nis the NiChanges during the event
+   * \param channelWidth the channel width (in MHz)
+   * \param nss the number of spatial streams
+   * \param band the band
+   * \param mode the mode of the window
+   * \param start the start of the window
+   * \param stop the end of the window
+   *
+   * \return the effective SNR in linear scale
+   */
+  double CalculateEffectiveSnr (Ptr<const Event> event, const EventNiChanges &nis, uint16_t channelWidth,
+                                uint8_t nss, WifiSpectrumBand band, WifiMode mode, Time start, Time stop) const;
+
   double m_noiseFigure;                                    //!< noise figure (linear)
   Ptr<ErrorRateModel> m_errorRateModel;                    //!< error rate model
   uint8_t m_numRxAntennas;                                 //!< the number of RX antennas in the corresponding receiver
   NiChangesPerBand m_niChangesPerBand;                     //!< NI Changes for each band
-  std::map <WifiSpectrumBand, double> m_firstPowerPerBand; //!< first power of each band in watts
   bool m_rxing;                                            //!< flag whether it is in receiving state
 
   /**
-   * Returns an iterator to the first NiChange that is later than moment
-   *
-   * \param moment time to check from
-   * \param niIt iterator of the band to check
-   * \returns an iterator to the list of NiChanges
-   */
-  NiChanges::iterator GetNextPosition (Time moment, NiChangesPerBand::iterator niIt);
-  /**
-   * Returns an iterator to the last NiChange that is before than moment
+   * Returns the index of the first NiChange that is later than moment
    *
    * \param moment time to check from
-   * \param niIt iterator of the band to check
-   * \returns an iterator to the list of NiChanges
+   * \param changes the changes of the band to check
+   * \returns the index of the change
    */
-  NiChanges::iterator GetPreviousPosition (Time moment, NiChangesPerBand::iterator niIt);
-
+  static std::size_t GetNextPosition (Time moment, const NiChanges &changes);
   /**
-   * Add NiChange to the list at the appropriate position and
-   * return the iterator of the new event.
+   * Returns the index of the last NiChange that is before than moment
    *
    * \param moment time to check from
-   * \param change the NiChange to add
-   * \param niIt iterator of the band to check
-   * \returns the iterator of the new event
+   * \param changes the changes of the band to check
+   * \returns the index of the change
    */
-  NiChanges::iterator AddNiChangeEvent (Time moment, NiChange change, NiChangesPerBand::iterator niIt);
+  static std::size_t GetPreviousPosition (Time moment, const NiChanges &changes);
 };
 
 } //namespace ns3
@@ -0,0 +1,535 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+#include "multi-link-scheduler.h"
+#include "regular-wifi-mac.h"
+#include "ap-wifi-mac.h"
+#include "wifi-mac-queue.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MultiLinkScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (MultiLinkSequenceTag);
+
+TypeId
+MultiLinkSequenceTag::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultiLinkSequenceTag")
+    .SetParent<Tag> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<MultiLinkSequenceTag> ()
+  ;
+  return tid;
+}
+
+TypeId
+MultiLinkSequenceTag::GetInstanceTypeId (void) const
+{
+  return GetTypeId ();
+}
+
+MultiLinkSequenceTag::MultiLinkSequenceTag ()
+  : m_tid (0),
+    m_sequenceNumber (0)
+{
+}
+
+uint32_t
+MultiLinkSequenceTag::GetSerializedSize (void) const
+{
+  return 6 + 6 + 1 + 8;
+}
+
+void
+MultiLinkSequenceTag::Serialize (TagBuffer i) const
+{
+  uint8_t buffer[6];
+  m_transmitter.CopyTo (buffer);
+  i.Write (buffer, 6);
+  m_receiver.CopyTo (buffer);
+  i.Write (buffer, 6);
+  i.WriteU8 (m_tid);
+  i.WriteU64 (m_sequenceNumber);
+}
+
+void
+MultiLinkSequenceTag::Deserialize (TagBuffer i)
+{
+  uint8_t buffer[6];
+  i.Read (buffer, 6);
+  m_transmitter.CopyFrom (buffer);
+  i.Read (buffer, 6);
+  m_receiver.CopyFrom (buffer);
+  m_tid = i.ReadU8 ();
+  m_sequenceNumber = i.ReadU64 ();
+}
+
+void
+MultiLinkSequenceTag::Print (std::ostream &os) const
+{
+  os << "Transmitter=" << m_transmitter << " Receiver=" << m_receiver
+     << " Tid=" << +m_tid << " SequenceNumber=" << m_sequenceNumber;
+}
+
+void
+MultiLinkSequenceTag::SetTransmitter (Mac48Address transmitter)
+{
+  m_transmitter = transmitter;
+}
+
+Mac48Address
+MultiLinkSequenceTag::GetTransmitter (void) const
+{
+  return m_transmitter;
+}
+
+void
+MultiLinkSequenceTag::SetReceiver (Mac48Address receiver)
+{
+  m_receiver = receiver;
+}
+
+Mac48Address
+MultiLinkSequenceTag::GetReceiver (void) const
+{
+  return m_receiver;
+}
+
+void
+MultiLinkSequenceTag::SetTid (uint8_t tid)
+{
+  m_tid = tid;
+}
+
+uint8_t
+MultiLinkSequenceTag::GetTid (void) const
+{
+  return m_tid;
+}
+
+void
+MultiLinkSequenceTag::SetSequenceNumber (uint64_t sequenceNumber)
+{
+  m_sequenceNumber = sequenceNumber;
+}
+
+uint64_t
+MultiLinkSequenceTag::GetSequenceNumber (void) const
+{
+  return m_sequenceNumber;
+}
+
+
+NS_OBJECT_ENSURE_REGISTERED (MultiLinkScheduler);
+
+TypeId
+MultiLinkScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultiLinkScheduler")
+    .SetParent<Object> ()
+    .SetGroupName ("Wifi")
+    .AddConstructor<MultiLinkScheduler> ()
+    .AddAttribute ("MaxLinkQueueBytes",
+                   "No packet is handed to a link whose queue for the Access Category "
+                   "of the packet holds this number of bytes or more (including the "
+                   "MPDUs in flight). The packets wait in the queue of the multi-link "
+                   "device until a link has room for them.",
+                   UintegerValue (131072),
+                   MakeUintegerAccessor (&MultiLinkScheduler::m_maxLinkQueueBytes),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("ReorderTimeout",
+                   "The time a received unicast packet waits for a packet sent "
+                   "before it on another link. Once it expires, the packets "
+                   "received after the missing one are passed up without it.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&MultiLinkScheduler::m_reorderTimeout),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+MultiLinkScheduler::MultiLinkScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+  for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+    {
+      m_queues[ac] = CreateObject<WifiMacQueue> (ac);
+      m_queues[ac]->TraceConnectWithoutContext ("Expired",
+                                                MakeCallback (&MultiLinkScheduler::NotifyDrop, this));
+    }
+}
+
+MultiLinkScheduler::~MultiLinkScheduler ()
+{
+  NS_LOG_FUNCTION_NOARGS ();
+}
+
+void
+MultiLinkScheduler::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (auto& event : m_dispatchEvents)
+    {
+      event.second.Cancel ();
+    }
+  for (auto& buffer : m_reorderBuffers)
+    {
+      buffer.second.timeout.Cancel ();
+    }
+  m_reorderBuffers.clear ();
+  m_forwardUp = MakeNullCallback<void, Ptr<const Packet>, Mac48Address, Mac48Address> ();
+  for (auto& queue : m_queues)
+    {
+      queue.second->Dispose ();
+      queue.second = 0;
+    }
+  m_links.clear ();
+  Object::DoDispose ();
+}
+
+void
+MultiLinkScheduler::AddLink (Ptr<RegularWifiMac> mac)
+{
+  NS_LOG_FUNCTION (this << mac);
+  NS_ABORT_MSG_IF (mac == 0 || !mac->GetQosSupported (),
+                   "The MACs of a multi-link device must support QoS");
+  NS_ABORT_MSG_IF (m_links.size () == 255, "Too many links");
+
+  for (auto ac : {AC_BE, AC_BK, AC_VI, AC_VO})
+    {
+      mac->GetQosTxop (ac)->GetWifiMacQueue ()
+        ->TraceConnectWithoutContext ("Dequeue",
+                                      MakeCallback (&MultiLinkScheduler::NotifyLinkQueueRemoval, this)
+                                      .Bind (ac));
+      m_nPacketsToLink[ac].push_back (0);
+    }
+  m_links.push_back (mac);
+}
+
+uint8_t
+MultiLinkScheduler::GetNLinks (void) const
+{
+  return static_cast<uint8_t> (m_links.size ());
+}
+
+void
+MultiLinkScheduler::SetForwardUpCallback (WifiMac::ForwardUpCallback upCallback)
+{
+  NS_LOG_FUNCTION (this);
+  m_forwardUp = upCallback;
+}
+
+Ptr<WifiMacQueue>
+MultiLinkScheduler::GetQueue (AcIndex ac) const
+{
+  auto it = m_queues.find (ac);
+  NS_ASSERT (it != m_queues.end ());
+  return it->second;
+}
+
+uint64_t
+MultiLinkScheduler::GetNPacketsToLink (AcIndex ac, uint8_t linkId) const
+{
+  auto it = m_nPacketsToLink.find (ac);
+  NS_ASSERT (it != m_nPacketsToLink.end () && linkId < it->second.size ());
+  return it->second[linkId];
+}
+
+void
+MultiLinkScheduler::Enqueue (Ptr<Packet> packet, Mac48Address to, Mac48Address from)
+{
+  NS_LOG_FUNCTION (this << packet << to << from);
+  NS_ASSERT (!m_links.empty ());
+
+  uint8_t tid = QosUtilsGetTidForPacket (packet);
+  //Any value greater than 7 is invalid and likely indicates that
+  //the packet had no QoS tag, so we revert to zero, which will
+  //mean that AC_BE is used.
+  if (tid > 7)
+    {
+      tid = 0;
+    }
+
+  //The header only records the destination, source and TID of the
+  //packet until it is handed to the MAC of a link
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (tid);
+  hdr.SetAddr1 (to);
+  hdr.SetAddr2 (from);
+
+  AcIndex ac = QosUtilsMapTidToAc (tid);
+  Ptr<WifiMacQueueItem> item = Create<WifiMacQueueItem> (packet, hdr);
+  if (!m_queues[ac]->Enqueue (item))
+    {
+      NS_LOG_DEBUG ("MLD queue full, dropping " << *item);
+      NotifyDrop (item);
+      return;
+    }
+  Dispatch (ac);
+}
+
+bool
+MultiLinkScheduler::SelectLinks (Ptr<const WifiMacQueueItem> item, std::vector<uint8_t> &linkIds) const
+{
+  NS_LOG_FUNCTION (this << *item);
+  Mac48Address to = item->GetHeader ().GetAddr1 ();
+  AcIndex ac = QosUtilsMapTidToAc (item->GetHeader ().GetQosTid ());
+  linkIds.clear ();
+
+  if (to.IsGroup ())
+    {
+      for (uint8_t id = 0; id < m_links.size (); id++)
+        {
+          if (!m_links[id]->CanForwardPacketsTo (to))
+            {
+              continue;
+            }
+          Ptr<ApWifiMac> ap = DynamicCast<ApWifiMac> (m_links[id]);
+          if (ap == 0)
+            {
+              //a single copy is sent to the AP, which receives it on any link
+              linkIds.push_back (id);
+              break;
+            }
+          if (!ap->GetStaList ().empty ())
+            {
+              linkIds.push_back (id);
+            }
+        }
+      if (linkIds.empty ())
+        {
+          //no STA is associated, or no link can forward the packet
+          linkIds.push_back (0);
+          return true;
+        }
+      //the copies are handed at once, so that the packets keep their order
+      //on every link
+      for (auto id : linkIds)
+        {
+          if (m_links[id]->GetQosTxop (ac)->GetWifiMacQueue ()->GetNBytes () >= m_maxLinkQueueBytes)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+
+  bool canForward = false;
+  uint32_t minBytes = 0;
+  for (uint8_t id = 0; id < m_links.size (); id++)
+    {
+      if (!m_links[id]->CanForwardPacketsTo (to))
+        {
+          continue;
+        }
+      uint32_t bytes = m_links[id]->GetQosTxop (ac)->GetWifiMacQueue ()->GetNBytes ();
+      NS_LOG_DEBUG ("Link " << +id << ": " << bytes << " bytes queued");
+      if (bytes < m_maxLinkQueueBytes && (linkIds.empty () || bytes < minBytes))
+        {
+          minBytes = bytes;
+          linkIds.assign (1, id);
+        }
+      canForward = true;
+    }
+
+  if (!canForward)
+    {
+      //let the MAC of the first link handle the packet (e.g., a non-AP STA
+      //drops it and tries to associate)
+      linkIds.push_back (0);
+      return true;
+    }
+  return !linkIds.empty ();
+}
+
+void
+MultiLinkScheduler::Dispatch (AcIndex ac)
+{
+  NS_LOG_FUNCTION (this << ac);
+  Ptr<WifiMacQueue> queue = m_queues[ac];
+  Ptr<const WifiMacQueueItem> peeked;
+  std::vector<uint8_t> linkIds;
+
+  while ((peeked = queue->Peek ()) != 0 && SelectLinks (peeked, linkIds))
+    {
+      Ptr<WifiMacQueueItem> item = queue->Dequeue ();
+      NS_ASSERT (item == peeked);
+      Mac48Address to = item->GetHeader ().GetAddr1 ();
+      Mac48Address from = item->GetHeader ().GetAddr2 ();
+      for (auto linkId : linkIds)
+        {
+          NS_LOG_DEBUG ("Handing " << *item << " to link " << +linkId);
+          m_nPacketsToLink[ac][linkId]++;
+
+          Ptr<RegularWifiMac> mac = m_links[linkId];
+          Ptr<Packet> packet = item->GetPacket ()->Copy ();
+          if (!to.IsGroup ())
+            {
+              //a non-AP STA sends its packets to the AP, whatever their destination
+              Mac48Address receiver = (mac->GetTypeOfStation () == STA ? mac->GetBssid () : to);
+              uint8_t tid = item->GetHeader ().GetQosTid ();
+              MultiLinkSequenceTag tag;
+              tag.SetTransmitter (mac->GetAddress ());
+              tag.SetReceiver (receiver);
+              tag.SetTid (tid);
+              tag.SetSequenceNumber (m_nextSequenceNumbers[{receiver, tid}]++);
+              packet->AddByteTag (tag);
+            }
+          if (from == mac->GetAddress ())
+            {
+              mac->Enqueue (packet, to);
+            }
+          else
+            {
+              mac->Enqueue (packet, to, from);
+            }
+        }
+    }
+}
+
+void
+MultiLinkScheduler::NotifyDrop (Ptr<const WifiMacQueueItem> item)
+{
+  NS_LOG_FUNCTION (this << *item);
+  if (!m_links.empty ())
+    {
+      m_links[0]->NotifyTxDrop (item->GetPacket ());
+    }
+}
+
+void
+MultiLinkScheduler::NotifyLinkQueueRemoval (AcIndex ac, Ptr<const WifiMacQueueItem> item)
+{
+  NS_LOG_FUNCTION (this << ac << *item);
+  //dispatch once the link has completed the operation removing the MPDU
+  if (!m_queues[ac]->IsEmpty () && !m_dispatchEvents[ac].IsRunning ())
+    {
+      m_dispatchEvents[ac] = Simulator::ScheduleNow (&MultiLinkScheduler::Dispatch, this, ac);
+    }
+}
+
+bool
+MultiLinkScheduler::FindSequenceTag (Ptr<const Packet> packet, MultiLinkSequenceTag &tag) const
+{
+  NS_LOG_FUNCTION (this << packet);
+  //a packet forwarded by several multi-link devices has a tag for each hop,
+  //the last one added being the one for this device
+  Mac48Address address = m_links[0]->GetAddress ();
+  TypeId tid = MultiLinkSequenceTag::GetTypeId ();
+  bool found = false;
+  ByteTagIterator it = packet->GetByteTagIterator ();
+  while (it.HasNext ())
+    {
+      ByteTagIterator::Item item = it.Next ();
+      if (item.GetTypeId () != tid)
+        {
+          continue;
+        }
+      MultiLinkSequenceTag candidate;
+      item.GetTag (candidate);
+      if (candidate.GetReceiver () == address)
+        {
+          tag = candidate;
+          found = true;
+        }
+    }
+  return found;
+}
+
+void
+MultiLinkScheduler::Receive (Ptr<const Packet> packet, Mac48Address from, Mac48Address to)
+{
+  NS_LOG_FUNCTION (this << packet << from << to);
+  NS_ASSERT (!m_links.empty ());
+
+  MultiLinkSequenceTag tag;
+  if (to.IsGroup () || !FindSequenceTag (packet, tag))
+    {
+      m_forwardUp (packet, from, to);
+      return;
+    }
+
+  WifiAddressTidPair key (tag.GetTransmitter (), tag.GetTid ());
+  ReorderBuffer &buffer = m_reorderBuffers[key];
+  uint64_t sequenceNumber = tag.GetSequenceNumber ();
+  if (sequenceNumber < buffer.nextSequenceNumber)
+    {
+      //the reorder timer expired before this packet was received
+      NS_LOG_DEBUG ("Late packet " << sequenceNumber << " from " << key.first
+                    << " TID " << +key.second);
+      m_forwardUp (packet, from, to);
+      return;
+    }
+  if (!buffer.packets.insert ({sequenceNumber, {packet, from, to}}).second)
+    {
+      NS_LOG_DEBUG ("Duplicate packet " << sequenceNumber << " from " << key.first
+                    << " TID " << +key.second);
+      return;
+    }
+  ForwardUpInOrder (key);
+}
+
+void
+MultiLinkScheduler::ForwardUpInOrder (WifiAddressTidPair key)
+{
+  NS_LOG_FUNCTION (this << key.first << +key.second);
+  ReorderBuffer &buffer = m_reorderBuffers[key];
+  uint64_t missing = buffer.nextSequenceNumber;
+
+  while (!buffer.packets.empty ()
+         && buffer.packets.begin ()->first == buffer.nextSequenceNumber)
+    {
+      BufferedPacket next = buffer.packets.begin ()->second;
+      buffer.packets.erase (buffer.packets.begin ());
+      buffer.nextSequenceNumber++;
+      m_forwardUp (next.packet, next.from, next.to);
+    }
+
+  if (buffer.packets.empty ())
+    {
+      buffer.timeout.Cancel ();
+    }
+  else if (buffer.nextSequenceNumber != missing || !buffer.timeout.IsRunning ())
+    {
+      //the timer measures how long the next missing packet has been awaited
+      NS_LOG_DEBUG ("Waiting for packet " << buffer.nextSequenceNumber << " from "
+                    << key.first << " TID " << +key.second);
+      buffer.timeout.Cancel ();
+      buffer.timeout = Simulator::Schedule (m_reorderTimeout, &MultiLinkScheduler::ReorderTimeout,
+                                            this, key);
+    }
+}
+
+void
+MultiLinkScheduler::ReorderTimeout (WifiAddressTidPair key)
+{
+  NS_LOG_FUNCTION (this << key.first << +key.second);
+  ReorderBuffer &buffer = m_reorderBuffers[key];
+  NS_ASSERT (!buffer.packets.empty ());
+  NS_LOG_DEBUG ("Packets " << buffer.nextSequenceNumber << " to "
+                << buffer.packets.begin ()->first - 1 << " from " << key.first
+                << " TID " << +key.second << " not received");
+  buffer.nextSequenceNumber = buffer.packets.begin ()->first;
+  ForwardUpInOrder (key);
+}
+
+} //namespace ns3
@@ -0,0 +1,303 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTI_LINK_SCHEDULER_H
+#define MULTI_LINK_SCHEDULER_H
+
+#include <map>
+#include <vector>
+#include "ns3/object.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/tag.h"
+#include "ns3/mac48-address.h"
+#include "qos-utils.h"
+#include "wifi-mac.h"
+
+namespace ns3 {
+
+class Packet;
+class RegularWifiMac;
+class WifiMacQueue;
+class WifiMacQueueItem;
+
+/**
+ * \ingroup wifi
+ * \brief Sequence number of a unicast packet sent by a multi-link device
+ *
+ * The MAC of each link numbers the MPDUs it sends, so the packets of a TID
+ * sent on several links cannot be put back in order by the receiver from
+ * their MAC headers.  The MultiLinkScheduler of the sender numbers the
+ * packets of each receiver and TID instead, and the MultiLinkScheduler of
+ * the receiver passes them up in this order.  This is a byte tag, so that
+ * every MSDU of an A-MSDU keeps its own tag.
+ */
+class MultiLinkSequenceTag : public Tag
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MultiLinkSequenceTag ();
+
+  TypeId GetInstanceTypeId (void) const override;
+  uint32_t GetSerializedSize (void) const override;
+  void Serialize (TagBuffer i) const override;
+  void Deserialize (TagBuffer i) override;
+  void Print (std::ostream &os) const override;
+
+  /**
+   * Set the address of the multi-link device sending the packet.
+   *
+   * \param transmitter the address of the sender
+   */
+  void SetTransmitter (Mac48Address transmitter);
+  /**
+   * \return the address of the multi-link device sending the packet
+   */
+  Mac48Address GetTransmitter (void) const;
+  /**
+   * Set the address of the device receiving the packet over the air.
+   *
+   * \param receiver the address of the receiver
+   */
+  void SetReceiver (Mac48Address receiver);
+  /**
+   * \return the address of the device receiving the packet over the air
+   */
+  Mac48Address GetReceiver (void) const;
+  /**
+   * \param tid the TID of the packet
+   */
+  void SetTid (uint8_t tid);
+  /**
+   * \return the TID of the packet
+   */
+  uint8_t GetTid (void) const;
+  /**
+   * \param sequenceNumber the sequence number of the packet among the
+   *                       packets of its receiver and TID
+   */
+  void SetSequenceNumber (uint64_t sequenceNumber);
+  /**
+   * \return the sequence number of the packet among the packets of its
+   *         receiver and TID
+   */
+  uint64_t GetSequenceNumber (void) const;
+
+private:
+  Mac48Address m_transmitter; //!< the address of the sender
+  Mac48Address m_receiver;    //!< the address of the receiver
+  uint8_t m_tid;              //!< the TID
+  uint64_t m_sequenceNumber;  //!< the sequence number
+};
+
+/**
+ * \ingroup wifi
+ * \brief Cross-link scheduler of a multi-link device (MLD)
+ *
+ * A multi-link device has a MAC affiliated with each of its links, with its
+ * own PHY, remote station manager, channel access manager and EDCA functions
+ * (QosTxop).  The packets sent by the device are first stored in a queue of
+ * the MLD per Access Category, and are handed to the MAC of a link when
+ * the queue of the link has room: the packets wait at the MLD level, where
+ * they can still go to any link, rather than behind the packets of a busy
+ * link.
+ *
+ * A packet goes to the link which has the fewest bytes queued (including
+ * the MPDUs which are in flight) for its Access Category, among the links
+ * whose MAC can forward packets to its destination (e.g., the affiliated STA
+ * is associated) and have less than MaxLinkQueueBytes queued; faster links
+ * drain their queues sooner and thus receive more packets.  An AP sends a
+ * copy of the group addressed packets on every link with associated STAs
+ * (a multi-link STA keeps the copy received on its first link that is up),
+ * and a STA sends them on the first link where it is associated.  If no MAC
+ * can forward a packet to its destination, the packet is handed to the MAC
+ * of the first link, as with a single-link device.  The packets dropped by
+ * the queues of the MLD are reported by the MacTxDrop trace of the MAC of
+ * the first link.
+ *
+ * Since the packets of a TID are spread over the links, the scheduler of
+ * the receiver restores their order: the scheduler of the sender gives each
+ * unicast packet a MultiLinkSequenceTag, and the scheduler of the receiver
+ * buffers the packets received ahead of a missing one.  If the missing
+ * packet is not received within ReorderTimeout (e.g., it was dropped by the
+ * MAC of its link), the buffered packets are passed up without it.
+ *
+ * The MACs of the links must support QoS.
+ */
+class MultiLinkScheduler : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  MultiLinkScheduler ();
+  virtual ~MultiLinkScheduler ();
+
+  /**
+   * Add a link, whose ID is the number of links added before.
+   *
+   * \param mac the MAC affiliated with the link
+   */
+  void AddLink (Ptr<RegularWifiMac> mac);
+
+  /**
+   * \return the number of links
+   */
+  uint8_t GetNLinks (void) const;
+
+  /**
+   * Store a packet in the queue of its Access Category and hand the packets
+   * of this queue to the links which have room for them.
+   *
+   * \param packet the packet to send
+   * \param to the destination address
+   * \param from the source address, which is the address of the device
+   *             unless the packet is bridged
+   */
+  void Enqueue (Ptr<Packet> packet, Mac48Address to, Mac48Address from);
+
+  /**
+   * \param upCallback the callback to invoke to pass a received packet up
+   */
+  void SetForwardUpCallback (WifiMac::ForwardUpCallback upCallback);
+
+  /**
+   * Pass up a packet received by the MAC of a link, after the unicast
+   * packets sent before it by the same multi-link device with the same TID.
+   *
+   * \param packet the received packet
+   * \param from the source address
+   * \param to the destination address
+   */
+  void Receive (Ptr<const Packet> packet, Mac48Address from, Mac48Address to);
+
+  /**
+   * \param ac the Access Category
+   * \return the MLD queue of the given Access Category
+   */
+  Ptr<WifiMacQueue> GetQueue (AcIndex ac) const;
+
+  /**
+   * \param ac the Access Category
+   * \param linkId the ID of the link
+   * \return the number of packets handed to the given link so far
+   */
+  uint64_t GetNPacketsToLink (AcIndex ac, uint8_t linkId) const;
+
+protected:
+  void DoDispose (void) override;
+
+private:
+  /**
+   * Select the links to which a packet is handed: a single link, unless the
+   * packet is group addressed and sent by an AP.
+   *
+   * \param item the packet, with its destination as Address 1 and its source
+   *             as Address 2 of the header
+   * \param[out] linkIds the IDs of the selected links
+   * \return false if the packet must wait for a link to have room for it,
+   *         true otherwise
+   */
+  bool SelectLinks (Ptr<const WifiMacQueueItem> item, std::vector<uint8_t> &linkIds) const;
+
+  /**
+   * Hand the packets of the MLD queue of the given Access Category to the
+   * links, in order, until a packet must wait for a link to have room.
+   *
+   * \param ac the Access Category
+   */
+  void Dispatch (AcIndex ac);
+
+  /**
+   * Notify that an MPDU left the queue of a link, which may now have room.
+   *
+   * \param ac the Access Category of the queue
+   * \param item the MPDU
+   */
+  void NotifyLinkQueueRemoval (AcIndex ac, Ptr<const WifiMacQueueItem> item);
+
+  /**
+   * Notify that a packet was dropped by an MLD queue.
+   *
+   * \param item the dropped packet
+   */
+  void NotifyDrop (Ptr<const WifiMacQueueItem> item);
+
+  /**
+   * Find the MultiLinkSequenceTag given to a packet by the multi-link device
+   * that sent it to this device.
+   *
+   * \param packet the received packet
+   * \param[out] tag the tag
+   * \return true if the packet has such a tag
+   */
+  bool FindSequenceTag (Ptr<const Packet> packet, MultiLinkSequenceTag &tag) const;
+
+  /**
+   * Pass up the packets buffered for the given transmitter and TID as long
+   * as none is missing, and restart the reorder timer if the next missing
+   * packet changed.
+   *
+   * \param key the address of the transmitter and the TID
+   */
+  void ForwardUpInOrder (WifiAddressTidPair key);
+
+  /**
+   * Give up waiting for the missing packet of the given transmitter and TID
+   * and pass up the packets buffered after it.
+   *
+   * \param key the address of the transmitter and the TID
+   */
+  void ReorderTimeout (WifiAddressTidPair key);
+
+  /// A received packet waiting for the packets sent before it
+  struct BufferedPacket
+  {
+    Ptr<const Packet> packet;  //!< the packet
+    Mac48Address from;         //!< the source address
+    Mac48Address to;           //!< the destination address
+  };
+
+  /// The packets received from a transmitter with a TID
+  struct ReorderBuffer
+  {
+    uint64_t nextSequenceNumber {0};                 //!< the sequence number of the next packet to pass up
+    std::map<uint64_t, BufferedPacket> packets;      //!< the buffered packets, by sequence number
+    EventId timeout;                                 //!< the reorder timer
+  };
+
+  std::vector<Ptr<RegularWifiMac> > m_links;         //!< the MAC of each link
+  std::map<AcIndex, Ptr<WifiMacQueue> > m_queues;    //!< the MLD queue of each Access Category
+  std::map<AcIndex, EventId> m_dispatchEvents;       //!< the dispatch event of each Access Category
+  std::map<AcIndex, std::vector<uint64_t> > m_nPacketsToLink; //!< the number of packets handed to each link
+  uint32_t m_maxLinkQueueBytes;                      //!< bytes above which no packet is handed to a link
+  Time m_reorderTimeout;                             //!< the time to wait for a missing packet
+  WifiMac::ForwardUpCallback m_forwardUp;            //!< the callback passing the received packets up
+  std::map<WifiAddressTidPair, uint64_t> m_nextSequenceNumbers;      //!< the next sequence number of each receiver and TID
+  std::map<WifiAddressTidPair, ReorderBuffer> m_reorderBuffers;      //!< the reorder buffer of each transmitter and TID
+};
+
+} //namespace ns3
+
+#endif /* MULTI_LINK_SCHEDULER_H */
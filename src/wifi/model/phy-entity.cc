@@ -249,6 +249,10 @@ PhyEntity::GetDurationUpToField (WifiPpduField field, const WifiTxVector& txVect
 PhyEntity::SnrPer
 PhyEntity::GetPhyHeaderSnrPer (WifiPpduField field, Ptr<Event> event) const
 {
+  if (m_wifiPhy->m_abstractedReception)
+    {
+      return SnrPer (0.0, 0.0); //evaluated by EndOfAbstractedPsdu
+    }
   uint16_t measurementChannelWidth = GetMeasurementChannelWidth (event->GetPpdu ());
   return m_wifiPhy->m_interference.CalculatePhyHeaderSnrPer (event, measurementChannelWidth, m_wifiPhy->GetPrimaryBand (measurementChannelWidth),
                                                              field);
@@ -554,6 +558,10 @@ void
 PhyEntity::ScheduleEndOfMpdus (Ptr<Event> event)
 {
   NS_LOG_FUNCTION (this << *event);
+  if (m_wifiPhy->m_abstractedReception)
+    {
+      return;
+    }
   Ptr<const WifiPpdu> ppdu = event->GetPpdu ();
   Ptr<const WifiPsdu> psdu = GetAddressedPsduInPpdu (ppdu);
   const WifiTxVector& txVector = event->GetTxVector ();
@@ -627,6 +635,65 @@ PhyEntity::EndOfMpdu (Ptr<Event> event, Ptr<const WifiPsdu> psdu, size_t mpduInd
     }
 }
 
+double
+PhyEntity::EndOfAbstractedPsdu (Ptr<Event> event)
+{
+  NS_LOG_FUNCTION (this << *event);
+  Ptr<const WifiPpdu> ppdu = event->GetPpdu ();
+  Ptr<const WifiPsdu> psdu = GetAddressedPsduInPpdu (ppdu);
+  const WifiTxVector& txVector = event->GetTxVector ();
+  uint16_t staId = GetStaId (ppdu);
+  const auto & channelWidthAndBand = GetChannelWidthAndBand (txVector, staId);
+  double snr = m_wifiPhy->m_interference.CalculatePayloadEffectiveSnr (event, channelWidthAndBand.first, channelWidthAndBand.second, staId);
+
+  bool headerSuccess = true;
+  if (ppdu->GetType () != WIFI_PPDU_TYPE_UL_MU) //the PHY header of HE TB PPDUs is not decoded
+    {
+      uint16_t measurementChannelWidth = GetMeasurementChannelWidth (ppdu);
+      SnrPer snrPer = m_wifiPhy->m_interference.CalculatePhyHeaderEffectiveSnrPer (event, measurementChannelWidth,
+                                                                                  m_wifiPhy->GetPrimaryBand (measurementChannelWidth));
+      headerSuccess = GetRandomValue () > snrPer.per;
+      NS_LOG_DEBUG ("PHY header: SNR(dB)=" << RatioToDb (snrPer.snr) << ", PER=" << snrPer.per << ", success=" << headerSuccess);
+    }
+
+  SignalNoiseDbm signalNoise;
+  signalNoise.signal = WToDbm (event->GetRxPowerW (channelWidthAndBand.second));
+  signalNoise.noise = WToDbm (event->GetRxPowerW (channelWidthAndBand.second) / snr);
+  auto signalNoiseIt = m_signalNoiseMap.find (std::make_pair (ppdu->GetUid (), staId));
+  NS_ASSERT (signalNoiseIt != m_signalNoiseMap.end ());
+  signalNoiseIt->second = signalNoise;
+
+  RxSignalInfo rxSignalInfo;
+  rxSignalInfo.snr = snr;
+  rxSignalInfo.rssi = signalNoise.signal;
+
+  auto statusPerMpduIt = m_statusPerMpduMap.find (std::make_pair (ppdu->GetUid (), staId));
+  NS_ASSERT (statusPerMpduIt != m_statusPerMpduMap.end ());
+  size_t nMpdus = psdu->GetNMpdus ();
+  bool isNormalMpdu = (nMpdus == 1 && !psdu->IsSingle ());
+  size_t i = 0;
+  for (auto mpdu = psdu->begin (); mpdu != psdu->end (); ++mpdu, ++i)
+    {
+      uint32_t size = isNormalMpdu ? psdu->GetSize () : psdu->GetAmpduSubframeSize (i);
+      Ptr<WifiPsdu> mpduPsdu = Create<WifiPsdu> (*mpdu, false);
+      bool success = false;
+      if (headerSuccess)
+        {
+          double per = m_wifiPhy->m_interference.CalculateMpduPer (snr, size, txVector, staId);
+          success = GetRandomValue () > per
+                    && !(m_wifiPhy->m_postReceptionErrorModel && m_wifiPhy->m_postReceptionErrorModel->IsCorrupt (mpduPsdu->GetPacket ()->Copy ()));
+          NS_LOG_DEBUG ("MPDU #" << i << ": size=" << size << ", PER=" << per << ", correct reception: " << success);
+        }
+      statusPerMpduIt->second.push_back (success);
+      if (success && nMpdus > 1)
+        {
+          //only done for correct MPDU that is part of an A-MPDU
+          m_state->ContinueRxNextMpdu (mpduPsdu, rxSignalInfo, txVector);
+        }
+    }
+  return snr;
+}
+
 void
 PhyEntity::EndReceivePayload (Ptr<Event> event)
 {
@@ -636,8 +703,16 @@ PhyEntity::EndReceivePayload (Ptr<Event> event)
   NS_LOG_FUNCTION (this << *event << psduDuration);
   NS_ASSERT (event->GetEndTime () == Simulator::Now ());
   uint16_t staId = GetStaId (ppdu);
-  const auto & channelWidthAndBand = GetChannelWidthAndBand (event->GetTxVector (), staId);
-  double snr = m_wifiPhy->m_interference.CalculateSnr (event, channelWidthAndBand.first, txVector.GetNss (staId), channelWidthAndBand.second);
+  double snr;
+  if (m_wifiPhy->m_abstractedReception)
+    {
+      snr = EndOfAbstractedPsdu (event);
+    }
+  else
+    {
+      const auto & channelWidthAndBand = GetChannelWidthAndBand (event->GetTxVector (), staId);
+      snr = m_wifiPhy->m_interference.CalculateSnr (event, channelWidthAndBand.first, txVector.GetNss (staId), channelWidthAndBand.second);
+    }
 
   Ptr<const WifiPsdu> psdu = GetAddressedPsduInPpdu (ppdu);
   m_wifiPhy->NotifyRxEnd (psdu);
@@ -821,7 +896,7 @@ PhyEntity::EndPreambleDetectionPeriod (Ptr<Event> event)
       m_wifiPhy->NotifyRxDrop (GetAddressedPsduInPpdu (event->GetPpdu ()), BUSY_DECODING_PREAMBLE);
       auto it = m_wifiPhy->m_currentPreambleEvents.find (std::make_pair (event->GetPpdu ()->GetUid (), event->GetPpdu ()->GetPreamble ()));
       m_wifiPhy->m_currentPreambleEvents.erase (it);
-      //This is needed to cleanup the m_firstPowerPerBand so that the first power corresponds to the power at the start of the PPDU
+      //This is needed to cleanup the first power of each band in the interference helper so that the first power corresponds to the power at the start of the PPDU
       m_wifiPhy->m_interference.NotifyRxEnd (maxEvent->GetStartTime ());
       //Make sure InterferenceHelper keeps recording events
       m_wifiPhy->m_interference.NotifyRxStart ();
@@ -851,7 +926,7 @@ PhyEntity::EndPreambleDetectionPeriod (Ptr<Event> event)
               if (m_wifiPhy->m_currentEvent->GetPpdu ()->GetUid () > it->first.first)
                 {
                   reason = PREAMBLE_DETECTION_PACKET_SWITCH;
-                  //This is needed to cleanup the m_firstPowerPerBand so that the first power corresponds to the power at the start of the PPDU
+                  //This is needed to cleanup the first power of each band in the interference helper so that the first power corresponds to the power at the start of the PPDU
                   m_wifiPhy->m_interference.NotifyRxEnd (m_wifiPhy->m_currentEvent->GetStartTime ());
                 }
               else
@@ -635,12 +635,25 @@ protected:
   void EndOfMpdu (Ptr<Event> event, Ptr<const WifiPsdu> psdu, size_t mpduIndex, Time relativeStart, Time mpduDuration);
 
   /**
-   * Schedule end of MPDUs events.
+   * Schedule end of MPDUs events.  Nothing is scheduled if the reception is
+   * abstracted, since the MPDUs are then evaluated by EndOfAbstractedPsdu.
    *
    * \param event the event holding incoming PPDU's information
    */
   void ScheduleEndOfMpdus (Ptr<Event> event);
 
+  /**
+   * Evaluate at once the reception of the PHY header and of all the MPDUs of
+   * the PSDU at the end of the PPDU, when the reception is abstracted (see the
+   * AbstractedReception attribute of WifiPhy), and notify the correctly
+   * received MPDUs of an A-MPDU as EndOfMpdu does.  The PHY header and each
+   * MPDU are received at the effective SNR of their part of the PPDU.
+   *
+   * \param event the event holding incoming PPDU's information
+   * \return the effective SNR of the payload in linear scale
+   */
+  double EndOfAbstractedPsdu (Ptr<Event> event);
+
   /**
    * Perform amendment-specific actions at the end of the reception of
    * the payload.
@@ -674,7 +687,8 @@ protected:
   double GetRandomValue (void) const;
   /**
    * Obtain the SNR and PER of the PPDU field from the WifiPhy's InterferenceHelper class.
-   * Wrapper used by child classes.
+   * Wrapper used by child classes.  If the reception is abstracted, the PHY
+   * header is evaluated at the end of the PPDU, and a null PER is returned.
    *
    * \param field the PPDU field
    * \param event the event holding incoming PPDU's information
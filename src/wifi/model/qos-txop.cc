@@ -270,9 +270,6 @@ QosTxop::PrepareBlockAckRequest (Mac48Address recipient, uint8_t tid) const
   NS_ASSERT (QosUtilsMapTidToAc (tid) == m_ac);
 
   CtrlBAckRequestHeader reqHdr = m_baManager->GetBlockAckReqHeader (recipient, tid);
-  Ptr<Packet> bar = Create<Packet> ();
-  bar->AddHeader (reqHdr);
-
   WifiMacHeader hdr;
   hdr.SetType (WIFI_MAC_CTL_BACKREQ);
   hdr.SetAddr1 (recipient);
@@ -282,7 +279,7 @@ QosTxop::PrepareBlockAckRequest (Mac48Address recipient, uint8_t tid) const
   hdr.SetNoRetry ();
   hdr.SetNoMoreFragments ();
 
-  return Create<const WifiMacQueueItem> (bar, hdr);
+  return Create<const WifiMacQueueItem> (Create<Packet> (), reqHdr, hdr);
 }
 
 void
@@ -65,6 +65,8 @@ struct MinstrelHtWifiRemoteStation : MinstrelWifiRemoteStation
   uint32_t m_ampduPacketCount; //!< Number of A-MPDUs transmitted.
 
   McsGroupData m_groupsTable;  //!< Table of groups with stats.
+  std::vector<uint8_t> m_supportedGroups;  //!< The supported groups, in increasing order.
+  std::vector<MinstrelHtRateInfo> m_rates; //!< The rates of the supported groups, group by group.
   bool m_isHt;                 //!< If the station is HT capable.
 
   std::ofstream m_statsFile;   //!< File where statistics table is written.
@@ -491,7 +493,6 @@ MinstrelHtWifiManager::CheckInit (MinstrelHtWifiRemoteStation *station)
           NS_LOG_DEBUG ("HT station " << station);
           station->m_isHt = true;
           station->m_nModes = GetNMcsSupported (station);
-          station->m_minstrelTable = MinstrelRate (station->m_nModes);
           station->m_sampleTable = SampleRate (m_numRates, std::vector<uint8_t> (m_nSampleCol));
           InitSampleTable (station);
           RateInit (station);
@@ -581,10 +582,10 @@ MinstrelHtWifiManager::DoReportDataOk (WifiRemoteStation *st, double ackSnr, Wif
       return;
     }
 
-  NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_minstrelTable[station->m_txrate].numRateAttempt << ", success = " << station->m_minstrelTable[station->m_txrate].numRateSuccess << " (before update).");
-
   if (!station->m_isHt)
     {
+      NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_minstrelTable[station->m_txrate].numRateAttempt << ", success = " << station->m_minstrelTable[station->m_txrate].numRateSuccess << " (before update).");
+
       station->m_minstrelTable[station->m_txrate].numRateSuccess++;
       station->m_minstrelTable[station->m_txrate].numRateAttempt++;
 
@@ -604,12 +605,14 @@ MinstrelHtWifiManager::DoReportDataOk (WifiRemoteStation *st, double ackSnr, Wif
     {
       uint8_t rateId = GetRateId (station->m_txrate);
       uint8_t groupId = GetGroupId (station->m_txrate);
+      NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt << ", success = " << station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess << " (before update).");
+
       station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess++;
       station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt++;
 
       UpdatePacketCounters (station, 1, 0);
 
-      NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_minstrelTable[station->m_txrate].numRateAttempt << ", success = " << station->m_minstrelTable[station->m_txrate].numRateSuccess << " (after update).");
+      NS_LOG_DEBUG ("DoReportDataOk m_txrate = " << station->m_txrate << ", attempt = " << station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt << ", success = " << station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess << " (after update).");
 
       station->m_isSampling = false;
       station->m_sampleDeferred = false;
@@ -1228,7 +1231,7 @@ MinstrelHtWifiManager::UpdateStats (MinstrelHtWifiRemoteStation *station)
   station->m_maxProbRate = GetLowestIndex (station);
 
   /// Update throughput and EWMA for each rate inside each group.
-  for (uint8_t j = 0; j < m_numGroups; j++)
+  for (uint8_t j : station->m_supportedGroups)
     {
       if (station->m_groupsTable[j].m_supported)
         {
@@ -1474,6 +1477,7 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
   NS_LOG_FUNCTION (this << station);
 
   station->m_groupsTable = McsGroupData (m_numGroups);
+  station->m_supportedGroups.clear ();
 
   /**
   * Initialize groups supported by the receiver.
@@ -1538,64 +1542,73 @@ MinstrelHtWifiManager::RateInit (MinstrelHtWifiRemoteStation *station)
           station->m_groupsTable[groupId].m_supported = true;
           station->m_groupsTable[groupId].m_col = 0;
           station->m_groupsTable[groupId].m_index = 0;
+          station->m_supportedGroups.push_back (groupId);
+        }
+    }
+  ///make sure at least one group is supported, otherwise we end up with an infinite loop in SetNextSample
+  if (noSupportedGroupFound)
+    {
+      NS_FATAL_ERROR ("No supported group has been found");
+    }
 
-          station->m_groupsTable[groupId].m_ratesTable = MinstrelHtRate (m_numRates); ///Create the rate list for the group.
-          for (uint8_t i = 0; i < m_numRates; i++)
+  /**
+  * Create the rate lists of the supported groups, in a single array.
+  */
+  station->m_rates = std::vector<MinstrelHtRateInfo> (station->m_supportedGroups.size () * m_numRates);
+  for (std::size_t k = 0; k < station->m_supportedGroups.size (); k++)
+    {
+      uint8_t groupId = station->m_supportedGroups[k];
+      station->m_groupsTable[groupId].m_ratesTable = MinstrelHtRate (&station->m_rates[k * m_numRates], m_numRates);
+      for (uint8_t i = 0; i < m_numRates; i++)
+        {
+          station->m_groupsTable[groupId].m_ratesTable[i].supported = false;
+        }
+
+      // Initialize all modes supported by the remote station that belong to the current group.
+      for (uint8_t i = 0; i < station->m_nModes; i++)
+        {
+          WifiMode mode = GetMcsSupported (station, i);
+
+          ///Use the McsValue as the index in the rate table.
+          ///This way, MCSs not supported are not initialized.
+          uint8_t rateId = mode.GetMcsValue ();
+          if (mode.GetModulationClass () == WIFI_MOD_CLASS_HT)
             {
-              station->m_groupsTable[groupId].m_ratesTable[i].supported = false;
+              rateId %= MAX_HT_GROUP_RATES;
             }
 
-          // Initialize all modes supported by the remote station that belong to the current group.
-          for (uint8_t i = 0; i < station->m_nModes; i++)
+          if (((m_minstrelGroups[groupId].type == GROUP_HE)
+                && (mode.GetModulationClass () == WIFI_MOD_CLASS_HE)                                                   ///If it is a HE MCS only add to a HE group.
+                && IsValidMcs (GetPhy (), m_minstrelGroups[groupId].streams, m_minstrelGroups[groupId].chWidth, mode)) ///Check validity of the HE MCS
+              || ((m_minstrelGroups[groupId].type == GROUP_VHT)
+                && (mode.GetModulationClass () == WIFI_MOD_CLASS_VHT)                                                  ///If it is a VHT MCS only add to a VHT group.
+                && IsValidMcs (GetPhy (), m_minstrelGroups[groupId].streams, m_minstrelGroups[groupId].chWidth, mode)) ///Check validity of the VHT MCS
+              || ((m_minstrelGroups[groupId].type == GROUP_HT)
+                  && (mode.GetModulationClass () == WIFI_MOD_CLASS_HT)                                                 ///If it is a HT MCS only add to a HT group.
+                  && (mode.GetMcsValue () < (m_minstrelGroups[groupId].streams * 8))                                     ///Check if the HT MCS corresponds to groups number of streams.
+                  && (mode.GetMcsValue () >= ((m_minstrelGroups[groupId].streams - 1) * 8))))
             {
-              WifiMode mode = GetMcsSupported (station, i);
-
-              ///Use the McsValue as the index in the rate table.
-              ///This way, MCSs not supported are not initialized.
-              uint8_t rateId = mode.GetMcsValue ();
-              if (mode.GetModulationClass () == WIFI_MOD_CLASS_HT)
-                {
-                  rateId %= MAX_HT_GROUP_RATES;
-                }
-
-              if (((m_minstrelGroups[groupId].type == GROUP_HE)
-                    && (mode.GetModulationClass () == WIFI_MOD_CLASS_HE)                                                   ///If it is a HE MCS only add to a HE group.
-                    && IsValidMcs (GetPhy (), m_minstrelGroups[groupId].streams, m_minstrelGroups[groupId].chWidth, mode)) ///Check validity of the HE MCS
-                  || ((m_minstrelGroups[groupId].type == GROUP_VHT)
-                    && (mode.GetModulationClass () == WIFI_MOD_CLASS_VHT)                                                  ///If it is a VHT MCS only add to a VHT group.
-                    && IsValidMcs (GetPhy (), m_minstrelGroups[groupId].streams, m_minstrelGroups[groupId].chWidth, mode)) ///Check validity of the VHT MCS
-                  || ((m_minstrelGroups[groupId].type == GROUP_HT)
-                      && (mode.GetModulationClass () == WIFI_MOD_CLASS_HT)                                                 ///If it is a HT MCS only add to a HT group.
-                      && (mode.GetMcsValue () < (m_minstrelGroups[groupId].streams * 8))                                     ///Check if the HT MCS corresponds to groups number of streams.
-                      && (mode.GetMcsValue () >= ((m_minstrelGroups[groupId].streams - 1) * 8))))
-                {
-                  NS_LOG_DEBUG ("Mode " << +i << ": " << mode);
-
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].supported = true;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex = i; ///Mapping between rateId and operationalMcsSet
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].prob = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateAttempt = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateSuccess = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].numSamplesSkipped = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].successHist = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].attemptHist = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].throughput = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, i));
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 0;
-                  station->m_groupsTable[groupId].m_ratesTable[rateId].adjustedRetryCount = 0;
-                  CalculateRetransmits (station, groupId, rateId);
-                }
+              NS_LOG_DEBUG ("Mode " << +i << ": " << mode);
+
+              station->m_groupsTable[groupId].m_ratesTable[rateId].supported = true;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].mcsIndex = i; ///Mapping between rateId and operationalMcsSet
+              station->m_groupsTable[groupId].m_ratesTable[rateId].numRateAttempt = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].numRateSuccess = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].prob = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].ewmaProb = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateAttempt = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].prevNumRateSuccess = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].numSamplesSkipped = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].successHist = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].attemptHist = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].throughput = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].perfectTxTime = GetFirstMpduTxTime (groupId, GetMcsSupported (station, i));
+              station->m_groupsTable[groupId].m_ratesTable[rateId].retryCount = 0;
+              station->m_groupsTable[groupId].m_ratesTable[rateId].adjustedRetryCount = 0;
+              CalculateRetransmits (station, groupId, rateId);
             }
         }
     }
-  ///make sure at least one group is supported, otherwise we end up with an infinite loop in SetNextSample
-  if (noSupportedGroupFound)
-    {
-      NS_FATAL_ERROR ("No supported group has been found");
-    }
   SetNextSample (station);                  /// Select the initial sample index.
   UpdateStats (station);                    /// Calculate the initial high throughput rates.
   station->m_txrate = FindRate (station);   /// Select the rate to use.
@@ -26,6 +26,7 @@
 #ifndef MINSTREL_HT_WIFI_MANAGER_H
 #define MINSTREL_HT_WIFI_MANAGER_H
 
+#include "ns3/assert.h"
 #include "ns3/wifi-remote-station-manager.h"
 #include "minstrel-wifi-manager.h"
 #include "ns3/wifi-mpdu-type.h"
@@ -98,6 +99,7 @@ typedef std::vector<McsGroup> MinstrelMcsGroups;
 struct MinstrelHtWifiRemoteStation;
 /**
  * A struct to contain all statistics information related to a data rate.
+ * The members are ordered by decreasing size, so that there is no padding.
  */
 struct MinstrelHtRateInfo
 {
@@ -106,14 +108,7 @@ struct MinstrelHtRateInfo
    * Given a bit rate and a packet length n bytes.
    */
   Time perfectTxTime;
-  bool supported;               //!< If the rate is supported.
-  uint8_t mcsIndex;             //!< The index in the operationalMcsSet of the WifiRemoteStationManager.
-  uint32_t retryCount;          //!< Retry limit.
-  uint32_t adjustedRetryCount;  //!< Adjust the retry limit for this rate.
-  uint32_t numRateAttempt;      //!< Number of transmission attempts so far.
-  uint32_t numRateSuccess;      //!< Number of successful frames transmitted so far.
   double prob;                  //!< Current probability within last time interval. (# frame success )/(# total frames)
-  bool retryUpdated;            //!< If number of retries was updated already.
   /**
    * Exponential weighted moving average of probability.
    * EWMA calculation:
@@ -121,19 +116,74 @@ struct MinstrelHtRateInfo
    */
   double ewmaProb;
   double ewmsdProb;             //!< Exponential weighted moving standard deviation of probability.
+  double throughput;            //!< Throughput of this rate (in packets per second).
+  uint64_t successHist;         //!< Aggregate of all transmission successes.
+  uint64_t attemptHist;         //!< Aggregate of all transmission attempts.
+  uint32_t retryCount;          //!< Retry limit.
+  uint32_t adjustedRetryCount;  //!< Adjust the retry limit for this rate.
+  uint32_t numRateAttempt;      //!< Number of transmission attempts so far.
+  uint32_t numRateSuccess;      //!< Number of successful frames transmitted so far.
   uint32_t prevNumRateAttempt;  //!< Number of transmission attempts with previous rate.
   uint32_t prevNumRateSuccess;  //!< Number of successful frames transmitted with previous rate.
   uint32_t numSamplesSkipped;   //!< Number of times this rate statistics were not updated because no attempts have been made.
-  uint64_t successHist;         //!< Aggregate of all transmission successes.
-  uint64_t attemptHist;         //!< Aggregate of all transmission attempts.
-  double throughput;            //!< Throughput of this rate (in packets per second).
+  uint8_t mcsIndex;             //!< The index in the operationalMcsSet of the WifiRemoteStationManager.
+  bool supported;               //!< If the rate is supported.
+  bool retryUpdated;            //!< If number of retries was updated already.
 };
 
 /**
- * Data structure for a Minstrel Rate table.
- * A vector of a struct MinstrelHtRateInfo.
+ * Data structure for a Minstrel Rate table: the rates of a group, stored
+ * in the array holding the rates of all the groups supported by a station.
  */
-typedef std::vector<MinstrelHtRateInfo> MinstrelHtRate;
+class MinstrelHtRate
+{
+public:
+  MinstrelHtRate ()
+    : m_rates (nullptr),
+      m_size (0)
+  {
+  }
+  /**
+   * Create the table of the given rates.
+   *
+   * \param rates the first rate of the group
+   * \param size the number of rates of the group
+   */
+  MinstrelHtRate (MinstrelHtRateInfo *rates, std::size_t size)
+    : m_rates (rates),
+      m_size (size)
+  {
+  }
+  /**
+   * \param i the index of the rate in the group
+   * \return the information about the rate
+   */
+  MinstrelHtRateInfo & operator[] (std::size_t i)
+  {
+    NS_ASSERT (i < m_size);
+    return m_rates[i];
+  }
+  /**
+   * \param i the index of the rate in the group
+   * \return the information about the rate
+   */
+  const MinstrelHtRateInfo & operator[] (std::size_t i) const
+  {
+    NS_ASSERT (i < m_size);
+    return m_rates[i];
+  }
+  /**
+   * \return the number of rates of the group (0 if the group is not supported)
+   */
+  std::size_t size (void) const
+  {
+    return m_size;
+  }
+
+private:
+  MinstrelHtRateInfo *m_rates; //!< the first rate of the group
+  std::size_t m_size;          //!< the number of rates of the group
+};
 
 /**
  * A struct to contain information of a group.
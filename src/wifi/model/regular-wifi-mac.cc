@@ -618,7 +618,10 @@ RegularWifiMac::GetHtSupported () const
 bool
 RegularWifiMac::GetVhtSupported () const
 {
-  if (GetVhtConfiguration ())
+  //VHT is not supported in the 2.4 GHz band, where a link of a multi-link
+  //device may operate although the device has a VHT configuration
+  if (GetVhtConfiguration ()
+      && (m_phy == 0 || m_phy->GetPhyBand () != WIFI_PHY_BAND_2_4GHZ))
     {
       return true;
     }
@@ -677,6 +680,10 @@ RegularWifiMac::SetAddress (Mac48Address address)
 {
   NS_LOG_FUNCTION (this << address);
   m_address = address;
+  if (m_feManager)
+    {
+      m_feManager->SetAddress (address);
+    }
 }
 
 Mac48Address
@@ -416,6 +416,12 @@ StaWifiMac::IsAssociated (void) const
   return m_state == ASSOCIATED;
 }
 
+bool
+StaWifiMac::CanForwardPacketsTo (Mac48Address to) const
+{
+  return IsAssociated ();
+}
+
 bool
 StaWifiMac::IsWaitAssocResp (void) const
 {
@@ -131,6 +131,12 @@ public:
    */
   void Enqueue (Ptr<Packet> packet, Mac48Address to) override;
 
+  /**
+   * \param to the address to which the packet should be sent.
+   * \return true if we are associated with an AP, false otherwise.
+   */
+  bool CanForwardPacketsTo (Mac48Address to) const override;
+
   /**
    * \param phy the physical layer attached to this MAC.
    */
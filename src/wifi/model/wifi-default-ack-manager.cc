@@ -648,7 +648,7 @@ WifiDefaultAckManager::TryUlMuTransmission (Ptr<const WifiMacQueueItem> mpdu,
   NS_ABORT_MSG_IF (heFem == nullptr, "HE APs only can send Trigger Frames");
 
   CtrlTriggerHeader trigger;
-  mpdu->GetPacket ()->PeekHeader (trigger);
+  mpdu->PeekFrameBody (trigger);
 
   if (trigger.IsBasic ())
     {
@@ -24,6 +24,8 @@
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/log.h"
+#include "ns3/global-value.h"
+#include "ns3/boolean.h"
 #include "wifi-mac-queue-item.h"
 #include "wifi-mac-trailer.h"
 #include "wifi-utils.h"
@@ -33,6 +35,20 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("WifiMacQueueItem");
 
+/**
+ * \ingroup wifi
+ * Whether the frame bodies (e.g., the bodies of the control frames) are
+ * passed by reference to the receivers, rather than serialized.
+ */
+static GlobalValue g_frameBodyByReference =
+  GlobalValue ("WifiFrameBodyByReference",
+               "A global switch to pass the bodies of Block Ack, Block Ack Request "
+               "and Trigger frames by reference to the receivers in the same "
+               "simulation, rather than serializing them. The bodies are still "
+               "serialized when the packets are requested (e.g., for pcap).",
+               BooleanValue (false),
+               MakeBooleanChecker ());
+
 WifiMacQueueItem::WifiMacQueueItem (Ptr<const Packet> p, const WifiMacHeader & header)
   : WifiMacQueueItem (p, header, Simulator::Now ())
 {
@@ -40,9 +56,11 @@ WifiMacQueueItem::WifiMacQueueItem (Ptr<const Packet> p, const WifiMacHeader & h
 
 WifiMacQueueItem::WifiMacQueueItem (Ptr<const Packet> p, const WifiMacHeader & header, Time tstamp)
   : m_packet (p),
+    m_bodySize (0),
     m_header (header),
     m_tstamp (tstamp),
-    m_queueAc (AC_UNDEF)
+    m_queueAc (AC_UNDEF),
+    m_queueOrder (0)
 {
   if (header.IsQosData () && header.IsQosAmsdu ())
     {
@@ -55,12 +73,57 @@ WifiMacQueueItem::~WifiMacQueueItem ()
 {
 }
 
+bool
+WifiMacQueueItem::IsFrameBodyByReference (void)
+{
+  BooleanValue val;
+  g_frameBodyByReference.GetValue (val);
+  return val.Get ();
+}
+
+void
+WifiMacQueueItem::SetFrameBody (std::shared_ptr<const Header> body, uint32_t size)
+{
+  NS_ASSERT (m_body == nullptr);
+  m_body = body;
+  m_bodySize = size;
+}
+
+void
+WifiMacQueueItem::AddFrameBody (const Header & body)
+{
+  Ptr<Packet> packet = m_packet->Copy ();
+  packet->AddHeader (body);
+  m_packet = packet;
+}
+
+void
+WifiMacQueueItem::PeekFrameBodyFromPacket (Header & body) const
+{
+  GetPacket ()->PeekHeader (body);
+}
+
 Ptr<const Packet>
 WifiMacQueueItem::GetPacket (void) const
 {
+  if (m_bodySize > 0)
+    {
+      // materialize the frame body stored by reference
+      NS_ASSERT (m_body != nullptr);
+      Ptr<Packet> packet = m_packet->Copy ();
+      packet->AddHeader (*m_body);
+      m_packet = packet;
+      m_bodySize = 0;
+    }
   return m_packet;
 }
 
+bool
+WifiMacQueueItem::PeekPacketTag (Tag & tag) const
+{
+  return m_packet->PeekPacketTag (tag);
+}
+
 const WifiMacHeader&
 WifiMacQueueItem::GetHeader (void) const
 {
@@ -88,7 +151,7 @@ WifiMacQueueItem::GetTimeStamp (void) const
 uint32_t
 WifiMacQueueItem::GetPacketSize (void) const
 {
-  return m_packet->GetSize ();
+  return m_packet->GetSize () + m_bodySize;
 }
 
 uint32_t
@@ -106,7 +169,7 @@ WifiMacQueueItem::IsFragment (void) const
 Ptr<Packet>
 WifiMacQueueItem::GetProtocolDataUnit (void) const
 {
-  Ptr<Packet> mpdu = m_packet->Copy ();
+  Ptr<Packet> mpdu = GetPacket ()->Copy ();
   mpdu->AddHeader (m_header);
   AddWifiMacTrailer (mpdu);
   return mpdu;
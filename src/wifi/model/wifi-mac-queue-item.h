@@ -29,11 +29,14 @@
 #include "amsdu-subframe-header.h"
 #include "qos-utils.h"
 #include <list>
+#include <memory>
+#include <type_traits>
 
 namespace ns3 {
 
 class QosBlockedDestinations;
 class Packet;
+class Tag;
 
 /**
  * \ingroup wifi
@@ -59,14 +62,61 @@ public:
    */
   WifiMacQueueItem (Ptr<const Packet> p, const WifiMacHeader & header, Time tstamp);
 
+  /**
+   * \brief Create a Wifi MAC queue item containing a frame whose body starts
+   *        with the given header (e.g., the body of a control frame).
+   *
+   * If the WifiFrameBodyByReference global value is true, the item keeps a
+   * copy of the header, which receivers in the same simulation read through
+   * PeekFrameBody without deserializing it, and the header is serialized into
+   * the packet only when the packet is requested (e.g., to trace the frame).
+   * Otherwise, the header is added to (a copy of) the given packet right away.
+   * In both cases, the size of the item includes the size of the header.
+   *
+   * \tparam T the type of the header
+   * \param p the const packet (possibly carrying tags) the body is added to
+   * \param body the header starting the body of the frame
+   * \param header the Wifi MAC header included in the created item.
+   */
+  template <typename T>
+  WifiMacQueueItem (Ptr<const Packet> p, const T & body, const WifiMacHeader & header);
+
   virtual ~WifiMacQueueItem ();
 
   /**
-   * \brief Get the packet stored in this item
+   * \brief Get the packet stored in this item. If the body of the frame is
+   *        stored by reference, it is serialized into the packet first.
    * \return the packet stored in this item.
    */
   Ptr<const Packet> GetPacket (void) const;
 
+  /**
+   * \brief Read the header starting the body of the frame contained in this
+   *        item, without deserializing it if it is stored by reference.
+   *
+   * \tparam T the type of the header
+   * \param body the header to fill
+   */
+  template <typename T>
+  void PeekFrameBody (T & body) const;
+
+  /**
+   * \brief Search the packet tags of the packet stored in this item for a
+   *        tag of the same type as the given one, without serializing the
+   *        frame body if it is stored by reference.
+   *
+   * \param tag the tag to fill, if found
+   * \return true if the tag was found, false otherwise
+   */
+  bool PeekPacketTag (Tag & tag) const;
+
+  /**
+   * \return the value of the WifiFrameBodyByReference global value, i.e.,
+   *         whether the frame bodies passed to the constructor are stored by
+   *         reference
+   */
+  static bool IsFrameBodyByReference (void);
+
   /**
    * \brief Get the header stored in this item
    * \return the header stored in this item.
@@ -202,14 +252,38 @@ private:
    */
   void DoAggregate (Ptr<const WifiMacQueueItem> msdu);
 
+  /**
+   * Store the header starting the frame body by reference.
+   *
+   * \param body the header
+   * \param size the serialized size of the header
+   */
+  void SetFrameBody (std::shared_ptr<const Header> body, uint32_t size);
+  /**
+   * Serialize the header starting the frame body into (a copy of) the packet.
+   *
+   * \param body the header
+   */
+  void AddFrameBody (const Header & body);
+  /**
+   * Deserialize the header starting the frame body from the packet.
+   *
+   * \param body the header to fill
+   */
+  void PeekFrameBodyFromPacket (Header & body) const;
+
   friend class WifiMacQueue;  // to set queue AC and iterator information
 
-  Ptr<const Packet> m_packet;                   //!< The packet (MSDU or A-MSDU) contained in this queue item
+  mutable Ptr<const Packet> m_packet;           //!< The packet (MSDU or A-MSDU) contained in this queue item
+  std::shared_ptr<const Header> m_body;         //!< The header starting the frame body, if stored by reference
+  mutable uint32_t m_bodySize;                  //!< Size of the frame body not serialized into the packet yet
   WifiMacHeader m_header;                       //!< Wifi MAC header associated with the packet
   Time m_tstamp;                                //!< timestamp when the packet arrived at the queue
   DeaggregatedMsdus m_msduList;                 //!< The list of aggregated MSDUs included in this MPDU
   ConstIterator m_queueIt;                      //!< Queue iterator pointing to this MPDU, if queued
   AcIndex m_queueAc;                            //!< AC associated with the queue this MPDU is stored into
+  std::list<ConstIterator>::iterator m_flowIt;  //!< Position of this MPDU in the index of its flow, if queued
+  uint64_t m_queueOrder;                        //!< Increasing with the position of this MPDU in the queue, if queued
   bool m_inFlight;                              //!< whether the MPDU is in flight
 };
 
@@ -224,4 +298,41 @@ std::ostream& operator<< (std::ostream& os, const WifiMacQueueItem &item);
 
 } //namespace ns3
 
+/***************************************************************
+ *  Implementation of the templates declared above.
+ ***************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+WifiMacQueueItem::WifiMacQueueItem (Ptr<const Packet> p, const T & body, const WifiMacHeader & header)
+  : WifiMacQueueItem (p, header)
+{
+  static_assert (std::is_base_of<Header, T>::value, "The frame body must be a Header");
+  if (IsFrameBodyByReference ())
+    {
+      SetFrameBody (std::make_shared<const T> (body), body.GetSerializedSize ());
+    }
+  else
+    {
+      AddFrameBody (body);
+    }
+}
+
+template <typename T>
+void
+WifiMacQueueItem::PeekFrameBody (T & body) const
+{
+  static_assert (std::is_base_of<Header, T>::value, "The frame body must be a Header");
+  const T* stored = dynamic_cast<const T*> (m_body.get ());
+  if (stored != nullptr)
+    {
+      body = *stored;
+      return;
+    }
+  PeekFrameBodyFromPacket (body);
+}
+
+} //namespace ns3
+
 #endif /* WIFI_MAC_QUEUE_ITEM_H */
@@ -25,6 +25,7 @@
 #include "wifi-mac-queue.h"
 #include "qos-blocked-destinations.h"
 #include <functional>
+#include <limits>
 
 namespace ns3 {
 
@@ -73,6 +74,17 @@ WifiMacQueue::~WifiMacQueue ()
   NS_LOG_FUNCTION_NOARGS ();
   m_nQueuedPackets.clear ();
   m_nQueuedBytes.clear ();
+  m_flowQueues.clear ();
+  m_nonQosQueue.clear ();
+}
+
+void
+WifiMacQueue::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_flowQueues.clear ();
+  m_nonQosQueue.clear ();
+  Queue<WifiMacQueueItem>::DoDispose ();
 }
 
 static std::list<Ptr<WifiMacQueueItem>> g_emptyWifiMacQueue; //!< empty Wi-Fi MAC queue
@@ -208,71 +220,65 @@ WifiMacQueue::ConstIterator
 WifiMacQueue::PeekByAddress (Mac48Address dest, ConstIterator pos) const
 {
   NS_LOG_FUNCTION (this << dest);
-  ConstIterator it = (pos != EMPTY ? pos : begin ());
   const Time now = Simulator::Now ();
-  while (it != end ())
+  ConstIterator ret = end ();
+  for (const auto& flow : m_flowQueues)
+    {
+      if (flow.first.first == dest)
+        {
+          ret = GetEarliest (ret, PeekFlow (flow.second, pos, now));
+        }
+    }
+  for (auto flowIt = GetFlowPosition (m_nonQosQueue, pos); flowIt != m_nonQosQueue.end (); flowIt++)
     {
+      ConstIterator it = *flowIt;
       // skip packets that stayed in the queue for too long. They will be
       // actually removed from the queue by the next call to a non-const method
-      if (now <= (*it)->GetTimeStamp () + m_maxDelay)
+      if (now <= (*it)->GetTimeStamp () + m_maxDelay
+          && (*it)->GetHeader ().IsData () && (*it)->GetDestinationAddress () == dest)
         {
-          if (((*it)->GetHeader ().IsData () || (*it)->GetHeader ().IsQosData ())
-              && (*it)->GetDestinationAddress () == dest)
-            {
-              return it;
-            }
+          ret = GetEarliest (ret, it);
+          break;
         }
-      it++;
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return end ();
+  if (ret == end ())
+    {
+      NS_LOG_DEBUG ("The queue is empty");
+    }
+  return ret;
 }
 
 WifiMacQueue::ConstIterator
 WifiMacQueue::PeekByTid (uint8_t tid, ConstIterator pos) const
 {
   NS_LOG_FUNCTION (this << +tid);
-  ConstIterator it = (pos != EMPTY ? pos : begin ());
   const Time now = Simulator::Now ();
-  while (it != end ())
+  ConstIterator ret = end ();
+  for (const auto& flow : m_flowQueues)
     {
-      // skip packets that stayed in the queue for too long. They will be
-      // actually removed from the queue by the next call to a non-const method
-      if (now <= (*it)->GetTimeStamp () + m_maxDelay)
+      if (flow.first.second == tid)
         {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return it;
-            }
+          ret = GetEarliest (ret, PeekFlow (flow.second, pos, now));
         }
-      it++;
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return end ();
+  if (ret == end ())
+    {
+      NS_LOG_DEBUG ("The queue is empty");
+    }
+  return ret;
 }
 
 WifiMacQueue::ConstIterator
 WifiMacQueue::PeekByTidAndAddress (uint8_t tid, Mac48Address dest, ConstIterator pos) const
 {
   NS_LOG_FUNCTION (this << +tid << dest);
-  ConstIterator it = (pos != EMPTY ? pos : begin ());
-  const Time now = Simulator::Now ();
-  while (it != end ())
+  auto flow = m_flowQueues.find (WifiAddressTidPair (dest, tid));
+  if (flow == m_flowQueues.end ())
     {
-      // skip packets that stayed in the queue for too long. They will be
-      // actually removed from the queue by the next call to a non-const method
-      if (now <= (*it)->GetTimeStamp () + m_maxDelay)
-        {
-          if ((*it)->GetHeader ().IsQosData () && (*it)->GetDestinationAddress () == dest
-              && (*it)->GetHeader ().GetQosTid () == tid)
-            {
-              return it;
-            }
-        }
-      it++;
+      NS_LOG_DEBUG ("The queue is empty");
+      return end ();
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return end ();
+  return PeekFlow (flow->second, pos, Simulator::Now ());
 }
 
 WifiMacQueue::ConstIterator
@@ -292,11 +298,27 @@ WifiMacQueue::PeekFirstAvailable (const Ptr<QosBlockedDestinations> blockedPacke
             {
               return it;
             }
+          // the packets of the blocked flows may be many, hence look for the
+          // first available packet among the flows that are not blocked
+          break;
         }
       it++;
     }
-  NS_LOG_DEBUG ("The queue is empty");
-  return end ();
+  if (it == end ())
+    {
+      NS_LOG_DEBUG ("The queue is empty");
+      return end ();
+    }
+
+  ConstIterator ret = PeekFlow (m_nonQosQueue, it, now);
+  for (const auto& flow : m_flowQueues)
+    {
+      if (!blockedPackets->IsBlocked (flow.first.first, flow.first.second))
+        {
+          ret = GetEarliest (ret, PeekFlow (flow.second, it, now));
+        }
+    }
+  return ret;
 }
 
 Ptr<WifiMacQueueItem>
@@ -496,6 +518,197 @@ WifiMacQueue::GetNBytes (uint8_t tid, Mac48Address dest) const
   return m_nQueuedBytes.at (addressTidPair);
 }
 
+WifiMacQueue::FlowQueue &
+WifiMacQueue::GetFlowQueue (Ptr<const WifiMacQueueItem> item)
+{
+  if (item->GetHeader ().IsQosData ())
+    {
+      return m_flowQueues[WifiAddressTidPair (item->GetHeader ().GetAddr1 (),
+                                              item->GetHeader ().GetQosTid ())];
+    }
+  return m_nonQosQueue;
+}
+
+const WifiMacQueue::FlowQueue *
+WifiMacQueue::FindFlowQueue (Ptr<const WifiMacQueueItem> item) const
+{
+  if (item->GetHeader ().IsQosData ())
+    {
+      auto flow = m_flowQueues.find (WifiAddressTidPair (item->GetHeader ().GetAddr1 (),
+                                                         item->GetHeader ().GetQosTid ()));
+      return (flow != m_flowQueues.end () ? &flow->second : nullptr);
+    }
+  return &m_nonQosQueue;
+}
+
+WifiMacQueue::FlowQueue::const_iterator
+WifiMacQueue::LowerBound (const FlowQueue &flow, uint64_t order)
+{
+  // all the positions before first have a lower order, and all the positions
+  // from last on have a greater or equal order
+  auto first = flow.begin ();
+  auto last = flow.end ();
+  while (first != last)
+    {
+      if ((**first)->m_queueOrder >= order)
+        {
+          return first;
+        }
+      if (++first == last)
+        {
+          break;
+        }
+      if ((**--last)->m_queueOrder < order)
+        {
+          return ++last;
+        }
+    }
+  return first;
+}
+
+WifiMacQueue::FlowQueue::const_iterator
+WifiMacQueue::GetFlowPosition (const FlowQueue &flow, ConstIterator pos) const
+{
+  if (pos == EMPTY || pos == begin ())
+    {
+      return flow.begin ();
+    }
+  if (pos == end ())
+    {
+      return flow.end ();
+    }
+  if (FindFlowQueue (*pos) == &flow)
+    {
+      return (*pos)->m_flowIt;
+    }
+  // typically, the search starts right after the packet previously returned
+  auto prev = std::prev (pos);
+  if (FindFlowQueue (*prev) == &flow)
+    {
+      return std::next ((*prev)->m_flowIt);
+    }
+  return LowerBound (flow, (*pos)->m_queueOrder);
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueue::PeekFlow (const FlowQueue &flow, ConstIterator pos, const Time& now) const
+{
+  for (auto flowIt = GetFlowPosition (flow, pos); flowIt != flow.end (); flowIt++)
+    {
+      // skip packets that stayed in the queue for too long. They will be
+      // actually removed from the queue by the next call to a non-const method
+      if (now <= (**flowIt)->GetTimeStamp () + m_maxDelay)
+        {
+          return *flowIt;
+        }
+    }
+  return end ();
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueue::GetEarliest (ConstIterator first, ConstIterator second) const
+{
+  if (first == end ())
+    {
+      return second;
+    }
+  if (second == end () || (*first)->m_queueOrder < (*second)->m_queueOrder)
+    {
+      return first;
+    }
+  return second;
+}
+
+void
+WifiMacQueue::SetQueueOrder (ConstIterator pos)
+{
+  // leave room for many insertions at the head and at the tail of the queue
+  const uint64_t step = 1 << 20;
+  const uint64_t middle = static_cast<uint64_t> (1) << 62;
+
+  bool isFirst = (pos == begin ());
+  bool isLast = (std::next (pos) == end ());
+  uint64_t prevOrder = (isFirst ? 0 : (*std::prev (pos))->m_queueOrder);
+  uint64_t nextOrder = (isLast ? 0 : (*std::next (pos))->m_queueOrder);
+
+  if (isFirst && isLast)
+    {
+      (*pos)->m_queueOrder = middle;
+    }
+  else if (isLast && prevOrder <= std::numeric_limits<uint64_t>::max () - step)
+    {
+      (*pos)->m_queueOrder = prevOrder + step;
+    }
+  else if (isFirst && nextOrder >= step)
+    {
+      (*pos)->m_queueOrder = nextOrder - step;
+    }
+  else if (!isFirst && !isLast && nextOrder - prevOrder >= 2)
+    {
+      (*pos)->m_queueOrder = prevOrder + (nextOrder - prevOrder) / 2;
+    }
+  else
+    {
+      NS_LOG_DEBUG ("Resetting the order of the queued items");
+      uint64_t order = middle;
+      for (auto it = begin (); it != end (); it++)
+        {
+          (*it)->m_queueOrder = order;
+          order += step;
+        }
+    }
+}
+
+void
+WifiMacQueue::AddToFlowQueue (ConstIterator pos)
+{
+  FlowQueue &flow = GetFlowQueue (*pos);
+  FlowQueue::const_iterator flowPos;
+
+  if (std::next (pos) == end ())
+    {
+      flowPos = flow.end ();
+    }
+  else if (pos == begin ())
+    {
+      flowPos = flow.begin ();
+    }
+  else if (FindFlowQueue (*std::prev (pos)) == &flow)
+    {
+      flowPos = std::next ((*std::prev (pos))->m_flowIt);
+    }
+  else if (FindFlowQueue (*std::next (pos)) == &flow)
+    {
+      flowPos = (*std::next (pos))->m_flowIt;
+    }
+  else
+    {
+      flowPos = LowerBound (flow, (*pos)->m_queueOrder);
+    }
+  (*pos)->m_flowIt = flow.insert (flowPos, pos);
+}
+
+void
+WifiMacQueue::RemoveFromFlowQueue (ConstIterator pos)
+{
+  Ptr<const WifiMacQueueItem> item = *pos;
+  if (item->GetHeader ().IsQosData ())
+    {
+      auto flow = m_flowQueues.find (WifiAddressTidPair (item->GetHeader ().GetAddr1 (),
+                                                         item->GetHeader ().GetQosTid ()));
+      NS_ASSERT (flow != m_flowQueues.end ());
+      flow->second.erase (item->m_flowIt);
+      if (flow->second.empty ())
+        {
+          m_flowQueues.erase (flow);
+        }
+    }
+  else
+    {
+      m_nonQosQueue.erase (item->m_flowIt);
+    }
+}
+
 bool
 WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
 {
@@ -518,6 +731,8 @@ WifiMacQueue::DoEnqueue (ConstIterator pos, Ptr<WifiMacQueueItem> item)
       // set item's information about its position in the queue
       item->m_queueAc = m_ac;
       item->m_queueIt = ret;
+      SetQueueOrder (ret);
+      AddToFlowQueue (ret);
       return true;
     }
   return false;
@@ -534,6 +749,10 @@ WifiMacQueue::DoDequeue (ConstIterator pos)
       return nullptr;
     }
 
+  if (pos != end ())
+    {
+      RemoveFromFlowQueue (pos);
+    }
   Ptr<WifiMacQueueItem> item = Queue<WifiMacQueueItem>::DoDequeue (pos);
 
   if (item != 0 && item->GetHeader ().IsQosData ())
@@ -559,6 +778,10 @@ WifiMacQueue::DoDequeue (ConstIterator pos)
 Ptr<WifiMacQueueItem>
 WifiMacQueue::DoRemove (ConstIterator pos)
 {
+  if (pos != end ())
+    {
+      RemoveFromFlowQueue (pos);
+    }
   Ptr<WifiMacQueueItem> item = Queue<WifiMacQueueItem>::DoRemove (pos);
 
   if (item != 0 && item->GetHeader ().IsQosData ())
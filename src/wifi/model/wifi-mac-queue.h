@@ -55,6 +55,11 @@ extern template class Queue<WifiMacQueueItem>;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * The positions of the QoS Data frames are also kept, in queue order, in
+ * a list per (receiver address, TID) pair, and those of the other frames
+ * in another list, so that the search of the first frame of a flow does not
+ * go through the frames of the other flows.
  */
 class WifiMacQueue : public Queue<WifiMacQueueItem>
 {
@@ -145,7 +150,9 @@ public:
    * frame or QoS Data frame) having the receiver address equal to <i>addr</i>.
    * If <i>pos</i> is a valid iterator, the search starts from the packet pointed
    * to by the given iterator.
-   * This method does not remove the packet from the queue.
+   * This method does not remove the packet from the queue. The complexity is
+   * linear in the number of flows of the destination and in the number of
+   * frames that are not QoS Data frames.
    *
    * \param dest the given destination
    * \param pos the iterator pointing to the packet the search starts from
@@ -157,7 +164,8 @@ public:
    * Search and return, if present in the queue, the first packet having the
    * TID equal to <i>tid</i>. If <i>pos</i> is a valid iterator, the search starts
    * from the packet pointed to by the given iterator.
-   * This method does not remove the packet from the queue.
+   * This method does not remove the packet from the queue. The complexity is
+   * linear in the number of flows.
    *
    * \param tid the given TID
    * \param pos the iterator pointing to the packet the search starts from
@@ -171,7 +179,8 @@ public:
    * If <i>pos</i> is a valid iterator, the search starts from the packet pointed
    * to by the given iterator. This method does not remove the packet from the queue.
    * It is typically used by ns3::QosTxop in order to perform correct MSDU aggregation
-   * (A-MSDU).
+   * (A-MSDU). The complexity is constant, apart from the skipped expired packets,
+   * if <i>pos</i> is not valid or points to, or just after, a packet of the flow.
    *
    * \param tid the given TID
    * \param dest the given destination
@@ -182,6 +191,9 @@ public:
   ConstIterator PeekByTidAndAddress (uint8_t tid, Mac48Address dest, ConstIterator pos = EMPTY) const;
   /**
    * Return first available packet for transmission. The packet is not removed from queue.
+   * The complexity is constant, apart from the skipped expired packets, until
+   * a packet to a blocked destination is found; the search then goes through
+   * the flows that are not blocked.
    *
    * \param blockedPackets the destination address & TID pairs that are waiting for a BlockAck response
    * \param pos the iterator pointing to the packet the search starts from
@@ -298,7 +310,88 @@ public:
   static const ConstIterator EMPTY;         //!< Invalid iterator to signal an empty queue
 
 
+protected:
+  void DoDispose (void) override;
+
 private:
+  /// Positions in the queue of the MPDUs of a flow, in queue order
+  typedef std::list<ConstIterator> FlowQueue;
+
+  /**
+   * Get the list of the positions of the flow of the given MPDU, creating it
+   * if needed.
+   *
+   * \param item the given MPDU
+   * \return the list of the positions of the flow of the MPDU
+   */
+  FlowQueue & GetFlowQueue (Ptr<const WifiMacQueueItem> item);
+  /**
+   * Find the list of the positions of the flow of the given MPDU.
+   *
+   * \param item the given MPDU
+   * \return the list of the positions of the flow of the MPDU, or a null pointer
+   */
+  const FlowQueue * FindFlowQueue (Ptr<const WifiMacQueueItem> item) const;
+  /**
+   * Get the first position in the list of a flow whose MPDU has an order
+   * greater than or equal to the given order. The list is walked from both
+   * ends, hence the complexity is linear in the lower between the number of
+   * MPDUs of the flow before and after the returned position.
+   *
+   * \param flow the list of the positions of the flow
+   * \param order the given order
+   * \return the first position not before the given order
+   */
+  static FlowQueue::const_iterator LowerBound (const FlowQueue &flow, uint64_t order);
+  /**
+   * Get the first position in the list of a flow whose MPDU is stored at or
+   * after the given position in the queue.
+   *
+   * \param flow the list of the positions of the flow
+   * \param pos the position in the queue, or EMPTY for the head of the queue
+   * \return the first position of the flow at or after the given position
+   */
+  FlowQueue::const_iterator GetFlowPosition (const FlowQueue &flow, ConstIterator pos) const;
+  /**
+   * Return the first MPDU of the given flow that is stored at or after the
+   * given position in the queue and has not been in the queue for too long.
+   *
+   * \param flow the list of the positions of the flow
+   * \param pos the position in the queue, or EMPTY for the head of the queue
+   * \param now a copy of Simulator::Now()
+   * \return an iterator pointing to the MPDU, or end() if none
+   */
+  ConstIterator PeekFlow (const FlowQueue &flow, ConstIterator pos, const Time& now) const;
+  /**
+   * Return the one of the two given positions that comes first in the queue.
+   * end() comes after all the positions.
+   *
+   * \param first a position in the queue
+   * \param second another position in the queue
+   * \return the position that comes first
+   */
+  ConstIterator GetEarliest (ConstIterator first, ConstIterator second) const;
+  /**
+   * Set the order of the item just inserted at the given position, between
+   * the orders of its neighbors. The orders of all the items are reset if
+   * there is no room between those of the neighbors.
+   *
+   * \param pos the position of the item
+   */
+  void SetQueueOrder (ConstIterator pos);
+  /**
+   * Add the item just inserted at the given position to the list of its flow.
+   *
+   * \param pos the position of the item
+   */
+  void AddToFlowQueue (ConstIterator pos);
+  /**
+   * Remove the item at the given position from the list of its flow.
+   *
+   * \param pos the position of the item
+   */
+  void RemoveFromFlowQueue (ConstIterator pos);
+
   /**
    * Wrapper for the DoEnqueue method provided by the base class that additionally
    * sets the iterator field of the item and updates internal statistics, if
@@ -336,6 +429,10 @@ private:
   std::unordered_map<WifiAddressTidPair, uint32_t, WifiAddressTidHash> m_nQueuedPackets;
   /// Per (MAC address, TID) pair queued bytes
   std::unordered_map<WifiAddressTidPair, uint32_t, WifiAddressTidHash> m_nQueuedBytes;
+  /// Per (MAC address, TID) pair positions of the queued QoS Data frames
+  std::unordered_map<WifiAddressTidPair, FlowQueue, WifiAddressTidHash> m_flowQueues;
+  /// Positions of the queued frames that are not QoS Data frames
+  FlowQueue m_nonQosQueue;
 
   /// Traced callback: fired when a packet is dropped due to lifetime expiration
   TracedCallback<Ptr<const WifiMacQueueItem> > m_traceExpired;
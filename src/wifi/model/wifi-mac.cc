@@ -93,6 +93,12 @@ WifiMac::GetDevice (void) const
   return m_device;
 }
 
+bool
+WifiMac::CanForwardPacketsTo (Mac48Address to) const
+{
+  return true;
+}
+
 void
 WifiMac::NotifyTx (Ptr<const Packet> packet)
 {
@@ -177,6 +177,14 @@ public:
    * false otherwise.
    */
   virtual bool SupportsSendFrom (void) const = 0;
+  /**
+   * \param to the address to which the packet should be sent.
+   * \return true if packets can be forwarded to the given destination
+   *         (e.g., the STA is associated), false otherwise.
+   *
+   * The default implementation returns true.
+   */
+  virtual bool CanForwardPacketsTo (Mac48Address to) const;
   /**
    * \param phy the physical layer attached to this MAC.
    */
@@ -27,6 +27,8 @@
 #include "wifi-net-device.h"
 #include "wifi-phy.h"
 #include "wifi-mac.h"
+#include "regular-wifi-mac.h"
+#include "multi-link-scheduler.h"
 #include "ns3/ht-configuration.h"
 #include "ns3/vht-configuration.h"
 #include "ns3/he-configuration.h"
@@ -55,18 +57,21 @@ WifiNetDevice::GetTypeId (void)
                    MakePointerChecker<Channel> ())
     .AddAttribute ("Phy", "The PHY layer attached to this device.",
                    PointerValue (),
-                   MakePointerAccessor (&WifiNetDevice::GetPhy,
+                   MakePointerAccessor (static_cast<Ptr<WifiPhy> (WifiNetDevice::*) (void) const>
+                                          (&WifiNetDevice::GetPhy),
                                         &WifiNetDevice::SetPhy),
                    MakePointerChecker<WifiPhy> ())
     .AddAttribute ("Mac", "The MAC layer attached to this device.",
                    PointerValue (),
-                   MakePointerAccessor (&WifiNetDevice::GetMac,
+                   MakePointerAccessor (static_cast<Ptr<WifiMac> (WifiNetDevice::*) (void) const>
+                                          (&WifiNetDevice::GetMac),
                                         &WifiNetDevice::SetMac),
                    MakePointerChecker<WifiMac> ())
     .AddAttribute ("RemoteStationManager", "The station manager attached to this device.",
                    PointerValue (),
                    MakePointerAccessor (&WifiNetDevice::SetRemoteStationManager,
-                                        &WifiNetDevice::GetRemoteStationManager),
+                                        static_cast<Ptr<WifiRemoteStationManager> (WifiNetDevice::*) (void) const>
+                                          (&WifiNetDevice::GetRemoteStationManager)),
                    MakePointerChecker<WifiRemoteStationManager> ())
     .AddAttribute ("HtConfiguration",
                    "The HtConfiguration object.",
@@ -83,12 +88,19 @@ WifiNetDevice::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&WifiNetDevice::GetHeConfiguration),
                    MakePointerChecker<HeConfiguration> ())
+    .AddAttribute ("MultiLinkScheduler",
+                   "The scheduler distributing the packets among the links of "
+                   "a multi-link device (null if the device has a single link).",
+                   PointerValue (),
+                   MakePointerAccessor (&WifiNetDevice::GetMultiLinkScheduler),
+                   MakePointerChecker<MultiLinkScheduler> ())
   ;
   return tid;
 }
 
 WifiNetDevice::WifiNetDevice ()
-  : m_configComplete (false)
+  : m_linkUp (false),
+    m_configComplete (false)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -103,6 +115,18 @@ WifiNetDevice::DoDispose (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_node = 0;
+  if (m_mlScheduler)
+    {
+      m_mlScheduler->Dispose ();
+      m_mlScheduler = 0;
+    }
+  for (auto& link : m_otherLinks)
+    {
+      link.mac->Dispose ();
+      link.phy->Dispose ();
+      link.stationManager->Dispose ();
+    }
+  m_otherLinks.clear ();
   if (m_mac)
     {
       m_mac->Dispose ();
@@ -152,6 +176,12 @@ WifiNetDevice::DoInitialize (void)
     {
       m_stationManager->Initialize ();
     }
+  for (auto& link : m_otherLinks)
+    {
+      link.phy->Initialize ();
+      link.mac->Initialize ();
+      link.stationManager->Initialize ();
+    }
   NetDevice::DoInitialize ();
 }
 
@@ -166,16 +196,28 @@ WifiNetDevice::CompleteConfig (void)
     {
       return;
     }
-  m_mac->SetWifiRemoteStationManager (m_stationManager);
-  m_mac->SetWifiPhy (m_phy);
-  m_mac->SetForwardUpCallback (MakeCallback (&WifiNetDevice::ForwardUp, this));
-  m_mac->SetLinkUpCallback (MakeCallback (&WifiNetDevice::LinkUp, this));
-  m_mac->SetLinkDownCallback (MakeCallback (&WifiNetDevice::LinkDown, this));
-  m_stationManager->SetupPhy (m_phy);
-  m_stationManager->SetupMac (m_mac);
+  for (uint8_t linkId = 0; linkId < GetNLinks (); linkId++)
+    {
+      ConnectLink (linkId);
+    }
   m_configComplete = true;
 }
 
+void
+WifiNetDevice::ConnectLink (uint8_t linkId)
+{
+  Ptr<WifiMac> mac = GetMac (linkId);
+  Ptr<WifiPhy> phy = GetPhy (linkId);
+  Ptr<WifiRemoteStationManager> stationManager = GetRemoteStationManager (linkId);
+  mac->SetWifiRemoteStationManager (stationManager);
+  mac->SetWifiPhy (phy);
+  mac->SetForwardUpCallback (MakeCallback (&WifiNetDevice::ForwardUpFromLink, this).Bind (linkId));
+  mac->SetLinkUpCallback (MakeCallback (&WifiNetDevice::LinkUp, this).Bind (linkId));
+  mac->SetLinkDownCallback (MakeCallback (&WifiNetDevice::LinkDown, this).Bind (linkId));
+  stationManager->SetupPhy (phy);
+  stationManager->SetupMac (mac);
+}
+
 void
 WifiNetDevice::SetMac (const Ptr<WifiMac> mac)
 {
@@ -215,6 +257,78 @@ WifiNetDevice::GetRemoteStationManager (void) const
   return m_stationManager;
 }
 
+void
+WifiNetDevice::AddLink (const Ptr<WifiPhy> phy, const Ptr<WifiMac> mac,
+                        const Ptr<WifiRemoteStationManager> manager)
+{
+  NS_LOG_FUNCTION (this << phy << mac << manager);
+  NS_ABORT_MSG_IF (m_phy == 0 || m_mac == 0 || m_stationManager == 0,
+                   "The first link must be set before adding other links");
+  NS_ABORT_MSG_IF (phy == 0 || mac == 0 || manager == 0, "Incomplete link");
+  NS_ABORT_MSG_IF (GetNLinks () == 255, "Too many links");
+
+  if (m_mlScheduler == 0)
+    {
+      m_mlScheduler = CreateObject<MultiLinkScheduler> ();
+      m_mlScheduler->AddLink (DynamicCast<RegularWifiMac> (m_mac));
+      m_mlScheduler->SetForwardUpCallback (MakeCallback (&WifiNetDevice::ForwardUp, this));
+    }
+  uint8_t linkId = GetNLinks ();
+  m_otherLinks.push_back ({phy, mac, manager});
+  mac->SetAddress (m_mac->GetAddress ());
+  m_mlScheduler->AddLink (DynamicCast<RegularWifiMac> (mac));
+  if (m_configComplete)
+    {
+      ConnectLink (linkId);
+    }
+}
+
+uint8_t
+WifiNetDevice::GetNLinks (void) const
+{
+  return static_cast<uint8_t> (1 + m_otherLinks.size ());
+}
+
+Ptr<WifiMac>
+WifiNetDevice::GetMac (uint8_t linkId) const
+{
+  NS_ASSERT (linkId < GetNLinks ());
+  return (linkId == 0 ? m_mac : m_otherLinks[linkId - 1].mac);
+}
+
+Ptr<WifiPhy>
+WifiNetDevice::GetPhy (uint8_t linkId) const
+{
+  NS_ASSERT (linkId < GetNLinks ());
+  return (linkId == 0 ? m_phy : m_otherLinks[linkId - 1].phy);
+}
+
+Ptr<WifiRemoteStationManager>
+WifiNetDevice::GetRemoteStationManager (uint8_t linkId) const
+{
+  NS_ASSERT (linkId < GetNLinks ());
+  return (linkId == 0 ? m_stationManager : m_otherLinks[linkId - 1].stationManager);
+}
+
+uint8_t
+WifiNetDevice::GetLinkId (Ptr<const WifiPhy> phy) const
+{
+  for (uint8_t linkId = 1; linkId < GetNLinks (); linkId++)
+    {
+      if (m_otherLinks[linkId - 1].phy == phy)
+        {
+          return linkId;
+        }
+    }
+  return 0;
+}
+
+Ptr<MultiLinkScheduler>
+WifiNetDevice::GetMultiLinkScheduler (void) const
+{
+  return m_mlScheduler;
+}
+
 void
 WifiNetDevice::SetIfIndex (const uint32_t index)
 {
@@ -237,6 +351,10 @@ void
 WifiNetDevice::SetAddress (Address address)
 {
   m_mac->SetAddress (Mac48Address::ConvertFrom (address));
+  for (auto& link : m_otherLinks)
+    {
+      link.mac->SetAddress (Mac48Address::ConvertFrom (address));
+    }
 }
 
 Address
@@ -328,7 +446,14 @@ WifiNetDevice::Send (Ptr<Packet> packet, const Address& dest, uint16_t protocolN
   packet->AddHeader (llc);
 
   m_mac->NotifyTx (packet);
-  m_mac->Enqueue (packet, realTo);
+  if (m_mlScheduler != 0)
+    {
+      m_mlScheduler->Enqueue (packet, realTo, m_mac->GetAddress ());
+    }
+  else
+    {
+      m_mac->Enqueue (packet, realTo);
+    }
   return true;
 }
 
@@ -400,16 +525,36 @@ WifiNetDevice::ForwardUp (Ptr<const Packet> packet, Mac48Address from, Mac48Addr
 }
 
 void
-WifiNetDevice::LinkUp (void)
+WifiNetDevice::ForwardUpFromLink (uint8_t linkId, Ptr<const Packet> packet, Mac48Address from, Mac48Address to)
 {
+  NS_LOG_FUNCTION (this << +linkId << packet << from << to);
+  if (m_mlScheduler != 0 && to.IsGroup () && GetMac (linkId)->GetTypeOfStation () == STA
+      && !m_upLinks.empty () && linkId != *m_upLinks.begin ())
+    {
+      NS_LOG_DEBUG ("Copy of a group addressed packet received on link " << +linkId);
+      return;
+    }
+  if (m_mlScheduler != 0)
+    {
+      m_mlScheduler->Receive (packet, from, to);
+      return;
+    }
+  ForwardUp (packet, from, to);
+}
+
+void
+WifiNetDevice::LinkUp (uint8_t linkId)
+{
+  m_upLinks.insert (linkId);
   m_linkUp = true;
   m_linkChanges ();
 }
 
 void
-WifiNetDevice::LinkDown (void)
+WifiNetDevice::LinkDown (uint8_t linkId)
 {
-  m_linkUp = false;
+  m_upLinks.erase (linkId);
+  m_linkUp = !m_upLinks.empty ();
   m_linkChanges ();
 }
 
@@ -428,7 +573,14 @@ WifiNetDevice::SendFrom (Ptr<Packet> packet, const Address& source, const Addres
   packet->AddHeader (llc);
 
   m_mac->NotifyTx (packet);
-  m_mac->Enqueue (packet, realTo, realFrom);
+  if (m_mlScheduler != 0)
+    {
+      m_mlScheduler->Enqueue (packet, realTo, realFrom);
+    }
+  else
+    {
+      m_mac->Enqueue (packet, realTo, realFrom);
+    }
 
   return true;
 }
@@ -438,6 +590,10 @@ WifiNetDevice::SetPromiscReceiveCallback (PromiscReceiveCallback cb)
 {
   m_promiscRx = cb;
   m_mac->SetPromisc ();
+  for (auto& link : m_otherLinks)
+    {
+      link.mac->SetPromisc ();
+    }
 }
 
 bool
@@ -23,6 +23,8 @@
 
 #include "ns3/net-device.h"
 #include "ns3/traced-callback.h"
+#include <set>
+#include <vector>
 
 namespace ns3 {
 
@@ -32,6 +34,7 @@ class WifiMac;
 class HtConfiguration;
 class VhtConfiguration;
 class HeConfiguration;
+class MultiLinkScheduler;
 
 /// This value conforms to the 802.11 specification
 static const uint16_t MAX_MSDU_SIZE = 2304;
@@ -49,6 +52,16 @@ static const uint16_t MAX_MSDU_SIZE = 2304;
  *
  * This class holds together ns3::Channel, ns3::WifiPhy,
  * ns3::WifiMac, and, ns3::WifiRemoteStationManager.
+ *
+ * A multi-link device (MLD) has a WifiPhy, a WifiMac and a
+ * WifiRemoteStationManager for each of its links, all the MACs having the
+ * address of the device.  The PHY, MAC and remote station manager set by
+ * SetPhy, SetMac and SetRemoteStationManager are those of the first link
+ * (link 0), which is also the link used by the NetDevice methods that
+ * refer to a single MAC (e.g., the MAC traces of sent and received packets
+ * are those of the first link).  The other links are added by AddLink, and
+ * the packets sent by the device are distributed among the links by a
+ * MultiLinkScheduler.
  */
 class WifiNetDevice : public NetDevice
 {
@@ -87,6 +100,49 @@ public:
    */
   Ptr<WifiRemoteStationManager> GetRemoteStationManager (void) const;
 
+  /**
+   * Add a link to this device, which becomes a multi-link device.  The
+   * PHY, MAC and remote station manager of the first link must have been
+   * set, and the MACs must support QoS.  The MAC of the new link is given
+   * the address of the device.
+   *
+   * \param phy the PHY of the link
+   * \param mac the MAC of the link
+   * \param manager the remote station manager of the link
+   */
+  void AddLink (const Ptr<WifiPhy> phy, const Ptr<WifiMac> mac,
+                const Ptr<WifiRemoteStationManager> manager);
+  /**
+   * \returns the number of links of this device (1 unless links were added)
+   */
+  uint8_t GetNLinks (void) const;
+  /**
+   * \param linkId the ID of the link
+   * \returns the MAC of the given link
+   */
+  Ptr<WifiMac> GetMac (uint8_t linkId) const;
+  /**
+   * \param linkId the ID of the link
+   * \returns the PHY of the given link
+   */
+  Ptr<WifiPhy> GetPhy (uint8_t linkId) const;
+  /**
+   * \param linkId the ID of the link
+   * \returns the remote station manager of the given link
+   */
+  Ptr<WifiRemoteStationManager> GetRemoteStationManager (uint8_t linkId) const;
+  /**
+   * \param phy the PHY of a link of this device
+   * \returns the ID of the link of the given PHY (0 if the given PHY is
+   *          not the PHY of another link)
+   */
+  uint8_t GetLinkId (Ptr<const WifiPhy> phy) const;
+  /**
+   * \returns the scheduler distributing the packets among the links, or a
+   *          null pointer if this device has a single link
+   */
+  Ptr<MultiLinkScheduler> GetMultiLinkScheduler (void) const;
+
   /**
    * \param htConfiguration pointer to HtConfiguration
    */
@@ -170,25 +226,60 @@ private:
    */
   WifiNetDevice &operator = (const WifiNetDevice &o);
 
+  /**
+   * Receive a packet from the MAC of a link.  A multi-link STA only passes
+   * up the group addressed packets received on its first link that is up,
+   * since the AP sends a copy of them on each of its links.  The unicast
+   * packets received by a multi-link device are passed up through the
+   * MultiLinkScheduler, which restores their order across the links.
+   *
+   * \param linkId the ID of the link
+   * \param packet the packet to forward up
+   * \param from the source address
+   * \param to the destination address
+   */
+  void ForwardUpFromLink (uint8_t linkId, Ptr<const Packet> packet, Mac48Address from, Mac48Address to);
   /**
    * Set that the link is up. A link is always up in ad-hoc mode.
    * For a STA, a link is up when the STA is associated with an AP.
+   * The device is up when one of its links is up.
+   *
+   * \param linkId the ID of the link
    */
-  void LinkUp (void);
+  void LinkUp (uint8_t linkId);
   /**
    * Set that the link is down (i.e. STA is not associated).
+   *
+   * \param linkId the ID of the link
    */
-  void LinkDown (void);
+  void LinkDown (uint8_t linkId);
   /**
    * Complete the configuration of this Wi-Fi device by
    * connecting all lower components (e.g. MAC, WifiRemoteStation) together.
    */
   void CompleteConfig (void);
+  /**
+   * Connect the PHY, MAC and remote station manager of a link together.
+   *
+   * \param linkId the ID of the link
+   */
+  void ConnectLink (uint8_t linkId);
+
+  /// The PHY, MAC and remote station manager of a link
+  struct Link
+  {
+    Ptr<WifiPhy> phy;                              //!< the PHY
+    Ptr<WifiMac> mac;                              //!< the MAC
+    Ptr<WifiRemoteStationManager> stationManager;  //!< the station manager
+  };
 
   Ptr<Node> m_node; //!< the node
   Ptr<WifiPhy> m_phy; //!< the phy
   Ptr<WifiMac> m_mac; //!< the MAC
   Ptr<WifiRemoteStationManager> m_stationManager; //!< the station manager
+  std::vector<Link> m_otherLinks; //!< the links other than the first one
+  std::set<uint8_t> m_upLinks; //!< the IDs of the links that are up
+  Ptr<MultiLinkScheduler> m_mlScheduler; //!< the multi-link scheduler
   Ptr<HtConfiguration> m_htConfiguration; //!< the HtConfiguration
   Ptr<VhtConfiguration> m_vhtConfiguration; //!< the VhtConfiguration
   Ptr<HeConfiguration> m_heConfiguration; //!< the HeConfiguration
@@ -471,6 +471,17 @@ WifiPhy::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&WifiPhy::m_postReceptionErrorModel),
                    MakePointerChecker<ErrorModel> ())
+    .AddAttribute ("AbstractedReception",
+                   "If true, the PHY headers and the MPDUs of a received PPDU are "
+                   "evaluated once, at the end of the PPDU, from the effective SNR "
+                   "of the PPDU (exponential effective SINR mapping of the SNR of "
+                   "each chunk of constant interference), instead of chunk by chunk "
+                   "at the end of each PHY header field and MPDU. This speeds up the "
+                   "simulation of large networks, at the expense of the accuracy of "
+                   "the reception of each PPDU.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&WifiPhy::m_abstractedReception),
+                   MakeBooleanChecker ())
     .AddAttribute ("Sifs",
                    "The duration of the Short Interframe Space. "
                    "NOTE that the default value is overwritten by the value defined "
@@ -580,6 +591,7 @@ WifiPhy::WifiPhy ()
     m_txSpatialStreams (0),
     m_rxSpatialStreams (0),
     m_wifiRadioEnergyModel (0),
+    m_abstractedReception (false),
     m_timeLastPreambleDetected (Seconds (0))
 {
   NS_LOG_FUNCTION (this);
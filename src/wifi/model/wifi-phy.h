@@ -1427,6 +1427,7 @@ private:
   Ptr<PreambleDetectionModel> m_preambleDetectionModel; //!< Preamble detection model
   Ptr<WifiRadioEnergyModel> m_wifiRadioEnergyModel;     //!< Wifi radio energy model
   Ptr<ErrorModel> m_postReceptionErrorModel;            //!< Error model for receive packet events
+  bool m_abstractedReception;                           //!< Flag whether the receptions are evaluated at the end of the PPDUs
   Time m_timeLastPreambleDetected;                      //!< Record the time the last preamble was detected
 
   Callback<void> m_capabilitiesChangedCallback; //!< Callback when PHY capabilities changed
@@ -245,7 +245,9 @@ WifiRemoteStationManager::GetVhtSupported (void) const
 {
   Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (m_wifiPhy->GetDevice ());
   Ptr<VhtConfiguration> vhtConfiguration = device->GetVhtConfiguration ();
-  if (vhtConfiguration)
+  //VHT is not supported in the 2.4 GHz band, where a link of a multi-link
+  //device may operate although the device has a VHT configuration
+  if (vhtConfiguration && m_wifiPhy->GetPhyBand () != WIFI_PHY_BAND_2_4GHZ)
     {
       return true;
     }
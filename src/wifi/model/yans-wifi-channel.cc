@@ -21,6 +21,7 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/propagation-loss-model.h"
@@ -53,11 +54,24 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "The distance beyond which the receivers are skipped, without "
+                   "computing their propagation loss, in meters. The receivers are "
+                   "found through a grid of their positions, so that a transmission "
+                   "costs only for the receivers near the transmitter. 0 considers "
+                   "all the receivers. Set it above the range at which the loss "
+                   "model gives a signal above the RX sensitivity.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0),
+    m_nCulledByRange (0),
+    m_nCulledByThreshold (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -65,6 +79,7 @@ YansWifiChannel::YansWifiChannel ()
 YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION (this);
+  m_index.Clear ();
   m_phyList.clear ();
 }
 
@@ -88,23 +103,45 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
   NS_LOG_FUNCTION (this << sender << ppdu << txPowerDbm);
   Ptr<MobilityModel> senderMobility = sender->GetMobility ();
   NS_ASSERT (senderMobility != 0);
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++)
+  std::vector<uint32_t> candidates;
+  std::size_t nReceivers = m_phyList.size ();
+  if (m_maxRange > 0)
     {
-      if (sender != (*i))
+      GetCandidates (senderMobility->GetPosition (), candidates);
+      m_nCulledByRange += m_phyList.size () - candidates.size ();
+      nReceivers = candidates.size ();
+    }
+  for (std::size_t j = 0; j < nReceivers; j++)
+    {
+      Ptr<YansWifiPhy> receiver = m_phyList[(m_maxRange > 0) ? candidates[j] : j];
+      if (sender != receiver)
         {
           //For now don't account for inter channel interference nor channel bonding
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (receiver->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+          Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+          if (m_maxRange > 0 && senderMobility->GetDistanceFrom (receiverMobility) > m_maxRange)
+            {
+              m_nCulledByRange++;
+              continue;
+            }
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+          // Do no further processing if signal is too weak
+          // Current implementation assumes constant RX power over the PPDU duration
+          if ((rxPowerDbm + receiver->GetRxGain ()) < receiver->GetRxSensitivity ())
+            {
+              NS_LOG_INFO ("Received signal too weak to process: " << rxPowerDbm << " dBm");
+              m_nCulledByThreshold++;
+              continue;
+            }
           Ptr<WifiPpdu> copy = ppdu->Copy ();
-          Ptr<NetDevice> dstNetDevice = (*i)->GetDevice ();
+          Ptr<NetDevice> dstNetDevice = receiver->GetDevice ();
           uint32_t dstNode;
           if (dstNetDevice == 0)
             {
@@ -117,7 +154,7 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double
 
           Simulator::ScheduleWithContext (dstNode,
                                           delay, &YansWifiChannel::Receive,
-                                          (*i), copy, rxPowerDbm);
+                                          receiver, copy, rxPowerDbm);
         }
     }
 }
@@ -126,18 +163,36 @@ void
 YansWifiChannel::Receive (Ptr<YansWifiPhy> phy, Ptr<WifiPpdu> ppdu, double rxPowerDbm)
 {
   NS_LOG_FUNCTION (phy << ppdu << rxPowerDbm);
-  // Do no further processing if signal is too weak
-  // Current implementation assumes constant RX power over the PPDU duration
-  if ((rxPowerDbm + phy->GetRxGain ()) < phy->GetRxSensitivity ())
-    {
-      NS_LOG_INFO ("Received signal too weak to process: " << rxPowerDbm << " dBm");
-      return;
-    }
   RxPowerWattPerChannelBand rxPowerW;
   rxPowerW.insert ({std::make_pair (0, 0), (DbmToW (rxPowerDbm + phy->GetRxGain ()))}); //dummy band for YANS
   phy->StartReceivePreamble (ppdu, rxPowerW, ppdu->GetTxDuration ());
 }
 
+void
+YansWifiChannel::GetCandidates (const Vector &position, std::vector<uint32_t> &phys) const
+{
+  // the mobility models are looked up only now, since they may be
+  // aggregated to the nodes after the PHYs are added to the channel
+  for (std::size_t i = m_index.GetN (); i < m_phyList.size (); i++)
+    {
+      m_index.Add (m_phyList[i]->GetMobility ());
+    }
+  m_index.SetCellSize (m_maxRange);
+  m_index.GetCandidates (position, m_maxRange, phys);
+}
+
+uint64_t
+YansWifiChannel::GetNCulledByRange (void) const
+{
+  return m_nCulledByRange;
+}
+
+uint64_t
+YansWifiChannel::GetNCulledByThreshold (void) const
+{
+  return m_nCulledByThreshold;
+}
+
 std::size_t
 YansWifiChannel::GetNDevices (void) const
 {
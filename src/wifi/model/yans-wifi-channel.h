@@ -22,6 +22,7 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include "ns3/channel.h"
+#include "ns3/mobility-grid-index.h"
 
 namespace ns3 {
 
@@ -41,6 +42,13 @@ class WifiPpdu;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * The receivers for which the signal is below their RX sensitivity are
+ * skipped when the signal is sent, without scheduling their reception.
+ * With the MaxRange attribute, the receivers farther than this range from
+ * the transmitter are skipped too, without computing their propagation
+ * loss; a MobilityGridIndex over the positions of the receivers avoids
+ * looking at each of them.
  */
 class YansWifiChannel : public Channel
 {
@@ -96,6 +104,17 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \return the number of receivers skipped because they were beyond
+   *         the MaxRange attribute
+   */
+  uint64_t GetNCulledByRange (void) const;
+
+  /**
+   * \return the number of receivers skipped because the signal was below
+   *         their RX sensitivity
+   */
+  uint64_t GetNCulledByThreshold (void) const;
 
 private:
   /**
@@ -114,9 +133,22 @@ private:
    */
   static void Receive (Ptr<YansWifiPhy> receiver, Ptr<WifiPpdu> ppdu, double txPowerDbm);
 
+  /**
+   * Get the receivers which may be in range of a transmitter, adding the
+   * PHYs added since the last call to the index
+   *
+   * \param position the position of the transmitter
+   * \param phys the receivers, in the order of the PHY list
+   */
+  void GetCandidates (const Vector &position, std::vector<uint32_t> &phys) const;
+
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_maxRange;                   //!< Range beyond which the receivers are skipped (m), 0 if none
+  mutable MobilityGridIndex m_index;   //!< Positions of the PHYs, used with m_maxRange
+  mutable uint64_t m_nCulledByRange;   //!< Number of receivers skipped by range
+  mutable uint64_t m_nCulledByThreshold; //!< Number of receivers skipped by RX sensitivity
 };
 
 } //namespace ns3
@@ -27,7 +27,13 @@
 #include "ns3/wifi-phy.h"
 #include "ns3/wifi-utils.h"
 #include "ns3/table-based-error-rate-model.h"
+#include "ns3/cached-error-rate-model.h"
+#include "ns3/object-factory.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
 #include "ns3/he-phy.h" //includes HT and VHT
+#include <fstream>
+#include <sstream>
 
 using namespace ns3;
 
@@ -1527,6 +1533,131 @@ TableBasedErrorRateTestCase::DoRun (void)
     }
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Check that the cached error rate model is close to the model it wraps,
+ * that its tables are shared by the models of the same type and freed with
+ * the last of them, and that they are the same once saved and loaded
+ */
+class CachedErrorRateTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   *
+   * \param model the type of the error rate model to wrap
+   */
+  CachedErrorRateTestCase (std::string model);
+  virtual ~CachedErrorRateTestCase ();
+
+private:
+  void DoRun (void) override;
+
+  /**
+   * Read a file
+   *
+   * \param fileName the name of the file
+   * \return the content of the file
+   */
+  static std::string ReadFile (std::string fileName);
+
+  std::string m_model; ///< The type of the error rate model to wrap
+};
+
+CachedErrorRateTestCase::CachedErrorRateTestCase (std::string model)
+  : TestCase ("Cached error rate model wrapping " + model),
+    m_model (model)
+{
+}
+
+CachedErrorRateTestCase::~CachedErrorRateTestCase ()
+{
+}
+
+void
+CachedErrorRateTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("cached-error-rate-tables.txt");
+  ObjectFactory factory (m_model);
+  Ptr<ErrorRateModel> model = factory.Create<ErrorRateModel> ();
+  Ptr<CachedErrorRateModel> cached = CreateObject<CachedErrorRateModel> ();
+  cached->SetAttribute ("ErrorRateModel", PointerValue (model));
+
+  std::vector<WifiMode> modes {WifiMode ("OfdmRate6Mbps"), WifiMode ("OfdmRate54Mbps"),
+                               HtPhy::GetHtMcs3 (), VhtPhy::GetVhtMcs8 (), HePhy::GetHeMcs11 ()};
+  std::vector<uint64_t> sizes {1, 24, 100, 1500 * 8, 65535 * 8};
+  for (const auto &mode : modes)
+    {
+      WifiTxVector txVector;
+      txVector.SetMode (mode);
+      txVector.SetChannelWidth (mode.GetModulationClass () >= WIFI_MOD_CLASS_VHT ? 80 : 20);
+      for (double snr = -12; snr <= 52; snr += 0.0371)
+        {
+          for (auto nbits : sizes)
+            {
+              double exact = model->GetChunkSuccessRate (mode, txVector, std::pow (10.0, snr / 10.0), nbits);
+              double csr = cached->GetChunkSuccessRate (mode, txVector, std::pow (10.0, snr / 10.0), nbits);
+              NS_TEST_ASSERT_MSG_EQ_TOL (csr, exact, 1e-4, mode << " snr=" << snr << "dB nbits=" << nbits);
+            }
+        }
+    }
+  cached->SaveTables (fileName);
+
+  // a cached model wrapping another model of the same type shares the tables
+  Ptr<CachedErrorRateModel> shared = CreateObject<CachedErrorRateModel> ();
+  shared->SetAttribute ("ErrorRateModel", PointerValue (factory.Create<ErrorRateModel> ()));
+  std::string sharedFileName = CreateTempDirFilename ("cached-error-rate-shared-tables.txt");
+  shared->SaveTables (sharedFileName);
+  NS_TEST_ASSERT_MSG_EQ (ReadFile (sharedFileName), ReadFile (fileName), "Tables not shared");
+
+  std::vector<double> expected;
+  for (const auto &mode : modes)
+    {
+      WifiTxVector txVector;
+      txVector.SetMode (mode);
+      txVector.SetChannelWidth (mode.GetModulationClass () >= WIFI_MOD_CLASS_VHT ? 80 : 20);
+      for (double snr = -5; snr <= 45; snr += 0.31)
+        {
+          expected.push_back (cached->GetChunkSuccessRate (mode, txVector, std::pow (10.0, snr / 10.0), 1500 * 8));
+        }
+    }
+
+  // the tables are freed with the last cached model using them, and those
+  // of the next one are loaded from the file
+  std::string saved = ReadFile (fileName);
+  std::string headerOnly = saved.substr (0, saved.find ('\n') + 1);
+  cached = 0;
+  shared = 0;
+  Ptr<CachedErrorRateModel> loaded = CreateObject<CachedErrorRateModel> ();
+  loaded->SetAttribute ("ErrorRateModel", PointerValue (factory.Create<ErrorRateModel> ()));
+  loaded->SaveTables (sharedFileName);
+  NS_TEST_ASSERT_MSG_EQ (ReadFile (sharedFileName), headerOnly, "Tables not freed");
+  loaded->SetAttribute ("TableFile", StringValue (fileName));
+  std::size_t i = 0;
+  for (const auto &mode : modes)
+    {
+      WifiTxVector txVector;
+      txVector.SetMode (mode);
+      txVector.SetChannelWidth (mode.GetModulationClass () >= WIFI_MOD_CLASS_VHT ? 80 : 20);
+      for (double snr = -5; snr <= 45; snr += 0.31)
+        {
+          double csr = loaded->GetChunkSuccessRate (mode, txVector, std::pow (10.0, snr / 10.0), 1500 * 8);
+          NS_TEST_ASSERT_MSG_EQ (csr, expected[i++], "Loaded tables differ for " << mode << " snr=" << snr << "dB");
+        }
+    }
+}
+
+std::string
+CachedErrorRateTestCase::ReadFile (std::string fileName)
+{
+  std::ifstream file (fileName);
+  std::ostringstream oss;
+  oss << file.rdbuf ();
+  return oss.str ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1545,6 +1676,8 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseMimo, TestCase::QUICK);
+  AddTestCase (new CachedErrorRateTestCase ("ns3::NistErrorRateModel"), TestCase::QUICK);
+  AddTestCase (new CachedErrorRateTestCase ("ns3::YansErrorRateModel"), TestCase::QUICK);
   AddTestCase (new TableBasedErrorRateTestCase ("DefaultTableBasedHtMcs0-1458bytes", HtPhy::GetHtMcs0 (), 1458), TestCase::QUICK);
   AddTestCase (new TableBasedErrorRateTestCase ("DefaultTableBasedHtMcs0-32bytes", HtPhy::GetHtMcs0 (), 32), TestCase::QUICK);
   AddTestCase (new TableBasedErrorRateTestCase ("DefaultTableBasedHtMcs0-1000bytes", HtPhy::GetHtMcs0 (), 1000), TestCase::QUICK);
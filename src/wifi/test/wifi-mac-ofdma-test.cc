@@ -20,6 +20,7 @@
 
 #include "ns3/test.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "ns3/qos-utils.h"
 #include "ns3/packet.h"
 #include "ns3/wifi-net-device.h"
@@ -39,7 +40,10 @@
 #include "ns3/rng-seed-manager.h"
 #include "ns3/wifi-psdu.h"
 #include "ns3/multi-user-scheduler.h"
+#include "ns3/ofdma-scheduling-policy.h"
+#include "ns3/he-ru.h"
 #include "ns3/he-phy.h"
+#include <cmath>
 
 using namespace ns3;
 
@@ -344,10 +348,12 @@ public:
    * \param txopLimit the TXOP limit in microseconds
    * \param nPktsPerSta number of packets to send to/receive from each station
    * \param muEdcaParameterSet the MU EDCA Parameter Set
+   * \param frameBodyByReference whether the bodies of the control frames are
+   *                             passed by reference rather than serialized
    */
   OfdmaAckSequenceTest (uint16_t width, WifiAcknowledgment::Method dlType, uint32_t maxAmpduSize,
                         uint16_t txopLimit, uint16_t nPktsPerSta,
-                        MuEdcaParameterSet muEdcaParameterSet);
+                        MuEdcaParameterSet muEdcaParameterSet, bool frameBodyByReference = false);
   virtual ~OfdmaAckSequenceTest ();
 
   /**
@@ -402,6 +408,7 @@ private:
   uint16_t m_txopLimit;                      ///< TXOP limit in microseconds
   uint16_t m_nPktsPerSta;                    ///< number of packets to send to each station
   MuEdcaParameterSet m_muEdcaParameterSet;   ///< MU EDCA Parameter Set
+  bool m_frameBodyByReference;               ///< whether control frame bodies are passed by reference
   uint16_t m_received;                       ///< number of packets received by the stations
   uint16_t m_flushed;                        ///< number of DL packets flushed after DL MU PPDU
   Time m_edcaDisabledStartTime;              ///< time when disabling EDCA started
@@ -411,8 +418,10 @@ private:
 OfdmaAckSequenceTest::OfdmaAckSequenceTest (uint16_t width, WifiAcknowledgment::Method dlType,
                                             uint32_t maxAmpduSize, uint16_t txopLimit,
                                             uint16_t nPktsPerSta,
-                                            MuEdcaParameterSet muEdcaParameterSet)
-  : TestCase ("Check correct operation of DL OFDMA acknowledgment sequences"),
+                                            MuEdcaParameterSet muEdcaParameterSet,
+                                            bool frameBodyByReference)
+  : TestCase ("Check correct operation of DL OFDMA acknowledgment sequences"
+              + std::string (frameBodyByReference ? " (frame bodies by reference)" : "")),
     m_nStations (4),
     m_channelWidth (width),
     m_dlMuAckType (dlType),
@@ -420,6 +429,7 @@ OfdmaAckSequenceTest::OfdmaAckSequenceTest (uint16_t width, WifiAcknowledgment::
     m_txopLimit (txopLimit),
     m_nPktsPerSta (nPktsPerSta),
     m_muEdcaParameterSet (muEdcaParameterSet),
+    m_frameBodyByReference (frameBodyByReference),
     m_received (0),
     m_flushed (0),
     m_edcaDisabledStartTime (Seconds (0)),
@@ -1095,6 +1105,8 @@ OfdmaAckSequenceTest::DoRun (void)
   RngSeedManager::SetRun (2);
   int64_t streamNumber = 100;
 
+  Config::SetGlobal ("WifiFrameBodyByReference", BooleanValue (m_frameBodyByReference));
+
   NodeContainer wifiApNode;
   wifiApNode.Create (1);
 
@@ -1301,6 +1313,313 @@ OfdmaAckSequenceTest::DoRun (void)
                 apBeQosTxop->GetAifsn ());
 
   Simulator::Destroy ();
+  Config::SetGlobal ("WifiFrameBodyByReference", BooleanValue (false));
+}
+
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test the scheduling policies of the round robin multi-user scheduler
+ *
+ * This test checks that the table of RU allocations provided by HeRu matches
+ * the RUs computed on demand and that the proportional fair and the max
+ * throughput scheduling policies rank stations as expected. Then, an AP with
+ * 8 associated stations and a round robin multi-user scheduler granting an RU
+ * to at most 4 stations sends a burst of packets to every station. All the
+ * stations have the same data rate, hence the max throughput policy sends the
+ * first two DL MU PPDUs of the burst to the stations with the lowest AIDs
+ * (ties are broken by AID), while the proportional fair policy sends the
+ * second DL MU PPDU to the stations that were not served by the first one.
+ */
+class OfdmaSchedulingPolicyTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param policy the TypeId of the scheduling policy
+   */
+  OfdmaSchedulingPolicyTest (TypeId policy);
+  virtual ~OfdmaSchedulingPolicyTest ();
+
+  /**
+   * Function to trace packets received by the server application
+   * \param context the context
+   * \param p the packet
+   * \param addr the address
+   */
+  void L7Receive (std::string context, Ptr<const Packet> p, const Address &addr);
+  /**
+   * Callback invoked when FrameExchangeManager passes PSDUs to the PHY
+   * \param context the context
+   * \param psduMap the PSDU map
+   * \param txVector the TX vector
+   * \param txPowerW the tx power in Watts
+   */
+  void Transmit (std::string context, WifiConstPsduMap psduMap, WifiTxVector txVector, double txPowerW);
+
+private:
+  void DoRun (void) override;
+
+  /// Check the table of RU allocations provided by HeRu
+  void CheckRuAllocationTable (void);
+  /// Check the priorities returned by the scheduling policies
+  void CheckPolicies (void);
+
+  TypeId m_policy;                                 ///< the TypeId of the scheduling policy
+  uint16_t m_nStations;                            ///< number of stations
+  uint16_t m_nPktsPerSta;                          ///< number of packets of the burst sent to each station
+  uint16_t m_received;                             ///< number of packets received by the stations
+  std::vector<std::set<uint16_t>> m_dlMuPpduStaIds; ///< the STA-IDs of the DL MU PPDUs sent in the burst
+};
+
+OfdmaSchedulingPolicyTest::OfdmaSchedulingPolicyTest (TypeId policy)
+  : TestCase ("Check the scheduling policies of the round robin multi-user scheduler ("
+              + policy.GetName () + ")"),
+    m_policy (policy),
+    m_nStations (8),
+    m_nPktsPerSta (60),
+    m_received (0)
+{
+}
+
+OfdmaSchedulingPolicyTest::~OfdmaSchedulingPolicyTest ()
+{
+}
+
+void
+OfdmaSchedulingPolicyTest::L7Receive (std::string context, Ptr<const Packet> p, const Address &addr)
+{
+  m_received++;
+}
+
+void
+OfdmaSchedulingPolicyTest::Transmit (std::string context, WifiConstPsduMap psduMap, WifiTxVector txVector, double txPowerW)
+{
+  // record the DL MU PPDUs carrying the burst, which starts at 1.5 seconds
+  if (Simulator::Now () >= Seconds (1.5) && txVector.IsDlMu ())
+    {
+      std::set<uint16_t> staIds;
+      for (const auto& psdu : psduMap)
+        {
+          staIds.insert (psdu.first);
+        }
+      m_dlMuPpduStaIds.push_back (staIds);
+    }
+}
+
+void
+OfdmaSchedulingPolicyTest::CheckRuAllocationTable (void)
+{
+  for (uint16_t bw : {20, 40, 80, 160})
+    {
+      for (std::size_t n = 1; n <= HeRu::GetNRus (bw, HeRu::RU_26_TONE) + 1; n++)
+        {
+          std::size_t nStations = n;
+          std::size_t nCentral26TonesRus;
+          HeRu::RuType ruType = HeRu::GetEqualSizedRusForStations (bw, nStations, nCentral26TonesRus);
+          const HeRu::EqualSizedRuAllocation& allocation = HeRu::GetEqualSizedRuAllocation (bw, n);
+
+          NS_TEST_EXPECT_MSG_EQ (allocation.ruType, ruType, "Unexpected RU type for " << n
+                                 << " stations and a bandwidth of " << bw << " MHz");
+          NS_TEST_EXPECT_MSG_EQ (allocation.rus.size (), nStations, "Unexpected number of RUs for "
+                                 << n << " stations and a bandwidth of " << bw << " MHz");
+          NS_TEST_EXPECT_MSG_EQ (allocation.central26TonesRus.size (), nCentral26TonesRus,
+                                 "Unexpected number of central 26-tone RUs for " << n
+                                 << " stations and a bandwidth of " << bw << " MHz");
+
+          std::vector<HeRu::RuSpec> expected = HeRu::GetRusOfType (bw, ruType);
+          std::vector<HeRu::RuSpec> central26TonesRus = HeRu::GetCentral26TonesRus (bw, ruType);
+          expected.insert (expected.end (), central26TonesRus.begin (), central26TonesRus.end ());
+          std::vector<HeRu::RuSpec> rus = allocation.rus;
+          rus.insert (rus.end (), allocation.central26TonesRus.begin (), allocation.central26TonesRus.end ());
+
+          NS_TEST_ASSERT_MSG_EQ (rus.size (), expected.size (), "Unexpected number of RUs");
+          for (std::size_t i = 0; i < rus.size (); i++)
+            {
+              NS_TEST_EXPECT_MSG_EQ ((rus[i].GetRuType () == expected[i].GetRuType ()
+                                      && rus[i].GetIndex () == expected[i].GetIndex ()
+                                      && rus[i].GetPrimary80MHz () == expected[i].GetPrimary80MHz ()),
+                                     true, "Unexpected RU " << rus[i] << " (expected " << expected[i] << ")");
+            }
+        }
+    }
+}
+
+void
+OfdmaSchedulingPolicyTest::CheckPolicies (void)
+{
+  Mac48Address sta1 ("00:00:00:00:00:01");
+  Mac48Address sta2 ("00:00:00:00:00:02");
+
+  Ptr<MaxThroughputSchedulingPolicy> mt = CreateObject<MaxThroughputSchedulingPolicy> ();
+  mt->NotifyScheduled (sta1, 100000);
+  NS_TEST_EXPECT_MSG_GT (mt->GetPriority (sta1, 100e6), mt->GetPriority (sta2, 50e6),
+                         "The station with the highest rate must have the highest priority");
+
+  Ptr<ProportionalFairSchedulingPolicy> pf = CreateObject<ProportionalFairSchedulingPolicy> ();
+  NS_TEST_EXPECT_MSG_GT (pf->GetPriority (sta1, 100e6), pf->GetPriority (sta2, 50e6),
+                         "Without scheduled data, the station with the highest rate must come first");
+  pf->NotifyScheduled (sta1, 100000);
+  NS_TEST_EXPECT_MSG_LT (pf->GetPriority (sta1, 100e6), pf->GetPriority (sta2, 50e6),
+                         "The station for which data was scheduled must come second");
+  // 100000 bytes scheduled with a time constant of 100 ms
+  NS_TEST_EXPECT_MSG_EQ_TOL (pf->GetAverageThroughput (sta1), 8e6, 1,
+                             "Unexpected average throughput");
+
+  // the average throughput decays exponentially while nothing is scheduled
+  Simulator::Stop (MilliSeconds (100));
+  Simulator::Run ();
+  double avgThroughput = pf->GetAverageThroughput (sta1);
+  Simulator::Destroy ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (avgThroughput, 8e6 * std::exp (-1), 1,
+                             "Unexpected average throughput after one time constant");
+
+  pf->NotifyStationRemoved (sta1);
+  NS_TEST_EXPECT_MSG_EQ (pf->GetAverageThroughput (sta1), 0, "The state of the station was not removed");
+}
+
+void
+OfdmaSchedulingPolicyTest::DoRun (void)
+{
+  CheckRuAllocationTable ();
+  CheckPolicies ();
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  int64_t streamNumber = 100;
+
+  NodeContainer wifiApNode;
+  wifiApNode.Create (1);
+
+  NodeContainer wifiStaNodes;
+  wifiStaNodes.Create (m_nStations);
+
+  Ptr<MultiModelSpectrumChannel> spectrumChannel = CreateObject<MultiModelSpectrumChannel> ();
+  Ptr<FriisPropagationLossModel> lossModel = CreateObject<FriisPropagationLossModel> ();
+  spectrumChannel->AddPropagationLossModel (lossModel);
+  Ptr<ConstantSpeedPropagationDelayModel> delayModel = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  spectrumChannel->SetPropagationDelayModel (delayModel);
+
+  SpectrumWifiPhyHelper phy;
+  phy.SetErrorRateModel ("ns3::NistErrorRateModel");
+  phy.SetChannel (spectrumChannel);
+  phy.Set ("ChannelNumber", UintegerValue (36));
+  phy.Set ("ChannelWidth", UintegerValue (20));
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_STANDARD_80211ax_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::IdealWifiManager");
+
+  WifiMacHelper mac;
+  Ssid ssid = Ssid ("ns-3-ssid");
+  mac.SetType ("ns3::StaWifiMac",
+               "Ssid", SsidValue (ssid),
+               "ActiveProbing", BooleanValue (false));
+
+  NetDeviceContainer staDevices = wifi.Install (phy, mac, wifiStaNodes);
+
+  // the proportional fair policy forgets the packets sent before the burst
+  ObjectFactory factory (m_policy.GetName ());
+  if (m_policy == ProportionalFairSchedulingPolicy::GetTypeId ())
+    {
+      factory.Set ("TimeConstant", TimeValue (MilliSeconds (1)));
+    }
+
+  mac.SetType ("ns3::ApWifiMac",
+               "Ssid", SsidValue (ssid),
+               "BeaconGeneration", BooleanValue (true));
+  mac.SetMultiUserScheduler ("ns3::RrMultiUserScheduler",
+                             "NStations", UintegerValue (4),
+                             "EnableUlOfdma", BooleanValue (false),
+                             "SchedulingPolicy", PointerValue (factory.Create<OfdmaSchedulingPolicy> ()));
+
+  Ptr<NetDevice> apDevice = wifi.Install (phy, mac, wifiApNode).Get (0);
+
+  streamNumber += wifi.AssignStreams (NetDeviceContainer (apDevice), streamNumber);
+  streamNumber += wifi.AssignStreams (staDevices, streamNumber);
+
+  // all the stations are at the same distance from the AP
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  for (uint16_t i = 0; i < m_nStations; i++)
+    {
+      double angle = 2 * M_PI * i / m_nStations;
+      positionAlloc->Add (Vector (std::cos (angle), std::sin (angle), 0.0));
+    }
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiApNode);
+  mobility.Install (wifiStaNodes);
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (wifiApNode);
+  packetSocket.Install (wifiStaNodes);
+
+  for (uint16_t i = 0; i < m_nStations; i++)
+    {
+      PacketSocketAddress socket;
+      socket.SetSingleDevice (apDevice->GetIfIndex ());
+      socket.SetPhysicalAddress (staDevices.Get (i)->GetAddress ());
+      socket.SetProtocol (1);
+
+      // the first client application generates two packets in order
+      // to trigger the establishment of a Block Ack agreement
+      Ptr<PacketSocketClient> client1 = CreateObject<PacketSocketClient> ();
+      client1->SetAttribute ("PacketSize", UintegerValue (1400));
+      client1->SetAttribute ("MaxPackets", UintegerValue (2));
+      client1->SetAttribute ("Interval", TimeValue (MicroSeconds (0)));
+      client1->SetRemote (socket);
+      wifiApNode.Get (0)->AddApplication (client1);
+      client1->SetStartTime (Seconds (1) + i * MilliSeconds (10));
+      client1->SetStopTime (Seconds (2.0));
+
+      // the second client application generates the burst
+      Ptr<PacketSocketClient> client2 = CreateObject<PacketSocketClient> ();
+      client2->SetAttribute ("PacketSize", UintegerValue (1400));
+      client2->SetAttribute ("MaxPackets", UintegerValue (m_nPktsPerSta));
+      client2->SetAttribute ("Interval", TimeValue (MicroSeconds (0)));
+      client2->SetRemote (socket);
+      wifiApNode.Get (0)->AddApplication (client2);
+      client2->SetStartTime (Seconds (1.5));
+      client2->SetStopTime (Seconds (2.5));
+
+      Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+      server->SetLocal (socket);
+      wifiStaNodes.Get (i)->AddApplication (server);
+      server->SetStartTime (Seconds (0.0));
+      server->SetStopTime (Seconds (3.0));
+    }
+
+  Config::Connect ("/NodeList/*/ApplicationList/0/$ns3::PacketSocketServer/Rx",
+                   MakeCallback (&OfdmaSchedulingPolicyTest::L7Receive, this));
+  Config::Connect ("/NodeList/*/DeviceList/*/$ns3::WifiNetDevice/Phy/PhyTxPsduBegin",
+                   MakeCallback (&OfdmaSchedulingPolicyTest::Transmit, this));
+
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, m_nStations * (m_nPktsPerSta + 2), "Not all packets were received");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (m_dlMuPpduStaIds.size (), 2, "Expected at least two DL MU PPDUs");
+
+  std::set<uint16_t> lowAids {1, 2, 3, 4};
+  std::set<uint16_t> highAids {5, 6, 7, 8};
+  NS_TEST_EXPECT_MSG_EQ ((m_dlMuPpduStaIds[0] == lowAids), true,
+                         "The first DL MU PPDU must be sent to the stations with the lowest AIDs");
+  if (m_policy == ProportionalFairSchedulingPolicy::GetTypeId ())
+    {
+      NS_TEST_EXPECT_MSG_EQ ((m_dlMuPpduStaIds[1] == highAids), true,
+                             "The second DL MU PPDU must be sent to the stations not served yet");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ ((m_dlMuPpduStaIds[1] == lowAids), true,
+                             "The second DL MU PPDU must be sent to the stations with the lowest AIDs");
+    }
+
+  Simulator::Destroy ();
 }
 
 
@@ -1332,6 +1651,18 @@ WifiMacOfdmaTestSuite::WifiMacOfdmaTestSuite ()
       AddTestCase (new OfdmaAckSequenceTest (40, WifiAcknowledgment::DL_MU_AGGREGATE_TF, 10000, 0, 15, muEdcaParameterSet), TestCase::QUICK);
       AddTestCase (new OfdmaAckSequenceTest (40, WifiAcknowledgment::DL_MU_TF_MU_BAR, 10000, 0, 15, muEdcaParameterSet), TestCase::QUICK);
     }
+
+  // the same exchanges must occur if the bodies of the control frames are passed by reference
+  for (auto dlType : {WifiAcknowledgment::DL_MU_BAR_BA_SEQUENCE,
+                      WifiAcknowledgment::DL_MU_AGGREGATE_TF,
+                      WifiAcknowledgment::DL_MU_TF_MU_BAR})
+    {
+      AddTestCase (new OfdmaAckSequenceTest (20, dlType, 10000, 5440, 15, {10, 127, 2047, 100}, true),
+                   TestCase::QUICK);
+    }
+
+  AddTestCase (new OfdmaSchedulingPolicyTest (ProportionalFairSchedulingPolicy::GetTypeId ()), TestCase::QUICK);
+  AddTestCase (new OfdmaSchedulingPolicyTest (MaxThroughputSchedulingPolicy::GetTypeId ()), TestCase::QUICK);
 }
 
 static WifiMacOfdmaTestSuite g_wifiMacOfdmaTestSuite; ///< the test suite
@@ -21,6 +21,10 @@
 #include "ns3/test.h"
 #include "ns3/wifi-mac-queue.h"
 #include "ns3/simulator.h"
+#include "ns3/qos-blocked-destinations.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/random-variable-stream.h"
+#include <functional>
 
 using namespace ns3;
 
@@ -107,6 +111,221 @@ WifiMacQueueDropOldestTest::DoRun ()
   Simulator::Destroy ();
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test the searches of the packets of a flow.
+ *
+ * This test verifies that PeekByAddress, PeekByTid, PeekByTidAndAddress and
+ * PeekFirstAvailable, which use the per-flow lists of the queue, return the
+ * packets found by a linear search of the queue, from various positions,
+ * while packets (some of which expired) are inserted at and removed from
+ * random positions.
+ */
+class WifiMacQueueFlowSearchTest : public TestCase
+{
+public:
+  /**
+   * \brief Constructor
+   */
+  WifiMacQueueFlowSearchTest ();
+
+  void DoRun () override;
+
+private:
+  /**
+   * Check the searches from the given position against linear searches.
+   *
+   * \param pos the position the searches start from
+   */
+  void CheckSearches (WifiMacQueue::ConstIterator pos);
+  /**
+   * Create a packet to enqueue.
+   *
+   * \return the packet
+   */
+  Ptr<WifiMacQueueItem> CreateItem (void);
+  /**
+   * Get a random position in the queue, end () included.
+   *
+   * \return the position
+   */
+  WifiMacQueue::ConstIterator GetRandomPosition (void);
+
+  Ptr<WifiMacQueue> m_queue;                          //!< the queue
+  Ptr<QosBlockedDestinations> m_blocked;              //!< the blocked destinations
+  Ptr<UniformRandomVariable> m_rv;                    //!< random variable
+  std::vector<Mac48Address> m_addresses;              //!< the receiver addresses
+};
+
+WifiMacQueueFlowSearchTest::WifiMacQueueFlowSearchTest ()
+  : TestCase ("Test the searches of the packets of a flow")
+{
+}
+
+Ptr<WifiMacQueueItem>
+WifiMacQueueFlowSearchTest::CreateItem (void)
+{
+  WifiMacHeader header;
+  uint32_t type = m_rv->GetInteger (0, 9);
+  if (type == 0)
+    {
+      header.SetType (WIFI_MAC_MGT_ACTION);
+    }
+  else if (type == 1)
+    {
+      header.SetType (WIFI_MAC_DATA);
+    }
+  else
+    {
+      header.SetType (WIFI_MAC_QOSDATA);
+      header.SetQosTid (m_rv->GetInteger (0, 3));
+    }
+  header.SetAddr1 (m_addresses[m_rv->GetInteger (0, m_addresses.size () - 1)]);
+  // one packet out of five has been in the queue for too long
+  Time tstamp = (m_rv->GetInteger (0, 4) == 0 ? Seconds (-1) : Seconds (0));
+  return Create<WifiMacQueueItem> (Create<Packet> (), header, tstamp);
+}
+
+WifiMacQueue::ConstIterator
+WifiMacQueueFlowSearchTest::GetRandomPosition (void)
+{
+  return std::next (m_queue->begin (), m_rv->GetInteger (0, m_queue->QueueBase::GetNPackets ()));
+}
+
+void
+WifiMacQueueFlowSearchTest::CheckSearches (WifiMacQueue::ConstIterator pos)
+{
+  const Time now = Simulator::Now ();
+  // linear search of the first packet satisfying the given predicate
+  auto search = [&] (std::function<bool (Ptr<const WifiMacQueueItem>)> predicate) -> WifiMacQueue::ConstIterator
+    {
+      for (auto it = (pos == WifiMacQueue::EMPTY ? m_queue->begin () : pos); it != m_queue->end (); it++)
+        {
+          if (now <= (*it)->GetTimeStamp () + m_queue->GetMaxDelay () && predicate (*it))
+            {
+              return it;
+            }
+        }
+      return m_queue->end ();
+    };
+
+  for (const auto& address : m_addresses)
+    {
+      auto expected = search ([&] (Ptr<const WifiMacQueueItem> item)
+                              {
+                                return (item->GetHeader ().IsData () || item->GetHeader ().IsQosData ())
+                                       && item->GetDestinationAddress () == address;
+                              });
+      NS_TEST_EXPECT_MSG_EQ ((m_queue->PeekByAddress (address, pos) == expected), true,
+                             "Unexpected packet found by PeekByAddress");
+      for (uint8_t tid = 0; tid < 4; tid++)
+        {
+          expected = search ([&] (Ptr<const WifiMacQueueItem> item)
+                             {
+                               return item->GetHeader ().IsQosData () && item->GetDestinationAddress () == address
+                                      && item->GetHeader ().GetQosTid () == tid;
+                             });
+          NS_TEST_EXPECT_MSG_EQ ((m_queue->PeekByTidAndAddress (tid, address, pos) == expected), true,
+                                 "Unexpected packet found by PeekByTidAndAddress");
+        }
+    }
+  for (uint8_t tid = 0; tid < 4; tid++)
+    {
+      auto expected = search ([&] (Ptr<const WifiMacQueueItem> item)
+                              {
+                                return item->GetHeader ().IsQosData () && item->GetHeader ().GetQosTid () == tid;
+                              });
+      NS_TEST_EXPECT_MSG_EQ ((m_queue->PeekByTid (tid, pos) == expected), true,
+                             "Unexpected packet found by PeekByTid");
+    }
+  auto expected = search ([&] (Ptr<const WifiMacQueueItem> item)
+                          {
+                            return !item->GetHeader ().IsQosData ()
+                                   || !m_blocked->IsBlocked (item->GetHeader ().GetAddr1 (),
+                                                             item->GetHeader ().GetQosTid ());
+                          });
+  NS_TEST_EXPECT_MSG_EQ ((m_queue->PeekFirstAvailable (m_blocked, pos) == expected), true,
+                         "Unexpected packet found by PeekFirstAvailable");
+}
+
+void
+WifiMacQueueFlowSearchTest::DoRun ()
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  m_rv = CreateObject<UniformRandomVariable> ();
+  m_rv->SetStream (1);
+  m_queue = CreateObject<WifiMacQueue> (AC_BE);
+  m_queue->SetMaxSize (QueueSize ("1000p"));
+  m_blocked = Create<QosBlockedDestinations> ();
+  for (uint32_t i = 1; i <= 4; i++)
+    {
+      std::ostringstream oss;
+      oss << "00:00:00:00:00:0" << i;
+      m_addresses.push_back (Mac48Address (oss.str ().c_str ()));
+    }
+  m_blocked->Block (m_addresses[0], 0);
+  m_blocked->Block (m_addresses[1], 2);
+
+  for (uint32_t i = 0; i < 500; i++)
+    {
+      // grow the queue up to about 50 packets, then keep its size
+      uint32_t op = m_rv->GetInteger (0, (m_queue->QueueBase::GetNPackets () < 50 ? 4 : 6));
+      if (op == 0)
+        {
+          m_queue->Enqueue (CreateItem ());
+        }
+      else if (op == 1)
+        {
+          m_queue->PushFront (CreateItem ());
+        }
+      else if (op <= 4)
+        {
+          m_queue->Insert (GetRandomPosition (), CreateItem ());
+        }
+      else if (op == 5 && !m_queue->QueueBase::IsEmpty ())
+        {
+          auto pos = GetRandomPosition ();
+          if (pos != m_queue->end ())
+            {
+              m_queue->Remove (pos, m_rv->GetInteger (0, 1) == 1);
+            }
+        }
+      else if (op == 6 && !m_queue->QueueBase::IsEmpty ())
+        {
+          auto pos = GetRandomPosition ();
+          if (pos != m_queue->end ())
+            {
+              m_queue->DequeueIfQueued (*pos);
+            }
+        }
+
+      CheckSearches (WifiMacQueue::EMPTY);
+      CheckSearches (GetRandomPosition ());
+    }
+
+  // keep inserting after the head of the queue, so that the orders of the
+  // packets are reset
+  for (uint32_t i = 0; i < 30; i++)
+    {
+      m_queue->Insert (std::next (m_queue->begin ()), CreateItem ());
+      CheckSearches (GetRandomPosition ());
+    }
+  CheckSearches (WifiMacQueue::EMPTY);
+
+  // the non-const methods remove the expired packets
+  m_queue->GetNPackets ();
+  CheckSearches (WifiMacQueue::EMPTY);
+  m_queue->Dispose ();
+  m_queue = 0;
+  m_rv = 0;
+  m_blocked = 0;
+
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -123,6 +342,7 @@ WifiMacQueueTestSuite::WifiMacQueueTestSuite ()
   : TestSuite ("wifi-mac-queue", UNIT)
 {
   AddTestCase (new WifiMacQueueDropOldestTest, TestCase::QUICK);
+  AddTestCase (new WifiMacQueueFlowSearchTest, TestCase::QUICK);
 }
 
 static WifiMacQueueTestSuite g_wifiMacQueueTestSuite; ///< the test suite
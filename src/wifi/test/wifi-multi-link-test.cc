@@ -0,0 +1,539 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <set>
+#include "ns3/test.h"
+#include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/packet.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/packet-socket-server.h"
+#include "ns3/packet-socket-client.h"
+#include "ns3/packet-socket-helper.h"
+#include "ns3/config.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/sta-wifi-mac.h"
+#include "ns3/ap-wifi-mac.h"
+#include "ns3/multi-link-scheduler.h"
+#include "ns3/wifi-mac-queue.h"
+
+using namespace ns3;
+
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test the transmission of packets between multi-link devices
+ *
+ * An AP and a non-AP STA, both multi-link devices (MLDs) with a link in the
+ * 5 GHz band and a link in the 6 GHz band, exchange a burst of packets in
+ * the downlink and in the uplink, all with the same TID.  The test checks
+ * that the affiliated STAs associate on both links, that the packets are
+ * distributed among the links and that every packet is received exactly
+ * once and in the order it was sent.  The AP then broadcasts a
+ * few packets, which must be sent on both links and received once.  The
+ * same burst is then sent between single-link devices, which must take
+ * longer to deliver it.  Finally, the downlink burst is sent through a
+ * queue of the AP MLD too small to hold it, and the packets it drops must be
+ * reported by the MacTxDrop trace.
+ */
+class WifiMultiLinkTest : public TestCase
+{
+public:
+  WifiMultiLinkTest ();
+  virtual ~WifiMultiLinkTest ();
+
+private:
+  void DoRun (void) override;
+
+  /**
+   * Send a burst of packets in each direction between an AP and a non-AP STA
+   * with the given number of links, and broadcast packets from the AP.
+   *
+   * \param nLinks the number of links (1 or 2)
+   * \param mldQueueSize the maximum number of packets in the queues of the
+   *                     AP MLD, or 0 for the default
+   * \return the time it took to receive the downlink burst
+   */
+  Time RunScenario (uint8_t nLinks, uint32_t mldQueueSize = 0);
+
+  /**
+   * Function to trace packets received by the server application
+   * \param context the context
+   * \param p the packet
+   * \param addr the address
+   */
+  void L7Receive (std::string context, Ptr<const Packet> p, const Address &addr);
+
+  /**
+   * Function to trace packets dropped by the MAC of the AP
+   * \param p the packet
+   */
+  void MacTxDrop (Ptr<const Packet> p);
+
+  const uint32_t m_nPackets {500};     ///< number of packets sent in each direction
+  const uint32_t m_packetSize {1000};  ///< size in bytes of the packets
+  const uint32_t m_nBroadcast {10};    ///< number of packets broadcast by the AP
+  const uint32_t m_broadcastSize {500}; ///< size in bytes of the broadcast packets
+  const Time m_startTime {Seconds (1)}; ///< start time of the downlink burst
+  uint32_t m_dlReceived;               ///< number of packets received by the STA
+  uint32_t m_ulReceived;               ///< number of packets received by the AP
+  uint32_t m_bcReceived;               ///< number of broadcast packets received by the STA
+  uint32_t m_dlDropped;                ///< number of packets dropped by the AP
+  uint32_t m_dlOutOfOrder;             ///< number of DL packets received after a packet sent later
+  uint32_t m_ulOutOfOrder;             ///< number of UL packets received after a packet sent later
+  uint64_t m_lastDlUid;                ///< UID of the last DL packet received
+  uint64_t m_lastUlUid;                ///< UID of the last UL packet received
+  std::set<uint64_t> m_dlUids;         ///< UIDs of the packets received by the STA
+  std::set<uint64_t> m_ulUids;         ///< UIDs of the packets received by the AP
+  std::set<uint64_t> m_bcUids;         ///< UIDs of the broadcast packets received by the STA
+  Time m_lastDlRx;                     ///< time the last downlink packet was received
+};
+
+WifiMultiLinkTest::WifiMultiLinkTest ()
+  : TestCase ("Check the transmission of packets between multi-link devices")
+{
+}
+
+WifiMultiLinkTest::~WifiMultiLinkTest ()
+{
+}
+
+void
+WifiMultiLinkTest::L7Receive (std::string context, Ptr<const Packet> p, const Address &addr)
+{
+  // the AP is node 0
+  // the packets of a client are created, hence numbered, in order
+  if (context.find ("/NodeList/0/") == 0)
+    {
+      if (m_ulReceived > 0 && p->GetUid () < m_lastUlUid)
+        {
+          m_ulOutOfOrder++;
+        }
+      m_ulReceived++;
+      m_ulUids.insert (p->GetUid ());
+      m_lastUlUid = p->GetUid ();
+    }
+  else if (p->GetSize () == m_broadcastSize)
+    {
+      m_bcReceived++;
+      m_bcUids.insert (p->GetUid ());
+    }
+  else
+    {
+      if (m_dlReceived > 0 && p->GetUid () < m_lastDlUid)
+        {
+          m_dlOutOfOrder++;
+        }
+      m_dlReceived++;
+      m_dlUids.insert (p->GetUid ());
+      m_lastDlUid = p->GetUid ();
+      m_lastDlRx = Simulator::Now ();
+    }
+}
+
+void
+WifiMultiLinkTest::MacTxDrop (Ptr<const Packet> p)
+{
+  m_dlDropped++;
+}
+
+Time
+WifiMultiLinkTest::RunScenario (uint8_t nLinks, uint32_t mldQueueSize)
+{
+  m_dlReceived = 0;
+  m_ulReceived = 0;
+  m_bcReceived = 0;
+  m_dlDropped = 0;
+  m_dlOutOfOrder = 0;
+  m_ulOutOfOrder = 0;
+  m_lastDlUid = 0;
+  m_lastUlUid = 0;
+  m_dlUids.clear ();
+  m_ulUids.clear ();
+  m_bcUids.clear ();
+  m_lastDlRx = Seconds (0);
+
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  int64_t streamNumber = 100;
+
+  NodeContainer wifiApNode;
+  wifiApNode.Create (1);
+  NodeContainer wifiStaNode;
+  wifiStaNode.Create (1);
+
+  YansWifiPhyHelper phy5;
+  phy5.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  YansWifiPhyHelper phy6;
+  phy6.SetChannel (YansWifiChannelHelper::Default ().Create ());
+
+  std::vector<const WifiPhyHelper*> phys {&phy5, &phy6};
+  std::vector<WifiStandard> standards {WIFI_STANDARD_80211ax_5GHZ, WIFI_STANDARD_80211ax_6GHZ};
+  phys.resize (nLinks);
+  standards.resize (nLinks);
+
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("HeMcs7"),
+                                "ControlMode", StringValue ("OfdmRate24Mbps"));
+
+  WifiMacHelper mac;
+  Ssid ssid ("wifi-multi-link-ssid");
+  mac.SetType ("ns3::StaWifiMac",
+               "Ssid", SsidValue (ssid));
+  NetDeviceContainer staDevices = wifi.Install (phys, standards, mac, wifiStaNode);
+
+  mac.SetType ("ns3::ApWifiMac",
+               "Ssid", SsidValue (ssid),
+               "EnableBeaconJitter", BooleanValue (false));
+  NetDeviceContainer apDevices = wifi.Install (phys, standards, mac, wifiApNode);
+
+  wifi.AssignStreams (apDevices, streamNumber);
+  wifi.AssignStreams (staDevices, streamNumber + 100);
+
+  MobilityHelper mobility;
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 0.0));
+  positionAlloc->Add (Vector (1.0, 0.0, 0.0));
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (wifiApNode);
+  mobility.Install (wifiStaNode);
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (wifiApNode);
+  packetSocket.Install (wifiStaNode);
+
+  // DL burst at m_startTime, UL burst one second later
+  NetDeviceContainer txDevices[2] = {apDevices, staDevices};
+  NetDeviceContainer rxDevices[2] = {staDevices, apDevices};
+  NodeContainer txNodes[2] = {wifiApNode, wifiStaNode};
+  NodeContainer rxNodes[2] = {wifiStaNode, wifiApNode};
+  for (uint8_t i = 0; i < 2; i++)
+    {
+      PacketSocketAddress socket;
+      socket.SetSingleDevice (txDevices[i].Get (0)->GetIfIndex ());
+      socket.SetPhysicalAddress (rxDevices[i].Get (0)->GetAddress ());
+      socket.SetProtocol (1);
+
+      Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+      client->SetAttribute ("PacketSize", UintegerValue (m_packetSize));
+      client->SetAttribute ("MaxPackets", UintegerValue (m_nPackets));
+      client->SetAttribute ("Interval", TimeValue (MicroSeconds (0)));
+      client->SetRemote (socket);
+      txNodes[i].Get (0)->AddApplication (client);
+      client->SetStartTime (m_startTime + Seconds (i));
+      client->SetStopTime (Seconds (4));
+
+      Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+      server->SetLocal (socket);
+      rxNodes[i].Get (0)->AddApplication (server);
+      server->SetStartTime (Seconds (0));
+      server->SetStopTime (Seconds (4));
+    }
+
+  // broadcast packets after the bursts
+  PacketSocketAddress broadcast;
+  broadcast.SetSingleDevice (apDevices.Get (0)->GetIfIndex ());
+  broadcast.SetPhysicalAddress (apDevices.Get (0)->GetBroadcast ());
+  broadcast.SetProtocol (1);
+  Ptr<PacketSocketClient> bcClient = CreateObject<PacketSocketClient> ();
+  bcClient->SetAttribute ("PacketSize", UintegerValue (m_broadcastSize));
+  bcClient->SetAttribute ("MaxPackets", UintegerValue (m_nBroadcast));
+  bcClient->SetAttribute ("Interval", TimeValue (MilliSeconds (1)));
+  bcClient->SetRemote (broadcast);
+  wifiApNode.Get (0)->AddApplication (bcClient);
+  bcClient->SetStartTime (m_startTime + Seconds (2));
+  bcClient->SetStopTime (Seconds (4));
+
+  Config::Connect ("/NodeList/*/ApplicationList/*/$ns3::PacketSocketServer/Rx",
+                   MakeCallback (&WifiMultiLinkTest::L7Receive, this));
+
+  Ptr<WifiNetDevice> apDev = DynamicCast<WifiNetDevice> (apDevices.Get (0));
+  Ptr<WifiNetDevice> staDev = DynamicCast<WifiNetDevice> (staDevices.Get (0));
+  apDev->GetMac ()->TraceConnectWithoutContext ("MacTxDrop", MakeCallback (&WifiMultiLinkTest::MacTxDrop, this));
+  if (mldQueueSize > 0)
+    {
+      apDev->GetMultiLinkScheduler ()->GetQueue (AC_BE)->SetMaxSize (QueueSize (QueueSizeUnit::PACKETS, mldQueueSize));
+    }
+
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (+apDev->GetNLinks (), +nLinks, "Unexpected number of links of the AP");
+  NS_TEST_EXPECT_MSG_EQ (+staDev->GetNLinks (), +nLinks, "Unexpected number of links of the STA");
+
+  for (uint8_t linkId = 0; linkId < nLinks; linkId++)
+    {
+      Ptr<StaWifiMac> staMac = DynamicCast<StaWifiMac> (staDev->GetMac (linkId));
+      NS_TEST_EXPECT_MSG_EQ (staMac->IsAssociated (), true,
+                             "The STA is not associated on link " << +linkId);
+      NS_TEST_EXPECT_MSG_EQ (staMac->GetAddress (), staDev->GetMac ()->GetAddress (),
+                             "All the MACs of an MLD must have the address of the device");
+      NS_TEST_EXPECT_MSG_EQ (DynamicCast<ApWifiMac> (apDev->GetMac (linkId))->CanForwardPacketsTo (staMac->GetAddress ()),
+                             true, "The AP cannot forward packets to the STA on link " << +linkId);
+    }
+
+  Ptr<MultiLinkScheduler> apScheduler = apDev->GetMultiLinkScheduler ();
+  Ptr<MultiLinkScheduler> staScheduler = staDev->GetMultiLinkScheduler ();
+  NS_TEST_EXPECT_MSG_EQ ((apScheduler != 0), (nLinks > 1),
+                         "Only multi-link devices have a multi-link scheduler");
+  NS_TEST_EXPECT_MSG_EQ ((staScheduler != 0), (nLinks > 1),
+                         "Only multi-link devices have a multi-link scheduler");
+
+  if (apScheduler != 0 && staScheduler != 0)
+    {
+      uint64_t dlTotal = 0;
+      uint64_t ulTotal = 0;
+      for (uint8_t linkId = 0; linkId < nLinks; linkId++)
+        {
+          uint64_t dl = apScheduler->GetNPacketsToLink (AC_BE, linkId);
+          uint64_t ul = staScheduler->GetNPacketsToLink (AC_BE, linkId);
+          NS_TEST_EXPECT_MSG_GT (dl, 0, "No DL packet sent on link " << +linkId);
+          NS_TEST_EXPECT_MSG_GT (ul, 0, "No UL packet sent on link " << +linkId);
+          dlTotal += dl;
+          ulTotal += ul;
+        }
+      // each broadcast packet is handed to both links
+      NS_TEST_EXPECT_MSG_EQ (dlTotal, m_nPackets - m_dlDropped + nLinks * m_nBroadcast,
+                             "Unexpected number of DL packets handed to the links");
+      NS_TEST_EXPECT_MSG_EQ (ulTotal, m_nPackets, "Unexpected number of UL packets handed to the links");
+      NS_TEST_EXPECT_MSG_EQ (apScheduler->GetQueue (AC_BE)->IsEmpty (), true,
+                             "The MLD queue of the AP should be empty");
+    }
+
+  if (mldQueueSize > 0)
+    {
+      NS_TEST_EXPECT_MSG_GT (m_dlDropped, 0, "The queue of the AP MLD should have dropped packets");
+    }
+  else
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_dlDropped, 0, "Unexpected packets dropped by the AP");
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_dlReceived, m_nPackets - m_dlDropped, "Unexpected number of DL packets received");
+  NS_TEST_EXPECT_MSG_EQ (m_dlUids.size (), m_dlReceived, "DL packets received more than once");
+  NS_TEST_EXPECT_MSG_EQ (m_bcReceived, m_nBroadcast, "Unexpected number of broadcast packets received");
+  NS_TEST_EXPECT_MSG_EQ (m_bcUids.size (), m_nBroadcast, "Broadcast packets received more than once");
+  NS_TEST_EXPECT_MSG_EQ (m_ulReceived, m_nPackets, "Unexpected number of UL packets received");
+  NS_TEST_EXPECT_MSG_EQ (m_ulUids.size (), m_nPackets, "UL packets received more than once");
+  NS_TEST_EXPECT_MSG_EQ (m_dlOutOfOrder, 0, "DL packets received out of order");
+  NS_TEST_EXPECT_MSG_EQ (m_ulOutOfOrder, 0, "UL packets received out of order");
+
+  Simulator::Destroy ();
+  return m_lastDlRx - m_startTime;
+}
+
+void
+WifiMultiLinkTest::DoRun (void)
+{
+  Time singleLink = RunScenario (1);
+  Time multiLink = RunScenario (2);
+
+  NS_TEST_EXPECT_MSG_LT (multiLink, singleLink,
+                         "Two links should deliver the burst faster than one link");
+
+  RunScenario (2, 50);
+}
+
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Test the reordering of the packets received by a multi-link device
+ *
+ * Packets carrying a MultiLinkSequenceTag are passed to the
+ * MultiLinkScheduler of a multi-link STA as if they were received by its
+ * links.  The test checks that a packet received ahead of a missing one is
+ * passed up once the missing one is received or once the reorder timeout
+ * expires, that a duplicate packet is discarded, that a late packet is
+ * passed up at once, and that the packets of another TID or tagged for
+ * another receiver are not held.
+ */
+class WifiMultiLinkReorderTest : public TestCase
+{
+public:
+  WifiMultiLinkReorderTest ();
+  virtual ~WifiMultiLinkReorderTest ();
+
+private:
+  void DoRun (void) override;
+
+  /**
+   * Pass a packet to the MultiLinkScheduler as if it was received by a link.
+   *
+   * \param receiver the receiver set in the tag of the packet
+   * \param tid the TID of the packet
+   * \param sequenceNumber the sequence number of the packet
+   */
+  void Receive (Mac48Address receiver, uint8_t tid, uint64_t sequenceNumber);
+
+  /**
+   * Record a packet passed up by the MultiLinkScheduler.
+   *
+   * \param packet the packet
+   * \param from the source address
+   * \param to the destination address
+   */
+  void ForwardUp (Ptr<const Packet> packet, Mac48Address from, Mac48Address to);
+
+  /**
+   * Check the sequence numbers of the packets passed up so far.
+   *
+   * \param expected the expected sequence numbers, in order
+   */
+  void CheckForwardedUp (std::vector<uint64_t> expected);
+
+  Ptr<MultiLinkScheduler> m_scheduler;   ///< the scheduler of the STA
+  Mac48Address m_address;                ///< the address of the STA
+  const Mac48Address m_transmitter {"00:00:00:00:00:aa"}; ///< the address of the sender
+  std::vector<uint64_t> m_forwardedUp;   ///< the sequence numbers of the packets passed up
+};
+
+WifiMultiLinkReorderTest::WifiMultiLinkReorderTest ()
+  : TestCase ("Check the reordering of the packets received by a multi-link device")
+{
+}
+
+WifiMultiLinkReorderTest::~WifiMultiLinkReorderTest ()
+{
+}
+
+void
+WifiMultiLinkReorderTest::Receive (Mac48Address receiver, uint8_t tid, uint64_t sequenceNumber)
+{
+  // the size of the packet is its sequence number
+  Ptr<Packet> packet = Create<Packet> (sequenceNumber);
+  MultiLinkSequenceTag tag;
+  tag.SetTransmitter (m_transmitter);
+  tag.SetReceiver (receiver);
+  tag.SetTid (tid);
+  tag.SetSequenceNumber (sequenceNumber);
+  packet->AddByteTag (tag);
+  m_scheduler->Receive (packet, m_transmitter, m_address);
+}
+
+void
+WifiMultiLinkReorderTest::ForwardUp (Ptr<const Packet> packet, Mac48Address from, Mac48Address to)
+{
+  NS_TEST_EXPECT_MSG_EQ (from, m_transmitter, "Unexpected source address");
+  NS_TEST_EXPECT_MSG_EQ (to, m_address, "Unexpected destination address");
+  m_forwardedUp.push_back (packet->GetSize ());
+}
+
+void
+WifiMultiLinkReorderTest::CheckForwardedUp (std::vector<uint64_t> expected)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_forwardedUp.size (), expected.size (),
+                         "Unexpected number of packets passed up at " << Simulator::Now ().As (Time::MS));
+  for (std::size_t i = 0; i < expected.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_forwardedUp[i], expected[i],
+                             "Unexpected packet passed up at " << Simulator::Now ().As (Time::MS));
+    }
+}
+
+void
+WifiMultiLinkReorderTest::DoRun (void)
+{
+  NodeContainer wifiStaNode;
+  wifiStaNode.Create (1);
+
+  YansWifiPhyHelper phy5;
+  phy5.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  YansWifiPhyHelper phy6;
+  phy6.SetChannel (YansWifiChannelHelper::Default ().Create ());
+
+  WifiHelper wifi;
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("HeMcs7"),
+                                "ControlMode", StringValue ("OfdmRate24Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::StaWifiMac",
+               "Ssid", SsidValue (Ssid ("wifi-multi-link-ssid")));
+  NetDeviceContainer staDevices = wifi.Install ({&phy5, &phy6},
+                                                {WIFI_STANDARD_80211ax_5GHZ, WIFI_STANDARD_80211ax_6GHZ},
+                                                mac, wifiStaNode);
+
+  Ptr<WifiNetDevice> staDev = DynamicCast<WifiNetDevice> (staDevices.Get (0));
+  m_address = staDev->GetMac ()->GetAddress ();
+  m_scheduler = staDev->GetMultiLinkScheduler ();
+  m_scheduler->SetForwardUpCallback (MakeCallback (&WifiMultiLinkReorderTest::ForwardUp, this));
+  TimeValue timeout;
+  m_scheduler->GetAttribute ("ReorderTimeout", timeout);
+  Time start = Seconds (1);
+
+  // packet 1 is missing: packets 2 and 3 wait for it until the timeout
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::Receive, this, m_address, 0, 0);
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::Receive, this, m_address, 0, 2);
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::Receive, this, m_address, 0, 3);
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::CheckForwardedUp, this,
+                       std::vector<uint64_t> {0});
+  // a duplicate is discarded, and does not restart the timer
+  Simulator::Schedule (start + timeout.Get () / 2, &WifiMultiLinkReorderTest::Receive, this, m_address, 0, 3);
+  Simulator::Schedule (start + timeout.Get () - NanoSeconds (1), &WifiMultiLinkReorderTest::CheckForwardedUp, this,
+                       std::vector<uint64_t> {0});
+  Simulator::Schedule (start + timeout.Get () + NanoSeconds (1), &WifiMultiLinkReorderTest::CheckForwardedUp, this,
+                       std::vector<uint64_t> {0, 2, 3});
+  // packet 5 is missing, then received: packets 6 and 5 are passed up at once
+  start += Seconds (1);
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::Receive, this, m_address, 0, 4);
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::Receive, this, m_address, 0, 6);
+  Simulator::Schedule (start + MilliSeconds (1), &WifiMultiLinkReorderTest::Receive, this, m_address, 0, 5);
+  Simulator::Schedule (start + MilliSeconds (1), &WifiMultiLinkReorderTest::CheckForwardedUp, this,
+                       std::vector<uint64_t> {0, 2, 3, 4, 5, 6});
+  // the late packet 1, the packets of another TID and the packets tagged
+  // for another receiver are passed up at once
+  start += Seconds (1);
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::Receive, this, m_address, 0, 1);
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::Receive, this, m_address, 5, 0);
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::Receive, this, m_transmitter, 0, 8);
+  Simulator::Schedule (start, &WifiMultiLinkReorderTest::CheckForwardedUp, this,
+                       std::vector<uint64_t> {0, 2, 3, 4, 5, 6, 1, 0, 8});
+
+  Simulator::Stop (start + Seconds (1));
+  Simulator::Run ();
+  CheckForwardedUp ({0, 2, 3, 4, 5, 6, 1, 0, 8});
+  m_scheduler = 0;
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief wifi multi-link Test Suite
+ */
+class WifiMultiLinkTestSuite : public TestSuite
+{
+public:
+  WifiMultiLinkTestSuite ();
+};
+
+WifiMultiLinkTestSuite::WifiMultiLinkTestSuite ()
+  : TestSuite ("wifi-multi-link", UNIT)
+{
+  AddTestCase (new WifiMultiLinkTest (), TestCase::QUICK);
+  AddTestCase (new WifiMultiLinkReorderTest (), TestCase::QUICK);
+}
+
+static WifiMultiLinkTestSuite g_wifiMultiLinkTestSuite; ///< the test suite
@@ -28,6 +28,7 @@
 #include "ns3/packet-socket-helper.h"
 #include "ns3/packet-socket-server.h"
 #include "ns3/test.h"
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/pointer.h"
 #include "ns3/rng-seed-manager.h"
@@ -2550,6 +2551,195 @@ TestUnsupportedModulationReception::CheckResults (void)
   NS_TEST_EXPECT_MSG_EQ (m_dropped, 0, "Dropped some packets unexpectedly");
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Abstracted reception test
+ *
+ * The PHY evaluates the reception of the PHY header and of the MPDUs of an
+ * A-MPDU at the end of the PPDU, from the effective SNR of the PPDU.  An
+ * A-MPDU received at a high SNR is correctly received, and its MPDUs are
+ * notified one by one before the end of the reception.  The same A-MPDU,
+ * interfered during part of its payload, is lost: the effective SNR is
+ * dominated by the chunk with interference.  A PPDU received below the noise
+ * floor is lost because of its PHY header.
+ */
+class TestAbstractedReception : public TestCase
+{
+public:
+  TestAbstractedReception ();
+  virtual ~TestAbstractedReception ();
+
+protected:
+  void DoSetup (void) override;
+  void DoTeardown (void) override;
+
+private:
+  void DoRun (void) override;
+
+  /**
+   * Send an A-MPDU
+   * \param rxPowerDbm the received power in dBm
+   * \param nMpdus the number of MPDUs in the A-MPDU
+   */
+  void SendAmpdu (double rxPowerDbm, std::size_t nMpdus);
+  /**
+   * Spectrum wifi receive success function
+   * \param psdu the PSDU
+   * \param rxSignalInfo the info on the received signal (\see RxSignalInfo)
+   * \param txVector the transmit vector
+   * \param statusPerMpdu reception status per MPDU
+   */
+  void RxSuccess (Ptr<WifiPsdu> psdu, RxSignalInfo rxSignalInfo,
+                  WifiTxVector txVector, std::vector<bool> statusPerMpdu);
+  /**
+   * Spectrum wifi receive failure function
+   * \param psdu the PSDU
+   */
+  void RxFailure (Ptr<WifiPsdu> psdu);
+  /**
+   * Check the receptions and reset the counters
+   * \param expectedMpdus the expected number of MPDUs notified before the end of the A-MPDU
+   * \param expectedSuccess the expected number of correctly received PPDUs
+   * \param expectedFailure the expected number of PPDUs received with errors
+   */
+  void CheckRx (uint32_t expectedMpdus, uint32_t expectedSuccess, uint32_t expectedFailure);
+
+  Ptr<SpectrumWifiPhy> m_phy; ///< Phy
+  uint32_t m_countRxMpdus;    ///< count MPDUs notified before the end of the A-MPDU
+  uint32_t m_countRxSuccess;  ///< count correctly received PPDUs
+  uint32_t m_countRxFailure;  ///< count PPDUs received with errors
+  uint64_t m_uid;             ///< the UID to use for the PPDU
+};
+
+TestAbstractedReception::TestAbstractedReception ()
+  : TestCase ("Abstracted reception test"),
+    m_countRxMpdus (0),
+    m_countRxSuccess (0),
+    m_countRxFailure (0),
+    m_uid (0)
+{
+}
+
+TestAbstractedReception::~TestAbstractedReception ()
+{
+  m_phy = 0;
+}
+
+void
+TestAbstractedReception::SendAmpdu (double rxPowerDbm, std::size_t nMpdus)
+{
+  WifiTxVector txVector = WifiTxVector (HePhy::GetHeMcs5 (), 0, WIFI_PREAMBLE_HE_SU, 800, 1, 1, 0, 20, true);
+
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+
+  std::vector<Ptr<WifiMacQueueItem>> mpduList;
+  for (std::size_t i = 0; i < nMpdus; ++i)
+    {
+      mpduList.push_back (Create<WifiMacQueueItem> (Create<Packet> (1000), hdr));
+    }
+  Ptr<WifiPsdu> psdu = Create<WifiPsdu> (mpduList);
+
+  Time txDuration = m_phy->CalculateTxDuration (psdu->GetSize (), txVector, m_phy->GetPhyBand ());
+
+  Ptr<WifiPpdu> ppdu = Create<HePpdu> (psdu, txVector, txDuration, WIFI_PHY_BAND_5GHZ, m_uid++);
+
+  Ptr<SpectrumValue> txPowerSpectrum = WifiSpectrumValueHelper::CreateHeOfdmTxPowerSpectralDensity (FREQUENCY, CHANNEL_WIDTH, DbmToW (rxPowerDbm), GUARD_WIDTH);
+
+  Ptr<WifiSpectrumSignalParameters> txParams = Create<WifiSpectrumSignalParameters> ();
+  txParams->psd = txPowerSpectrum;
+  txParams->txPhy = 0;
+  txParams->duration = txDuration;
+  txParams->ppdu = ppdu;
+
+  m_phy->StartRx (txParams);
+}
+
+void
+TestAbstractedReception::RxSuccess (Ptr<WifiPsdu> psdu, RxSignalInfo rxSignalInfo,
+                                    WifiTxVector txVector, std::vector<bool> statusPerMpdu)
+{
+  NS_LOG_FUNCTION (this << *psdu << rxSignalInfo << txVector);
+  if (statusPerMpdu.empty ())
+    {
+      //MPDU of an A-MPDU notified before the end of the reception
+      m_countRxMpdus++;
+      return;
+    }
+  NS_TEST_EXPECT_MSG_EQ (std::count (statusPerMpdu.begin (), statusPerMpdu.end (), true), m_countRxMpdus,
+                         "The status of the MPDUs does not match the MPDUs notified");
+  m_countRxSuccess++;
+}
+
+void
+TestAbstractedReception::RxFailure (Ptr<WifiPsdu> psdu)
+{
+  NS_LOG_FUNCTION (this << *psdu);
+  m_countRxFailure++;
+}
+
+void
+TestAbstractedReception::CheckRx (uint32_t expectedMpdus, uint32_t expectedSuccess, uint32_t expectedFailure)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_countRxMpdus, expectedMpdus, "Didn't notify the expected number of MPDUs");
+  NS_TEST_ASSERT_MSG_EQ (m_countRxSuccess, expectedSuccess, "Didn't receive the expected number of PPDUs");
+  NS_TEST_ASSERT_MSG_EQ (m_countRxFailure, expectedFailure, "Didn't fail the expected number of PPDUs");
+  m_countRxMpdus = 0;
+  m_countRxSuccess = 0;
+  m_countRxFailure = 0;
+}
+
+void
+TestAbstractedReception::DoSetup (void)
+{
+  m_phy = CreateObject<SpectrumWifiPhy> ();
+  m_phy->ConfigureStandardAndBand (WIFI_PHY_STANDARD_80211ax, WIFI_PHY_BAND_5GHZ);
+  Ptr<ErrorRateModel> error = CreateObject<NistErrorRateModel> ();
+  m_phy->SetErrorRateModel (error);
+  m_phy->SetChannelNumber (CHANNEL_NUMBER);
+  m_phy->SetFrequency (FREQUENCY);
+  m_phy->SetAttribute ("AbstractedReception", BooleanValue (true));
+
+  m_phy->SetReceiveOkCallback (MakeCallback (&TestAbstractedReception::RxSuccess, this));
+  m_phy->SetReceiveErrorCallback (MakeCallback (&TestAbstractedReception::RxFailure, this));
+}
+
+void
+TestAbstractedReception::DoTeardown (void)
+{
+  m_phy->Dispose ();
+  m_phy = 0;
+}
+
+void
+TestAbstractedReception::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  int64_t streamNumber = 0;
+  m_phy->AssignStreams (streamNumber);
+
+  // CASE 1: an A-MPDU received at a high SNR: all its MPDUs are received
+  Simulator::Schedule (Seconds (1.0), &TestAbstractedReception::SendAmpdu, this, -70, 3);
+  Simulator::Schedule (Seconds (1.1), &TestAbstractedReception::CheckRx, this, 3, 1, 0);
+
+  // CASE 2: the same A-MPDU, with a 3 dB weaker PPDU arriving during its payload:
+  // the effective SNR of the payload is too low for any MPDU to be received
+  Simulator::Schedule (Seconds (2.0), &TestAbstractedReception::SendAmpdu, this, -70, 3);
+  Simulator::Schedule (Seconds (2.0) + MicroSeconds (150), &TestAbstractedReception::SendAmpdu, this, -73, 1);
+  Simulator::Schedule (Seconds (2.1), &TestAbstractedReception::CheckRx, this, 0, 0, 1);
+
+  // CASE 3: an A-MPDU received below the noise floor: the PHY header is not received
+  Simulator::Schedule (Seconds (3.0), &TestAbstractedReception::SendAmpdu, this, -100, 3);
+  Simulator::Schedule (Seconds (3.1), &TestAbstractedReception::CheckRx, this, 0, 0, 1);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -2571,6 +2761,7 @@ WifiPhyReceptionTestSuite::WifiPhyReceptionTestSuite ()
   AddTestCase (new TestPhyHeadersReception, TestCase::QUICK);
   AddTestCase (new TestAmpduReception, TestCase::QUICK);
   AddTestCase (new TestUnsupportedModulationReception (), TestCase::QUICK);
+  AddTestCase (new TestAbstractedReception, TestCase::QUICK);
 }
 
 static WifiPhyReceptionTestSuite wifiPhyReceptionTestSuite; ///< the test suite
@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the serialization of the common
+// Internet stack headers (PPP, IPv4, UDP and TCP) for 'n' packets, both
+// through Packet::AddHeader (which uses Header::SerializeTo when it can)
+// and through Header::Serialize (Buffer::Iterator).
+// Sample usage:  ./waf --run 'bench-headers --n=100000'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/buffer.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/udp-header.h"
+#include "ns3/tcp-header.h"
+#include "ns3/ppp-header.h"
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// whether the headers compute their checksums
+static bool g_checksum = false;
+
+/**
+ * Build the IPv4 header used by all the benchmarks
+ * \param protocol the IPv4 protocol number
+ * \param payloadSize the IPv4 payload size
+ * \returns the header
+ */
+static Ipv4Header
+MakeIpv4Header (uint8_t protocol, uint16_t payloadSize)
+{
+  Ipv4Header ipv4;
+  ipv4.SetSource (Ipv4Address ("10.1.1.1"));
+  ipv4.SetDestination (Ipv4Address ("10.1.1.2"));
+  ipv4.SetProtocol (protocol);
+  ipv4.SetPayloadSize (payloadSize);
+  ipv4.SetTtl (64);
+  if (g_checksum)
+    {
+      ipv4.EnableChecksum ();
+    }
+  return ipv4;
+}
+
+/**
+ * Add PPP, IPv4 and UDP headers to n packets
+ * \param n number of packets
+ */
+static void
+benchUdp (uint32_t n)
+{
+  UdpHeader udp;
+  udp.SetSourcePort (49153);
+  udp.SetDestinationPort (9);
+  if (g_checksum)
+    {
+      udp.InitializeChecksum (Ipv4Address ("10.1.1.1"), Ipv4Address ("10.1.1.2"), 17);
+      udp.EnableChecksums ();
+    }
+  Ipv4Header ipv4 = MakeIpv4Header (17, 1000 + udp.GetSerializedSize ());
+  PppHeader ppp;
+  ppp.SetProtocol (0x0021);
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddHeader (udp);
+      p->AddHeader (ipv4);
+      p->AddHeader (ppp);
+    }
+}
+
+/**
+ * Add PPP, IPv4 and TCP headers (without options) to n packets
+ * \param n number of packets
+ */
+static void
+benchTcp (uint32_t n)
+{
+  TcpHeader tcp;
+  tcp.SetSourcePort (49153);
+  tcp.SetDestinationPort (50000);
+  tcp.SetFlags (TcpHeader::ACK);
+  tcp.SetWindowSize (65535);
+  if (g_checksum)
+    {
+      tcp.InitializeChecksum (Ipv4Address ("10.1.1.1"), Ipv4Address ("10.1.1.2"), 6);
+      tcp.EnableChecksums ();
+    }
+  Ipv4Header ipv4 = MakeIpv4Header (6, 536 + tcp.GetSerializedSize ());
+  PppHeader ppp;
+  ppp.SetProtocol (0x0021);
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (536);
+      tcp.SetSequenceNumber (SequenceNumber32 (1 + i * 536));
+      p->AddHeader (tcp);
+      p->AddHeader (ipv4);
+      p->AddHeader (ppp);
+    }
+}
+
+/**
+ * Serialize the PPP, IPv4 and UDP headers through Buffer::Iterator only,
+ * as Packet::AddHeader does for headers without a fast path
+ * \param n number of packets
+ */
+static void
+benchIterator (uint32_t n)
+{
+  UdpHeader udp;
+  udp.SetSourcePort (49153);
+  udp.SetDestinationPort (9);
+  Ipv4Header ipv4 = MakeIpv4Header (17, 1000 + udp.GetSerializedSize ());
+  PppHeader ppp;
+  ppp.SetProtocol (0x0021);
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Buffer buffer (1000);
+      buffer.AddAtStart (udp.GetSerializedSize ());
+      udp.Serialize (buffer.Begin ());
+      buffer.AddAtStart (ipv4.GetSerializedSize ());
+      ipv4.Serialize (buffer.Begin ());
+      buffer.AddAtStart (ppp.GetSerializedSize ());
+      ppp.Serialize (buffer.Begin ());
+    }
+}
+
+/**
+ * Same as benchIterator, through Header::SerializeTo
+ * \param n number of packets
+ */
+static void
+benchFlat (uint32_t n)
+{
+  UdpHeader udp;
+  udp.SetSourcePort (49153);
+  udp.SetDestinationPort (9);
+  Ipv4Header ipv4 = MakeIpv4Header (17, 1000 + udp.GetSerializedSize ());
+  PppHeader ppp;
+  ppp.SetProtocol (0x0021);
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Buffer buffer (1000);
+      udp.SerializeTo (buffer.AddAtStartForWrite (udp.GetSerializedSize ()), buffer.GetSize ());
+      ipv4.SerializeTo (buffer.AddAtStartForWrite (ipv4.GetSerializedSize ()), buffer.GetSize ());
+      ppp.SerializeTo (buffer.AddAtStartForWrite (ppp.GetSerializedSize ()), buffer.GetSize ());
+    }
+}
+
+/**
+ * Time one run of a benchmark
+ * \param bench the benchmark
+ * \param n number of packets
+ * \returns the elapsed time, in ms
+ */
+static uint64_t
+runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  (*bench) (n);
+  uint64_t deltaMs = time.End ();
+  return deltaMs;
+}
+
+/**
+ * Run a benchmark several times and print the best rate
+ * \param bench the benchmark
+ * \param n number of packets
+ * \param minIterations number of runs
+ * \param name the benchmark name
+ */
+static void
+runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = runBenchOneIteration (bench, n);
+      minDelay = std::min (minDelay, delay);
+    }
+  double ps = n;
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " packets/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the serialization of the common Internet stack headers");
+  cmd.AddValue ("n", "number of iterations", n);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0)
+    {
+      std::cerr << "Error-- number of packets must be specified " <<
+        "by command-line argument --n=(number of packets)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-headers with n=" << n << std::endl;
+
+  runBench (&benchIterator, n, minIterations, "PPP+IPv4+UDP through Buffer::Iterator");
+  runBench (&benchFlat, n, minIterations, "PPP+IPv4+UDP through Header::SerializeTo");
+  runBench (&benchUdp, n, minIterations, "Packet::AddHeader PPP+IPv4+UDP");
+  runBench (&benchTcp, n, minIterations, "Packet::AddHeader PPP+IPv4+TCP");
+  g_checksum = true;
+  runBench (&benchUdp, n, minIterations, "Packet::AddHeader PPP+IPv4+UDP, checksums");
+  runBench (&benchTcp, n, minIterations, "Packet::AddHeader PPP+IPv4+TCP, checksums");
+
+  return 0;
+}
@@ -328,6 +328,43 @@ benchByteTags (uint32_t n)
     }
 }
 
+static void
+benchPacketTags (uint32_t n)
+{
+  // Mimic a packet crossing a tag-heavy stack (flow id, Wi-Fi SNR and
+  // queueing tags, ...): several small packet tags and byte tags per
+  // packet, copied at each hop and stripped again on delivery.
+  BenchTag<4> flowId;
+  BenchTag<8> snr;
+  BenchTag<12> timestamp;
+  BenchTag<16> queue;
+  BenchTag<2> hop;
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1500);
+      p->AddPacketTag (flowId);
+      p->AddPacketTag (timestamp);
+      p->AddByteTag (flowId);
+      p->AddByteTag (hop);
+      for (uint32_t j = 0; j < 3; j++)
+        {
+          Ptr<Packet> o = p->Copy ();
+          o->AddPacketTag (queue);
+          o->AddPacketTag (snr);
+          o->PeekPacketTag (flowId);
+          o->RemovePacketTag (snr);
+          o->ReplacePacketTag (queue);
+          o->AddByteTag (snr);
+          p = o;
+          p->RemovePacketTag (queue);
+        }
+      p->RemovePacketTag (timestamp);
+      p->RemoveAllPacketTags ();
+      p->RemoveAllByteTags ();
+    }
+}
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -385,6 +422,7 @@ int main (int argc, char *argv[])
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
+  runBench (&benchPacketTags, n, minIterations, "Tag-heavy packet copies");
 
   return 0;
 }
@@ -0,0 +1,174 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the TCP receive buffer with 'n'
+// segments which arrive in order, or shuffled inside windows of 'window'
+// segments (as with multipath or link-layer reordering).  The application
+// reads all the available data after each segment, as TcpSocketBase
+// notifies it.
+// Sample usage:  ./waf --run 'bench-tcp-rx-buffer --n=100000 --window=64'
+
+#include "ns3/command-line.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-rx-buffer.h"
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <vector>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// size of the segments
+static uint32_t g_segmentSize = 1448;
+
+/**
+ * Build the order of arrival of n segments, shuffled inside windows
+ * \param n number of segments
+ * \param window size of the shuffled windows, in segments (1 for in order)
+ * \param reverse whether each window arrives in the reverse order
+ * \returns the indexes of the segments, in order of arrival
+ */
+static std::vector<uint32_t>
+MakeArrivals (uint32_t n, uint32_t window, bool reverse)
+{
+  std::vector<uint32_t> arrivals (n);
+  for (uint32_t i = 0; i < n; i++)
+    {
+      arrivals[i] = i;
+    }
+  // a fixed linear congruential generator, so that the runs are comparable
+  uint32_t state = 1;
+  for (uint32_t start = 0; start < n; start += window)
+    {
+      uint32_t end = std::min (n, start + window);
+      if (reverse)
+        {
+          std::reverse (arrivals.begin () + start, arrivals.begin () + end);
+          continue;
+        }
+      for (uint32_t i = end - 1; i > start; i--)
+        {
+          state = state * 1664525 + 1013904223;
+          uint32_t j = start + (state >> 8) % (i - start + 1);
+          std::swap (arrivals[i], arrivals[j]);
+        }
+    }
+  return arrivals;
+}
+
+/**
+ * Feed the segments to a receive buffer in the given order
+ * \param arrivals the indexes of the segments, in order of arrival
+ * \returns the number of bytes read by the application
+ */
+static uint64_t
+benchRxBuffer (const std::vector<uint32_t> &arrivals)
+{
+  uint32_t n = arrivals.size ();
+  TcpRxBuffer rxBuf (1);
+  rxBuf.SetMaxBufferSize (std::numeric_limits<int32_t>::max ());
+  Ptr<Packet> segment = Create<Packet> (g_segmentSize);
+  TcpHeader h;
+  uint64_t read = 0;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      h.SetSequenceNumber (SequenceNumber32 (1 + arrivals[i] * g_segmentSize));
+      rxBuf.Add (segment, h);
+      if (rxBuf.Available () > 0)
+        {
+          read += rxBuf.Extract (rxBuf.Available ())->GetSize ();
+        }
+      rxBuf.GetSackList ();
+    }
+  return read;
+}
+
+/**
+ * Time one run of a benchmark
+ * \param arrivals the indexes of the segments, in order of arrival
+ * \returns the elapsed time, in ms
+ */
+static uint64_t
+runBenchOneIteration (const std::vector<uint32_t> &arrivals)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  uint64_t read = benchRxBuffer (arrivals);
+  uint64_t deltaMs = time.End ();
+  if (read != static_cast<uint64_t> (arrivals.size ()) * g_segmentSize)
+    {
+      std::cerr << "Error-- read " << read << " bytes" << std::endl;
+      exit (1);
+    }
+  return deltaMs;
+}
+
+/**
+ * Run a benchmark several times and print the best rate
+ * \param arrivals the indexes of the segments, in order of arrival
+ * \param minIterations number of runs
+ * \param name the benchmark name
+ */
+static void
+runBench (const std::vector<uint32_t> &arrivals, uint32_t minIterations, char const *name)
+{
+  uint64_t minDelay = std::numeric_limits<uint64_t>::max ();
+  for (uint32_t i = 0; i < minIterations; i++)
+    {
+      uint64_t delay = runBenchOneIteration (arrivals);
+      minDelay = std::min (minDelay, delay);
+    }
+  double ps = arrivals.size ();
+  ps *= 1000;
+  ps /= std::max<uint64_t> (minDelay, 1);
+  std::cout << ps << " segments/s"
+            << " (" << minDelay << " ms elapsed)\t"
+            << name
+            << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t n = 0;
+  uint32_t window = 64;
+  uint32_t minIterations = 1;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the TCP receive buffer with reordered segments");
+  cmd.AddValue ("n", "number of segments", n);
+  cmd.AddValue ("window", "size of the reordering windows, in segments", window);
+  cmd.AddValue ("segment-size", "size of the segments", g_segmentSize);
+  cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
+  cmd.Parse (argc, argv);
+
+  if (n == 0 || window == 0)
+    {
+      std::cerr << "Error-- number of segments must be specified " <<
+        "by command-line argument --n=(number of segments)" << std::endl;
+      exit (1);
+    }
+  std::cout << "Running bench-tcp-rx-buffer with n=" << n << " window=" << window << std::endl;
+
+  runBench (MakeArrivals (n, 1, false), minIterations, "in order");
+  runBench (MakeArrivals (n, window, false), minIterations, "shuffled windows");
+  runBench (MakeArrivals (n, window, true), minIterations, "reversed windows");
+  runBench (MakeArrivals (n, n, false), minIterations, "whole stream shuffled");
+
+  return 0;
+}
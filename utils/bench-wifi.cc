@@ -0,0 +1,569 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the speed of Wi-Fi simulations.
+// It sweeps the number of stations associated with one AP, the standard,
+// the channel model and the offered load, and prints one CSV line per
+// configuration: the events per second, the wall-clock time per simulated
+// second, the peak resident set size and the shares of the wall-clock time
+// spent in the events of the PHY, the MAC and the channel.  The time of an
+// event includes the functions it calls in the other parts: for instance,
+// the MAC processing of a received frame is part of the PHY event ending its
+// reception, and the enqueuing of a packet is part of the application event
+// sending it (other).
+//
+// Each station has a downlink and an uplink flow of fixed size packets,
+// sent over packet sockets, which carry half the offered load each.  The
+// flows start after the association of the stations (warm-up), which is not
+// measured.  Each configuration runs in a child process, so that the peak
+// resident set size is that of the configuration.
+//
+// Sample usage:
+//   ./waf --run 'bench-wifi --stations=10,100,1000,2000 --standards=11n,11ac,11ax
+//                --channels=yans,spectrum --loads=10,100'
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/spectrum-module.h"
+#include "ns3/wifi-module.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include <cxxabi.h>
+#include <stdlib.h> // for exit ()
+#include <unistd.h> // for fork ()
+#include <sys/resource.h> // for getrusage ()
+#include <sys/wait.h> // for waitpid ()
+
+using namespace ns3;
+
+/// The parts of the simulation the wall-clock time is split between
+enum BenchPart
+{
+  BENCH_PHY = 0,
+  BENCH_MAC,
+  BENCH_CHANNEL,
+  BENCH_OTHER,
+  BENCH_N_PARTS
+};
+
+/// wall-clock time spent in the events of each part, in seconds
+static std::array<double, BENCH_N_PARTS> g_partTimes;
+/// part of the event being run
+static BenchPart g_currentPart = BENCH_OTHER;
+/// start of the event being run
+static std::chrono::steady_clock::time_point g_eventStart;
+/// whether the time of the events is being measured
+static bool g_measuring = false;
+/// part of the events of each type
+static std::unordered_map<std::type_index, BenchPart> g_eventParts;
+/// whether to print the part of each type of event
+static bool g_verbose = false;
+
+/**
+ * Get the part of the simulation an event belongs to.  The type of the
+ * events scheduled by MakeEvent with a member function names the class of
+ * the function; the other events are classified by their whole type name.
+ * \param event the event
+ * \returns the part of the event
+ */
+static BenchPart
+GetEventPart (const EventImpl *event)
+{
+  std::type_index type = typeid (*event);
+  auto it = g_eventParts.find (type);
+  if (it != g_eventParts.end ())
+    {
+      return it->second;
+    }
+
+  int status;
+  char *demangled = abi::__cxa_demangle (type.name (), NULL, NULL, &status);
+  std::string name = (status == 0 ? demangled : type.name ());
+  free (demangled);
+
+  std::string owner = name;
+  std::size_t end = name.find ("::*)");
+  if (end != std::string::npos)
+    {
+      std::size_t start = name.rfind ('(', end);
+      owner = name.substr (start + 1, end - start - 1);
+    }
+
+  BenchPart part = BENCH_OTHER;
+  if (owner.find ("ChannelAccessManager") != std::string::npos
+      || owner.find ("Mac") != std::string::npos
+      || owner.find ("Txop") != std::string::npos
+      || owner.find ("ExchangeManager") != std::string::npos
+      || owner.find ("BlockAck") != std::string::npos
+      || owner.find ("StationManager") != std::string::npos
+      || owner.find ("MultiUserScheduler") != std::string::npos
+      || owner.find ("WifiNetDevice") != std::string::npos)
+    {
+      part = BENCH_MAC;
+    }
+  else if (owner.find ("Channel") != std::string::npos
+           // YansWifiChannel::Receive is a static function
+           || owner.find ("(*)(ns3::Ptr<ns3::YansWifiPhy>") != std::string::npos)
+    {
+      part = BENCH_CHANNEL;
+    }
+  else if (owner.find ("Phy") != std::string::npos
+           || owner.find ("InterferenceHelper") != std::string::npos)
+    {
+      part = BENCH_PHY;
+    }
+  else if (owner.find ("Wifi") != std::string::npos)
+    {
+      part = BENCH_MAC;
+    }
+  if (g_verbose)
+    {
+      static const char *partNames[] = {"phy", "mac", "channel", "other"};
+      std::cerr << partNames[part] << "\t" << name << std::endl;
+    }
+  g_eventParts[type] = part;
+  return part;
+}
+
+/**
+ * Add the time of the event being run to its part.
+ * \param now the current wall-clock time
+ */
+static void
+EndEvent (std::chrono::steady_clock::time_point now)
+{
+  if (g_measuring)
+    {
+      g_partTimes[g_currentPart] += std::chrono::duration<double> (now - g_eventStart).count ();
+    }
+  g_currentPart = BENCH_OTHER;
+  g_eventStart = now;
+}
+
+/**
+ * A scheduler measuring the wall-clock time spent in the events of each
+ * part of the simulation.  It forwards the events to the scheduler set by
+ * the SchedulerType global value.  The time of an event runs from its
+ * removal from the scheduler, just before the simulator invokes it, to the
+ * removal of the next event.
+ */
+class BenchScheduler : public Scheduler
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  BenchScheduler ();
+
+  void Insert (const Event &ev) override;
+  bool IsEmpty (void) const override;
+  Event PeekNext (void) const override;
+  Event RemoveNext (void) override;
+  void Remove (const Event &ev) override;
+
+private:
+  Ptr<Scheduler> m_scheduler; ///< the scheduler the events are forwarded to
+};
+
+NS_OBJECT_ENSURE_REGISTERED (BenchScheduler);
+
+TypeId
+BenchScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::BenchScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<BenchScheduler> ()
+  ;
+  return tid;
+}
+
+BenchScheduler::BenchScheduler ()
+{
+  TypeIdValue type;
+  GlobalValue::GetValueByName ("SchedulerType", type);
+  ObjectFactory factory;
+  factory.SetTypeId (type.Get ());
+  m_scheduler = factory.Create<Scheduler> ();
+}
+
+void
+BenchScheduler::Insert (const Event &ev)
+{
+  m_scheduler->Insert (ev);
+}
+
+bool
+BenchScheduler::IsEmpty (void) const
+{
+  return m_scheduler->IsEmpty ();
+}
+
+Scheduler::Event
+BenchScheduler::PeekNext (void) const
+{
+  return m_scheduler->PeekNext ();
+}
+
+Scheduler::Event
+BenchScheduler::RemoveNext (void)
+{
+  Event ev = m_scheduler->RemoveNext ();
+  EndEvent (std::chrono::steady_clock::now ());
+  g_currentPart = GetEventPart (ev.impl);
+  return ev;
+}
+
+void
+BenchScheduler::Remove (const Event &ev)
+{
+  m_scheduler->Remove (ev);
+}
+
+/// A configuration of the benchmark
+struct BenchConfig
+{
+  uint32_t stations;     ///< number of stations
+  std::string standard;  ///< standard (11n, 11ac or 11ax)
+  std::string channel;   ///< channel model (yans or spectrum)
+  double load;           ///< offered load, in Mbit/s
+};
+
+/// The parameters common to all the configurations
+struct BenchParams
+{
+  double warmup;         ///< simulated time for the association, in seconds
+  double simTime;        ///< measured simulated time, in seconds
+  uint32_t packetSize;   ///< size of the packets, in bytes
+  std::string manager;   ///< remote station manager
+  bool profile;          ///< whether to split the time between the parts
+};
+
+/// number of bytes received by the packet socket servers
+static uint64_t g_rxBytes = 0;
+
+/**
+ * Count the bytes received by a packet socket server.
+ * \param packet the packet
+ * \param from the sender address
+ */
+static void
+RxCallback (Ptr<const Packet> packet, const Address &from)
+{
+  g_rxBytes += packet->GetSize ();
+}
+
+/**
+ * Split a comma separated list.
+ * \param list the list
+ * \returns the items
+ */
+static std::vector<std::string>
+SplitList (const std::string &list)
+{
+  std::vector<std::string> items;
+  std::istringstream iss (list);
+  std::string item;
+  while (std::getline (iss, item, ','))
+    {
+      if (!item.empty ())
+        {
+          items.push_back (item);
+        }
+    }
+  return items;
+}
+
+/**
+ * Get the peak resident set size of this process.
+ * \returns the peak resident set size, in KiB
+ */
+static uint64_t
+GetPeakRss (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+/**
+ * Simulate a configuration and print its CSV line.
+ * \param config the configuration
+ * \param params the common parameters
+ */
+static void
+RunBench (const BenchConfig &config, const BenchParams &params)
+{
+  if (params.profile)
+    {
+      ObjectFactory factory;
+      factory.SetTypeId (BenchScheduler::GetTypeId ());
+      Simulator::SetScheduler (factory);
+    }
+  g_rxBytes = 0;
+
+  NodeContainer apNode;
+  apNode.Create (1);
+  NodeContainer staNodes;
+  staNodes.Create (config.stations);
+
+  WifiHelper wifi;
+  if (config.standard == "11n")
+    {
+      wifi.SetStandard (WIFI_STANDARD_80211n_5GHZ);
+    }
+  else if (config.standard == "11ac")
+    {
+      wifi.SetStandard (WIFI_STANDARD_80211ac);
+    }
+  else if (config.standard == "11ax")
+    {
+      wifi.SetStandard (WIFI_STANDARD_80211ax_5GHZ);
+    }
+  else
+    {
+      std::cerr << "Error-- unknown standard " << config.standard << std::endl;
+      exit (1);
+    }
+  wifi.SetRemoteStationManager (params.manager);
+
+  WifiMacHelper mac;
+  Ssid ssid ("bench-wifi");
+  NetDeviceContainer apDevice;
+  NetDeviceContainer staDevices;
+  if (config.channel == "yans")
+    {
+      YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+      YansWifiPhyHelper phy;
+      phy.SetChannel (channel.Create ());
+      mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid));
+      staDevices = wifi.Install (phy, mac, staNodes);
+      mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
+      apDevice = wifi.Install (phy, mac, apNode);
+    }
+  else if (config.channel == "spectrum")
+    {
+      Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+      channel->AddPropagationLossModel (CreateObject<LogDistancePropagationLossModel> ());
+      channel->SetPropagationDelayModel (CreateObject<ConstantSpeedPropagationDelayModel> ());
+      SpectrumWifiPhyHelper phy;
+      phy.SetChannel (channel);
+      mac.SetType ("ns3::StaWifiMac", "Ssid", SsidValue (ssid));
+      staDevices = wifi.Install (phy, mac, staNodes);
+      mac.SetType ("ns3::ApWifiMac", "Ssid", SsidValue (ssid));
+      apDevice = wifi.Install (phy, mac, apNode);
+    }
+  else
+    {
+      std::cerr << "Error-- unknown channel " << config.channel << std::endl;
+      exit (1);
+    }
+  int64_t streamIndex = 1;
+  streamIndex += wifi.AssignStreams (apDevice, streamIndex);
+  streamIndex += wifi.AssignStreams (staDevices, streamIndex);
+
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (apNode);
+  Ptr<UniformDiscPositionAllocator> positions = CreateObject<UniformDiscPositionAllocator> ();
+  positions->SetRho (10);
+  positions->AssignStreams (streamIndex);
+  mobility.SetPositionAllocator (positions);
+  mobility.Install (staNodes);
+
+  PacketSocketHelper packetSocket;
+  packetSocket.Install (apNode);
+  packetSocket.Install (staNodes);
+
+  // a server per node receives all the packets sent to the node
+  Ptr<NetDevice> ap = apDevice.Get (0);
+  NetDeviceContainer devices (apDevice, staDevices);
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      PacketSocketAddress socket;
+      socket.SetSingleDevice (devices.Get (i)->GetIfIndex ());
+      socket.SetProtocol (1);
+      Ptr<PacketSocketServer> server = CreateObject<PacketSocketServer> ();
+      server->SetLocal (socket);
+      devices.Get (i)->GetNode ()->AddApplication (server);
+      server->TraceConnectWithoutContext ("Rx", MakeCallback (&RxCallback));
+    }
+
+  // each flow carries half the load of its station
+  double flowRate = config.load * 1e6 / (2 * config.stations);
+  double interval = params.packetSize * 8 / flowRate;
+  for (uint32_t i = 0; i < config.stations; i++)
+    {
+      Ptr<NetDevice> sta = staDevices.Get (i);
+      for (bool downlink : {true, false})
+        {
+          Ptr<NetDevice> from = (downlink ? ap : sta);
+          Ptr<NetDevice> to = (downlink ? sta : ap);
+          PacketSocketAddress socket;
+          socket.SetSingleDevice (from->GetIfIndex ());
+          socket.SetPhysicalAddress (to->GetAddress ());
+          socket.SetProtocol (1);
+
+          Ptr<PacketSocketClient> client = CreateObject<PacketSocketClient> ();
+          client->SetAttribute ("PacketSize", UintegerValue (params.packetSize));
+          client->SetAttribute ("MaxPackets", UintegerValue (0));
+          client->SetAttribute ("Interval", TimeValue (Seconds (interval)));
+          client->SetRemote (socket);
+          from->GetNode ()->AddApplication (client);
+          // spread the first packets over an interval
+          client->SetStartTime (Seconds (params.warmup + interval * (2 * i + downlink) / (2 * config.stations)));
+        }
+    }
+
+  // the association of the stations is not measured
+  Simulator::Stop (Seconds (params.warmup));
+  Simulator::Run ();
+  uint32_t associated = 0;
+  for (uint32_t i = 0; i < config.stations; i++)
+    {
+      Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (staDevices.Get (i));
+      associated += DynamicCast<StaWifiMac> (device->GetMac ())->IsAssociated ();
+    }
+
+  g_partTimes.fill (0);
+  g_measuring = true;
+  uint64_t rxBytes = g_rxBytes;
+  uint64_t events = Simulator::GetEventCount ();
+  auto start = std::chrono::steady_clock::now ();
+  EndEvent (start);
+  Simulator::Stop (Seconds (params.simTime));
+  Simulator::Run ();
+  auto stop = std::chrono::steady_clock::now ();
+  EndEvent (stop);
+  g_measuring = false;
+  events = Simulator::GetEventCount () - events;
+  rxBytes = g_rxBytes - rxBytes;
+  Simulator::Destroy ();
+
+  double wallTime = std::chrono::duration<double> (stop - start).count ();
+  double total = 0;
+  for (double partTime : g_partTimes)
+    {
+      total += partTime;
+    }
+  std::cout << config.stations << ","
+            << config.standard << ","
+            << config.channel << ","
+            << config.load << ","
+            << associated << ","
+            << params.simTime << ","
+            << events << ","
+            << wallTime << ","
+            << events / wallTime << ","
+            << wallTime / params.simTime << ","
+            << GetPeakRss ();
+  for (double partTime : g_partTimes)
+    {
+      std::cout << "," << (params.profile && total > 0 ? partTime / total : NAN);
+    }
+  std::cout << "," << rxBytes * 8 / params.simTime / 1e6 << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string stations = "10,50,100";
+  std::string standards = "11n,11ac,11ax";
+  std::string channels = "yans,spectrum";
+  std::string loads = "20";
+  BenchParams params;
+  params.warmup = 1;
+  params.simTime = 1;
+  params.packetSize = 1000;
+  params.manager = "ns3::IdealWifiManager";
+  params.profile = true;
+  bool useFork = true;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the speed of Wi-Fi simulations");
+  cmd.AddValue ("stations", "comma separated numbers of stations", stations);
+  cmd.AddValue ("standards", "comma separated standards (11n, 11ac, 11ax)", standards);
+  cmd.AddValue ("channels", "comma separated channel models (yans, spectrum)", channels);
+  cmd.AddValue ("loads", "comma separated offered loads, in Mbit/s", loads);
+  cmd.AddValue ("warmup", "simulated time for the association, in seconds", params.warmup);
+  cmd.AddValue ("simTime", "measured simulated time, in seconds", params.simTime);
+  cmd.AddValue ("packetSize", "size of the packets, in bytes", params.packetSize);
+  cmd.AddValue ("manager", "remote station manager", params.manager);
+  cmd.AddValue ("profile", "split the wall-clock time between the PHY, the MAC and the channel", params.profile);
+  cmd.AddValue ("fork", "run each configuration in a child process", useFork);
+  cmd.AddValue ("verbose", "print the part of each type of event", g_verbose);
+  cmd.Parse (argc, argv);
+
+  std::vector<BenchConfig> configs;
+  for (const auto &nStations : SplitList (stations))
+    {
+      for (const auto &standard : SplitList (standards))
+        {
+          for (const auto &channel : SplitList (channels))
+            {
+              for (const auto &load : SplitList (loads))
+                {
+                  configs.push_back ({static_cast<uint32_t> (std::stoul (nStations)),
+                                      standard, channel, std::stod (load)});
+                }
+            }
+        }
+    }
+
+  std::cout << "stations,standard,channel,loadMbps,associated,simTime,events,wallTime,"
+            << "eventsPerSecond,wallPerSimSecond,peakRssKiB,phyShare,macShare,channelShare,"
+            << "otherShare,throughputMbps" << std::endl;
+
+  for (const auto &config : configs)
+    {
+      if (!useFork)
+        {
+          RunBench (config, params);
+          continue;
+        }
+      pid_t pid = fork ();
+      if (pid == 0)
+        {
+          RunBench (config, params);
+          std::cout.flush ();
+          _exit (0);
+        }
+      int status = -1;
+      if (pid < 0 || waitpid (pid, &status, 0) < 0 || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          std::cerr << "Error-- the configuration with " << config.stations << " stations, "
+                    << config.standard << ", " << config.channel << " channel and "
+                    << config.load << " Mbit/s failed" << std::endl;
+        }
+    }
+
+  return 0;
+}